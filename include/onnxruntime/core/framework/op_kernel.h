@@ -129,6 +129,25 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function to use pre-packed weight loaded from the pre-packed weights cache file of the session
+  // instead of calling PrePack(). Unlike UseSharedPrePackedBuffers(), PrePack() has not been called for the
+  // kernel, so the implementation must restore any state that PrePack() would have set, e.g. the shape of the weight.
+  // @param tensor: The constant initializer the buffers were pre-packed from.
+  // @param prepacked_buffers: The buffers written by PrePack() in a previous session. The deleter of the
+  //                           BufferUniquePtr is NULL, the buffers are owned by the session.
+  // @param prepacked_buffer_sizes: The size of each buffer in bytes, which the kernel shall validate.
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param used_cached_buffers: Boolean flag set by the kernel implementation indicating
+  // that the provided weight has been used by the kernel. If false, PrePack() is called.
+  virtual Status UseCachedPrePackedBuffers(const Tensor& /*tensor*/,
+                                           std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                           gsl::span<const size_t> /*prepacked_buffer_sizes*/,
+                                           int /*input_idx*/,
+                                           /*out*/ bool& used_cached_buffers) {
+    used_cached_buffers = false;
+    return Status::OK();
+  }
+
   const OrtDevice GetDevice(OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
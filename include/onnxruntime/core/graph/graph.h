@@ -164,7 +164,10 @@ class Node {
   @remarks Used during layout transformation for setting since version for layout transformed nodes with
   domain kMSNHWC.
   */
-  void SetSinceVersion(int since_version) noexcept { since_version_ = since_version; }
+  void SetSinceVersion(int since_version) {
+    since_version_ = since_version;
+    RecordChange();
+  }
 
 #if !defined(ORT_MINIMAL_BUILD)
   /** Gets the Node's OpSchema.
@@ -242,7 +245,8 @@ class Node {
   }
 
   /** Gets a modifiable collection of the Node's implicit input definitions. */
-  std::vector<NodeArg*>& MutableImplicitInputDefs() noexcept {
+  std::vector<NodeArg*>& MutableImplicitInputDefs() {
+    RecordChange();
     return definitions_.implicit_input_defs;
   }
 #endif  // !defined(ORT_MINIMAL_BUILD)
@@ -251,15 +255,20 @@ class Node {
   /** Gets a modifiable count of arguments for each of the Node's explicit inputs.
   @todo This should be removed in favor of a method that updates the input args and the count.
         Currently these operations are separate which is not a good setup. */
-  std::vector<int>& MutableInputArgsCount() { return definitions_.input_arg_count; }
+  std::vector<int>& MutableInputArgsCount() {
+    RecordChange();
+    return definitions_.input_arg_count;
+  }
 
   /** Gets a modifiable collection of the Node's input definitions. */
-  std::vector<NodeArg*>& MutableInputDefs() noexcept {
+  std::vector<NodeArg*>& MutableInputDefs() {
+    RecordChange();
     return definitions_.input_defs;
   }
 
   /** Gets a modifiable collection of the Node's output definitions. */
-  std::vector<NodeArg*>& MutableOutputDefs() noexcept {
+  std::vector<NodeArg*>& MutableOutputDefs() {
+    RecordChange();
     return definitions_.output_defs;
   }
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
@@ -390,7 +399,10 @@ class Node {
   bool ClearAttribute(const std::string& attr_name);
 
   /** Gets the Node's mutable attributes. */
-  NodeAttributes& GetMutableAttributes() noexcept { return attributes_; }
+  NodeAttributes& GetMutableAttributes() {
+    RecordChange();
+    return attributes_;
+  }
 
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 
@@ -453,6 +465,7 @@ class Node {
   /** Sets the execution ProviderType that this Node will be executed by. */
   void SetExecutionProviderType(ProviderType execution_provider_type) {
     execution_provider_type_ = execution_provider_type;
+    RecordChange();
   }
 
   /** Call the provided function for all explicit inputs, implicit inputs, and outputs of this Node.
@@ -575,10 +588,10 @@ class Node {
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
   // internal only method to allow selected classes to directly alter the input/output definitions and arg counts
-  Definitions& MutableDefinitions() noexcept;
+  Definitions& MutableDefinitions();
 
   // internal only method to allow selected classes to directly alter the links between nodes.
-  Relationships& MutableRelationships() noexcept;
+  Relationships& MutableRelationships();
 
   void SetNodeType(Node::Type node_type) noexcept { node_type_ = node_type; }
 #endif
@@ -588,6 +601,9 @@ class Node {
 
   std::vector<std::unique_ptr<Graph>>& MutableSubgraphs() noexcept { return subgraphs_; }
 
+  // add this node to the node change log of the graph, if the graph has one
+  void RecordChange();
+
   // validate and update the input arg count
   common::Status UpdateInputArgCount();
 
@@ -1029,6 +1045,16 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
   bool AddControlEdge(NodeIndex src_node_index, NodeIndex dst_node_index);
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+  /** Sets the log that the NodeIndex of every Node that is added, removed or modified is appended to.
+  A Node may be logged more than once, and changes to a Node in a subgraph are logged as a change to the Node
+  that contains the subgraph. The edges rebuilt by Resolve() are not logged.
+  @param node_change_log Log to append to, or nullptr to stop logging. Must outlive the logging. */
+  void SetNodeChangeLog(std::vector<NodeIndex>* node_change_log) noexcept {
+    node_change_log_ = node_change_log;
+  }
+#endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+
   /** Mark the Graph as needing Resolve() to be called.
   This should be done after modifying any aspect of the Graph that changes the Nodes or relationships between them. */
   Graph& SetGraphResolveNeeded() noexcept {
@@ -1418,6 +1444,7 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
   // This friendship relationship should only be used to call Graph::Graph and
   // Graph::LoadGraph All other access should be via the public API.
   friend class Model;
+  friend class Node;
 
   Graph() = delete;
 
@@ -1484,6 +1511,9 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
     return *this;
   }
 
+  // append node_index to the node change log, or the node containing this graph to the log of the parent graph
+  void RecordNodeChange(NodeIndex node_index);
+
   Graph& GraphProtoSyncNeeded(bool needed) noexcept {
     graph_proto_sync_needed_ = needed;
     return *this;
@@ -1694,6 +1724,11 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
 
   bool graph_proto_sync_needed_ = false;
 
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+  // log of the nodes that were added, removed or modified. see SetNodeChangeLog.
+  std::vector<NodeIndex>* node_change_log_ = nullptr;
+#endif
+
   // The topological order of node index used to do node and op match verification temporarily.
   std::vector<NodeIndex> nodes_in_topological_order_;
 
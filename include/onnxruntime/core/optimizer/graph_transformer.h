@@ -3,6 +3,7 @@
 
 #pragma once
 #include <string>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/inlined_containers.h"
@@ -41,8 +42,25 @@ class GraphTransformer {
   */
   Status Apply(Graph& graph, bool& modified, const logging::Logger& logger) const;
 
+  /** Apply the in-place transformation, restricting it to the given nodes of the main graph where possible.
+  Used by the worklist mode of the GraphTransformerManager to only revisit the neighborhood of nodes that
+  were changed by earlier transformers. Transformers that do not override ApplyImplToNodes fall back to
+  processing the whole graph.
+  @param nodes Indices of the main graph nodes that may have become matchable.
+  @param[out] modified Set to true if the Graph was modified.
+  @returns Status with success or error information.
+  */
+  Status ApplyToNodes(Graph& graph, const InlinedHashSet<NodeIndex>& nodes, bool& modified,
+                      const logging::Logger& logger) const;
+
   virtual bool ShouldOnlyApplyOnce() const { return false; }
 
+  /** Gets the op types of the nodes this transformer anchors its matches on.
+  The worklist mode of the GraphTransformerManager skips the transformer when none of the changed nodes has one
+  of these op types. An empty list means the transformer may match any node.
+  */
+  virtual std::vector<std::string> TargetOpTypes() const noexcept { return {}; }
+
  protected:
   /** Helper method to call ApplyImpl on any subgraphs in the Node. */
   Status Recurse(Node& node, bool& modified, int graph_level, const logging::Logger& logger) const {
@@ -67,6 +85,15 @@ class GraphTransformer {
   // should suffice.
   virtual Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const = 0;
 
+  // Apply the transform to the given nodes of the main graph. Subgraphs of those nodes must still be processed
+  // in full via Recurse. The default implementation ignores the node list and calls ApplyImpl.
+  virtual Status ApplyImplToNodes(Graph& graph, const InlinedHashSet<NodeIndex>& /*nodes*/, bool& modified,
+                                  const logging::Logger& logger) const {
+    return ApplyImpl(graph, modified, 0, logger);
+  }
+
+  Status ResolveIfModified(Graph& graph, bool modified, Status status, const logging::Logger& logger) const;
+
   const std::string name_;
   const InlinedHashSet<std::string_view> compatible_provider_types_;
 };
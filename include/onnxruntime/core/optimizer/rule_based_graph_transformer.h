@@ -53,6 +53,10 @@ class RuleBasedGraphTransformer : public GraphTransformer {
   /** Returns the total number of rules that are registered in this transformer. */
   size_t RulesCount() const;
 
+  /** Returns the union of the op types of the registered rules, or an empty list if any rule is evaluated
+      on all op types. */
+  std::vector<std::string> TargetOpTypes() const noexcept override;
+
  protected:
   /** Applies the given set of rewrite rules on the Node of this Graph.
       @param[in] graph The Graph.
@@ -77,6 +81,15 @@ class RuleBasedGraphTransformer : public GraphTransformer {
 
   // Performs a single top-down traversal of the graph and applies all registered rules.
   common::Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  // Same as ApplyImpl but only visits the given nodes of the main graph.
+  common::Status ApplyImplToNodes(Graph& graph, const InlinedHashSet<NodeIndex>& nodes, bool& modified,
+                                  const logging::Logger& logger) const override;
+
+  // Applies the registered rules to the nodes of the graph in topological order. If nodes is not null, only the
+  // nodes in it are visited.
+  common::Status ApplyRules(Graph& graph, const InlinedHashSet<NodeIndex>* nodes, bool& modified, int graph_level,
+                            const logging::Logger& logger) const;
 };
 
 }  // namespace onnxruntime
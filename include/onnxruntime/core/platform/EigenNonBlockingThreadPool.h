@@ -39,7 +39,11 @@
 #pragma warning(disable : 4127)
 #pragma warning(disable : 4805)
 #endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <vector>
 #include "unsupported/Eigen/CXX11/ThreadPool"
 
 #if defined(__GNUC__)
@@ -53,6 +57,7 @@
 #include "core/platform/ort_mutex.h"
 #include "core/platform/ort_spin_lock.h"
 #include "core/platform/Barrier.h"
+#include "core/platform/threadpool.h"
 
 // ORT thread pool overview
 // ------------------------
@@ -79,6 +84,12 @@
 //   This spin-then-block behavior is configured via a flag provided
 //   when creating the thread pool, and by the constant spin_count.
 //
+//   Each thread also has a priority RunQueue for the tasks of
+//   threads marked as high priority (SetCallerHighPriority).  Workers
+//   pop and steal from the priority queues before the normal ones, so
+//   that work from latency-critical requests overtakes batch work
+//   sharing the same pool.
+//
 // - Although all tasks are simple void()->void functions,
 //   conceptually there are three different kinds:
 //
@@ -385,6 +396,10 @@ class ThreadPoolParallelSection {
   std::atomic<ThreadPoolLoop*> current_loop{nullptr};
   std::atomic<unsigned> workers_in_loop{0};
 
+  // Whether the tasks of the section are added to the priority queues
+  // of the workers, see ThreadPoolTempl::SetCallerHighPriority
+  bool high_priority{false};
+
   // Members to track asynchronous dispatching
   int dispatch_q_idx = -1;      // index of thread that dispatch work to all other threads
   unsigned dispatch_w_idx = 0;  // index of enqueued work
@@ -790,6 +805,10 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       ComputeCoprimes(i, &all_coprimes_.back());
     }
 
+    if (thread_options.numa_aware) {
+      InitializeNumaDomains(thread_options);
+    }
+
     // Eigen::MaxSizeVector has neither essential exception safety features
     // such as swap, nor it is movable. So we have to join threads right here
     // on exception
@@ -818,12 +837,20 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
   void Schedule(std::function<void()> fn) override {
     PerThread* pt = GetPerThread();
-    int q_idx = Rand(&pt->rand) % num_threads_;
+    int q_idx;
+    if (!numa_domains_.empty() && pt->pool == this) {
+      // Keep work created by a worker on the worker's NUMA node
+      const auto& domain = numa_domains_[worker_domain_[pt->thread_id]];
+      q_idx = domain[Rand(&pt->rand) % domain.size()];
+    } else {
+      q_idx = Rand(&pt->rand) % num_threads_;
+    }
     WorkerData& td = worker_data_[q_idx];
-    Queue& q = td.queue;
+    Queue& q = td.GetQueue(pt->high_priority);
     fn = q.PushBack(std::move(fn));
     if (!fn) {
       // The queue accepted the work; ensure that the thread will pick it up
+      CountPush(td, q);
       td.EnsureAwake();
     } else {
       // Run the work directly if the queue rejected the work
@@ -858,6 +885,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     ps.work_done = false;
     ps.tasks_revoked = 0;
     ps.current_dop = 1;
+    ps.high_priority = pt.high_priority;
     ps.active = true;
   }
 
@@ -885,7 +913,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     // not the dispatch task itself has started -- if it has not started
     // then it cannot have pushed tasks.
     if (ps.dispatch_q_idx != -1) {
-      Queue& q = worker_data_[ps.dispatch_q_idx].queue;
+      Queue& q = worker_data_[ps.dispatch_q_idx].GetQueue(ps.high_priority);
       if (q.RevokeWithTag(pt.tag, ps.dispatch_w_idx)) {
         if (!ps.dispatch_started.load(std::memory_order_acquire)) {
           // We successfully revoked a task, and saw the dispatch task
@@ -908,9 +936,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     // finish dispatch work.  This avoids new tasks being started
     // concurrently with us attempting to end the parallel section.
     if (ps.dispatch_q_idx != -1) {
-      while (!ps.dispatch_done.load(std::memory_order_acquire)) {
-        onnxruntime::concurrency::SpinPause();
-      }
+      SpinUntil([&ps]() { return ps.dispatch_done.load(std::memory_order_acquire); });
     }
 
     // Now we know that dispatch is finshed, we synchronize with the
@@ -921,7 +947,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     unsigned tasks_started = static_cast<unsigned>(ps.tasks.size());
     while (!ps.tasks.empty()) {
       const auto& item = ps.tasks.back();
-      Queue& q = worker_data_[item.first].queue;
+      Queue& q = worker_data_[item.first].GetQueue(ps.high_priority);
       if (q.RevokeWithTag(pt.tag, item.second)) {
         ps.tasks_revoked++;
       }
@@ -931,16 +957,12 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
     // Wait for the dispatch task's own work...
     if (ps.dispatch_q_idx > -1) {
-      while (!ps.work_done.load(std::memory_order_acquire)) {
-        onnxruntime::concurrency::SpinPause();
-      }
+      SpinUntil([&ps]() { return ps.work_done.load(std::memory_order_acquire); });
     }
 
     // ...and wait for any other tasks not revoked to finish their work
     auto tasks_to_wait_for = tasks_started - ps.tasks_revoked;
-    while (ps.tasks_finished < tasks_to_wait_for) {
-      onnxruntime::concurrency::SpinPause();
-    }
+    SpinUntil([&ps, tasks_to_wait_for]() { return ps.tasks_finished >= tasks_to_wait_for; });
 
     // Clear status to allow the ThreadPoolParallelSection to be
     // re-used.
@@ -967,6 +989,13 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   // will distribute work across the pool of workers.  For workers
   // with multiple main threads it attempts to balance the load.
   //
+  // With NUMA-aware scheduling, the initial hints instead list the
+  // workers of a single NUMA node first (the node of the calling
+  // thread if it is a worker, and round-robin among the nodes
+  // otherwise), followed by the workers of the remaining nodes.  This
+  // keeps the shards of a loop on one node unless the loop needs more
+  // threads than the node has.
+  //
   // These hints are just used as a starting point, and are updated by
   // the worker thread that actually claims an item (e.g., if an item
   // initially assigned to thread T1 is stolen and executed by T2,
@@ -1053,7 +1082,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   //   From that point onwards, the two main threads will dispatch tasks
   //   to separate workers, avoiding the need for further work stealing.
 
-  void InitializePreferredWorkers(InlinedVector<int>& preferred_workers) {
+  void InitializePreferredWorkers(PerThread& pt, InlinedVector<int>& preferred_workers) {
     static std::atomic<unsigned> next_worker{0};
 
     // preferred_workers[0] isn't supposed to be used, so initializing it with -1 to:
@@ -1063,6 +1092,20 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       preferred_workers.push_back(-1);
     }
 
+    if (!numa_domains_.empty() && preferred_workers.size() == 1) {
+      static std::atomic<unsigned> next_domain{0};
+      const unsigned num_domains = static_cast<unsigned>(numa_domains_.size());
+      const unsigned first_domain = pt.pool == this ? worker_domain_[pt.thread_id] : next_domain++ % num_domains;
+      for (unsigned d = 0; d < num_domains; ++d) {
+        const auto& domain = numa_domains_[(first_domain + d) % num_domains];
+        const unsigned domain_size = static_cast<unsigned>(domain.size());
+        const unsigned offset = next_worker++ % domain_size;
+        for (unsigned i = 0; i < domain_size; ++i) {
+          preferred_workers.push_back(static_cast<int>(domain[(offset + i) % domain_size]));
+        }
+      }
+    }
+
     // preferred_workers maps from a par_idx to a q_idx, hence we
     // initialize slots in the range [0,num_threads_]
     while (preferred_workers.size() <= num_threads_) {
@@ -1096,7 +1139,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       unsigned q_idx = preferred_workers[par_idx] % num_threads_;
       assert(q_idx < num_threads_);
       WorkerData& td = worker_data_[q_idx];
-      Queue& q = td.queue;
+      Queue& q = td.GetQueue(ps.high_priority);
       unsigned w_idx;
 
       // Attempt to enqueue the task
@@ -1114,6 +1157,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       // another thread (which may then steal the task).
       if (push_status == PushResult::ACCEPTED_IDLE || push_status == PushResult::ACCEPTED_BUSY) {
         ps.tasks.push_back({q_idx, w_idx});
+        CountPush(td, q);
         td.EnsureAwake();
         if (push_status == PushResult::ACCEPTED_BUSY) {
           worker_data_[Rand(&pt.rand) % num_threads_].EnsureAwake();
@@ -1164,7 +1208,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     // in as they complete.
     assert(new_dop <= (unsigned)(num_threads_ + 1));
     auto& preferred_workers = pt.preferred_workers;
-    InitializePreferredWorkers(preferred_workers);
+    InitializePreferredWorkers(pt, preferred_workers);
 
     // current_dop is the degree of parallelism via any workers already
     // participating in the current parallel section.  Usually, for
@@ -1209,7 +1253,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         profiler_.LogStart();
         ps.dispatch_q_idx = preferred_workers[current_dop] % num_threads_;
         WorkerData& dispatch_td = worker_data_[ps.dispatch_q_idx];
-        Queue& dispatch_que = dispatch_td.queue;
+        Queue& dispatch_que = dispatch_td.GetQueue(ps.high_priority);
 
         // assign dispatch task to selected dispatcher
         auto push_status = dispatch_que.PushBackWithTag(dispatch_task, pt.tag, ps.dispatch_w_idx);
@@ -1217,6 +1261,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         // In addition, if the queue was non-empty, attempt to wake
         // another thread (which may then steal the task).
         if (push_status == PushResult::ACCEPTED_IDLE || push_status == PushResult::ACCEPTED_BUSY) {
+          CountPush(dispatch_td, dispatch_que);
           dispatch_td.EnsureAwake();
           if (push_status == PushResult::ACCEPTED_BUSY) {
             worker_data_[Rand(&pt.rand) % num_threads_].EnsureAwake();
@@ -1280,9 +1325,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
     // Wait for workers to exit the loop
     ps.current_loop = 0;
-    while (ps.workers_in_loop) {
-      onnxruntime::concurrency::SpinPause();
-    }
+    SpinUntil([&ps]() { return ps.workers_in_loop == 0; });
     profiler_.LogEnd(ThreadPoolProfiler::WAIT);
   }
 
@@ -1328,11 +1371,82 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     spin_loop_status_ = SpinLoopStatus::kBusy;
   }
 
+  // Number of NUMA nodes the workers are grouped into.  1 if NUMA-aware scheduling is not in use.
+  unsigned NumNumaDomains() const {
+    return numa_domains_.empty() ? 1u : static_cast<unsigned>(numa_domains_.size());
+  }
+
   void DisableSpinning() {
     spin_loop_status_ = SpinLoopStatus::kIdle;
   }
 
+  // Set whether the tasks and parallel loops of the calling thread are added to the priority
+  // queues of the workers, which the workers drain before their normal queues.  Applies to all
+  // pools of this type and returns the previous setting.
+  static bool SetCallerHighPriority(bool high_priority) {
+    PerThread* pt = GetPerThread();
+    const bool previous = pt->high_priority;
+    pt->high_priority = high_priority;
+    return previous;
+  }
+
+  static bool CallerHasHighPriority() {
+    return GetPerThread()->high_priority;
+  }
+
+  // Sum the counters of the workers.  The counters are read without synchronizing with the
+  // workers, so a snapshot taken while the pool runs may miss the latest updates.
+  ThreadPoolStats GetStats() const {
+    ThreadPoolStats stats;
+    stats.num_threads = static_cast<int>(num_threads_);
+    stats.allow_spinning = allow_spinning_;
+    for (const auto& td : worker_data_) {
+      stats.tasks_scheduled += td.tasks_scheduled.load(std::memory_order_relaxed);
+      stats.tasks_stolen += td.tasks_stolen.load(std::memory_order_relaxed);
+      stats.spin_iterations += td.spin_iterations.load(std::memory_order_relaxed);
+      stats.parks += td.parks.load(std::memory_order_relaxed);
+      stats.unparks += td.unparks.load(std::memory_order_relaxed);
+      for (size_t i = 0; i < ThreadPoolStats::kQueueDepthBuckets; ++i) {
+        stats.queue_depth_histogram[i] += td.queue_depth_histogram[i].load(std::memory_order_relaxed);
+      }
+    }
+    stats.parallel_section_wait_ns = parallel_section_wait_ns_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
  private:
+  // Group the workers by the NUMA node of the first logical processor in their affinity.  NUMA-aware
+  // scheduling is left disabled if the placement of any worker is unknown or all workers share a node.
+  void InitializeNumaDomains(const ThreadOptions& thread_options) {
+    std::vector<int> worker_nodes;
+    worker_nodes.reserve(num_threads_);
+    for (unsigned i = 0; i < num_threads_; ++i) {
+      if (i >= thread_options.affinities.size() || thread_options.affinities[i].empty()) {
+        return;
+      }
+      worker_nodes.push_back(env_.GetNumaNodeOfLogicalProcessor(thread_options.affinities[i].front()));
+    }
+
+    std::vector<int> domain_nodes;
+    worker_domain_.resize(num_threads_);
+    for (unsigned i = 0; i < num_threads_; ++i) {
+      auto it = std::find(domain_nodes.begin(), domain_nodes.end(), worker_nodes[i]);
+      if (it == domain_nodes.end()) {
+        domain_nodes.push_back(worker_nodes[i]);
+        numa_domains_.emplace_back();
+        it = domain_nodes.end() - 1;
+      }
+      const auto domain = static_cast<unsigned>(it - domain_nodes.begin());
+      worker_domain_[i] = domain;
+      numa_domains_[domain].push_back(i);
+    }
+
+    if (numa_domains_.size() < 2) {
+      numa_domains_.clear();
+      worker_domain_.clear();
+    }
+  }
+
   void ComputeCoprimes(int N, Eigen::MaxSizeVector<unsigned>* coprimes) {
     for (int i = 1; i <= N; i++) {
       unsigned a = i;
@@ -1376,6 +1490,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     int thread_id{-1};                // Worker thread index in pool.
     Tag tag{};                        // Work item tag used to identify this thread.
     bool leading_par_section{false};  // Leading a parallel section (used only for asserts)
+    bool high_priority{false};        // Work is added to the priority queues of the workers
 
     // When this thread is entering a parallel section, it will
     // initially push work to this set of workers.  The aim is to
@@ -1390,11 +1505,48 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 #endif  // _MSC_VER
 
   struct WorkerData {
-    constexpr WorkerData() : thread(), queue() {
+    constexpr WorkerData() : thread(), queue(), priority_queue() {
     }
     std::unique_ptr<Thread> thread;
     Queue queue;
 
+    // Work of the threads running with high priority.  The worker pops from it, and other
+    // workers steal from it, before the normal queue.
+    Queue priority_queue;
+
+    Queue& GetQueue(bool high_priority) {
+      return high_priority ? priority_queue : queue;
+    }
+
+    Task PopFront() {
+      Task t = priority_queue.PopFront();
+      if (!t) {
+        t = queue.PopFront();
+      }
+      return t;
+    }
+
+    Task PopBack() {
+      Task t = priority_queue.PopBack();
+      if (!t) {
+        t = queue.PopBack();
+      }
+      return t;
+    }
+
+    bool Empty() const {
+      return priority_queue.Empty() && queue.Empty();
+    }
+
+    // Counters reported by GetStats.  tasks_scheduled, queue_depth_histogram and unparks are
+    // updated by the threads pushing work to this worker, the others by the worker itself.
+    std::atomic<uint64_t> tasks_scheduled{0};
+    std::atomic<uint64_t> tasks_stolen{0};
+    std::atomic<uint64_t> spin_iterations{0};
+    std::atomic<uint64_t> parks{0};
+    std::atomic<uint64_t> unparks{0};
+    std::atomic<uint64_t> queue_depth_histogram[ThreadPoolStats::kQueueDepthBuckets]{};
+
     // Each thread has a status, available read-only without locking, and protected
     // by the mutex field below for updates.  The status is used for three
     // purposes:
@@ -1449,6 +1601,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         assert(seen != ThreadStatus::Blocking);
         if (seen == ThreadStatus::Blocked) {
           status.store(ThreadStatus::Waking, std::memory_order_relaxed);
+          unparks.fetch_add(1, std::memory_order_relaxed);
           lk.unlock();
           cv.notify_one();
         }
@@ -1495,9 +1648,19 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   const bool set_denormal_as_zero_;
   Eigen::MaxSizeVector<WorkerData> worker_data_;
   Eigen::MaxSizeVector<Eigen::MaxSizeVector<unsigned>> all_coprimes_;
+
+  // NUMA-aware scheduling.  numa_domains_ lists the worker indices on each NUMA node that has workers,
+  // and worker_domain_ maps a worker index to its entry in numa_domains_.  Both are empty if NUMA-aware
+  // scheduling is not in use.
+  std::vector<std::vector<unsigned>> numa_domains_;
+  std::vector<unsigned> worker_domain_;
+
   std::atomic<unsigned> blocked_;  // Count of blocked workers, used as a termination condition
   std::atomic<bool> done_;
 
+  // Time threads running parallel loops spent spinning for the workers, see SpinUntil
+  std::atomic<uint64_t> parallel_section_wait_ns_{0};
+
   // SpinLoopStatus indicates whether the main worker spinning (inner) loop should exit immediately when there is
   // no work available (kIdle) or whether it should follow the configured spin-then-block policy (kBusy).
   // This lets the ORT session layer hint to the thread pool that it should stop spinning in between
@@ -1510,6 +1673,33 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   // Default is no control over spinning
   std::atomic<SpinLoopStatus> spin_loop_status_{SpinLoopStatus::kBusy};
 
+  // Count a task accepted by queue q of td, and the depth of the queue after adding it.
+  static void CountPush(WorkerData& td, const Queue& q) {
+    td.tasks_scheduled.fetch_add(1, std::memory_order_relaxed);
+    unsigned depth = std::max(q.Size(), 1u);
+    size_t bucket = 0;
+    while ((depth >>= 1) != 0 && bucket + 1 < ThreadPoolStats::kQueueDepthBuckets) {
+      ++bucket;
+    }
+    td.queue_depth_histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Spin until done() holds, accounting the time to the waits in parallel sections.  The clock
+  // is only read if done() does not hold on entry.
+  template <typename Predicate>
+  void SpinUntil(Predicate done) {
+    if (done()) {
+      return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    do {
+      onnxruntime::concurrency::SpinPause();
+    } while (!done());
+    const auto wait_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    parallel_section_wait_ns_.fetch_add(static_cast<uint64_t>(wait_ns.count()), std::memory_order_relaxed);
+  }
+
   // Wake any blocked workers so that they can cleanly exit WorkerLoop().  For
   // a clean exit, each thread will observe (1) done_ set, indicating that the
   // destructor has been called, (2) all threads blocked, and (3) no
@@ -1525,7 +1715,6 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   void WorkerLoop(int thread_id) {
     PerThread* pt = GetPerThread();
     WorkerData& td = worker_data_[thread_id];
-    Queue& q = td.queue;
     bool should_exit = false;
     pt->pool = this;
     pt->thread_id = thread_id;
@@ -1539,15 +1728,25 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     SetDenormalAsZero(set_denormal_as_zero_);
     profiler_.LogThreadId(thread_id);
 
+    auto steal = [&](StealAttemptKind steal_kind) {
+      Task stolen = Steal(steal_kind);
+      if (stolen) {
+        td.tasks_stolen.fetch_add(1, std::memory_order_relaxed);
+      }
+      return stolen;
+    };
+
     while (!should_exit) {
-      Task t = q.PopFront();
+      Task t = td.PopFront();
       if (!t) {
         // Spin waiting for work.
+        int spins = 0;
         for (int i = 0; i < spin_count && !done_; i++) {
+          ++spins;
           if (((i + 1) % steal_count == 0)) {
-            t = Steal(StealAttemptKind::TRY_ONE);
+            t = steal(StealAttemptKind::TRY_ONE);
           } else {
-            t = q.PopFront();
+            t = td.PopFront();
           }
           if (t) break;
 
@@ -1556,6 +1755,15 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
           }
           onnxruntime::concurrency::SpinPause();
         }
+        if (spins != 0) {
+          td.spin_iterations.fetch_add(static_cast<uint64_t>(spins), std::memory_order_relaxed);
+        }
+
+        // With NUMA-aware scheduling the spin loop only steals from the local node.  Look for work on
+        // the remote nodes before blocking.
+        if (!t && !numa_domains_.empty()) {
+          t = steal(StealAttemptKind::TRY_ALL);
+        }
 
         // Attempt to block
         if (!t) {
@@ -1578,7 +1786,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
                 //
                 // If #A if after #2 then #B will see #1, and we abandon blocking
                 assert(!t);
-                t = q.PopFront();
+                t = td.PopFront();
                 if (t) {
                   should_block = false;
                 }
@@ -1614,12 +1822,13 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
               // Post-block update (executed only if we blocked)
               [&]() {
                 blocked_--;
+                td.parks.fetch_add(1, std::memory_order_relaxed);
               });
           // Thread just unblocked.  Unless we picked up work while
           // blocking, or are exiting, then either work was pushed to
           // us, or it was pushed to an overloaded queue
-          if (!t) t = q.PopFront();
-          if (!t) t = Steal(StealAttemptKind::TRY_ALL);
+          if (!t) t = td.PopFront();
+          if (!t) t = steal(StealAttemptKind::TRY_ALL);
         }
       }
 
@@ -1645,8 +1854,29 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   // "snatching" work from a thread which is just about to notice the
   // work itself.
 
+  //
+  // With NUMA-aware scheduling a thread first attempts to steal from
+  // the workers on its own NUMA node, and only steals from remote
+  // nodes when it is trying all the workers, i.e. when it is about to
+  // block or has just been woken up.
+
   Task Steal(StealAttemptKind steal_kind) {
     PerThread* pt = GetPerThread();
+    if (!numa_domains_.empty() && pt->pool == this) {
+      const unsigned num_domains = static_cast<unsigned>(numa_domains_.size());
+      const unsigned local_domain = worker_domain_[pt->thread_id];
+      if (steal_kind == StealAttemptKind::TRY_ONE) {
+        return StealFromDomain(*pt, numa_domains_[local_domain], 1);
+      }
+
+      Task t;
+      for (unsigned d = 0; d < num_domains && !t; ++d) {
+        const auto& domain = numa_domains_[(local_domain + d) % num_domains];
+        t = StealFromDomain(*pt, domain, static_cast<unsigned>(domain.size()));
+      }
+      return t;
+    }
+
     unsigned size = num_threads_;
     unsigned num_attempts = (steal_kind == StealAttemptKind::TRY_ALL) ? size : 1;
     unsigned r = Rand(&pt->rand);
@@ -1656,7 +1886,32 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     for (unsigned i = 0; i < num_attempts; i++) {
       assert(victim < size);
       if (worker_data_[victim].GetStatus() == WorkerData::ThreadStatus::Active) {
-        Task t = worker_data_[victim].queue.PopBack();
+        Task t = worker_data_[victim].PopBack();
+        if (t) {
+          return t;
+        }
+      }
+      victim += inc;
+      if (victim >= size) {
+        victim -= size;
+      }
+    }
+
+    return Task();
+  }
+
+  // Steal from up to num_attempts of the workers in domain, visiting them in pseudo-random order.
+  Task StealFromDomain(PerThread& pt, const std::vector<unsigned>& domain, unsigned num_attempts) {
+    const unsigned size = static_cast<unsigned>(domain.size());
+    unsigned r = Rand(&pt.rand);
+    unsigned inc = all_coprimes_[size - 1][r % all_coprimes_[size - 1].size()];
+    unsigned victim = r % size;
+
+    for (unsigned i = 0; i < num_attempts; i++) {
+      assert(victim < size);
+      WorkerData& td = worker_data_[domain[victim]];
+      if (td.GetStatus() == WorkerData::ThreadStatus::Active) {
+        Task t = td.PopBack();
         if (t) {
           return t;
         }
@@ -1677,7 +1932,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     unsigned inc = all_coprimes_[size - 1][r % all_coprimes_[size - 1].size()];
     unsigned victim = r % size;
     for (unsigned i = 0; i < size; i++) {
-      if (!worker_data_[victim].queue.Empty()) {
+      if (!worker_data_[victim].Empty()) {
         return victim;
       }
       victim += inc;
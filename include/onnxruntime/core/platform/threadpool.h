@@ -16,6 +16,7 @@ limitations under the License.
 /* Modifications Copyright (c) Microsoft. */
 
 #pragma once
+#include <chrono>
 #include <string>
 #include <vector>
 #include <functional>
@@ -136,6 +137,24 @@ class ExtendedThreadPoolInterface;
 class LoopCounter;
 class ThreadPoolParallelSection;
 
+// Counters of the work done by the threads of a pool since the pool was created.  The counters are
+// kept while the pool runs, so the difference of two snapshots describes the load in between.
+struct ThreadPoolStats {
+  // queue_depth_histogram[i] counts the tasks after whose addition the work queue held
+  // [2^i, 2^(i+1)) tasks.  A queue holds up to 1024 tasks.
+  static constexpr size_t kQueueDepthBuckets = 11;
+
+  int num_threads = 0;                    // Threads created by the pool
+  bool allow_spinning = false;            // Whether idle workers spin before blocking
+  uint64_t tasks_scheduled = 0;           // Tasks added to the work queues of the workers
+  uint64_t tasks_stolen = 0;              // Tasks a worker took from the queue of another worker
+  uint64_t spin_iterations = 0;           // Iterations of the loop idle workers spin in waiting for work
+  uint64_t parks = 0;                     // Times a worker blocked waiting for work
+  uint64_t unparks = 0;                   // Times a blocked worker was woken up
+  uint64_t parallel_section_wait_ns = 0;  // Time threads running parallel loops waited for the workers
+  uint64_t queue_depth_histogram[kQueueDepthBuckets] = {};
+};
+
 class ThreadPool {
  public:
 #ifdef _WIN32
@@ -213,6 +232,109 @@ class ThreadPool {
     ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelSection);
   };
 
+  // Limit the number of threads, including the calling thread, that the parallel loops started by the
+  // calling thread use in any pool while the object is alive.  A limit of 0 means no limit.  Limits may
+  // be nested, a nested limit can only lower the limit of the enclosing one.
+  //
+  // The parallel executor uses this so that kernels running concurrently on different streams share the
+  // threads of the intra-op pool instead of each of them using all of the threads.
+  class ScopedThreadLimit {
+   public:
+    explicit ScopedThreadLimit(int max_threads);
+    ~ScopedThreadLimit();
+
+   private:
+    int previous_limit_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedThreadLimit);
+  };
+
+  // Scale the block size that ParallelFor derives from the cost of a loop, for the loops started by the
+  // calling thread while the object is alive.  A scale below 1 splits the loops into more, smaller blocks
+  // and a scale above 1 into fewer, larger ones.  Scales may be nested, the innermost one applies.
+  //
+  // The intra-op parallelism tuner uses this to correct the cost that a kernel passes to ParallelFor.
+  class ScopedBlockSizeScale {
+   public:
+    explicit ScopedBlockSizeScale(double scale);
+    ~ScopedBlockSizeScale();
+
+   private:
+    double previous_scale_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedBlockSizeScale);
+  };
+
+  // Accumulate the time the calling thread spends in the parallel loops it starts in any pool without running its
+  // own share of the loop, i.e. distributing the work and waiting for the other threads to finish, while the
+  // object is alive.  Counters may be nested, the innermost one counts.
+  //
+  // The node trace recorder uses this to report how long a kernel waits for the intra-op threads.
+  class ScopedWaitTimeCounter {
+   public:
+    ScopedWaitTimeCounter();
+    ~ScopedWaitTimeCounter();
+
+    uint64_t WaitNanoseconds() const { return wait_ns_; }
+
+   private:
+    uint64_t* previous_counter_;
+    uint64_t wait_ns_{0};
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedWaitTimeCounter);
+  };
+
+  // Priority of the tasks and parallel loops that a thread adds to a pool.  The workers run the work of
+  // high priority callers before normal work, so that latency-critical requests are not queued behind
+  // batch requests sharing the pool.
+  enum class Priority {
+    kNormal,
+    kHigh,
+  };
+
+  // Set the priority of the work that the calling thread adds to any pool while the object is alive.
+  // Priorities may be nested, the innermost one applies.
+  //
+  // Sessions use this for the priority set with the "session.intra_op.priority" config entry and the
+  // "run.intra_op.priority" run option.
+  class ScopedPriority {
+   public:
+    explicit ScopedPriority(Priority priority);
+    ~ScopedPriority();
+
+   private:
+    Priority previous_priority_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedPriority);
+  };
+
+  // Return the priority of the work the calling thread adds to the pools.
+  static Priority CurrentPriority();
+
+  // Return the ScopedThreadLimit of the calling thread, 0 if there is none.
+  static int CurrentThreadLimit();
+
+  // Set a deadline for the work of the calling thread while the object is alive.  Deadlines may be
+  // nested, the earliest one applies.  Parallel loops started by the thread pass the deadline on to the
+  // workers running them.
+  //
+  // The pool does not interrupt running work when the deadline passes.  Long-running kernels poll
+  // DeadlinePassed() between units of work (GEMM tiles, loop iterations, decoding steps) and give up early,
+  // and the executor stops before the next node.  Sessions set the deadline from the "run.deadline_ms"
+  // run option.
+  class ScopedDeadline {
+   public:
+    explicit ScopedDeadline(std::chrono::steady_clock::time_point deadline);
+    ~ScopedDeadline();
+
+   private:
+    std::chrono::steady_clock::time_point previous_deadline_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedDeadline);
+  };
+
+  // Return the deadline of the calling thread, time_point::max() if there is none.
+  static std::chrono::steady_clock::time_point CurrentDeadline();
+
+  // Return true if the calling thread has a deadline and it has passed.  The clock is only read when a
+  // deadline is set, so this is cheap enough to call from inner loops.
+  static bool DeadlinePassed();
+
   // The below API allows to disable spinning
   // This is used to support real-time scenarios where
   // spinning between relatively infrequent requests
@@ -221,6 +343,10 @@ class ThreadPool {
 
   void DisableSpinning();
 
+  // Returns the counters of the work done by the threads of the pool.  All counters are zero for
+  // a pool without threads.  May be called while the pool runs.
+  ThreadPoolStats GetStats() const;
+
   // Schedules fn() for execution in the pool of threads.  The function may run
   // synchronously if it cannot be enqueued.  This will occur if the thread pool's
   // degree-of-parallelism is 1, but it may also occur for implementation-dependent
@@ -360,6 +486,11 @@ class ThreadPool {
   // working in combination with the thread initiating the loop.
   static int DegreeOfParallelism(const ThreadPool* tp);
 
+  // Return the number of threads created by the pool plus 1 for the thread entering a loop, or 1 if tp is
+  // nullptr.  Unlike DegreeOfParallelism this does not depend on the task granularity used on hybrid CPUs
+  // nor on the ScopedThreadLimit of the calling thread.
+  static int NumThreadsIncludingCaller(const ThreadPool* tp);
+
   ORT_DISALLOW_COPY_AND_ASSIGNMENT(ThreadPool);
 
   // StartProfiling and StopProfiling are not to be consumed as public-facing API
@@ -373,6 +504,10 @@ class ThreadPool {
   // value returned by DegreeOfParallelism to code using the pool.
   int NumThreads() const;
 
+  // Returns the number of threads, including the calling thread, that a parallel loop started by the
+  // calling thread may use, i.e. NumThreads() + 1 capped by the ScopedThreadLimit of the thread.
+  int MaxThreadsForCaller() const;
+
   // Returns current thread id between 0 and NumThreads() - 1, if called from a
   // thread in the pool. Returns -1 otherwise.
   int CurrentThreadId() const;
@@ -13,6 +13,8 @@
 
 struct OrtThreadingOptions;
 namespace onnxruntime {
+class SharedInitializerStore;
+
 /** TODO: remove this class
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -79,6 +81,14 @@ class Environment {
    */
   Status UnregisterAllocator(const OrtMemoryInfo& mem_info);
 
+  /**
+   * Returns the store of initializers shared between the sessions of this env, or nullptr if the env was not
+   * created with Create().
+   */
+  SharedInitializerStore* GetSharedInitializerStore() const {
+    return shared_initializer_store_.get();
+  }
+
   Environment() = default;
 
   /**
@@ -99,5 +109,6 @@ class Environment {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
   bool create_global_thread_pools_{false};
   std::vector<AllocatorPtr> shared_allocators_;
+  std::shared_ptr<SharedInitializerStore> shared_initializer_store_;
 };
 }  // namespace onnxruntime
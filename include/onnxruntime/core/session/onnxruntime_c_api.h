@@ -2803,6 +2803,9 @@ struct OrtApi {
    *  Use -1 to allow ORT to choose the default 1GB for max_power_of_two_extend_bytes.
    *  Ultimately, the allocation size is determined by the allocation memory request.
    *  Further allocation sizes are governed by the arena extend strategy.
+   * "thread_cache_max_bytes": Maximum number of bytes of freed small chunks each per-thread cache of the arena holds
+   *  for reuse without locking the arena. Only used by arenas that are not stream aware.
+   *  Use -1 to allow ORT to choose the default of 0, which disables the caches.
    *
    * \param[in] arena_config_keys Keys to configure the arena
    * \param[in] arena_config_values Values to configure the arena
@@ -4666,6 +4669,42 @@ struct OrtApi {
                   _In_reads_(num_external_initializer_files) char* const* external_initializer_file_buffer_array,
                   _In_reads_(num_external_initializer_files) const size_t* external_initializer_file_lengths,
                   size_t num_external_initializer_files);
+
+  /** \brief Get the latency statistics of the kernel runs sampled by the node trace
+   *
+   * Node tracing is enabled with the session config entry "session.node_trace.sample_interval". The statistics
+   * cover the last sampled runs of each thread and can be queried while the session runs.
+   *
+   * \param[in] session
+   * \param[in] allocator Allocator used to allocate the returned string.
+   * \param[out] out Null terminated JSON object with the "nodes" and "op_types" arrays. Each entry has the
+   *             "op_type", "count", "p50_us", "p99_us", "mean_us", "mean_output_bytes" and
+   *             "mean_thread_pool_wait_us" of the recorded runs, and the nodes have a "name".
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionGetNodeTraceStats, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /** \brief Get the counters of the thread pools used by the session
+   *
+   * The counters cover the lifetime of each pool. If the session uses the global thread pools of the environment
+   * they include the work of the other sessions sharing them.
+   *
+   * \param[in] session
+   * \param[in] allocator Allocator used to allocate the returned string.
+   * \param[out] out Null terminated JSON object with the "intra_op" and "inter_op" pools, null if the session has
+   *             no such pool. Each pool has the "num_threads", "allow_spinning", "tasks_scheduled", "tasks_stolen",
+   *             "spin_iterations", "parks", "unparks", "parallel_section_wait_ns" and "queue_depth_histogram"
+   *             entries. Entry i of the histogram counts the tasks after whose addition a work queue held
+   *             [2^i, 2^(i+1)) tasks.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionGetThreadPoolStats, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
 };
 
 /*
@@ -1038,6 +1038,20 @@ struct ConstSessionImpl : Base<T> {
   uint64_t GetProfilingStartTimeNs() const;  ///< Wraps OrtApi::SessionGetProfilingStartTimeNs
   ModelMetadata GetModelMetadata() const;    ///< Wraps OrtApi::SessionGetModelMetadata
 
+  /** \brief Returns the latency statistics of the sampled kernel runs as a JSON string
+   *
+   * \param allocator to allocate memory for the returned string
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   */
+  AllocatedStringPtr GetNodeTraceStatsAllocated(OrtAllocator* allocator) const;  ///< Wraps OrtApi::SessionGetNodeTraceStats
+
+  /** \brief Returns the counters of the thread pools used by the session as a JSON string
+   *
+   * \param allocator to allocate memory for the returned string
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   */
+  AllocatedStringPtr GetThreadPoolStatsAllocated(OrtAllocator* allocator) const;  ///< Wraps OrtApi::SessionGetThreadPoolStats
+
   TypeInfo GetInputTypeInfo(size_t index) const;                   ///< Wraps OrtApi::SessionGetInputTypeInfo
   TypeInfo GetOutputTypeInfo(size_t index) const;                  ///< Wraps OrtApi::SessionGetOutputTypeInfo
   TypeInfo GetOverridableInitializerTypeInfo(size_t index) const;  ///< Wraps OrtApi::SessionGetOverridableInitializerTypeInfo
@@ -49,3 +49,18 @@ static const char* const kOrtRunOptionsConfigQnnRpcControlLatency = "qnn.rpc_con
 // If the value is set to -1, cuda graph capture/replay is disabled in that run.
 // User are not expected to set the value to 0 as it is reserved for internal use.
 static const char* const kOrtRunOptionsConfigCudaGraphAnnotation = "gpu_graph_id";
+
+// Priority of the intra-op work of the run, overriding the session config entry "session.intra_op.priority".
+// Option values: "normal", "high".
+static const char* const kOrtRunOptionsConfigIntraOpPriority = "run.intra_op.priority";
+
+// Share of the intra-op thread pool that the run may use, as a number in (0, 1], overriding the session config
+// entry "session.intra_op.thread_share".
+static const char* const kOrtRunOptionsConfigIntraOpThreadShare = "run.intra_op.thread_share";
+
+// Deadline of the run in milliseconds, counted from the call to Run or RunAsync. Fractions of a millisecond are
+// allowed. Once it passes the run stops before its next node, and long-running kernels such as SGEMM, Loop, Scan
+// and the generation operators stop between units of work. The run then fails and its outputs are discarded.
+// RunAsync requests whose deadline passed while they were queued are dropped without being run.
+// The value must be in (0, 1e9]. There is no deadline by default.
+static const char* const kOrtRunOptionsConfigDeadlineMs = "run.deadline_ms";
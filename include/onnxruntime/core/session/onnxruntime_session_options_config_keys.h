@@ -214,6 +214,32 @@ static const char* const kNodePartitionConfigFile = "session.node_partition_conf
 //    Hence 64-65 is an invalid configuration, because a windows thread cannot be attached to processors across group boundary.
 static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op_thread_affinities";
 
+// Enables NUMA-aware scheduling in the intra-op thread pool.
+// Worker threads are grouped by the NUMA node they are attached to. Workers steal work from their own node first and
+// from remote nodes only when they run out of local work, and the shards of a parallel loop started by a thread are
+// preferably dispatched to the workers of a single node so they stay close to the memory that node touched.
+// If "session.intra_op_thread_affinities" is not set, the threads are attached to the physical cores in order.
+// Has no effect on single node systems.
+// Option values:
+// - "0": NUMA-aware scheduling is disabled. [DEFAULT]
+// - "1": NUMA-aware scheduling is enabled.
+static const char* const kOrtSessionOptionsConfigIntraOpNumaAware = "session.intra_op.numa_aware";
+
+// Priority of the parallel loops and tasks that the runs of the session add to the intra-op thread pool.
+// The workers of the pool run the work of "high" priority runs before "normal" work, so that sessions sharing the
+// global thread pools (see DisablePerSessionThreads) can serve latency-critical requests next to batch workloads.
+// Can be overridden per run with "run.intra_op.priority".
+// Option values:
+// - "normal": [DEFAULT]
+// - "high"
+static const char* const kOrtSessionOptionsConfigIntraOpPriority = "session.intra_op.priority";
+
+// Share of the intra-op thread pool that a run of the session may use, as a number in (0, 1]. The parallel loops of
+// the run use at most that fraction of the threads of the pool, including the calling thread, and at least one
+// thread. Can be overridden per run with "run.intra_op.thread_share".
+// The default is "1" (all threads).
+static const char* const kOrtSessionOptionsConfigIntraOpThreadShare = "session.intra_op.thread_share";
+
 // This option will dump out the model to assist debugging any issues with layout transformation,
 // and is primarily intended for developer usage. It is only relevant if an execution provider that requests
 // NHWC layout is enabled such as NNAPI, XNNPACK or QNN.
@@ -279,3 +305,125 @@ static const char* const kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16 = "mlas
 // Refer to MatMulNBits op schema for more details.
 // If not provided, default is 4.
 static const char* const kOrtSessionOptionsQDQMatMulNBitsAccuracyLevel = "session.qdq_matmulnbits_accuracy_level";
+
+// Enables dynamic batching of RunAsync requests. Concurrently queued requests are concatenated along the batch
+// dimension, executed in a single run and the outputs are split back to the individual callbacks.
+// Dynamic batching is only enabled if all graph inputs and outputs share the same symbolic leading dimension, the
+// session has an intra-op thread pool with at least 2 threads, and the value is greater than 1.
+// Requests with pre-allocated outputs, non-CPU or string inputs are executed individually.
+// Option value: the maximum number of rows in a batched run. The default is "0" (disabled).
+static const char* const kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize = "session.dynamic_batching.max_batch_size";
+
+// The maximum time in microseconds a queued RunAsync request waits for other requests to be batched with.
+// Only used if dynamic batching is enabled via "session.dynamic_batching.max_batch_size".
+// The default is "1000".
+static const char* const kOrtSessionOptionsConfigDynamicBatchingMaxQueueDelayUs =
+    "session.dynamic_batching.max_queue_delay_us";
+
+// Maximum number of input shape buckets kept in the memory pattern cache of a session (and of each subgraph).
+// Memory patterns are cached per distinct set of input shapes. With a non-zero value the least recently used bucket is
+// evicted once the limit is exceeded, each bucket keeps the activation block of finished runs for reuse so repeated
+// runs with the same input shapes do not allocate it again, and memory patterns are also used for graphs with inputs
+// that have no shape. Requires memory patterns to be enabled.
+// The default is "0", i.e. the cache is unbounded and activation blocks are freed at the end of each run.
+static const char* const kOrtSessionOptionsConfigMemoryPatternCacheMaxEntries =
+    "session.memory_pattern_cache.max_entries";
+
+// Path of a file that caches the pre-packed weights of the CPU kernels of the session, e.g. the packed B matrix of
+// MatMul. If the file exists and was written for the same model on the same CPU feature set and ONNX Runtime version,
+// it is memory-mapped and the kernels use the pre-packed weights in it instead of packing the weights again. Otherwise
+// the file is (re)written once the session is initialized. The file is replaced atomically and can be used by
+// concurrent processes, which then share the pages of the pre-packed weights.
+// Only kernels that can restore their state from the file use it: MatMul, and MatMulNBits with 4 bit weights packed
+// without their scales. MatMulNBits packs again when the scales are part of its packed weight, i.e. with
+// accuracy_level 4 (CompInt8) on x86/x64 and for 2, 3 and 8 bit weights, which it dequantizes when packing.
+// The default is "" (disabled).
+static const char* const kOrtSessionOptionsConfigPrepackedWeightsCacheFile = "session.prepacked_weights_cache_file";
+
+// By default an ORT format model loaded from a file is memory-mapped, and the initializers larger than 127 bytes use
+// their data in the mapped file directly instead of copying it. The mapping is kept for the lifetime of the session
+// and its read-only pages are shared with other sessions and processes that load the same file.
+// Set to "1" to read the file into a buffer that is released after the session is initialized instead.
+// The default is "0".
+static const char* const kOrtSessionOptionsConfigDisableOrtModelFileMapping = "session.disable_ort_model_file_mapping";
+
+// Gemm fastmath mode computes fp32 MatMul and Gemm with bfloat16 inputs and fp32 accumulation on any platform that
+// supports it: ARM64 Linux with the BF16 extension, or x64 with AVX512-BF16 or AMX-BF16 (and an AVX2 emulation that is
+// only meant for testing). The weights are pre-packed to bfloat16.
+// "mlas.enable_gemm_fastmath_arm64_bfloat16" is the ARM64 only predecessor of this option and is still accepted.
+// Option values:
+// - "0": Gemm FastMath mode is not enabled. [DEFAULT]
+// - "1": Gemm FastMath mode is enabled if the CPU supports bfloat16 acceleration.
+// - "2": Gemm FastMath mode is enabled, and emulated if the CPU has no bfloat16 acceleration (x64 with AVX2 only).
+static const char* const kOrtSessionOptionsMlasGemmFastMathBfloat16 = "mlas.enable_gemm_fastmath_bfloat16";
+
+// By default the initializers on CPU are loaded, the kernels of the CPU EP are created and the constant weights of the
+// CPU kernels are pre-packed in parallel on the intra-op thread pool when the session is initialized. The results do
+// not depend on the number of threads.
+// Set to "1" to initialize the session sequentially, e.g. when other sessions run concurrently on a shared thread pool.
+// The default is "0".
+static const char* const kOrtSessionOptionsConfigDisableParallelInitialization =
+    "session.disable_parallel_initialization";
+
+// By default the graph transformers of each optimization level are applied to the whole graph repeatedly until none of
+// them modifies the graph or the maximum number of steps is reached.
+// Set to "1" to only apply a transformer to the whole graph in the first step, and in the following steps only to the
+// neighborhood of the nodes that were changed since it last ran. A transformer is skipped if none of these nodes has
+// one of the op types it targets. This reduces the optimization time of large models.
+// The time and the number of nodes modified by each transformer are logged at the INFO level and recorded by the
+// session profiler in both modes.
+// The default is "0".
+static const char* const kOrtSessionOptionsGraphOptimizationWorklistMode = "optimization.enable_worklist_mode";
+
+// Directory of the optimized model cache. If set, the model is saved in ORT format to a file in this directory once it
+// is optimized and partitioned, and later sessions with the same model and configuration load that file instead of
+// optimizing the model again. The file name is a hash of the model, the execution providers and their options, the
+// session options, the ONNX Runtime version and the CPU features. Graph transformers registered by the application
+// are part of the key by name and level only, so a transformer whose behavior changes needs a new name.
+// Models with nodes compiled by an execution provider are not cached, and neither are models with 2GB or more of
+// initializers, the size limit of an ORT format model. The cache is not used when loading an ORT format model or when
+// saving the optimized model with SessionOptions::optimized_model_filepath.
+// The default is "" (disabled).
+static const char* const kOrtSessionOptionsConfigOptimizedModelCacheDir = "session.optimized_model_cache_dir";
+
+// Set to "1" to share the constant CPU initializers with the other sessions of the environment that have "1" set too.
+// The initializers are looked up by a hash of their type, shape and data after the graph is optimized, so sessions
+// created from the same model with different options use a single copy of each initializer, including of the
+// initializers created by constant folding. An initializer is freed when the last session using it is destroyed or
+// has pre-packed it.
+// Initializers smaller than 128 bytes and external data used in place from the mapped file are not shared this way.
+// The default is "0".
+static const char* const kOrtSessionOptionsConfigShareInitializersAcrossSessions =
+    "session.share_initializers_across_sessions";
+
+// Maximum number of streams the CPU nodes of the main graph are partitioned into with ExecutionMode::ORT_PARALLEL.
+// The nodes are assigned to the streams by their critical path, each stream runs on a thread of the inter-op thread
+// pool, and the intra-op threads are split between the streams running at the same time.
+// "0" uses the number of threads of the inter-op thread pool, "1" runs all CPU nodes in a single stream.
+// The setting is ignored when a node partition config file is set with kNodePartitionConfigFile.
+// The default is "0".
+static const char* const kOrtSessionOptionsConfigParallelExecutionMaxCpuStreams =
+    "session.parallel_execution_max_cpu_streams";
+
+// Set to "1" to tune the intra-op parallelism of the CPU kernels from measured execution times.
+// For each node and set of input shapes, the first runs of the kernel measure it with different numbers of intra-op
+// threads and block sizes of its parallel loops, and later runs use the fastest setting. Kernels taking less than
+// about 20 microseconds with all threads keep the default. Nodes in subgraphs are not tuned.
+// The default is "0".
+static const char* const kOrtSessionOptionsConfigIntraOpParallelismTuning = "session.intra_op_parallelism_tuning";
+
+// Path of a file that keeps the settings tuned with kOrtSessionOptionsConfigIntraOpParallelismTuning. The file is
+// loaded when the session is initialized and written when it is destroyed, so later sessions of the same model use
+// the tuned settings right away. It is ignored if it was written for another model, CPU feature set, ONNX Runtime
+// version or number of intra-op threads.
+// The default is "" (the settings are not persisted).
+static const char* const kOrtSessionOptionsConfigIntraOpParallelismTuningFile =
+    "session.intra_op_parallelism_tuning_file";
+
+// Records one in N kernel runs of each thread of the session in a lock-free per-thread ring buffer: the node, the
+// start and duration of the run, the bytes of its outputs and the time it waited for the intra-op threads.
+// The overhead is low enough to keep it enabled in production. SessionGetNodeTraceStats returns the p50/p99 latency
+// per node and per op type of the recorded runs.
+// Only the nodes of the main graph are recorded.
+// The default is "0" (disabled). "1" records every kernel run.
+static const char* const kOrtSessionOptionsConfigNodeTraceSampleInterval = "session.node_trace.sample_interval";
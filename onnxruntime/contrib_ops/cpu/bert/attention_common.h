@@ -120,6 +120,10 @@ struct GroupQueryAttentionParameters {
   AttentionQkvFormat past_kv_format;
   int zeros_count;
   int* zero_ptr;
+  bool is_paged_kv_cache;       // past and present kv are block pools addressed through a block table
+  int kv_block_size;            // number of tokens per block of the paged kv cache
+  int num_kv_blocks;            // number of blocks in the paged kv cache
+  int max_blocks_per_sequence;  // dimension 1 of the block table
 };
 
 // Parameters for sparse attention.
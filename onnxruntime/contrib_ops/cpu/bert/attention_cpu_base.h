@@ -5,18 +5,29 @@
 
 #include "contrib_ops/cpu/bert/attention_base.h"
 #include "contrib_ops/cpu/bert/attention_helper.h"
+#include "contrib_ops/cpu/bert/attention_utils.h"
 #include "core/common/common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/env.h"
+#include "core/platform/env_var_utils.h"
 #include "contrib_ops/cpu/utils/dump_tensor.h"
 
+#include <type_traits>
+
 namespace onnxruntime {
 namespace contrib {
 
 class AttentionCPUBase : public AttentionBase {
  protected:
   AttentionCPUBase(const OpKernelInfo& info, bool require_same_hidden_size)
-      : AttentionBase(info, require_same_hidden_size) {}
+      : AttentionBase(info, require_same_hidden_size) {
+    l2_cache_size_ = Env::Default().GetL2CacheSize();
+    disable_flash_ = ParseEnvironmentVariableWithDefault<bool>(attention::kDisableFlashAttention, false);
+  }
+
+  bool disable_flash_;  // whether to disable MlasFlashAttention
+  int l2_cache_size_;   // L2 cache size used to choose the block sizes of MlasFlashAttention
 
   template <typename T>
   Status ApplyAttention(const T* Q,                // Q data with shape BxNxSxH
@@ -53,8 +64,55 @@ class AttentionCPUBase : public AttentionBase {
     // Total sequence length including that of past state: T = P + L
     const int total_sequence_length = past_sequence_length + kv_sequence_length;
 
-    // Merge causal mask with padding mask, and convert values from 0/1 to -inf/0, then broadcast to 3D (BxSxT).
     bool causal = (is_unidirectional_ && sequence_length > 1);
+    float scale = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(qk_head_size)) : scale_;
+
+    // Flash attention computes the softmax block by block, so the BxNxSxT probabilities are never materialized.
+    // The causal mask of the kernel is aligned to the last key, which is the mask above only when L == S.
+    if constexpr (std::is_same_v<T, float>) {
+      if (!disable_flash_ && l2_cache_size_ > 0 && mask_index == nullptr && attn_bias == nullptr &&
+          (!causal || kv_sequence_length == sequence_length)) {
+        const int head_size = qk_head_size == 0 ? v_head_size : qk_head_size;
+        const T* k = K;
+        const T* v = V;
+        if (present != nullptr || present_key != nullptr) {
+          // Combined past and present states have shape (2, B, N, P or T, H), and the values follow the keys.
+          const ptrdiff_t past_values_offset = SafeInt<ptrdiff_t>(batch_size) * num_heads_ * past_sequence_length *
+                                               head_size;
+          const ptrdiff_t present_values_offset = SafeInt<ptrdiff_t>(batch_size) * num_heads_ *
+                                                  total_sequence_length * head_size;
+          T* present_k = present != nullptr ? present->MutableData<T>() : present_key->MutableData<T>();
+          T* present_v = present != nullptr ? present_k + present_values_offset : present_value->MutableData<T>();
+          const T* past_k = past != nullptr ? past->Data<T>() : (past_key != nullptr ? past_key->Data<T>() : nullptr);
+          const T* past_v = past != nullptr ? past_k + past_values_offset
+                                            : (past_value != nullptr ? past_value->Data<T>() : nullptr);
+          ConcatPastToPresent(past_k, K, present_k, batch_size, past_sequence_length, kv_sequence_length, head_size,
+                              tp);
+          ConcatPastToPresent(past_v, V, present_v, batch_size, past_sequence_length, kv_sequence_length, v_head_size,
+                              tp);
+          k = present_k;
+          v = present_v;
+        }
+
+        MlasFlashAttentionThreadedArgs args;
+        args.batch_size = batch_size;
+        args.num_heads = num_heads_;
+        args.q_sequence_length = sequence_length;
+        args.kv_sequence_length = total_sequence_length;
+        args.qk_head_size = head_size;
+        args.v_head_size = v_head_size;
+        args.scale = scale;
+        args.is_causal = causal;
+        args.query = Q;
+        args.key = k;
+        args.value = v;
+        args.output = output->MutableData<T>();
+        RunFlashAttention(args, l2_cache_size_, allocator, tp);
+        return Status::OK();
+      }
+    }
+
+    // Merge causal mask with padding mask, and convert values from 0/1 to -inf/0, then broadcast to 3D (BxSxT).
     void* mask_data = nullptr;
     if (mask_index != nullptr || causal) {
       size_t mask_data_bytes = SafeInt<size_t>(batch_size) * sequence_length * total_sequence_length * sizeof(T);
@@ -77,8 +135,6 @@ class AttentionCPUBase : public AttentionBase {
       DUMP_CPU_TENSOR("Mask3D", static_cast<T*>(mask_data), batch_size, sequence_length, total_sequence_length);
     }
 
-    float scale = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(qk_head_size)) : scale_;
-
     const T* past_data = past != nullptr ? past->Data<T>() : nullptr;
     T* present_data = present != nullptr ? present->MutableData<T>() : nullptr;
     const T* past_key_data = past_key != nullptr ? past_key->Data<T>() : nullptr;
@@ -112,6 +168,27 @@ class AttentionCPUBase : public AttentionBase {
   }
 
  private:
+  // Concatenate past and new key or value: (BxNx)PxH, (BxNx)LxH -> (BxNx)TxH
+  template <typename T>
+  void ConcatPastToPresent(const T* past, const T* chunk, T* present, int batch_size, int past_sequence_length,
+                           int kv_sequence_length, int head_size, ThreadPool* tp) const {
+    const size_t past_chunk_length = static_cast<size_t>(past_sequence_length) * head_size;
+    const size_t kv_input_chunk_length = static_cast<size_t>(kv_sequence_length) * head_size;
+    const size_t present_chunk_length = past_chunk_length + kv_input_chunk_length;
+
+    TensorOpCost unit_cost;
+    unit_cost.bytes_loaded = static_cast<double>(present_chunk_length * sizeof(T));
+    unit_cost.bytes_stored = unit_cost.bytes_loaded;
+    unit_cost.compute_cycles = 0;
+    ThreadPool::TryParallelFor(
+        tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i != end; ++i) {
+            ConcatStateChunk(past, chunk + kv_input_chunk_length * i, present, past_chunk_length,
+                             present_chunk_length, i);
+          }
+        });
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T) +
   //                                1 x mask_data(B, N, S, T)
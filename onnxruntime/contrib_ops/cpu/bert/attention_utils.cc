@@ -2,6 +2,7 @@
 #include "core/common/common.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/transpose_helper.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/tensor/reshape_helper.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 
@@ -242,5 +243,48 @@ template Status MaybeTransposeToBNSH<float>(AllocatorPtr allocator,
                                             int batch_size, int num_heads, int sequence_length, int head_size,
                                             const Tensor* in, OrtValue& out);
 
+void RunFlashAttention(MlasFlashAttentionThreadedArgs& args, int l2_cache_size, AllocatorPtr allocator,
+                       ThreadPool* tp) {
+  const int qk_head_size = args.qk_head_size;
+  const int v_head_size = args.v_head_size;
+  /*
+    q_block_size, kv_block_size correspond to Br, Bc in the FlashAttention paper.
+    Let M = l2_cache_size / sizeof(float)
+    In the FlashAttention kernel, there are 5 big matrices that we need to keep in L2 cache:
+      slice of Q -- [Br, qk_head_size]
+      slice of K -- [Bc, qk_head_size]
+      slice of V -- [Bc, v_head_size]
+      result of QK -- [Br, Bc]
+      temporary output (same shape as QKV) -- [Br, v_head_size]
+    The total size of these matrices is (Br + Bc) * (qk_head_size + v_head_size) + Br * Bc
+    By taking Bc = M / (4 * (qk_head_size + v_head_size)), and Br = min(Bc, qk_head_size + v_head_size), we have
+      (Br + Bc) * (qk_head_size + v_head_size) + Br * Bc
+      <= 2 * Bc * (qk_head_size + v_head_size) + Br * Bc
+      <= 2 * Bc * (qk_head_size + v_head_size) + M/4
+      <= 2 * M/4 + M/4 = M * (3/4)
+
+    We leave 1/4 of the L2 cache for
+      1. storing small tensors l and m
+      2. instruction (code)
+  */
+  args.kv_block_size = l2_cache_size / (static_cast<int>(sizeof(float)) * 4 * (qk_head_size + v_head_size));
+  args.kv_block_size = std::max(args.kv_block_size, 1);  // avoid kv_block_size = 0
+  args.q_block_size = std::min(args.kv_block_size, qk_head_size + v_head_size);
+  // No point to have kv_block_size > kv_sequence_length or q_block_size > q_sequence_length
+  args.kv_block_size = std::min(args.kv_block_size, args.kv_sequence_length);
+  args.q_block_size = std::min(args.q_block_size, args.q_sequence_length);
+
+  args.thread_count = ThreadPool::DegreeOfParallelism(tp);
+  args.buffer_size_per_thread = (static_cast<size_t>(args.q_block_size) * 2 +
+                                 static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.kv_block_size) +
+                                 static_cast<size_t>(args.q_block_size) * static_cast<size_t>(v_head_size)) *
+                                sizeof(float);
+  size_t buffer_bytes = args.buffer_size_per_thread * args.thread_count;
+  IAllocatorUniquePtr<void> buffer = IAllocator::MakeUniquePtr<void>(allocator, buffer_bytes);
+
+  args.buffer = reinterpret_cast<float*>(buffer.get());
+  MlasFlashAttention(&args, tp);
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -2,6 +2,7 @@
 #include "core/common/common.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/transpose_helper.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/tensor/reshape_helper.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 
@@ -57,5 +58,10 @@ Status MaybeTransposeToBNSH(AllocatorPtr allocator,
                             int batch_size, int num_heads, int sequence_length, int head_size,
                             const Tensor* in, OrtValue& out);
 
+// Run MlasFlashAttention. The caller describes the problem in args, and the q and kv block sizes,
+// the thread count and the scratch buffer are chosen here from the L2 cache size.
+void RunFlashAttention(MlasFlashAttentionThreadedArgs& args, int l2_cache_size, AllocatorPtr allocator,
+                       concurrency::ThreadPool* tp);
+
 }  // namespace contrib
 }  // namespace onnxruntime
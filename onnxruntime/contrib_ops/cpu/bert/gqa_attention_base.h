@@ -5,11 +5,18 @@
 
 #include "contrib_ops/cpu/bert/attention_base.h"
 #include "contrib_ops/cpu/bert/attention_helper.h"
+#include "contrib_ops/cpu/bert/attention_utils.h"
 
 #include "core/common/common.h"
 #include "contrib_ops/cpu/bert/attention_common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/env.h"
+#include "core/platform/env_var_utils.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
 
 namespace onnxruntime {
 namespace contrib {
@@ -31,6 +38,9 @@ class GQAAttentionBase {
     rotary_interleaved_ = info.GetAttrOrDefault<int64_t>("rotary_interleaved", 0) == 1;
 
     local_window_size_ = has_local ? static_cast<int>(info.GetAttrOrDefault<int64_t>("local_window_size", -1)) : -1;
+
+    l2_cache_size_ = Env::Default().GetL2CacheSize();
+    disable_flash_ = ParseEnvironmentVariableWithDefault<bool>(attention::kDisableFlashAttention, false);
   }
 
   int num_heads_;     // number of attention heads of Q
@@ -39,6 +49,8 @@ class GQAAttentionBase {
   bool do_rotary_;    // whether or not to use rotary embeddings
   bool rotary_interleaved_;
   int local_window_size_;
+  bool disable_flash_;  // whether to disable MlasFlashAttention
+  int l2_cache_size_;   // L2 cache size used to choose the block sizes of MlasFlashAttention
 
   template <typename T>
   Status ApplyAttention(const T* Q,                                 // Q data with shape BxNxSxH
@@ -50,6 +62,7 @@ class GQAAttentionBase {
                         Tensor* present_key,                        // present K output tensor (if separating present KV)
                         Tensor* present_value,                      // present V output tensor (if separating present KV)
                         const Tensor* seqlens_k,                    // past sequence lengths tensor
+                        const Tensor* block_table,                  // block table of the paged KV cache (optional)
                         GroupQueryAttentionParameters& parameters,  // attention parameters
                         AllocatorPtr allocator,                     // allocator for temporary tensors
                         OpKernelContext* context) const {
@@ -61,17 +74,17 @@ class GQAAttentionBase {
 
     auto* tp = context->GetOperatorThreadPool();
 
+    if (parameters.is_paged_kv_cache) {
+      return ApplyPagedAttention(Q, K, V, past_key, past_value, output, present_key, present_value, seqlens_k,
+                                 block_table, parameters, allocator, tp);
+    }
+
     int seqlen_past_kv_cache = 0;
     if (past_key != nullptr && past_value != nullptr) {
       seqlen_past_kv_cache = static_cast<int>(past_key->Shape().GetDims()[2]);
     }
     int seqlen_present_kv_cache = static_cast<int>(present_key->Shape().GetDims()[2]);
 
-    // Compute the attention score.
-    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(T);
-    auto attention_probs = allocator->Alloc(bytes);
-    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
-
     const T* past_key_data = past_key != nullptr ? past_key->Data<T>() : nullptr;
     T* present_key_data = present_key != nullptr ? present_key->MutableData<T>() : nullptr;
     const T* past_value_data = past_value != nullptr ? past_value->Data<T>() : nullptr;
@@ -79,6 +92,20 @@ class GQAAttentionBase {
 
     bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
 
+    if constexpr (std::is_same_v<T, float>) {
+      if (!disable_flash_ && l2_cache_size_ > 0) {
+        ApplyFlashAttention(Q, K, V, past_key_data, past_value_data, output->MutableData<T>(), present_key_data,
+                            present_value_data, seqlens_k->Data<int32_t>(), parameters, seqlen_past_kv_cache,
+                            seqlen_present_kv_cache, past_present_share_buffer, allocator, tp);
+        return Status::OK();
+      }
+    }
+
+    // Compute the attention score.
+    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(T);
+    auto attention_probs = allocator->Alloc(bytes);
+    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+
     const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
     ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, k, seqlens_k->Data<int32_t>(), batch_size,
                              sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache, head_size, past_key_data,
@@ -95,6 +122,99 @@ class GQAAttentionBase {
   }
 
  private:
+  // Attention with MlasFlashAttention, which computes the softmax block by block so that the BxNxSxT probabilities are
+  // never materialized. The new key and value are appended to the present buffers first, and the kernel attends to the
+  // first seqlens_k + 1 tokens of each sequence with the causal mask and the local window.
+  void ApplyFlashAttention(const float* Q,                                   // Q data with shape BxNxSxH
+                           const float* K,                                   // K data with shape BxN_kvxSxH
+                           const float* V,                                   // V data with shape BxN_kvxSxH
+                           const float* past_key,                            // past key only
+                           const float* past_value,                          // past value only
+                           float* output,                                    // output with shape BxSxNxH
+                           float* present_key,                               // present key only
+                           float* present_value,                             // present value only
+                           const int32_t* seqlens_k,                         // past sequence lengths
+                           const GroupQueryAttentionParameters& parameters,  // attention parameters
+                           int past_buffer_sequence_length,                  // sequence length of past state
+                           int present_buffer_sequence_length,               // sequence length of present state
+                           bool past_present_share_buffer,                   // whether past and present share buffers
+                           AllocatorPtr allocator,                           // allocator for temporary tensors
+                           ThreadPool* tp) const {
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const bool packed_qkv = parameters.is_packed_qkv;
+    const bool is_prompt = sequence_length != 1;
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const size_t kv_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;
+    const size_t past_buff_chunk_length = static_cast<size_t>(past_buffer_sequence_length) * head_size;
+    const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;
+
+    if (!past_present_share_buffer) {
+      const size_t present_bytes = SafeInt<size_t>(batch_size) * kv_num_heads_ * present_buff_chunk_length *
+                                   sizeof(float);
+      memset(present_key, 0, present_bytes);
+      memset(present_value, 0, present_bytes);
+    }
+
+    const float* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
+    const float* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
+
+    TensorOpCost unit_cost;
+    unit_cost.bytes_loaded = static_cast<double>(2 * present_buff_chunk_length * sizeof(float));
+    unit_cost.bytes_stored = unit_cost.bytes_loaded;
+    unit_cost.compute_cycles = 0;
+    ThreadPool::TryParallelFor(
+        tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i != end; ++i) {
+            const int batch_index = static_cast<int>(i / kv_num_heads_);
+            const int head_index = static_cast<int>(i % kv_num_heads_);
+            const int past_seqlen = is_prompt ? past_buffer_sequence_length : static_cast<int>(seqlens_k[batch_index]);
+            const size_t past_chunk_length = static_cast<size_t>(past_seqlen) * head_size;
+            const ptrdiff_t chunk_length = static_cast<ptrdiff_t>(kv_input_chunk_length);
+            const ptrdiff_t input_offset = packed_qkv ? packed_batch_stride * batch_index + chunk_length * head_index
+                                                      : chunk_length * i;
+            ConcatStateChunkGQA(past_key, k + input_offset, present_key, present_buff_chunk_length,
+                                past_buff_chunk_length, past_chunk_length, kv_input_chunk_length, is_prompt,
+                                past_present_share_buffer, i);
+            ConcatStateChunkGQA(past_value, v + input_offset, present_value, present_buff_chunk_length,
+                                past_buff_chunk_length, past_chunk_length, kv_input_chunk_length, is_prompt,
+                                past_present_share_buffer, i);
+          }
+        });
+
+    // Query i of a prompt is at position i, and the query of token generation follows the past tokens.
+    std::vector<int> kv_sequence_lengths(batch_size);
+    std::vector<int> past_sequence_lengths(batch_size);
+    for (int b = 0; b < batch_size; b++) {
+      kv_sequence_lengths[b] = seqlens_k[b] + 1;
+      past_sequence_lengths[b] = is_prompt ? 0 : seqlens_k[b];
+    }
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = batch_size;
+    args.num_heads = num_heads_;
+    args.q_sequence_length = sequence_length;
+    args.kv_sequence_length = *std::max_element(kv_sequence_lengths.begin(), kv_sequence_lengths.end());
+    args.qk_head_size = head_size;
+    args.v_head_size = head_size;
+    args.scale = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    args.kv_num_heads = kv_num_heads_;
+    args.kv_buffer_sequence_length = present_buffer_sequence_length;
+    args.q_batch_stride = static_cast<size_t>(packed_batch_stride);
+    args.kv_sequence_lengths = kv_sequence_lengths.data();
+    args.is_causal = true;
+    args.past_sequence_lengths = past_sequence_lengths.data();
+    args.local_window_size = local_window_size_;
+    args.query = Q;
+    args.key = present_key;
+    args.value = present_value;
+    args.output = output;
+    RunFlashAttention(args, l2_cache_size_, std::move(allocator), tp);
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T)
   //  attention_probs(B, N, S, T) = Softmax(attention_probs)
@@ -187,29 +307,35 @@ class GQAAttentionBase {
                                     head_size, k, head_size, 0.0f /*bata*/, output, present_buffer_sequence_length,
                                     nullptr);
 
-        // compute Softmax
-        T* output_softmax = output;
-        for (int seq = 0; seq < sequence_length; seq++) {
-          int seq_causal_length = sequence_length == 1 ? total_seqlen : seq + 1;
-          if (local_window_size_ > 0 && seq_causal_length > local_window_size_ + 1) {
-            for (int total_seq_id = 0; total_seq_id < seq_causal_length - local_window_size_ - 1; total_seq_id++) {
-              output_softmax[total_seq_id] = 0.f;
-            }
-            ComputeAttentionSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
-                                           local_window_size_ + 1, nullptr);
-          } else {
-            ComputeAttentionSoftmaxInplace(output_softmax, 1, seq_causal_length, nullptr);
-          }
-
-          // set causal [seq_causal_length, total_seqlen) to 0.f
-          for (int total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
-            output_softmax[total_seq_id] = 0.f;
-          }
+        ComputeCausalSoftmax(output, sequence_length, total_seqlen, present_buffer_sequence_length);
+      }
+    });
+  }
 
-          output_softmax += present_buffer_sequence_length;
+  // Softmax over the scores of one head, i.e. S rows of total_seqlen valid scores each with stride row_stride.
+  // Scores outside of the causal mask or the local window are set to 0.
+  template <typename T>
+  void ComputeCausalSoftmax(T* output, int sequence_length, int total_seqlen, int row_stride) const {
+    T* output_softmax = output;
+    for (int seq = 0; seq < sequence_length; seq++) {
+      int seq_causal_length = sequence_length == 1 ? total_seqlen : seq + 1;
+      if (local_window_size_ > 0 && seq_causal_length > local_window_size_ + 1) {
+        for (int total_seq_id = 0; total_seq_id < seq_causal_length - local_window_size_ - 1; total_seq_id++) {
+          output_softmax[total_seq_id] = 0.f;
         }
+        ComputeAttentionSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
+                                       local_window_size_ + 1, nullptr);
+      } else {
+        ComputeAttentionSoftmaxInplace(output_softmax, 1, seq_causal_length, nullptr);
       }
-    });
+
+      // set causal [seq_causal_length, total_seqlen) to 0.f
+      for (int total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
+        output_softmax[total_seq_id] = 0.f;
+      }
+
+      output_softmax += row_stride;
+    }
   }
 
   template <typename T>
@@ -292,6 +418,211 @@ class GQAAttentionBase {
           }
         });
   }
+
+  // Attention with a paged KV cache. The key and value of token t of batch b are stored at row t % block_size of block
+  // block_table[b][t / block_size] of the block pools, i.e. past_key and past_value with shape
+  // (num_blocks, N_kv, block_size, H). The new tokens are written into the present pools, which are normally the same
+  // buffers as the past pools, and Q*K' and the attention score * V are computed block by block.
+  template <typename T>
+  Status ApplyPagedAttention(const T* Q,                                       // Q data with shape BxNxSxH
+                             const T* K,                                       // K data with shape BxN_kvxSxH
+                             const T* V,                                       // V data with shape BxN_kvxSxH
+                             const Tensor* past_key,                           // past key block pool
+                             const Tensor* past_value,                         // past value block pool
+                             Tensor* output,                                   // output tensor
+                             Tensor* present_key,                              // present key block pool
+                             Tensor* present_value,                            // present value block pool
+                             const Tensor* seqlens_k,                          // past sequence lengths tensor
+                             const Tensor* block_table,                        // block table with shape BxMB
+                             const GroupQueryAttentionParameters& parameters,  // attention parameters
+                             AllocatorPtr allocator,                           // allocator for temporary tensors
+                             ThreadPool* tp) const {
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const bool packed_qkv = parameters.is_packed_qkv;
+    const int present_sequence_length = parameters.seqlen_present_kv_cache;
+
+    T* key_cache = present_key->MutableData<T>();
+    T* value_cache = present_value->MutableData<T>();
+    if (key_cache != past_key->Data<T>()) {
+      memcpy(key_cache, past_key->Data<T>(), past_key->SizeInBytes());
+    }
+    if (value_cache != past_value->Data<T>()) {
+      memcpy(value_cache, past_value->Data<T>(), past_value->SizeInBytes());
+    }
+
+    const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+    const int32_t* block_table_data = block_table->Data<int32_t>();
+    const ptrdiff_t kv_batch_stride =
+        SafeInt<ptrdiff_t>(packed_qkv ? num_heads_ + 2 * kv_num_heads_ : kv_num_heads_) * sequence_length * head_size;
+    const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
+    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
+    WritePagedKVCache(key_cache, k, kv_batch_stride, seqlens_k_data, block_table_data, parameters, tp);
+    WritePagedKVCache(value_cache, v, kv_batch_stride, seqlens_k_data, block_table_data, parameters, tp);
+
+    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * present_sequence_length * sizeof(T);
+    auto attention_probs = allocator->Alloc(bytes);
+    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+
+    ComputePagedAttentionProbs(static_cast<T*>(attention_probs), Q, key_cache, seqlens_k_data, block_table_data,
+                               parameters, tp);
+    ComputePagedVxAttentionScore(output->MutableData<T>(), static_cast<const T*>(attention_probs), value_cache,
+                                 seqlens_k_data, block_table_data, parameters, tp);
+    return Status::OK();
+  }
+
+  // Copy the new key or value tokens of each sequence into the block pool.
+  template <typename T>
+  void WritePagedKVCache(T* cache,                                         // block pool with shape NBxN_kvxBSxH
+                         const T* chunk,                                   // new tokens with shape BxN_kvxSxH
+                         ptrdiff_t chunk_batch_stride,                     // stride of the batches of chunk
+                         const int32_t* seqlens_k,                         // past sequence lengths
+                         const int32_t* block_table,                       // block table with shape BxMB
+                         const GroupQueryAttentionParameters& parameters,  // attention parameters
+                         ThreadPool* tp) const {
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const int block_size = parameters.kv_block_size;
+    const int max_blocks_per_sequence = parameters.max_blocks_per_sequence;
+    const size_t bytes_per_token = SafeInt<size_t>(head_size) * sizeof(T);
+
+    TensorOpCost unit_cost;
+    unit_cost.bytes_loaded = static_cast<double>(sequence_length * bytes_per_token);
+    unit_cost.bytes_stored = unit_cost.bytes_loaded;
+    unit_cost.compute_cycles = 0;
+
+    ThreadPool::TryParallelFor(
+        tp, SafeInt<ptrdiff_t>(parameters.batch_size) * kv_num_heads_, unit_cost,
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i != end; ++i) {
+            const int batch_index = static_cast<int>(i / kv_num_heads_);
+            const int head_index = static_cast<int>(i % kv_num_heads_);
+            const int past_seqlen = parameters.is_prompt ? 0 : static_cast<int>(seqlens_k[batch_index]);
+            const int32_t* blocks = block_table + static_cast<ptrdiff_t>(batch_index) * max_blocks_per_sequence;
+            const T* src = chunk + chunk_batch_stride * batch_index +
+                           static_cast<ptrdiff_t>(head_index) * sequence_length * head_size;
+            for (int seq = 0; seq < sequence_length; seq++) {
+              const int position = past_seqlen + seq;
+              const ptrdiff_t row = (SafeInt<ptrdiff_t>(blocks[position / block_size]) * kv_num_heads_ + head_index) *
+                                        block_size +
+                                    position % block_size;
+              memcpy(cache + row * head_size, src + static_cast<ptrdiff_t>(seq) * head_size, bytes_per_token);
+            }
+          }
+        });
+  }
+
+  // attention_probs(B, N, S, T) = Softmax(1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T)) with K gathered
+  // from the blocks of each sequence.
+  template <typename T>
+  void ComputePagedAttentionProbs(T* attention_probs,                                // output buffer with size BxNxSxT
+                                  const T* Q,                                       // Q data. Its size is BxNxSxH
+                                  const T* key_cache,                               // key block pool
+                                  const int32_t* seqlens_k,                         // past sequence lengths
+                                  const int32_t* block_table,                       // block table with shape BxMB
+                                  const GroupQueryAttentionParameters& parameters,  // attention parameters
+                                  ThreadPool* tp) const {
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const int block_size = parameters.kv_block_size;
+    const int max_blocks_per_sequence = parameters.max_blocks_per_sequence;
+    const int present_sequence_length = parameters.seqlen_present_kv_cache;
+    const ptrdiff_t q_batch_stride =
+        SafeInt<ptrdiff_t>(parameters.is_packed_qkv ? num_heads_ + 2 * kv_num_heads_ : num_heads_) *
+        sequence_length * head_size;
+    const int kv_num_heads_factor = num_heads_ / kv_num_heads_;
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+
+    TensorOpCost unit_cost;
+    const ptrdiff_t probs_matrix_bytes = SafeInt<ptrdiff_t>(sequence_length) * present_sequence_length * sizeof(T);
+    unit_cost.compute_cycles =
+        static_cast<double>(SafeInt<ptrdiff_t>(2) * sequence_length * head_size * present_sequence_length);
+    unit_cost.bytes_loaded =
+        static_cast<double>((sequence_length + present_sequence_length) * head_size * sizeof(T) + probs_matrix_bytes);
+    unit_cost.bytes_stored = static_cast<double>(2 * probs_matrix_bytes);
+
+    ThreadPool::TryParallelFor(
+        tp, SafeInt<ptrdiff_t>(parameters.batch_size) * num_heads_, unit_cost,
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i != end; ++i) {
+            const int batch_index = static_cast<int>(i / num_heads_);
+            const int head_index = static_cast<int>(i % num_heads_);
+            const int kv_head_index = head_index / kv_num_heads_factor;
+            const int total_seqlen = seqlens_k[batch_index] + 1;
+            const int32_t* blocks = block_table + static_cast<ptrdiff_t>(batch_index) * max_blocks_per_sequence;
+
+            const T* q = Q + q_batch_stride * batch_index +
+                         static_cast<ptrdiff_t>(head_index) * sequence_length * head_size;
+            const ptrdiff_t output_offset = SafeInt<ptrdiff_t>(i) * sequence_length * present_sequence_length;
+            T* output = attention_probs + output_offset;
+            for (int start = 0; start < total_seqlen; start += block_size) {
+              const int block_length = std::min(block_size, total_seqlen - start);
+              const ptrdiff_t block_offset =
+                  (SafeInt<ptrdiff_t>(blocks[start / block_size]) * kv_num_heads_ + kv_head_index) * block_size *
+                  head_size;
+              const T* k = key_cache + block_offset;
+              math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, block_length, head_size, alpha,
+                                          q, head_size, k, head_size, 0.0f /*beta*/, output + start,
+                                          present_sequence_length, nullptr);
+            }
+
+            ComputeCausalSoftmax(output, sequence_length, total_seqlen, present_sequence_length);
+          }
+        });
+  }
+
+  // output(B, S, N, H) = attention_probs(B, N, S, T) x V(B, N, T, H) with V gathered from the blocks of each sequence.
+  template <typename T>
+  void ComputePagedVxAttentionScore(T* output,                                        // output with size BxSxNxH
+                                    const T* attention_probs,                         // probs with size BxNxSxT
+                                    const T* value_cache,                             // value block pool
+                                    const int32_t* seqlens_k,                         // past sequence lengths
+                                    const int32_t* block_table,                       // block table with shape BxMB
+                                    const GroupQueryAttentionParameters& parameters,  // attention parameters
+                                    ThreadPool* tp) const {
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const int hidden_size = parameters.hidden_size;
+    const int block_size = parameters.kv_block_size;
+    const int max_blocks_per_sequence = parameters.max_blocks_per_sequence;
+    const int present_sequence_length = parameters.seqlen_present_kv_cache;
+    const int kv_num_heads_factor = num_heads_ / kv_num_heads_;
+
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles =
+        static_cast<double>(SafeInt<ptrdiff_t>(2) * sequence_length * head_size * present_sequence_length);
+    unit_cost.bytes_loaded = static_cast<double>(SafeInt<ptrdiff_t>(sequence_length + head_size) *
+                                                 present_sequence_length * sizeof(T));
+    unit_cost.bytes_stored = static_cast<double>(sequence_length * head_size * sizeof(T));
+
+    ThreadPool::TryParallelFor(
+        tp, SafeInt<ptrdiff_t>(parameters.batch_size) * num_heads_, unit_cost,
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i != end; ++i) {
+            const int batch_index = static_cast<int>(i / num_heads_);
+            const int head_index = static_cast<int>(i % num_heads_);
+            const int kv_head_index = head_index / kv_num_heads_factor;
+            const int total_seqlen = seqlens_k[batch_index] + 1;
+            const int32_t* blocks = block_table + static_cast<ptrdiff_t>(batch_index) * max_blocks_per_sequence;
+
+            T* output_current = output + (batch_index * sequence_length * num_heads_ + head_index) * head_size;
+            const ptrdiff_t probs_offset = SafeInt<ptrdiff_t>(i) * sequence_length * present_sequence_length;
+            const T* probs = attention_probs + probs_offset;
+            for (int start = 0; start < total_seqlen; start += block_size) {
+              const int block_length = std::min(block_size, total_seqlen - start);
+              const ptrdiff_t block_offset =
+                  (SafeInt<ptrdiff_t>(blocks[start / block_size]) * kv_num_heads_ + kv_head_index) * block_size *
+                  head_size;
+              const T* v = value_cache + block_offset;
+              // accumulate the contribution of each block
+              math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasNoTrans, sequence_length, head_size, block_length,
+                                          1.f /*alpha*/, probs + start, present_sequence_length, v, head_size,
+                                          start == 0 ? 0.0f : 1.0f /*beta*/, output_current, hidden_size, nullptr);
+            }
+          }
+        });
+  }
 };
 
 }  // namespace contrib
@@ -30,7 +30,9 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
     kCpuExecutionProvider,
     KernelDefBuilder()
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
-        .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()),
+        .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>())
+        .MayInplace(3, 1)
+        .MayInplace(4, 2),
     GroupQueryAttention<float>);
 
 template <typename T>
@@ -48,14 +50,17 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   const Tensor* total_seqlen = context->Input<Tensor>(6);
   const Tensor* cos_cache = context->Input<Tensor>(7);
   const Tensor* sin_cache = context->Input<Tensor>(8);
+  const Tensor* block_table = context->Input<Tensor>(9);
+  const bool is_paged_kv_cache = block_table != nullptr;
 
   GroupQueryAttentionParameters parameters = {};
   constexpr float scale = 1.0f;
+  // The paged past key and value are block pools, which are validated separately.
   ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckInputs(query,
                                                                 key,
                                                                 value,
-                                                                past_key,
-                                                                past_value,
+                                                                is_paged_kv_cache ? nullptr : past_key,
+                                                                is_paged_kv_cache ? nullptr : past_value,
                                                                 cos_cache,
                                                                 sin_cache,
                                                                 &parameters,
@@ -64,6 +69,10 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
                                                                 seqlens_k,
                                                                 total_seqlen,
                                                                 scale));
+  if (is_paged_kv_cache) {
+    ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckPagedKVCache(past_key, past_value, block_table, seqlens_k,
+                                                                        &parameters));
+  }
 
   const int batch_size = parameters.batch_size;
   const int sequence_length = parameters.sequence_length;
@@ -80,6 +89,12 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
 
   std::vector<int64_t> present_k_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
   std::vector<int64_t> present_v_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
+  if (is_paged_kv_cache) {
+    // The present key and value are the updated block pools.
+    const auto pool_dims = past_key->Shape().GetDims();
+    present_k_shape.assign(pool_dims.begin(), pool_dims.end());
+    present_v_shape.assign(pool_dims.begin(), pool_dims.end());
+  }
   Tensor* present_k = context->Output(1, present_k_shape);
   Tensor* present_v = context->Output(2, present_v_shape);
 
@@ -179,7 +194,7 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   // Compute the attention score and apply the score to V
   return ApplyAttention(Q.Get<Tensor>().Data<T>(), packed_qkv ? nullptr : K.Get<Tensor>().Data<T>(),
                         packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), past_key, past_value, output, present_k, present_v,
-                        seqlens_k, parameters, allocator, context);
+                        seqlens_k, block_table, parameters, allocator, context);
 }
 }  // namespace contrib
 }  // namespace onnxruntime
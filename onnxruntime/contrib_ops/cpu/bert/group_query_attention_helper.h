@@ -263,6 +263,89 @@ Status CheckInputs(const Tensor* query,
 
   return CheckInputs(query, key, value, past_key, past_value, cos_cache, sin_cache, parameters, num_heads, kv_num_heads, seqlens_k, total_seqlen, scale);
 }
+
+// Check the paged KV cache inputs. CheckInputs shall be called first without past_key and past_value.
+Status CheckPagedKVCache(const Tensor* past_key,
+                         const Tensor* past_value,
+                         const Tensor* block_table,
+                         const Tensor* seqlens_k,
+                         void* parameters) {
+  // Note: Here NB is number of blocks, BS is block size and MB is max number of blocks per sequence
+  //     past_key                   : (NB, N_k, BS, H)
+  //     past_value                 : (NB, N_k, BS, H)
+  //     block_table                : (B, MB)
+  GroupQueryAttentionParameters* output_parameters = reinterpret_cast<GroupQueryAttentionParameters*>(parameters);
+  if (past_key == nullptr || past_value == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'past_key' and 'past_value' are required when 'block_table' is given.");
+  }
+
+  const auto& past_key_dims = past_key->Shape().GetDims();
+  if (past_key_dims.size() != 4) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Paged input 'past_key' is expected to have 4 dimensions, got ", past_key_dims.size());
+  }
+  if (past_value->Shape() != past_key->Shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Paged input 'past_key' and 'past_value' shall have the same shape.");
+  }
+  if (past_key_dims[1] != output_parameters->kv_num_heads) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Paged input 'past_key' dimension 1 should be kv_num_heads, got ", past_key_dims[1]);
+  }
+  if (past_key_dims[2] <= 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Paged input 'past_key' dimension 2 (block size) shall be positive.");
+  }
+  if (past_key_dims[3] != output_parameters->head_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Paged input 'past_key' dimension 3 should be same as head_size, got ", past_key_dims[3]);
+  }
+
+  const auto& block_table_dims = block_table->Shape().GetDims();
+  if (block_table_dims.size() != 2 || block_table_dims[0] != output_parameters->batch_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "block_table must be shape (batch_size, max_blocks_per_sequence).");
+  }
+
+  const int num_blocks = static_cast<int>(past_key_dims[0]);
+  const int block_size = static_cast<int>(past_key_dims[2]);
+  const int max_blocks_per_sequence = static_cast<int>(block_table_dims[1]);
+  const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+  const int32_t* block_table_data = block_table->Data<int32_t>();
+  for (int b = 0; b < output_parameters->batch_size; b++) {
+    // The prompt writes all (padded) sequence_length tokens of the sequence. Token generation appends one token.
+    int num_tokens = seqlens_k_data[b] + 1;
+    if (output_parameters->is_prompt) {
+      num_tokens = std::max(num_tokens, output_parameters->sequence_length);
+    }
+    if (seqlens_k_data[b] < 0 || num_tokens > output_parameters->seqlen_present_kv_cache) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "seqlens_k of batch ", b, " does not fit in total_sequence_length.");
+    }
+    const int num_sequence_blocks = (num_tokens + block_size - 1) / block_size;
+    if (num_sequence_blocks > max_blocks_per_sequence) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "block_table of batch ", b, " needs ", num_sequence_blocks, " blocks, got ",
+                             max_blocks_per_sequence);
+    }
+    for (int i = 0; i < num_sequence_blocks; i++) {
+      const int32_t block = block_table_data[b * max_blocks_per_sequence + i];
+      if (block < 0 || block >= num_blocks) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "block_table of batch ", b, " refers to block ", block, " out of range [0, ",
+                               num_blocks, ").");
+      }
+    }
+  }
+
+  output_parameters->is_paged_kv_cache = true;
+  output_parameters->kv_share_buffer = true;
+  output_parameters->kv_block_size = block_size;
+  output_parameters->num_kv_blocks = num_blocks;
+  output_parameters->max_blocks_per_sequence = max_blocks_per_sequence;
+  return Status::OK();
+}
 }  // namespace group_query_attention_helper
 }  // namespace contrib
 }  // namespace onnxruntime
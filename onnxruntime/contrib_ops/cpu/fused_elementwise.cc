@@ -0,0 +1,443 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/fused_elementwise.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/common/inlined_containers.h"
+#include "core/common/narrow.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+namespace {
+
+// Number of elements evaluated by the whole program before moving on. Large enough to amortize the per-op
+// dispatch, small enough that the scratch blocks of a typical program stay in the L1 cache.
+constexpr std::ptrdiff_t kBlockSize = 1024;
+
+using OpCode = FusedElementwise::OpCode;
+
+double OpCost(OpCode op) {
+  switch (op) {
+    case OpCode::Sigmoid:
+    case OpCode::Tanh:
+    case OpCode::Exp:
+    case OpCode::Erf:
+      return 10.0;
+    case OpCode::Div:
+    case OpCode::Sqrt:
+    case OpCode::Reciprocal:
+      return 4.0;
+    default:
+      return 1.0;
+  }
+}
+
+void Evaluate(OpCode op, const float* a, const float* b, float* y, std::ptrdiff_t n) {
+  ConstEigenVectorArrayMap<float> xa(a, n);
+  EigenVectorArrayMap<float> ym(y, n);
+
+  switch (op) {
+    case OpCode::Add:
+      ym = xa + ConstEigenVectorArrayMap<float>(b, n);
+      break;
+    case OpCode::Sub:
+      ym = xa - ConstEigenVectorArrayMap<float>(b, n);
+      break;
+    case OpCode::Mul:
+      ym = xa * ConstEigenVectorArrayMap<float>(b, n);
+      break;
+    case OpCode::Div:
+      ym = xa / ConstEigenVectorArrayMap<float>(b, n);
+      break;
+    case OpCode::Max:
+      ym = xa.max(ConstEigenVectorArrayMap<float>(b, n));
+      break;
+    case OpCode::Min:
+      ym = xa.min(ConstEigenVectorArrayMap<float>(b, n));
+      break;
+    case OpCode::Relu:
+      ym = xa.cwiseMax(0.0f);
+      break;
+    case OpCode::Sigmoid:
+      MlasComputeLogistic(a, y, narrow<size_t>(n));
+      break;
+    case OpCode::Tanh:
+      MlasComputeTanh(a, y, narrow<size_t>(n));
+      break;
+    case OpCode::Exp:
+      MlasComputeExp(a, y, narrow<size_t>(n));
+      break;
+    case OpCode::Erf:
+      MlasComputeErf(a, y, narrow<size_t>(n));
+      break;
+    case OpCode::Neg:
+      ym = -xa;
+      break;
+    case OpCode::Abs:
+      ym = xa.abs();
+      break;
+    case OpCode::Sqrt:
+      ym = xa.sqrt();
+      break;
+    case OpCode::Reciprocal:
+      ym = xa.inverse();
+      break;
+  }
+}
+
+// How an input is read for a block of the output. The dims of the output are merged into runs along which the
+// input is either broadcast (stride 0) or read contiguously, e.g. a bias of shape (C, 1, 1) for an output of shape
+// (N, C, H, W) has the runs (N, C, H * W) with the strides (0, 1, 0).
+struct InputBroadcast {
+  enum class Kind {
+    // the input has the output shape
+    Full,
+    // the input has a single element
+    Scalar,
+    // the input broadcasts from its trailing dims, so it repeats with a period of its size
+    Periodic,
+    // any other broadcast, gathered run by run
+    Gather,
+  };
+
+  Kind kind;
+  TensorShapeVector dims;
+  TensorShapeVector strides;
+};
+
+// Returns false if `input` does not broadcast to `output`.
+bool GetInputBroadcast(const TensorShape& input, const TensorShape& output, InputBroadcast& broadcast) {
+  const auto input_dims = input.GetDims();
+  const auto output_dims = output.GetDims();
+  if (input_dims.size() > output_dims.size()) {
+    return false;
+  }
+
+  // broadcast flag of each run, from the outermost
+  InlinedVector<bool> is_broadcast;
+  broadcast.dims.clear();
+  const size_t offset = output_dims.size() - input_dims.size();
+  for (size_t i = 0; i < output_dims.size(); ++i) {
+    const int64_t input_dim = i < offset ? 1 : input_dims[i - offset];
+    if (input_dim != output_dims[i] && input_dim != 1) {
+      return false;
+    }
+    if (output_dims[i] == 1) {
+      continue;
+    }
+    const bool broadcast_dim = input_dim != output_dims[i];
+    if (!is_broadcast.empty() && is_broadcast.back() == broadcast_dim) {
+      broadcast.dims.back() *= output_dims[i];
+    } else {
+      is_broadcast.push_back(broadcast_dim);
+      broadcast.dims.push_back(output_dims[i]);
+    }
+  }
+
+  broadcast.strides.assign(broadcast.dims.size(), 0);
+  int64_t stride = 1;
+  for (size_t i = broadcast.dims.size(); i-- > 0;) {
+    if (!is_broadcast[i]) {
+      broadcast.strides[i] = stride;
+      stride *= broadcast.dims[i];
+    }
+  }
+
+  if (std::none_of(is_broadcast.begin(), is_broadcast.end(), [](bool b) { return !b; })) {
+    broadcast.kind = input.Size() == output.Size() ? InputBroadcast::Kind::Full : InputBroadcast::Kind::Scalar;
+  } else if (is_broadcast.size() == 1) {
+    broadcast.kind = InputBroadcast::Kind::Full;
+  } else if (is_broadcast.size() == 2 && is_broadcast[0]) {
+    broadcast.kind = InputBroadcast::Kind::Periodic;
+  } else {
+    broadcast.kind = InputBroadcast::Kind::Gather;
+  }
+  return true;
+}
+
+// Writes the elements [start, start + n) of `data` broadcast to the output into `block`, a run of the innermost
+// merged dim at a time.
+void GatherBlock(const float* data, const InputBroadcast& broadcast, std::ptrdiff_t start, std::ptrdiff_t n,
+                 float* block) {
+  const auto& dims = broadcast.dims;
+  const auto& strides = broadcast.strides;
+  const size_t inner = dims.size() - 1;
+
+  InlinedVector<int64_t> index(dims.size());
+  int64_t offset = 0;
+  int64_t remainder = start;
+  for (size_t i = dims.size(); i-- > 0;) {
+    index[i] = remainder % dims[i];
+    remainder /= dims[i];
+    offset += index[i] * strides[i];
+  }
+
+  for (std::ptrdiff_t copied = 0; copied < n;) {
+    const std::ptrdiff_t count = std::min<std::ptrdiff_t>(dims[inner] - index[inner], n - copied);
+    if (strides[inner] == 0) {
+      std::fill_n(block + copied, count, data[offset]);
+    } else {
+      std::memcpy(block + copied, data + offset, narrow<size_t>(count) * sizeof(float));
+    }
+    copied += count;
+
+    // move to the start of the next run
+    index[inner] += count;
+    offset += count * strides[inner];
+    for (size_t i = inner; i > 0 && index[i] == dims[i]; --i) {
+      offset += strides[i - 1] - index[i] * strides[i];
+      index[i] = 0;
+      ++index[i - 1];
+    }
+  }
+}
+
+}  // namespace
+
+std::optional<OpCode> FusedElementwise::ParseOpCode(std::string_view op_type) {
+  static const std::pair<std::string_view, OpCode> op_codes[] = {
+      {"Add", OpCode::Add},
+      {"Sub", OpCode::Sub},
+      {"Mul", OpCode::Mul},
+      {"Div", OpCode::Div},
+      {"Max", OpCode::Max},
+      {"Min", OpCode::Min},
+      {"Relu", OpCode::Relu},
+      {"Sigmoid", OpCode::Sigmoid},
+      {"Tanh", OpCode::Tanh},
+      {"Exp", OpCode::Exp},
+      {"Erf", OpCode::Erf},
+      {"Neg", OpCode::Neg},
+      {"Abs", OpCode::Abs},
+      {"Sqrt", OpCode::Sqrt},
+      {"Reciprocal", OpCode::Reciprocal},
+  };
+
+  for (const auto& [name, op] : op_codes) {
+    if (name == op_type) {
+      return op;
+    }
+  }
+
+  return std::nullopt;
+}
+
+bool FusedElementwise::IsUnary(OpCode op) {
+  switch (op) {
+    case OpCode::Add:
+    case OpCode::Sub:
+    case OpCode::Mul:
+    case OpCode::Div:
+    case OpCode::Max:
+    case OpCode::Min:
+      return false;
+    default:
+      return true;
+  }
+}
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  const auto ops = info.GetAttrsOrDefault<std::string>("ops");
+  const auto operands = info.GetAttrsOrDefault<int64_t>("operands");
+  ORT_ENFORCE(!ops.empty(), "FusedElementwise requires a non-empty 'ops' attribute.");
+  ORT_ENFORCE(operands.size() == ops.size() * 2, "FusedElementwise requires two operands per op. Got ",
+              operands.size(), " operands for ", ops.size(), " ops.");
+
+  num_inputs_ = info.GetInputCount();
+  const auto num_values = static_cast<int64_t>(num_inputs_ + ops.size());
+
+  // last_use[k] is the index of the last instruction reading the result of instruction k.
+  std::vector<size_t> last_use(ops.size(), 0);
+  cost_per_element_ = 0.0;
+  program_.reserve(ops.size());
+
+  for (size_t k = 0; k < ops.size(); ++k) {
+    const auto op = ParseOpCode(ops[k]);
+    ORT_ENFORCE(op.has_value(), "FusedElementwise does not support op ", ops[k]);
+
+    Instruction instruction{*op, operands[2 * k], operands[2 * k + 1], -1};
+    const int64_t limit = static_cast<int64_t>(num_inputs_ + k);
+    ORT_ENFORCE(instruction.lhs >= 0 && instruction.lhs < limit, "Invalid operand ", instruction.lhs,
+                " for op ", k, ". Operands must refer to an input or an earlier op.");
+    if (IsUnary(*op)) {
+      ORT_ENFORCE(instruction.rhs == -1, "Unary op ", ops[k], " must use -1 as the second operand.");
+    } else {
+      ORT_ENFORCE(instruction.rhs >= 0 && instruction.rhs < limit, "Invalid operand ", instruction.rhs,
+                  " for op ", k, ". Operands must refer to an input or an earlier op.");
+    }
+
+    for (const int64_t operand : {instruction.lhs, instruction.rhs}) {
+      if (operand >= static_cast<int64_t>(num_inputs_) && operand < num_values) {
+        last_use[narrow<size_t>(operand) - num_inputs_] = k;
+      }
+    }
+
+    cost_per_element_ += OpCost(*op);
+    program_.push_back(instruction);
+  }
+
+  // Assign scratch blocks to the intermediate results, reusing a block once its value is dead. An op may write
+  // into the block of an operand it reads last as every op is elementwise.
+  std::vector<int64_t> free_slots;
+  num_slots_ = 0;
+
+  for (size_t k = 0; k < program_.size(); ++k) {
+    auto& instruction = program_[k];
+
+    for (const int64_t operand : {instruction.lhs, instruction.rhs}) {
+      if (operand >= static_cast<int64_t>(num_inputs_)) {
+        const size_t producer = narrow<size_t>(operand) - num_inputs_;
+        if (last_use[producer] == k &&
+            std::find(free_slots.begin(), free_slots.end(), program_[producer].slot) == free_slots.end()) {
+          free_slots.push_back(program_[producer].slot);
+        }
+      }
+    }
+
+    if (k + 1 == program_.size()) {
+      break;
+    }
+
+    if (free_slots.empty()) {
+      instruction.slot = static_cast<int64_t>(num_slots_++);
+    } else {
+      instruction.slot = free_slots.back();
+      free_slots.pop_back();
+    }
+  }
+}
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  InlinedVector<const Tensor*> inputs;
+  inputs.reserve(num_inputs_);
+
+  // The output has the multidirectional broadcast shape of the inputs.
+  size_t output_rank = 0;
+  for (size_t i = 0; i < num_inputs_; ++i) {
+    const Tensor* input = context->Input<Tensor>(static_cast<int>(i));
+    inputs.push_back(input);
+    output_rank = std::max(output_rank, input->Shape().NumDimensions());
+  }
+
+  TensorShapeVector output_dims(output_rank, 1);
+  for (const Tensor* input : inputs) {
+    const auto input_dims = input->Shape().GetDims();
+    const size_t offset = output_rank - input_dims.size();
+    for (size_t i = 0; i < input_dims.size(); ++i) {
+      if (output_dims[offset + i] == 1) {
+        output_dims[offset + i] = input_dims[i];
+      }
+    }
+  }
+  const TensorShape output_shape(output_dims);
+
+  InlinedVector<InputBroadcast> broadcasts(num_inputs_);
+  for (size_t i = 0; i < num_inputs_; ++i) {
+    if (!GetInputBroadcast(inputs[i]->Shape(), output_shape, broadcasts[i])) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise input with shape ",
+                             inputs[i]->Shape(), " does not broadcast to the output shape ", output_shape, ".");
+    }
+  }
+
+  Tensor* output = context->Output(0, output_shape);
+  const std::ptrdiff_t total = narrow<std::ptrdiff_t>(output_shape.Size());
+  if (total == 0) {
+    return Status::OK();
+  }
+
+  float* output_data = output->MutableData<float>();
+
+  const TensorOpCost cost{static_cast<double>(num_inputs_ * sizeof(float)), static_cast<double>(sizeof(float)),
+                          cost_per_element_};
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), total, cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        // One block per input for broadcast values plus one per scratch slot.
+        std::vector<float> scratch((num_inputs_ + num_slots_) * kBlockSize);
+        float* input_blocks = scratch.data();
+        float* slot_blocks = scratch.data() + num_inputs_ * kBlockSize;
+
+        // Scalars are expanded once for the whole range.
+        for (size_t i = 0; i < num_inputs_; ++i) {
+          if (broadcasts[i].kind == InputBroadcast::Kind::Scalar) {
+            std::fill_n(input_blocks + i * kBlockSize, kBlockSize, *inputs[i]->Data<float>());
+          }
+        }
+
+        InlinedVector<const float*> input_ptrs(num_inputs_);
+
+        for (std::ptrdiff_t start = first; start < last; start += kBlockSize) {
+          const std::ptrdiff_t n = std::min(kBlockSize, last - start);
+
+          for (size_t i = 0; i < num_inputs_; ++i) {
+            const float* data = inputs[i]->Data<float>();
+            const std::ptrdiff_t size = narrow<std::ptrdiff_t>(inputs[i]->Shape().Size());
+            float* block = input_blocks + i * kBlockSize;
+
+            switch (broadcasts[i].kind) {
+              case InputBroadcast::Kind::Full:
+                input_ptrs[i] = data + start;
+                break;
+              case InputBroadcast::Kind::Scalar:
+                input_ptrs[i] = block;
+                break;
+              case InputBroadcast::Kind::Periodic: {
+                // The input repeats with a period of its size. Read it in place unless the block wraps around.
+                std::ptrdiff_t offset = start % size;
+                if (offset + n <= size) {
+                  input_ptrs[i] = data + offset;
+                } else {
+                  for (std::ptrdiff_t copied = 0; copied < n; offset = 0) {
+                    const std::ptrdiff_t count = std::min(size - offset, n - copied);
+                    std::memcpy(block + copied, data + offset, narrow<size_t>(count) * sizeof(float));
+                    copied += count;
+                  }
+                  input_ptrs[i] = block;
+                }
+                break;
+              }
+              case InputBroadcast::Kind::Gather:
+                GatherBlock(data, broadcasts[i], start, n, block);
+                input_ptrs[i] = block;
+                break;
+            }
+          }
+
+          const auto operand = [&](int64_t index) -> const float* {
+            if (index < 0) {
+              return nullptr;
+            }
+            if (index < static_cast<int64_t>(num_inputs_)) {
+              return input_ptrs[narrow<size_t>(index)];
+            }
+            return slot_blocks + program_[narrow<size_t>(index) - num_inputs_].slot * kBlockSize;
+          };
+
+          for (const auto& instruction : program_) {
+            float* y = instruction.slot < 0 ? output_data + start : slot_blocks + instruction.slot * kBlockSize;
+            Evaluate(instruction.op, operand(instruction.lhs), operand(instruction.rhs), y, n);
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
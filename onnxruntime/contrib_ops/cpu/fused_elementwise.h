@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Evaluates a program of elementwise ops produced by ElementwiseFusion. The output is processed in blocks
+// small enough for the intermediate results to stay in the L1 cache, so only the inputs and the final result
+// touch memory.
+class FusedElementwise final : public OpKernel {
+ public:
+  enum class OpCode {
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Max,
+    Min,
+    Relu,
+    Sigmoid,
+    Tanh,
+    Exp,
+    Erf,
+    Neg,
+    Abs,
+    Sqrt,
+    Reciprocal,
+  };
+
+  static std::optional<OpCode> ParseOpCode(std::string_view op_type);
+  static bool IsUnary(OpCode op);
+
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  struct Instruction {
+    OpCode op;
+    // operand indices: below num_inputs_ an input, otherwise num_inputs_ + the index of an earlier instruction.
+    // rhs is -1 for unary ops.
+    int64_t lhs;
+    int64_t rhs;
+    // scratch block receiving the result, or -1 for the last instruction which writes the output.
+    int64_t slot;
+  };
+
+  size_t num_inputs_;
+  size_t num_slots_;
+  double cost_per_element_;
+  std::vector<Instruction> program_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
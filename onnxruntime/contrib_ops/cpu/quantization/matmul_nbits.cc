@@ -3,6 +3,7 @@
 
 #include "contrib_ops/cpu/quantization/matmul_nbits_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <type_traits>
 
@@ -102,8 +103,8 @@ class MatMulNBits final : public OpKernel {
       has_unquantized_zero_point_ = type != ONNX_NAMESPACE::TensorProto_DataType_UINT8;
     }
 
-    ORT_ENFORCE(nbits_ == 4,
-                "Only 4b quantization is supported for MatMulNBits op, additional bits support is planned.");
+    ORT_ENFORCE(nbits_ == 2 || nbits_ == 3 || nbits_ == 4 || nbits_ == 8,
+                "Only 2b, 3b, 4b and 8b quantization is supported for MatMulNBits op. Got ", nbits_, "b.");
     const Tensor* tensor_zero_point = nullptr;
     has_zp_input_ = info.TryGetConstantInput(InputIndex::zero_points, &tensor_zero_point);
 #ifdef ORT_NEURAL_SPEED
@@ -126,6 +127,10 @@ class MatMulNBits final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UseCachedPrePackedBuffers(const Tensor& tensor, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   gsl::span<const size_t> prepacked_buffer_sizes, int input_idx,
+                                   /*out*/ bool& used_cached_buffers) override;
+
  private:
   const size_t K_;
   const size_t N_;
@@ -140,6 +145,27 @@ class MatMulNBits final : public OpKernel {
   size_t packed_b_size_{0};
 
   bool has_zp_input_{false};
+
+  // Number of columns of B that are dequantized at a time for bit widths without SQNBitGemm kernels.
+  static constexpr size_t kDequantizedTileN = 32;
+
+  // Y = A * B' + bias with SGEMM, where B is a dequantized [N, K] float matrix.
+  void ComputeFloatGemm(OpKernelContext* ctx, const MatMulComputeHelper& helper, const float* a_data,
+                        const float* b_data, float* y_data, concurrency::ThreadPool* thread_pool) const;
+
+  // Y = A * B' + bias for bit widths without SQNBitGemm kernels. B stays quantized, and each task dequantizes
+  // kDequantizedTileN of its columns into a scratch buffer and multiplies them with SGEMM.
+  Status ComputeDequantizedTiles(OpKernelContext* ctx, const MatMulComputeHelper& helper, const float* a_data,
+                                 float* y_data, concurrency::ThreadPool* thread_pool) const;
+
+  static bool PacksScalesIntoB(MLAS_SQNBIT_GEMM_COMPUTE_TYPE compute_type) {
+#ifdef MLAS_TARGET_AMD64_IX86
+    return compute_type == CompInt8;
+#else
+    ORT_UNUSED_PARAMETER(compute_type);
+    return false;
+#endif
+  }
 #if defined(ORT_NEURAL_SPEED)
 
   bool is_asym_{false};
@@ -152,7 +178,8 @@ Status MatMulNBits::PrePack(const Tensor& tensor, int input_idx, /*out*/ Allocat
                             /*out*/ bool& is_packed,
                             /*out*/ PrePackedWeights* prepacked_weights) {
   is_packed = false;
-  if (has_g_idx_ || has_unquantized_zero_point_) {
+  // MLAS only has 4b kernels, B of other bit widths stays quantized and is dequantized tile by tile in Compute
+  if (nbits_ != 4 || has_g_idx_ || has_unquantized_zero_point_) {
     return Status::OK();
   }
 #if defined(ORT_NEURAL_SPEED)
@@ -209,7 +236,6 @@ Status MatMulNBits::PrePack(const Tensor& tensor, int input_idx, /*out*/ Allocat
   }
 
 #else  // defined(ORT_NEURAL_SPEED)
-  ORT_UNUSED_PARAMETER(prepacked_weights);
   const auto compute_type = static_cast<MLAS_SQNBIT_GEMM_COMPUTE_TYPE>(accuracy_level_);
   if (input_idx == InputIndex::B) {
     if (!MlasIsSQNBitGemmAvailable(nbits_, block_size_, compute_type)) {
@@ -223,6 +249,11 @@ Status MatMulNBits::PrePack(const Tensor& tensor, int input_idx, /*out*/ Allocat
     packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size_, true);
     MlasSQNBitGemmPackQuantBData(N_, K_, nbits_, block_size_, compute_type, qptr, packed_b_.get(), nullptr, has_zp_input_, nullptr, nullptr);
     is_packed = true;
+    // The scales and zero points of CompInt8 are packed into the same buffer later, so it is specific to this kernel.
+    if (prepacked_weights && !PacksScalesIntoB(compute_type)) {
+      prepacked_weights->buffers_.push_back(std::move(packed_b_));
+      prepacked_weights->buffer_sizes_.push_back(packed_b_size_);
+    }
   } else if (compute_type == CompInt8) {
 #ifdef MLAS_TARGET_AMD64_IX86
     if (input_idx == InputIndex::scales && packed_b_ != nullptr) {
@@ -273,6 +304,35 @@ Status MatMulNBits::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+Status MatMulNBits::UseCachedPrePackedBuffers(const Tensor& /*tensor*/, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              gsl::span<const size_t> prepacked_buffer_sizes, int input_idx,
+                                              /*out*/ bool& used_cached_buffers) {
+  used_cached_buffers = false;
+
+#if !defined(ORT_NEURAL_SPEED)
+  const auto compute_type = static_cast<MLAS_SQNBIT_GEMM_COMPUTE_TYPE>(accuracy_level_);
+  if (input_idx != InputIndex::B || has_g_idx_ || has_unquantized_zero_point_ || prepacked_buffers.size() != 1 ||
+      PacksScalesIntoB(compute_type) || !MlasIsSQNBitGemmAvailable(nbits_, block_size_, compute_type)) {
+    return Status::OK();
+  }
+
+  const size_t packed_b_size = MlasSQNBitGemmPackQuantBDataSize(N_, K_, nbits_, block_size_, compute_type);
+  if (packed_b_size == 0 || prepacked_buffer_sizes[0] != packed_b_size) {
+    return Status::OK();
+  }
+
+  used_cached_buffers = true;
+  packed_b_size_ = packed_b_size;
+  packed_b_ = std::move(prepacked_buffers[0]);
+#else
+  ORT_UNUSED_PARAMETER(prepacked_buffers);
+  ORT_UNUSED_PARAMETER(prepacked_buffer_sizes);
+  ORT_UNUSED_PARAMETER(input_idx);
+#endif
+
+  return Status::OK();
+}
+
 Status MatMulNBits::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
   const Tensor* a = ctx->Input<Tensor>(InputIndex::A);
@@ -304,6 +364,7 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
 #if defined(ORT_NEURAL_SPEED)
 
   if (has_single_b_matrix &&
+      nbits_ == 4 &&
       packed_b_) {
     InlinedVector<NS_SQNBITS_GEMM_DATA_PACKED_PARAMS> gemm_params(batch_count);
     AllocatorPtr allocator;
@@ -325,6 +386,7 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
 #else  // defined(ORT_NEURAL_SPEED)
 
   if (has_single_b_matrix &&
+      nbits_ == 4 &&
       packed_b_) {  // Assume that MlasSQNBitGemmBatch() always requires packed B.
                     // If this changes, i.e., if MlasIsSQNBitGemmAvailable() can return true while
                     // MlasSQNBitGemmPackQuantBDataSize() returns 0, we can consider calling MlasSQNBitGemmBatch()
@@ -374,6 +436,10 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
 
 #endif  // !defined(ORT_NEURAL_SPEED)
 
+  if (nbits_ != 4) {
+    return ComputeDequantizedTiles(ctx, helper, a_data, y_data, thread_pool);
+  }
+
   // fallback implementation - dequantize B first and then compute float gemm
 
   const Tensor* scales = ctx->Input<Tensor>(InputIndex::scales);
@@ -387,7 +453,6 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
   const Tensor* b = ctx->Input<Tensor>(InputIndex::B);
   const uint8_t* b_data = b->Data<uint8_t>();
 
-  const size_t ldb = helper.Ldb(true);
   AllocatorPtr allocator;
   ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
   auto tmp_b_data_ptr = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(K_) * N_);
@@ -437,12 +502,25 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
   MlasTranspose(tmp_b_data_ptr.get(), tm_b_data_ptr_trans.get(), N_, K_);
 #endif
 
+  ComputeFloatGemm(ctx, helper, a_data, tmp_b_data_ptr.get(), y_data, thread_pool);
+
+  return Status::OK();
+}
+
+void MatMulNBits::ComputeFloatGemm(OpKernelContext* ctx, const MatMulComputeHelper& helper, const float* a_data,
+                                   const float* b_data, float* y_data, concurrency::ThreadPool* thread_pool) const {
+  const size_t batch_count = helper.OutputOffsets().size();
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+  const size_t lda = helper.Lda(false);
+  const size_t ldb = helper.Ldb(true);
+
   std::vector<MLAS_SGEMM_DATA_PARAMS> data(batch_count);
   for (size_t i = 0; i < batch_count; i++) {
-    data[i].BIsPacked = false;
     data[i].A = a_data + helper.LeftOffsets()[i];
     data[i].lda = lda;
-    data[i].B = tmp_b_data_ptr.get() + helper.RightOffsets()[i];
+    data[i].B = b_data + helper.RightOffsets()[i];
     data[i].ldb = ldb;
     data[i].C = y_data + helper.OutputOffsets()[i];
     data[i].ldc = N;
@@ -468,6 +546,87 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
 
   MlasGemmBatch(CblasNoTrans, CblasTrans,
                 M, N, K, data.data(), batch_count, thread_pool);
+}
+
+Status MatMulNBits::ComputeDequantizedTiles(OpKernelContext* ctx, const MatMulComputeHelper& helper,
+                                            const float* a_data, float* y_data,
+                                            concurrency::ThreadPool* thread_pool) const {
+  const size_t batch_count = helper.OutputOffsets().size();
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+  const size_t lda = helper.Lda(false);
+
+  const Tensor* b = ctx->Input<Tensor>(InputIndex::B);
+  const Tensor* scales = ctx->Input<Tensor>(InputIndex::scales);
+  const Tensor* zero_points = ctx->Input<Tensor>(InputIndex::zero_points);
+  const Tensor* reorder_idx = ctx->Input<Tensor>(InputIndex::g_idx);
+  const Tensor* bias = ctx->Input<Tensor>(InputIndex::bias);
+
+  const uint8_t* b_data = b->Data<uint8_t>();
+  const float* scales_data = scales->Data<float>();
+  const bool zero_points_are_float = zero_points != nullptr && zero_points->IsDataType<float>();
+  const void* zero_points_data = zero_points == nullptr ? nullptr : zero_points->DataRaw();
+  const int32_t* reorder_idx_data = reorder_idx == nullptr ? nullptr : reorder_idx->Data<int32_t>();
+  const float* bias_data = bias == nullptr ? nullptr : bias->Data<float>();
+
+  // strides of one column of B, its scales and its zero points
+  const size_t blocks_per_col = (K_ + block_size_ - 1) / block_size_;
+  const size_t blob_size = (block_size_ * nbits_ + 7) / 8;
+  const size_t b_col_stride = blocks_per_col * blob_size;
+  const size_t zp_col_stride = zero_points_are_float ? blocks_per_col : (blocks_per_col * nbits_ + 7) / 8;
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
+
+  const size_t num_tiles = (N + kDequantizedTileN - 1) / kDequantizedTileN;
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(num_tiles),
+      [&](std::ptrdiff_t tile) {
+        const size_t n_start = static_cast<size_t>(tile) * kDequantizedTileN;
+        const size_t tile_n = std::min(kDequantizedTileN, N - n_start);
+
+        auto tile_b = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(tile_n) * K_);
+        if (zero_points_are_float) {
+          DequantizeBlockwiseNBits<float, float>(
+              tile_b.get(), b_data + n_start * b_col_stride, scales_data + n_start * blocks_per_col,
+              static_cast<const float*>(zero_points_data) + n_start * zp_col_stride, reorder_idx_data,
+              static_cast<int32_t>(nbits_), static_cast<int32_t>(block_size_),
+              static_cast<int32_t>(K_), static_cast<int32_t>(tile_n), nullptr);
+        } else {
+          DequantizeBlockwiseNBits<float, uint8_t>(
+              tile_b.get(), b_data + n_start * b_col_stride, scales_data + n_start * blocks_per_col,
+              zero_points_data == nullptr ? nullptr
+                                          : static_cast<const uint8_t*>(zero_points_data) + n_start * zp_col_stride,
+              reorder_idx_data, static_cast<int32_t>(nbits_), static_cast<int32_t>(block_size_),
+              static_cast<int32_t>(K_), static_cast<int32_t>(tile_n), nullptr);
+        }
+
+        std::vector<MLAS_SGEMM_DATA_PARAMS> data(batch_count);
+        for (size_t i = 0; i < batch_count; i++) {
+          data[i].A = a_data + helper.LeftOffsets()[i];
+          data[i].lda = lda;
+          data[i].B = tile_b.get();
+          data[i].ldb = K_;
+          data[i].C = y_data + helper.OutputOffsets()[i] + n_start;
+          data[i].ldc = N;
+          data[i].alpha = 1.f;
+          data[i].beta = 0.0f;
+
+          // copy the bias values of the tile into C and set beta to 1.0f
+          if (bias_data != nullptr) {
+            float* C_row = data[i].C;
+            for (size_t m = 0; m < M; ++m) {
+              memcpy(C_row, bias_data + n_start, tile_n * sizeof(float));
+              C_row += N;
+            }
+            data[i].beta = 1.0f;
+          }
+        }
+
+        // the tiles already run in parallel
+        MlasGemmBatch(CblasNoTrans, CblasTrans, M, tile_n, K, data.data(), batch_count, nullptr);
+      });
 
   return Status::OK();
 }
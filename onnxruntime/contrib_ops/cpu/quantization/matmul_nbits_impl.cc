@@ -112,5 +112,72 @@ template void DequantizeBlockwise<float, float>(
     const float* zero_points, const int32_t* reorder_idx, int32_t block_size,
     bool columnwise, int32_t K, int32_t N, onnxruntime::concurrency::ThreadPool* thread_pool);
 
+// Read the nbits wide value starting at bit_offset of a little-endian bit stream.
+static inline uint32_t ExtractBits(const uint8_t* data, size_t bit_offset, int nbits) {
+  const size_t byte_offset = bit_offset / 8;
+  const int shift = static_cast<int>(bit_offset % 8);
+  uint32_t value = static_cast<uint32_t>(data[byte_offset]) >> shift;
+  if (shift + nbits > 8) {
+    value |= static_cast<uint32_t>(data[byte_offset + 1]) << (8 - shift);
+  }
+  return value & ((1u << nbits) - 1);
+}
+
+template <typename inputT, typename zeroT>
+void DequantizeBlockwiseNBits(
+    inputT* output,              // dequantized output
+    const uint8_t* quant_data,   // quantized input
+    const inputT* scales_data,   // quantization scales
+    const zeroT* zero_points,    // quantization zero points
+    const int32_t* reorder_idx,  // reorder_idx for groupwise quantization
+    int32_t nbits,               // number of bits of a quantized value
+    int32_t block_size,          // quantization block size
+    int32_t K,                   // number of rows in quantized input
+    int32_t N,                   // number of columns in quantized input
+    onnxruntime::concurrency::ThreadPool* pool) {
+  const int32_t blocks_per_col = (K + block_size - 1) / block_size;
+  const size_t blob_size = (static_cast<size_t>(block_size) * nbits + 7) / 8;
+  const size_t zp_bytes_per_col = (static_cast<size_t>(blocks_per_col) * nbits + 7) / 8;
+  const float default_zp = static_cast<float>(1 << (nbits - 1));
+
+  // one column of B, i.e. one row of the output, per iteration
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      pool, static_cast<std::ptrdiff_t>(N),
+      [&](std::ptrdiff_t n) {
+        const uint8_t* col_data = quant_data + static_cast<size_t>(n) * blocks_per_col * blob_size;
+        const inputT* col_scales = scales_data + static_cast<size_t>(n) * blocks_per_col;
+        inputT* out_row = output + static_cast<size_t>(n) * K;
+        for (int32_t k = 0; k < K; ++k) {
+          const int32_t block = k / block_size;
+          const int32_t block_offset = k % block_size;
+          const int32_t rid = reorder_idx ? reorder_idx[k] : block;
+
+          float zp = default_zp;
+          if (zero_points) {
+            if constexpr (std::is_same_v<zeroT, inputT>) {
+              zp = static_cast<float>(zero_points[static_cast<size_t>(n) * blocks_per_col + rid]);
+            } else {
+              zp = static_cast<float>(ExtractBits(zero_points + static_cast<size_t>(n) * zp_bytes_per_col,
+                                                  static_cast<size_t>(rid) * nbits, nbits));
+            }
+          }
+
+          const uint32_t q = ExtractBits(col_data + static_cast<size_t>(block) * blob_size,
+                                         static_cast<size_t>(block_offset) * nbits, nbits);
+          out_row[k] = static_cast<inputT>((static_cast<float>(q) - zp) * static_cast<float>(col_scales[rid]));
+        }
+      });
+}
+
+template void DequantizeBlockwiseNBits<float, uint8_t>(
+    float* output, const uint8_t* quant_data, const float* scales_data,
+    const uint8_t* zero_points, const int32_t* reorder_idx, int32_t nbits, int32_t block_size,
+    int32_t K, int32_t N, onnxruntime::concurrency::ThreadPool* thread_pool);
+
+template void DequantizeBlockwiseNBits<float, float>(
+    float* output, const uint8_t* quant_data, const float* scales_data,
+    const float* zero_points, const int32_t* reorder_idx, int32_t nbits, int32_t block_size,
+    int32_t K, int32_t N, onnxruntime::concurrency::ThreadPool* thread_pool);
+
 }  // namespace contrib
 }  // namespace onnxruntime
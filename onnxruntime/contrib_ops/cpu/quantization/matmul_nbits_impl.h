@@ -19,5 +19,21 @@ void DequantizeBlockwise(
     int32_t N,                   // number of columns in quantized input
     onnxruntime::concurrency::ThreadPool* thread_pool);
 
+// Dequantize B of MatMulNBits for any supported bit width (2, 3, 4 or 8) into a [N, K] row major matrix.
+// Each block of B is a little-endian bit stream of block_size values. Packed uint8_t zero points use the same bit
+// stream layout with ceil(n_blocks_per_col * nbits / 8) bytes per column of B; float zero points are not packed.
+template <typename inputT, typename zeroT>
+void DequantizeBlockwiseNBits(
+    inputT* output,              // dequantized output
+    const uint8_t* quant_data,   // quantized input
+    const inputT* scales_data,   // quantization scales
+    const zeroT* zero_points,    // quantization zero points
+    const int32_t* reorder_idx,  // reorder_idx for groupwise quantization
+    int32_t nbits,               // number of bits of a quantized value
+    int32_t block_size,          // quantization block size
+    int32_t K,                   // number of rows in quantized input
+    int32_t N,                   // number of columns in quantized input
+    onnxruntime::concurrency::ThreadPool* thread_pool);
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "contrib_ops/cpu/transformers/beam_search_impl_base.h"
+#include "contrib_ops/cpu/transformers/paged_kv_cache.h"
 
 #include "core/common/span_utils.h"
 
@@ -225,10 +226,10 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
                                          gpt_subgraph_.has_decoder_masked_attention_));
 
   if (gpt_subgraph_.past_present_share_buffer_) {  // Reuse past and present
-    fetches.reserve(static_cast<size_t>(gpt_subgraph_.GetFirstPresentOutputIndex()) + gpt_subgraph_.num_layers);
+    fetches.reserve(static_cast<size_t>(gpt_subgraph_.GetFirstPresentOutputIndex()) + gpt_subgraph_.GetNumPastInputs());
     fetches.resize(gpt_subgraph_.GetFirstPresentOutputIndex(), OrtValue());
-    for (int layer = 0; layer < gpt_subgraph_.num_layers; layer++) {
-      int feed_idx = gpt_subgraph_.GetFirstPastInputIndex() + layer;
+    for (int i = 0; i < gpt_subgraph_.GetNumPastInputs(); i++) {
+      int feed_idx = gpt_subgraph_.GetFirstPastInputIndex() + i;
       OrtValue& past_tensor_value = feeds[feed_idx];
       Tensor* past_tensor = past_tensor_value.GetMutable<Tensor>();
       OrtValue present_tensor_value;
@@ -238,6 +239,13 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
     }
   }
 
+  // With a paged past state, blocks are allocated as tokens are generated.
+  std::unique_ptr<PagedKVCache> paged_kv_cache;
+  if (gpt_subgraph_.paged_kv_cache_) {
+    paged_kv_cache = std::make_unique<PagedKVCache>(static_cast<int>(parameters->BatchBeamSize()),
+                                                    parameters->max_length, gpt_subgraph_.kv_block_size_);
+  }
+
   BeamSearchState<T> beam_state{*parameters,
                                 this->temp_space_allocator_,
                                 gpt_subgraph_.has_decoder_masked_attention_,
@@ -277,6 +285,7 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
   int current_length = parameters->sequence_length;
   int iteration_counter = 0;
   while (current_length < parameters->max_length) {
+    ORT_RETURN_IF_ERROR(this->CheckRunDeadline(current_length));
 #ifdef DEBUG_GENERATION
     auto cur_len = std::to_string(current_length);
     dumper->Print("***CurrentLength", cur_len, true);
@@ -291,6 +300,20 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
     }
 #endif
 
+    if (paged_kv_cache != nullptr) {
+      // The first run writes the prompt, and each following run appends one token.
+      ORT_RETURN_IF_ERROR(UpdatePagedKVCacheFeeds<T>(*paged_kv_cache,
+                                                     iteration_counter == 0 ? 0 : current_length - 1,
+                                                     current_length,
+                                                     this->temp_space_allocator_,
+                                                     gpt_subgraph_.GetFirstPastInputIndex(),
+                                                     gpt_subgraph_.GetFirstPresentOutputIndex(),
+                                                     gpt_subgraph_.GetNumPastInputs(),
+                                                     gpt_subgraph_.GetBlockTableInputIndex(),
+                                                     feeds,
+                                                     fetches));
+    }
+
     // For the first iteration use the init_run_decoder subgraph (if present)
     if (iteration_counter++ == 0 &&
         init_run_decoder_session_state_ != nullptr) {
@@ -335,6 +358,11 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
     if (this->beam_scorer_->IsDone())
       break;
 
+    // Selected beams share the blocks of the beams that they are extended from.
+    if (paged_kv_cache != nullptr) {
+      paged_kv_cache->Reorder(ReinterpretAsSpan<const int32_t>(this->beam_scorer_->GetNextIndicesCPU()));
+    }
+
     // Increase sequence length after a new token is generated.
     ++current_length;
 
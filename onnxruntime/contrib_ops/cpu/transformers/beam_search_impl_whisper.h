@@ -353,6 +353,7 @@ Status BeamSearchWhisper<T>::Execute(const FeedsFetchesManager& encoder_feeds_fe
   }
 
   while (current_length < parameters->max_length) {
+    ORT_RETURN_IF_ERROR(this->CheckRunDeadline(current_length));
     iteration_counter++;
 #ifdef DEBUG_GENERATION
     auto cur_len = std::to_string(current_length);
@@ -7,6 +7,7 @@
 #include <utility>
 #include <vector>
 #include "core/common/span_utils.h"
+#include "core/platform/threadpool.h"
 #include "contrib_ops/cpu/transformers/generation_shared.h"
 
 namespace onnxruntime {
@@ -254,6 +255,13 @@ class GenerateBase {
     return IsCuda() ? cuda_dumper_ : &(cpu_dumper_);
   }
 
+  // Stop generating once the deadline of the run has passed. Checked before each decoding step.
+  static Status CheckRunDeadline(int current_length) {
+    ORT_RETURN_IF(concurrency::ThreadPool::DeadlinePassed(), "Generation stopped at sequence length ",
+                  current_length, " as the run deadline passed.");
+    return Status::OK();
+  }
+
   OpKernelContextInternal& context_;
 
   const SessionState& decoder_session_state_;
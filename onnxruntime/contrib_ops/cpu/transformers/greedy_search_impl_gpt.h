@@ -3,10 +3,12 @@
 
 #pragma once
 #include <algorithm>
+#include <memory>
 #include <vector>
 
 #include "core/common/span_utils.h"
 #include "contrib_ops/cpu/transformers/greedy_search_impl_base.h"
+#include "contrib_ops/cpu/transformers/paged_kv_cache.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -231,10 +233,10 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
   ORT_RETURN_IF_ERROR(CreateInitialFeeds(greedy_state.sequence_lengths, expanded_input_ids_in_cpu, feeds, buffer));
 
   if (gpt_subgraph_.past_present_share_buffer_) {  // Reuse past and present
-    fetches.reserve(static_cast<size_t>(gpt_subgraph_.GetFirstPresentOutputIndex()) + gpt_subgraph_.num_layers);
+    fetches.reserve(static_cast<size_t>(gpt_subgraph_.GetFirstPresentOutputIndex()) + gpt_subgraph_.GetNumPastInputs());
     fetches.resize(gpt_subgraph_.GetFirstPresentOutputIndex(), OrtValue());
-    for (int layer = 0; layer < gpt_subgraph_.num_layers; layer++) {
-      int feed_idx = gpt_subgraph_.GetFirstPastInputIndex() + layer;
+    for (int i = 0; i < gpt_subgraph_.GetNumPastInputs(); i++) {
+      int feed_idx = gpt_subgraph_.GetFirstPastInputIndex() + i;
       OrtValue& past_tensor_value = feeds[feed_idx];
       Tensor* past_tensor = past_tensor_value.GetMutable<Tensor>();
       OrtValue present_tensor_value;
@@ -244,6 +246,13 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     }
   }
 
+  // With a paged past state, blocks are allocated as tokens are generated.
+  std::unique_ptr<PagedKVCache> paged_kv_cache;
+  if (gpt_subgraph_.paged_kv_cache_) {
+    paged_kv_cache = std::make_unique<PagedKVCache>(static_cast<int>(parameters->BatchBeamSize()),
+                                                    parameters->max_length, gpt_subgraph_.kv_block_size_);
+  }
+
   init_greedy_state_func_(&greedy_state,
                           greedy_state.sequence_lengths,
                           this->ort_stream_);
@@ -271,6 +280,7 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
   int current_length = parameters->sequence_length;
   int iteration_counter = 0;
   while (current_length < parameters->max_length) {
+    ORT_RETURN_IF_ERROR(this->CheckRunDeadline(current_length));
 #ifdef DEBUG_GENERATION
     auto cur_len = std::to_string(current_length);
     dumper->Print("***CurrentLength", cur_len, true);
@@ -280,6 +290,20 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     dumper->Print("past", feeds[3]);
 #endif
 
+    if (paged_kv_cache != nullptr) {
+      // The first run writes the prompt, and each following run appends one token.
+      ORT_RETURN_IF_ERROR(UpdatePagedKVCacheFeeds<T>(*paged_kv_cache,
+                                                     iteration_counter == 0 ? 0 : current_length - 1,
+                                                     current_length,
+                                                     this->temp_space_allocator_,
+                                                     gpt_subgraph_.GetFirstPastInputIndex(),
+                                                     gpt_subgraph_.GetFirstPresentOutputIndex(),
+                                                     gpt_subgraph_.GetNumPastInputs(),
+                                                     gpt_subgraph_.GetBlockTableInputIndex(),
+                                                     feeds,
+                                                     fetches));
+    }
+
     // For the first iteration use the init_run_decoder subgraph (if present)
     if (iteration_counter++ == 0 &&
         init_run_decoder_session_state_ != nullptr) {
@@ -0,0 +1,181 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transformers/paged_kv_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+PagedKVCache::PagedKVCache(int num_sequences, int max_sequence_length, int block_size)
+    : num_sequences_(num_sequences),
+      block_size_(block_size),
+      max_blocks_per_sequence_((max_sequence_length + block_size - 1) / block_size) {
+  ORT_ENFORCE(num_sequences > 0 && max_sequence_length > 0 && block_size > 0);
+  block_table_.assign(SafeInt<size_t>(num_sequences) * max_blocks_per_sequence_, -1);
+}
+
+int32_t PagedKVCache::AllocateBlock() {
+  if (free_blocks_.empty()) {
+    // Grow geometrically so that the pools are reallocated a logarithmic number of times.
+    const int32_t num_blocks = NumBlocks();
+    const int32_t num_new_blocks = std::max(num_blocks, num_sequences_);
+    ref_counts_.resize(SafeInt<size_t>(num_blocks) + num_new_blocks, 0);
+    for (int32_t block = num_blocks + num_new_blocks - 1; block >= num_blocks; block--) {
+      free_blocks_.push_back(block);
+    }
+  }
+
+  const int32_t block = free_blocks_.back();
+  free_blocks_.pop_back();
+  ref_counts_[block] = 1;
+  return block;
+}
+
+void PagedKVCache::ReleaseBlock(int32_t block) {
+  if (--ref_counts_[block] == 0) {
+    free_blocks_.push_back(block);
+  }
+}
+
+Status PagedKVCache::PrepareWrite(int begin, int end, std::vector<std::pair<int32_t, int32_t>>& copies) {
+  ORT_RETURN_IF(begin < 0 || begin >= end || end > max_blocks_per_sequence_ * block_size_,
+                "Invalid range [", begin, ", ", end, ") of the paged KV cache with capacity of ",
+                max_blocks_per_sequence_ * block_size_, " tokens per sequence.");
+
+  const int first_block = begin / block_size_;
+  const int last_block = (end - 1) / block_size_;
+  for (int sequence = 0; sequence < num_sequences_; sequence++) {
+    int32_t* blocks = block_table_.data() + static_cast<ptrdiff_t>(sequence) * max_blocks_per_sequence_;
+    for (int i = first_block; i <= last_block; i++) {
+      if (blocks[i] < 0) {
+        blocks[i] = AllocateBlock();
+      } else if (ref_counts_[blocks[i]] > 1) {
+        const int32_t copy = AllocateBlock();
+        copies.emplace_back(blocks[i], copy);
+        ReleaseBlock(blocks[i]);
+        blocks[i] = copy;
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+void PagedKVCache::Reorder(gsl::span<const int32_t> source_indices) {
+  ORT_ENFORCE(source_indices.size() == static_cast<size_t>(num_sequences_));
+
+  // Take the references of the new block table before releasing the old one, so shared blocks are not freed.
+  reorder_buffer_.resize(block_table_.size());
+  for (int sequence = 0; sequence < num_sequences_; sequence++) {
+    const int32_t source = source_indices[sequence];
+    ORT_ENFORCE(source >= 0 && source < num_sequences_);
+    const auto source_blocks = gsl::make_span(block_table_).subspan(
+        static_cast<size_t>(source) * max_blocks_per_sequence_, max_blocks_per_sequence_);
+    std::copy(source_blocks.begin(), source_blocks.end(),
+              reorder_buffer_.begin() + static_cast<ptrdiff_t>(sequence) * max_blocks_per_sequence_);
+    for (int32_t block : source_blocks) {
+      if (block >= 0) {
+        ++ref_counts_[block];
+      }
+    }
+  }
+
+  for (int32_t block : block_table_) {
+    if (block >= 0) {
+      ReleaseBlock(block);
+    }
+  }
+
+  block_table_.swap(reorder_buffer_);
+}
+
+template <typename T>
+Status UpdatePagedKVCacheFeeds(PagedKVCache& cache,
+                               int begin,
+                               int end,
+                               AllocatorPtr allocator,
+                               int first_past_input_index,
+                               int first_present_output_index,
+                               int num_pools,
+                               int block_table_input_index,
+                               std::vector<OrtValue>& feeds,
+                               std::vector<OrtValue>& fetches) {
+  const int old_num_blocks = cache.NumBlocks();
+  std::vector<std::pair<int32_t, int32_t>> copies;
+  ORT_RETURN_IF_ERROR(cache.PrepareWrite(begin, end, copies));
+  const int num_blocks = cache.NumBlocks();
+
+  for (int i = 0; i < num_pools; i++) {
+    OrtValue& past = feeds[static_cast<size_t>(first_past_input_index) + i];
+    if (num_blocks != old_num_blocks) {
+      // Past key or value pool shape is like (num_blocks, kv_num_heads, block_size, head_size)
+      const TensorShape& old_shape = past.Get<Tensor>().Shape();
+      TensorShape new_shape = old_shape;
+      new_shape[0] = num_blocks;
+
+      OrtValue grown;
+      Tensor::InitOrtValue(DataTypeImpl::GetType<T>(), new_shape, allocator, grown);
+      const size_t old_pool_size = onnxruntime::narrow<size_t>(old_shape.Size());
+      if (old_pool_size > 0) {
+        memcpy(grown.GetMutable<Tensor>()->MutableData<T>(), past.Get<Tensor>().Data<T>(), old_pool_size * sizeof(T));
+      }
+      past = grown;
+
+      // The present output shares the buffer with the past input.
+      Tensor* past_tensor = past.GetMutable<Tensor>();
+      OrtValue present;
+      Tensor::InitOrtValue(past_tensor->DataType(), past_tensor->Shape(), past_tensor->MutableData<T>(),
+                           past_tensor->Location(), present);
+      fetches[static_cast<size_t>(first_present_output_index) + i] = present;
+    }
+
+    if (!copies.empty()) {
+      Tensor* past_tensor = past.GetMutable<Tensor>();
+      const size_t block_elements = onnxruntime::narrow<size_t>(past_tensor->Shape().SizeFromDimension(1));
+      T* pool = past_tensor->MutableData<T>();
+      for (const auto& copy : copies) {
+        memcpy(pool + copy.second * block_elements, pool + copy.first * block_elements, block_elements * sizeof(T));
+      }
+    }
+  }
+
+  const auto block_table = cache.BlockTable();
+  int32_t* block_table_data = feeds[block_table_input_index].GetMutable<Tensor>()->MutableData<int32_t>();
+  std::copy(block_table.begin(), block_table.end(), block_table_data);
+  return Status::OK();
+}
+
+template Status UpdatePagedKVCacheFeeds<float>(
+    PagedKVCache& cache,
+    int begin,
+    int end,
+    AllocatorPtr allocator,
+    int first_past_input_index,
+    int first_present_output_index,
+    int num_pools,
+    int block_table_input_index,
+    std::vector<OrtValue>& feeds,
+    std::vector<OrtValue>& fetches);
+
+template Status UpdatePagedKVCacheFeeds<MLFloat16>(
+    PagedKVCache& cache,
+    int begin,
+    int end,
+    AllocatorPtr allocator,
+    int first_past_input_index,
+    int first_present_output_index,
+    int num_pools,
+    int block_table_input_index,
+    std::vector<OrtValue>& feeds,
+    std::vector<OrtValue>& fetches);
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <utility>
+#include <vector>
+#include <gsl/gsl>
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// Block manager of a paged key-value cache used by the generation loop of a GPT subgraph.
+//
+// The key and value of token t of sequence s are stored in block BlockTable()[s * MaxBlocksPerSequence() + t / BlockSize()]
+// of the block pools of every layer. Blocks are reference counted so that sequences can share them, e.g. beams that
+// are selected from the same beam share the blocks of their common prefix. A block that is shared is copied before a
+// sequence writes to it (copy-on-write), so only blocks that are actually written are duplicated.
+class PagedKVCache {
+ public:
+  PagedKVCache(int num_sequences, int max_sequence_length, int block_size);
+
+  int BlockSize() const { return block_size_; }
+  int MaxBlocksPerSequence() const { return max_blocks_per_sequence_; }
+
+  // Number of blocks in the pools, including free blocks.
+  int NumBlocks() const { return static_cast<int>(ref_counts_.size()); }
+  int NumUsedBlocks() const { return NumBlocks() - static_cast<int>(free_blocks_.size()); }
+
+  // Block indices with shape (num_sequences, max_blocks_per_sequence). Unassigned entries are -1.
+  gsl::span<const int32_t> BlockTable() const { return block_table_; }
+
+  // Make the blocks holding positions [begin, end) of every sequence writable.
+  // Missing blocks are allocated, and shared blocks are replaced by a new block. The (source, destination) pairs of
+  // the replaced blocks are appended to copies, and their content shall be copied before the blocks are written.
+  // The number of blocks grows when there are no free blocks left.
+  Status PrepareWrite(int begin, int end, std::vector<std::pair<int32_t, int32_t>>& copies);
+
+  // Sequence i continues sequence source_indices[i]. It shares the blocks of the source sequence and releases its own.
+  void Reorder(gsl::span<const int32_t> source_indices);
+
+ private:
+  int32_t AllocateBlock();
+  void ReleaseBlock(int32_t block);
+
+  const int num_sequences_;
+  const int block_size_;
+  const int max_blocks_per_sequence_;
+
+  std::vector<int32_t> block_table_;
+  std::vector<int32_t> ref_counts_;
+  std::vector<int32_t> free_blocks_;
+  std::vector<int32_t> reorder_buffer_;
+};
+
+// Prepare the feeds of a GPT subgraph with a paged KV cache for a run that writes positions [begin, end).
+// Each layer has a past key pool and a past value pool with shape (num_blocks, kv_num_heads, block_size, head_size),
+// i.e. the past_key and past_value inputs of GroupQueryAttention, and each pool is also used as present output.
+// The pools are grown when more blocks are needed, the shared blocks that will be written are copied, and the block
+// table is written to the block_table feed.
+template <typename T>
+Status UpdatePagedKVCacheFeeds(PagedKVCache& cache,
+                               int begin,
+                               int end,
+                               AllocatorPtr allocator,
+                               int first_past_input_index,
+                               int first_present_output_index,
+                               int num_pools,
+                               int block_table_input_index,
+                               std::vector<OrtValue>& feeds,
+                               std::vector<OrtValue>& fetches);
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
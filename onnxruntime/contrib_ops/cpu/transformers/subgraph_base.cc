@@ -90,6 +90,10 @@ Status Subgraph::Setup(const SessionState& session_state,
         past_present_share_buffer_ = true;
         // past_sequence_length is on CPU memory
         feed_locations.push_back(OrtDevice());
+      } else if (feed_names[i] == "block_table") {
+        // block_table is only given when the past state is a paged KV cache. It is on CPU memory.
+        paged_kv_cache_ = true;
+        feed_locations.push_back(OrtDevice());
       } else if (feed_names[i] == "beam_width") {
         // beam_width is on CPU memory
         feed_locations.push_back(OrtDevice());
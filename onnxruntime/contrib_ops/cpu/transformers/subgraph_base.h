@@ -46,6 +46,8 @@ class Subgraph {
   bool past_present_share_buffer_;
   bool has_decoder_masked_attention_;
   bool output_cross_qk_ = false;
+  bool paged_kv_cache_ = false;  // past state is a pool of blocks addressed through the block_table input
+  int kv_block_size_ = 0;        // number of tokens per block of the paged past state
 
   // Setup execution
   Status Setup(const SessionState& session_state,
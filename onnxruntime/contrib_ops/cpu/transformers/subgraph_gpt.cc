@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include "core/framework/framework_common.h"
 #include "core/framework/session_state.h"
 #include "core/framework/tensorprotoutils.h"
@@ -86,6 +87,34 @@ Status GptSubgraph::CreateInitialFeeds(
     for (int i = first_past_input_index_; i < num_subgraph_inputs; ++i) {
       feeds.push_back(empty_past);
     }
+  } else if (paged_kv_cache_) {
+    ORT_RETURN_IF(provider->Type() != kCpuExecutionProvider,
+                  "Paged KV cache of GPT subgraph is only supported by the CPU execution provider.");
+
+    // Past state feeds are empty key and value block pools, which are grown by the generation loop when blocks are
+    // needed. Each pool has the layout of the past_key or past_value input of GroupQueryAttention.
+    TensorShape past_shape{0, num_heads, kv_block_size_, head_size};
+
+    // The remaining inputs are past state except the last two, which are `block_table` and `past_sequence_length`
+    auto past_end_iter = num_subgraph_inputs - 2;
+    for (int i = first_past_input_index_; i < past_end_iter; ++i) {
+      OrtValue past_tensor;
+      Tensor::InitOrtValue(past_type, past_shape, default_allocator, past_tensor);
+      feeds.push_back(past_tensor);
+    }
+
+    // Block table feed. It is filled by the generation loop before each run.
+    const int64_t max_blocks_per_sequence =
+        (static_cast<int64_t>(past_present_share_buffer_max_seq_len) + kv_block_size_ - 1) / kv_block_size_;
+    TensorShape block_table_shape{batch_size * num_beams, max_blocks_per_sequence};
+    OrtValue block_table;
+    Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(), block_table_shape, cpu_allocator, block_table);
+    auto block_table_data = block_table.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>();
+    std::fill(block_table_data.begin(), block_table_data.end(), -1);
+    feeds.push_back(block_table);
+
+    // Past sequence length feed
+    ORT_RETURN_IF_ERROR(AppendPastSequenceLength(feeds, cpu_allocator, 0));
   } else {
     // Past state feeds
     TensorShape past_shape{2, batch_size * num_beams, num_heads, past_present_share_buffer_max_seq_len, head_size};
@@ -127,42 +156,83 @@ Status GptSubgraph::Validate(const std::vector<const NodeArg*>& subgraph_inputs,
 
   ORT_RETURN_IF(!((num_subgraph_inputs == num_subgraph_outputs + 2) ||
                   (num_subgraph_inputs == num_subgraph_outputs + 3) ||
+                  (num_subgraph_inputs == num_subgraph_outputs + 4 && paged_kv_cache_) ||
                   (num_subgraph_inputs == num_subgraph_outputs + 5)),
                 "Invalid GPT-2 subgraph: number of inputs shall be number of outputs plus 2 or "
                 "3 (if past_present_share_buffer) or "
+                "4 (if past_present_share_buffer with paged past state) or "
                 "5 (if past_present_share_buffer and use_decoder_masked_self_attention for BeamSearch)");
 
+  if (paged_kv_cache_) {
+    ORT_RETURN_IF(num_subgraph_inputs != num_subgraph_outputs + 4 || has_decoder_masked_attention_,
+                  "Invalid GPT-2 subgraph: paged past state does not support DecoderMaskedSelfAttention.");
+    ORT_RETURN_IF(subgraph_inputs[num_subgraph_inputs - 2]->Name() != "block_table",
+                  "subgraph input ", num_subgraph_inputs - 2, " shall be named as block_table, got: ",
+                  subgraph_inputs[num_subgraph_inputs - 2]->Name());
+    ORT_RETURN_IF(subgraph_inputs[num_subgraph_inputs - 1]->Name() != "past_sequence_length",
+                  "subgraph input ", num_subgraph_inputs - 1, " shall be named as past_sequence_length, got: ",
+                  subgraph_inputs[num_subgraph_inputs - 1]->Name());
+  }
+
   ORT_RETURN_IF(subgraph_inputs[0]->Name() != "input_ids",
                 "subgraph input 0 shall be named as input_ids, got: ", subgraph_inputs[0]->Name());
   ORT_RETURN_IF(subgraph_inputs[1]->Name() != "position_ids",
                 "subgraph input 1 shall be named as position_ids, got: ", subgraph_inputs[1]->Name());
   ORT_RETURN_IF(subgraph_inputs[2]->Name() != "attention_mask",
                 "subgraph input 2 shall be named as attention_mask, got: ", subgraph_inputs[2]->Name());
-  ORT_RETURN_IF(subgraph_inputs[3]->Name() != "past_0",
-                "subgraph input 3 shall be named as past_0, got: ", subgraph_inputs[3]->Name());
 
-  // Past state shape is like (2, batch_size, num_heads, past_seq_len, hidden_size/num_heads).
   const ONNX_NAMESPACE::TensorShapeProto* past_shape = subgraph_inputs[3]->Shape();
   ORT_RETURN_IF(past_shape == nullptr,
                 "subgraph past state cannot be nullptr");
-  ORT_RETURN_IF(past_shape->dim_size() != 5,
-                "subgraph past state is expected to have 5 dimension, got ", past_shape->dim_size());
 
-  ORT_RETURN_IF(!past_shape->dim(0).has_dim_value() || past_shape->dim(0).dim_value() != 2,
-                "subgraph past state dimension 0 shall have length of 2");
+  if (paged_kv_cache_) {
+    // Paged past state has a key pool and a value pool per layer, which are the past_key and past_value inputs of
+    // GroupQueryAttention. Pool shape is like (num_blocks, kv_num_heads, block_size, hidden_size/num_heads).
+    ORT_RETURN_IF((num_subgraph_outputs - first_present_output_index_) % 2 != 0,
+                  "Invalid GPT-2 subgraph: paged past state shall have a present key and a present value per layer.");
+    ORT_RETURN_IF(subgraph_inputs[3]->Name() != "past_key_0",
+                  "subgraph input 3 shall be named as past_key_0, got: ", subgraph_inputs[3]->Name());
+    ORT_RETURN_IF(subgraph_inputs[4]->Name() != "past_value_0",
+                  "subgraph input 4 shall be named as past_value_0, got: ", subgraph_inputs[4]->Name());
+    ORT_RETURN_IF(past_shape->dim_size() != 4,
+                  "subgraph paged past state is expected to have 4 dimension, got ", past_shape->dim_size());
+
+    ORT_RETURN_IF(!past_shape->dim(1).has_dim_value() || past_shape->dim(1).dim_value() <= 0,
+                  "subgraph paged past state dimension 1 shall have a positive value for number of heads");
+
+    ORT_RETURN_IF(!past_shape->dim(3).has_dim_value() || past_shape->dim(3).dim_value() <= 0,
+                  "subgraph paged past state dimension 3 shall have a positive value for hidden size per head");
+  } else {
+    ORT_RETURN_IF(subgraph_inputs[3]->Name() != "past_0",
+                  "subgraph input 3 shall be named as past_0, got: ", subgraph_inputs[3]->Name());
+
+    // Past state shape is like (2, batch_size, num_heads, past_seq_len, hidden_size/num_heads).
+    ORT_RETURN_IF(past_shape->dim_size() != 5,
+                  "subgraph past state is expected to have 5 dimension, got ", past_shape->dim_size());
+
+    ORT_RETURN_IF(!past_shape->dim(0).has_dim_value() || past_shape->dim(0).dim_value() != 2,
+                  "subgraph past state dimension 0 shall have length of 2");
 
-  ORT_RETURN_IF(!past_shape->dim(2).has_dim_value() || past_shape->dim(2).dim_value() <= 0,
-                "subgraph past state dimension 2 shall have a positive value for number of heads");
+    ORT_RETURN_IF(!past_shape->dim(2).has_dim_value() || past_shape->dim(2).dim_value() <= 0,
+                  "subgraph past state dimension 2 shall have a positive value for number of heads");
 
-  ORT_RETURN_IF(!past_shape->dim(4).has_dim_value() || past_shape->dim(4).dim_value() <= 0,
-                "subgraph past state dimension 4 shall have a positive value for hidden size per head");
+    ORT_RETURN_IF(!past_shape->dim(4).has_dim_value() || past_shape->dim(4).dim_value() <= 0,
+                  "subgraph past state dimension 4 shall have a positive value for hidden size per head");
+  }
 
   // check subgraph outputs
   ORT_RETURN_IF(subgraph_outputs[0]->Name() != "logits",
                 "subgraph output 0 shall be named as logits, got: ", subgraph_outputs[0]->Name());
 
-  ORT_RETURN_IF(subgraph_outputs[1]->Name() != "present_0",
-                "subgraph input 1 shall be named as present_0, got: ", subgraph_outputs[1]->Name());
+  if (paged_kv_cache_) {
+    ORT_RETURN_IF(subgraph_outputs[1]->Name() != "present_key_0",
+                  "subgraph output 1 shall be named as present_key_0, got: ", subgraph_outputs[1]->Name());
+    ORT_RETURN_IF(subgraph_outputs[2]->Name() != "present_value_0",
+                  "subgraph output 2 shall be named as present_value_0, got: ", subgraph_outputs[2]->Name());
+  } else {
+    ORT_RETURN_IF(subgraph_outputs[1]->Name() != "present_0",
+                  "subgraph input 1 shall be named as present_0, got: ", subgraph_outputs[1]->Name());
+  }
 
   // Logits shape is like (batch_size, seq_len, 50257). Here 50257 is the vocabulary size.
   const ONNX_NAMESPACE::TensorShapeProto* logits_shape = subgraph_outputs[0]->Shape();
@@ -173,10 +243,19 @@ Status GptSubgraph::Validate(const std::vector<const NodeArg*>& subgraph_inputs,
                 "subgraph past state dimension 2 shall have a positive value for vocabulary size");
 
   // Save parameters related to the subgraph.
-  num_heads = static_cast<int>(past_shape->dim(2).dim_value());
-  head_size = static_cast<int>(past_shape->dim(4).dim_value());
   vocab_size = static_cast<int>(logits_shape->dim(2).dim_value());
-  num_layers = static_cast<int>(subgraph_outputs.size()) - 1;
+  if (paged_kv_cache_) {
+    num_heads = static_cast<int>(past_shape->dim(1).dim_value());
+    head_size = static_cast<int>(past_shape->dim(3).dim_value());
+    num_layers = (static_cast<int>(subgraph_outputs.size()) - 1) / 2;
+    kv_block_size_ = past_shape->dim(2).has_dim_value() && past_shape->dim(2).dim_value() > 0
+                         ? static_cast<int>(past_shape->dim(2).dim_value())
+                         : kDefaultKVBlockSize;
+  } else {
+    num_heads = static_cast<int>(past_shape->dim(2).dim_value());
+    head_size = static_cast<int>(past_shape->dim(4).dim_value());
+    num_layers = static_cast<int>(subgraph_outputs.size()) - 1;
+  }
 
   constexpr auto int32_type = ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_INT32;
   constexpr auto float32_type = ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_FLOAT;
@@ -188,15 +267,18 @@ Status GptSubgraph::Validate(const std::vector<const NodeArg*>& subgraph_inputs,
                 "subgraph input 1 (position_ids) shall have int32 type");
   ORT_RETURN_IF(subgraph_inputs[2]->TypeAsProto()->tensor_type().elem_type() != int32_type,
                 "subgraph input 2 (attention_mask) shall have int32 type");
+  ORT_RETURN_IF(paged_kv_cache_ &&
+                    subgraph_inputs[num_subgraph_inputs - 2]->TypeAsProto()->tensor_type().elem_type() != int32_type,
+                "subgraph input block_table shall have int32 type");
 
   auto output_type = subgraph_outputs[0]->TypeAsProto()->tensor_type().elem_type();
   ORT_RETURN_IF(output_type != float32_type && output_type != float16_type,
                 "subgraph output 0 (logits) shall be float or float16 data type");
 
   ORT_RETURN_IF(subgraph_inputs[first_past_input_index_]->TypeAsProto()->tensor_type().elem_type() != output_type,
-                "subgraph input 3 (past_0) shall shall have same data type of logits output");
+                "subgraph input 3 (past state) shall shall have same data type of logits output");
   ORT_RETURN_IF(subgraph_outputs[first_present_output_index_]->TypeAsProto()->tensor_type().elem_type() != output_type,
-                "subgraph output 1 (present_0) shall shall have same data type of logits output");
+                "subgraph output 1 (present state) shall shall have same data type of logits output");
 
   is_output_float16_ = (output_type == float16_type);
 
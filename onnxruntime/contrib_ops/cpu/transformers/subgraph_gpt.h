@@ -48,6 +48,19 @@ class GptSubgraph : public Subgraph {
     return first_present_output_index_;
   }
 
+  // The block_table input precedes past_sequence_length when the past state is paged.
+  int GetBlockTableInputIndex() const {
+    return num_subgraph_inputs - 2;
+  }
+
+  // Number of past state inputs. A paged past state has separate key and value pools per layer.
+  int GetNumPastInputs() const {
+    return paged_kv_cache_ ? 2 * num_layers : num_layers;
+  }
+
+  // Block size of the paged past state when the subgraph does not specify it in the shape of past_key_0.
+  static constexpr int kDefaultKVBlockSize = 16;
+
  private:
   int first_past_input_index_;
   int first_present_output_index_;
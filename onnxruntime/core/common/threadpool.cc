@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <optional>
 
@@ -410,7 +412,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
   if (total <= 0)
     return;
 
-  if (total <= block_size) {
+  if (total <= block_size || MaxThreadsForCaller() == 1) {
     fn(0, total);
     return;
   }
@@ -420,7 +422,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     // Split the work across threads in the pool.  Each work item will run a loop claiming iterations,
     // hence we need at most one for each thread, even if the number of blocks of iterations is larger.
     auto num_blocks = total / block_size;
-    auto num_threads_inc_main = NumThreads() + 1;
+    auto num_threads_inc_main = MaxThreadsForCaller();
     int num_work_items = static_cast<int>(std::min(static_cast<std::ptrdiff_t>(num_threads_inc_main), num_blocks));
     assert(num_work_items > 0);
 
@@ -459,7 +461,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     };
     // Distribute task among all threads in the pool, reduce number of work items if
     // num_of_blocks is smaller than number of threads.
-    RunInParallel(run_work, std::min(NumThreads() + 1, num_of_blocks), base_block_size);
+    RunInParallel(run_work, std::min(MaxThreadsForCaller(), num_of_blocks), base_block_size);
   }
 }
 
@@ -495,6 +497,80 @@ std::string ThreadPool::StopProfiling() {
 
 namespace {
 thread_local std::optional<ThreadPoolParallelSection> current_parallel_section;
+thread_local int current_thread_limit = 0;
+thread_local double current_block_size_scale = 1.0;
+thread_local uint64_t* current_wait_counter = nullptr;
+thread_local std::chrono::steady_clock::time_point current_deadline = std::chrono::steady_clock::time_point::max();
+
+uint64_t NanosecondsSince(std::chrono::steady_clock::time_point start) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+}  // namespace
+
+ThreadPool::ScopedThreadLimit::ScopedThreadLimit(int max_threads) : previous_limit_(current_thread_limit) {
+  if (max_threads > 0) {
+    current_thread_limit = previous_limit_ > 0 ? std::min(previous_limit_, max_threads) : max_threads;
+  }
+}
+
+ThreadPool::ScopedThreadLimit::~ScopedThreadLimit() {
+  current_thread_limit = previous_limit_;
+}
+
+ThreadPool::ScopedBlockSizeScale::ScopedBlockSizeScale(double scale) : previous_scale_(current_block_size_scale) {
+  current_block_size_scale = scale > 0.0 ? scale : 1.0;
+}
+
+ThreadPool::ScopedBlockSizeScale::~ScopedBlockSizeScale() {
+  current_block_size_scale = previous_scale_;
+}
+
+ThreadPool::ScopedWaitTimeCounter::ScopedWaitTimeCounter() : previous_counter_(current_wait_counter) {
+  current_wait_counter = &wait_ns_;
+}
+
+ThreadPool::ScopedWaitTimeCounter::~ScopedWaitTimeCounter() {
+  current_wait_counter = previous_counter_;
+}
+
+ThreadPool::ScopedPriority::ScopedPriority(Priority priority) : previous_priority_(CurrentPriority()) {
+  ThreadPoolTempl<Env>::SetCallerHighPriority(priority == Priority::kHigh);
+}
+
+ThreadPool::ScopedPriority::~ScopedPriority() {
+  ThreadPoolTempl<Env>::SetCallerHighPriority(previous_priority_ == Priority::kHigh);
+}
+
+ThreadPool::Priority ThreadPool::CurrentPriority() {
+  return ThreadPoolTempl<Env>::CallerHasHighPriority() ? Priority::kHigh : Priority::kNormal;
+}
+
+int ThreadPool::CurrentThreadLimit() {
+  return current_thread_limit;
+}
+
+ThreadPool::ScopedDeadline::ScopedDeadline(std::chrono::steady_clock::time_point deadline)
+    : previous_deadline_(current_deadline) {
+  current_deadline = std::min(previous_deadline_, deadline);
+}
+
+ThreadPool::ScopedDeadline::~ScopedDeadline() {
+  current_deadline = previous_deadline_;
+}
+
+std::chrono::steady_clock::time_point ThreadPool::CurrentDeadline() {
+  return current_deadline;
+}
+
+bool ThreadPool::DeadlinePassed() {
+  return current_deadline != std::chrono::steady_clock::time_point::max() &&
+         std::chrono::steady_clock::now() >= current_deadline;
+}
+
+int ThreadPool::MaxThreadsForCaller() const {
+  const int num_threads_inc_main = NumThreads() + 1;
+  return current_thread_limit > 0 ? std::min(num_threads_inc_main, current_thread_limit) : num_threads_inc_main;
 }
 
 ThreadPool::ParallelSection::ParallelSection(ThreadPool* tp) {
@@ -516,6 +592,36 @@ ThreadPool::ParallelSection::~ParallelSection() {
 }
 
 void ThreadPool::RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size) {
+  if (underlying_threadpool_ && current_wait_counter != nullptr) {
+    // the calling thread runs work item 0, the time outside of it is spent on the pool
+    uint64_t* wait_counter = current_wait_counter;
+    uint64_t own_work_ns = 0;
+    const auto start = std::chrono::steady_clock::now();
+    std::function<void(unsigned idx)> timed_fn = [&fn, &own_work_ns](unsigned idx) {
+      if (idx != 0) {
+        fn(idx);
+        return;
+      }
+      const auto own_work_start = std::chrono::steady_clock::now();
+      fn(idx);
+      own_work_ns += NanosecondsSince(own_work_start);
+    };
+    current_wait_counter = nullptr;
+    RunInParallel(std::move(timed_fn), n, block_size);
+    current_wait_counter = wait_counter;
+    const uint64_t total_ns = NanosecondsSince(start);
+    *wait_counter += total_ns > own_work_ns ? total_ns - own_work_ns : 0;
+    return;
+  }
+
+  if (underlying_threadpool_ && current_deadline != std::chrono::steady_clock::time_point::max()) {
+    // the workers run their items under the deadline of the caller so that kernels see it on every thread
+    fn = [fn = std::move(fn), deadline = current_deadline](unsigned idx) {
+      ScopedDeadline scoped_deadline(deadline);
+      fn(idx);
+    };
+  }
+
   if (underlying_threadpool_) {
     if (current_parallel_section.has_value()) {
       underlying_threadpool_->RunInParallelSection(*current_parallel_section,
@@ -546,6 +652,11 @@ bool ThreadPool::ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
     return false;
   }
 
+  // Do not parallelize loops if the calling thread is limited to itself
+  if (MaxThreadsForCaller() == 1) {
+    return false;
+  }
+
   return true;
 }
 
@@ -623,6 +734,9 @@ void ThreadPool::ParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
   }
 
   ptrdiff_t block = CalculateParallelForBlock(n, cost, nullptr, d_of_p);
+  if (current_block_size_scale != 1.0) {
+    block = std::clamp<ptrdiff_t>(static_cast<ptrdiff_t>(static_cast<double>(block) * current_block_size_scale), 1, n);
+  }
   ParallelForFixedBlockSizeScheduling(n, block, f);
 }
 
@@ -640,15 +754,19 @@ int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
   // tp, plus 1 for the thread entering a loop.
   if (tp) {
     if (tp->force_hybrid_ || CPUIDInfo::GetCPUIDInfo().IsHybrid()) {
-      return ((tp->NumThreads() + 1)) * TaskGranularityFactor;
+      return tp->MaxThreadsForCaller() * TaskGranularityFactor;
     } else {
-      return ((tp->NumThreads() + 1));
+      return tp->MaxThreadsForCaller();
     }
   } else {
     return 1;
   }
 }
 
+int ThreadPool::NumThreadsIncludingCaller(const concurrency::ThreadPool* tp) {
+  return tp ? tp->NumThreads() + 1 : 1;
+}
+
 void ThreadPool::StartProfiling(concurrency::ThreadPool* tp) {
   if (tp) {
     tp->StartProfiling();
@@ -675,6 +793,13 @@ void ThreadPool::DisableSpinning() {
   }
 }
 
+ThreadPoolStats ThreadPool::GetStats() const {
+  if (extended_eigen_threadpool_) {
+    return extended_eigen_threadpool_->GetStats();
+  }
+  return {};
+}
+
 // Return the number of threads created by the pool.
 int ThreadPool::NumThreads() const {
   if (underlying_threadpool_) {
@@ -3,6 +3,8 @@
 
 #include "core/framework/allocation_planner.h"
 #include <list>
+#include <set>
+#include <string_view>
 #include <algorithm>
 #include <deque>
 #include <sstream>
@@ -1918,7 +1920,8 @@ class PlannerImpl {
   void
   PartitionIntoStreams(const logging::Logger& logger, const ExecutionProviders& execution_providers,
                        const PathString& partition_config_file) {
-    auto partitioner = IGraphPartitioner::CreateGraphPartitioner(logger, partition_config_file);
+    const size_t max_cpu_streams = context_->IsParallelExecutionEnabled() ? context_->GetMaxCpuStreams() : 1;
+    auto partitioner = IGraphPartitioner::CreateGraphPartitioner(logger, partition_config_file, max_cpu_streams);
     auto status = partitioner->PartitionGraph(graph_viewer_, execution_providers, stream_nodes_, context_->GetExecutionOrder());
     ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
     plan_.node_stream_map_.resize(SafeInt<size_t>(graph_viewer_.MaxNodeIndex()) + 1);
@@ -2541,11 +2544,222 @@ void DeviceBasedPartitioner::SaveConfig() const {
   }
 }
 
+/*
+CriticalPathPartitioner splits the CPU nodes of a graph into up to max_cpu_streams sequences for parallel execution.
+Nodes of other devices are put into one stream per device type, as DeviceBasedPartitioner does.
+
+Nodes are list scheduled by their bottom level, i.e. the estimated cost of the longest path from the node to a graph
+output, so the nodes on the critical path are scheduled first. Each CPU node goes to the stream on which it can start
+the earliest, where a dependency on a node of another stream adds the cost of a barrier. The cost of a node is a rough
+estimate by op type as the shapes are not always known at this point.
+*/
+class CriticalPathPartitioner : public IGraphPartitioner {
+ public:
+  CriticalPathPartitioner(const logging::Logger& logger, size_t max_cpu_streams)
+      : IGraphPartitioner(logger, PathString{}), max_cpu_streams_(std::max<size_t>(max_cpu_streams, 1)) {}
+
+  Status PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
+                        const ExecutionProviders& execution_providers,
+                        std::vector<InlinedVector<NodeIndex>>& stream_nodes,
+                        ExecutionOrder execution_order) override;
+
+  const char* Type() const override { return "CriticalPathPartitioner"; }
+  size_t Streams() const override { return num_streams_; }
+
+ private:
+  static double EstimateCost(const Node& node);
+
+  // cost of synchronizing with a node of another stream, relative to the cost of a lightweight node
+  static constexpr double kCrossStreamCost = 0.5;
+
+  const size_t max_cpu_streams_;
+  size_t num_streams_ = 0;
+};
+
+double CriticalPathPartitioner::EstimateCost(const Node& node) {
+  static const InlinedHashSet<std::string_view> heavy_ops = {
+      "Attention", "Conv", "ConvInteger", "ConvTranspose", "DynamicQuantizeMatMul", "FusedConv", "FusedGemm",
+      "FusedMatMul", "GRU", "Gemm", "LSTM", "MatMul", "MatMulInteger", "MatMulIntegerToFloat", "MatMulNBits",
+      "MultiHeadAttention", "NchwcConv", "QAttention", "QGemm", "QLinearConv", "QLinearMatMul", "RNN"};
+  static const InlinedHashSet<std::string_view> light_ops = {
+      "Constant", "ConstantOfShape", "Flatten", "Gather", "Identity", "Range", "Reshape", "Shape", "Size", "Slice",
+      "Squeeze", "Unsqueeze"};
+
+  if (heavy_ops.count(node.OpType()) > 0) {
+    return 16.0;
+  }
+  if (light_ops.count(node.OpType()) > 0) {
+    return 0.1;
+  }
+  // control flow nodes run a whole subgraph
+  if (node.ContainsSubgraph()) {
+    return 16.0;
+  }
+  return 1.0;
+}
+
+Status CriticalPathPartitioner::PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
+                                               const ExecutionProviders& execution_providers,
+                                               std::vector<InlinedVector<NodeIndex>>& stream_nodes,
+                                               ExecutionOrder execution_order) {
+  const auto& p_graph_nodes = graph_viewer.GetNodesInTopologicalOrder(execution_order);
+  const size_t max_node_index = graph_viewer.MaxNodeIndex();
+
+  std::vector<size_t> topo_index(max_node_index, 0);
+  std::vector<double> cost(max_node_index, 0.0);
+  std::vector<bool> is_cpu(max_node_index, false);
+  std::vector<OrtDevice::DeviceType> device_types(max_node_index, OrtDevice::CPU);
+  for (size_t i = 0; i < p_graph_nodes.size(); ++i) {
+    const auto* node = graph_viewer.GetNode(p_graph_nodes[i]);
+    const auto* ep = execution_providers.Get(*node);
+    ORT_RETURN_IF(ep == nullptr, "Failed to find the execution provider of node ", node->Name());
+    topo_index[node->Index()] = i;
+    cost[node->Index()] = EstimateCost(*node);
+    device_types[node->Index()] = ep->GetOrtDeviceByMemType(OrtMemType::OrtMemTypeDefault).Type();
+    is_cpu[node->Index()] = device_types[node->Index()] == OrtDevice::CPU;
+  }
+
+  // bottom level of each node: its cost plus the largest bottom level of the nodes consuming its outputs
+  std::vector<double> bottom_level(max_node_index, 0.0);
+  for (auto it = p_graph_nodes.rbegin(); it != p_graph_nodes.rend(); ++it) {
+    const auto* node = graph_viewer.GetNode(*it);
+    double max_successor_level = 0.0;
+    for (auto output_it = node->OutputNodesBegin(); output_it != node->OutputNodesEnd(); ++output_it) {
+      max_successor_level = std::max(max_successor_level, bottom_level[output_it->Index()]);
+    }
+    bottom_level[*it] = cost[*it] + max_successor_level;
+  }
+
+  // ready nodes ordered by the largest bottom level first, then by topological order
+  auto ready_order = [&](NodeIndex a, NodeIndex b) {
+    if (bottom_level[a] != bottom_level[b]) {
+      return bottom_level[a] > bottom_level[b];
+    }
+    return topo_index[a] < topo_index[b];
+  };
+  std::set<NodeIndex, decltype(ready_order)> ready(ready_order);
+
+  std::vector<size_t> pending_inputs(max_node_index, 0);
+  for (auto node_index : p_graph_nodes) {
+    const auto* node = graph_viewer.GetNode(node_index);
+    pending_inputs[node_index] = node->GetInputEdgesCount();
+    if (pending_inputs[node_index] == 0) {
+      ready.insert(node_index);
+    }
+  }
+
+  struct StreamState {
+    OrtDevice::DeviceType device_type;
+    double free_at;
+    InlinedVector<NodeIndex> nodes;
+  };
+  std::vector<StreamState> streams;
+  InlinedHashMap<OrtDevice::DeviceType, size_t> device_to_stream;
+  InlinedVector<size_t> cpu_streams;
+  std::vector<size_t> node_stream(max_node_index, 0);
+  std::vector<double> finish_at(max_node_index, 0.0);
+
+  auto start_time_on = [&](const Node& node, size_t stream_idx) {
+    double start = streams[stream_idx].free_at;
+    for (auto input_it = node.InputNodesBegin(); input_it != node.InputNodesEnd(); ++input_it) {
+      const auto input_index = input_it->Index();
+      const double sync_cost = node_stream[input_index] == stream_idx ? 0.0 : kCrossStreamCost;
+      start = std::max(start, finish_at[input_index] + sync_cost);
+    }
+    return start;
+  };
+
+  while (!ready.empty()) {
+    const NodeIndex node_index = *ready.begin();
+    ready.erase(ready.begin());
+    const auto* node = graph_viewer.GetNode(node_index);
+
+    size_t stream_idx = 0;
+    if (!is_cpu[node_index]) {
+      auto it = device_to_stream.find(device_types[node_index]);
+      if (it == device_to_stream.end()) {
+        it = device_to_stream.emplace(device_types[node_index], streams.size()).first;
+        streams.push_back({device_types[node_index], 0.0, {}});
+      }
+      stream_idx = it->second;
+    } else {
+      // pick the CPU stream with the earliest start. prefer continuing a stream whose last node is an input on ties,
+      // and open a new stream only if it lets the node start earlier.
+      bool found = false;
+      double best_start = 0.0;
+      bool best_continues_input = false;
+      for (auto candidate : cpu_streams) {
+        const double start = start_time_on(*node, candidate);
+        bool continues_input = false;
+        if (!streams[candidate].nodes.empty()) {
+          const auto tail = streams[candidate].nodes.back();
+          for (auto input_it = node->InputNodesBegin(); input_it != node->InputNodesEnd(); ++input_it) {
+            if (input_it->Index() == tail) {
+              continues_input = true;
+              break;
+            }
+          }
+        }
+        if (!found || start < best_start || (start == best_start && continues_input && !best_continues_input)) {
+          found = true;
+          best_start = start;
+          best_continues_input = continues_input;
+          stream_idx = candidate;
+        }
+      }
+      if (cpu_streams.size() < max_cpu_streams_) {
+        streams.push_back({OrtDevice::CPU, 0.0, {}});
+        const size_t new_stream = streams.size() - 1;
+        if (!found || start_time_on(*node, new_stream) < best_start) {
+          cpu_streams.push_back(new_stream);
+          stream_idx = new_stream;
+        } else {
+          streams.pop_back();
+        }
+      }
+    }
+
+    const double start = start_time_on(*node, stream_idx);
+    node_stream[node_index] = stream_idx;
+    finish_at[node_index] = start + cost[node_index];
+    streams[stream_idx].free_at = finish_at[node_index];
+    streams[stream_idx].nodes.push_back(node_index);
+
+    for (auto output_it = node->OutputNodesBegin(); output_it != node->OutputNodesEnd(); ++output_it) {
+      // an edge per input, so a node consuming several outputs of this node is counted down several times
+      if (--pending_inputs[output_it->Index()] == 0) {
+        ready.insert(output_it->Index());
+      }
+    }
+  }
+
+  size_t num_scheduled = 0;
+  for (const auto& stream : streams) {
+    num_scheduled += stream.nodes.size();
+  }
+  ORT_RETURN_IF_NOT(num_scheduled == p_graph_nodes.size(), "CriticalPathPartitioner scheduled ", num_scheduled,
+                    " of ", p_graph_nodes.size(), " nodes");
+
+  stream_nodes.clear();
+  stream_nodes.reserve(streams.size());
+  for (auto& stream : streams) {
+    stream_nodes.push_back(std::move(stream.nodes));
+  }
+  num_streams_ = stream_nodes.size();
+  LOGS(logger_, INFO) << "CriticalPathPartitioner partitioned " << p_graph_nodes.size() << " nodes into "
+                      << num_streams_ << " streams, " << cpu_streams.size() << " of them on CPU";
+  return Status::OK();
+}
+
 std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(const logging::Logger& logger,
-                                                                             const PathString& config_file) {
-  // use device based partitioner by default
+                                                                             const PathString& config_file,
+                                                                             size_t max_cpu_streams) {
+  // use device based partitioner by default, and the critical path based one when the CPU nodes may use several
+  // streams. a config file always takes precedence.
   IGraphPartitioner::GraphPartitioningStrategy partitioner_type =
-      IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition;
+      max_cpu_streams > 1 && config_file.empty()
+          ? IGraphPartitioner::GraphPartitioningStrategy::CriticalPathBasedPartition
+          : IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition;
   if (!config_file.empty()) {
     std::ifstream f(config_file);
     if (f.is_open()) {
@@ -2566,6 +2780,9 @@ std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(con
   if (partitioner_type == IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition) {
     LOGS(logger, INFO) << "Use DeviceBasedPartition as default";
     return std::make_unique<DeviceBasedPartitioner>(logger, config_file);
+  } else if (partitioner_type == IGraphPartitioner::GraphPartitioningStrategy::CriticalPathBasedPartition) {
+    LOGS(logger, INFO) << "Use CriticalPathBasedPartition with up to " << max_cpu_streams << " CPU streams";
+    return std::make_unique<CriticalPathPartitioner>(logger, max_cpu_streams);
   }  // else if other partitioner types ...
   ORT_THROW("Failed to create partitioner");
 }
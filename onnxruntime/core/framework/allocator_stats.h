@@ -22,6 +22,9 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  int64_t num_thread_cache_hits;     // Number of allocations served from per-thread caches without locking the arena.
+  int64_t num_thread_cache_flushes;  // Number of times a per-thread cache returned chunks to the arena.
+  int64_t thread_cache_bytes;        // Bytes of freed chunks held in per-thread caches.
 
   AllocatorStats() { Clear(); }
 
@@ -35,6 +38,9 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_thread_cache_hits = 0;
+    this->num_thread_cache_flushes = 0;
+    this->thread_cache_bytes = 0;
   }
 
   std::string DebugString() const {
@@ -47,7 +53,10 @@ struct AllocatorStats {
        << "NumReserves:              " << this->num_reserves << "\n"
        << "NumArenaExtensions:       " << this->num_arena_extensions << "\n"
        << "NumArenaShrinkages:       " << this->num_arena_shrinkages << "\n"
-       << "MaxAllocSize:             " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:             " << this->max_alloc_size << "\n"
+       << "NumThreadCacheHits:       " << this->num_thread_cache_hits << "\n"
+       << "NumThreadCacheFlushes:    " << this->num_thread_cache_flushes << "\n"
+       << "ThreadCacheBytes:         " << this->thread_cache_bytes << "\n";
     return ss.str();
   }
 };
@@ -12,7 +12,8 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
                    int initial_growth_chunk_size_bytes,
-                   int64_t max_power_of_two_extend_bytes)
+                   int64_t max_power_of_two_extend_bytes,
+                   int64_t thread_cache_max_bytes)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -25,15 +26,21 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
       max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
       initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes),
-      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes) {
+      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes),
+      thread_cache_max_bytes_(thread_cache_max_bytes > 0 ? static_cast<size_t>(thread_cache_max_bytes) : 0) {
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
                      << " max_power_of_two_extend_bytes: " << max_power_of_two_extend_bytes_
+                     << " thread_cache_max_bytes: " << thread_cache_max_bytes_
                      << " memory limit: " << total_memory
                      << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
 
+  if (thread_cache_max_bytes_ > 0) {
+    thread_cache_shards_ = std::make_unique<ThreadCacheShard[]>(kNumThreadCacheShards);
+  }
+
   // static_cast<std::underlying_type_t<ArenaExtendStrategy>>(arena_extend_strategy); doesn't work on this compiler
 
   curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, static_cast<size_t>(initial_chunk_size_bytes_)));
@@ -269,9 +276,137 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (thread_cache_shards_ && size > 0 && size <= kThreadCacheMaxChunkSize) {
+    return AllocateSmall(size);
+  }
   return AllocateRawInternal(size, false, nullptr, false, nullptr);
 }
 
+BFCArena::ThreadCacheShard& BFCArena::ThreadCacheShardForThread() {
+  // spread threads over the shards round-robin
+  static std::atomic<size_t> next_shard{0};
+  static thread_local const size_t shard = next_shard++;
+  return thread_cache_shards_[shard % kNumThreadCacheShards];
+}
+
+BFCArena::ThreadCacheShard& BFCArena::ThreadCacheShardForAddress(const void* p) {
+  auto chunk_index = reinterpret_cast<uintptr_t>(p) >> kMinAllocationBits;
+  return thread_cache_shards_[chunk_index % kNumThreadCacheShards];
+}
+
+void* BFCArena::AllocateSmall(size_t num_bytes) {
+  const size_t rounded_bytes = RoundedBytes(num_bytes);
+  const BinNum bin_num = BinNumForSize(rounded_bytes);
+
+  CachedChunk chunk{nullptr, 0};
+  {
+    ThreadCacheShard& shard = ThreadCacheShardForThread();
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    auto& free_chunks = shard.free_chunks[bin_num];
+    // chunks in a bin differ in size. only look at the most recently freed ones.
+    constexpr int kMaxCandidates = 4;
+    int candidates = 0;
+    for (auto it = free_chunks.rbegin(); it != free_chunks.rend() && candidates < kMaxCandidates; ++it, ++candidates) {
+      if (it->size >= rounded_bytes) {
+        chunk = *it;
+        free_chunks.erase(std::next(it).base());
+        shard.cached_bytes -= chunk.size;
+        break;
+      }
+    }
+  }
+
+  if (chunk.ptr != nullptr) {
+    thread_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+    thread_cache_bytes_.fetch_sub(static_cast<int64_t>(chunk.size), std::memory_order_relaxed);
+  } else {
+    chunk.ptr = AllocateRawInternal(num_bytes, false, nullptr, false, nullptr);
+    chunk.size = AllocatedSize(chunk.ptr);
+  }
+
+  ThreadCacheShard& owner = ThreadCacheShardForAddress(chunk.ptr);
+  std::lock_guard<OrtMutex> lock(owner.mutex);
+  owner.in_use.insert_or_assign(chunk.ptr, std::make_pair(chunk.size, num_bytes));
+  return chunk.ptr;
+}
+
+bool BFCArena::FreeSmall(void* p) {
+  size_t chunk_size = 0;
+  {
+    ThreadCacheShard& owner = ThreadCacheShardForAddress(p);
+    std::lock_guard<OrtMutex> lock(owner.mutex);
+    auto it = owner.in_use.find(p);
+    if (it == owner.in_use.end()) {
+      return false;
+    }
+    chunk_size = it->second.first;
+    owner.in_use.erase(it);
+  }
+
+  std::vector<void*> evicted;
+  const BinNum bin_num = BinNumForSize(chunk_size);
+  if (bin_num < kNumThreadCacheBins) {
+    ThreadCacheShard& shard = ThreadCacheShardForThread();
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    shard.free_chunks[bin_num].push_back({p, chunk_size});
+    shard.cached_bytes += chunk_size;
+    thread_cache_bytes_.fetch_add(static_cast<int64_t>(chunk_size), std::memory_order_relaxed);
+    if (shard.cached_bytes > thread_cache_max_bytes_) {
+      // return the oldest half so the next few frees do not need to take lock_ as well
+      EvictFromThreadCache(shard, thread_cache_max_bytes_ / 2, evicted);
+    }
+  } else {
+    evicted.push_back(p);
+  }
+
+  if (!evicted.empty()) {
+    ReturnToBins(evicted);
+  }
+
+  return true;
+}
+
+void BFCArena::EvictFromThreadCache(ThreadCacheShard& shard, size_t max_bytes, std::vector<void*>& evicted) {
+  size_t evicted_bytes = 0;
+  // start with the largest chunks as they are the least likely to be reused soon
+  for (int b = kNumThreadCacheBins - 1; b >= 0 && shard.cached_bytes > max_bytes; --b) {
+    auto& free_chunks = shard.free_chunks[b];
+    while (!free_chunks.empty() && shard.cached_bytes > max_bytes) {
+      evicted.push_back(free_chunks.front().ptr);
+      shard.cached_bytes -= free_chunks.front().size;
+      evicted_bytes += free_chunks.front().size;
+      free_chunks.pop_front();
+    }
+  }
+
+  thread_cache_bytes_.fetch_sub(static_cast<int64_t>(evicted_bytes), std::memory_order_relaxed);
+}
+
+void BFCArena::ReturnToBins(const std::vector<void*>& chunks) {
+  thread_cache_flushes_.fetch_add(1, std::memory_order_relaxed);
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (void* p : chunks) {
+    DeallocateRawInternal(p);
+  }
+}
+
+void BFCArena::FlushThreadCaches() {
+  if (!thread_cache_shards_) {
+    return;
+  }
+
+  std::vector<void*> evicted;
+  for (size_t i = 0; i < kNumThreadCacheShards; ++i) {
+    ThreadCacheShard& shard = thread_cache_shards_[i];
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    EvictFromThreadCache(shard, 0, evicted);
+  }
+
+  if (!evicted.empty()) {
+    ReturnToBins(evicted);
+  }
+}
+
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
@@ -293,6 +428,16 @@ void* BFCArena::Reserve(size_t size) {
 }
 
 size_t BFCArena::RequestedSize(const void* ptr) {
+  if (thread_cache_shards_) {
+    // the chunk may have been reused from a per-thread cache for a different size
+    ThreadCacheShard& owner = ThreadCacheShardForAddress(ptr);
+    std::lock_guard<OrtMutex> lock(owner.mutex);
+    auto it = owner.in_use.find(ptr);
+    if (it != owner.in_use.end()) {
+      return it->second.second;
+    }
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
   ORT_ENFORCE(h != kInvalidChunkHandle);
@@ -325,7 +470,7 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   // The BFC allocator tries to find the best fit first.
   BinNum bin_num = BinNumForSize(rounded_bytes);
 
-  std::lock_guard<OrtMutex> lock(lock_);
+  std::unique_lock<OrtMutex> lock(lock_);
   // search for a valid chunk
   auto* chunk = FindChunkPtr(bin_num,
                              rounded_bytes,
@@ -344,6 +489,24 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
     return chunk->ptr;
   }
 
+  // The chunks held by the per-thread caches are free but not in the bins. Return them to the bins, where they may
+  // coalesce with their neighbors, and search once more before growing the arena.
+  if (thread_cache_bytes_.load(std::memory_order_relaxed) > 0) {
+    lock.unlock();
+    FlushThreadCaches();
+    lock.lock();
+
+    chunk = FindChunkPtr(bin_num, rounded_bytes, num_bytes, stream, enable_cross_stream_reusing, wait_fn);
+    if (chunk != nullptr) {
+      if (chunk->stream == nullptr) {
+        chunk->stream = stream;
+        if (stream)
+          chunk->stream_timestamp = stream->GetCurrentTimestamp();
+      }
+      return chunk->ptr;
+    }
+  }
+
   LOGS_DEFAULT(INFO) << "Extending BFCArena for " << device_allocator_->Info().name
                      << ". bin_num:" << bin_num << " (requested) num_bytes: " << num_bytes << " (actual) rounded_bytes:" << rounded_bytes;
 
@@ -379,6 +542,17 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
+
+  if (thread_cache_shards_) {
+    // chunks in the per-thread caches are in use as far as the bins are concerned
+    const int64_t hits = thread_cache_hits_.load(std::memory_order_relaxed);
+    const int64_t cached_bytes = thread_cache_bytes_.load(std::memory_order_relaxed);
+    stats->num_allocs += hits;
+    stats->bytes_in_use -= cached_bytes;
+    stats->num_thread_cache_hits = hits;
+    stats->num_thread_cache_flushes = thread_cache_flushes_.load(std::memory_order_relaxed);
+    stats->thread_cache_bytes = cached_bytes;
+  }
 }
 
 BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* free_chunks,
@@ -496,6 +670,11 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+
+  if (thread_cache_shards_ && FreeSmall(p)) {
+    return;
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -509,6 +688,8 @@ void BFCArena::Free(void* p) {
 }
 
 Status BFCArena::Shrink() {
+  FlushThreadCaches();
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto num_regions = region_manager_.regions().size();
   std::vector<void*> region_ptrs;
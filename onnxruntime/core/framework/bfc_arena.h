@@ -16,13 +16,18 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include "onnxruntime_config.h"
 
 #include "core/common/common.h"
+#include "core/common/inlined_containers.h"
 #include "core/common/logging/logging.h"
 #include "core/common/logging/severity.h"
 #include "core/common/safeint.h"
@@ -61,6 +66,7 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const int64_t DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES = 1024 * 1024 * 1024;  // 1GB
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  static const int64_t DEFAULT_THREAD_CACHE_MAX_BYTES = 0;  // disabled
 
   enum ArenaType {
     BaseArena,
@@ -73,7 +79,8 @@ class BFCArena : public IAllocator {
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
            int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
-           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES);
+           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+           int64_t thread_cache_max_bytes = DEFAULT_THREAD_CACHE_MAX_BYTES);
 
   ~BFCArena() override;
 
@@ -86,6 +93,7 @@ class BFCArena : public IAllocator {
   void Free(void* p) override;
 
   // Frees all allocation regions in which no chunk is in use.
+  // Chunks held in the per-thread caches are returned to the arena first.
   // Does not free any reserved chunks.
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
@@ -429,6 +437,42 @@ class BFCArena : public IAllocator {
   // Computes and returns a BinDebugInfo for each Bin.
   std::array<BinDebugInfo, kNumBins> get_bin_debug_info();
 
+  // Per-thread caches of small chunks.
+  //
+  // A freed chunk of up to kThreadCacheMaxChunkSize bytes is kept in the cache shard of the freeing thread and handed
+  // out again to threads using the same shard without taking lock_. A cached chunk stays in use as far as the bins
+  // are concerned. Once a shard holds more than thread_cache_max_bytes_ it returns its oldest chunks to the bins.
+  //
+  // Small allocations are also recorded in a shard chosen by their address so that Free can tell whether a pointer
+  // belongs to a small chunk, and its size, without taking lock_.
+  static constexpr size_t kThreadCacheMaxChunkSize = 64 * 1024;
+  static constexpr int kNumThreadCacheBins = 9;  // bins holding chunks of less than 2 * kThreadCacheMaxChunkSize
+  static constexpr size_t kNumThreadCacheShards = 16;
+
+  struct CachedChunk {
+    void* ptr;
+    size_t size;
+  };
+
+  struct ThreadCacheShard {
+    OrtMutex mutex;
+    // freed chunks by bin, oldest first
+    std::array<std::deque<CachedChunk>, kNumThreadCacheBins> free_chunks;
+    size_t cached_bytes = 0;
+    // chunk size and requested size of the small allocations whose address maps to this shard
+    InlinedHashMap<const void*, std::pair<size_t, size_t>> in_use;
+  };
+
+  ThreadCacheShard& ThreadCacheShardForThread();
+  ThreadCacheShard& ThreadCacheShardForAddress(const void* p);
+  void* AllocateSmall(size_t num_bytes);
+  // Returns false if p was not allocated by AllocateSmall.
+  bool FreeSmall(void* p);
+  // Remove chunks from the shard until it holds at most max_bytes, oldest first.
+  void EvictFromThreadCache(ThreadCacheShard& shard, size_t max_bytes, std::vector<void*>& evicted);
+  void ReturnToBins(const std::vector<void*>& chunks);
+  void FlushThreadCaches();
+
   // Structures immutable after construction
   size_t memory_limit_ = 0;
   ArenaExtendStrategy arena_extend_strategy_ = ArenaExtendStrategy::kNextPowerOfTwo;
@@ -514,6 +558,13 @@ class BFCArena : public IAllocator {
   // is to be considered for shrinkage or not.
   bool consider_first_allocation_region_for_shrinkage_;
 
+  const size_t thread_cache_max_bytes_;
+  // nullptr if the per-thread caches are disabled
+  std::unique_ptr<ThreadCacheShard[]> thread_cache_shards_;
+  std::atomic<int64_t> thread_cache_hits_{0};
+  std::atomic<int64_t> thread_cache_flushes_{0};
+  std::atomic<int64_t> thread_cache_bytes_{0};
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef ORT_ENABLE_STREAM
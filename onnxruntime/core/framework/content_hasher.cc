@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/content_hasher.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "core/common/cpuid_info.h"
+#include "core/framework/murmurhash3.h"
+#include "core/graph/graph.h"
+#include "onnxruntime_config.h"
+
+namespace onnxruntime {
+
+void ContentHasher::Update(const void* data, size_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  // MurmurHash3 takes an int length, so large buffers are hashed in chunks.
+  constexpr size_t kMaxChunkSize = size_t{1} << 30;
+  do {
+    const size_t chunk_size = std::min(size, kMaxChunkSize);
+    MurmurHash3::x86_128(bytes, static_cast<int>(chunk_size), hash_[0], hash_);
+    bytes += chunk_size;
+    size -= chunk_size;
+  } while (size > 0);
+}
+
+void HashNodeAttributes(const Node& node, ContentHasher& hasher) {
+  std::vector<const std::pair<const std::string, ONNX_NAMESPACE::AttributeProto>*> attributes;
+  for (const auto& attribute : node.GetAttributes()) {
+    attributes.push_back(&attribute);
+  }
+  std::sort(attributes.begin(), attributes.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+  for (const auto* attribute : attributes) {
+    hasher.Update(attribute->first);
+    const auto type = attribute->second.type();
+    hasher.UpdateValue(static_cast<int32_t>(type));
+    if (type != ONNX_NAMESPACE::AttributeProto_AttributeType_GRAPH &&
+        type != ONNX_NAMESPACE::AttributeProto_AttributeType_GRAPHS) {
+      hasher.Update(attribute->second.SerializeAsString());
+    }
+  }
+}
+
+uint64_t GetCpuEnvironmentHash() {
+  const auto& cpu_info = CPUIDInfo::GetCPUIDInfo();
+  const bool features[] = {
+      cpu_info.HasSSE3(), cpu_info.HasSSE4_1(), cpu_info.HasAVX(), cpu_info.HasAVX2(), cpu_info.HasF16C(),
+      cpu_info.HasAVX512f(), cpu_info.HasAVX512Skylake(), cpu_info.HasAVX512_BF16(), cpu_info.HasAMX_BF16(),
+      cpu_info.HasArmNeonDot(), cpu_info.HasArmNeon_I8MM(), cpu_info.HasArmSVE_I8MM(), cpu_info.HasArmNeon_BF16(),
+      cpu_info.HasFp16VectorAcceleration()};
+
+  ContentHasher hasher;
+  hasher.Update(std::string(ORT_VERSION));
+  hasher.UpdateValue(sizeof(void*));
+  for (bool feature : features) {
+    hasher.UpdateValue(feature);
+  }
+  return hasher.Value();
+}
+
+}  // namespace onnxruntime
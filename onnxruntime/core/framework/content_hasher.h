@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace onnxruntime {
+
+class Node;
+
+// Incremental MurmurHash3 x86_128 hash of a byte stream, truncated to 64 bits.
+// Used to key the files that persist the results of session initialization across processes.
+class ContentHasher {
+ public:
+  void Update(const void* data, size_t size);
+
+  void Update(const std::string& str) {
+    const uint64_t size = str.size();
+    Update(&size, sizeof(size));
+    Update(str.data(), str.size());
+  }
+
+  template <typename T>
+  void UpdateValue(T value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    Update(&value, sizeof(value));
+  }
+
+  uint64_t Value() const { return static_cast<uint64_t>(hash_[0]) | (static_cast<uint64_t>(hash_[1]) << 32); }
+
+ private:
+  uint32_t hash_[4] = {0, 0, 0, 0};
+};
+
+// Adds the attributes of the node to the hash in name order. Subgraph attributes only contribute their name, as
+// subgraphs are hashed through their own nodes.
+void HashNodeAttributes(const Node& node, ContentHasher& hasher);
+
+// Hash of the ONNX Runtime version and of the CPU features that select the MLAS kernels and the optimizations.
+uint64_t GetCpuEnvironmentHash();
+
+}  // namespace onnxruntime
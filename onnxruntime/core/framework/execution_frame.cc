@@ -406,85 +406,91 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 
     // if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, inferred_shapes_);
+      mem_pattern_entry_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs);
       // if no existing patterns, generate one in this execution frame
-      if (!mem_patterns_) {
+      if (!mem_pattern_entry_) {
         planner_.emplace(*session_state.GetExecutionPlan());
       } else {
-        // pre-allocate the big chunk requested in memory pattern.
-        // all the internal kernel's input/output tensors will be allocated on these buffer.
-        buffers_.reserve(mem_patterns_->locations.size());
-        for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
-          const auto& location = mem_patterns_->locations[i];
-          ORT_ENFORCE(buffers_.find(location) == buffers_.end());
-          if (mem_patterns_->patterns[i].PeakSize() > 0) {
-            AllocatorPtr alloc = GetAllocator(location);
-            void* buffer = nullptr;
-            // it's possible we can't allocate the large block. if we have memory patterns we know we have successfully
-            // executed once before, so if there's an arena involved it probably has smaller blocks available.
-            // due to that we can still run and use those blocks (inside the arena logic) instead of one large one.
-            // it's less efficient (the arena will add some overhead to coalesce individual allocations
-            // back into blocks on 'free'), but better than failing completely.
-            ORT_TRY {
-              auto peak_size = mem_patterns_->patterns[i].PeakSize();
-              // Planning of one memory type should only happen once.
+        mem_patterns_ = &mem_pattern_entry_->MemPatterns();
+        inferred_shapes_ = &mem_pattern_entry_->InferredShapes();
+        // reuse the big chunks of a previous run with the same input shapes if the cache retains them.
+        if (!mem_pattern_entry_->AcquireBuffers(buffers_)) {
+          // pre-allocate the big chunk requested in memory pattern.
+          // all the internal kernel's input/output tensors will be allocated on these buffer.
+          buffers_.reserve(mem_patterns_->locations.size());
+          for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
+            const auto& location = mem_patterns_->locations[i];
+            ORT_ENFORCE(buffers_.find(location) == buffers_.end());
+            if (mem_patterns_->patterns[i].PeakSize() > 0) {
+              AllocatorPtr alloc = GetAllocator(location);
+              void* buffer = nullptr;
+              // it's possible we can't allocate the large block. if we have memory patterns we know we have successfully
+              // executed once before, so if there's an arena involved it probably has smaller blocks available.
+              // due to that we can still run and use those blocks (inside the arena logic) instead of one large one.
+              // it's less efficient (the arena will add some overhead to coalesce individual allocations
+              // back into blocks on 'free'), but better than failing completely.
+              ORT_TRY {
+                auto peak_size = mem_patterns_->patterns[i].PeakSize();
+                // Planning of one memory type should only happen once.
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
-              ORT_ENFORCE(
-                  static_activation_memory_sizes_in_byte_.find(location.ToString()) ==
-                      static_activation_memory_sizes_in_byte_.end(),
-                  "Memory type ",
-                  location.ToString(),
-                  " should only appear once.");
-              // static_activation_memory_in_bytes_ is max virtual memory size the planner computes.
-              // Memory dynamically allocated when executing kernels is not recorded using this field.
-              static_activation_memory_sizes_in_byte_[location.ToString()] = peak_size;
+                ORT_ENFORCE(
+                    static_activation_memory_sizes_in_byte_.find(location.ToString()) ==
+                        static_activation_memory_sizes_in_byte_.end(),
+                    "Memory type ",
+                    location.ToString(),
+                    " should only appear once.");
+                // static_activation_memory_in_bytes_ is max virtual memory size the planner computes.
+                // Memory dynamically allocated when executing kernels is not recorded using this field.
+                static_activation_memory_sizes_in_byte_[location.ToString()] = peak_size;
 #endif
-              // the memory pattern buffer will leave in the whole execution.
+                // the memory pattern buffer will leave in the whole execution.
 #ifdef ORT_ENABLE_STREAM
-              StreamAwareArena* stream_aware_alloc = AsStreamBasedAllocator(alloc);
-              if (stream_aware_alloc && device_streams_) {
-                Stream* mem_pattern_stream = device_streams_->GetRootStream();
-                buffer = stream_aware_alloc->AllocOnStream(peak_size, mem_pattern_stream, nullptr);
-                for (size_t j = 0; j < device_streams_->NumStreams(); j++) {
-                  stream_aware_alloc->SecureTheChunk(mem_pattern_stream, device_streams_->GetStream(j), nullptr);
+                StreamAwareArena* stream_aware_alloc = AsStreamBasedAllocator(alloc);
+                if (stream_aware_alloc && device_streams_) {
+                  Stream* mem_pattern_stream = device_streams_->GetRootStream();
+                  buffer = stream_aware_alloc->AllocOnStream(peak_size, mem_pattern_stream, nullptr);
+                  buffers_on_stream_ = true;
+                  for (size_t j = 0; j < device_streams_->NumStreams(); j++) {
+                    stream_aware_alloc->SecureTheChunk(mem_pattern_stream, device_streams_->GetStream(j), nullptr);
+                  }
+                } else {
+                  buffer = alloc->Alloc(peak_size);
                 }
-              } else {
-                buffer = alloc->Alloc(peak_size);
-              }
 #else
-              buffer = alloc->Alloc(peak_size);
+                buffer = alloc->Alloc(peak_size);
 #endif
-              // handle allocator that doesn't throw
-              if (buffer == nullptr) {
-                // INFO level as this may fire on every run and there may not be much a user can do
-                LOGS(session_state_.Logger(), INFO) << "Allocation of memory pattern buffer for "
-                                                    << location.ToString() << " returned nullptr";
+                // handle allocator that doesn't throw
+                if (buffer == nullptr) {
+                  // INFO level as this may fire on every run and there may not be much a user can do
+                  LOGS(session_state_.Logger(), INFO) << "Allocation of memory pattern buffer for "
+                                                      << location.ToString() << " returned nullptr";
+                }
+              }
+              ORT_CATCH(const OnnxRuntimeException& ex) {
+                ORT_HANDLE_EXCEPTION([&]() {
+                  LOGS(session_state_.Logger(), INFO) << "Allocation of memory pattern buffer for "
+                                                      << location.ToString() << " failed. Error:" << ex.what();
+                });
               }
-            }
-            ORT_CATCH(const OnnxRuntimeException& ex) {
-              ORT_HANDLE_EXCEPTION([&]() {
-                LOGS(session_state_.Logger(), INFO) << "Allocation of memory pattern buffer for "
-                                                    << location.ToString() << " failed. Error:" << ex.what();
-              });
-            }
 
-            if (buffer != nullptr) {
-              buffers_[location] = BufferUniquePtr(buffer, BufferDeleter(alloc));
-            }
+              if (buffer != nullptr) {
+                buffers_[location] = BufferUniquePtr(buffer, BufferDeleter(alloc));
+              }
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
-            // Record activation memory pattern
-            auto mem_profier_ptr = session_state.GetMemoryProfiler();
-            mem_profier_ptr->GetMemoryInfo().ClearMemoryInfoPerExecution();
-            if (mem_patterns_ && buffer != nullptr) {
-              mem_profier_ptr->GetMemoryInfo().RecordPatternInfo(*mem_patterns_, MemoryInfo::MapType::StaticActivation);
-              mem_profier_ptr->CreateEvents(
-                  "static activations_" + std::to_string(mem_profier_ptr->GetMemoryInfo().GetIteration()),
-                  mem_profier_ptr->GetAndIncreasePid(), MemoryInfo::MapType::StaticActivation, "", 0);
-            }
+              // Record activation memory pattern
+              auto mem_profier_ptr = session_state.GetMemoryProfiler();
+              mem_profier_ptr->GetMemoryInfo().ClearMemoryInfoPerExecution();
+              if (mem_patterns_ && buffer != nullptr) {
+                mem_profier_ptr->GetMemoryInfo().RecordPatternInfo(*mem_patterns_, MemoryInfo::MapType::StaticActivation);
+                mem_profier_ptr->CreateEvents(
+                    "static activations_" + std::to_string(mem_profier_ptr->GetMemoryInfo().GetIteration()),
+                    mem_profier_ptr->GetAndIncreasePid(), MemoryInfo::MapType::StaticActivation, "", 0);
+              }
 #endif
-            // log size of activation. Keep it commented out for now to avoid log flooding.
-            // VLOGS(session_state_.Logger(), 1) << "**** Allocated memory for activations, size: "
-            //                                   << mem_patterns_->patterns[i].PeakSize();
+              // log size of activation. Keep it commented out for now to avoid log flooding.
+              // VLOGS(session_state_.Logger(), 1) << "**** Allocated memory for activations, size: "
+              //                                   << mem_patterns_->patterns[i].PeakSize();
+            }
           }
         }
       }
@@ -492,7 +498,13 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
   }
 }
 
-ExecutionFrame::~ExecutionFrame() = default;
+ExecutionFrame::~ExecutionFrame() {
+  if (mem_pattern_entry_ && !buffers_on_stream_) {
+    // hand the big chunks back so the next run with the same input shapes can use them.
+    // chunks allocated on the streams of this run are freed with the frame.
+    mem_pattern_entry_->ReleaseBuffers(std::move(buffers_));
+  }
+}
 
 Status ExecutionFrame::CopyTensor(const Tensor& src, Tensor& dest) const {
   return session_state_.GetDataTransferMgr().CopyTensor(src, dest);
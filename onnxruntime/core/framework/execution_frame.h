@@ -23,6 +23,7 @@ class DataTransferManager;
 class SessionState;
 class OrtValueNameIdxMap;
 struct MemoryPatternGroup;
+class MemoryPatternCacheEntry;
 class NodeIndexInfo;
 class Stream;
 #ifdef ORT_ENABLE_STREAM
@@ -232,6 +233,8 @@ class ExecutionFrame final : public IExecutionFrame {
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
   const MemoryPatternGroup* mem_patterns_;
+  // Cache entry that owns mem_patterns_ and inferred_shapes_.
+  std::shared_ptr<const MemoryPatternCacheEntry> mem_pattern_entry_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
@@ -239,6 +242,8 @@ class ExecutionFrame final : public IExecutionFrame {
 
   // Big chunks on different locations that will be used by mem_pattern.
   InlinedHashMap<OrtDevice, BufferUniquePtr> buffers_;
+  // True if any of buffers_ was allocated on a stream of this run.
+  bool buffers_on_stream_{false};
 
   // Given the input shapes of the executed graph, ExecutionFrame tries inferring
   // all symbolic shapes. inferred_shapes_[i] is the shape of OrtValue indexed
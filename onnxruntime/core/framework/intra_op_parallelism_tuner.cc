@@ -0,0 +1,267 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/intra_op_parallelism_tuner.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <locale>
+#include <sstream>
+#include <string>
+
+#include "core/framework/content_hasher.h"
+#include "core/framework/op_kernel_context.h"
+#include "core/framework/tensor.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// File layout, one record per line:
+//   magic model_hash environment_hash max_threads
+//   node_index shape_hash num_threads block_size_scale
+constexpr const char* kMagic = "ORTIOPT1";
+
+}  // namespace
+
+IntraOpParallelismTuner::IntraOpParallelismTuner(PathString file_path, uint64_t model_hash, int max_threads)
+    : file_path_(std::move(file_path)), model_hash_(model_hash), max_threads_(max_threads) {}
+
+Status IntraOpParallelismTuner::Load(const logging::Logger& logger) {
+  if (file_path_.empty()) {
+    return Status::OK();
+  }
+
+  std::ifstream stream{std::filesystem::path(file_path_)};
+  if (!stream.is_open()) {
+    LOGS(logger, INFO) << "No intra-op parallelism tuning file at " << PathToUTF8String(file_path_);
+    return Status::OK();
+  }
+  stream.imbue(std::locale::classic());
+
+  std::string magic;
+  uint64_t model_hash = 0;
+  uint64_t environment_hash = 0;
+  int max_threads = 0;
+  if (!(stream >> magic >> model_hash >> environment_hash >> max_threads) || magic != kMagic ||
+      model_hash != model_hash_ || environment_hash != GetCpuEnvironmentHash() || max_threads != max_threads_) {
+    LOGS(logger, INFO) << "Ignoring intra-op parallelism tuning file " << PathToUTF8String(file_path_)
+                       << " written for another model or environment.";
+    return Status::OK();
+  }
+
+  std::unordered_map<uint64_t, Entry> entries;
+  Entry entry;
+  while (stream >> entry.node_index >> entry.shape_hash >> entry.setting.num_threads >>
+         entry.setting.block_size_scale) {
+    if (entry.setting.num_threads < 0 || entry.setting.num_threads > max_threads_ ||
+        !(entry.setting.block_size_scale > 0.0)) {
+      break;
+    }
+    entry.tuned = true;
+    entries[GetKey(entry.node_index, entry.shape_hash)] = entry;
+  }
+
+  if (!stream.eof()) {
+    LOGS(logger, WARNING) << "Ignoring corrupt intra-op parallelism tuning file " << PathToUTF8String(file_path_);
+    return Status::OK();
+  }
+
+  LOGS(logger, INFO) << "Loaded " << entries.size() << " tuned intra-op parallelism settings from "
+                     << PathToUTF8String(file_path_);
+  std::lock_guard<OrtMutex> lock(mutex_);
+  entries_ = std::move(entries);
+  return Status::OK();
+}
+
+Status IntraOpParallelismTuner::Save(const logging::Logger& logger) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (file_path_.empty() || !has_new_settings_) {
+    return Status::OK();
+  }
+
+  // Write to a file of this process and rename it, so that no process reads a partially written file.
+  std::basic_ostringstream<PathChar> temp_path;
+  temp_path << file_path_ << ORT_TSTR(".") << Env::Default().GetSelfPid() << ORT_TSTR(".tmp");
+  const std::filesystem::path temp_file_path(temp_path.str());
+
+  {
+    std::ofstream stream(temp_file_path, std::ios::trunc);
+    ORT_RETURN_IF_NOT(stream.good(), "Failed to create intra-op parallelism tuning file ", temp_file_path.string());
+    stream.imbue(std::locale::classic());
+    stream << kMagic << ' ' << model_hash_ << ' ' << GetCpuEnvironmentHash() << ' ' << max_threads_ << '\n';
+    for (const auto& [key, entry] : entries_) {
+      if (entry.tuned) {
+        stream << entry.node_index << ' ' << entry.shape_hash << ' ' << entry.setting.num_threads << ' '
+               << entry.setting.block_size_scale << '\n';
+      }
+    }
+    ORT_RETURN_IF_NOT(stream.good(), "Failed to write intra-op parallelism tuning file ", temp_file_path.string());
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temp_file_path, std::filesystem::path(file_path_), error);
+  if (error) {
+    LOGS(logger, WARNING) << "Failed to replace intra-op parallelism tuning file " << PathToUTF8String(file_path_)
+                          << ": " << error.message();
+    std::filesystem::remove(temp_file_path, error);
+    return Status::OK();
+  }
+
+  LOGS(logger, INFO) << "Wrote intra-op parallelism tuning file " << PathToUTF8String(file_path_);
+  return Status::OK();
+}
+
+size_t IntraOpParallelismTuner::NumTuned() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return static_cast<size_t>(std::count_if(entries_.begin(), entries_.end(),
+                                           [](const auto& key_entry) { return key_entry.second.tuned; }));
+}
+
+size_t IntraOpParallelismTuner::NumTuning() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return static_cast<size_t>(std::count_if(entries_.begin(), entries_.end(),
+                                           [](const auto& key_entry) { return !key_entry.second.tuned; }));
+}
+
+uint64_t IntraOpParallelismTuner::GetShapeHash(const OpKernelContext& context) {
+  ContentHasher hasher;
+  for (int i = 0, end = context.InputCount(); i < end; ++i) {
+    const OrtValue* value = context.GetInputOrtValue(i);
+    if (value == nullptr || !value->IsTensor()) {
+      hasher.UpdateValue(int64_t{-1});
+      continue;
+    }
+    const auto dims = value->Get<Tensor>().Shape().GetDims();
+    hasher.UpdateValue(dims.size());
+    for (int64_t dim : dims) {
+      hasher.UpdateValue(dim);
+    }
+  }
+  return hasher.Value();
+}
+
+uint64_t IntraOpParallelismTuner::GetKey(NodeIndex node_index, uint64_t shape_hash) {
+  ContentHasher hasher;
+  hasher.UpdateValue(node_index);
+  hasher.UpdateValue(shape_hash);
+  return hasher.Value();
+}
+
+IntraOpParallelismTuner::Setting IntraOpParallelismTuner::Begin(uint64_t key, NodeIndex node_index,
+                                                                uint64_t shape_hash, int& candidate) {
+  candidate = -1;
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    if (entries_.size() >= kMaxEntries) {
+      return Setting{};
+    }
+
+    // all threads first, which is what the kernel uses without tuning, then 1, 2, 4, ... threads
+    Entry entry;
+    entry.node_index = node_index;
+    entry.shape_hash = shape_hash;
+    entry.candidates.push_back({Setting{0, 1.0}, 0.0, 0});
+    for (int num_threads = 1; num_threads < max_threads_; num_threads *= 2) {
+      entry.candidates.push_back({Setting{num_threads, 1.0}, 0.0, 0});
+    }
+    it = entries_.emplace(key, std::move(entry)).first;
+  }
+
+  Entry& entry = it->second;
+  if (entry.tuned) {
+    return entry.setting;
+  }
+  candidate = static_cast<int>(entry.next);
+  return entry.candidates[entry.next].setting;
+}
+
+void IntraOpParallelismTuner::End(uint64_t key, int candidate, double microseconds) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end() || it->second.tuned) {
+    return;
+  }
+
+  Entry& entry = it->second;
+  Candidate& measured = entry.candidates[candidate];
+  measured.best_microseconds = measured.runs == 0 ? microseconds : std::min(measured.best_microseconds, microseconds);
+  ++measured.runs;
+  if (static_cast<size_t>(candidate) != entry.next || measured.runs < kRunsPerCandidate) {
+    return;
+  }
+
+  if (candidate == 0 && measured.best_microseconds < kMinTunedMicroseconds) {
+    entry.candidates.resize(1);
+    Finish(entry);
+    return;
+  }
+
+  if (++entry.next == entry.candidates.size()) {
+    AddBlockSizeCandidates(entry);
+    if (entry.next == entry.candidates.size()) {
+      Finish(entry);
+    }
+  }
+}
+
+void IntraOpParallelismTuner::AddBlockSizeCandidates(Entry& entry) const {
+  // only once, after the thread limits are measured
+  if (std::any_of(entry.candidates.begin(), entry.candidates.end(),
+                  [](const Candidate& candidate) { return candidate.setting.block_size_scale != 1.0; })) {
+    return;
+  }
+
+  const auto best = std::min_element(entry.candidates.begin(), entry.candidates.end(),
+                                     [](const Candidate& a, const Candidate& b) {
+                                       return a.best_microseconds < b.best_microseconds;
+                                     });
+  const int num_threads = best->setting.num_threads;
+  if (num_threads == 1) {
+    // the block size does not matter if the loops run in the calling thread
+    return;
+  }
+  entry.candidates.push_back({Setting{num_threads, 0.25}, 0.0, 0});
+  entry.candidates.push_back({Setting{num_threads, 4.0}, 0.0, 0});
+}
+
+void IntraOpParallelismTuner::Finish(Entry& entry) {
+  const auto best = std::min_element(entry.candidates.begin(), entry.candidates.end(),
+                                     [](const Candidate& a, const Candidate& b) {
+                                       return a.best_microseconds < b.best_microseconds;
+                                     });
+  entry.setting = best->setting;
+  entry.tuned = true;
+  entry.candidates.clear();
+  entry.candidates.shrink_to_fit();
+  has_new_settings_ = true;
+}
+
+IntraOpParallelismTuner::KernelScope::KernelScope(IntraOpParallelismTuner& tuner, NodeIndex node_index,
+                                                  const OpKernelContext& context)
+    : tuner_(tuner) {
+  const uint64_t shape_hash = GetShapeHash(context);
+  key_ = GetKey(node_index, shape_hash);
+  const Setting setting = tuner_.Begin(key_, node_index, shape_hash, candidate_);
+  if (setting.num_threads > 0) {
+    thread_limit_.emplace(setting.num_threads);
+  }
+  if (setting.block_size_scale != 1.0) {
+    block_size_scale_.emplace(setting.block_size_scale);
+  }
+  if (candidate_ >= 0) {
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+IntraOpParallelismTuner::KernelScope::~KernelScope() {
+  if (candidate_ >= 0) {
+    const auto elapsed = std::chrono::steady_clock::now() - start_;
+    tuner_.End(key_, candidate_, std::chrono::duration<double, std::micro>(elapsed).count());
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/common/path_string.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+class OpKernelContext;
+
+// Tunes the intra-op parallelism of the CPU kernels of a session from measured execution times.
+//
+// The kernels split their loops with ThreadPool::TryParallelFor based on a TensorOpCost they estimate themselves,
+// which may be far off for a given shape. For each node and set of input shapes the tuner runs the kernel a few times
+// with each of a number of thread limits, then with the best thread limit and a few scales of the block size that
+// ParallelFor derives from the cost. The fastest setting is used for all later runs with these shapes.
+//
+// The tuned settings can be written to a file and loaded by later sessions of the same model, so only the first
+// session pays for the measurements. The file is ignored if it was written for another model, CPU feature set,
+// ONNX Runtime version or intra-op thread count.
+class IntraOpParallelismTuner final {
+ public:
+  struct Setting {
+    // maximum number of threads including the calling thread. 0 means the whole intra-op thread pool.
+    int num_threads{0};
+    double block_size_scale{1.0};
+  };
+
+  IntraOpParallelismTuner(PathString file_path, uint64_t model_hash, int max_threads);
+
+  // Loads the settings tuned by a previous session. A missing, stale or corrupt file is not an error.
+  Status Load(const logging::Logger& logger);
+
+  // Writes the tuned settings to the file if any setting was tuned since Load().
+  Status Save(const logging::Logger& logger) const;
+
+  // Applies the setting of a node to the parallel loops started by the calling thread while it is alive,
+  // and measures the execution time if the node is being tuned.
+  class KernelScope {
+   public:
+    KernelScope(IntraOpParallelismTuner& tuner, NodeIndex node_index, const OpKernelContext& context);
+    ~KernelScope();
+
+   private:
+    IntraOpParallelismTuner& tuner_;
+    uint64_t key_;
+    // index of the measured candidate, or -1 if the node is not being tuned
+    int candidate_;
+    std::optional<concurrency::ThreadPool::ScopedThreadLimit> thread_limit_;
+    std::optional<concurrency::ThreadPool::ScopedBlockSizeScale> block_size_scale_;
+    std::chrono::steady_clock::time_point start_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelScope);
+  };
+
+  // Number of node and input shape combinations that are tuned, and that are still being tuned.
+  size_t NumTuned() const;
+  size_t NumTuning() const;
+
+  // Returns the setting for the next run of a node with the given key, and the index of the candidate measured by
+  // the run or -1 if the node is tuned. End() records the execution time of the run. KernelScope calls these with the
+  // key of the node and its input shapes.
+  Setting Begin(uint64_t key, NodeIndex node_index, uint64_t shape_hash, int& candidate);
+  void End(uint64_t key, int candidate, double microseconds);
+
+ private:
+  struct Candidate {
+    Setting setting;
+    double best_microseconds;
+    int runs;
+  };
+
+  struct Entry {
+    NodeIndex node_index;
+    uint64_t shape_hash;
+    std::vector<Candidate> candidates;
+    // candidate measured by the next run
+    size_t next{0};
+    // true once 'setting' is the tuned one
+    bool tuned{false};
+    Setting setting;
+  };
+
+  // runs measured for each candidate. the fastest one counts, so that the first run warming up the caches does not.
+  static constexpr int kRunsPerCandidate = 3;
+  // kernels faster than this with all threads are not worth tuning
+  static constexpr double kMinTunedMicroseconds = 20.0;
+  // bounds the memory used for nodes with many different input shapes
+  static constexpr size_t kMaxEntries = 1 << 16;
+
+  static uint64_t GetShapeHash(const OpKernelContext& context);
+  static uint64_t GetKey(NodeIndex node_index, uint64_t shape_hash);
+
+  void AddBlockSizeCandidates(Entry& entry) const;
+  void Finish(Entry& entry);
+
+  const PathString file_path_;
+  const uint64_t model_hash_;
+  const int max_threads_;
+
+  mutable OrtMutex mutex_;
+  std::unordered_map<uint64_t, Entry> entries_;
+  bool has_new_settings_{false};
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IntraOpParallelismTuner);
+};
+
+}  // namespace onnxruntime
@@ -70,6 +70,10 @@ class KernelRegistryManager {
   Status SearchKernelRegistry(const Node& node,
                               /*out*/ const KernelCreateInfo** kernel_create_info) const;
 
+  // Whether the kernel of the node is from a custom kernel registry, e.g. a custom op, instead of the kernel registry
+  // of its execution provider.
+  bool HasCustomKernel(const Node& node) const;
+
   /**
    * Whether this node can be run on this provider
    */
@@ -0,0 +1,178 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include <sstream>
+
+#include "core/common/safeint.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+MemoryPatternCacheEntry::MemoryPatternCacheEntry(MemoryPatternGroup mem_patterns,
+                                                 InlinedHashMap<int, TensorShape> inferred_shapes,
+                                                 bool retain_buffers)
+    : mem_patterns_(std::move(mem_patterns)),
+      inferred_shapes_(std::move(inferred_shapes)),
+      retain_buffers_(retain_buffers) {
+  SafeInt<size_t> planned_bytes = 0;
+  for (const auto& pattern : mem_patterns_.patterns) {
+    planned_bytes += pattern.PeakSize();
+  }
+  planned_bytes_ = planned_bytes;
+}
+
+size_t MemoryPatternCacheEntry::RetainedBytes() const {
+  std::lock_guard<OrtMutex> lock(buffers_lock_);
+  return retained_bytes_;
+}
+
+size_t MemoryPatternCacheEntry::BufferSetBytes(const ActivationBuffers& buffers) const {
+  size_t bytes = 0;
+  for (const auto& buffer : buffers) {
+    const auto* pattern = mem_patterns_.GetPatterns(buffer.first);
+    if (pattern != nullptr && buffer.second != nullptr) {
+      bytes += pattern->PeakSize();
+    }
+  }
+  return bytes;
+}
+
+bool MemoryPatternCacheEntry::AcquireBuffers(ActivationBuffers& buffers) const {
+  std::lock_guard<OrtMutex> lock(buffers_lock_);
+  if (!retain_buffers_ || free_buffers_.empty()) {
+    return false;
+  }
+
+  buffers = std::move(free_buffers_.back());
+  free_buffers_.pop_back();
+  retained_bytes_ -= BufferSetBytes(buffers);
+  return true;
+}
+
+void MemoryPatternCacheEntry::ReleaseBuffers(ActivationBuffers&& buffers) const {
+  {
+    std::lock_guard<OrtMutex> lock(buffers_lock_);
+    if (retain_buffers_ && !buffers.empty()) {
+      retained_bytes_ += BufferSetBytes(buffers);
+      free_buffers_.push_back(std::move(buffers));
+      return;
+    }
+  }
+
+  buffers.clear();
+}
+
+void MemoryPatternCacheEntry::ReleaseRetainedBuffers() const {
+  std::vector<ActivationBuffers> released;
+  {
+    std::lock_guard<OrtMutex> lock(buffers_lock_);
+    retain_buffers_ = false;
+    released.swap(free_buffers_);
+    retained_bytes_ = 0;
+  }
+
+  // the blocks are returned to their allocators outside of the lock
+  released.clear();
+}
+
+MemoryPatternCache::~MemoryPatternCache() {
+  // frames that outlive the cache keep their entry alive, but must not keep the retained blocks alive with it
+  for (const auto& bucket : lru_) {
+    bucket.entry->ReleaseRetainedBuffers();
+  }
+}
+
+MemoryPatternCache::Key MemoryPatternCache::MakeKey(gsl::span<const int> feed_mlvalue_idxs,
+                                                    gsl::span<const OrtValue> tensor_inputs) {
+  Key key;
+  for (size_t i = 0, end = tensor_inputs.size(); i < end; ++i) {
+    const auto dims = tensor_inputs[i].Get<Tensor>().Shape().GetDims();
+    key.push_back(i < feed_mlvalue_idxs.size() ? feed_mlvalue_idxs[i] : -1);
+    key.push_back(static_cast<int64_t>(dims.size()));
+    key.insert(key.end(), dims.begin(), dims.end());
+  }
+  return key;
+}
+
+std::shared_ptr<const MemoryPatternCacheEntry> MemoryPatternCache::Find(gsl::span<const int> feed_mlvalue_idxs,
+                                                                        gsl::span<const OrtValue> tensor_inputs) {
+  const Key key = MakeKey(feed_mlvalue_idxs, tensor_inputs);
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+
+  ++hits_;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->entry;
+}
+
+std::shared_ptr<const MemoryPatternCacheEntry> MemoryPatternCache::Insert(
+    gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> tensor_inputs,
+    MemoryPatternGroup mem_patterns, InlinedHashMap<int, TensorShape> inferred_shapes) {
+  Key key = MakeKey(feed_mlvalue_idxs, tensor_inputs);
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    // Do not replace an existing entry. Runs that started after it was inserted use it.
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->entry;
+  }
+
+  auto entry = std::make_shared<const MemoryPatternCacheEntry>(std::move(mem_patterns), std::move(inferred_shapes),
+                                                               /*retain_buffers*/ max_entries_ > 0);
+  lru_.push_front(Bucket{key, entry});
+  index_.emplace(std::move(key), lru_.begin());
+  EvictLocked();
+  return entry;
+}
+
+void MemoryPatternCache::EvictLocked() {
+  if (max_entries_ == 0) {
+    return;
+  }
+
+  while (lru_.size() > max_entries_) {
+    // runs that are using the entry keep it alive until they finish, and free their blocks when they do
+    lru_.back().entry->ReleaseRetainedBuffers();
+    index_.erase(lru_.back().key);
+    lru_.pop_back();
+    ++evictions_;
+  }
+}
+
+MemoryPatternCacheStats MemoryPatternCache::GetStats() const {
+  MemoryPatternCacheStats stats;
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.evictions = evictions_;
+  stats.buckets.reserve(lru_.size());
+  for (const auto& bucket : lru_) {
+    // decode the OrtValue index, rank and dims of each feed
+    std::ostringstream shapes;
+    for (size_t i = 0, end = bucket.key.size(); i + 1 < end;) {
+      const auto rank = static_cast<size_t>(bucket.key[i + 1]);
+      i += 2;
+      shapes << (shapes.tellp() > 0 ? ",[" : "[");
+      for (size_t d = 0; d < rank; ++d) {
+        shapes << (d > 0 ? "," : "") << bucket.key[i + d];
+      }
+      shapes << "]";
+      i += rank;
+    }
+
+    stats.buckets.push_back({shapes.str(), bucket.entry->PlannedBytes(), bucket.entry->RetainedBytes()});
+  }
+
+  return stats;
+}
+
+}  // namespace onnxruntime
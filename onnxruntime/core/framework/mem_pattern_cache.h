@@ -0,0 +1,148 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/buffer_deleter.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/tensor_shape.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Memory patterns generated for one input-shape signature, i.e. for one "shape bucket".
+ *
+ * Entries are shared with the execution frames that use them so they stay valid if they are evicted from the cache
+ * while a run is in progress.
+ */
+class MemoryPatternCacheEntry {
+ public:
+  using ActivationBuffers = InlinedHashMap<OrtDevice, BufferUniquePtr>;
+
+  MemoryPatternCacheEntry(MemoryPatternGroup mem_patterns, InlinedHashMap<int, TensorShape> inferred_shapes,
+                          bool retain_buffers);
+
+  const MemoryPatternGroup& MemPatterns() const noexcept { return mem_patterns_; }
+
+  // Shapes resolved from the symbolic dimensions of the graph inputs. Only populated in training builds.
+  const InlinedHashMap<int, TensorShape>& InferredShapes() const noexcept { return inferred_shapes_; }
+
+  // Sum of the activation block sizes required by the patterns.
+  size_t PlannedBytes() const noexcept { return planned_bytes_; }
+
+  // Bytes of activation blocks currently held by the entry for reuse by the next run.
+  size_t RetainedBytes() const;
+
+  /**
+   * Take a set of activation blocks released by a previous run with the same input shapes.
+   * @returns false if the entry does not retain blocks or none are available.
+   */
+  bool AcquireBuffers(ActivationBuffers& buffers) const;
+
+  // Hand the activation blocks of a finished run back for reuse. They are freed if the entry does not retain blocks.
+  void ReleaseBuffers(ActivationBuffers&& buffers) const;
+
+  // Free the retained blocks and stop retaining the blocks of runs that are still using the entry.
+  void ReleaseRetainedBuffers() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCacheEntry);
+
+  size_t BufferSetBytes(const ActivationBuffers& buffers) const;
+
+  const MemoryPatternGroup mem_patterns_;
+  const InlinedHashMap<int, TensorShape> inferred_shapes_;
+  size_t planned_bytes_{0};
+
+  mutable OrtMutex buffers_lock_;
+  mutable bool retain_buffers_;
+  mutable std::vector<ActivationBuffers> free_buffers_;
+  mutable size_t retained_bytes_{0};
+};
+
+struct MemoryPatternCacheStats {
+  struct Bucket {
+    // Input shapes of the bucket, e.g. "[1,128],[1,128]".
+    std::string shapes;
+    size_t planned_bytes;
+    size_t retained_bytes;
+  };
+
+  size_t hits{0};
+  size_t misses{0};
+  size_t evictions{0};
+  // Buckets in most recently used first order.
+  std::vector<Bucket> buckets;
+};
+
+/**
+ * Cache of memory patterns keyed by the shapes of the feeds.
+ *
+ * If max_entries is 0 the cache is unbounded and activation blocks are freed at the end of each run. Otherwise the
+ * least recently used bucket is evicted once there are more than max_entries buckets, and each bucket retains the
+ * activation blocks of finished runs so repeated runs with the same input shapes do not need to allocate them again.
+ */
+class MemoryPatternCache {
+ public:
+  explicit MemoryPatternCache(size_t max_entries = 0) : max_entries_(max_entries) {}
+  ~MemoryPatternCache();
+
+  size_t MaxEntries() const noexcept { return max_entries_; }
+
+  // Look up the patterns for the feeds. Counts a hit or a miss.
+  std::shared_ptr<const MemoryPatternCacheEntry> Find(gsl::span<const int> feed_mlvalue_idxs,
+                                                      gsl::span<const OrtValue> tensor_inputs);
+
+  /**
+   * Add the patterns for the feeds.
+   * If an entry for the feeds is already present it is kept and returned, as it may be in use by other runs.
+   */
+  std::shared_ptr<const MemoryPatternCacheEntry> Insert(gsl::span<const int> feed_mlvalue_idxs,
+                                                        gsl::span<const OrtValue> tensor_inputs,
+                                                        MemoryPatternGroup mem_patterns,
+                                                        InlinedHashMap<int, TensorShape> inferred_shapes);
+
+  MemoryPatternCacheStats GetStats() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCache);
+
+  // OrtValue index, rank and dims of each feed.
+  using Key = InlinedVector<int64_t>;
+
+  struct Bucket {
+    Key key;
+    std::shared_ptr<const MemoryPatternCacheEntry> entry;
+  };
+
+  using LruList = std::list<Bucket>;
+
+  static Key MakeKey(gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> tensor_inputs);
+  void EvictLocked();
+
+  const size_t max_entries_;
+
+  mutable OrtMutex lock_;
+  // most recently used bucket first
+  LruList lru_;
+#ifndef DISABLE_ABSEIL
+  InlinedHashMap<Key, LruList::iterator> index_;
+#else
+  std::map<Key, LruList::iterator> index_;
+#endif
+  size_t hits_{0};
+  size_t misses_{0};
+  size_t evictions_{0};
+};
+
+}  // namespace onnxruntime
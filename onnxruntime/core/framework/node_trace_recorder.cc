@@ -0,0 +1,309 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/node_trace_recorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iterator>
+#include <locale>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+namespace profiling {
+
+// Ring buffer written by a single thread and read by any thread without a lock.
+//
+// The writer announces the event it is about to overwrite a slot with in 'started_', so a reader can tell which of
+// the events it copied may have been overwritten while it was copying them, like a sequence lock.
+struct NodeTraceRingBuffer {
+  struct Slot {
+    std::atomic<uint64_t> node_index{0};
+    std::atomic<uint64_t> start_ns{0};
+    std::atomic<uint64_t> duration_ns{0};
+    std::atomic<uint64_t> output_bytes{0};
+    std::atomic<uint64_t> thread_pool_wait_ns{0};
+  };
+
+  void Write(const NodeTraceEvent& event) {
+    const uint64_t index = written_.load(std::memory_order_relaxed);
+    started_.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Slot& slot = slots_[index % NodeTraceRecorder::kEventsPerThread];
+    slot.node_index.store(static_cast<uint64_t>(event.node_index), std::memory_order_relaxed);
+    slot.start_ns.store(event.start_ns, std::memory_order_relaxed);
+    slot.duration_ns.store(event.duration_ns, std::memory_order_relaxed);
+    slot.output_bytes.store(event.output_bytes, std::memory_order_relaxed);
+    slot.thread_pool_wait_ns.store(event.thread_pool_wait_ns, std::memory_order_relaxed);
+
+    written_.store(index + 1, std::memory_order_release);
+  }
+
+  void Read(std::vector<NodeTraceEvent>& events) const {
+    constexpr uint64_t capacity = NodeTraceRecorder::kEventsPerThread;
+    const uint64_t end = written_.load(std::memory_order_acquire);
+    const uint64_t begin = end > capacity ? end - capacity : 0;
+
+    const size_t first_event = events.size();
+    for (uint64_t index = begin; index < end; ++index) {
+      const Slot& slot = slots_[index % capacity];
+      NodeTraceEvent event;
+      event.node_index = static_cast<NodeIndex>(slot.node_index.load(std::memory_order_relaxed));
+      event.start_ns = slot.start_ns.load(std::memory_order_relaxed);
+      event.duration_ns = slot.duration_ns.load(std::memory_order_relaxed);
+      event.output_bytes = slot.output_bytes.load(std::memory_order_relaxed);
+      event.thread_pool_wait_ns = slot.thread_pool_wait_ns.load(std::memory_order_relaxed);
+      events.push_back(event);
+    }
+
+    // drop the events whose slot the writer started to overwrite in the meantime
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t started = started_.load(std::memory_order_relaxed);
+    const uint64_t first_valid = started > capacity ? started - capacity : 0;
+    if (first_valid > begin) {
+      const auto num_invalid = static_cast<size_t>(std::min(first_valid, end) - begin);
+      events.erase(events.begin() + first_event, events.begin() + first_event + num_invalid);
+    }
+  }
+
+ private:
+  std::unique_ptr<Slot[]> slots_{new Slot[NodeTraceRecorder::kEventsPerThread]};
+  // number of events written, and number of events the writer started to write
+  std::atomic<uint64_t> written_{0};
+  std::atomic<uint64_t> started_{0};
+};
+
+namespace {
+
+std::atomic<uint64_t> next_recorder_id{1};
+
+struct ThreadState {
+  // buffer of the recorder used last by the thread
+  uint64_t recorder_id{0};
+  NodeTraceRingBuffer* buffer{nullptr};
+  // kernel runs until the next sampled one
+  uint32_t countdown{0};
+};
+
+thread_local ThreadState thread_state;
+
+uint64_t ToNanoseconds(std::chrono::steady_clock::duration duration) {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+// nearest-rank percentile of sorted values
+double Percentile(const std::vector<double>& sorted_values, double percentile) {
+  const auto rank = static_cast<size_t>(std::ceil(percentile * static_cast<double>(sorted_values.size())));
+  return sorted_values[std::clamp<size_t>(rank, 1, sorted_values.size()) - 1];
+}
+
+struct Accumulator {
+  std::vector<double> durations_us;
+  double total_output_bytes{0};
+  double total_thread_pool_wait_us{0};
+
+  void Add(const NodeTraceEvent& event) {
+    durations_us.push_back(static_cast<double>(event.duration_ns) / 1000.0);
+    total_output_bytes += static_cast<double>(event.output_bytes);
+    total_thread_pool_wait_us += static_cast<double>(event.thread_pool_wait_ns) / 1000.0;
+  }
+
+  NodeTraceRecorder::Stats ToStats(std::string name, std::string op_type) {
+    NodeTraceRecorder::Stats stats;
+    stats.name = std::move(name);
+    stats.op_type = std::move(op_type);
+    stats.count = durations_us.size();
+    std::sort(durations_us.begin(), durations_us.end());
+    stats.p50_us = Percentile(durations_us, 0.50);
+    stats.p99_us = Percentile(durations_us, 0.99);
+    const auto count = static_cast<double>(stats.count);
+    double total_us = 0;
+    for (double duration_us : durations_us) {
+      total_us += duration_us;
+    }
+    stats.mean_us = total_us / count;
+    stats.mean_output_bytes = total_output_bytes / count;
+    stats.mean_thread_pool_wait_us = total_thread_pool_wait_us / count;
+    return stats;
+  }
+};
+
+void WriteJsonString(std::ostream& out, const std::string& value) {
+  out << '"';
+  for (const char c : value) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+void SortByTotalTime(std::vector<NodeTraceRecorder::Stats>& stats) {
+  std::sort(stats.begin(), stats.end(), [](const NodeTraceRecorder::Stats& a, const NodeTraceRecorder::Stats& b) {
+    return a.mean_us * static_cast<double>(a.count) > b.mean_us * static_cast<double>(b.count);
+  });
+}
+
+}  // namespace
+
+NodeTraceRecorder::NodeTraceRecorder(const GraphViewer& graph_viewer, uint32_t sample_interval)
+    : id_(next_recorder_id++), sample_interval_(std::max<uint32_t>(sample_interval, 1)) {
+  node_names_.resize(graph_viewer.MaxNodeIndex());
+  op_types_.resize(graph_viewer.MaxNodeIndex());
+  for (const auto& node : graph_viewer.Nodes()) {
+    node_names_[node.Index()] = node.Name();
+    op_types_[node.Index()] = node.OpType();
+  }
+}
+
+NodeTraceRecorder::~NodeTraceRecorder() = default;
+
+bool NodeTraceRecorder::ShouldSample() {
+  if (thread_state.countdown == 0) {
+    thread_state.countdown = sample_interval_ - 1;
+    return true;
+  }
+  --thread_state.countdown;
+  return false;
+}
+
+NodeTraceRingBuffer& NodeTraceRecorder::GetThreadBuffer() {
+  if (thread_state.recorder_id != id_) {
+    // a thread may run several sessions, so look up the buffer it used before with this recorder. The buffers of the
+    // recorders destroyed since are dropped here, so the map only grows with the number of live sessions.
+    static thread_local std::unordered_map<uint64_t, std::weak_ptr<NodeTraceRingBuffer>> buffer_by_recorder;
+    for (auto it = buffer_by_recorder.begin(); it != buffer_by_recorder.end();) {
+      it = it->second.expired() ? buffer_by_recorder.erase(it) : std::next(it);
+    }
+
+    std::shared_ptr<NodeTraceRingBuffer> buffer;
+    auto it = buffer_by_recorder.find(id_);
+    if (it == buffer_by_recorder.end()) {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      buffer = buffers_.emplace_back(std::make_shared<NodeTraceRingBuffer>());
+      buffer_by_recorder.emplace(id_, buffer);
+    } else {
+      buffer = it->second.lock();
+    }
+    thread_state.recorder_id = id_;
+    thread_state.buffer = buffer.get();
+  }
+  return *thread_state.buffer;
+}
+
+void NodeTraceRecorder::Record(const NodeTraceEvent& event) {
+  GetThreadBuffer().Write(event);
+}
+
+NodeTraceRecorder::Snapshot NodeTraceRecorder::GetSnapshot() const {
+  std::vector<NodeTraceEvent> events;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    events.reserve(buffers_.size() * kEventsPerThread);
+    for (const auto& buffer : buffers_) {
+      buffer->Read(events);
+    }
+  }
+
+  std::map<NodeIndex, Accumulator> by_node;
+  std::map<std::string, Accumulator> by_op_type;
+  for (const auto& event : events) {
+    if (event.node_index >= op_types_.size()) {
+      continue;
+    }
+    by_node[event.node_index].Add(event);
+    by_op_type[op_types_[event.node_index]].Add(event);
+  }
+
+  Snapshot snapshot;
+  snapshot.nodes.reserve(by_node.size());
+  for (auto& [node_index, accumulator] : by_node) {
+    snapshot.nodes.push_back(accumulator.ToStats(node_names_[node_index], op_types_[node_index]));
+  }
+  snapshot.op_types.reserve(by_op_type.size());
+  for (auto& [op_type, accumulator] : by_op_type) {
+    snapshot.op_types.push_back(accumulator.ToStats("", op_type));
+  }
+  SortByTotalTime(snapshot.nodes);
+  SortByTotalTime(snapshot.op_types);
+  return snapshot;
+}
+
+std::string NodeTraceRecorder::ToJson(const Snapshot& snapshot) {
+  // written by hand like the profiler output, as the framework does not depend on a JSON library in all builds
+  std::ostringstream out;
+  out.imbue(std::locale::classic());
+  auto write_stats = [&out](const char* key, const std::vector<Stats>& stats, bool with_name) {
+    out << '"' << key << "\":[";
+    for (size_t i = 0; i < stats.size(); ++i) {
+      const Stats& entry = stats[i];
+      out << (i == 0 ? "{" : ",{");
+      if (with_name) {
+        out << "\"name\":";
+        WriteJsonString(out, entry.name);
+        out << ',';
+      }
+      out << "\"op_type\":";
+      WriteJsonString(out, entry.op_type);
+      out << ",\"count\":" << entry.count
+          << ",\"p50_us\":" << entry.p50_us
+          << ",\"p99_us\":" << entry.p99_us
+          << ",\"mean_us\":" << entry.mean_us
+          << ",\"mean_output_bytes\":" << entry.mean_output_bytes
+          << ",\"mean_thread_pool_wait_us\":" << entry.mean_thread_pool_wait_us << '}';
+    }
+    out << ']';
+  };
+
+  out << '{';
+  write_stats("nodes", snapshot.nodes, true);
+  out << ',';
+  write_stats("op_types", snapshot.op_types, false);
+  out << '}';
+  return out.str();
+}
+
+NodeTraceRecorder::KernelScope::KernelScope(NodeTraceRecorder& recorder, NodeIndex node_index,
+                                            OpKernelContextInternal& context)
+    : recorder_(recorder), node_index_(node_index), context_(context), sampled_(recorder.ShouldSample()) {
+  if (sampled_) {
+    wait_time_counter_.emplace();
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+NodeTraceRecorder::KernelScope::~KernelScope() {
+  if (!sampled_) {
+    return;
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+  NodeTraceEvent event;
+  event.node_index = node_index_;
+  event.start_ns = ToNanoseconds(start_.time_since_epoch());
+  event.duration_ns = ToNanoseconds(end - start_);
+  event.output_bytes = 0;
+  for (int i = 0, num_outputs = context_.OutputCount(); i < num_outputs; ++i) {
+    const OrtValue* output = context_.GetOutputMLValue(i);
+    if (output != nullptr && output->IsTensor()) {
+      event.output_bytes += output->Get<Tensor>().SizeInBytes();
+    }
+  }
+  event.thread_pool_wait_ns = wait_time_counter_->WaitNanoseconds();
+  recorder_.Record(event);
+}
+
+}  // namespace profiling
+}  // namespace onnxruntime
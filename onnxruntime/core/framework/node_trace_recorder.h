@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+class OpKernelContextInternal;
+
+namespace profiling {
+
+struct NodeTraceEvent {
+  NodeIndex node_index;
+  // steady clock time the kernel started
+  uint64_t start_ns;
+  uint64_t duration_ns;
+  // bytes of the output tensors of the kernel
+  uint64_t output_bytes;
+  // time the kernel spent waiting for the intra-op threads, see ThreadPool::ScopedWaitTimeCounter
+  uint64_t thread_pool_wait_ns;
+};
+
+struct NodeTraceRingBuffer;
+
+/**
+ * Low overhead recorder of the kernel runs of a session, meant to stay enabled in production.
+ *
+ * Unlike the Profiler, which collects a JSON event per kernel run in a vector under a lock, the recorder writes a
+ * sampled fixed size event to a ring buffer of the running thread without taking a lock. The buffers keep the last
+ * events of each thread, and GetSnapshot() aggregates them into latency percentiles per node and per op type on
+ * demand.
+ *
+ * Only the nodes of the main graph are recorded. The events of a control flow node include its subgraphs.
+ */
+class NodeTraceRecorder {
+ public:
+  // Number of events kept per thread
+  static constexpr size_t kEventsPerThread = 4096;
+
+  // Records one in sample_interval kernel runs of each thread.
+  NodeTraceRecorder(const GraphViewer& graph_viewer, uint32_t sample_interval);
+  ~NodeTraceRecorder();
+
+  // Records the run of a kernel if it is sampled.
+  class KernelScope {
+   public:
+    KernelScope(NodeTraceRecorder& recorder, NodeIndex node_index, OpKernelContextInternal& context);
+    ~KernelScope();
+
+   private:
+    NodeTraceRecorder& recorder_;
+    const NodeIndex node_index_;
+    OpKernelContextInternal& context_;
+    bool sampled_;
+    std::optional<concurrency::ThreadPool::ScopedWaitTimeCounter> wait_time_counter_;
+    std::chrono::steady_clock::time_point start_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelScope);
+  };
+
+  // Adds the event to the ring buffer of the calling thread.
+  void Record(const NodeTraceEvent& event);
+
+  struct Stats {
+    // node name, or empty for the stats of an op type
+    std::string name;
+    std::string op_type;
+    size_t count{0};
+    double p50_us{0};
+    double p99_us{0};
+    double mean_us{0};
+    double mean_output_bytes{0};
+    double mean_thread_pool_wait_us{0};
+  };
+
+  struct Snapshot {
+    // ordered by the total time of the recorded runs, descending
+    std::vector<Stats> nodes;
+    std::vector<Stats> op_types;
+  };
+
+  // Aggregates the events currently in the ring buffers. Can be called while the session runs.
+  Snapshot GetSnapshot() const;
+
+  // Returns the snapshot as a JSON object with "nodes" and "op_types" arrays.
+  static std::string ToJson(const Snapshot& snapshot);
+
+ private:
+  bool ShouldSample();
+  NodeTraceRingBuffer& GetThreadBuffer();
+
+  // unique in the process, so that the buffer cached by a thread for a destroyed recorder is never used
+  const uint64_t id_;
+  const uint32_t sample_interval_;
+  std::vector<std::string> node_names_;
+  std::vector<std::string> op_types_;
+
+  mutable OrtMutex mutex_;
+  // shared with weak references in the threads, which drop their entries of the destroyed recorders
+  std::vector<std::shared_ptr<NodeTraceRingBuffer>> buffers_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NodeTraceRecorder);
+};
+
+}  // namespace profiling
+}  // namespace onnxruntime
@@ -0,0 +1,328 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_file_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <type_traits>
+
+#include "core/framework/content_hasher.h"
+#include "core/framework/tensor.h"
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// File layout:
+//   FileHeader
+//   pre-packed buffers, each aligned to kBufferAlignment
+//   index: uint32 number of entries, then for each entry:
+//     uint32 key size, key, uint64 weight hash, int32 weight element type, uint64 weight size in bytes,
+//     uint32 weight rank, int64 dims, uint32 number of buffers, then for each buffer:
+//       uint64 offset, uint64 size
+struct FileHeader {
+  char magic[8];
+  uint64_t model_hash;
+  uint64_t environment_hash;
+  uint64_t index_offset;
+  uint64_t index_size;
+};
+
+constexpr char kMagic[8] = {'O', 'R', 'T', 'P', 'P', 'W', 'C', '2'};
+constexpr size_t kBufferAlignment = 64;
+
+void HashGraph(const Graph& graph, ContentHasher& hasher) {
+  for (const auto& node : graph.Nodes()) {
+    hasher.Update(node.Domain());
+    hasher.Update(node.OpType());
+    hasher.Update(node.Name());
+    hasher.UpdateValue(node.SinceVersion());
+    HashNodeAttributes(node, hasher);
+    for (const auto& subgraph : node.GetSubgraphs()) {
+      HashGraph(*subgraph, hasher);
+    }
+  }
+}
+
+template <typename T>
+bool Read(const char*& data, const char* end, T& value) {
+  if (static_cast<size_t>(end - data) < sizeof(T)) {
+    return false;
+  }
+  memcpy(&value, data, sizeof(T));
+  data += sizeof(T);
+  return true;
+}
+
+template <typename T>
+void Write(std::ostream& stream, T value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+}  // namespace
+
+PrepackedWeightsFileCache::PrepackedWeightsFileCache(PathString file_path, uint64_t model_hash)
+    : file_path_(std::move(file_path)), model_hash_(model_hash) {}
+
+Status PrepackedWeightsFileCache::Load(const logging::Logger& logger) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  const auto& env = Env::Default();
+  size_t file_size = 0;
+  if (!env.GetFileLength(file_path_.c_str(), file_size).IsOK() || file_size < sizeof(FileHeader)) {
+    LOGS(logger, INFO) << "No pre-packed weights cache file at " << PathToUTF8String(file_path_);
+    return Status::OK();
+  }
+
+  Env::MappedMemoryPtr mapped_file;
+  ORT_RETURN_IF_ERROR(env.MapFileIntoMemory(file_path_.c_str(), 0, file_size, mapped_file));
+  const char* file_data = mapped_file.get();
+
+  FileHeader header;
+  memcpy(&header, file_data, sizeof(header));
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.model_hash != model_hash_ ||
+      header.environment_hash != GetCpuEnvironmentHash()) {
+    LOGS(logger, INFO) << "Ignoring pre-packed weights cache file " << PathToUTF8String(file_path_)
+                       << " written for another model or environment.";
+    return Status::OK();
+  }
+
+  std::unordered_map<std::string, Entry> entries;
+  bool is_valid = header.index_offset <= file_size && header.index_size <= file_size - header.index_offset;
+  if (is_valid) {
+    const char* data = file_data + header.index_offset;
+    const char* end = data + header.index_size;
+    uint32_t num_entries = 0;
+    is_valid = Read(data, end, num_entries);
+    for (uint32_t i = 0; is_valid && i < num_entries; ++i) {
+      uint32_t key_size = 0;
+      Entry entry{{}, {}, false};
+      uint32_t rank = 0;
+      uint32_t num_buffers = 0;
+      is_valid = Read(data, end, key_size) && static_cast<size_t>(end - data) >= key_size;
+      if (!is_valid) {
+        break;
+      }
+      std::string key(data, key_size);
+      data += key_size;
+      is_valid = Read(data, end, entry.weight.hash) && Read(data, end, entry.weight.elem_type) &&
+                 Read(data, end, entry.weight.size_in_bytes) && Read(data, end, rank);
+      for (uint32_t j = 0; is_valid && j < rank; ++j) {
+        int64_t dim = 0;
+        is_valid = Read(data, end, dim);
+        entry.weight.shape.push_back(dim);
+      }
+      is_valid = is_valid && Read(data, end, num_buffers);
+      for (uint32_t j = 0; is_valid && j < num_buffers; ++j) {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        is_valid = Read(data, end, offset) && Read(data, end, size) &&
+                   offset <= header.index_offset && size <= header.index_offset - offset;
+        if (is_valid) {
+          entry.buffers.emplace_back(size == 0 ? nullptr : file_data + offset, static_cast<size_t>(size));
+        }
+      }
+      if (is_valid) {
+        entries.emplace(std::move(key), std::move(entry));
+      }
+    }
+  }
+
+  if (!is_valid) {
+    LOGS(logger, WARNING) << "Ignoring corrupt pre-packed weights cache file " << PathToUTF8String(file_path_);
+    return Status::OK();
+  }
+
+  LOGS(logger, INFO) << "Mapped " << entries.size() << " pre-packed weights from " << PathToUTF8String(file_path_);
+  entries_ = std::move(entries);
+  mapped_file_ = std::move(mapped_file);
+  return Status::OK();
+}
+
+bool PrepackedWeightsFileCache::Find(const std::string& key, const WeightSignature& weight,
+                                     std::vector<BufferUniquePtr>& prepacked_buffers,
+                                     std::vector<size_t>& prepacked_buffer_sizes) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end() || it->second.weight != weight || it->second.buffers.empty()) {
+    return false;
+  }
+
+  prepacked_buffers.clear();
+  prepacked_buffer_sizes.clear();
+  for (const auto& buffer : it->second.buffers) {
+    // BufferDeleter is nullptr because the buffers belong to the cache
+    prepacked_buffers.emplace_back(const_cast<void*>(buffer.first), BufferDeleter(nullptr));
+    prepacked_buffer_sizes.push_back(buffer.second);
+  }
+
+  if (!it->second.used) {
+    it->second.used = true;
+    if (mapped_file_ != nullptr) {
+      for (const auto& buffer : it->second.buffers) {
+        mapped_bytes_ += buffer.second;
+      }
+    }
+  }
+  return true;
+}
+
+void PrepackedWeightsFileCache::AddEntry(const std::string& key, const WeightSignature& weight,
+                                         const PrePackedWeights& prepacked_weights) {
+  // Kernels that cannot restore their pre-packed weights from the cache pack them again on every load. The file
+  // already holds the weight in that case, so keep the entry instead of rewriting the file.
+  auto it = entries_.find(key);
+  if (it != entries_.end() && it->second.weight == weight &&
+      it->second.buffers.size() == prepacked_weights.buffer_sizes_.size() &&
+      std::equal(it->second.buffers.begin(), it->second.buffers.end(), prepacked_weights.buffer_sizes_.begin(),
+                 [](const std::pair<const void*, size_t>& buffer, size_t size) { return buffer.second == size; })) {
+    it->second.used = true;
+    return;
+  }
+
+  Entry entry{weight, {}, true};
+  for (size_t i = 0; i < prepacked_weights.buffers_.size(); ++i) {
+    entry.buffers.emplace_back(prepacked_weights.buffers_[i].get(), prepacked_weights.buffer_sizes_[i]);
+  }
+  entries_[key] = std::move(entry);
+  has_new_entries_ = true;
+}
+
+void PrepackedWeightsFileCache::Add(const std::string& key, const WeightSignature& weight,
+                                    const PrePackedWeights& prepacked_weights) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  AddEntry(key, weight, prepacked_weights);
+}
+
+const PrePackedWeights& PrepackedWeightsFileCache::Add(const std::string& key, const WeightSignature& weight,
+                                                       PrePackedWeights&& prepacked_weights) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  owned_weights_.push_back(std::make_unique<PrePackedWeights>(std::move(prepacked_weights)));
+  AddEntry(key, weight, *owned_weights_.back());
+  return *owned_weights_.back();
+}
+
+Status PrepackedWeightsFileCache::Save(const logging::Logger& logger) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (!has_new_entries_) {
+    return Status::OK();
+  }
+
+  // Write to a file of this process and rename it, so that no process maps a partially written file.
+  std::basic_ostringstream<PathChar> temp_path;
+  temp_path << file_path_ << ORT_TSTR(".") << Env::Default().GetSelfPid() << ORT_TSTR(".tmp");
+  const std::filesystem::path temp_file_path(temp_path.str());
+
+  {
+    std::ofstream stream(temp_file_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(stream.good(), "Failed to create pre-packed weights cache file ", temp_file_path.string());
+
+    FileHeader header{};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.model_hash = model_hash_;
+    header.environment_hash = GetCpuEnvironmentHash();
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::ostringstream index;
+    uint64_t offset = sizeof(header);
+    uint32_t num_entries = 0;
+    for (const auto& [key, entry] : entries_) {
+      if (!entry.used) {
+        continue;
+      }
+      ++num_entries;
+      Write(index, static_cast<uint32_t>(key.size()));
+      index.write(key.data(), key.size());
+      Write(index, entry.weight.hash);
+      Write(index, entry.weight.elem_type);
+      Write(index, entry.weight.size_in_bytes);
+      Write(index, static_cast<uint32_t>(entry.weight.shape.size()));
+      for (int64_t dim : entry.weight.shape) {
+        Write(index, dim);
+      }
+      Write(index, static_cast<uint32_t>(entry.buffers.size()));
+      for (const auto& [buffer, size] : entry.buffers) {
+        const uint64_t padding = (kBufferAlignment - offset % kBufferAlignment) % kBufferAlignment;
+        const char zeros[kBufferAlignment] = {};
+        stream.write(zeros, static_cast<std::streamsize>(padding));
+        offset += padding;
+        Write(index, buffer == nullptr ? uint64_t{0} : offset);
+        Write(index, static_cast<uint64_t>(buffer == nullptr ? 0 : size));
+        if (buffer != nullptr) {
+          stream.write(static_cast<const char*>(buffer), static_cast<std::streamsize>(size));
+          offset += size;
+        }
+      }
+    }
+
+    const std::string index_data = index.str();
+    header.index_offset = offset;
+    header.index_size = sizeof(num_entries) + index_data.size();
+    Write(stream, num_entries);
+    stream.write(index_data.data(), static_cast<std::streamsize>(index_data.size()));
+    stream.seekp(0);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ORT_RETURN_IF_NOT(stream.good(), "Failed to write pre-packed weights cache file ", temp_file_path.string());
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temp_file_path, std::filesystem::path(file_path_), error);
+  if (error) {
+    // e.g. the file is mapped by another process on Windows. The next session will try again.
+    LOGS(logger, WARNING) << "Failed to replace pre-packed weights cache file " << PathToUTF8String(file_path_)
+                          << ": " << error.message();
+    std::filesystem::remove(temp_file_path, error);
+    return Status::OK();
+  }
+
+  LOGS(logger, INFO) << "Wrote pre-packed weights cache file " << PathToUTF8String(file_path_);
+  return Status::OK();
+}
+
+std::string PrepackedWeightsFileCache::GetKey(const Node& node, int input_idx, const std::string& weight_name) {
+  std::ostringstream key;
+  key << node.Domain() << ':' << node.OpType() << ':' << node.SinceVersion() << '/'
+      << (node.Name().empty() ? std::to_string(node.Index()) : node.Name()) << '/' << input_idx << '/' << weight_name;
+  return key.str();
+}
+
+PrepackedWeightsFileCache::WeightSignature PrepackedWeightsFileCache::GetWeightSignature(const Node& node,
+                                                                                         const Tensor& weight) {
+  ContentHasher hasher;
+  hasher.UpdateValue(weight.GetElementType());
+  for (int64_t dim : weight.Shape().GetDims()) {
+    hasher.UpdateValue(dim);
+  }
+  hasher.Update(weight.DataRaw(), weight.SizeInBytes());
+  HashNodeAttributes(node, hasher);
+
+  WeightSignature signature;
+  signature.hash = hasher.Value();
+  signature.elem_type = weight.GetElementType();
+  signature.size_in_bytes = weight.SizeInBytes();
+  const auto dims = weight.Shape().GetDims();
+  signature.shape.assign(dims.begin(), dims.end());
+  return signature;
+}
+
+uint64_t PrepackedWeightsFileCache::GetModelHash(const Graph& graph) {
+  std::vector<std::string> initializer_names;
+  for (const auto& [name, initializer] : graph.GetAllInitializedTensors()) {
+    initializer_names.push_back(name);
+  }
+  std::sort(initializer_names.begin(), initializer_names.end());
+
+  ContentHasher hasher;
+  HashGraph(graph, hasher);
+  for (const auto& name : initializer_names) {
+    hasher.Update(name);
+  }
+  return hasher.Value();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/common/path_string.h"
+#include "core/framework/buffer_deleter.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/platform/env.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class Graph;
+class Node;
+class Tensor;
+
+// Persistent cache of the pre-packed weights of the CPU kernels of a session.
+//
+// The PrePack() output of the kernels is written to a file when the session is initialized, and later sessions of
+// the same model, possibly in other processes, memory-map the file and hand the buffers to the kernels with
+// OpKernel::UseCachedPrePackedBuffers() instead of packing the weights again. As the file is mapped, the packed weights
+// of all processes using it share the page cache.
+//
+// An entry is keyed by the kernel type, the node, the input index and the weight name, and it is only used if the
+// signature of the weight matches: the hash of the weight content and the node attributes, and the element type, shape
+// and byte size of the weight. The whole file is ignored if it was written for another model, CPU feature set or ONNX
+// Runtime version.
+class PrepackedWeightsFileCache final {
+ public:
+  // The hash alone is only 64 bits, so the element type, shape and size must match as well before the buffers of an
+  // entry are handed to a kernel that reads them with the layout of the weight.
+  struct WeightSignature {
+    uint64_t hash{0};
+    int32_t elem_type{0};
+    uint64_t size_in_bytes{0};
+    std::vector<int64_t> shape;
+
+    bool operator==(const WeightSignature& other) const {
+      return hash == other.hash && elem_type == other.elem_type && size_in_bytes == other.size_in_bytes &&
+             shape == other.shape;
+    }
+    bool operator!=(const WeightSignature& other) const { return !(*this == other); }
+  };
+
+  PrepackedWeightsFileCache(PathString file_path, uint64_t model_hash);
+
+  // Maps the cache file. A missing, stale or corrupt file is not an error, the cache is just empty.
+  Status Load(const logging::Logger& logger);
+
+  // Writes the entries that were used or added since Load() to the cache file if any entry was added.
+  // The file is replaced atomically, so other processes keep using the file they mapped.
+  Status Save(const logging::Logger& logger) const;
+
+  // Returns true if the cached buffers of key match the weight signature. The buffers are owned by the cache and have
+  // a NULL deleter.
+  bool Find(const std::string& key, const WeightSignature& weight, std::vector<BufferUniquePtr>& prepacked_buffers,
+            std::vector<size_t>& prepacked_buffer_sizes);
+
+  // Adds the pre-packed buffers of key that are owned by somebody else, e.g. the PrepackedWeightsContainer of the
+  // session. They must stay alive until Save() is called. A key that the cache file already holds with the same
+  // weight signature and buffer sizes keeps the buffers of the file and does not make Save() rewrite it.
+  void Add(const std::string& key, const WeightSignature& weight, const PrePackedWeights& prepacked_weights);
+
+  // Adds the pre-packed buffers of key and takes ownership of them for the lifetime of the cache.
+  const PrePackedWeights& Add(const std::string& key, const WeightSignature& weight,
+                              PrePackedWeights&& prepacked_weights);
+
+  // Returns true if an entry was added that is not in the cache file yet, i.e. Save() will rewrite the file.
+  bool HasNewEntries() const {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    return has_new_entries_;
+  }
+
+  // Number of bytes of pre-packed weights mapped from the cache file.
+  size_t GetMappedBytes() const { return mapped_bytes_; }
+
+  static std::string GetKey(const Node& node, int input_idx, const std::string& weight_name);
+
+  // Hash of the content, the shape and the type of the weight and of the attributes of the node, with the type, shape
+  // and size of the weight.
+  static WeightSignature GetWeightSignature(const Node& node, const Tensor& weight);
+
+  // Hash of the nodes and their attributes in the graph, without the initializer data.
+  static uint64_t GetModelHash(const Graph& graph);
+
+ private:
+  struct Entry {
+    WeightSignature weight;
+    std::vector<std::pair<const void*, size_t>> buffers;
+    bool used;
+  };
+
+  void AddEntry(const std::string& key, const WeightSignature& weight, const PrePackedWeights& prepacked_weights);
+
+  const PathString file_path_;
+  const uint64_t model_hash_;
+
+  mutable OrtMutex mutex_;
+  Env::MappedMemoryPtr mapped_file_;
+  size_t mapped_bytes_{0};
+  std::unordered_map<std::string, Entry> entries_;
+  std::vector<std::unique_ptr<PrePackedWeights>> owned_weights_;
+  bool has_new_entries_{false};
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsFileCache);
+};
+
+}  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #include "core/framework/sequential_executor.h"
 
 #include <chrono>
+#include <optional>
 #include <thread>
 #include <vector>
 #include <sstream>
@@ -11,6 +12,8 @@
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/intra_op_parallelism_tuner.h"
+#include "core/framework/node_trace_recorder.h"
 #include "core/framework/stream_execution_context.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
@@ -461,6 +464,16 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
     ORT_THROW("Async Kernel Support is not implemented yet.");
   } else {
     KernelScope kernel_scope(session_scope, kernel_ctx, *p_kernel);
+    std::optional<profiling::NodeTraceRecorder::KernelScope> node_trace_scope;
+    if (auto* recorder = ctx.GetSessionState().GetNodeTraceRecorder(); recorder != nullptr) {
+      node_trace_scope.emplace(*recorder, idx, kernel_ctx);
+    }
+    // apply the tuned intra-op parallelism of the node, or measure it while it is being tuned
+    std::optional<IntraOpParallelismTuner::KernelScope> tuner_scope;
+    if (auto* tuner = ctx.GetSessionState().GetIntraOpParallelismTuner();
+        tuner != nullptr && p_kernel->Info().GetExecutionProvider()->Type() == kCpuExecutionProvider) {
+      tuner_scope.emplace(*tuner, idx, kernel_ctx);
+    }
     ORT_TRY {
 #ifdef ENABLE_TRAINING
       // AllocateInputsContiguously - is only required for NCCL kernels
@@ -606,7 +619,8 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
     if (all_tensors) {
       MemoryPatternGroup mem_patterns;
       ORT_RETURN_IF_ERROR(ctx.GetExecutionFrame().GeneratePatterns(mem_patterns));
-      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
+      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, feed_mlvalue_idxs,
+                                                                  std::move(mem_patterns)));
     }
   }
 
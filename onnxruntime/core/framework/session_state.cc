@@ -7,6 +7,7 @@
 
 #include "core/platform/ort_mutex.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
@@ -61,6 +62,33 @@ class StreamCommandHandleRegistryImpl : public IStreamCommandHandleRegistry {
 };
 #endif
 
+static size_t GetMemoryPatternCacheMaxEntries(const SessionOptions& sess_options) {
+  const std::string value =
+      sess_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternCacheMaxEntries, "0");
+  size_t max_entries = 0;
+  ORT_ENFORCE(TryParseStringWithClassicLocale(value, max_entries),
+              "Invalid value for ", kOrtSessionOptionsConfigMemoryPatternCacheMaxEntries, ": ", value);
+  return max_entries;
+}
+
+// The CPU nodes are partitioned into as many streams as the inter-op thread pool can run concurrently in parallel
+// execution mode, unless the number is set in the config.
+static Status GetMaxCpuStreams(const SessionOptions& sess_options, const concurrency::ThreadPool* inter_op_thread_pool,
+                               size_t& max_cpu_streams) {
+  max_cpu_streams = 1;
+  if (sess_options.execution_mode != ExecutionMode::ORT_PARALLEL) {
+    return Status::OK();
+  }
+  const std::string value =
+      sess_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigParallelExecutionMaxCpuStreams, "0");
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(value, max_cpu_streams),
+                    "Invalid value for ", kOrtSessionOptionsConfigParallelExecutionMaxCpuStreams, ": ", value);
+  if (max_cpu_streams == 0) {
+    max_cpu_streams = static_cast<size_t>(concurrency::ThreadPool::NumThreadsIncludingCaller(inter_op_thread_pool));
+  }
+  return Status::OK();
+}
+
 SessionState::SessionState(Graph& graph,
                            const ExecutionProviders& execution_providers,
                            concurrency::ThreadPool* thread_pool,
@@ -75,6 +103,7 @@ SessionState::SessionState(Graph& graph,
       execution_providers_(execution_providers),
       logger_(logger),
       profiler_(profiler),
+      mem_patterns_(GetMemoryPatternCacheMaxEntries(sess_options)),
       thread_pool_(thread_pool),
       inter_op_thread_pool_(inter_op_thread_pool),
       data_transfer_mgr_(data_transfer_mgr),
@@ -213,6 +242,14 @@ const KernelCreateInfo& SessionState::GetNodeKernelCreateInfo(NodeIndex node_ind
   return *entry->second;
 }
 
+concurrency::ThreadPool* SessionState::GetInitializationThreadPool() const {
+  if (sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisableParallelInitialization, "0") ==
+      "1") {
+    return nullptr;
+  }
+  return thread_pool_;
+}
+
 Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_manager) {
   const auto& nodes = graph_viewer_->Nodes();
   if (!nodes.empty()) {
@@ -222,7 +259,8 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
     }
     session_kernels_.clear();
     session_kernels_.resize(max_nodeid + 1);
-    for (const auto& node : nodes) {
+
+    auto create_kernel = [this, &kernel_registry_manager](const Node& node) -> Status {
       // construct and save the kernels
       const KernelCreateInfo& kci = GetNodeKernelCreateInfo(node.Index());
 
@@ -231,8 +269,26 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
       const IExecutionProvider& exec_provider = *execution_providers_.Get(exec_provider_name);
 
       // assumes vector is already resize()'ed to the number of nodes in the graph
-      ORT_RETURN_IF_ERROR(kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]));
+      return kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]);
+    };
+
+    // The built-in kernels of the CPU EP are created in parallel. Kernels of other EPs may set up device state in
+    // their constructor and custom op kernels are not required to be thread safe, so they are created sequentially.
+    concurrency::ThreadPool* thread_pool = GetInitializationThreadPool();
+    InlinedVector<const Node*> cpu_nodes;
+    for (const auto& node : nodes) {
+      if (thread_pool != nullptr && node.GetExecutionProviderType() == kCpuExecutionProvider &&
+          !kernel_registry_manager.HasCustomKernel(node)) {
+        cpu_nodes.push_back(&node);
+      } else {
+        ORT_RETURN_IF_ERROR(create_kernel(node));
+      }
     }
+
+    ORT_RETURN_IF_ERROR(session_state_utils::ParallelForWithStatus(
+        thread_pool, cpu_nodes.size(), [&create_kernel, &cpu_nodes](size_t i) {
+          return create_kernel(*cpu_nodes[i]);
+        }));
   }
   node_index_info_.emplace(*graph_viewer_, ort_value_name_idx_map_);
   return Status::OK();
@@ -360,6 +416,36 @@ void SessionState::CleanInitializedTensorsFromGraph() {
   graph_.CleanAllInitializedTensors();
 }
 
+size_t SessionState::GetInitializerMappedBytes() const {
+  size_t bytes = initializer_mapped_bytes_;
+  for (const auto& [node_index, subgraph_session_states] : subgraph_session_states_) {
+    for (const auto& [attribute_name, subgraph_session_state] : subgraph_session_states) {
+      bytes += subgraph_session_state->GetInitializerMappedBytes();
+    }
+  }
+  return bytes;
+}
+
+size_t SessionState::GetInitializerCopiedBytes() const {
+  size_t bytes = initializer_copied_bytes_;
+  for (const auto& [node_index, subgraph_session_states] : subgraph_session_states_) {
+    for (const auto& [attribute_name, subgraph_session_state] : subgraph_session_states) {
+      bytes += subgraph_session_state->GetInitializerCopiedBytes();
+    }
+  }
+  return bytes;
+}
+
+size_t SessionState::GetInitializerSharedBytes() const {
+  size_t bytes = initializer_shared_bytes_;
+  for (const auto& [node_index, subgraph_session_states] : subgraph_session_states_) {
+    for (const auto& [attribute_name, subgraph_session_state] : subgraph_session_states) {
+      bytes += subgraph_session_state->GetInitializerSharedBytes();
+    }
+  }
+  return bytes;
+}
+
 static Status KernelUseSharedPrePackedBuffers(OpKernel& kernel, int input_idx,
                                               const PrePackedWeights& prepacked_weights,
                                               const std::string& node_name) {
@@ -396,10 +482,207 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
 
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                                        const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
-  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
-                                        bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
+  // a constant initialized tensor from the current or an outer scope graph that is an input of a node
+  struct ConstantInput {
+    int input_idx;
+    const std::string* name;
+    SessionState* owner;
+    int ort_value_idx;
+    const Tensor* tensor;
+    bool is_packed;
+  };
+
+  struct NodeToPrePack {
+    const Node* node;
+    OpKernel* kernel;
+    InlinedVector<ConstantInput> inputs;
+  };
+
+  const bool should_cache_prepacked_weights_for_shared_initializers = (prepacked_weights_container_ != nullptr);
+
+  // serializes the accesses of the kernels that are pre-packed in parallel to the pre-packed weights container and
+  // to the counters
+  OrtMutex prepack_mutex;
+
+  // The inputs of a node are pre-packed in order as the kernel may keep state between the calls to PrePack()
+  auto prepack_node = [this, &initializers_to_share_map, should_cache_prepacked_weights_for_shared_initializers,
+                       &prepack_mutex](NodeToPrePack& node_to_prepack) -> Status {
+    const Node& node = *node_to_prepack.node;
+    OpKernel* kernel = node_to_prepack.kernel;
+    for (auto& input : node_to_prepack.inputs) {
+      const int input_idx = input.input_idx;
+      const std::string& input_name = *input.name;
+      const Tensor& const_initialized_tensor = *input.tensor;
+      bool is_packed = false;
+
+      auto iter = initializers_to_share_map.find(input_name);
+      bool is_shared_initializer = (iter != initializers_to_share_map.end());
+
+      // The pre-packed weights cache file is limited to the CPU EP as its buffers live in host memory
+      const bool use_file_cache = prepacked_weights_file_cache_ != nullptr &&
+                                  node.GetExecutionProviderType() == kCpuExecutionProvider;
+      std::string file_cache_key;
+      PrepackedWeightsFileCache::WeightSignature file_cache_weight;
+      if (use_file_cache) {
+        file_cache_key = PrepackedWeightsFileCache::GetKey(node, input_idx, input_name);
+        file_cache_weight = PrepackedWeightsFileCache::GetWeightSignature(node, const_initialized_tensor);
+
+        std::vector<BufferUniquePtr> cached_buffers;
+        std::vector<size_t> cached_buffer_sizes;
+        if (prepacked_weights_file_cache_->Find(file_cache_key, file_cache_weight, cached_buffers,
+                                                cached_buffer_sizes)) {
+          ORT_RETURN_IF_ERROR(kernel->UseCachedPrePackedBuffers(const_initialized_tensor, cached_buffers,
+                                                                cached_buffer_sizes, input_idx, is_packed));
+          if (is_packed) {
+            std::lock_guard<OrtMutex> l(prepack_mutex);
+            ++used_cached_pre_packed_weights_counter_;
+          }
+        }
+      }
+
+      if (is_packed) {
+        // the kernel restored the pre-packed weight from the cache file, nothing to pack
+      } else if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
+                 node.GetExecutionProviderType() == kCpuExecutionProvider) {  // caching of pre-packed weights' turned ON
+
+        AllocatorPtr allocator_for_caching;
+        {
+          std::lock_guard<OrtMutex> l(prepack_mutex);
+          allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
+        }
+        ORT_ENFORCE(allocator_for_caching.get() != nullptr);
+
+        PrePackedWeights weights_to_be_filled_in;
+        // The reason we invoke PrePack() before looking into the container for any pre-packed weight
+        // cached by another instance of the same op_type (for the same constant initializer) is because
+        // to truly know if we can use a cached pre-packed weight, we would have to compare the cached pre-packed
+        // weight with the pre-packed weight generated by this instance of the same op_type because other static
+        // properties of the node like node attributes could play a role in the pre-packed weights' contents.
+        ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, allocator_for_caching,
+                                            is_packed,
+                                            &weights_to_be_filled_in));
+
+        if (is_packed) {
+          // BUG CHECK: Ensure that the kernel has filled in the pre-packed weight to be cached if the weight was pre-packed
+          ORT_ENFORCE(weights_to_be_filled_in.buffers_.size() > 0, "The kernel corresponding to the node ", node.Name(),
+                      " doesn't have an implementation that can cache computed pre-packed weights");
+
+          const auto& op_type = node.OpType();
+
+          // Sanity check
+          // TODO: Check if some version of the ONNX IR allows op_type to be empty
+          ORT_ENFORCE(!op_type.empty(), "The op type of a node cannot be empty");
+
+          // The key for the pre-packed weights container lookup is the op_type + hash of the prepacked-weight
+          // that we just got by invoking PrePack() on this kernel.
+
+          const std::string& prepacked_weights_container_key = GenerateKeyForPrepackedWeightsMap(op_type,
+                                                                                                 weights_to_be_filled_in);
+
+          std::lock_guard<OrtMutex> l(prepack_mutex);
+
+          bool container_contains_packed_weight = prepacked_weights_container_->HasWeight(prepacked_weights_container_key);
+
+          if (container_contains_packed_weight) {
+            LOGS(logger_, INFO) << "Using cached version of pre-packed weight for constant initializer: " << input_name
+                                << " used in the node: " << node.Name() << " which is of op type: " << node.OpType();
+
+            ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
+                                                                prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
+                                                                node.Name()));
+
+            ++used_shared_pre_packed_weights_counter_;
+          } else {  // container doesn't contain the pre-packed weight - so write into it for sharing across kernel instances
+
+            if (!prepacked_weights_container_->WriteWeight(prepacked_weights_container_key, std::move(weights_to_be_filled_in))) {
+              return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unable to write the provided PrePackedWeights instance into the container");
+            }
+
+            ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
+                                                                prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
+                                                                node.Name()));
+          }
+
+          if (use_file_cache) {
+            prepacked_weights_file_cache_->Add(file_cache_key, file_cache_weight,
+                                               prepacked_weights_container_->GetWeight(prepacked_weights_container_key));
+          }
+        }
+
+      } else if (use_file_cache) {  // caching of pre-packed weights in the cache file
+        AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+        PrePackedWeights weights_to_be_filled_in;
+        ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
+                                            session_cpu_alloc,  // use allocator tied to this session
+                                            is_packed,
+                                            &weights_to_be_filled_in));
+
+        // Kernels that keep the pre-packed weight to themselves are not cached
+        if (is_packed && !weights_to_be_filled_in.buffers_.empty()) {
+          const PrePackedWeights& cached_weights = prepacked_weights_file_cache_->Add(
+              file_cache_key, file_cache_weight, std::move(weights_to_be_filled_in));
+          ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx, cached_weights, node.Name()));
+        }
+      } else {  // caching of pre-packed weights' turned OFF
+        AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+        ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
+                                            session_cpu_alloc,  // use allocator tied to this session
+                                            is_packed,
+                                            nullptr  // no caching required
+                                            ));
+      }
+
+      input.is_packed = is_packed;
+    }
+
+    return Status::OK();
+  };
+
+  // The nodes of the CPU EP are pre-packed in parallel, in chunks of one node per thread. The pre-packed initializers
+  // are released after each chunk, so the peak memory exceeds the one of a sequential pre-packing by at most one
+  // initializer per thread. Nodes of other EPs are pre-packed sequentially as their kernels may use device state.
+  concurrency::ThreadPool* thread_pool = GetInitializationThreadPool();
+  const size_t chunk_size = static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(thread_pool));
+  std::vector<NodeToPrePack> chunk;
+  chunk.reserve(chunk_size);
+  InlinedVector<NodeToPrePack*> cpu_nodes;
+
+  auto prepack_chunk = [&]() -> Status {
+    cpu_nodes.clear();
+    for (auto& node_to_prepack : chunk) {
+      if (thread_pool != nullptr && node_to_prepack.node->GetExecutionProviderType() == kCpuExecutionProvider) {
+        cpu_nodes.push_back(&node_to_prepack);
+      } else {
+        ORT_RETURN_IF_ERROR(prepack_node(node_to_prepack));
+      }
+    }
+
+    ORT_RETURN_IF_ERROR(session_state_utils::ParallelForWithStatus(
+        thread_pool, cpu_nodes.size(), [&prepack_node, &cpu_nodes](size_t i) {
+          return prepack_node(*cpu_nodes[i]);
+        }));
+
+    for (const auto& node_to_prepack : chunk) {
+      for (const auto& input : node_to_prepack.inputs) {
+        if (input.is_packed) {
+          ++number_of_prepacks_counter_;
+
+          if (constant_initializers_use_count.count(*input.name) && --constant_initializers_use_count[*input.name] == 0) {
+            // release the constant initialized tensor
+            input.owner->initialized_tensors_.erase(input.ort_value_idx);
+            input.owner->constant_initialized_tensors_.erase(input.ort_value_idx);
+          }
+        }
+      }
+    }
+
+    chunk.clear();
+    return Status::OK();
+  };
+
+  auto prepack_constant_weights = [&]() -> Status {
     for (auto& node : GetGraphViewer().Nodes()) {
-      auto kernel = GetMutableKernel(node.Index());
+      NodeToPrePack node_to_prepack{&node, GetMutableKernel(node.Index()), {}};
       int input_idx = 0;
       for (auto& input_def : node.InputDefs()) {
         if (input_def->Exists()) {
@@ -412,87 +695,9 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
             if (st->GetOrtValueNameIdxMap().GetIdx(input_name, ort_value_idx).IsOK()) {
               std::unordered_map<int, OrtValue>& constant_initialized_tensors = st->constant_initialized_tensors_;
 
-              if (constant_initialized_tensors.count(ort_value_idx)) {
-                bool is_packed = false;
-                const Tensor& const_initialized_tensor = constant_initialized_tensors[ort_value_idx].Get<Tensor>();
-
-                auto iter = initializers_to_share_map.find(input_name);
-                bool is_shared_initializer = (iter != initializers_to_share_map.end());
-
-                // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
-                if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
-                    node.GetExecutionProviderType() == kCpuExecutionProvider) {  // caching of pre-packed weights' turned ON
-
-                  AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
-                  ORT_ENFORCE(allocator_for_caching.get() != nullptr);
-
-                  PrePackedWeights weights_to_be_filled_in;
-                  // The reason we invoke PrePack() before looking into the container for any pre-packed weight
-                  // cached by another instance of the same op_type (for the same constant initializer) is because
-                  // to truly know if we can use a cached pre-packed weight, we would have to compare the cached pre-packed
-                  // weight with the pre-packed weight generated by this instance of the same op_type because other static
-                  // properties of the node like node attributes could play a role in the pre-packed weights' contents.
-                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, allocator_for_caching,
-                                                      is_packed,
-                                                      &weights_to_be_filled_in));
-
-                  if (is_packed) {
-                    // BUG CHECK: Ensure that the kernel has filled in the pre-packed weight to be cached if the weight was pre-packed
-                    ORT_ENFORCE(weights_to_be_filled_in.buffers_.size() > 0, "The kernel corresponding to the node ", node.Name(),
-                                " doesn't have an implementation that can cache computed pre-packed weights");
-
-                    const auto& op_type = node.OpType();
-
-                    // Sanity check
-                    // TODO: Check if some version of the ONNX IR allows op_type to be empty
-                    ORT_ENFORCE(!op_type.empty(), "The op type of a node cannot be empty");
-
-                    // The key for the pre-packed weights container lookup is the op_type + hash of the prepacked-weight
-                    // that we just got by invoking PrePack() on this kernel.
-
-                    const std::string& prepacked_weights_container_key = GenerateKeyForPrepackedWeightsMap(op_type,
-                                                                                                           weights_to_be_filled_in);
-
-                    bool container_contains_packed_weight = prepacked_weights_container_->HasWeight(prepacked_weights_container_key);
-
-                    if (container_contains_packed_weight) {
-                      LOGS(logger_, INFO) << "Using cached version of pre-packed weight for constant initializer: " << input_name
-                                          << " used in the node: " << node.Name() << " which is of op type: " << node.OpType();
-
-                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                          prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
-                                                                          node.Name()));
-
-                      ++used_shared_pre_packed_weights_counter_;
-                    } else {  // container doesn't contain the pre-packed weight - so write into it for sharing across kernel instances
-
-                      if (!prepacked_weights_container_->WriteWeight(prepacked_weights_container_key, std::move(weights_to_be_filled_in))) {
-                        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unable to write the provided PrePackedWeights instance into the container");
-                      }
-
-                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                          prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
-                                                                          node.Name()));
-                    }
-                  }
-
-                } else {  // caching of pre-packed weights' turned OFF
-                  AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
-                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
-                                                      session_cpu_alloc,  // use allocator tied to this session
-                                                      is_packed,
-                                                      nullptr  // no caching required
-                                                      ));
-                }
-                if (is_packed) {
-                  ++number_of_prepacks_counter_;
-
-                  if (constant_initializers_use_count.count(input_name) && --constant_initializers_use_count[input_name] == 0) {
-                    // release the constant initialized tensor
-                    st->initialized_tensors_.erase(ort_value_idx);
-                    constant_initialized_tensors.erase(ort_value_idx);
-                  }
-                }
+              if (auto it = constant_initialized_tensors.find(ort_value_idx); it != constant_initialized_tensors.end()) {
+                node_to_prepack.inputs.push_back(
+                    {input_idx, &input_name, st, ort_value_idx, &it->second.Get<Tensor>(), false});
               }
               // stop searching in 2 cases:
               // 1. value is not from OuterScope
@@ -506,29 +711,25 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
         }
         input_idx++;
       }
+
+      if (!node_to_prepack.inputs.empty()) {
+        chunk.push_back(std::move(node_to_prepack));
+        if (chunk.size() == chunk_size) {
+          ORT_RETURN_IF_ERROR(prepack_chunk());
+        }
+      }
     }
 
-    return Status::OK();
+    return prepack_chunk();
   };
 
-  bool should_cache_prepacked_weights_for_shared_initializers = (prepacked_weights_container_ != nullptr);
-
+  // serialize calls to the method that looks up the container, calls UseCachedPrePackedWeight/PrePack
+  // and writes pre-packed weights to the container
+  std::unique_lock<onnxruntime::OrtMutex> l;
   if (should_cache_prepacked_weights_for_shared_initializers) {
-    // serialize calls to the method that looks up the container, calls UseCachedPrePackedWeight/PrePack
-    // and writes pre-packed weights to the container
-    std::lock_guard<onnxruntime::OrtMutex> l(prepacked_weights_container_->mutex_);
-    return prepacked_constant_weights(true);
-  } else {
-    return prepacked_constant_weights(false);
+    l = std::unique_lock<onnxruntime::OrtMutex>(prepacked_weights_container_->mutex_);
   }
-}
-
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
-  int64_t key = 0;
-  for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
-  }
-  return key;
+  return prepack_constant_weights();
 }
 
 #ifdef ENABLE_TRAINING
@@ -765,44 +966,32 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
 #endif
 
-// MemoryPatternGroup pointer is cached. It only inserted upon creation
-// and is not updated if already present.
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+// The cache entry is only inserted upon creation and is not updated if already present.
+std::shared_ptr<const MemoryPatternCacheEntry> SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
-    gsl::span<const int> feed_mlvalue_idxs,
-    const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
-  out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-#ifdef ENABLE_TRAINING
-    MemoryPatternGroup mem_patterns;
-    InlinedHashMap<int, TensorShape> inferred_shapes;
-    if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
-      auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
-      out_inferred_shapes = &shape_insert.first->second;
-      return ptr;
-    }
-#else
-    ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
-#endif
-    return nullptr;
+    gsl::span<const int> feed_mlvalue_idxs) const {
+  auto entry = mem_patterns_.Find(feed_mlvalue_idxs, tensor_inputs);
+  if (entry) {
+    return entry;
   }
 
-  auto patt_hit = shape_patterns_.find(key);
-  if (patt_hit != shape_patterns_.cend()) {
-    out_inferred_shapes = &patt_hit->second;
+#ifdef ENABLE_TRAINING
+  MemoryPatternGroup mem_patterns;
+  InlinedHashMap<int, TensorShape> inferred_shapes;
+  if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
+    return mem_patterns_.Insert(feed_mlvalue_idxs, tensor_inputs, std::move(mem_patterns), std::move(inferred_shapes));
   }
-  return &it->second;
+#endif
+  return nullptr;
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
   if (enable_mem_pattern_) {
+    // The bounded cache keys the patterns by the exact input shapes, so it does not need the
+    // graph inputs to have a shape.
+    const bool shape_keyed_cache = mem_patterns_.MaxEntries() > 0;
     for (auto* input : graph_viewer_->GetInputs()) {
-      if (!input->HasTensorOrScalarShape()) {
+      if (!shape_keyed_cache && !input->HasTensorOrScalarShape()) {
         enable_mem_pattern_ = false;
         break;
       }
@@ -836,7 +1025,7 @@ void SessionState::ResolveMemoryPatternFlag() {
       const auto* parent_node = graph_viewer_->ParentNode();
 
       for (auto* implicit_input : parent_node->ImplicitInputDefs()) {
-        if (!implicit_input->HasTensorOrScalarShape()) {
+        if (!shape_keyed_cache && !implicit_input->HasTensorOrScalarShape()) {
           enable_mem_pattern_ = false;
           break;
         }
@@ -846,15 +1035,17 @@ void SessionState::ResolveMemoryPatternFlag() {
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
+                                                   gsl::span<const int> feed_mlvalue_idxs,
                                                    MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
-
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  // Do not update if present, as the existing entry may be in use
+  mem_patterns_.Insert(feed_mlvalue_idxs, tensor_inputs, std::move(mem_patterns), {});
   return Status::OK();
 }
 
+MemoryPatternCacheStats SessionState::GetMemoryPatternCacheStats() const {
+  return mem_patterns_.GetStats();
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
 bool SessionState::GetEnableMemoryReuse() const { return sess_options_.enable_mem_reuse; }
@@ -1051,6 +1242,8 @@ Status SessionState::CreateSubgraphSessionState() {
 
       // Pass fused function manager to subgraph
       subgraph_session_state->fused_funcs_mgr_.SetFusedFuncs(fused_funcs_mgr_);
+      subgraph_session_state->prepacked_weights_file_cache_ = prepacked_weights_file_cache_;
+      subgraph_session_state->shared_initializer_store_ = shared_initializer_store_;
 
       // recurse
       ORT_RETURN_IF_ERROR(subgraph_session_state->CreateSubgraphSessionState());
@@ -1323,6 +1516,19 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                                               InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                               const InlinedHashMap<OrtValueName, OrtDevice>& outer_scope_node_arg_to_location_map,
                                               bool graph_info_already_created) {
+  // record the time of the initialization phases in the session profiler
+  TimePoint phase_start;
+  auto record_phase = [this, &phase_start](const std::string& event_name,
+                                           const std::initializer_list<std::pair<std::string, std::string>>& args) {
+    if (profiler_.IsEnabled()) {
+      profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, event_name, phase_start, args);
+      phase_start = profiler_.Start();
+    }
+  };
+  if (profiler_.IsEnabled()) {
+    phase_start = profiler_.Start();
+  }
+
   if (!graph_info_already_created) {
     CreateGraphInfo();
   }
@@ -1376,9 +1582,12 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   SubgraphsKernelCreateInfoMaps subgraphs_kernel_create_info_maps;
   AccumulateAllNestedSubgraphsInfo(*this, "", 0, subgraphs_kernel_create_info_maps);
 
+  size_t max_cpu_streams = 1;
+  ORT_RETURN_IF_ERROR(GetMaxCpuStreams(session_options, inter_op_thread_pool_, max_cpu_streams));
   SequentialPlannerContext context(session_options.execution_mode,
                                    session_options.execution_order,
-                                   session_options.enable_mem_reuse);
+                                   session_options.enable_mem_reuse,
+                                   max_cpu_streams);
 
 #ifdef _WIN32
 
@@ -1406,6 +1615,7 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                                               Logger(),
                                               p_seq_exec_plan_);
   ORT_RETURN_IF_ERROR(status);
+  record_phase("session_state_create_plan", {});
 
   // Record the allocation plan
 
@@ -1473,6 +1683,7 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   }
 #endif
 
+  session_state_utils::InitializerLoadStats initializer_load_stats;
   ORT_RETURN_IF_ERROR(
       session_state_utils::SaveInitializedTensors(
           Env::Default(), graph_location, *graph_viewer_,
@@ -1487,7 +1698,15 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
             return Status::OK();
           },
           logger_, data_transfer_mgr_, *p_seq_exec_plan_, session_options, memory_profile_func,
-          name_to_buffered_tensor_));
+          name_to_buffered_tensor_, initializer_load_stats, GetInitializationThreadPool(),
+          shared_initializer_store_));
+  initializer_mapped_bytes_ = initializer_load_stats.mapped_bytes;
+  initializer_copied_bytes_ = initializer_load_stats.copied_bytes;
+  initializer_shared_bytes_ = initializer_load_stats.shared_bytes;
+  record_phase("session_state_save_initializers",
+               {{"mapped_bytes", std::to_string(initializer_mapped_bytes_)},
+                {"copied_bytes", std::to_string(initializer_copied_bytes_)},
+                {"shared_bytes", std::to_string(initializer_shared_bytes_)}});
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Record Weight allocation info on device
@@ -1502,10 +1721,12 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   }
 
   ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager));
+  record_phase("session_state_create_kernels", {{"node_count", std::to_string(graph_viewer_->NumberOfNodes())}});
 
   if (!disable_prepacking) {
     ORT_RETURN_IF_ERROR(PrepackConstantInitializedTensors(constant_initializers_use_count,
                                                           session_options.initializers_to_share_map));
+    record_phase("session_state_prepack", {{"prepack_count", std::to_string(number_of_prepacks_counter_)}});
   }
 
   ORT_RETURN_IF_ERROR(
@@ -25,9 +25,11 @@
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/prepacked_weights_container.h"
+#include "core/framework/prepacked_weights_file_cache.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
@@ -56,6 +58,11 @@ class ExecutionProviders;
 class KernelDef;
 class OpKernel;
 class NodeIndexInfo;
+class SharedInitializerStore;
+class IntraOpParallelismTuner;
+namespace profiling {
+class NodeTraceRecorder;
+}
 struct SequentialExecutionPlan;
 struct MemoryPatternGroup;
 class DeviceStreamCollection;
@@ -215,16 +222,14 @@ class SessionState {
   /**
   Get cached memory pattern based on input shapes
   Must be called only when all values contain tensors
-  In training scenarios, the cache may be updated so
-  the callers would receive a copy of inferred shapes
-  made under mutex being held. In inference scenarios,
-  it is not mutable, we do not obtain a lock and simply get a pointer
-  w/o copying a hashtable
+  In training scenarios, the patterns and the shapes inferred
+  from the input shapes are generated if not present.
+  The returned entry stays valid if it is evicted from the cache
+  while it is in use.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternCacheEntry> GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
-      gsl::span<const int> feed_mlvalue_idxs,
-      const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
+      gsl::span<const int> feed_mlvalue_idxs) const;
 
   /**
   Set generated memory pattern with a given input shapes.
@@ -232,8 +237,15 @@ class SessionState {
   All inputs must represent Tensors
   */
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
+                                       gsl::span<const int> feed_mlvalue_idxs,
                                        MemoryPatternGroup mem_patterns) const;
 
+  /**
+  Get the hit/miss counters of the memory pattern cache and the memory
+  held by each input shape bucket.
+  */
+  MemoryPatternCacheStats GetMemoryPatternCacheStats() const;
+
   bool GetUseDeterministicCompute() const { return sess_options_.use_deterministic_compute; }
 
   /**
@@ -329,6 +341,48 @@ class SessionState {
     return used_shared_pre_packed_weights_counter_;
   }
 
+  size_t GetUsedCachedPrePackedWeightCounter() const {
+    return used_cached_pre_packed_weights_counter_;
+  }
+
+  // Bytes of initializer data of this graph and its subgraphs that is used in place from mapped memory
+  // (memory mapped external data or ORT format model bytes), and bytes that were copied when the initializers
+  // were loaded.
+  size_t GetInitializerMappedBytes() const;
+  size_t GetInitializerCopiedBytes() const;
+
+  // Bytes of initializer data of this graph and its subgraphs that is shared with other sessions through the
+  // SharedInitializerStore, i.e. that was already loaded by another session.
+  size_t GetInitializerSharedBytes() const;
+
+  // Set the cache file of pre-packed weights used by this session state and its subgraphs.
+  // Must be called before FinalizeSessionState(). The cache must outlive the kernels of the session.
+  void SetPrepackedWeightsFileCache(PrepackedWeightsFileCache* prepacked_weights_file_cache) noexcept {
+    prepacked_weights_file_cache_ = prepacked_weights_file_cache;
+  }
+
+  // Set the store through which this session state and its subgraphs share their constant CPU initializers with
+  // other sessions. Must be called before FinalizeSessionState().
+  void SetSharedInitializerStore(SharedInitializerStore* shared_initializer_store) noexcept {
+    shared_initializer_store_ = shared_initializer_store;
+  }
+
+  // Set the tuner of the intra-op parallelism of the kernels of this graph. Subgraphs are not tuned.
+  // The tuner must outlive the runs of the session.
+  void SetIntraOpParallelismTuner(IntraOpParallelismTuner* intra_op_parallelism_tuner) noexcept {
+    intra_op_parallelism_tuner_ = intra_op_parallelism_tuner;
+  }
+
+  IntraOpParallelismTuner* GetIntraOpParallelismTuner() const noexcept { return intra_op_parallelism_tuner_; }
+
+  // Set the recorder of the sampled kernel runs of this graph. Subgraphs are not recorded.
+  // The recorder must outlive the runs of the session.
+  void SetNodeTraceRecorder(profiling::NodeTraceRecorder* node_trace_recorder) noexcept {
+    node_trace_recorder_ = node_trace_recorder;
+  }
+
+  profiling::NodeTraceRecorder* GetNodeTraceRecorder() const noexcept { return node_trace_recorder_; }
+
   const KernelCreateInfoMap& GetKernelCreateInfoMap() const {
     return kernel_create_info_map_;
   }
@@ -366,6 +420,10 @@ class SessionState {
   // Populate OrtValueNameIdxMap and create the graph viewer.
   void CreateGraphInfo();
 
+  // Thread pool used to load initializers, create kernels and pre-pack weights in parallel,
+  // or nullptr if the session is initialized sequentially.
+  concurrency::ThreadPool* GetInitializationThreadPool() const;
+
   // create kernels using info in kernel_create_info_map_
   Status CreateKernels(const KernelRegistryManager& custom_registry_manager);
 
@@ -376,6 +434,7 @@ class SessionState {
   /**
    * Prepack the constant initialized tensors for better performance.
    * The original constant initialized tensors will be removed to save memory.
+   * The kernels of the CPU EP pre-pack their weights in parallel, one node per thread at a time.
    */
   Status PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                            const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map);
@@ -489,18 +548,8 @@ class SessionState {
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
 
-  // lock for the mem_patterns_
-  mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  // must be a node based container as a pointer is cached.
-  mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
-  // This is mutable under mutex in training scenarios so execution frame would make a copy
-  // of the value when created.
-#ifdef ENABLE_TRAINING
-  mutable NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#else
-  NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#endif
+  // cache for the generated mem_patterns, keyed by the input shapes.
+  mutable MemoryPatternCache mem_patterns_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -523,6 +572,18 @@ class SessionState {
   // prepacked_weights_container_ can be nullptr if no caching is required for prepacked weights
   PrepackedWeightsContainer* const prepacked_weights_container_{};
 
+  // Cache file of pre-packed weights of the CPU kernels. Owned by the InferenceSession, can be nullptr.
+  PrepackedWeightsFileCache* prepacked_weights_file_cache_ = nullptr;
+
+  // Store of initializers shared with other sessions. Owned by the Environment, can be nullptr.
+  SharedInitializerStore* shared_initializer_store_ = nullptr;
+
+  // Tuner of the intra-op parallelism of the kernels. Owned by the InferenceSession, can be nullptr.
+  IntraOpParallelismTuner* intra_op_parallelism_tuner_ = nullptr;
+
+  // Recorder of the sampled kernel runs. Owned by the InferenceSession, can be nullptr.
+  profiling::NodeTraceRecorder* node_trace_recorder_ = nullptr;
+
 #ifdef ENABLE_TRAINING
 // Needed for ORTTrainer. Should be removed along with ORTTrainer code
 #ifndef DISABLE_ABSEIL
@@ -553,6 +614,13 @@ class SessionState {
   // a constant initialized weight was used by the session state
   size_t used_shared_pre_packed_weights_counter_ = 0;
 
+  // Counter for number of times a pre-packed weight loaded from the cache file was used by the session state
+  size_t used_cached_pre_packed_weights_counter_ = 0;
+
+  size_t initializer_mapped_bytes_ = 0;
+  size_t initializer_copied_bytes_ = 0;
+  size_t initializer_shared_bytes_ = 0;
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   // Counter for number of times the session graph has been executed
   size_t graph_executions_counter_ = 0;
@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -16,12 +19,14 @@
 #include "core/common/logging/logging.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/data_transfer_manager.h"
+#include "core/framework/endian.h"
 #include "core/framework/graph_partitioner.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/framework/bfc_arena.h"
@@ -72,14 +77,15 @@ static inline common::Status ExtDataTensorProtoToTensor(const Env& env,
                                                         const std::basic_string<PATH_CHAR_TYPE>& proto_path,
                                                         const ONNX_NAMESPACE::TensorProto& tensor_proto,
                                                         Tensor& tensor, OrtCallback& ext_data_deleter,
-                                                        Tensor* buffered_tensor = nullptr) {
+                                                        Tensor* buffered_tensor = nullptr,
+                                                        bool* is_data_in_place = nullptr) {
   ORT_ENFORCE(utils::HasExternalData(tensor_proto));
 
   void* ext_data_buf = nullptr;
   SafeInt<size_t> ext_data_len = 0;
   ORT_RETURN_IF_ERROR(utils::GetExtDataFromTensorProto(env, proto_path.c_str(), tensor_proto,
                                                        ext_data_buf, ext_data_len, ext_data_deleter,
-                                                       buffered_tensor));
+                                                       buffered_tensor, is_data_in_place));
 
   // NB: creating a do-nothing allocator per tensor is wasteful; can perhaps be
   // avoided if the Tensor class implements the do-nothing behavior when given a
@@ -91,14 +97,23 @@ static inline common::Status ExtDataTensorProtoToTensor(const Env& env,
   return common::Status::OK();
 }
 
+// Kernels and MLAS expect the data of a tensor to be aligned to its element type at least.
+// Data used in place in a mapped file or in the ORT format model bytes is only as aligned as its offset.
+static bool IsAlignedForType(const void* data, const DataTypeImpl* type) {
+  const size_t alignment = std::min<size_t>(type->Size(), alignof(std::max_align_t));
+  return alignment == 0 || reinterpret_cast<uintptr_t>(data) % alignment == 0;
+}
+
 // If tensor_proto's external file path is kTensorProtoMemoryAddressTag, and
 // buffered_tensor is not null, buffered_tensor holds the real buffer pointed
 // by tensor_proto. buffered_tensor must be the owner of the buffer and deleter
 // should release the buffer when tensor_proto is released.
+// The size of the tensor is added to the mapped or copied bytes of load_stats.
 static common::Status DeserializeTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
                                              const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer* m,
                                              const AllocatorPtr& alloc, const AllocatorPtr& default_cpu_alloc,
                                              OrtValue& ort_value, const DataTransferManager& data_transfer_mgr,
+                                             InitializerLoadStats& load_stats,
                                              bool use_device_allocator_for_initializers = false,
                                              Tensor* buffered_tensor = nullptr) {
   if (bool(alloc) == (m != nullptr)) {
@@ -125,9 +140,22 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
       // utilize the mmap'd buffer directly by calling ExtDataTensorProtoToTensor. If we called
       // TensorProtoToTensor it would copy the data, causing unnecessary overhead
       OrtCallback ext_data_deleter;
+      bool is_data_in_place = false;
       ORT_RETURN_IF_ERROR(ExtDataTensorProtoToTensor(env, proto_path, tensor_proto, *p_tensor,
-                                                     ext_data_deleter, buffered_tensor));
+                                                     ext_data_deleter, buffered_tensor, &is_data_in_place));
+
+      if (!IsAlignedForType(p_tensor->DataRaw(), type)) {
+        ScopedOrtCallbackInvoker scoped_ort_callback_invoker(ext_data_deleter);
+        auto p_aligned_tensor = std::make_unique<Tensor>(type, p_tensor->Shape(), alloc ? alloc : default_cpu_alloc);
+        memcpy(p_aligned_tensor->MutableDataRaw(), p_tensor->DataRaw(), p_tensor->SizeInBytes());
+        load_stats.copied_bytes += p_aligned_tensor->SizeInBytes();
 
+        auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+        ort_value.Init(p_aligned_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+        return common::Status::OK();
+      }
+
+      (is_data_in_place ? load_stats.mapped_bytes : load_stats.copied_bytes) += p_tensor->SizeInBytes();
       ExtDataValueDeleter deleter{ext_data_deleter, p_tensor.get()};
       MLDataType ml_tensor_type = DataTypeImpl::GetType<Tensor>();
       ort_value.Init(p_tensor.release(), ml_tensor_type, deleter);
@@ -157,6 +185,7 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
       scoped_ort_callback_invoker = ScopedOrtCallbackInvoker(ext_data_deleter);
       // TODO!! Need a temp buffer allocator for non-escape buffers that maybe too big for stack allocation.
 
+      load_stats.copied_bytes += p_tensor->SizeInBytes();
       return CopyTensorFromCPUToDevice(data_transfer_mgr, p_deserialize_tensor, p_tensor, ort_value);
     }
   } else {
@@ -169,6 +198,7 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
     if (device_type == OrtDevice::CPU) {
       // deserialize directly to CPU tensor
       ORT_RETURN_IF_ERROR(utils::TensorProtoToTensor(env, proto_path.c_str(), tensor_proto, *p_tensor));
+      load_stats.copied_bytes += p_tensor->SizeInBytes();
       auto ml_tensor = DataTypeImpl::GetType<Tensor>();
       ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
       return common::Status::OK();
@@ -191,6 +221,7 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
       ORT_RETURN_IF_ERROR(utils::TensorProtoToTensor(env, proto_path.c_str(), tensor_proto, *p_deserialize_tensor));
       // TODO!! Need a temp buffer allocator for non-escape buffers that maybe too big for stack allocation.
 
+      load_stats.copied_bytes += p_tensor->SizeInBytes();
       return CopyTensorFromCPUToDevice(data_transfer_mgr, p_deserialize_tensor, p_tensor, ort_value);
     }
   }
@@ -255,6 +286,36 @@ common::Status CopyTensorFromCPUToDevice(
   }
 }
 
+// Initializers smaller than this are not worth the hashing and the lookup in the SharedInitializerStore.
+static constexpr size_t kMinSharedInitializerBytes = 128;
+
+// Get the initializer from the store, adding it if no other session did. The data is hashed in place if the
+// TensorProto has raw data in the native byte order, otherwise it is unpacked first.
+static common::Status GetSharedInitializer(SharedInitializerStore& shared_initializer_store,
+                                           const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                           OrtValue& ort_value, bool& reused) {
+  const DataTypeImpl* const type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+  const TensorShape tensor_shape = utils::GetTensorShapeFromTensorProto(tensor_proto);
+
+  std::vector<uint8_t> unpacked_data;
+  gsl::span<const uint8_t> data;
+  if (utils::HasRawData(tensor_proto) && endian::native == endian::little) {
+    data = gsl::make_span(reinterpret_cast<const uint8_t*>(tensor_proto.raw_data().data()),
+                          tensor_proto.raw_data().size());
+  } else {
+    ORT_RETURN_IF_ERROR(utils::UnpackInitializerData(tensor_proto, unpacked_data));
+    data = unpacked_data;
+  }
+
+  size_t expected_size = 0;
+  ORT_RETURN_IF_ERROR(Tensor::CalculateTensorStorageSize(type, tensor_shape, /*alignment*/ 0, expected_size));
+  ORT_RETURN_IF(data.size() != expected_size, "Initializer ", tensor_proto.name(), " has ", data.size(),
+                " bytes of data, expected ", expected_size);
+
+  ort_value = shared_initializer_store.GetOrAdd(type, tensor_shape, data, reused);
+  return Status::OK();
+}
+
 common::Status SaveInitializedTensors(
     const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
     const GraphViewer& graph, const AllocatorPtr& default_cpu_alloc,
@@ -266,7 +327,10 @@ common::Status SaveInitializedTensors(
     const ExecutionPlanBase& exec_plan,
     const SessionOptions& session_options,
     const MemoryProfileFunction& memory_profile_func,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors) {
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors,
+    InitializerLoadStats& load_stats,
+    concurrency::ThreadPool* thread_pool,
+    SharedInitializerStore* shared_initializer_store) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > -1, "OrtValue indexes should have been populated.");
 
@@ -299,6 +363,12 @@ common::Status SaveInitializedTensors(
     return retval;
   };
 
+  // External data on CPU is used in place (mmap'd file or ORT format model bytes), so no memory is planned for it.
+  // When data is external and on GPU, it needs to be copied first to cpu memory, then to gpu memory.
+  auto is_used_in_place = [&exec_plan](int ort_value_index, const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+    return utils::HasExternalData(tensor_proto) && exec_plan.GetLocation(ort_value_index).Type() == OrtDevice::CPU;
+  };
+
   // 1. first plan the memory
   const InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
   InlinedHashMap<int, const ONNX_NAMESPACE::TensorProto*> id_to_initialized_tensor;
@@ -316,16 +386,58 @@ common::Status SaveInitializedTensors(
     id_to_initialized_tensor[ort_value_index] = entry.second;
   }
 
+  // Constant initializers on CPU that are not used in place are shared with the other sessions of the environment
+  // through the store, so no memory is planned for them either. Initializers used in place are already shared, as the
+  // pages of a mapped file are shared between the processes and sessions that map it.
+  InlinedHashMap<int, OrtValue> shared_initializers;
+  if (shared_initializer_store != nullptr) {
+    InlinedVector<std::pair<int, const ONNX_NAMESPACE::TensorProto*>> initializers_to_share;
+    for (const auto& [ort_value_index, tensor_proto] : id_to_initialized_tensor) {
+      const std::string& name = tensor_proto->name();
+      size_t size_in_bytes = 0;
+      if (name.empty() ||
+          exec_plan.GetLocation(ort_value_index) != OrtDevice() ||
+          user_supplied_initializer_ids.find(ort_value_index) != user_supplied_initializer_ids.end() ||
+          tensor_proto->data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING ||
+          utils::HasExternalData(*tensor_proto) ||
+          buffered_tensors.find(name) != buffered_tensors.end() ||
+          !graph.IsConstantInitializer(name, /* check_outer_scope */ false) ||
+#if !defined(DISABLE_SPARSE_TENSORS)
+          graph.GetGraph().IsSparseInitializer(name) ||
+#endif
+          !utils::GetSizeInBytesFromTensorProto<0>(*tensor_proto, &size_in_bytes).IsOK() ||
+          size_in_bytes < kMinSharedInitializerBytes) {
+        continue;
+      }
+      initializers_to_share.emplace_back(ort_value_index, tensor_proto);
+    }
+
+    struct SharedInitializer {
+      OrtValue ort_value;
+      bool reused = false;
+    };
+    std::vector<SharedInitializer> results(initializers_to_share.size());
+    ORT_RETURN_IF_ERROR(ParallelForWithStatus(thread_pool, initializers_to_share.size(), [&](size_t i) {
+      return GetSharedInitializer(*shared_initializer_store, *initializers_to_share[i].second,
+                                  results[i].ort_value, results[i].reused);
+    }));
+
+    for (size_t i = 0; i < initializers_to_share.size(); ++i) {
+      const size_t size_in_bytes = results[i].ort_value.Get<Tensor>().SizeInBytes();
+      (results[i].reused ? load_stats.shared_bytes : load_stats.copied_bytes) += size_in_bytes;
+      shared_initializers.emplace(initializers_to_share[i].first, std::move(results[i].ort_value));
+    }
+  }
+
   // tensors requiring a specific allocation order are traced first, to ensure they are allocated in order
-  // NB1: vector with init allocation order may contain a subset of all tensors (or none at all)
-  // NB2: only skip tracing and planning memory when data is external (i.e mmap) and on CPU.
-  //    when data is external and on GPU, need to copy first to cpu memory, then to gpu memory.
+  // NB: vector with init allocation order may contain a subset of all tensors (or none at all)
   auto initialized_tensors_to_allocate = id_to_initialized_tensor;
   for (int ort_value_index : initializer_allocation_order) {
     const auto entry = initialized_tensors_to_allocate.find(ort_value_index);
     ORT_ENFORCE(entry != initialized_tensors_to_allocate.end(),
                 "OrtValue index: ", ort_value_index, " from initializer_allocation_order not found among initialized tensors");
-    if (!(utils::HasExternalData(*entry->second) && exec_plan.GetLocation(ort_value_index).Type() == OrtDevice::CPU)) {
+    if (!is_used_in_place(ort_value_index, *entry->second) &&
+        shared_initializers.find(ort_value_index) == shared_initializers.end()) {
       // can not trace string tensor
       ORT_ENFORCE(entry->second->data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING, "Can not trace string tensor");
       ORT_RETURN_IF_ERROR(planner.Trace(entry->first, entry->second));
@@ -342,6 +454,10 @@ common::Status SaveInitializedTensors(
       // do not trace string tensor
       continue;
     }
+    if (is_used_in_place(entry.first, *entry.second) ||
+        shared_initializers.find(entry.first) != shared_initializers.end()) {
+      continue;
+    }
     ORT_RETURN_IF_ERROR(planner.Trace(entry.first, entry.second));
   }
   // 2. allocate weight buffer on different locations
@@ -360,68 +476,156 @@ common::Status SaveInitializedTensors(
   }
 
   OrtCallback deleter{nullptr, nullptr};
+  const bool use_device_allocator_for_initializers =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
 
   // 3. create weight tensors based on weights buffer
-  for (const auto& entry : id_to_initialized_tensor) {
-    int ort_value_index = entry.first;
-    const std::string& name = entry.second->name();
+  // The initializers on CPU are deserialized in parallel, in chunks of one initializer per thread. A chunk is saved in
+  // order before the next one is loaded, so the TensorProto instances can be released as we go and the peak memory
+  // stays close to the one of a sequential load.
+  struct InitializerToLoad {
+    int ort_value_index;
+    const ONNX_NAMESPACE::TensorProto* tensor_proto;
+    std::optional<MemBuffer> m;
+    AllocatorPtr alloc;
+    Tensor* buffered_tensor = nullptr;
+    OrtValue ort_value;
+    InitializerLoadStats load_stats;
+  };
 
-    if (name.empty()) {
-      LOGS(logger, INFO) << "Skipping entry for missing optional value at idx " << ort_value_index;
-      continue;
+  auto deserialize = [&](InitializerToLoad& initializer) -> Status {
+    Status st = DeserializeTensorProto(env, graph_loc, *initializer.tensor_proto,
+                                       initializer.m.has_value() ? &*initializer.m : nullptr, initializer.alloc,
+                                       default_cpu_alloc, initializer.ort_value, data_transfer_mgr,
+                                       initializer.load_stats, use_device_allocator_for_initializers,
+                                       initializer.buffered_tensor);
+    if (!st.IsOK()) {
+      std::ostringstream oss;
+      oss << "Deserialize tensor " << initializer.tensor_proto->name() << " failed." << st.ErrorMessage();
+      return Status(st.Category(), st.Code(), oss.str());
     }
+    return Status::OK();
+  };
 
-    OrtValue ort_value;
+  const InlinedVector<std::pair<int, const ONNX_NAMESPACE::TensorProto*>> initializers_to_load(
+      id_to_initialized_tensor.begin(), id_to_initialized_tensor.end());
+  const size_t chunk_size = static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(thread_pool));
+  std::vector<InitializerToLoad> chunk;
+  chunk.reserve(chunk_size);
+  InlinedVector<InitializerToLoad*> cpu_initializers;
+
+  for (size_t chunk_start = 0; chunk_start < initializers_to_load.size(); chunk_start += chunk_size) {
+    const size_t chunk_end = std::min(chunk_start + chunk_size, initializers_to_load.size());
+    chunk.clear();
+    cpu_initializers.clear();
+
+    // the buffers of the planner and the buffered tensors are looked up sequentially
+    for (size_t i = chunk_start; i < chunk_end; ++i) {
+      const auto [ort_value_index, tensor_proto] = initializers_to_load[i];
+      const std::string& name = tensor_proto->name();
+
+      if (name.empty()) {
+        LOGS(logger, INFO) << "Skipping entry for missing optional value at idx " << ort_value_index;
+        continue;
+      }
 
-    if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end()) {
-      ort_value = *(session_options.initializers_to_share_map.at(name));
-      LOGS(logger, INFO) << "Using user supplied initializer with name (" << name << ").";
-    } else {
-      const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
+      InitializerToLoad& initializer = chunk.emplace_back();
+      initializer.ort_value_index = ort_value_index;
+      initializer.tensor_proto = tensor_proto;
 
-      std::optional<MemBuffer> m;
-      AllocatorPtr alloc;
-      // TODO: if the tensor need be copied, does it have enough room?
-      ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m, alloc));
-      bool use_device_allocator_for_initializers =
-          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
+      if (user_supplied_initializer_ids.find(ort_value_index) != user_supplied_initializer_ids.end()) {
+        initializer.ort_value = *(session_options.initializers_to_share_map.at(name));
+        LOGS(logger, INFO) << "Using user supplied initializer with name (" << name << ").";
+        continue;
+      }
+
+      if (auto iter = shared_initializers.find(ort_value_index); iter != shared_initializers.end()) {
+        initializer.ort_value = std::move(iter->second);
+        continue;
+      }
+
+      if (is_used_in_place(ort_value_index, *tensor_proto)) {
+        // not traced, the allocator is only used if the data must be copied
+        initializer.alloc = planner.GetAllocator(exec_plan.GetLocation(ort_value_index));
+      } else {
+        // TODO: if the tensor need be copied, does it have enough room?
+        ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, initializer.m, initializer.alloc));
+      }
 
-      Tensor* p_tensor = nullptr;
       if (auto iter = buffered_tensors.find(name);
           iter != buffered_tensors.end()) {
-        p_tensor = iter->second.release();
+        initializer.buffered_tensor = iter->second.release();
         buffered_tensors.erase(iter);
       }
 
-      Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, (m.has_value()) ? &*m : nullptr, alloc,
-                                         default_cpu_alloc, ort_value, data_transfer_mgr,
-                                         use_device_allocator_for_initializers, p_tensor);
-      if (!st.IsOK()) {
-        std::ostringstream oss;
-        oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
-        return Status(st.Category(), st.Code(), oss.str());
+      // copies to other devices go through the data transfer manager, which is not required to be thread safe
+      const auto device_type = initializer.alloc != nullptr ? initializer.alloc->Info().device.Type()
+                                                            : initializer.m->GetAllocInfo().device.Type();
+      if (device_type == OrtDevice::CPU) {
+        cpu_initializers.push_back(&initializer);
+      } else {
+        ORT_RETURN_IF_ERROR(deserialize(initializer));
       }
     }
 
-    // 'name' is a reference to a string within the TensorProto that save_tensor_func may free
-    // so we need to output this message prior to calling save_tensor_func
-    VLOGS(logger, 1) << "Adding weight with name : " << name << " with index: " << ort_value_index;
+    ORT_RETURN_IF_ERROR(ParallelForWithStatus(thread_pool, cpu_initializers.size(), [&](size_t i) {
+      return deserialize(*cpu_initializers[i]);
+    }));
+
+    for (auto& initializer : chunk) {
+      const std::string& name = initializer.tensor_proto->name();
+      load_stats.mapped_bytes += initializer.load_stats.mapped_bytes;
+      load_stats.copied_bytes += initializer.load_stats.copied_bytes;
+
+      // 'name' is a reference to a string within the TensorProto that save_tensor_func may free
+      // so we need to output this message prior to calling save_tensor_func
+      VLOGS(logger, 1) << "Adding weight with name : " << name << " with index: " << initializer.ort_value_index;
 
-    // any outer scope value is shadowed by a local value and can't override it.
-    // due to that check_outer_scope is false
-    const bool constant = graph.IsConstantInitializer(name, /* check_outer_scope */ false);
+      // any outer scope value is shadowed by a local value and can't override it.
+      // due to that check_outer_scope is false
+      const bool constant = graph.IsConstantInitializer(name, /* check_outer_scope */ false);
 #if !defined(DISABLE_SPARSE_TENSORS)
-    const bool sparse = graph.GetGraph().IsSparseInitializer(name);
-    ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, ort_value, deleter, constant, sparse));
+      const bool sparse = graph.GetGraph().IsSparseInitializer(name);
+      ORT_RETURN_IF_ERROR(save_tensor_func(name, initializer.ort_value_index, initializer.ort_value, deleter,
+                                           constant, sparse));
 #else
-    ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, ort_value, deleter, constant, false));
+      ORT_RETURN_IF_ERROR(save_tensor_func(name, initializer.ort_value_index, initializer.ort_value, deleter,
+                                           constant, false));
 #endif
+    }
   }
 
-  LOGS(logger, INFO) << "Done saving initialized tensors";
+  LOGS(logger, INFO) << "Done saving initialized tensors. " << load_stats.mapped_bytes
+                     << " bytes are used in place from mapped memory, " << load_stats.copied_bytes
+                     << " bytes were copied, " << load_stats.shared_bytes << " bytes are shared with other sessions.";
   return common::Status::OK();
 }
 
+common::Status ParallelForWithStatus(concurrency::ThreadPool* thread_pool, size_t count,
+                                     const std::function<common::Status(size_t)>& fn) {
+  std::vector<Status> statuses(count);
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(count), [&fn, &statuses](std::ptrdiff_t i) {
+        Status& status = statuses[static_cast<size_t>(i)];
+        ORT_TRY {
+          status = fn(static_cast<size_t>(i));
+        }
+        ORT_CATCH(const std::exception& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+          });
+        }
+        ORT_CATCH(...) {
+          status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "Unknown exception");
+        }
+      });
+
+  for (auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  return Status::OK();
+}
+
 template <typename T>  // T is container of const NodeArg* or NodeArg*
 static bool IsArgNameInInputsOutputs(const std::string& name,
                                      const T& graph_args) {
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -14,6 +15,7 @@
 #include "core/framework/session_options.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/platform/path_lib.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 class Env;
@@ -24,6 +26,7 @@ class GraphViewer;
 class OrtValueNameIdxMap;
 class DataTransferManager;
 class NodeArg;
+class SharedInitializerStore;
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
 class MemoryInfo;
 #endif
@@ -37,6 +40,16 @@ using SaveTensorFunction = std::function<Status(const std::string& name, int idx
                                                 const OrtCallback& d, bool constant, bool sparse)>;
 using MemoryProfileFunction = std::function<void(ITensorAllocator& planner)>;
 
+// Bytes of initializer data that is used in place from mapped memory, i.e. a memory mapped external data file or the
+// bytes of an ORT format model, and bytes that were copied into memory allocated by the session.
+// shared_bytes are the bytes of the initializers that were already loaded by another session and are shared through
+// the SharedInitializerStore. The initializers added to the store by this session are counted as copied.
+struct InitializerLoadStats {
+  size_t mapped_bytes = 0;
+  size_t copied_bytes = 0;
+  size_t shared_bytes = 0;
+};
+
 common::Status SaveInitializedTensors(
     const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
     const GraphViewer& graph, const AllocatorPtr& default_cpu_memory_info,
@@ -48,7 +61,16 @@ common::Status SaveInitializedTensors(
     const ExecutionPlanBase& exec_plan,
     const SessionOptions& session_options,
     const MemoryProfileFunction& memory_profile_func,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors);
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors,
+    InitializerLoadStats& load_stats,
+    concurrency::ThreadPool* thread_pool,
+    SharedInitializerStore* shared_initializer_store = nullptr);
+
+// Runs fn(i) for i in [0, count) on thread_pool, or sequentially if thread_pool is nullptr.
+// Exceptions thrown by fn are converted to a Status. The error of the lowest index is returned so the reported error
+// does not depend on the scheduling.
+common::Status ParallelForWithStatus(concurrency::ThreadPool* thread_pool, size_t count,
+                                     const std::function<common::Status(size_t)>& fn);
 
 common::Status AllocateTensor(
     const onnxruntime::MemBuffer* m,
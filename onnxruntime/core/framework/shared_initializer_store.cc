@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_store.h"
+
+#include <cstring>
+
+#include "core/framework/content_hasher.h"
+
+namespace onnxruntime {
+
+namespace {
+uint64_t HashTensorContent(MLDataType type, const TensorShape& shape, gsl::span<const uint8_t> data) {
+  ContentHasher hasher;
+  hasher.UpdateValue(type->AsPrimitiveDataType()->GetDataType());
+  hasher.UpdateValue(shape.NumDimensions());
+  for (const int64_t dim : shape.GetDims()) {
+    hasher.UpdateValue(dim);
+  }
+  hasher.Update(data.data(), data.size());
+  return hasher.Value();
+}
+
+bool HasContent(const Tensor& tensor, MLDataType type, const TensorShape& shape, gsl::span<const uint8_t> data) {
+  return tensor.DataType() == type && tensor.Shape() == shape && tensor.SizeInBytes() == data.size() &&
+         (data.empty() || std::memcmp(tensor.DataRaw(), data.data(), data.size()) == 0);
+}
+
+// The OrtValue holds a reference to the tensor of the store, which is released when the last copy of the OrtValue
+// is destroyed.
+OrtValue MakeOrtValue(std::shared_ptr<Tensor> tensor) {
+  Tensor* p_tensor = tensor.get();
+  OrtValue ort_value;
+  ort_value.Init(p_tensor, DataTypeImpl::GetType<Tensor>(),
+                 [tensor = std::move(tensor)](void*) mutable { tensor.reset(); });
+  return ort_value;
+}
+}  // namespace
+
+SharedInitializerStore::SharedInitializerStore() : allocator_(std::make_shared<CPUAllocator>()) {}
+
+OrtValue SharedInitializerStore::GetOrAdd(MLDataType type, const TensorShape& shape, gsl::span<const uint8_t> data,
+                                          bool& reused) {
+  const uint64_t hash = HashTensorContent(type, shape, data);
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto [begin, end] = tensors_.equal_range(hash);
+    for (auto it = begin; it != end;) {
+      if (auto tensor = it->second.lock()) {
+        if (HasContent(*tensor, type, shape, data)) {
+          reused = true;
+          return MakeOrtValue(std::move(tensor));
+        }
+        ++it;
+      } else {
+        it = tensors_.erase(it);
+      }
+    }
+  }
+
+  // copy the data outside of the lock. if another session adds the same tensor meanwhile both copies are used.
+  auto tensor = std::make_shared<Tensor>(type, shape, allocator_);
+  if (!data.empty()) {
+    std::memcpy(tensor->MutableDataRaw(), data.data(), data.size());
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    tensors_.emplace(hash, tensor);
+  }
+
+  reused = false;
+  return MakeOrtValue(std::move(tensor));
+}
+
+SharedInitializerStore::Stats SharedInitializerStore::GetStats() const {
+  Stats stats;
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (auto it = tensors_.begin(); it != tensors_.end();) {
+    auto tensor = it->second.lock();
+    if (!tensor) {
+      it = tensors_.erase(it);
+      continue;
+    }
+
+    // not counting the reference held by 'tensor'. it is the only one if the last session released the tensor since.
+    const auto num_references = static_cast<size_t>(tensor.use_count() - 1);
+    if (num_references == 0) {
+      ++it;
+      continue;
+    }
+
+    const size_t bytes = tensor->SizeInBytes();
+    ++stats.num_initializers;
+    stats.num_references += num_references;
+    stats.bytes += bytes;
+    stats.saved_bytes += (num_references - 1) * bytes;
+    ++it;
+  }
+  return stats;
+}
+
+}  // namespace onnxruntime
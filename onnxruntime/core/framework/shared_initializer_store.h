@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/tensor.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Content-addressed store of the CPU initializers of the sessions of an environment.
+ *
+ * Sessions that load the same initializer data, e.g. sessions created from the same model with different options,
+ * use a single copy of each tensor. Initializers are looked up by a hash of their type, shape and bytes after the
+ * graph is optimized, so constant-folded initializers are shared as well.
+ *
+ * The store does not own the tensors. Each session holds a reference, and a tensor is freed when the last session
+ * releases it, e.g. when its kernels have pre-packed it or when the session is destroyed.
+ */
+class SharedInitializerStore {
+ public:
+  SharedInitializerStore();
+
+  /**
+   * Get a CPU tensor with the given type, shape and data.
+   * @param reused Set to true if an identical tensor was already in the store, in which case no memory is allocated.
+   * @returns An OrtValue holding a reference to the tensor of the store.
+   */
+  OrtValue GetOrAdd(MLDataType type, const TensorShape& shape, gsl::span<const uint8_t> data, bool& reused);
+
+  struct Stats {
+    // Tensors in the store that are used by at least one session.
+    size_t num_initializers{0};
+    // Sum of the number of sessions using each tensor.
+    size_t num_references{0};
+    // Bytes of the tensors in the store.
+    size_t bytes{0};
+    // Bytes the sessions would allocate in addition if they did not share the tensors.
+    size_t saved_bytes{0};
+  };
+
+  Stats GetStats() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedInitializerStore);
+
+  AllocatorPtr allocator_;
+
+  mutable OrtMutex mutex_;
+  // Tensors by content hash. An entry expires when no session uses the tensor and is removed lazily.
+  mutable std::unordered_multimap<uint64_t, std::weak_ptr<Tensor>> tensors_;
+};
+
+}  // namespace onnxruntime
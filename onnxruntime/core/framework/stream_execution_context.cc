@@ -7,7 +7,18 @@
 #include "core/framework/session_state.h"
 #include "core/common/spin_pause.h"
 
+#include <algorithm>
+#include <optional>
+
 namespace onnxruntime {
+// Threads of the intra-op thread pool including the calling thread that the run started by the calling thread may
+// use, i.e. capped by the ScopedThreadLimit of the thread.
+static int IntraOpThreadsForRun(const SessionState& sess_state) {
+  const int pool_threads = concurrency::ThreadPool::NumThreadsIncludingCaller(sess_state.GetThreadPool());
+  const int run_thread_limit = concurrency::ThreadPool::CurrentThreadLimit();
+  return run_thread_limit > 0 ? std::min(pool_threads, run_thread_limit) : pool_threads;
+}
+
 #ifdef ORT_ENABLE_STREAM
 StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
                                                int32_t num_streams,
@@ -31,6 +42,10 @@ StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
              sess_state),
       logger_(&sess_logger),
       single_thread_mode_(single_thread_mode),
+      intra_op_threads_(IntraOpThreadsForRun(sess_state)),
+      run_thread_limit_(concurrency::ThreadPool::CurrentThreadLimit()),
+      intra_op_priority_(concurrency::ThreadPool::CurrentPriority()),
+      deadline_(concurrency::ThreadPool::CurrentDeadline()),
       device_stream_map_(device_stream_map),
       count_down_barriers_(num_barriers) {
   notifications_.reserve(notification_owners.size());
@@ -97,7 +112,11 @@ StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
              fetch_allocators,
              sess_state),
       logger_(&sess_logger),
-      single_thread_mode_(single_thread_mode) {
+      single_thread_mode_(single_thread_mode),
+      intra_op_threads_(IntraOpThreadsForRun(sess_state)),
+      run_thread_limit_(concurrency::ThreadPool::CurrentThreadLimit()),
+      intra_op_priority_(concurrency::ThreadPool::CurrentPriority()),
+      deadline_(concurrency::ThreadPool::CurrentDeadline()) {
 #ifdef _WIN32
 #pragma warning(push)
 #pragma warning(disable : 26409 26400)
@@ -139,6 +158,26 @@ const Status& StreamExecutionContext ::TaskStatus() const {
   return task_status_;
 }
 
+void StreamExecutionContext ::StartRunningStream() {
+  if (!single_thread_mode_) {
+    running_streams_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void StreamExecutionContext ::StopRunningStream() {
+  if (!single_thread_mode_) {
+    running_streams_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+int StreamExecutionContext ::GetIntraOpThreadLimit() const {
+  const int running_streams = running_streams_.load(std::memory_order_relaxed);
+  if (running_streams <= 1) {
+    return run_thread_limit_;
+  }
+  return std::max(1, intra_op_threads_ / running_streams);
+}
+
 void StreamExecutionContext ::CompleteTask() {
   remain_tasks_.Dec();
 }
@@ -173,32 +212,23 @@ void StreamExecutionContext::RecycleNodeInputs(onnxruntime::NodeIndex node_index
   }
 }
 
-void RunSince(size_t stream_idx, StreamExecutionContext& ctx, SessionScope& session_scope, const bool& terminate_flag, size_t since) {
-  if (!ctx.TaskStatus().IsOK()) {
-    // already in bad status, terminate it
-    ctx.CompleteTask();
-    return;
-  }
-
-#ifdef USE_CANN
-  // Leave it to CANN EP to fill the gap if they want to use run_options
-  static onnxruntime::RunOptions run_options;
-  // For CANN EP, it is necessary to explicitly create a corresponding Context for each thread in the thread pool,
-  // which is different from CUDA Runtime API, but similar to CUDA Driver API.
-  auto& execution_providers = ctx.GetSessionState().GetExecutionProviders();
-  for (auto& xp : execution_providers) {
-    auto status = xp->OnRunStart(run_options);
-    if (!status.IsOK()) {
-      ctx.SetStatus(status);
-      return;
-    }
-  }
-#endif
+static Status DeadlineExceededStatus(const StreamExecutionContext& ctx, const std::string& where) {
+  const auto overrun = std::chrono::steady_clock::now() - ctx.GetDeadline();
+  return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to the run deadline being exceeded by ",
+                         std::chrono::duration_cast<std::chrono::microseconds>(overrun).count(), " us ", where,
+                         ". ", ctx.CompletedSteps(), " steps of the run completed.");
+}
 
+// Run the steps of the stream from 'since' until the end, a step that fails or a barrier that is not reached yet.
+static void RunSteps(size_t stream_idx, StreamExecutionContext& ctx, SessionScope& session_scope,
+                     const bool& terminate_flag, size_t since) {
   // get logic stream
   auto& execution_plan = ctx.GetSessionState().GetExecutionPlan()->execution_plan;
   auto& logic_stream = execution_plan[stream_idx];
   size_t end = logic_stream->steps_.size();
+  // the stream may run on an inter-op thread, keep the intra-op priority and the deadline of the run
+  concurrency::ThreadPool::ScopedPriority intra_op_priority(ctx.GetIntraOpPriority());
+  concurrency::ThreadPool::ScopedDeadline deadline(ctx.GetDeadline());
 #ifdef ENABLE_TRAINING
   auto* range = ctx.GetCurrentRange();
   if (range)
@@ -207,18 +237,25 @@ void RunSince(size_t stream_idx, StreamExecutionContext& ctx, SessionScope& sess
 
   while (since < end) {
     if (!ctx.TaskStatus().IsOK()) {
-      ctx.CompleteTask();
       return;
     }
     if (terminate_flag) {
       Status status_made = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
       ctx.SetStatus(status_made);
-      ctx.CompleteTask();
+      return;
+    }
+    if (concurrency::ThreadPool::DeadlinePassed()) {
+      ctx.SetStatus(DeadlineExceededStatus(ctx, "before " + logic_stream->steps_[since]->ToString()));
       return;
     }
     bool continue_flag = true;
     Status status;
     ORT_TRY {
+      // kernels of streams running concurrently share the intra-op threads
+      std::optional<concurrency::ThreadPool::ScopedThreadLimit> thread_limit;
+      if (const int intra_op_thread_limit = ctx.GetIntraOpThreadLimit(); intra_op_thread_limit > 0) {
+        thread_limit.emplace(intra_op_thread_limit);
+      }
       status = logic_stream->steps_[since]->Execute(ctx, stream_idx, session_scope, terminate_flag, continue_flag);
     }
     ORT_CATCH(const std::exception& ex) {
@@ -229,19 +266,49 @@ void RunSince(size_t stream_idx, StreamExecutionContext& ctx, SessionScope& sess
     if (!status.IsOK()) {
       // terminate it
       ctx.SetStatus(status);
-      ctx.CompleteTask();
       return;
     }
+    ctx.StepCompleted();
     if (!continue_flag) {
       // break but not terminate
-      ctx.CompleteTask();
       return;
     }
     since++;
   }
   ORT_ENFORCE(since == end);
+  // kernels that poll the deadline give up early and leave their outputs incomplete
+  if (concurrency::ThreadPool::DeadlinePassed()) {
+    ctx.SetStatus(DeadlineExceededStatus(ctx, "at the end of stream " + std::to_string(stream_idx)));
+  }
+}
+
+void RunSince(size_t stream_idx, StreamExecutionContext& ctx, SessionScope& session_scope, const bool& terminate_flag, size_t since) {
+  if (!ctx.TaskStatus().IsOK()) {
+    // already in bad status, terminate it
+    ctx.CompleteTask();
+    return;
+  }
+
+#ifdef USE_CANN
+  // Leave it to CANN EP to fill the gap if they want to use run_options
+  static onnxruntime::RunOptions run_options;
+  // For CANN EP, it is necessary to explicitly create a corresponding Context for each thread in the thread pool,
+  // which is different from CUDA Runtime API, but similar to CUDA Driver API.
+  auto& execution_providers = ctx.GetSessionState().GetExecutionProviders();
+  for (auto& xp : execution_providers) {
+    auto status = xp->OnRunStart(run_options);
+    if (!status.IsOK()) {
+      ctx.SetStatus(status);
+      return;
+    }
+  }
+#endif
+
+  // the stream must stop running before the task completes, as the context may be destroyed right after
+  ctx.StartRunningStream();
+  RunSteps(stream_idx, ctx, session_scope, terminate_flag, since);
+  ctx.StopRunningStream();
   ctx.CompleteTask();
-  return;
 }
 
 void ScheduleDownstream(StreamExecutionContext& ctx, size_t trigger, bool single_thread_mode,
@@ -10,6 +10,7 @@
 #include "core/graph/basic_types.h"
 #include "core/common/inlined_containers.h"
 #include "core/framework/memory_info.h"
+#include "core/platform/threadpool.h"
 #ifdef ENABLE_TRAINING
 #include "core/framework/partial_graph_execution_state.h"
 #endif
@@ -100,6 +101,24 @@ class StreamExecutionContext {
   // return nullptr if the device of given logic sequence doesn't register stream support.
   Stream* GetDeviceStream(size_t idx);
 
+  // Track the streams that are executing steps, in multi-threads mode only.
+  void StartRunningStream();
+  void StopRunningStream();
+
+  // Maximum number of intra-op threads, including the calling thread, that a kernel should use so that the kernels
+  // of the streams running concurrently share the intra-op threads the run may use. 0 if there is no limit.
+  int GetIntraOpThreadLimit() const;
+
+  // Priority of the intra-op work of the run, that of the thread that created the context.
+  concurrency::ThreadPool::Priority GetIntraOpPriority() const { return intra_op_priority_; }
+
+  // Deadline of the run, that of the thread that created the context. time_point::max() if there is none.
+  std::chrono::steady_clock::time_point GetDeadline() const { return deadline_; }
+
+  // Count the steps that completed, reported when the run misses its deadline.
+  void StepCompleted() { completed_steps_.fetch_add(1, std::memory_order_relaxed); }
+  size_t CompletedSteps() const { return completed_steps_.load(std::memory_order_relaxed); }
+
   // Decrease the count of remaining job by 1.
   void CompleteTask();
 
@@ -171,6 +190,17 @@ class StreamExecutionContext {
 #endif
   const bool single_thread_mode_;
 
+  // Threads of the intra-op thread pool including the calling thread, and number of streams executing steps.
+  const int intra_op_threads_;
+  std::atomic_int running_streams_{0};
+
+  // ScopedThreadLimit, ScopedPriority and ScopedDeadline of the thread that created the context, applied to the
+  // threads running the streams.
+  const int run_thread_limit_;
+  const concurrency::ThreadPool::Priority intra_op_priority_;
+  const std::chrono::steady_clock::time_point deadline_;
+  std::atomic<size_t> completed_steps_{0};
+
 #ifdef ORT_ENABLE_STREAM
   InlinedVector<std::unique_ptr<synchronize::Notification>> notifications_;
   // if it is nullptr, means current session doesn't have any EP using stream feature
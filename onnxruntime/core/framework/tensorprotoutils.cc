@@ -956,7 +956,7 @@ static void DeleteCharArray(void* param) noexcept {
 
 #if !defined(__wasm__)
 static Status GetFileContent(const Env& env, const std::filesystem::path& file_path, FileOffsetType offset,
-                             size_t length, void*& raw_buffer, OrtCallback& deleter) {
+                             size_t length, void*& raw_buffer, OrtCallback& deleter, bool& is_mapped) {
   // query length if it is 0
   if (length == 0) {
     // The return type of std::filesystem::file_size is uintmax_t which could be bigger than size_t
@@ -970,6 +970,7 @@ static Status GetFileContent(const Env& env, const std::filesystem::path& file_p
     if (status.IsOK()) {
       deleter = mapped_memory.get_deleter().callback;
       raw_buffer = mapped_memory.release();
+      is_mapped = true;
       return Status::OK();
     }
   }
@@ -981,6 +982,7 @@ static Status GetFileContent(const Env& env, const std::filesystem::path& file_p
 
   deleter = OrtCallback{DeleteCharArray, buffer.get()};
   raw_buffer = buffer.release();
+  is_mapped = false;
   return Status::OK();
 }
 #endif
@@ -988,7 +990,7 @@ static Status GetFileContent(const Env& env, const std::filesystem::path& file_p
 Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& model_path,
                                  const ONNX_NAMESPACE::TensorProto& tensor_proto, void*& ext_data_buf,
                                  SafeInt<size_t>& ext_data_len, OrtCallback& ext_data_deleter,
-                                 Tensor* buffered_tensor) {
+                                 Tensor* buffered_tensor, bool* is_data_in_place) {
   ORT_ENFORCE(utils::HasExternalData(tensor_proto));
   std::basic_string<ORTCHAR_T> tensor_proto_dir;
   if (!model_path.empty()) {
@@ -1004,6 +1006,9 @@ Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& mo
     // the value in location is the memory address of the data
     ext_data_buf = reinterpret_cast<void*>(file_offset);
     ext_data_len = raw_data_safe_len;
+    if (is_data_in_place) {
+      *is_data_in_place = true;
+    }
     if (buffered_tensor) {
       ext_data_deleter = OrtCallback{[](void* p) noexcept { delete reinterpret_cast<Tensor*>(p); },
                                      reinterpret_cast<void*>(buffered_tensor)};
@@ -1021,6 +1026,9 @@ Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& mo
     ext_data_deleter = OrtCallback{DeleteCharArray, buffer.get()};
     ext_data_buf = buffer.release();
     ext_data_len = raw_data_safe_len;
+    if (is_data_in_place) {
+      *is_data_in_place = false;
+    }
 
     // In WebAssembly, try use a simplified preloaded file map in WebAssembly when available.
     auto err_code = EM_ASM_INT(({
@@ -1086,9 +1094,13 @@ Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& mo
                   "External initializer: ", tensor_proto.name(), " offset: ", file_offset,
                   " size to read: ", static_cast<size_t>(raw_data_safe_len), " given file_length: ", file_length,
                   " are out of bounds or can not be read in full.");
+    bool is_mapped = false;
     ORT_RETURN_IF_ERROR(GetFileContent(env, external_data_file_path.c_str(), file_offset, raw_data_safe_len,
-                                       ext_data_buf, ext_data_deleter));
+                                       ext_data_buf, ext_data_deleter, is_mapped));
     ext_data_len = raw_data_safe_len;
+    if (is_data_in_place) {
+      *is_data_in_place = is_mapped;
+    }
 #endif
   }
 
@@ -318,7 +318,9 @@ void BaseGroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceConte
 
 void GroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_key_index) {
   // TODO(aciddelgado): propagate output shapes depending if kv-share buffer is on or not
-  constexpr int use_max_past_present_buffer = -1;
+  // The present block pools of a paged k-v cache have the same shape as the past block pools.
+  constexpr int block_table_index = 9;
+  const int use_max_past_present_buffer = hasInputShape(ctx, block_table_index) ? 1 : -1;
   BaseGroupQueryAttentionTypeAndShapeInference(ctx, past_key_index, use_max_past_present_buffer);
 }
 
@@ -1049,6 +1051,11 @@ Supports different number of heads for q and kv for CPU and CUDA.
 Only supports causal and local attention.
 Supports rotary position embedding for CPU and CUDA.
 Supports packed input for CPU and CUDA.
+Supports paged k-v cache for CPU. When block_table is given, past_key and past_value are pools of fixed-size blocks
+with shape (num_blocks, kv_num_heads, block_size, head_size). The key and value of token t of sequence b are stored at
+row t % block_size of block block_table[b, t / block_size]. The blocks that the new tokens are written to shall not be
+shared with other sequences. present_key and present_value are the updated pools and shall share buffer with past_key
+and past_value to avoid copying the pools.
 )DOC";
 
 ONNX_MS_OPERATOR_SET_SCHEMA(
@@ -1119,6 +1126,12 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "2D tensor with shape (max_sequence_length, head_size / 2).",
                "T",
                OpSchema::Optional)
+        .Input(9,
+               "block_table",
+               "2D tensor with shape (batch_size, max_blocks_per_sequence). Block indices of each sequence in the "
+               "paged past_key and past_value.",
+               "M",
+               OpSchema::Optional)
         .Output(0,
                 "output",
                 "3D output tensor with shape (batch_size, sequence_length, hidden_size)",
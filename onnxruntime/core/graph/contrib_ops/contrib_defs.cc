@@ -631,6 +631,43 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           return true;
         }));
 
+constexpr const char* FusedElementwise_ver1_doc = R"DOC(
+Evaluates a chain of elementwise operators in a single pass over the output.
+The program is given by `ops`, executed in order. Each op reads two entries of
+`operands`: an index below the number of inputs refers to that input, and an
+index `num_inputs + k` refers to the result of op k. Unary ops use -1 as the
+second operand. The result of the last op is the output.
+The inputs are broadcast to the output with the multidirectional (Numpy-style)
+broadcasting rules, e.g. a scalar, a bias of shape (C) for an output of shape
+(N, S, C) or a per-channel bias of shape (C, 1, 1) for an output of shape
+(N, C, H, W).
+Supported ops: Add, Sub, Mul, Div, Max, Min, Relu, Sigmoid, Tanh, Exp, Erf, Neg,
+Abs, Sqrt and Reciprocal.)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    FusedElementwise, 1,
+    OpSchema()
+        .SetDomain(kMSDomain)
+        .SinceVersion(1)
+        .SetDoc(FusedElementwise_ver1_doc)
+        .Attr("ops", "The op types of the program in execution order.", AttributeProto::STRINGS)
+        .Attr("operands", "Two operand indices for each op in `ops`.", AttributeProto::INTS)
+        .Input(0, "inputs", "The input tensors referenced by the program.", "T", OpSchema::Variadic)
+        .Output(0, "Y", "The result of the last op.", "T")
+        .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          propagateElemTypeFromInputToOutput(ctx, 0, 0);
+          std::vector<const TensorShapeProto*> shapes;
+          for (size_t i = 0; i < ctx.getNumInputs(); ++i) {
+            if (!hasInputShape(ctx, i)) {
+              return;
+            }
+            shapes.push_back(&ctx.getInputType(i)->tensor_type().shape());
+          }
+          multidirectionalBroadcastShapeInference(
+              shapes, *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape());
+        }));
+
 // Used to be ONNX 1.7 Inverse(12)
 // Comment out docs not to increase the binary size
 //
@@ -2110,6 +2147,7 @@ Matrix product that behaves like numpy.matmul: https://docs.scipy.org/doc/numpy-
 
 constexpr const char* FusedMatMulActivation_doc = R"DOC(
 Executes the same operation as FusedMatMul, but also has an activation function fused to its output.
+When the optional inputs are given, the output is Y = activation(alpha * A * B + bias) + residual.
 )DOC";
 
 ONNX_MS_OPERATOR_SET_SCHEMA(TransposeMatMul, 1,
@@ -2168,6 +2206,10 @@ ONNX_MS_OPERATOR_SET_SCHEMA(FusedMatMulActivation, 1,
                             OpSchema()
                                 .Input(0, "A", "N-dimensional matrix A", "T")
                                 .Input(1, "B", "N-dimensional matrix B", "T")
+                                .Input(2, "bias", "1D bias with the size of the last dimension of Y, added before the activation",
+                                       "T", OpSchema::Optional)
+                                .Input(3, "residual", "Tensor with the shape of Y, added after the activation", "T",
+                                       OpSchema::Optional)
                                 .Attr("alpha", "Scalar multiplier for the product of the input tensors.", AttributeProto::FLOAT, 1.0f)
                                 .Attr("transA", "Whether A should be transposed on the last two dimensions before doing multiplication",
                                       AttributeProto::INT, static_cast<int64_t>(0))
@@ -9,6 +9,7 @@
 #include <numeric>
 #include <stack>
 #include <queue>
+#include <utility>
 
 #include "core/common/common.h"
 #include <gsl/gsl>
@@ -918,21 +919,29 @@ void Node::Init(std::string_view name,
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD) || defined(ORT_MINIMAL_BUILD_CUSTOM_OPS)
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
-Node::Definitions& Node::MutableDefinitions() noexcept {
+Node::Definitions& Node::MutableDefinitions() {
   // someone fetching these is going to change something
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  RecordChange();
   return definitions_;
 }
 
-Node::Relationships& Node::MutableRelationships() noexcept {
+Node::Relationships& Node::MutableRelationships() {
   // someone fetching these is going to change something
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  RecordChange();
   return relationships_;
 }
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 
+void Node::RecordChange() {
+  if (graph_) {
+    graph_->RecordNodeChange(index_);
+  }
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 void Node::CreateSubgraph(const std::string& attr_name) {
   auto attr = attributes_.find(attr_name);
@@ -952,6 +961,7 @@ void Node::AddAttributeProto(AttributeProto value) {
   if (graph_) {
     graph_->SetGraphResolveNeeded();
     graph_->SetGraphProtoSyncNeeded();
+    graph_->RecordNodeChange(index_);
   }
 }
 
@@ -999,6 +1009,7 @@ void Node::AddAttribute(std::string attr_name, GraphProto value) {
 bool Node::ClearAttribute(const std::string& attr_name) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  RecordChange();
   return attributes_.erase(attr_name) > 0;
 }
 
@@ -3274,6 +3285,12 @@ Status Graph::Resolve(const ResolveOptions& options) {
     return Status::OK();
   }
 
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+  // the edges and implicit inputs are rebuilt from the node definitions, whose changes were logged when made
+  std::vector<NodeIndex>* node_change_log = std::exchange(node_change_log_, nullptr);
+  auto restore_node_change_log = gsl::finally([this, node_change_log]() { node_change_log_ = node_change_log; });
+#endif
+
   // init all graph/subgraphs. non-recursive so call via ForThisAndAllSubgraphs.
   auto init_func = [](Graph& graph) { return graph.InitInputsInitializersOutputs(); };
   ORT_RETURN_IF_ERROR(ForThisAndAllSubgraphs(all_subgraphs, init_func));
@@ -4462,6 +4479,21 @@ bool Graph::SetOpSchemaFromRegistryForNode(Node& node) {
 }
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
+void Graph::RecordNodeChange(NodeIndex node_index) {
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+  if (parent_graph_ != nullptr) {
+    // a change in a subgraph is a change of the node that contains it
+    if (parent_node_ != nullptr) {
+      parent_graph_->RecordNodeChange(parent_node_->Index());
+    }
+  } else if (node_change_log_ != nullptr) {
+    node_change_log_->push_back(node_index);
+  }
+#else
+  ORT_UNUSED_PARAMETER(node_index);
+#endif
+}
+
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 Status Graph::PopulateNodeArgToProducerConsumerLookupsFromNodes() {
   node_arg_to_producer_node_.clear();
@@ -4490,6 +4522,7 @@ gsl::not_null<Node*> Graph::AllocateNode() {
   nodes_.push_back(std::move(new_node));
   ++num_of_nodes_;
   GraphResolveNeeded(true);
+  RecordNodeChange(node->Index());
 
   return gsl::not_null<Node*>{node};
 }
@@ -4502,6 +4535,16 @@ bool Graph::ReleaseNode(NodeIndex index) {
 
   // index is valid, but the entry may already be empty
   if (nodes_[index] != nullptr) {
+    // the neighbors of a removed node may now match a pattern that they did not match before
+    const Node& node = *nodes_[index];
+    for (auto it = node.InputNodesBegin(), end = node.InputNodesEnd(); it != end; ++it) {
+      RecordNodeChange(it->Index());
+    }
+    for (auto it = node.OutputNodesBegin(), end = node.OutputNodesEnd(); it != end; ++it) {
+      RecordNodeChange(it->Index());
+    }
+    RecordNodeChange(index);
+
     nodes_[index] = nullptr;
     --num_of_nodes_;
     GraphProtoSyncNeeded(true);
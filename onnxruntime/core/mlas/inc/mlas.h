@@ -21,6 +21,8 @@ Abstract:
 #include <cstdlib>
 #include <cstdint>
 
+#include "mlas_gemm_postprocessor.h"
+
 //
 // Define the calling convention for Windows targets.
 //
@@ -80,6 +82,10 @@ Abstract:
 #define MLAS_SUPPORTS_GEMM_DOUBLE
 #endif
 
+#if (defined(__aarch64__) && defined(__linux__)) || defined(MLAS_TARGET_AMD64)
+#define MLAS_SUPPORTS_SBGEMM
+#endif
+
 #if (!defined(_MSC_VER)) || (_MSC_VER >= 1930)
 #if defined(MLAS_TARGET_ARM64) || defined(MLAS_TARGET_ARM64EC)
 #if !defined(__APPLE__)
@@ -161,6 +167,9 @@ enum MLAS_ACTIVATION_KIND {
     MlasLogisticActivation,
     MlasClipActivation,
     MlasHardSigmoidActivation,
+    MlasGeluActivation,
+    MlasFastGeluActivation,
+    MlasSiluActivation,
     MlasActivationKindCount,
 };
 
@@ -178,6 +187,9 @@ struct MLAS_ACTIVATION {
             float alpha;
             float beta;
         } HardSigmoid;
+        struct {
+            float alpha;
+        } Silu;
         float Values[2];
     } Parameters;
 };
@@ -212,6 +224,46 @@ struct MLAS_SGEMM_DATA_PARAMS {
     float alpha = 1.0f;       /**< Supplies the scalar alpha multiplier (see SGEMM definition) */
     float beta = 0.0f;        /**< Supplies the scalar beta multiplier (see SGEMM definition) */
     bool BIsPacked = false;   /**< Whether B is pre-packed */
+    const MLAS_GEMM_POSTPROCESSOR<float>* OutputProcessor = nullptr; /**< Optional processor for each tile of C */
+};
+
+/**
+ * @brief Supply the operations applied to the result of a single precision GEMM
+ *
+ *     C = Activation(C + Bias) + Residual
+ *
+ * Residual and QuantizedOutput have the same layout as the GEMM output matrix.
+ */
+struct MLAS_SGEMM_EPILOGUE {
+    const float* Bias = nullptr;        /**< optional bias, vector size N, added to each row */
+    MLAS_ACTIVATION Activation{MlasIdentityActivation, {}}; /**< activation applied after the bias */
+    const float* Residual = nullptr;    /**< optional matrix added after the activation */
+    int8_t* QuantizedOutput = nullptr;  /**< optional result quantized to int8 */
+    float QuantizedScale = 1.0f;        /**< scale of QuantizedOutput */
+    int8_t QuantizedZeroPoint = 0;      /**< zero point of QuantizedOutput */
+};
+
+/**
+ * @brief Apply a GEMM epilogue to each tile of the output matrix while the tile
+ *        is still in the cache. Supply an instance as the OutputProcessor of
+ *        MLAS_SGEMM_DATA_PARAMS; the epilogue must outlive the GEMM call.
+ */
+class MLAS_SGEMM_EPILOGUE_PROCESSOR : public MLAS_GEMM_POSTPROCESSOR<float>
+{
+  public:
+    MLAS_SGEMM_EPILOGUE_PROCESSOR(const MLAS_SGEMM_EPILOGUE& Epilogue) : Epilogue_(Epilogue) {}
+
+    void Process(
+        float* C,
+        size_t StartM,
+        size_t StartN,
+        size_t CountM,
+        size_t CountN,
+        size_t ldc
+        ) const override;
+
+  private:
+    const MLAS_SGEMM_EPILOGUE& Epilogue_;
 };
 
 /**
@@ -754,6 +806,7 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
 #if defined(MLAS_TARGET_WASM_SCALAR)
     MlasConvAlgorithmDepthwise,
 #endif
@@ -786,6 +839,10 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t TileBlockCount;
+            const float* PackedFilter;
+        } Winograd;
     } u;
 };
 
@@ -819,6 +876,31 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Winograd convolution filter packing routines. MlasConvPrepare selects the
+// Winograd algorithm for suitable 3x3 convolutions; callers with constant
+// filters may transform them once and store the result in
+// MLAS_CONV_PARAMETERS::u.Winograd.PackedFilter before calling MlasConv.
+//
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount
+    );
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    );
+
 void
 MLASCALL
 MlasConvDepthwise(
@@ -1417,6 +1499,75 @@ MlasQLinearMul(
     bool IsScalarB
     );
 
+//
+// Layer normalization routines.
+//
+
+/**
+ * @brief Parameters for MlasLayerNorm and MlasRmsNorm. Each row of D elements
+ *        is normalized independently. The input row is first summed with the
+ *        optional skip and bias, and the normalized result is multiplied by
+ *        the scale and offset by the shift. The result can be written in the
+ *        input type, quantized to int8 or both.
+ */
+template <typename T>
+struct MLAS_LAYER_NORM_PARAMS {
+    const T* Input = nullptr;           /**< input rows, N x D */
+    const T* Skip = nullptr;            /**< optional residual, SkipRows x D. Row n adds row n % SkipRows */
+    size_t SkipRows = 0;                /**< number of rows of Skip */
+    const T* Bias = nullptr;            /**< optional bias added to each input row, D */
+    const T* Scale = nullptr;           /**< scale (gamma), D */
+    const T* Shift = nullptr;           /**< optional shift (beta), D. Not used by MlasRmsNorm */
+    T* Output = nullptr;                /**< optional normalized output, N x D */
+    T* SumOutput = nullptr;             /**< optional sum of the input, skip and bias, N x D */
+    int8_t* QuantizedOutput = nullptr;  /**< optional normalized output quantized to int8, N x D */
+    float QuantizedScale = 1.0f;        /**< scale of QuantizedOutput */
+    int8_t QuantizedZeroPoint = 0;      /**< zero point of QuantizedOutput */
+    float* Mean = nullptr;              /**< optional mean of each row, N. Not used by MlasRmsNorm */
+    float* InvStdDev = nullptr;         /**< optional inverse standard deviation (or root mean square) of each row, N */
+    float Epsilon = 0.0f;               /**< added to the variance (or mean square) */
+};
+
+/**
+ * @brief Layer normalization: Y = (X - mean(X)) / sqrt(var(X) + Epsilon) * Scale + Shift
+ *        where X is the sum of the input, skip and bias rows.
+ *
+ * @tparam T          float or MLAS_FP16. Statistics are always computed in float.
+ * @param Params      the buffers and options of the operation
+ * @param N           the number of rows
+ * @param D           the number of elements per row
+ * @param ThreadPool  the thread pool to use, else nullptr
+ */
+template <typename T>
+void
+MLASCALL
+MlasLayerNorm(
+    const MLAS_LAYER_NORM_PARAMS<T>& Params,
+    size_t N,
+    size_t D,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+/**
+ * @brief Root mean square normalization: Y = X / sqrt(mean(X * X) + Epsilon) * Scale
+ *        where X is the sum of the input, skip and bias rows.
+ *
+ * @tparam T          float or MLAS_FP16. Statistics are always computed in float.
+ * @param Params      the buffers and options of the operation. Shift and Mean are ignored.
+ * @param N           the number of rows
+ * @param D           the number of elements per row
+ * @param ThreadPool  the thread pool to use, else nullptr
+ */
+template <typename T>
+void
+MLASCALL
+MlasRmsNorm(
+    const MLAS_LAYER_NORM_PARAMS<T>& Params,
+    size_t N,
+    size_t D,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Half precision routines
 //
@@ -1428,6 +1579,9 @@ constexpr size_t FP16_SIZE = sizeof(uint16_t);
 
 /**
  * @brief Whether current CPU supports FP16 acceleration.
+ *
+ * On x64 this requires AVX2, FMA3 and F16C and only covers the half precision
+ * GEMM routines, the other FP16 routines are built for ARM64 only.
 */
 bool MLASCALL
 MlasFp16AccelerationSupported();
@@ -1634,9 +1788,13 @@ MlasHalfGemmConvertPackB(
     void* PackedB
     );
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SUPPORTS_SBGEMM)
 /**
  * @brief Whether current CPU supports Bfloat16(bf16) acceleration.
+ *
+ * On x64 this requires AVX512-BF16 or AMX-BF16. MlasSBGemmPackBSize returns
+ * non-zero if the SBGEMM routines are available, which may use an AVX2
+ * emulation of the bf16 dot products.
  */
 bool MLASCALL
 MlasBf16AccelerationSupported();
@@ -1845,10 +2003,33 @@ struct MlasFlashAttentionThreadedArgs {
     const float* key;
     const float* value;
     float* output;
+    //
+    // Optional fields. The defaults describe dense BxNxSxH query, key and value
+    // without masking.
+    //
+    // Number of key and value heads, each shared by num_heads / kv_num_heads
+    // query heads. 0 means num_heads.
+    int kv_num_heads = 0;
+    // Sequence length of the key and value buffers of each head. 0 means
+    // kv_sequence_length.
+    int kv_buffer_sequence_length = 0;
+    // Elements between batches of query, and of key and value. 0 means dense.
+    size_t q_batch_stride = 0;
+    size_t kv_batch_stride = 0;
+    // Number of valid keys of each batch. nullptr means kv_sequence_length.
+    const int* kv_sequence_lengths = nullptr;
+    // Causal mask: query i of batch b attends to keys j <= past_sequence_lengths[b] + i.
+    // nullptr past_sequence_lengths means the number of valid keys - q_sequence_length.
+    bool is_causal = false;
+    const int* past_sequence_lengths = nullptr;
+    // When positive, the query at position p only attends to keys j >= p - local_window_size.
+    int local_window_size = -1;
 };
 
 /**
- * @brief Per-thread worker function for fp32 Flash Attention
+ * @brief Per-thread worker function for fp32 Flash Attention. Supports grouped
+ *        query attention, causal and sliding window masks and per-batch key
+ *        lengths, so that the score matrix is never materialized.
  * @param thread_id    Thread index
  * @param args         Arguments
  * @return
@@ -406,6 +406,216 @@ Return Value:
     }
 }
 
+//
+// Templates for activation functions of the form Value * Gate(Value), where
+// the gate is computed with one of the vectorized transcendental routines:
+//
+//     Gate(Value) = GateBias + GateScale * Transcendental(Prepare(Value))
+//
+
+template<MLAS_ACTIVATION_KIND ActivationKind>
+struct MLAS_GATED_ACTIVATION_FUNCTION;
+
+template<>
+struct MLAS_GATED_ACTIVATION_FUNCTION<MlasGeluActivation>
+{
+    //
+    // Gelu(x) = x * 0.5 * (1 + erf(x / sqrt(2)))
+    //
+
+    static constexpr float InputScale = 0.70710678118654752f;
+    static constexpr float GateBias = 0.5f;
+    static constexpr float GateScale = 0.5f;
+
+    const MLAS_FLOAT32X4 InputScaleBroadcast = MlasBroadcastFloat32x4(InputScale);
+
+    MLAS_GATED_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation)
+    {
+        MLAS_UNREFERENCED_PARAMETER(Activation);
+    }
+
+    MLAS_FLOAT32X4 Prepare(MLAS_FLOAT32X4 Value)
+    {
+        return MlasMultiplyFloat32x4(Value, InputScaleBroadcast);
+    }
+
+    float Prepare(float Value)
+    {
+        return Value * InputScale;
+    }
+
+    void Compute(float* Buffer, size_t N)
+    {
+        MlasComputeErf(Buffer, Buffer, N);
+    }
+};
+
+template<>
+struct MLAS_GATED_ACTIVATION_FUNCTION<MlasFastGeluActivation>
+{
+    //
+    // FastGelu(x) = x * 0.5 * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+    //
+
+    static constexpr float LinearScale = 0.79788456080286536f;
+    static constexpr float CubicScale = 0.79788456080286536f * 0.044715f;
+    static constexpr float GateBias = 0.5f;
+    static constexpr float GateScale = 0.5f;
+
+    const MLAS_FLOAT32X4 LinearScaleBroadcast = MlasBroadcastFloat32x4(LinearScale);
+    const MLAS_FLOAT32X4 CubicScaleBroadcast = MlasBroadcastFloat32x4(CubicScale);
+
+    MLAS_GATED_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation)
+    {
+        MLAS_UNREFERENCED_PARAMETER(Activation);
+    }
+
+    MLAS_FLOAT32X4 Prepare(MLAS_FLOAT32X4 Value)
+    {
+        MLAS_FLOAT32X4 Square = MlasMultiplyFloat32x4(Value, Value);
+        return MlasMultiplyFloat32x4(Value, MlasMultiplyAddFloat32x4(Square, CubicScaleBroadcast, LinearScaleBroadcast));
+    }
+
+    float Prepare(float Value)
+    {
+        return Value * (Value * Value * CubicScale + LinearScale);
+    }
+
+    void Compute(float* Buffer, size_t N)
+    {
+        MlasComputeTanh(Buffer, Buffer, N);
+    }
+};
+
+template<>
+struct MLAS_GATED_ACTIVATION_FUNCTION<MlasSiluActivation>
+{
+    //
+    // Silu(x) = x * sigmoid(alpha * x)
+    //
+
+    static constexpr float GateBias = 0.0f;
+    static constexpr float GateScale = 1.0f;
+
+    float Alpha;
+    MLAS_FLOAT32X4 AlphaBroadcast;
+
+    MLAS_GATED_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation)
+    {
+        Alpha = Activation->Parameters.Silu.alpha;
+        AlphaBroadcast = MlasBroadcastFloat32x4(Alpha);
+    }
+
+    MLAS_FLOAT32X4 Prepare(MLAS_FLOAT32X4 Value)
+    {
+        return MlasMultiplyFloat32x4(Value, AlphaBroadcast);
+    }
+
+    float Prepare(float Value)
+    {
+        return Value * Alpha;
+    }
+
+    void Compute(float* Buffer, size_t N)
+    {
+        MlasComputeLogistic(Buffer, Buffer, N);
+    }
+};
+
+template<MLAS_ACTIVATION_KIND ActivationKind>
+void
+MlasGatedActivationKernel(
+    const MLAS_ACTIVATION* Activation,
+    float* Buffer,
+    const float* Bias,
+    size_t M,
+    size_t N,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine steps over the output matrix and applies a gated activation
+    function. The gate of each row is computed a chunk at a time into a local
+    buffer that stays in the L1 cache.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation.
+
+    Buffer - Supplies the output matrix.
+
+    Bias - Supplies the optional bias vector.
+
+    M - Supplies the number of elements of the bias vector and the number of
+        rows in the output matrix.
+
+    N - Supplies the number of columns of the output matrix.
+
+    ldc - Supplies the number of elements per row of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t ChunkSize = 256;
+
+    MLAS_GATED_ACTIVATION_FUNCTION<ActivationKind> ActivationFunction(Activation);
+
+    const float GateBias = ActivationFunction.GateBias;
+    const float GateScale = ActivationFunction.GateScale;
+    const MLAS_FLOAT32X4 GateBiasBroadcast = MlasBroadcastFloat32x4(GateBias);
+    const MLAS_FLOAT32X4 GateScaleBroadcast = MlasBroadcastFloat32x4(GateScale);
+
+    MLAS_DECLSPEC_ALIGN(float Gate[ChunkSize], 16 * sizeof(float));
+
+    if (Bias != nullptr) {
+        MlasActivationKernel<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+    }
+
+    //
+    // Step through each row of the output matrix.
+    //
+
+    while (M-- > 0) {
+
+        size_t CountN;
+
+        for (size_t n = 0; n < N; n += CountN) {
+
+            CountN = std::min(N - n, ChunkSize);
+
+            float* buffer = Buffer + n;
+            size_t i = 0;
+
+            for (; i + 4 <= CountN; i += 4) {
+                MlasStoreFloat32x4(&Gate[i], ActivationFunction.Prepare(MlasLoadFloat32x4(&buffer[i])));
+            }
+
+            for (; i < CountN; i++) {
+                Gate[i] = ActivationFunction.Prepare(buffer[i]);
+            }
+
+            ActivationFunction.Compute(Gate, CountN);
+
+            for (i = 0; i + 4 <= CountN; i += 4) {
+                MLAS_FLOAT32X4 GateVector =
+                    MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(&Gate[i]), GateScaleBroadcast, GateBiasBroadcast);
+                MlasStoreFloat32x4(&buffer[i], MlasMultiplyFloat32x4(MlasLoadFloat32x4(&buffer[i]), GateVector));
+            }
+
+            for (; i < CountN; i++) {
+                buffer[i] *= Gate[i] * GateScale + GateBias;
+            }
+        }
+
+        Buffer += ldc;
+    }
+}
+
 void
 MLASCALL
 MlasActivation(
@@ -512,6 +722,24 @@ Return Value:
             break;
         }
 
+        case MlasGeluActivation:
+        {
+            MlasGatedActivationKernel<MlasGeluActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
+        case MlasFastGeluActivation:
+        {
+            MlasGatedActivationKernel<MlasFastGeluActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
+        case MlasSiluActivation:
+        {
+            MlasGatedActivationKernel<MlasSiluActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
         case MlasActivationKindCount:
         {
             MLAS_THROW_EX(std::runtime_error, "bad mlas activation kind");
@@ -519,3 +747,92 @@ Return Value:
         }
     }
 }
+
+MLAS_FORCEINLINE
+void
+MlasEpilogueAddKernel(
+    float* Buffer,
+    const float* Addend,
+    size_t N
+    )
+{
+    while (N >= 4) {
+        MlasStoreFloat32x4(Buffer, MlasAddFloat32x4(MlasLoadFloat32x4(Buffer), MlasLoadFloat32x4(Addend)));
+        Buffer += 4;
+        Addend += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+        *Buffer++ += *Addend++;
+        N -= 1;
+    }
+}
+
+void
+MLAS_SGEMM_EPILOGUE_PROCESSOR::Process(
+    float* C,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc
+    ) const
+/*++
+
+Routine Description:
+
+    This routine applies the GEMM epilogue to a tile of the output matrix. The
+    tile is processed one row at a time so that each row stays in the L1 cache
+    through all of the operations.
+
+Arguments:
+
+    C - Supplies the address of the output matrix.
+
+    StartM - Supplies the first row of the tile.
+
+    StartN - Supplies the first column of the tile.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+    ldc - Supplies the first dimension of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_SGEMM_EPILOGUE& Epilogue = Epilogue_;
+    const size_t Offset = StartM * ldc + StartN;
+
+    float* Output = C + Offset;
+    const float* Bias = (Epilogue.Bias != nullptr) ? Epilogue.Bias + StartN : nullptr;
+    const float* Residual = (Epilogue.Residual != nullptr) ? Epilogue.Residual + Offset : nullptr;
+    int8_t* QuantizedOutput = (Epilogue.QuantizedOutput != nullptr) ? Epilogue.QuantizedOutput + Offset : nullptr;
+
+    while (CountM-- > 0) {
+
+        if (Bias != nullptr) {
+            MlasEpilogueAddKernel(Output, Bias, CountN);
+        }
+
+        MlasActivation(&Epilogue.Activation, Output, nullptr, 1, CountN, CountN);
+
+        if (Residual != nullptr) {
+            MlasEpilogueAddKernel(Output, Residual, CountN);
+            Residual += ldc;
+        }
+
+        if (QuantizedOutput != nullptr) {
+            MlasQuantizeLinear<int8_t>(Output, QuantizedOutput, CountN, Epilogue.QuantizedScale,
+                Epilogue.QuantizedZeroPoint);
+            QuantizedOutput += ldc;
+        }
+
+        Output += ldc;
+    }
+}
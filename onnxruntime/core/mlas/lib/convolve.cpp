@@ -903,6 +903,18 @@ Return Value:
         return;
     }
 
+    //
+    // The Winograd algorithm schedules tiles from all batches and groups
+    // across multiple threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmWinograd) {
+
+        MlasConvWinograd(Parameters, Input, Filter, Bias, WorkingBuffer, Output, ThreadPool);
+
+        return;
+    }
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
     if (Algorithm == MlasConvAlgorithmDepthwise) {
@@ -1002,6 +1014,15 @@ Return Value:
 
                     break;
                 }
+
+                case MlasConvAlgorithmWinograd:
+                {
+                    //
+                    // Handled above for all batches and groups.
+                    //
+
+                    break;
+                }
             }
 
             //
@@ -1211,6 +1232,14 @@ Return Value:
         }
     }
 
+    //
+    // Detect 3x3 convolutions that benefit from the Winograd algorithm.
+    //
+
+    if (MlasConvWinogradPrepare(Parameters, WorkingBufferSize, ThreadPool)) {
+        return;
+    }
+
     if (FilterCount > OutputSize) {
 
         //
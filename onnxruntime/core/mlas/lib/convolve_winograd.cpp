@@ -0,0 +1,773 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convolve_winograd.cpp
+
+Abstract:
+
+    This module implements the single precision convolution operation for
+    3x3 kernels with unit stride and dilation using the Winograd F(2x2,3x3)
+    minimal filtering algorithm.
+
+    Each 2x2 output tile is computed from a 4x4 input tile. The input tiles
+    and the filters are transformed to the Winograd domain, where the
+    convolution becomes 16 independent matrix multiplications that reduce over
+    the input channels. The products are then transformed back to 2x2 output
+    tiles. This performs 2.25 times fewer multiplications than the direct
+    method for the price of the transforms.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of elements in a transformed 4x4 tile.
+//
+
+#define MLAS_WINOGRAD_TILE_ELEMENTS 16
+
+//
+// Define the target number of working buffer elements used per thread for the
+// transformed input tiles and the intermediate products. The tile block count
+// is chosen so that both fit in the per-core cache.
+//
+
+#define MLAS_WINOGRAD_WORKING_ELEMENTS_PER_THREAD (64 * 1024)
+
+//
+// Define the bounds for the number of tiles transformed per block. The lower
+// bound keeps the GEMM N dimension a multiple of the SGEMM kernel width.
+//
+
+#define MLAS_WINOGRAD_MINIMUM_TILE_BLOCK 16
+#define MLAS_WINOGRAD_MAXIMUM_TILE_BLOCK 256
+
+//
+// Define the parameters to execute blocks of tiles on worker threads.
+//
+
+struct MLAS_CONV_WINOGRAD_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const float* TransformedFilter;
+    const float* Bias;
+    float* WorkingBuffer;
+    float* Output;
+    ptrdiff_t TargetThreadCount;
+};
+
+static
+void
+MlasConvWinogradTransformFilter(
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* TransformedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the 3x3 filters of one group to the Winograd
+    domain by computing G * g * G^T for each filter and input channel.
+
+Arguments:
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+    Filter - Supplies the filters for the group in [F][C][3][3] order.
+
+    TransformedFilter - Supplies the buffer that receives the transformed
+        filters in [16][F][C] order.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t TransformStride = FilterCount * InputChannels;
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        for (size_t c = 0; c < InputChannels; c++) {
+
+            const float* g = Filter + (f * InputChannels + c) * 9;
+
+            //
+            // Compute t = G * g.
+            //
+
+            float t[4][3];
+
+            for (size_t j = 0; j < 3; j++) {
+                t[0][j] = g[j];
+                t[1][j] = 0.5f * (g[j] + g[3 + j] + g[6 + j]);
+                t[2][j] = 0.5f * (g[j] - g[3 + j] + g[6 + j]);
+                t[3][j] = g[6 + j];
+            }
+
+            //
+            // Compute u = t * G^T and scatter the elements to the transformed
+            // filter matrices.
+            //
+
+            float* u = TransformedFilter + f * InputChannels + c;
+
+            for (size_t i = 0; i < 4; i++) {
+                u[(i * 4 + 0) * TransformStride] = t[i][0];
+                u[(i * 4 + 1) * TransformStride] = 0.5f * (t[i][0] + t[i][1] + t[i][2]);
+                u[(i * 4 + 2) * TransformStride] = 0.5f * (t[i][0] - t[i][1] + t[i][2]);
+                u[(i * 4 + 3) * TransformStride] = t[i][2];
+            }
+        }
+    }
+}
+
+static
+void
+MlasConvWinogradTransformInput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    float* TransformedInput,
+    size_t TileBlockCount,
+    size_t TileStart,
+    size_t TileCount
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a block of 4x4 input tiles to the Winograd domain
+    by computing B^T * d * B for each tile and input channel. Elements of the
+    tile that fall in the padding area are treated as zero.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor for the batch and group.
+
+    TransformedInput - Supplies the buffer that receives the transformed
+        tiles in [16][C][TileBlockCount] order.
+
+    TileBlockCount - Supplies the leading dimension of the transformed tiles.
+
+    TileStart - Supplies the index of the first tile of the block.
+
+    TileCount - Supplies the number of tiles in the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t TilesW = (Parameters->OutputShape[1] + 1) / 2;
+
+    const size_t TransformStride = InputChannels * TileBlockCount;
+
+    for (size_t c = 0; c < InputChannels; c++) {
+
+        const float* input = Input + c * InputSize;
+
+        for (size_t t = 0; t < TileCount; t++) {
+
+            const size_t tile = TileStart + t;
+            const size_t ih0 = (tile / TilesW) * 2 - PaddingTop;
+            const size_t iw0 = (tile % TilesW) * 2 - PaddingLeft;
+
+            //
+            // Gather the 4x4 input tile. The unsigned arithmetic wraps for
+            // elements in the leading padding area so a single comparison
+            // against the input shape detects both edges.
+            //
+
+            float d[4][4];
+
+            if (ih0 < InputHeight && InputHeight - ih0 >= 4 &&
+                iw0 < InputWidth && InputWidth - iw0 >= 4) {
+
+                const float* row = input + ih0 * InputWidth + iw0;
+
+                for (size_t i = 0; i < 4; i++) {
+                    d[i][0] = row[0];
+                    d[i][1] = row[1];
+                    d[i][2] = row[2];
+                    d[i][3] = row[3];
+                    row += InputWidth;
+                }
+
+            } else {
+
+                for (size_t i = 0; i < 4; i++) {
+                    const size_t ih = ih0 + i;
+                    for (size_t j = 0; j < 4; j++) {
+                        const size_t iw = iw0 + j;
+                        d[i][j] = (ih < InputHeight && iw < InputWidth) ?
+                            input[ih * InputWidth + iw] : 0.0f;
+                    }
+                }
+            }
+
+            //
+            // Compute s = B^T * d.
+            //
+
+            float s[4][4];
+
+            for (size_t j = 0; j < 4; j++) {
+                s[0][j] = d[0][j] - d[2][j];
+                s[1][j] = d[1][j] + d[2][j];
+                s[2][j] = d[2][j] - d[1][j];
+                s[3][j] = d[1][j] - d[3][j];
+            }
+
+            //
+            // Compute v = s * B and scatter the elements to the transformed
+            // input matrices.
+            //
+
+            float* v = TransformedInput + c * TileBlockCount + t;
+
+            for (size_t i = 0; i < 4; i++) {
+                v[(i * 4 + 0) * TransformStride] = s[i][0] - s[i][2];
+                v[(i * 4 + 1) * TransformStride] = s[i][1] + s[i][2];
+                v[(i * 4 + 2) * TransformStride] = s[i][2] - s[i][1];
+                v[(i * 4 + 3) * TransformStride] = s[i][1] - s[i][3];
+            }
+        }
+    }
+}
+
+static
+void
+MlasConvWinogradTransformOutput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* TransformedOutput,
+    float* Output,
+    size_t TileBlockCount,
+    size_t TileStart,
+    size_t TileCount
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a block of products from the Winograd domain to
+    2x2 output tiles by computing A^T * m * A for each tile and filter. Output
+    tiles are clipped at the bottom and right edges of the output.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    TransformedOutput - Supplies the products in [16][F][TileBlockCount]
+        order.
+
+    Output - Supplies the output tensor for the batch and group.
+
+    TileBlockCount - Supplies the leading dimension of the products.
+
+    TileStart - Supplies the index of the first tile of the block.
+
+    TileCount - Supplies the number of tiles in the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t TilesW = (OutputWidth + 1) / 2;
+    const float Beta = Parameters->Beta;
+
+    const size_t TransformStride = FilterCount * TileBlockCount;
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        float* output = Output + f * OutputSize;
+
+        for (size_t t = 0; t < TileCount; t++) {
+
+            const float* m = TransformedOutput + f * TileBlockCount + t;
+
+            //
+            // Compute s = A^T * m.
+            //
+
+            float s[2][4];
+
+            for (size_t j = 0; j < 4; j++) {
+                const float m0 = m[(0 * 4 + j) * TransformStride];
+                const float m1 = m[(1 * 4 + j) * TransformStride];
+                const float m2 = m[(2 * 4 + j) * TransformStride];
+                const float m3 = m[(3 * 4 + j) * TransformStride];
+                s[0][j] = m0 + m1 + m2;
+                s[1][j] = m1 - m2 - m3;
+            }
+
+            //
+            // Compute y = s * A and store the tile.
+            //
+
+            float y[2][2];
+
+            for (size_t i = 0; i < 2; i++) {
+                y[i][0] = s[i][0] + s[i][1] + s[i][2];
+                y[i][1] = s[i][1] - s[i][2] - s[i][3];
+            }
+
+            const size_t tile = TileStart + t;
+            const size_t oh0 = (tile / TilesW) * 2;
+            const size_t ow0 = (tile % TilesW) * 2;
+
+            for (size_t i = 0; i < 2 && oh0 + i < OutputHeight; i++) {
+                float* row = output + (oh0 + i) * OutputWidth + ow0;
+                for (size_t j = 0; j < 2 && ow0 + j < OutputWidth; j++) {
+                    row[j] = (Beta == 0.0f) ? y[i][j] : y[i][j] + Beta * row[j];
+                }
+            }
+        }
+    }
+}
+
+static
+void
+MlasConvWinogradActivation(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    float* Output,
+    const float* Bias,
+    size_t TileStart,
+    size_t TileCount
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the activation with optional bias to the output
+    elements covered by a block of tiles. Runs of complete tile rows map to a
+    contiguous range of the output and are handled with a single call.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Output - Supplies the output tensor for the batch and group.
+
+    Bias - Optionally supplies the bias vector for the group.
+
+    TileStart - Supplies the index of the first tile of the block.
+
+    TileCount - Supplies the number of tiles in the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t TilesW = (OutputWidth + 1) / 2;
+
+    size_t th = TileStart / TilesW;
+    size_t tw = TileStart % TilesW;
+
+    while (TileCount > 0) {
+
+        if (tw == 0 && TileCount >= TilesW) {
+
+            const size_t RowCount = TileCount / TilesW;
+            const size_t oh0 = th * 2;
+            const size_t oh1 = std::min(oh0 + RowCount * 2, OutputHeight);
+
+            MlasActivation(Parameters->Activation, Output + oh0 * OutputWidth, Bias,
+                FilterCount, (oh1 - oh0) * OutputWidth, OutputSize);
+
+            th += RowCount;
+            TileCount -= RowCount * TilesW;
+            continue;
+        }
+
+        const size_t CountW = std::min(TilesW - tw, TileCount);
+        const size_t ow0 = tw * 2;
+        const size_t ow1 = std::min(ow0 + CountW * 2, OutputWidth);
+
+        for (size_t oh = th * 2; oh < th * 2 + 2 && oh < OutputHeight; oh++) {
+            MlasActivation(Parameters->Activation, Output + oh * OutputWidth + ow0, Bias,
+                FilterCount, ow1 - ow0, OutputSize);
+        }
+
+        th++;
+        tw = 0;
+        TileCount -= CountW;
+    }
+}
+
+static
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute the blocks of
+    tiles assigned to the thread.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t TileBlockCount = Parameters->u.Winograd.TileBlockCount;
+    const size_t TileTotal =
+        ((Parameters->OutputShape[0] + 1) / 2) * ((Parameters->OutputShape[1] + 1) / 2);
+    const size_t BlockCount = (TileTotal + TileBlockCount - 1) / TileBlockCount;
+
+    const size_t InputGroupSize = InputChannels * Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * Parameters->OutputSize;
+    const size_t FilterGroupSize = MLAS_WINOGRAD_TILE_ELEMENTS * FilterCount * InputChannels;
+    const size_t TransformedInputSize = MLAS_WINOGRAD_TILE_ELEMENTS * InputChannels * TileBlockCount;
+    const size_t TransformedOutputSize = MLAS_WINOGRAD_TILE_ELEMENTS * FilterCount * TileBlockCount;
+
+    float* TransformedInput =
+        WorkBlock->WorkingBuffer + Index * (TransformedInputSize + TransformedOutputSize);
+    float* TransformedOutput = TransformedInput + TransformedInputSize;
+
+    //
+    // Compute the range of tile blocks to use for this thread.
+    //
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount,
+        Parameters->BatchCount * GroupCount * BlockCount, &WorkIndex, &WorkRemaining);
+
+    while (WorkRemaining > 0) {
+
+        const size_t bg = WorkIndex / BlockCount;
+        const size_t group = bg % GroupCount;
+
+        const size_t TileStart = (WorkIndex % BlockCount) * TileBlockCount;
+        const size_t TileCount = std::min(TileBlockCount, TileTotal - TileStart);
+
+        const float* input = WorkBlock->Input + bg * InputGroupSize;
+        const float* filter = WorkBlock->TransformedFilter + group * FilterGroupSize;
+        float* output = WorkBlock->Output + bg * OutputGroupSize;
+
+        MlasConvWinogradTransformInput(Parameters, input, TransformedInput,
+            TileBlockCount, TileStart, TileCount);
+
+        //
+        // Multiply the transformed filters by the transformed input tiles for
+        // each of the tile elements.
+        //
+
+        for (size_t e = 0; e < MLAS_WINOGRAD_TILE_ELEMENTS; e++) {
+            MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, TileCount,
+                InputChannels, 1.0f, filter + e * FilterCount * InputChannels,
+                InputChannels, TransformedInput + e * InputChannels * TileBlockCount,
+                TileBlockCount, 0.0f, TransformedOutput + e * FilterCount * TileBlockCount,
+                TileBlockCount);
+        }
+
+        MlasConvWinogradTransformOutput(Parameters, TransformedOutput, output,
+            TileBlockCount, TileStart, TileCount);
+
+        //
+        // Apply the activation with optional bias.
+        //
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group * FilterCount;
+        }
+
+        MlasConvWinogradActivation(Parameters, output, bias, TileStart, TileCount);
+
+        WorkIndex++;
+        WorkRemaining--;
+    }
+}
+
+bool
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine determines whether the convolution described by the
+    parameters should use the Winograd algorithm and if so, computes the tile
+    blocking and the required working buffer size.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer for intermediate results.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the Winograd algorithm was selected, else false.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+
+    if (Parameters->Dimensions != 2 ||
+        Parameters->KernelShape[0] != 3 || Parameters->KernelShape[1] != 3 ||
+        Parameters->StrideShape[0] != 1 || Parameters->StrideShape[1] != 1 ||
+        Parameters->DilationShape[0] != 1 || Parameters->DilationShape[1] != 1) {
+        return false;
+    }
+
+    //
+    // The transforms cost O(C + F) per tile while the multiplications saved
+    // are O(C * F) per tile, so skip narrow layers. Small outputs also leave
+    // too few tiles to amortize the filter transform.
+    //
+
+    if (InputChannels < 16 || FilterCount < 16 || Parameters->OutputSize < 64) {
+        return false;
+    }
+
+    const size_t TileTotal =
+        ((Parameters->OutputShape[0] + 1) / 2) * ((Parameters->OutputShape[1] + 1) / 2);
+
+    //
+    // Size the tile block so that the transformed input tiles and the
+    // intermediate products for one block fit in the per-thread target.
+    //
+
+    size_t TileBlockCount = MLAS_WINOGRAD_WORKING_ELEMENTS_PER_THREAD /
+        (MLAS_WINOGRAD_TILE_ELEMENTS * (InputChannels + FilterCount));
+
+    TileBlockCount &= ~size_t(MLAS_WINOGRAD_MINIMUM_TILE_BLOCK - 1);
+    TileBlockCount = std::max<size_t>(TileBlockCount, MLAS_WINOGRAD_MINIMUM_TILE_BLOCK);
+    TileBlockCount = std::min<size_t>(TileBlockCount, MLAS_WINOGRAD_MAXIMUM_TILE_BLOCK);
+    TileBlockCount = std::min(TileBlockCount, TileTotal);
+
+    const size_t BlockCount = (TileTotal + TileBlockCount - 1) / TileBlockCount;
+    const size_t WorkCount = Parameters->BatchCount * Parameters->GroupCount * BlockCount;
+
+    ptrdiff_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(TargetThreadCount) >= WorkCount) {
+        TargetThreadCount = ptrdiff_t(WorkCount);
+    }
+
+    Parameters->Algorithm = MlasConvAlgorithmWinograd;
+    Parameters->ThreadCount = TargetThreadCount;
+    Parameters->u.Winograd.TileBlockCount = TileBlockCount;
+    Parameters->u.Winograd.PackedFilter = nullptr;
+
+    //
+    // The working buffer holds the transformed filters for all groups
+    // followed by the per-thread transformed tiles and products. The filter
+    // area is unused if the caller supplies pre-transformed filters.
+    //
+
+    *WorkingBufferSize = Parameters->GroupCount * MLAS_WINOGRAD_TILE_ELEMENTS * FilterCount * InputChannels +
+        size_t(TargetThreadCount) * MLAS_WINOGRAD_TILE_ELEMENTS * (InputChannels + FilterCount) * TileBlockCount;
+
+    return true;
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution operation using the Winograd
+    algorithm.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor. This is ignored if the parameters
+        reference filters pre-transformed by MlasConvWinogradPackFilter.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t FilterGroupSize =
+        MLAS_WINOGRAD_TILE_ELEMENTS * Parameters->FilterCount * Parameters->InputChannels;
+
+    const float* TransformedFilter = Parameters->u.Winograd.PackedFilter;
+
+    if (TransformedFilter == nullptr) {
+
+        MlasConvWinogradPackFilter(GroupCount, Parameters->InputChannels,
+            Parameters->FilterCount, Filter, WorkingBuffer);
+
+        TransformedFilter = WorkingBuffer;
+    }
+
+    MLAS_CONV_WINOGRAD_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.TransformedFilter = TransformedFilter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer + GroupCount * FilterGroupSize;
+    WorkBlock.Output = Output;
+    WorkBlock.TargetThreadCount = Parameters->ThreadCount;
+
+    MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock, WorkBlock.TargetThreadCount, ThreadPool);
+}
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of bytes required to store the filters
+    transformed by MlasConvWinogradPackFilter.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+Return Value:
+
+    Returns the size in bytes of the transformed filters.
+
+--*/
+{
+    return GroupCount * MLAS_WINOGRAD_TILE_ELEMENTS * FilterCount * InputChannels * sizeof(float);
+}
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms 3x3 filters to the Winograd domain so that the
+    transform can be done once for constant weights and supplied to MlasConv
+    through the Winograd parameters.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+    Filter - Supplies the filter tensor in [G*F][C][3][3] order.
+
+    PackedFilter - Supplies the buffer that receives the transformed filters.
+        The buffer must be sized by MlasConvWinogradPackFilterSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterGroupSize = FilterCount * InputChannels;
+
+    for (size_t group = 0; group < GroupCount; group++) {
+
+        MlasConvWinogradTransformFilter(InputChannels, FilterCount,
+            Filter + group * FilterGroupSize * 9,
+            PackedFilter + group * FilterGroupSize * MLAS_WINOGRAD_TILE_ELEMENTS);
+    }
+}
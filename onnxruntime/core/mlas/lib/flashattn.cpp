@@ -25,6 +25,19 @@ MlasFlashAttentionThreaded(
     const float* value = args->value;
     float* output = args->output;
 
+    ptrdiff_t kv_num_heads = args->kv_num_heads > 0 ? static_cast<ptrdiff_t>(args->kv_num_heads) : num_heads;
+    ptrdiff_t kv_num_heads_factor = num_heads / kv_num_heads;
+    ptrdiff_t kv_buffer_sequence_length = args->kv_buffer_sequence_length > 0
+                                              ? static_cast<ptrdiff_t>(args->kv_buffer_sequence_length)
+                                              : kv_sequence_length;
+    ptrdiff_t q_batch_stride = args->q_batch_stride > 0 ? static_cast<ptrdiff_t>(args->q_batch_stride)
+                                                        : num_heads * q_sequence_length * qk_head_size;
+    ptrdiff_t k_batch_stride = args->kv_batch_stride > 0 ? static_cast<ptrdiff_t>(args->kv_batch_stride)
+                                                         : kv_num_heads * kv_buffer_sequence_length * qk_head_size;
+    ptrdiff_t v_batch_stride = args->kv_batch_stride > 0 ? static_cast<ptrdiff_t>(args->kv_batch_stride)
+                                                         : kv_num_heads * kv_buffer_sequence_length * v_head_size;
+    ptrdiff_t local_window_size = static_cast<ptrdiff_t>(args->local_window_size);
+
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
     auto&& mlas_platform = GetMlasPlatform();
 #endif
@@ -50,6 +63,7 @@ MlasFlashAttentionThreaded(
         batch_idx /= q_chunk_count;
         ptrdiff_t head_idx = batch_idx % num_heads;
         batch_idx /= num_heads;
+        ptrdiff_t kv_head_idx = head_idx / kv_num_heads_factor;
 
         char* buffer_current_thread = reinterpret_cast<char*>(buffer) + thread_id * buffer_size_per_thread;
         float* l = reinterpret_cast<float*>(buffer_current_thread);
@@ -61,7 +75,35 @@ MlasFlashAttentionThreaded(
         float* temp_output = intermediate + q_block_size * kv_block_size;
         float negmax = 0;
 
-        for (ptrdiff_t ir = 0; ir < kv_sequence_length; ir += kv_block_size) {
+        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_sequence_length - q_idx);
+
+        // Range of keys [kv_start, kv_end) that any query row of this chunk attends to.
+        ptrdiff_t kv_valid_length = args->kv_sequence_lengths != nullptr
+                                        ? static_cast<ptrdiff_t>(args->kv_sequence_lengths[batch_idx])
+                                        : kv_sequence_length;
+        ptrdiff_t q_position = 0;  // position of the first query row of this chunk
+        if (args->is_causal || local_window_size > 0) {
+            q_position = args->past_sequence_lengths != nullptr
+                             ? static_cast<ptrdiff_t>(args->past_sequence_lengths[batch_idx])
+                             : kv_valid_length - q_sequence_length;
+            q_position += q_idx;
+        }
+        ptrdiff_t kv_end = kv_valid_length;
+        if (args->is_causal) {
+            kv_end = std::min(kv_end, q_position + row_size_q_valid);
+        }
+        ptrdiff_t kv_start = 0;
+        if (local_window_size > 0) {
+            kv_start = std::max<ptrdiff_t>(0, q_position - local_window_size);
+            kv_start -= kv_start % kv_block_size;
+        }
+        bool is_masked = args->is_causal || local_window_size > 0;
+
+        const float* inputQ = query + batch_idx * q_batch_stride + (head_idx * q_sequence_length + q_idx) * qk_head_size;
+        const float* key_head = key + batch_idx * k_batch_stride + kv_head_idx * kv_buffer_sequence_length * qk_head_size;
+        const float* value_head = value + batch_idx * v_batch_stride + kv_head_idx * kv_buffer_sequence_length * v_head_size;
+
+        for (ptrdiff_t ir = kv_start; ir < kv_end; ir += kv_block_size) {
             /*
                 S = Q[batch_idx, head_idx, q_idx:q_idx+q_block_size, :] * (K[batch_idx, head_idx, ir:ir+kv_block_size, :]).T
                 old_m = m
@@ -71,13 +113,12 @@ MlasFlashAttentionThreaded(
                 l = exp(diff) * l + rowsum(S)
                 O = diag(exp(diff)) * O + S * V[batch_idx, head_idx, ir:ir+kv_block_size, :]
             */
-            ptrdiff_t h = batch_idx * num_heads + head_idx;
-            const float* inputQ = query + (h * q_sequence_length + q_idx) * qk_head_size;
-            const float* inputK = key + (h * kv_sequence_length + ir) * qk_head_size;
-            const float* inputV = value + (h * kv_sequence_length + ir) * v_head_size;
+            const float* inputK = key_head + ir * qk_head_size;
+            const float* inputV = value_head + ir * v_head_size;
+            bool is_first_block = ir == kv_start;
 
-            size_t row_size_q_capped = static_cast<size_t>(std::min(q_block_size, q_sequence_length - q_idx));
-            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_sequence_length - ir));
+            size_t row_size_q_capped = static_cast<size_t>(row_size_q_valid);
+            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_end - ir));
 
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
                      CBLAS_TRANSPOSE::CblasTrans,
@@ -96,6 +137,18 @@ MlasFlashAttentionThreaded(
             for (ptrdiff_t irow = 0; irow < static_cast<ptrdiff_t>(row_size_q_capped); ++irow) {
                 float* p = intermediate + irow * row_size_kv_capped;
 
+                if (is_masked) {
+                    // Mask out the keys after the query position and before its local window.
+                    ptrdiff_t position = q_position + irow;
+                    ptrdiff_t first = local_window_size > 0 ? position - local_window_size - ir : 0;
+                    ptrdiff_t last = args->is_causal ? position - ir : static_cast<ptrdiff_t>(row_size_kv_capped) - 1;
+                    for (ptrdiff_t icol = 0; icol < static_cast<ptrdiff_t>(row_size_kv_capped); ++icol) {
+                        if (icol < first || icol > last) {
+                            p[icol] = -std::numeric_limits<float>::infinity();
+                        }
+                    }
+                }
+
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
                 float rowmax = mlas_platform.ReduceMaximumF32Kernel(p, row_size_kv_capped);
 #else
@@ -112,8 +165,8 @@ MlasFlashAttentionThreaded(
                 float rowsum = MlasComputeSumExpF32Kernel(p, p, row_size_kv_capped, &negmax);
 #endif
 
-                // Note: for ir == 0, there is actually no need to calculate exp_diff
-                if (ir != 0) {
+                // Note: for the first block, there is actually no need to calculate exp_diff
+                if (!is_first_block) {
                     float exp_diff = std::exp(m_diff);
                     l[irow] = exp_diff * l[irow] + rowsum;
 
@@ -122,7 +175,7 @@ MlasFlashAttentionThreaded(
                     }
                 } else {
                     l[irow] = rowsum;
-                    // When ir == 0, there is no need to scale the old result because it is zero.
+                    // For the first block, there is no need to scale the old result because it is zero.
                 }
             }
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
@@ -135,17 +188,18 @@ MlasFlashAttentionThreaded(
                      row_size_kv_capped,
                      inputV,
                      static_cast<size_t>(v_head_size),
-                     ir == 0 ? 0.0f : 1.0f,
+                     is_first_block ? 0.0f : 1.0f,
                      temp_output,
                      static_cast<size_t>(v_head_size));
         }
 
         float* output_row = output + ((batch_idx * q_sequence_length + q_idx) * num_heads + head_idx) * v_head_size;
-        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_sequence_length - q_idx);
         // TODO: leverage advanced instruction sets
         for (ptrdiff_t irow = 0; irow < row_size_q_valid; ++irow) {
+            // A row without any key to attend to, e.g. padding, gets zeros.
+            float scale = (kv_start < kv_end && l[irow] > 0.0f) ? 1.0f / l[irow] : 0.0f;
             for (ptrdiff_t icol = 0; icol < v_head_size; ++icol) {
-                output_row[icol] = temp_output[irow * v_head_size + icol] / l[irow];
+                output_row[icol] = kv_start < kv_end ? temp_output[irow * v_head_size + icol] * scale : 0.0f;
             }
             output_row += num_heads * v_head_size;
         }
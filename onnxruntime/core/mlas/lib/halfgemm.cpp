@@ -25,8 +25,10 @@ Abstract:
 bool MLASCALL
 MlasFp16AccelerationSupported()
 {
-#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
     return MLAS_CPUIDINFO::GetCPUIDInfo().HasFp16VectorAcceleration();
+#elif defined(MLAS_TARGET_AMD64)
+    return GetMlasPlatform().HalfGemmDispatch != nullptr;
 #else
     return false;
 #endif
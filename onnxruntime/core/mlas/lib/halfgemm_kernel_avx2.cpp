@@ -0,0 +1,341 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements half precision GEMM kernel for AVX2.
+
+    The matrices stay in fp16 in memory. Panels of A and B are converted to
+    fp32 on the fly with the F16C instructions and the products are
+    accumulated in fp32 with FMA3. Each kernel call rounds its result to fp16
+    once. When A and B are fp16 the driver passes all of K to one call, so C
+    is rounded once. When A or B is fp32, it is converted to fp16 in panels
+    of Strides.K (512) columns, and C is rounded to fp16 after each panel.
+
+--*/
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+#include <cstring>
+
+struct MLAS_HALF_GEMM_KERNEL_AVX2 {
+    static constexpr bool PackNeeded = false;
+    static constexpr size_t KernelMaxM = 6;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 1;
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{24, 128, 512};
+};
+
+MLAS_FORCEINLINE
+__m256
+MlasLoadFloat16x8Avx2(
+    const _mlas_fp16_* src
+    )
+{
+    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+}
+
+MLAS_FORCEINLINE
+__m256
+MlasLoadPartialFloat16x8Avx2(
+    const _mlas_fp16_* src,
+    size_t len
+    )
+{
+    _mlas_fp16_ buf[8] = {};
+    std::memcpy(buf, src, len * sizeof(_mlas_fp16_));
+    return MlasLoadFloat16x8Avx2(buf);
+}
+
+MLAS_FORCEINLINE
+void
+MlasStoreFloat16x8Avx2(
+    _mlas_fp16_* dest,
+    __m256 v
+    )
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+}
+
+MLAS_FORCEINLINE
+void
+MlasStorePartialFloat16x8Avx2(
+    _mlas_fp16_* dest,
+    __m256 v,
+    size_t len
+    )
+{
+    _mlas_fp16_ buf[8];
+    MlasStoreFloat16x8Avx2(buf, v);
+    std::memcpy(dest, buf, len * sizeof(_mlas_fp16_));
+}
+
+/**
+ * @brief Compute a block of RowCount rows by 16 columns of C.
+*/
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmBlock16Avx2(
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    bool ZeroMode
+    )
+{
+    __m256 Acc0[RowCount];
+    __m256 Acc1[RowCount];
+
+    const __m256 Bias0 = Bias == nullptr ? _mm256_setzero_ps() : MlasLoadFloat16x8Avx2(Bias);
+    const __m256 Bias1 = Bias == nullptr ? _mm256_setzero_ps() : MlasLoadFloat16x8Avx2(Bias + 8);
+    for (size_t r = 0; r < RowCount; r++) {
+        Acc0[r] = Bias0;
+        Acc1[r] = Bias1;
+        if (!ZeroMode) {
+            Acc0[r] = _mm256_add_ps(Acc0[r], MlasLoadFloat16x8Avx2(C + r * ldc));
+            Acc1[r] = _mm256_add_ps(Acc1[r], MlasLoadFloat16x8Avx2(C + r * ldc + 8));
+        }
+    }
+
+    for (size_t k = 0; k < CountK; k++) {
+        const __m256 B0 = MlasLoadFloat16x8Avx2(B);
+        const __m256 B1 = MlasLoadFloat16x8Avx2(B + 8);
+        for (size_t r = 0; r < RowCount; r++) {
+            const __m256 a = _mm256_set1_ps(_cvtsh_ss(A[r * lda + k]));
+            Acc0[r] = _mm256_fmadd_ps(a, B0, Acc0[r]);
+            Acc1[r] = _mm256_fmadd_ps(a, B1, Acc1[r]);
+        }
+        B += ldb;
+    }
+
+    for (size_t r = 0; r < RowCount; r++) {
+        MlasStoreFloat16x8Avx2(C + r * ldc, Acc0[r]);
+        MlasStoreFloat16x8Avx2(C + r * ldc + 8, Acc1[r]);
+    }
+}
+
+/**
+ * @brief Compute a block of RowCount rows by up to 8 columns of C.
+*/
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmBlock8Avx2(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    bool ZeroMode
+    )
+{
+    __m256 Acc[RowCount];
+
+    const bool Partial = CountN < 8;
+    __m256 BiasVector = _mm256_setzero_ps();
+    if (Bias != nullptr) {
+        BiasVector = Partial ? MlasLoadPartialFloat16x8Avx2(Bias, CountN) : MlasLoadFloat16x8Avx2(Bias);
+    }
+    for (size_t r = 0; r < RowCount; r++) {
+        Acc[r] = BiasVector;
+        if (!ZeroMode) {
+            const auto* c = C + r * ldc;
+            Acc[r] = _mm256_add_ps(
+                Acc[r], Partial ? MlasLoadPartialFloat16x8Avx2(c, CountN) : MlasLoadFloat16x8Avx2(c));
+        }
+    }
+
+    for (size_t k = 0; k < CountK; k++) {
+        const __m256 B0 = Partial ? MlasLoadPartialFloat16x8Avx2(B, CountN) : MlasLoadFloat16x8Avx2(B);
+        for (size_t r = 0; r < RowCount; r++) {
+            const __m256 a = _mm256_set1_ps(_cvtsh_ss(A[r * lda + k]));
+            Acc[r] = _mm256_fmadd_ps(a, B0, Acc[r]);
+        }
+        B += ldb;
+    }
+
+    for (size_t r = 0; r < RowCount; r++) {
+        if (Partial) {
+            MlasStorePartialFloat16x8Avx2(C + r * ldc, Acc[r], CountN);
+        } else {
+            MlasStoreFloat16x8Avx2(C + r * ldc, Acc[r]);
+        }
+    }
+}
+
+template<size_t RowCount>
+void
+MlasHalfGemmRowsAvx2(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    bool ZeroMode
+    )
+{
+    while (CountN >= 16) {
+        MlasHalfGemmBlock16Avx2<RowCount>(CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+        C += 16;
+        B += 16;
+        if (Bias != nullptr) {
+            Bias += 16;
+        }
+        CountN -= 16;
+    }
+
+    while (CountN > 0) {
+        const size_t CountN8 = std::min(CountN, size_t{8});
+        MlasHalfGemmBlock8Avx2<RowCount>(CountN8, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+        C += CountN8;
+        B += CountN8;
+        if (Bias != nullptr) {
+            Bias += CountN8;
+        }
+        CountN -= CountN8;
+    }
+}
+
+MLAS_FORCEINLINE
+void
+CvtFloat2Half(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t len
+)
+{
+    while (len >= 8) {
+        MlasStoreFloat16x8Avx2(dest, _mm256_loadu_ps(src));
+        src += 8;
+        dest += 8;
+        len -= 8;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        dest[i] = _cvtss_sh(src[i], _MM_FROUND_TO_NEAREST_INT);
+    }
+}
+
+/**
+ * @brief Convert a 2D matrix from float to fp16
+*/
+MLAS_FORCEINLINE
+void
+CvtFloat2Half2D(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t stride,
+    size_t CntRow,
+    size_t CntCol
+    )
+{
+    if (stride == CntCol) {
+        const size_t len = CntRow * CntCol;
+        CvtFloat2Half(dest, src, len);
+        return;
+    }
+    while (CntRow > 0) {
+        CvtFloat2Half(dest, src, CntCol);
+        src += stride;
+        dest += CntCol;
+        CntRow--;
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackA<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+)
+{
+    CvtFloat2Half2D(D, A, lda, CountM, CountK);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    CvtFloat2Half2D(D, B, ldb, CountK, CountN);
+}
+
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernel<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    switch (std::min(CountM, MLAS_HALF_GEMM_KERNEL_AVX2::KernelMaxM)) {
+        case 1:
+            MlasHalfGemmRowsAvx2<1>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmRowsAvx2<2>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmRowsAvx2<3>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 4:
+            MlasHalfGemmRowsAvx2<4>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 5:
+            MlasHalfGemmRowsAvx2<5>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        default:
+            MlasHalfGemmRowsAvx2<6>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+    }
+}
+
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2 = {
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    nullptr,
+    MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    MLAS_HALF_GEMM_KERNEL_AVX2::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX2::KernelMaxM,
+    0
+};
@@ -0,0 +1,663 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements the layer normalization and root mean square
+    normalization routines.
+
+    Each row is processed in two passes over chunks that fit in the L1 cache.
+    The first pass sums the input, skip and bias to accumulate the statistics
+    of the row, and the second pass recomputes the sum to produce the output,
+    so no intermediate row is written to memory. Half precision rows are
+    converted to float one chunk at a time.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Number of elements of a row processed at a time. The chunk buffers below
+// stay in the L1 cache.
+//
+
+constexpr size_t MLAS_LAYER_NORM_CHUNK_SIZE = 256;
+
+template <typename T>
+struct MLAS_LAYER_NORM_WORK_BLOCK {
+    ptrdiff_t ThreadCountN;
+    const MLAS_LAYER_NORM_PARAMS<T>* Params;
+    size_t N;
+    size_t D;
+    bool Simplified;
+};
+
+MLAS_FORCEINLINE
+const float*
+MlasLayerNormLoad(
+    const float* Source,
+    float* Buffer,
+    size_t Count
+    )
+{
+    MLAS_UNREFERENCED_PARAMETER(Buffer);
+    MLAS_UNREFERENCED_PARAMETER(Count);
+
+    return Source;
+}
+
+MLAS_FORCEINLINE
+const float*
+MlasLayerNormLoad(
+    const MLAS_FP16* Source,
+    float* Buffer,
+    size_t Count
+    )
+{
+    for (size_t i = 0; i < Count; i++) {
+        Buffer[i] = Source[i].ToFloat();
+    }
+
+    return Buffer;
+}
+
+MLAS_FORCEINLINE
+void
+MlasLayerNormStore(
+    const float* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+    if (Source != Destination) {
+        std::copy_n(Source, Count, Destination);
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasLayerNormStore(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    )
+{
+    for (size_t i = 0; i < Count; i++) {
+        Destination[i] = MLAS_FP16(Source[i]);
+    }
+}
+
+void
+MlasLayerNormAddKernel(
+    const float* Input,
+    const float* Addend,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine adds two vectors.
+
+Arguments:
+
+    Input - Supplies the first input buffer.
+
+    Addend - Supplies the second input buffer.
+
+    Output - Supplies the output buffer. This may alias the first input.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Input);
+        Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Addend));
+        MlasStoreFloat32x4(Output, Vector);
+
+        Input += 4;
+        Addend += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output++ = *Input++ + *Addend++;
+        N -= 1;
+    }
+}
+
+void
+MlasLayerNormAccumulateKernel(
+    const float* Input,
+    size_t N,
+    float* Sum,
+    float* SumSquares
+    )
+/*++
+
+Routine Description:
+
+    This routine accumulates the sum and the sum of squares of a vector.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+    Sum - Supplies the sum to update.
+
+    SumSquares - Supplies the sum of squares to update.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 SumVector0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumVector1 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumSquaresVector0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumSquaresVector1 = MlasZeroFloat32x4();
+
+    //
+    // Use two sets of accumulators to break the dependency chains.
+    //
+
+    while (N >= 8) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input);
+        MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input + 4);
+
+        SumVector0 = MlasAddFloat32x4(SumVector0, Vector0);
+        SumVector1 = MlasAddFloat32x4(SumVector1, Vector1);
+        SumSquaresVector0 = MlasMultiplyAddFloat32x4(Vector0, Vector0, SumSquaresVector0);
+        SumSquaresVector1 = MlasMultiplyAddFloat32x4(Vector1, Vector1, SumSquaresVector1);
+
+        Input += 8;
+        N -= 8;
+    }
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Input);
+
+        SumVector0 = MlasAddFloat32x4(SumVector0, Vector);
+        SumSquaresVector0 = MlasMultiplyAddFloat32x4(Vector, Vector, SumSquaresVector0);
+
+        Input += 4;
+        N -= 4;
+    }
+
+    float SumValue = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumVector0, SumVector1));
+    float SumSquaresValue = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumSquaresVector0, SumSquaresVector1));
+
+    while (N > 0) {
+
+        float Value = *Input++;
+        SumValue += Value;
+        SumSquaresValue += Value * Value;
+        N -= 1;
+    }
+
+    *Sum += SumValue;
+    *SumSquares += SumSquaresValue;
+}
+
+void
+MlasLayerNormOutputKernel(
+    const float* Input,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t N,
+    float Mean,
+    float InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine computes (Input - Mean) * InvStdDev * Scale + Shift.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Scale - Supplies the scale buffer.
+
+    Shift - Optionally supplies the shift buffer.
+
+    Output - Supplies the output buffer. This may alias the input.
+
+    N - Supplies the number of elements to process.
+
+    Mean - Supplies the mean to subtract from each element.
+
+    InvStdDev - Supplies the inverse standard deviation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 MeanVector = MlasBroadcastFloat32x4(Mean);
+    MLAS_FLOAT32X4 InvStdDevVector = MlasBroadcastFloat32x4(InvStdDev);
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input), MeanVector);
+        MLAS_FLOAT32X4 ScaleVector = MlasMultiplyFloat32x4(MlasLoadFloat32x4(Scale), InvStdDevVector);
+
+        if (Shift != nullptr) {
+            Vector = MlasMultiplyAddFloat32x4(Vector, ScaleVector, MlasLoadFloat32x4(Shift));
+            Shift += 4;
+        } else {
+            Vector = MlasMultiplyFloat32x4(Vector, ScaleVector);
+        }
+
+        MlasStoreFloat32x4(Output, Vector);
+
+        Input += 4;
+        Scale += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        float Value = (*Input++ - Mean) * (*Scale++ * InvStdDev);
+
+        if (Shift != nullptr) {
+            Value += *Shift++;
+        }
+
+        *Output++ = Value;
+        N -= 1;
+    }
+}
+
+template <typename T>
+const float*
+MlasLayerNormLoadSum(
+    const MLAS_LAYER_NORM_PARAMS<T>& Params,
+    const T* Input,
+    const T* Skip,
+    size_t Offset,
+    size_t Count,
+    float* InputBuffer,
+    float* AddendBuffer
+    )
+/*++
+
+Routine Description:
+
+    This routine loads a chunk of the sum of the input, skip and bias rows.
+
+Arguments:
+
+    Params - Supplies the normalization parameters.
+
+    Input - Supplies the input row.
+
+    Skip - Optionally supplies the skip row.
+
+    Offset - Supplies the offset of the chunk in the row.
+
+    Count - Supplies the number of elements of the chunk.
+
+    InputBuffer - Supplies a chunk buffer that receives the sum if it cannot
+        be read in place.
+
+    AddendBuffer - Supplies a chunk buffer used to convert the skip and bias.
+
+Return Value:
+
+    Returns the address of the sum.
+
+--*/
+{
+    const float* Sum = MlasLayerNormLoad(Input + Offset, InputBuffer, Count);
+
+    if (Skip != nullptr) {
+        MlasLayerNormAddKernel(Sum, MlasLayerNormLoad(Skip + Offset, AddendBuffer, Count), InputBuffer, Count);
+        Sum = InputBuffer;
+    }
+
+    if (Params.Bias != nullptr) {
+        MlasLayerNormAddKernel(Sum, MlasLayerNormLoad(Params.Bias + Offset, AddendBuffer, Count), InputBuffer, Count);
+        Sum = InputBuffer;
+    }
+
+    return Sum;
+}
+
+template <typename T>
+void
+MlasLayerNormRow(
+    const MLAS_LAYER_NORM_PARAMS<T>& Params,
+    size_t n,
+    size_t D,
+    bool Simplified
+    )
+/*++
+
+Routine Description:
+
+    This routine normalizes a single row.
+
+Arguments:
+
+    Params - Supplies the normalization parameters.
+
+    n - Supplies the index of the row.
+
+    D - Supplies the number of elements of the row.
+
+    Simplified - Supplies true for root mean square normalization, else false
+        for layer normalization.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float InputBuffer[MLAS_LAYER_NORM_CHUNK_SIZE], 64);
+    MLAS_DECLSPEC_ALIGN(float AddendBuffer[MLAS_LAYER_NORM_CHUNK_SIZE], 64);
+    MLAS_DECLSPEC_ALIGN(float ScaleBuffer[MLAS_LAYER_NORM_CHUNK_SIZE], 64);
+    MLAS_DECLSPEC_ALIGN(float ShiftBuffer[MLAS_LAYER_NORM_CHUNK_SIZE], 64);
+    MLAS_DECLSPEC_ALIGN(float OutputBuffer[MLAS_LAYER_NORM_CHUNK_SIZE], 64);
+
+    const T* Input = Params.Input + n * D;
+    const T* Skip = (Params.Skip != nullptr) ? Params.Skip + (n % Params.SkipRows) * D : nullptr;
+    const T* Shift = Simplified ? nullptr : Params.Shift;
+    T* SumOutput = (Params.SumOutput != nullptr) ? Params.SumOutput + n * D : nullptr;
+
+    //
+    // Accumulate the statistics of the row and write the sum of the input,
+    // skip and bias if requested.
+    //
+
+    float Sum = 0.0f;
+    float SumSquares = 0.0f;
+
+    for (size_t Offset = 0; Offset < D; Offset += MLAS_LAYER_NORM_CHUNK_SIZE) {
+
+        const size_t Count = std::min(D - Offset, MLAS_LAYER_NORM_CHUNK_SIZE);
+        const float* Value = MlasLayerNormLoadSum(Params, Input, Skip, Offset, Count, InputBuffer, AddendBuffer);
+
+        MlasLayerNormAccumulateKernel(Value, Count, &Sum, &SumSquares);
+
+        if (SumOutput != nullptr) {
+            MlasLayerNormStore(Value, SumOutput + Offset, Count);
+        }
+    }
+
+    float Mean = 0.0f;
+    float Variance;
+
+    if (Simplified) {
+        Variance = SumSquares / float(D);
+    } else {
+        Mean = Sum / float(D);
+        Variance = SumSquares / float(D) - Mean * Mean;
+    }
+
+    const float InvStdDev = 1.0f / std::sqrt(Variance + Params.Epsilon);
+
+    if (!Simplified && Params.Mean != nullptr) {
+        Params.Mean[n] = Mean;
+    }
+
+    if (Params.InvStdDev != nullptr) {
+        Params.InvStdDev[n] = InvStdDev;
+    }
+
+    if (Params.Output == nullptr && Params.QuantizedOutput == nullptr) {
+        return;
+    }
+
+    //
+    // Normalize the row. The sum is recomputed rather than reloaded as the
+    // input chunks are likely still in the cache.
+    //
+
+    for (size_t Offset = 0; Offset < D; Offset += MLAS_LAYER_NORM_CHUNK_SIZE) {
+
+        const size_t Count = std::min(D - Offset, MLAS_LAYER_NORM_CHUNK_SIZE);
+        const float* Value = MlasLayerNormLoadSum(Params, Input, Skip, Offset, Count, InputBuffer, AddendBuffer);
+        const float* Scale = MlasLayerNormLoad(Params.Scale + Offset, ScaleBuffer, Count);
+        const float* ShiftValue = (Shift != nullptr) ? MlasLayerNormLoad(Shift + Offset, ShiftBuffer, Count) : nullptr;
+
+        float* Output = OutputBuffer;
+
+        if constexpr (std::is_same_v<T, float>) {
+            if (Params.Output != nullptr) {
+                Output = Params.Output + n * D + Offset;
+            }
+        }
+
+        MlasLayerNormOutputKernel(Value, Scale, ShiftValue, Output, Count, Mean, InvStdDev);
+
+        if (Params.Output != nullptr) {
+            MlasLayerNormStore(Output, Params.Output + n * D + Offset, Count);
+        }
+
+        if (Params.QuantizedOutput != nullptr) {
+            MlasQuantizeLinear<int8_t>(Output, Params.QuantizedOutput + n * D + Offset, Count,
+                                       Params.QuantizedScale, Params.QuantizedZeroPoint);
+        }
+    }
+}
+
+template <typename T>
+void
+MlasLayerNormThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    normalization operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_LAYER_NORM_WORK_BLOCK<T>*)Context;
+
+    size_t n;
+    size_t CountN;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCountN, WorkBlock->N, &n, &CountN);
+
+    for (size_t i = n; i < n + CountN; i++) {
+        MlasLayerNormRow(*WorkBlock->Params, i, WorkBlock->D, WorkBlock->Simplified);
+    }
+}
+
+template <typename T>
+void
+MlasLayerNormExecute(
+    const MLAS_LAYER_NORM_PARAMS<T>& Params,
+    size_t N,
+    size_t D,
+    bool Simplified,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    if (N == 0 || D == 0) {
+        return;
+    }
+
+    MLAS_LAYER_NORM_WORK_BLOCK<T> WorkBlock;
+
+    WorkBlock.Params = &Params;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.Simplified = Simplified;
+
+    //
+    // Limit the number of threads to the number of rows and try to keep each
+    // thread processing a minimum number of elements before using another
+    // thread.
+    //
+
+    ptrdiff_t ThreadCountN = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCountN) > N) {
+        ThreadCountN = ptrdiff_t(N);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t BlockCount = ((N * D) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCountN) > BlockCount) {
+        ThreadCountN = ptrdiff_t(BlockCount);
+    }
+
+    WorkBlock.ThreadCountN = ThreadCountN;
+
+    MlasExecuteThreaded(MlasLayerNormThreaded<T>, &WorkBlock, ThreadCountN, ThreadPool);
+}
+
+template <typename T>
+void
+MLASCALL
+MlasLayerNorm(
+    const MLAS_LAYER_NORM_PARAMS<T>& Params,
+    size_t N,
+    size_t D,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the layer normalization of N rows of D elements.
+
+Arguments:
+
+    Params - Supplies the normalization parameters.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of elements per row.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasLayerNormExecute(Params, N, D, false, ThreadPool);
+}
+
+template <typename T>
+void
+MLASCALL
+MlasRmsNorm(
+    const MLAS_LAYER_NORM_PARAMS<T>& Params,
+    size_t N,
+    size_t D,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the root mean square normalization of N rows of D
+    elements.
+
+Arguments:
+
+    Params - Supplies the normalization parameters.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of elements per row.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasLayerNormExecute(Params, N, D, true, ThreadPool);
+}
+
+template
+void
+MLASCALL
+MlasLayerNorm<float>(
+    const MLAS_LAYER_NORM_PARAMS<float>& Params,
+    size_t N,
+    size_t D,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+template
+void
+MLASCALL
+MlasLayerNorm<MLAS_FP16>(
+    const MLAS_LAYER_NORM_PARAMS<MLAS_FP16>& Params,
+    size_t N,
+    size_t D,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+template
+void
+MLASCALL
+MlasRmsNorm<float>(
+    const MLAS_LAYER_NORM_PARAMS<float>& Params,
+    size_t N,
+    size_t D,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+template
+void
+MLASCALL
+MlasRmsNorm<MLAS_FP16>(
+    const MLAS_LAYER_NORM_PARAMS<MLAS_FP16>& Params,
+    size_t N,
+    size_t D,
+    MLAS_THREADPOOL* ThreadPool
+    );
@@ -898,7 +898,7 @@ extern "C" {
 #define MLAS_DGEMM_THREAD_COMPLEXITY                (size_t(64) * size_t(1024))
 #define MLAS_QGEMM_THREAD_COMPLEXITY                65536
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SUPPORTS_SBGEMM)
 #define MLAS_SBGEMM_THREAD_COMPLEXITY (size_t(64) * size_t(1024))
 #endif
 
@@ -920,7 +920,10 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_GEMM_POSTPROCESSOR<float>* OutputProcessor = nullptr,
+    size_t StartM = 0,
+    size_t StartN = 0
     );
 
 //
@@ -999,6 +1002,26 @@ extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512;
 
 extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512vnni;
 
+//
+// Half precision matrix/matrix multiply dispatch structure.
+//
+
+struct MLAS_HALFGEMM_DISPATCH;
+
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2;
+
+//
+// Bfloat16 precision matrix/matrix multiply dispatch structure.
+//
+
+struct MLAS_SBGEMM_DISPATCH;
+
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx2;
+
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512Bf16;
+
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAmx;
+
 //
 // Quantized depthwise convolution kernels.
 //
@@ -1151,6 +1174,11 @@ struct MLAS_PLATFORM {
     const MLAS_Q8Q4GEMM_DISPATCH* Q8Q4GemmDispatch{nullptr};
 
     const MLAS_SQNBIT_GEMM_DISPATCH* SQNBitGemmDispatch{nullptr};
+
+#if defined(MLAS_TARGET_AMD64)
+    const MLAS_HALFGEMM_DISPATCH* HalfGemmDispatch{nullptr};
+    const MLAS_SBGEMM_DISPATCH* SBGemmDispatch{nullptr};
+#endif
 };
 
 inline
@@ -1230,6 +1258,25 @@ MlasGetMaximumThreadCount(
 #endif
 }
 
+//
+// Returns true if the calling thread runs under a deadline that has passed.
+// Long-running routines poll this between slices of work and skip the rest of
+// the computation; the results are discarded by the caller in that case.
+//
+
+inline
+bool
+MlasDeadlinePassed(
+    void
+    )
+{
+#if defined(BUILD_MLAS_NO_ONNXRUNTIME)
+    return false;
+#else
+    return onnxruntime::concurrency::ThreadPool::DeadlinePassed();
+#endif
+}
+
 inline
 void
 MlasPartitionWork(
@@ -1301,6 +1348,28 @@ MlasFp32FromBits(
 #pragma warning(pop)
 #endif
 
+//
+// Winograd convolution routines.
+//
+
+bool
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
 void
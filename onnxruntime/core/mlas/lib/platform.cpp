@@ -384,6 +384,17 @@ Return Value:
                 this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
                 this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx2;
 
+                //
+                // Check if the processor supports the F16C half precision conversion
+                // instructions.
+                //
+
+                if ((Cpuid1[2] & 0x20000000) != 0) {
+                    this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx2;
+                }
+
+                this->SBGemmDispatch = &MlasSBGemmDispatchAvx2;
+
                 //
                 // Check if the processor supports Hybrid core architecture.
                 //
@@ -465,6 +476,14 @@ Return Value:
                             this->Q8Q4GemmDispatch = &MlasQ8Q4GemmDispatchAvx512vnni;
                             this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx512vnni;
                         }
+
+                        //
+                        // Check if the processor supports AVX512-BF16.
+                        //
+
+                        if ((Cpuid7_1[0] & 0x20) != 0) {
+                            this->SBGemmDispatch = &MlasSBGemmDispatchAvx512Bf16;
+                        }
                     }
                 }
 
@@ -479,6 +498,16 @@ Return Value:
                     if (MlasInitAMX()) {
                         this->GemmU8U8Dispatch = &MlasGemmU8S8DispatchAmx;
                         this->GemmU8S8Dispatch = &MlasGemmU8S8DispatchAmx;
+
+                        //
+                        // Check if the processor supports AMX-BF16. The rows
+                        // that do not fill a tile use AVX512-BF16.
+                        //
+
+                        if ((Cpuid7[3] & 0b1 << 22) != 0 &&
+                            this->SBGemmDispatch == &MlasSBGemmDispatchAvx512Bf16) {
+                            this->SBGemmDispatch = &MlasSBGemmDispatchAmx;
+                        }
                     }
                 }
 #endif // __APPLE__
@@ -0,0 +1,183 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+Copyright 2023 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm.cpp
+
+Abstract:
+
+    This module implements the bfloat16 precision matrix/matrix multiply
+    operation (SBGEMM).
+
+--*/
+
+#include "mlasi.h"
+#include "sbgemm.h"
+
+#if defined(MLAS_SUPPORTS_SBGEMM)
+
+bool MLASCALL
+MlasBf16AccelerationSupported()
+{
+#if defined(MLAS_TARGET_ARM64)
+    return MLAS_CPUIDINFO::GetCPUIDInfo().HasArmNeon_BF16();
+#elif defined(MLAS_TARGET_AMD64)
+    //
+    // The AVX2 kernel emulates the bf16 dot products with fp32 FMA, which is
+    // not faster than SGEMM.
+    //
+    const auto* dispatch = GetMlasPlatform().SBGemmDispatch;
+    return dispatch != nullptr && dispatch != &MlasSBGemmDispatchAvx2;
+#else
+    return false;
+#endif
+}
+
+#if defined(MLAS_TARGET_AMD64)
+
+void
+MlasSBGemmConvertPackBX64(
+    bfloat16_t* D, const float* B, size_t ldb, size_t CountN, size_t CountK, size_t StrideK
+)
+{
+    constexpr size_t PanelN = 16;
+    const size_t AlignedN = (CountN + PanelN - 1) & ~(PanelN - 1);
+
+    size_t CountBlockK;
+    for (size_t k = 0; k < CountK; k += CountBlockK) {
+        CountBlockK = std::min(CountK - k, StrideK);
+        const size_t AlignedBlockK = (CountBlockK + 1) & ~size_t{1};
+
+        for (size_t n = 0; n < CountN; n += PanelN) {
+            const size_t CountPanelN = std::min(CountN - n, PanelN);
+            bfloat16_t* d = D + n * AlignedBlockK;
+
+            for (size_t kk = 0; kk < CountBlockK; kk += 2) {
+                const float* b0 = B + (k + kk) * ldb + n;
+                const float* b1 = (kk + 1 < CountBlockK) ? b0 + ldb : nullptr;
+
+                for (size_t nn = 0; nn < PanelN; nn++) {
+                    if (nn < CountPanelN) {
+                        d[0] = MlasFp32ToBf16(b0[nn]);
+                        d[1] = (b1 != nullptr) ? MlasFp32ToBf16(b1[nn]) : bfloat16_t(0);
+                    } else {
+                        d[0] = 0;
+                        d[1] = 0;
+                    }
+                    d += 2;
+                }
+            }
+        }
+
+        D += AlignedN * CountBlockK;
+    }
+}
+
+#endif  // defined(MLAS_TARGET_AMD64)
+
+size_t MLASCALL
+MlasSBGemmPackBSize(size_t N, size_t K)
+{
+    //
+    // Compute the number of bytes required to hold the packed buffer.
+    //
+    const auto* dispatch = MlasSBGemmGetDispatch();
+    if (dispatch == nullptr) return 0;
+
+    const auto padding = dispatch->BufOverRead;
+    const auto PackedK = dispatch->PackedK;
+    const auto PackedN = dispatch->PackedN;
+
+    const size_t AlignedK = (K + PackedK - 1) & ~(PackedK - 1);
+    const size_t AlignedN = (N + PackedN - 1) & ~(PackedN - 1);
+    const size_t BytesRequired = AlignedN * AlignedK * sizeof(bfloat16_t) + padding;
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+    const size_t AlignedBytesRequired =
+        (BytesRequired + BufferAlignment - 1) & ~(BufferAlignment - 1);
+
+    return AlignedBytesRequired;
+}
+
+void MLASCALL
+MlasSBGemmConvertPackB(size_t N, size_t K, const float* B, size_t ldb, void* PackedB)
+{
+    const auto* dispatch = MlasSBGemmGetDispatch();
+    if (dispatch == nullptr) return;
+
+    dispatch->ConvertPackBRoutine((bfloat16_t*)PackedB, B, ldb, N, K);
+}
+
+void MLASCALL
+MlasSBGemmBatch(const size_t M, const size_t N, const size_t K, const size_t BatchN, const MLAS_SBGEMM_DATA_PARAMS* Data, MLAS_THREADPOOL* ThreadPool)
+{
+    const MLAS_SBGEMM_DISPATCH* dispatch = MlasSBGemmGetDispatch();
+    if (dispatch == nullptr) return;
+
+    MLAS_SBGEMM_OPERATION* operation = dispatch->Operation;
+
+    //
+    // Compute the number of target threads given the complexity of the SGEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K);
+
+    ptrdiff_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SBGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Segment the operation across multiple threads.
+    //
+    // N.B. Currently, the operation is segmented as a 1D partition, which
+    // works okay for operations involving skinny matrices.
+    //
+    ptrdiff_t ThreadsPerGemm = (TargetThreadCount + BatchN - 1) / BatchN;
+    ptrdiff_t ThreadCountM;
+    ptrdiff_t ThreadCountN;
+
+    if (N > M) {
+        const size_t BlockedN =
+            (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) / MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+        if (size_t(ThreadsPerGemm) > BlockedN) {
+            ThreadsPerGemm = ptrdiff_t(BlockedN);
+        }
+
+        ThreadCountM = 1;
+        ThreadCountN = ThreadsPerGemm;
+
+    } else {
+        if (size_t(ThreadsPerGemm) > M) {
+            ThreadsPerGemm = ptrdiff_t(M);
+        }
+
+        ThreadCountM = ThreadsPerGemm;
+        ThreadCountN = 1;
+    }
+
+    MlasTrySimpleParallel(
+        ThreadPool, ThreadsPerGemm * static_cast<ptrdiff_t>(BatchN), [=](ptrdiff_t tid) {
+            ptrdiff_t GemmIdx = tid / ThreadsPerGemm;
+            ptrdiff_t ThreadIdx = tid % ThreadsPerGemm;
+            operation(ThreadCountM, ThreadCountN, M, N, K, &(Data[GemmIdx]), ThreadIdx);
+        }
+    );
+}
+
+#endif  // defined(MLAS_SUPPORTS_SBGEMM)
@@ -28,17 +28,28 @@ Abstract:
         size_t PackedK;          Packed alignment on the K dim (power of 2)
         size_t PackedN;          Packed alignment on the n dim (power of 2)
         MLAS_SBGEMM_STRIDES Strides{128, 128, 256};
---*/
 
-#if defined(__aarch64__) && defined(__linux__)
+    The x64 kernels share the packed B layout produced by
+    MlasSBGemmConvertPackBX64: each block of Strides.K rows is stored as
+    panels of 16 columns, and a panel holds the rows in pairs with the two
+    values of a column next to each other. This is the operand layout of the
+    AVX512-BF16 VDPBF16PS instruction and of the AMX-BF16 B tiles.
+--*/
 
 #pragma once
 
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 
 #include "mlasi.h"
 
+#if defined(MLAS_SUPPORTS_SBGEMM)
+
+#if defined(MLAS_TARGET_AMD64)
+typedef uint16_t bfloat16_t;
+#endif
+
 /**
  * @brief Define the default striding parameters for
  *        the bfloat16 precision gemm operation
@@ -134,7 +145,8 @@ MlasSBGemmPackedOperation(size_t M, size_t RangeStartN, size_t RangeCountN, size
             bool ZeroMode = (k == 0);
             CountK = std::min(K - k, PackedStrideK);
 
-            const bfloat16_t* pb = (const bfloat16_t*)PackedB + AlignedN * k + CountK * SliceStartN;
+            const size_t AlignedCountK = (CountK + KernelType::PackedK - 1) & ~(KernelType::PackedK - 1);
+            const bfloat16_t* pb = (const bfloat16_t*)PackedB + AlignedN * k + AlignedCountK * SliceStartN;
             float* c = C + n;
             const float* pbias = ((nullptr == Bias) ? nullptr : Bias + RangeStartN + n);
             MlasSBGemmKernel<KernelType>(M, CountN, CountK, A + k, lda, pb, c, ldc, ZeroMode ? pbias : nullptr, ZeroMode);
@@ -173,7 +185,8 @@ MlasSBGemmNonPackedOperation(size_t M, size_t N, size_t K, const float* A, size_
         }
     }
 
-    constexpr size_t packBSize = UpAlignSize(Strides.N * Strides.K * sizeof(bfloat16_t));
+    const size_t AlignedStrideK = (StrideK + KernelType::PackedK - 1) & ~(KernelType::PackedK - 1);
+    const size_t packBSize = UpAlignSize(StrideN * AlignedStrideK * sizeof(bfloat16_t));
     MlasThreadedBufAlloc(packBSize);
     uint8_t* p = ThreadedBufHolder.get();
     auto* PanelB = reinterpret_cast<bfloat16_t*>(p);
@@ -198,8 +211,7 @@ MlasSBGemmNonPackedOperation(size_t M, size_t N, size_t K, const float* A, size_
             MlasSBGemmConvertPackB<KernelType>(PanelB, B + n + k * ldb, ldb, CountN, CountK);
 
             auto* c = C + n;
-            const float* pbias =
-                ((nullptr == Bias) ? nullptr : Bias + n);  // TODO: check the SliceNStart
+            const float* pbias = ((nullptr == Bias) ? nullptr : Bias + n);
 
             bool ZeroMode = (k == 0);
             MlasSBGemmKernel<KernelType>(M, CountN, CountK, A + k, lda, PanelB, c, ldc, ZeroMode ? pbias : nullptr, ZeroMode);
@@ -258,6 +270,9 @@ MlasSBGemmOperation(const ptrdiff_t ThreadCountM, const ptrdiff_t ThreadCountN,
     } else {
         const size_t ldb = DataParams->ldb;
         const float* B = (const float*)DataParams->B + RangeStartN;
+        if (bias != nullptr) {
+            bias += RangeStartN;
+        }
         MlasSBGemmNonPackedOperation<KernelType>(RangeCountM, RangeCountN, K, A, lda, B, ldb, C, ldc, bias, (void*)DataParams->OutputProcessor);
     }
 }
@@ -283,7 +298,9 @@ struct MLAS_SBGEMM_DISPATCH {
     size_t BufOverRead;
 };
 
+#if defined(MLAS_TARGET_ARM64)
 extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchNeon;
+#endif
 
 MLAS_FORCEINLINE
 const MLAS_SBGEMM_DISPATCH*
@@ -291,109 +308,67 @@ MlasSBGemmGetDispatch()
 {
 #if defined(MLAS_TARGET_ARM64)
     return &MlasSBGemmDispatchNeon;
+#elif defined(MLAS_TARGET_AMD64)
+    return GetMlasPlatform().SBGemmDispatch;
 #else
-    std::cerr << "SBGemm Kernel is supported only on ARM64 platform.";
+    std::cerr << "SBGemm Kernel is supported only on ARM64 and AMD64 platforms.";
     exit(1);
 #endif
 }
 
-size_t MLASCALL
-MlasSBGemmPackBSize(size_t N, size_t K)
-{
-    //
-    // Compute the number of bytes required to hold the packed buffer.
-    //
-    const auto* dispatch = MlasSBGemmGetDispatch();
-    if (dispatch == nullptr) return 0;
-
-    const auto padding = dispatch->BufOverRead;
-    const auto PackedK = dispatch->PackedK;
-    const auto PackedN = dispatch->PackedN;
+#if defined(MLAS_TARGET_AMD64)
 
-    const size_t AlignedK = (K + PackedK - 1) & ~(PackedK - 1);
-    const size_t AlignedN = (N + PackedN - 1) & ~(PackedN - 1);
-    const size_t BytesRequired = AlignedN * AlignedK * sizeof(bfloat16_t) + padding;
-    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
-    const size_t AlignedBytesRequired =
-        (BytesRequired + BufferAlignment - 1) & ~(BufferAlignment - 1);
-
-    return AlignedBytesRequired;
-}
-
-void MLASCALL
-MlasSBGemmConvertPackB(size_t N, size_t K, const float* B, size_t ldb, void* PackedB)
-{
-    const auto* dispatch = MlasSBGemmGetDispatch();
-    if (dispatch == nullptr) return;
-
-    dispatch->ConvertPackBRoutine((bfloat16_t*)PackedB, B, ldb, N, K);
-}
-
-void MLASCALL
-MlasSBGemmBatch(const size_t M, const size_t N, const size_t K, const size_t BatchN, const MLAS_SBGEMM_DATA_PARAMS* Data, MLAS_THREADPOOL* ThreadPool)
+/**
+ * @brief Round a fp32 value to the nearest bf16 value, ties to even.
+ */
+MLAS_FORCEINLINE
+bfloat16_t
+MlasFp32ToBf16(float Value)
 {
-    const MLAS_SBGEMM_DISPATCH* dispatch = MlasSBGemmGetDispatch();
-    if (dispatch == nullptr) return;
-
-    MLAS_SBGEMM_OPERATION* operation = dispatch->Operation;
-
-    //
-    // Compute the number of target threads given the complexity of the SGEMM
-    // operation. Small requests should run using the single threaded path.
-    //
-
-    const double Complexity = double(M) * double(N) * double(K);
-
-    ptrdiff_t TargetThreadCount;
-
-    if (Complexity < double(MLAS_SBGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
-        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
-    } else {
-        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    uint32_t Bits;
+    std::memcpy(&Bits, &Value, sizeof(Bits));
+    if ((Bits & 0x7fffffff) > 0x7f800000) {
+        return bfloat16_t((Bits >> 16) | 0x40);  // quiet NaN
     }
+    Bits += 0x7fff + ((Bits >> 16) & 1);
+    return bfloat16_t(Bits >> 16);
+}
 
-    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
-
-    if (TargetThreadCount >= MaximumThreadCount) {
-        TargetThreadCount = MaximumThreadCount;
-    }
-
-    //
-    // Segment the operation across multiple threads.
-    //
-    // N.B. Currently, the operation is segmented as a 1D partition, which
-    // works okay for operations involving skinny matrices.
-    //
-    ptrdiff_t ThreadsPerGemm = (TargetThreadCount + BatchN - 1) / BatchN;
-    ptrdiff_t ThreadCountM;
-    ptrdiff_t ThreadCountN;
-
-    if (N > M) {
-        const size_t BlockedN =
-            (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) / MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
-
-        if (size_t(ThreadsPerGemm) > BlockedN) {
-            ThreadsPerGemm = ptrdiff_t(BlockedN);
-        }
-
-        ThreadCountM = 1;
-        ThreadCountN = ThreadsPerGemm;
+/**
+ * @brief Convert fp32 matrix B to bf16 and pack it in the layout of the x64
+ *        kernels. Blocks of StrideK rows are packed one after another.
+ *
+ * @param[out] D         Address of packing buffer
+ * @param[in]  B         Address of source matrix B in fp32
+ * @param[in]  ldb       Leading dimension of B
+ * @param[in]  CountN    # of column to pack
+ * @param[in]  CountK    # of rows to pack
+ * @param[in]  StrideK   # of rows of a block
+ */
+void
+MlasSBGemmConvertPackBX64(
+    bfloat16_t* D, const float* B, size_t ldb, size_t CountN, size_t CountK, size_t StrideK
+);
 
-    } else {
-        if (size_t(ThreadsPerGemm) > M) {
-            ThreadsPerGemm = ptrdiff_t(M);
-        }
+/**
+ * @brief Compute C = A * B (+ Bias or C) for the packed B layout of the x64
+ *        kernels with AVX512-BF16 instructions. The AMX kernel uses it for
+ *        the rows that do not fill a tile.
+ */
+void
+MlasSBGemmKernelAvx512Bf16(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    const float* A,
+    size_t lda,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    bool ZeroMode
+);
 
-        ThreadCountM = ThreadsPerGemm;
-        ThreadCountN = 1;
-    }
+#endif
 
-    MlasTrySimpleParallel(
-        ThreadPool, ThreadsPerGemm * static_cast<ptrdiff_t>(BatchN), [=](ptrdiff_t tid) {
-            ptrdiff_t GemmIdx = tid / ThreadsPerGemm;
-            ptrdiff_t ThreadIdx = tid % ThreadsPerGemm;
-            operation(ThreadCountM, ThreadCountN, M, N, K, &(Data[GemmIdx]), ThreadIdx);
-        }
-    );
-}
-#endif  // defined(__aarch64__) && defined(__linux__)
+#endif  // defined(MLAS_SUPPORTS_SBGEMM)
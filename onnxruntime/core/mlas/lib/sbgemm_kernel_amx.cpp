@@ -0,0 +1,229 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_amx.cpp
+
+Abstract:
+
+    This module implements bfloat16 precision GEMM kernel for AMX-BF16.
+
+    A block of 32 rows by 32 columns of C is computed in four tiles, with two
+    tiles of A and two tiles of B (the packed B panels are in the VNNI layout
+    of the B tiles). Fewer than 16 remaining rows are computed by the
+    AVX512-BF16 kernel.
+
+--*/
+
+#include "mlasi.h"
+#include "sbgemm.h"
+#include "amx_common.h"
+
+#include <cstring>
+
+struct MLAS_SBGEMM_KERNEL_AMX {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = 32;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 2;
+    static constexpr size_t PackedN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    static constexpr MLAS_SBGEMM_STRIDES Strides{128, 128, 256};  // M:N:K
+};
+
+template <>
+MLAS_FORCEINLINE void
+MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AMX>(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    MlasSBGemmConvertPackBX64(PackedB, B, ldb, CountN, CountK, CountK);
+}
+
+static void
+MlasSBGemmConvertPackBAmx(bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK)
+{
+    MlasSBGemmConvertPackBX64(PackedB, B, ldb, CountN, CountK, MLAS_SBGEMM_KERNEL_AMX::Strides.K);
+}
+
+static void
+MlasSBGemmTileConfigAmx()
+{
+    static thread_local struct tileconfig_t tc;
+    struct tileconfig_t current_tc;
+    tile_storeconfig(&current_tc);
+
+    if (tc.palette_id == 0 || std::memcmp(&current_tc, &tc, sizeof(tc)) != 0) {
+        tc.palette_id = 1;
+        for (int t = 0; t < 8; t++) {
+            tc.rows[t] = 16;
+            tc.colb[t] = 64;
+        }
+
+        tile_loadconfig(&tc);
+    }
+}
+
+MLAS_FORCEINLINE
+__mmask16
+MlasSBGemmMask16Amx(size_t Count)
+{
+    return (Count >= 16) ? __mmask16(0xffff) : __mmask16((1u << Count) - 1);
+}
+
+/**
+ * @brief Convert CountK values of a row of A to bf16, ties to even. The row
+ *        is padded with zeros to AlignedK values, a multiple of 32.
+ */
+MLAS_FORCEINLINE
+void
+MlasSBGemmConvertRowAmx(bfloat16_t* D, const float* A, size_t CountK, size_t AlignedK)
+{
+    for (size_t k = 0; k < AlignedK; k += 32) {
+        const size_t Remaining = (k < CountK) ? CountK - k : 0;
+        const __m512 lo = _mm512_maskz_loadu_ps(MlasSBGemmMask16Amx(Remaining), A + k);
+        const __m512 hi = _mm512_maskz_loadu_ps(MlasSBGemmMask16Amx(Remaining > 16 ? Remaining - 16 : 0), A + k + 16);
+        _mm512_storeu_si512(D + k, (__m512i)_mm512_cvtne2ps_pbh(hi, lo));
+    }
+}
+
+/**
+ * @brief Load the B tile of the row pairs [PairStart, PairStart + 16) of a
+ *        panel. A partial tile is padded with zeros.
+ */
+#define MlasSBGemmLoadTileBAmx(Tile, Panel, PairStart, PairCountK, Scratch)                    \
+    if ((PairStart) + 16 <= (PairCountK)) {                                                    \
+        tile_loadd(Tile, (Panel) + (PairStart) * 32, 64);                                      \
+    } else {                                                                                   \
+        std::memset(Scratch, 0, 16 * 64);                                                      \
+        std::memcpy(Scratch, (Panel) + (PairStart) * 32, ((PairCountK) - (PairStart)) * 64);   \
+        tile_loadd(Tile, Scratch, 64);                                                         \
+    }
+
+MLAS_FORCEINLINE
+void
+MlasSBGemmStoreRowAmx(float* C, const float* Addend, const float* Tile, size_t CountN)
+{
+    const __mmask16 Mask = MlasSBGemmMask16Amx(CountN);
+    __m512 Acc = _mm512_maskz_loadu_ps(Mask, Tile);
+    if (Addend != nullptr) {
+        Acc = _mm512_add_ps(Acc, _mm512_maskz_loadu_ps(Mask, Addend));
+    }
+    _mm512_mask_storeu_ps(C, Mask, Acc);
+}
+
+template <>
+MLAS_FORCEINLINE void
+MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AMX>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    const float* A,
+    size_t lda,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const bool ZeroMode
+)
+{
+    constexpr size_t KernelMaxM = MLAS_SBGEMM_KERNEL_AMX::KernelMaxM;
+    constexpr size_t StrideK = MLAS_SBGEMM_KERNEL_AMX::Strides.K;
+
+    const size_t PanelStride = ((CountK + 1) & ~size_t{1}) * 16;
+    MLAS_DECLSPEC_ALIGN(bfloat16_t PanelA[KernelMaxM * StrideK], 64);
+    MLAS_DECLSPEC_ALIGN(float Tiles[KernelMaxM * 32], 64);
+    MLAS_DECLSPEC_ALIGN(bfloat16_t Scratch[16 * 32], 64);
+
+    if (CountM >= 16) {
+        MlasSBGemmTileConfigAmx();
+    }
+
+    while (CountM >= 16) {
+        const size_t RowCount = std::min(CountM, KernelMaxM);
+
+        //
+        // Step through the K dimension in chunks that fit the A panel. The
+        // partial results of the earlier chunks are accumulated in C.
+        //
+        size_t CountChunkK;
+        for (size_t k = 0; k < CountK; k += CountChunkK) {
+            CountChunkK = std::min(CountK - k, StrideK);
+            const size_t PairCountK = (CountChunkK + 1) / 2;
+            const size_t AlignedChunkK = (CountChunkK + 31) & ~size_t{31};
+            const size_t StrideA = AlignedChunkK * sizeof(bfloat16_t);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                MlasSBGemmConvertRowAmx(PanelA + r * AlignedChunkK, A + r * lda + k, CountChunkK, AlignedChunkK);
+            }
+            if (RowCount < KernelMaxM) {
+                std::memset(PanelA + RowCount * AlignedChunkK, 0, (KernelMaxM - RowCount) * StrideA);
+            }
+
+            const bool ZeroChunk = ZeroMode && (k == 0);
+            const float* bias = Bias;
+
+            for (size_t n = 0; n < CountN; n += 32) {
+                const bfloat16_t* b0 = B + (n / 16) * PanelStride + k * 16;
+                const bfloat16_t* b1 = b0 + PanelStride;
+                const bool TwoPanels = CountN - n > 16;
+
+                tile_zero(0);
+                tile_zero(1);
+                tile_zero(2);
+                tile_zero(3);
+
+                for (size_t p = 0; p < PairCountK; p += 16) {
+                    tile_loadd(4, PanelA + p * 2, StrideA);
+                    tile_loadd(5, PanelA + 16 * AlignedChunkK + p * 2, StrideA);
+                    MlasSBGemmLoadTileBAmx(6, b0, p, PairCountK, Scratch);
+                    tile_dpbf16ps(0, 4, 6);
+                    tile_dpbf16ps(2, 5, 6);
+                    if (TwoPanels) {
+                        MlasSBGemmLoadTileBAmx(7, b1, p, PairCountK, Scratch);
+                        tile_dpbf16ps(1, 4, 7);
+                        tile_dpbf16ps(3, 5, 7);
+                    }
+                }
+
+                tile_stored(0, Tiles, 32 * sizeof(float));
+                tile_stored(1, Tiles + 16, 32 * sizeof(float));
+                tile_stored(2, Tiles + 16 * 32, 32 * sizeof(float));
+                tile_stored(3, Tiles + 16 * 32 + 16, 32 * sizeof(float));
+
+                const size_t CountBlockN = std::min(CountN - n, size_t{32});
+                for (size_t r = 0; r < RowCount; r++) {
+                    float* c = C + r * ldc + n;
+                    const float* Addend = ZeroChunk ? bias : c;
+                    MlasSBGemmStoreRowAmx(c, Addend, Tiles + r * 32, CountBlockN);
+                    if (CountBlockN > 16) {
+                        MlasSBGemmStoreRowAmx(c + 16, (Addend != nullptr) ? Addend + 16 : nullptr, Tiles + r * 32 + 16, CountBlockN - 16);
+                    }
+                }
+
+                if (bias != nullptr) {
+                    bias += 32;
+                }
+            }
+        }
+
+        A += lda * RowCount;
+        C += ldc * RowCount;
+        CountM -= RowCount;
+    }
+
+    if (CountM > 0) {
+        MlasSBGemmKernelAvx512Bf16(CountM, CountN, CountK, A, lda, B, C, ldc, Bias, ZeroMode);
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAmx = {
+    MlasSBGemmOperation<MLAS_SBGEMM_KERNEL_AMX>,
+    MlasSBGemmConvertPackBAmx,
+    MLAS_SBGEMM_KERNEL_AMX::PackedK,
+    MLAS_SBGEMM_KERNEL_AMX::PackedN,
+    MLAS_SBGEMM_KERNEL_AMX::KernelMaxM,
+    0
+};
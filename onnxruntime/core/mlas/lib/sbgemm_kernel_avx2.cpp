@@ -0,0 +1,239 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements bfloat16 precision GEMM kernel for AVX2.
+
+    The processor has no bf16 dot product instruction, so the kernel emulates
+    VDPBF16PS: A is rounded to bf16, the packed bf16 values of B are widened
+    to fp32 and the products are accumulated with FMA3. The results match the
+    native kernels up to the order of the additions, which makes the bf16
+    fast math mode testable on any AVX2 machine.
+
+--*/
+
+#include "mlasi.h"
+#include "sbgemm.h"
+
+struct MLAS_SBGEMM_KERNEL_AVX2 {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = 4;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 2;
+    static constexpr size_t PackedN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    static constexpr MLAS_SBGEMM_STRIDES Strides{128, 128, 256};  // M:N:K
+};
+
+template <>
+MLAS_FORCEINLINE void
+MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AVX2>(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    MlasSBGemmConvertPackBX64(PackedB, B, ldb, CountN, CountK, CountK);
+}
+
+static void
+MlasSBGemmConvertPackBAvx2(bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK)
+{
+    MlasSBGemmConvertPackBX64(PackedB, B, ldb, CountN, CountK, MLAS_SBGEMM_KERNEL_AVX2::Strides.K);
+}
+
+/**
+ * @brief Round fp32 values to bf16 precision, ties to even, keeping them in
+ *        fp32 format.
+ */
+MLAS_FORCEINLINE
+__m256
+MlasRoundBf16Avx2(__m256 Value)
+{
+    const __m256i Bits = _mm256_castps_si256(Value);
+    const __m256i Lsb = _mm256_and_si256(_mm256_srli_epi32(Bits, 16), _mm256_set1_epi32(1));
+    __m256i Rounded = _mm256_add_epi32(Bits, _mm256_add_epi32(Lsb, _mm256_set1_epi32(0x7fff)));
+    Rounded = _mm256_and_si256(Rounded, _mm256_set1_epi32(int(0xffff0000)));
+    const __m256 IsNan = _mm256_cmp_ps(Value, Value, _CMP_UNORD_Q);
+    return _mm256_blendv_ps(_mm256_castsi256_ps(Rounded), Value, IsNan);
+}
+
+/**
+ * @brief Round CountK values of a row of A to bf16 precision. The row is
+ *        padded with a zero to an even length.
+ */
+MLAS_FORCEINLINE
+void
+MlasSBGemmConvertRowAvx2(float* D, const float* A, size_t CountK)
+{
+    size_t k = 0;
+    for (; k + 8 <= CountK; k += 8) {
+        _mm256_storeu_ps(D + k, MlasRoundBf16Avx2(_mm256_loadu_ps(A + k)));
+    }
+    if (k < CountK) {
+        float Buffer[8] = {};
+        std::copy_n(A + k, CountK - k, Buffer);
+        _mm256_storeu_ps(Buffer, MlasRoundBf16Avx2(_mm256_loadu_ps(Buffer)));
+        std::copy_n(Buffer, CountK - k, D + k);
+        k = CountK;
+    }
+    if ((k & 1) != 0) {
+        D[k] = 0.0f;
+    }
+}
+
+/**
+ * @brief Compute RowCount rows of C for each panel of 16 columns.
+ *
+ * @param CountN      # of columns of C
+ * @param PairCountK  # of row pairs of the panels of B to process
+ * @param A           Rows of A rounded to bf16 precision, lda is 2*PairCountK
+ * @param B           First panel of B
+ * @param PanelStride # of elements of a panel of B
+ */
+template <size_t RowCount>
+MLAS_FORCEINLINE void
+MlasSBGemmRowsAvx2(
+    size_t CountN,
+    size_t PairCountK,
+    const float* A,
+    const bfloat16_t* B,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    const size_t lda = PairCountK * 2;
+    const __m256i HighMask = _mm256_set1_epi32(int(0xffff0000));
+
+    for (size_t n = 0; n < CountN; n += 16) {
+        __m256 Acc0[RowCount];
+        __m256 Acc1[RowCount];
+        for (size_t r = 0; r < RowCount; r++) {
+            Acc0[r] = _mm256_setzero_ps();
+            Acc1[r] = _mm256_setzero_ps();
+        }
+
+        const bfloat16_t* b = B;
+        for (size_t p = 0; p < PairCountK; p++) {
+            const __m256i B0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+            const __m256i B1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 16));
+            const __m256 B0Even = _mm256_castsi256_ps(_mm256_slli_epi32(B0, 16));
+            const __m256 B0Odd = _mm256_castsi256_ps(_mm256_and_si256(B0, HighMask));
+            const __m256 B1Even = _mm256_castsi256_ps(_mm256_slli_epi32(B1, 16));
+            const __m256 B1Odd = _mm256_castsi256_ps(_mm256_and_si256(B1, HighMask));
+
+            for (size_t r = 0; r < RowCount; r++) {
+                const __m256 AEven = _mm256_broadcast_ss(A + r * lda + p * 2);
+                const __m256 AOdd = _mm256_broadcast_ss(A + r * lda + p * 2 + 1);
+                Acc0[r] = _mm256_fmadd_ps(AEven, B0Even, Acc0[r]);
+                Acc0[r] = _mm256_fmadd_ps(AOdd, B0Odd, Acc0[r]);
+                Acc1[r] = _mm256_fmadd_ps(AEven, B1Even, Acc1[r]);
+                Acc1[r] = _mm256_fmadd_ps(AOdd, B1Odd, Acc1[r]);
+            }
+            b += 32;
+        }
+
+        const size_t CountPanelN = std::min(CountN - n, size_t{16});
+        for (size_t r = 0; r < RowCount; r++) {
+            float* c = C + r * ldc + n;
+            const float* Addend = ZeroMode ? Bias : c;
+            if (CountPanelN == 16) {
+                if (Addend != nullptr) {
+                    Acc0[r] = _mm256_add_ps(Acc0[r], _mm256_loadu_ps(Addend));
+                    Acc1[r] = _mm256_add_ps(Acc1[r], _mm256_loadu_ps(Addend + 8));
+                }
+                _mm256_storeu_ps(c, Acc0[r]);
+                _mm256_storeu_ps(c + 8, Acc1[r]);
+            } else {
+                float Buffer[16];
+                _mm256_storeu_ps(Buffer, Acc0[r]);
+                _mm256_storeu_ps(Buffer + 8, Acc1[r]);
+                for (size_t nn = 0; nn < CountPanelN; nn++) {
+                    c[nn] = Buffer[nn] + ((Addend != nullptr) ? Addend[nn] : 0.0f);
+                }
+            }
+        }
+
+        if (Bias != nullptr) {
+            Bias += 16;
+        }
+        B += PanelStride;
+    }
+}
+
+template <>
+MLAS_FORCEINLINE void
+MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AVX2>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    const float* A,
+    size_t lda,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const bool ZeroMode
+)
+{
+    constexpr size_t KernelMaxM = MLAS_SBGEMM_KERNEL_AVX2::KernelMaxM;
+    constexpr size_t StrideK = MLAS_SBGEMM_KERNEL_AVX2::Strides.K;
+
+    const size_t PanelStride = ((CountK + 1) & ~size_t{1}) * 16;
+    MLAS_DECLSPEC_ALIGN(float PanelA[KernelMaxM * StrideK], 32);
+
+    while (CountM > 0) {
+        const size_t RowCount = std::min(CountM, KernelMaxM);
+
+        //
+        // Step through the K dimension in chunks that fit the A panel. The
+        // partial results of the earlier chunks are accumulated in C.
+        //
+        size_t CountChunkK;
+        for (size_t k = 0; k < CountK; k += CountChunkK) {
+            CountChunkK = std::min(CountK - k, StrideK);
+            const size_t PairCountK = (CountChunkK + 1) / 2;
+
+            for (size_t r = 0; r < RowCount; r++) {
+                MlasSBGemmConvertRowAvx2(PanelA + r * PairCountK * 2, A + r * lda + k, CountChunkK);
+            }
+
+            const bfloat16_t* b = B + k * 16;
+            const bool ZeroChunk = ZeroMode && (k == 0);
+            switch (RowCount) {
+                case 1:
+                    MlasSBGemmRowsAvx2<1>(CountN, PairCountK, PanelA, b, PanelStride, C, ldc, Bias, ZeroChunk);
+                    break;
+                case 2:
+                    MlasSBGemmRowsAvx2<2>(CountN, PairCountK, PanelA, b, PanelStride, C, ldc, Bias, ZeroChunk);
+                    break;
+                case 3:
+                    MlasSBGemmRowsAvx2<3>(CountN, PairCountK, PanelA, b, PanelStride, C, ldc, Bias, ZeroChunk);
+                    break;
+                default:
+                    MlasSBGemmRowsAvx2<4>(CountN, PairCountK, PanelA, b, PanelStride, C, ldc, Bias, ZeroChunk);
+                    break;
+            }
+        }
+
+        A += lda * RowCount;
+        C += ldc * RowCount;
+        CountM -= RowCount;
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx2 = {
+    MlasSBGemmOperation<MLAS_SBGEMM_KERNEL_AVX2>,
+    MlasSBGemmConvertPackBAvx2,
+    MLAS_SBGEMM_KERNEL_AVX2::PackedK,
+    MLAS_SBGEMM_KERNEL_AVX2::PackedN,
+    MLAS_SBGEMM_KERNEL_AVX2::KernelMaxM,
+    0
+};
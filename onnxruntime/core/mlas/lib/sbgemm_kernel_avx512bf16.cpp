@@ -0,0 +1,263 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_avx512bf16.cpp
+
+Abstract:
+
+    This module implements bfloat16 precision GEMM kernel for AVX512-BF16.
+
+    Rows of A are converted to bf16 pairs with VCVTNE2PS2BF16 and multiplied
+    with the packed B panels by VDPBF16PS, which accumulates in fp32.
+
+--*/
+
+#include "mlasi.h"
+#include "sbgemm.h"
+
+struct MLAS_SBGEMM_KERNEL_AVX512BF16 {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = 8;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 2;
+    static constexpr size_t PackedN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    static constexpr MLAS_SBGEMM_STRIDES Strides{128, 128, 256};  // M:N:K
+};
+
+template <>
+MLAS_FORCEINLINE void
+MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AVX512BF16>(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    MlasSBGemmConvertPackBX64(PackedB, B, ldb, CountN, CountK, CountK);
+}
+
+static void
+MlasSBGemmConvertPackBAvx512Bf16(bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK)
+{
+    MlasSBGemmConvertPackBX64(PackedB, B, ldb, CountN, CountK, MLAS_SBGEMM_KERNEL_AVX512BF16::Strides.K);
+}
+
+MLAS_FORCEINLINE
+__mmask16
+MlasSBGemmMask16(size_t Count)
+{
+    return (Count >= 16) ? __mmask16(0xffff) : __mmask16((1u << Count) - 1);
+}
+
+/**
+ * @brief Convert CountK values of a row of A to bf16, ties to even. The row
+ *        is padded with a zero to an even length.
+ */
+MLAS_FORCEINLINE
+void
+MlasSBGemmConvertRowAvx512Bf16(uint32_t* D, const float* A, size_t CountK)
+{
+    size_t k = 0;
+    for (; k + 32 <= CountK; k += 32) {
+        const __m512bh v = _mm512_cvtne2ps_pbh(_mm512_loadu_ps(A + k + 16), _mm512_loadu_ps(A + k));
+        _mm512_storeu_si512(D + k / 2, (__m512i)v);
+    }
+    if (k < CountK) {
+        const size_t Remaining = CountK - k;
+        const __m512 lo = _mm512_maskz_loadu_ps(MlasSBGemmMask16(Remaining), A + k);
+        const __m512 hi = _mm512_maskz_loadu_ps(MlasSBGemmMask16(Remaining > 16 ? Remaining - 16 : 0), A + k + 16);
+        const __m512bh v = _mm512_cvtne2ps_pbh(hi, lo);
+        _mm512_mask_storeu_epi32(D + k / 2, MlasSBGemmMask16((Remaining + 1) / 2), (__m512i)v);
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasSBGemmStoreAvx512Bf16(float* C, const float* Addend, __m512 Acc, size_t CountN)
+{
+    if (CountN >= 16) {
+        if (Addend != nullptr) {
+            Acc = _mm512_add_ps(Acc, _mm512_loadu_ps(Addend));
+        }
+        _mm512_storeu_ps(C, Acc);
+    } else {
+        const __mmask16 Mask = MlasSBGemmMask16(CountN);
+        if (Addend != nullptr) {
+            Acc = _mm512_add_ps(Acc, _mm512_maskz_loadu_ps(Mask, Addend));
+        }
+        _mm512_mask_storeu_ps(C, Mask, Acc);
+    }
+}
+
+/**
+ * @brief Compute RowCount rows of C for each pair of panels of 16 columns.
+ *
+ * @param CountN      # of columns of C
+ * @param PairCountK  # of row pairs of the panels of B to process
+ * @param A           Rows of A converted to bf16 pairs, lda is PairCountK
+ * @param B           First panel of B
+ * @param PanelStride # of elements of a panel of B
+ */
+template <size_t RowCount>
+MLAS_FORCEINLINE void
+MlasSBGemmRowsAvx512Bf16(
+    size_t CountN,
+    size_t PairCountK,
+    const uint32_t* A,
+    const bfloat16_t* B,
+    size_t PanelStride,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    for (size_t n = 0; n < CountN; n += 32) {
+        __m512 Acc0[RowCount];
+        __m512 Acc1[RowCount];
+        for (size_t r = 0; r < RowCount; r++) {
+            Acc0[r] = _mm512_setzero_ps();
+            Acc1[r] = _mm512_setzero_ps();
+        }
+
+        const bfloat16_t* b0 = B;
+        if (CountN - n > 16) {
+            const bfloat16_t* b1 = B + PanelStride;
+            for (size_t p = 0; p < PairCountK; p++) {
+                const __m512bh B0 = (__m512bh)_mm512_loadu_si512(b0);
+                const __m512bh B1 = (__m512bh)_mm512_loadu_si512(b1);
+                for (size_t r = 0; r < RowCount; r++) {
+                    const __m512bh a = (__m512bh)_mm512_set1_epi32(int(A[r * PairCountK + p]));
+                    Acc0[r] = _mm512_dpbf16_ps(Acc0[r], a, B0);
+                    Acc1[r] = _mm512_dpbf16_ps(Acc1[r], a, B1);
+                }
+                b0 += 32;
+                b1 += 32;
+            }
+        } else {
+            for (size_t p = 0; p < PairCountK; p++) {
+                const __m512bh B0 = (__m512bh)_mm512_loadu_si512(b0);
+                for (size_t r = 0; r < RowCount; r++) {
+                    const __m512bh a = (__m512bh)_mm512_set1_epi32(int(A[r * PairCountK + p]));
+                    Acc0[r] = _mm512_dpbf16_ps(Acc0[r], a, B0);
+                }
+                b0 += 32;
+            }
+        }
+
+        const size_t CountBlockN = std::min(CountN - n, size_t{32});
+        for (size_t r = 0; r < RowCount; r++) {
+            float* c = C + r * ldc + n;
+            const float* Addend = ZeroMode ? Bias : c;
+            MlasSBGemmStoreAvx512Bf16(c, Addend, Acc0[r], CountBlockN);
+            if (CountBlockN > 16) {
+                MlasSBGemmStoreAvx512Bf16(c + 16, (Addend != nullptr) ? Addend + 16 : nullptr, Acc1[r], CountBlockN - 16);
+            }
+        }
+
+        if (Bias != nullptr) {
+            Bias += 32;
+        }
+        B += PanelStride * 2;
+    }
+}
+
+void
+MlasSBGemmKernelAvx512Bf16(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    const float* A,
+    size_t lda,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    constexpr size_t KernelMaxM = MLAS_SBGEMM_KERNEL_AVX512BF16::KernelMaxM;
+    constexpr size_t StrideK = MLAS_SBGEMM_KERNEL_AVX512BF16::Strides.K;
+
+    const size_t PanelStride = ((CountK + 1) & ~size_t{1}) * 16;
+    MLAS_DECLSPEC_ALIGN(uint32_t PanelA[KernelMaxM * StrideK / 2], 64);
+
+    while (CountM > 0) {
+        const size_t RowCount = std::min(CountM, KernelMaxM);
+
+        //
+        // Step through the K dimension in chunks that fit the A panel. The
+        // partial results of the earlier chunks are accumulated in C.
+        //
+        size_t CountChunkK;
+        for (size_t k = 0; k < CountK; k += CountChunkK) {
+            CountChunkK = std::min(CountK - k, StrideK);
+            const size_t PairCountK = (CountChunkK + 1) / 2;
+
+            for (size_t r = 0; r < RowCount; r++) {
+                MlasSBGemmConvertRowAvx512Bf16(PanelA + r * PairCountK, A + r * lda + k, CountChunkK);
+            }
+
+            const bfloat16_t* b = B + k * 16;
+            const bool ZeroChunk = ZeroMode && (k == 0);
+            switch (RowCount) {
+                case 1:
+                    MlasSBGemmRowsAvx512Bf16<1>(CountN, PairCountK, PanelA, b, PanelStride, C, ldc, Bias, ZeroChunk);
+                    break;
+                case 2:
+                    MlasSBGemmRowsAvx512Bf16<2>(CountN, PairCountK, PanelA, b, PanelStride, C, ldc, Bias, ZeroChunk);
+                    break;
+                case 3:
+                    MlasSBGemmRowsAvx512Bf16<3>(CountN, PairCountK, PanelA, b, PanelStride, C, ldc, Bias, ZeroChunk);
+                    break;
+                case 4:
+                    MlasSBGemmRowsAvx512Bf16<4>(CountN, PairCountK, PanelA, b, PanelStride, C, ldc, Bias, ZeroChunk);
+                    break;
+                case 5:
+                    MlasSBGemmRowsAvx512Bf16<5>(CountN, PairCountK, PanelA, b, PanelStride, C, ldc, Bias, ZeroChunk);
+                    break;
+                case 6:
+                    MlasSBGemmRowsAvx512Bf16<6>(CountN, PairCountK, PanelA, b, PanelStride, C, ldc, Bias, ZeroChunk);
+                    break;
+                case 7:
+                    MlasSBGemmRowsAvx512Bf16<7>(CountN, PairCountK, PanelA, b, PanelStride, C, ldc, Bias, ZeroChunk);
+                    break;
+                default:
+                    MlasSBGemmRowsAvx512Bf16<8>(CountN, PairCountK, PanelA, b, PanelStride, C, ldc, Bias, ZeroChunk);
+                    break;
+            }
+        }
+
+        A += lda * RowCount;
+        C += ldc * RowCount;
+        CountM -= RowCount;
+    }
+}
+
+template <>
+MLAS_FORCEINLINE void
+MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AVX512BF16>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    const float* A,
+    size_t lda,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const bool ZeroMode
+)
+{
+    MlasSBGemmKernelAvx512Bf16(CountM, CountN, CountK, A, lda, B, C, ldc, Bias, ZeroMode);
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512Bf16 = {
+    MlasSBGemmOperation<MLAS_SBGEMM_KERNEL_AVX512BF16>,
+    MlasSBGemmConvertPackBAvx512Bf16,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::PackedK,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::PackedN,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::KernelMaxM,
+    0
+};
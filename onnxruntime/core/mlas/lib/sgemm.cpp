@@ -1003,6 +1003,53 @@ Return Value:
 
 #endif
 
+MLAS_FORCEINLINE
+void
+MlasSgemmOutputProcess(
+    const MLAS_GEMM_POSTPROCESSOR<float>* OutputProcessor,
+    float* C,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine invokes the optional output processor on a block of the
+    output matrix.
+
+Arguments:
+
+    OutputProcessor - Supplies the optional output processor.
+
+    C - Supplies the address of the first element of the block.
+
+    StartM - Supplies the row of the block within the matrix passed to the
+        output processor.
+
+    StartN - Supplies the column of the block within the matrix passed to the
+        output processor.
+
+    CountM - Supplies the number of rows of the block.
+
+    CountN - Supplies the number of columns of the block.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (OutputProcessor != nullptr) {
+        OutputProcessor->Process(C - (StartM * ldc + StartN), StartM, StartN, CountM, CountN, ldc);
+    }
+}
+
 MLAS_FORCEINLINE
 float*
 MlasSgemmKernelLoop(
@@ -1015,7 +1062,10 @@ MlasSgemmKernelLoop(
     size_t lda,
     size_t ldc,
     float alpha,
-    bool ZeroMode
+    bool ZeroMode,
+    const MLAS_GEMM_POSTPROCESSOR<float>* OutputProcessor,
+    size_t StartM,
+    size_t StartN
     )
 /*++
 
@@ -1051,6 +1101,15 @@ Arguments:
     ZeroMode - Supplies true if the output matrix must be zero initialized,
         else false if the output matrix is accumulated into.
 
+    OutputProcessor - Supplies the optional output processor to invoke on each
+        block of rows as soon as the kernel has computed it.
+
+    StartM - Supplies the row of matrix C within the matrix passed to the
+        output processor.
+
+    StartN - Supplies the column of matrix C within the matrix passed to the
+        output processor.
+
 Return Value:
 
     Returns the next address of matrix C.
@@ -1071,9 +1130,12 @@ Return Value:
         }
 #endif
 
+        MlasSgemmOutputProcess(OutputProcessor, C, StartM, StartN, RowsHandled, CountN, ldc);
+
         C += ldc * RowsHandled;
         A += lda * RowsHandled;
         CountM -= RowsHandled;
+        StartM += RowsHandled;
     }
 
     return C;
@@ -1093,7 +1155,10 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_GEMM_POSTPROCESSOR<float>* OutputProcessor,
+    size_t StartM,
+    size_t StartN
     )
 /*++
 
@@ -1131,6 +1196,17 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    OutputProcessor - Supplies the optional output processor. Each block of
+        rows of matrix C is processed after the last slice of matrix B along
+        the K dimension has been accumulated into it, while the block is still
+        in the cache.
+
+    StartM - Supplies the row of matrix C within the matrix passed to the
+        output processor.
+
+    StartN - Supplies the column of matrix C within the matrix passed to the
+        output processor.
+
 Return Value:
 
     None.
@@ -1147,6 +1223,7 @@ Return Value:
 
     if (K == 0) {
         MlasSgemmMultiplyBeta(C, M, N, ldc, beta);
+        MlasSgemmOutputProcess(OutputProcessor, C, StartM, StartN, M, N, ldc);
         return;
     }
 
@@ -1170,6 +1247,7 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+            MlasSgemmOutputProcess(OutputProcessor, C, StartM, StartN, M, N, ldc);
             return;
         }
 
@@ -1177,6 +1255,7 @@ Return Value:
 
         if (TransB == CblasNoTrans) {
             MlasGemvFloatKernel(A, B, C, K, N, ldb, (beta == 0.0f));
+            MlasSgemmOutputProcess(OutputProcessor, C, StartM, StartN, M, N, ldc);
             return;
         }
 
@@ -1205,6 +1284,7 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(B, A, C, K, M, lda, beta);
+            MlasSgemmOutputProcess(OutputProcessor, C, StartM, StartN, M, N, ldc);
             return;
         }
 
@@ -1246,6 +1326,14 @@ Return Value:
 
     for (size_t n = 0; n < N; n += CountN) {
 
+        //
+        // Skip the remaining slices if the deadline of the run has passed.
+        //
+
+        if (MlasDeadlinePassed()) {
+            return;
+        }
+
         CountN = std::min(N - n, StrideN);
 
         //
@@ -1283,9 +1371,13 @@ Return Value:
 
             float* c = C + n;
 
+            const MLAS_GEMM_POSTPROCESSOR<float>* SliceOutputProcessor =
+                (k + CountK == K) ? OutputProcessor : nullptr;
+
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SliceOutputProcessor, StartM, StartN + n);
 
             } else {
 
@@ -1302,14 +1394,15 @@ Return Value:
 
                     MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
 
-                    RowsRemaining -= RowsTransposed;
-                    a += RowsTransposed;
-
                     //
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SliceOutputProcessor, StartM + M - RowsRemaining, StartN + n);
+
+                    RowsRemaining -= RowsTransposed;
+                    a += RowsTransposed;
                 }
             }
 
@@ -1332,7 +1425,10 @@ MlasSgemmPackedOperation(
     size_t AlignedN,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_GEMM_POSTPROCESSOR<float>* OutputProcessor,
+    size_t StartM,
+    size_t StartN
     )
 /*++
 
@@ -1372,6 +1468,17 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    OutputProcessor - Supplies the optional output processor. Each block of
+        rows of matrix C is processed after the last slice of matrix B along
+        the K dimension has been accumulated into it, while the block is still
+        in the cache.
+
+    StartM - Supplies the row of matrix C within the matrix passed to the
+        output processor.
+
+    StartN - Supplies the column of matrix C within the matrix passed to the
+        output processor.
+
 Return Value:
 
     None.
@@ -1388,6 +1495,14 @@ Return Value:
 
     for (size_t n = 0; n < RangeCountN; n += CountN) {
 
+        //
+        // Skip the remaining slices if the deadline of the run has passed.
+        //
+
+        if (MlasDeadlinePassed()) {
+            return;
+        }
+
         const size_t SliceStartN = RangeStartN + n;
 
         CountN = std::min(RangeCountN - n, size_t(MLAS_SGEMM_PACKED_STRIDEN));
@@ -1418,9 +1533,13 @@ Return Value:
             const float* pb = (const float*)PackedB + AlignedN * k + CountK * SliceStartN;
             float* c = C + n;
 
+            const MLAS_GEMM_POSTPROCESSOR<float>* SliceOutputProcessor =
+                (k + CountK == K) ? OutputProcessor : nullptr;
+
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SliceOutputProcessor, StartM, StartN + n);
 
             } else {
 
@@ -1437,14 +1556,15 @@ Return Value:
 
                     MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
 
-                    RowsRemaining -= RowsTransposed;
-                    a += RowsTransposed;
-
                     //
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SliceOutputProcessor, StartM + M - RowsRemaining, StartN + n);
+
+                    RowsRemaining -= RowsTransposed;
+                    a += RowsTransposed;
                 }
             }
 
@@ -1540,7 +1660,8 @@ Return Value:
 
         MlasSgemmPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
             K, DataParams->alpha, A, lda, DataParams->B,
-            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc);
+            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc,
+            DataParams->OutputProcessor, RangeStartM, RangeStartN);
 
     } else {
 
@@ -1549,7 +1670,8 @@ Return Value:
         const float* B = (const float*)DataParams->B + RangeStartN * ((TransB == CblasNoTrans) ? 1 : ldb);
 
         MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, K,
-            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc);
+            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc,
+            DataParams->OutputProcessor, RangeStartM, RangeStartN);
     }
 }
 #if defined(_MSC_VER) && !defined(__clang__)
@@ -16,6 +16,10 @@ class BiasSoftmaxFusion : public GraphTransformer {
   BiasSoftmaxFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
       : GraphTransformer("BiasSoftmaxFusion", compatible_execution_providers) {}
 
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"Add"};
+  }
+
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 };
 
@@ -0,0 +1,261 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_fusion.h"
+
+#include <algorithm>
+#include <array>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+struct FusibleOp {
+  std::string_view op_type;
+  size_t num_inputs;
+  InlinedVector<ONNX_NAMESPACE::OperatorSetVersion> versions;
+};
+
+// Keep in sync with the ops supported by the com.microsoft.FusedElementwise CPU kernel.
+const FusibleOp* GetFusibleOp(const Node& node) {
+  static const FusibleOp fusible_ops[] = {
+      {"Add", 2, {7, 13, 14}},
+      {"Sub", 2, {7, 13, 14}},
+      {"Mul", 2, {7, 13, 14}},
+      {"Div", 2, {7, 13, 14}},
+      {"Max", 2, {8, 12, 13}},
+      {"Min", 2, {8, 12, 13}},
+      {"Relu", 1, {6, 13, 14}},
+      {"Sigmoid", 1, {6, 13}},
+      {"Tanh", 1, {6, 13}},
+      {"Exp", 1, {6, 13}},
+      {"Erf", 1, {9, 13}},
+      {"Neg", 1, {6, 13}},
+      {"Abs", 1, {6, 13}},
+      {"Sqrt", 1, {6, 13}},
+      {"Reciprocal", 1, {6, 13}},
+  };
+
+  for (const auto& op : fusible_ops) {
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, op.op_type, op.versions) &&
+        node.InputDefs().size() == op.num_inputs) {
+      return &op;
+    }
+  }
+
+  return nullptr;
+}
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+bool DimEquals(const TensorShapeProto_Dimension& dim, const TensorShapeProto_Dimension& other) {
+  if (utils::HasDimValue(dim) && utils::HasDimValue(other)) {
+    return dim.dim_value() == other.dim_value();
+  }
+  return utils::HasDimParam(dim) && utils::HasDimParam(other) && dim.dim_param() == other.dim_param();
+}
+
+// Returns true if `arg` has a known shape that broadcasts to `output_shape`, i.e. each of its dims, aligned to the
+// trailing dims of the output, is 1 or the output dim. This matches the broadcasting supported by the
+// FusedElementwise kernel.
+bool BroadcastsToOutput(const NodeArg& arg, const TensorShapeProto& output_shape) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr || shape->dim_size() > output_shape.dim_size()) {
+    return false;
+  }
+
+  const int offset = output_shape.dim_size() - shape->dim_size();
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    const auto& dim = shape->dim(i);
+    if (!(utils::HasDimValue(dim) && dim.dim_value() == 1) && !DimEquals(dim, output_shape.dim(offset + i))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool HasOutputShape(const NodeArg& arg, const TensorShapeProto& output_shape) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr || shape->dim_size() != output_shape.dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    if (!DimEquals(shape->dim(i), output_shape.dim(i))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool IsFusible(const Node& node, const InlinedHashSet<std::string_view>& compatible_providers) {
+  if (GetFusibleOp(node) == nullptr || !graph_utils::IsSupportedProvider(node, compatible_providers) ||
+      node.OutputDefs().size() != 1 || !IsFloatTensor(*node.OutputDefs()[0]) ||
+      node.OutputDefs()[0]->Shape() == nullptr) {
+    return false;
+  }
+
+  return std::all_of(node.InputDefs().begin(), node.InputDefs().end(),
+                     [](const NodeArg* arg) { return arg->Exists() && IsFloatTensor(*arg); });
+}
+
+// A node can join a group for `output_shape` if it computes a full-size value from inputs that broadcast to it.
+bool FitsGroup(const Node& node, const TensorShapeProto& output_shape) {
+  return HasOutputShape(*node.OutputDefs()[0], output_shape) &&
+         std::all_of(node.InputDefs().begin(), node.InputDefs().end(),
+                     [&](const NodeArg* arg) { return BroadcastsToOutput(*arg, output_shape); });
+}
+
+}  // namespace
+
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                    const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  InlinedVector<size_t> topological_position(static_cast<size_t>(graph.MaxNodeIndex()), 0);
+  for (size_t i = 0; i < node_topology_list.size(); ++i) {
+    auto* node = graph.GetNode(node_topology_list[i]);
+    if (node != nullptr) {
+      ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+      topological_position[node_topology_list[i]] = i;
+    }
+  }
+
+  const auto& compatible_providers = GetCompatibleExecutionProviders();
+
+  // Visit consumers before producers so each group is rooted at its last node and grows towards its inputs.
+  for (auto it = node_topology_list.rbegin(); it != node_topology_list.rend(); ++it) {
+    Node* root = graph.GetNode(*it);
+    if (root == nullptr || !IsFusible(*root, compatible_providers)) {
+      continue;
+    }
+
+    const TensorShapeProto& output_shape = *root->OutputDefs()[0]->Shape();
+    if (!FitsGroup(*root, output_shape)) {
+      continue;
+    }
+
+    // Absorb producers whose output is consumed only inside the group. Repeat until no node joins, as a
+    // producer feeding several group nodes qualifies only once all of them have joined.
+    InlinedHashSet<NodeIndex> group{root->Index()};
+    InlinedVector<Node*> group_nodes{root};
+
+    for (bool grew = true; grew;) {
+      grew = false;
+      for (size_t g = 0; g < group_nodes.size(); ++g) {
+        for (auto edge = group_nodes[g]->InputEdgesBegin(); edge != group_nodes[g]->InputEdgesEnd(); ++edge) {
+          Node* producer = graph.GetNode(edge->GetNode().Index());
+          if (group.count(producer->Index()) != 0 || !IsFusible(*producer, compatible_providers) ||
+              graph.NodeProducesGraphOutput(*producer) || !FitsGroup(*producer, output_shape)) {
+            continue;
+          }
+
+          const bool consumed_in_group =
+              std::all_of(producer->OutputEdgesBegin(), producer->OutputEdgesEnd(),
+                          [&](const Node::EdgeEnd& out) { return group.count(out.GetNode().Index()) != 0; });
+          if (!consumed_in_group) {
+            continue;
+          }
+
+          group.insert(producer->Index());
+          group_nodes.push_back(producer);
+          grew = true;
+        }
+      }
+    }
+
+    if (group_nodes.size() < 2) {
+      continue;
+    }
+
+    std::sort(group_nodes.begin(), group_nodes.end(), [&](const Node* a, const Node* b) {
+      return topological_position[a->Index()] < topological_position[b->Index()];
+    });
+
+    // Number the values: external inputs first in order of use, then one value per group node.
+    InlinedHashMap<std::string, int64_t> internal_values;
+    for (size_t k = 0; k < group_nodes.size(); ++k) {
+      internal_values.emplace(group_nodes[k]->OutputDefs()[0]->Name(), static_cast<int64_t>(k));
+    }
+
+    InlinedVector<NodeArg*> inputs;
+    InlinedHashMap<std::string, int64_t> input_indices;
+    for (Node* node : group_nodes) {
+      for (NodeArg* arg : node->MutableInputDefs()) {
+        if (internal_values.count(arg->Name()) == 0 && input_indices.count(arg->Name()) == 0) {
+          input_indices.emplace(arg->Name(), static_cast<int64_t>(inputs.size()));
+          inputs.push_back(arg);
+        }
+      }
+    }
+
+    const auto num_inputs = static_cast<int64_t>(inputs.size());
+    std::vector<std::string> ops;
+    std::vector<int64_t> operands;
+    for (const Node* node : group_nodes) {
+      ops.push_back(node->OpType());
+      for (size_t i = 0; i < 2; ++i) {
+        if (i >= node->InputDefs().size()) {
+          operands.push_back(-1);
+          continue;
+        }
+        const auto& name = node->InputDefs()[i]->Name();
+        auto internal = internal_values.find(name);
+        operands.push_back(internal != internal_values.end() ? num_inputs + internal->second
+                                                              : input_indices.at(name));
+      }
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName(root->Name() + "/ElementwiseFusion/"),
+                                     "FusedElementwise", "fused elementwise ops", inputs,
+                                     std::array{root->MutableOutputDefs()[0]}, nullptr, kMSDomain);
+    fused_node.AddAttribute("ops", gsl::span<const std::string>(ops));
+    fused_node.AddAttribute("operands", gsl::span<const int64_t>(operands));
+    fused_node.SetExecutionProviderType(root->GetExecutionProviderType());
+
+    // Remove the absorbed producers, then move the root's remaining input edges and its outputs to the fused node.
+    for (Node* node : group_nodes) {
+      if (node != root) {
+        graph_utils::RemoveNodeOutputEdges(graph, *node);
+        graph.RemoveNode(node->Index());
+      }
+    }
+
+    InlinedHashSet<std::string> root_inputs;
+    for (const NodeArg* arg : root->InputDefs()) {
+      root_inputs.insert(arg->Name());
+    }
+
+    graph_utils::FinalizeNodeFusion(graph, {*root}, fused_node);
+
+    // Connect the inputs that were only read by the removed producers.
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      const auto& name = inputs[i]->Name();
+      const Node* producer = graph.GetProducerNode(name);
+      if (producer != nullptr && root_inputs.count(name) == 0) {
+        graph.AddEdge(producer->Index(), fused_node.Index(),
+                      graph_utils::GetNodeOutputIndexFromOutputName(*producer, name), static_cast<int>(i));
+      }
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ElementwiseFusion
+
+Collapse maximal groups of float elementwise nodes (Add, Mul, Sigmoid, ...) into a single
+com.microsoft.FusedElementwise node that evaluates them in one pass over the output.
+
+A group has a single output. Every intermediate value must have the output shape and be consumed only inside
+the group, and every external input must broadcast to the output, e.g. a per-channel bias of shape (C, 1, 1) for an
+NCHW output.
+*/
+class ElementwiseFusion : public GraphTransformer {
+ public:
+  ElementwiseFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
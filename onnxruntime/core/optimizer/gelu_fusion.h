@@ -21,6 +21,10 @@ class GeluFusion : public GraphTransformer {
   GeluFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
       : GraphTransformer("GeluFusion", compatible_execution_providers) {}
 
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"Div"};
+  }
+
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 };
 
@@ -2,6 +2,12 @@
 // Licensed under the MIT License.
 
 #include "core/optimizer/graph_transformer_mgr.h"
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+
+#include "core/common/profiler.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 
 using namespace onnxruntime;
@@ -9,6 +15,93 @@ using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
 
+namespace {
+
+// Number of edges between a changed node and the nodes that are revisited in worklist mode. Fusions match a
+// pattern of several nodes around their anchor node, so a change can make a pattern with a distant anchor matchable.
+constexpr int kWorklistNeighborhoodRadius = 8;
+
+// Keeps track of the nodes of a graph that were added, changed or removed by the transformers, using the node change
+// log of the graph. Removing a node logs its neighbors as well.
+class NodeChangeTracker {
+ public:
+  explicit NodeChangeTracker(Graph& graph) : graph_(graph) { graph_.SetNodeChangeLog(&change_log_); }
+  ~NodeChangeTracker() { graph_.SetNodeChangeLog(nullptr); }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NodeChangeTracker);
+
+  // Gets the number of distinct nodes that were logged at or after the given position of the change log.
+  size_t CountChangedNodes(size_t log_position) const {
+    InlinedHashSet<NodeIndex> changed(change_log_.begin() + log_position, change_log_.end());
+    return changed.size();
+  }
+
+  size_t ChangeLogSize() const { return change_log_.size(); }
+
+  // Gets the existing nodes that were logged at or after the given position of the change log, and all the nodes
+  // within kWorklistNeighborhoodRadius edges of them.
+  InlinedHashSet<NodeIndex> GetAffectedNodes(const Graph& graph, size_t log_position) const {
+    InlinedHashSet<NodeIndex> affected;
+    InlinedVector<NodeIndex> frontier;
+    for (size_t i = log_position; i < change_log_.size(); ++i) {
+      const NodeIndex index = change_log_[i];
+      if (graph.GetNode(index) != nullptr && affected.insert(index).second) {
+        frontier.push_back(index);
+      }
+    }
+
+    InlinedVector<NodeIndex> next_frontier;
+    for (int distance = 0; distance < kWorklistNeighborhoodRadius && !frontier.empty(); ++distance) {
+      next_frontier.clear();
+      for (NodeIndex index : frontier) {
+        const Node& node = *graph.GetNode(index);
+        for (auto it = node.InputNodesBegin(), end = node.InputNodesEnd(); it != end; ++it) {
+          if (affected.insert(it->Index()).second) {
+            next_frontier.push_back(it->Index());
+          }
+        }
+        for (auto it = node.OutputNodesBegin(), end = node.OutputNodesEnd(); it != end; ++it) {
+          if (affected.insert(it->Index()).second) {
+            next_frontier.push_back(it->Index());
+          }
+        }
+      }
+      std::swap(frontier, next_frontier);
+    }
+
+    return affected;
+  }
+
+ private:
+  Graph& graph_;
+  std::vector<NodeIndex> change_log_;
+};
+
+// Returns true if one of the nodes may be matched by a transformer with the given target op types.
+// Nodes with subgraphs always match as the transformers process their subgraphs in full.
+bool ContainsTargetNode(const Graph& graph, const InlinedHashSet<NodeIndex>& nodes,
+                        const std::vector<std::string>& target_op_types) {
+  if (target_op_types.empty()) {
+    return !nodes.empty();
+  }
+
+  return std::any_of(nodes.begin(), nodes.end(), [&](NodeIndex index) {
+    const Node& node = *graph.GetNode(index);
+    return node.ContainsSubgraph() ||
+           std::find(target_op_types.begin(), target_op_types.end(), node.OpType()) != target_op_types.end();
+  });
+}
+
+struct TransformerStats {
+  std::chrono::nanoseconds duration{0};
+  size_t runs = 0;
+  size_t skipped = 0;
+  size_t modified_runs = 0;
+  size_t nodes_modified = 0;  // only tracked in worklist mode
+};
+
+}  // namespace
+
 common::Status GraphTransformerManager::SetSteps(unsigned steps) {
   steps_ = steps;
   return Status::OK();
@@ -26,14 +119,68 @@ common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, Transfor
     return Status::OK();
   }
 
+  const auto& level_transformers = transformers->second;
+  const bool profiling = profiler_ != nullptr && profiler_->IsEnabled();
+  // the change log is only needed to find the nodes to revisit in worklist mode
+  std::optional<NodeChangeTracker> change_tracker;
+  if (worklist_mode_) {
+    change_tracker.emplace(graph);
+  }
+  // position in the change log when each transformer last ran
+  InlinedVector<size_t> log_positions(level_transformers.size(), 0);
+  InlinedVector<TransformerStats> stats(level_transformers.size());
+
   for (unsigned step = 0; step < steps_; ++step) {
     bool graph_changed = false;
-    for (const auto& transformer : transformers->second) {
-      if (step > 0 && transformer->ShouldOnlyApplyOnce())
+    for (size_t i = 0; i < level_transformers.size(); ++i) {
+      const auto& transformer = *level_transformers[i];
+      if (step > 0 && transformer.ShouldOnlyApplyOnce())
         continue;
 
+      const bool use_worklist = worklist_mode_ && step > 0;
+      InlinedHashSet<NodeIndex> affected_nodes;
+      if (use_worklist) {
+        affected_nodes = change_tracker->GetAffectedNodes(graph, log_positions[i]);
+        if (!ContainsTargetNode(graph, affected_nodes, transformer.TargetOpTypes())) {
+          log_positions[i] = change_tracker->ChangeLogSize();
+          ++stats[i].skipped;
+          continue;
+        }
+      }
+
+      // changes made by the transformer itself can enable further matches by it, so they count for its next run
+      const size_t log_position = change_tracker ? change_tracker->ChangeLogSize() : 0;
+      log_positions[i] = log_position;
+
+      const size_t nodes_visited = use_worklist ? affected_nodes.size() : static_cast<size_t>(graph.NumberOfNodes());
       bool modified = false;
-      ORT_RETURN_IF_ERROR(transformer->Apply(graph, modified, logger));
+      const TimePoint start = std::chrono::high_resolution_clock::now();
+      if (use_worklist) {
+        ORT_RETURN_IF_ERROR(transformer.ApplyToNodes(graph, affected_nodes, modified, logger));
+      } else {
+        ORT_RETURN_IF_ERROR(transformer.Apply(graph, modified, logger));
+      }
+      const size_t nodes_modified = modified && change_tracker ? change_tracker->CountChangedNodes(log_position) : 0;
+
+      auto& transformer_stats = stats[i];
+      transformer_stats.duration += std::chrono::high_resolution_clock::now() - start;
+      ++transformer_stats.runs;
+      transformer_stats.modified_runs += modified ? 1 : 0;
+      transformer_stats.nodes_modified += nodes_modified;
+      if (profiling) {
+        if (change_tracker) {
+          profiler_->EndTimeAndRecordEvent(profiling::SESSION_EVENT, transformer.Name(), start,
+                                           {{"step", std::to_string(step)},
+                                            {"nodes_visited", std::to_string(nodes_visited)},
+                                            {"nodes_modified", std::to_string(nodes_modified)}});
+        } else {
+          profiler_->EndTimeAndRecordEvent(profiling::SESSION_EVENT, transformer.Name(), start,
+                                           {{"step", std::to_string(step)},
+                                            {"nodes_visited", std::to_string(nodes_visited)},
+                                            {"modified", modified ? "1" : "0"}});
+        }
+      }
+
       graph_changed = graph_changed || modified;
     }
     if (!graph_changed) {
@@ -41,6 +188,24 @@ common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, Transfor
     }
   }
 
+  for (size_t i = 0; i < level_transformers.size(); ++i) {
+    const auto& transformer_stats = stats[i];
+    if (transformer_stats.runs == 0 && transformer_stats.skipped == 0) {
+      continue;
+    }
+
+    LOGS(logger, INFO) << "GraphTransformer " << level_transformers[i]->Name()
+                       << " runs: " << transformer_stats.runs
+                       << " skipped: " << transformer_stats.skipped
+                       << " modified runs: " << transformer_stats.modified_runs
+                       << " nodes modified: "
+                       << (change_tracker ? std::to_string(transformer_stats.nodes_modified) : "n/a")
+                       << " time: " << std::chrono::duration_cast<std::chrono::microseconds>(
+                                           transformer_stats.duration)
+                                           .count()
+                       << "us";
+  }
+
   return Status::OK();
 }
 
@@ -10,6 +10,9 @@
 #include "core/optimizer/rewrite_rule.h"
 
 namespace onnxruntime {
+namespace profiling {
+class Profiler;
+}
 
 // Manages a list of graph transformers. It is initialized with a list of graph
 // transformers. Each inference session can further register additional ones.
@@ -27,6 +30,14 @@ class GraphTransformerManager {
   // Register a transformer with a level.
   common::Status Register(std::unique_ptr<GraphTransformer> transformer, TransformerLevel level);
 
+  // Enable or disable the worklist mode. In worklist mode every transformer runs on the whole graph in the first
+  // step only. In the following steps a transformer only revisits the neighborhood of the nodes that were changed
+  // since it last ran, and is skipped if none of them has one of its target op types.
+  void SetWorklistMode(bool enable) { worklist_mode_ = enable; }
+
+  // Set the profiler that the time and the number of modified nodes of each transformer run are recorded to.
+  void SetProfiler(profiling::Profiler* profiler) { profiler_ = profiler; }
+
   // Apply all transformers registered for the given level on the given graph
   common::Status ApplyTransformers(Graph& graph, TransformerLevel level, const logging::Logger& logger) const;
 
@@ -36,6 +47,9 @@ class GraphTransformerManager {
   // maximum number of graph transformation steps
   unsigned steps_;
 
+  bool worklist_mode_ = false;
+  profiling::Profiler* profiler_ = nullptr;
+
   InlinedHashMap<TransformerLevel, InlinedVector<std::unique_ptr<GraphTransformer>>> level_to_transformer_map_;
   InlinedHashMap<std::string, GraphTransformer*> transformers_info_;
 };
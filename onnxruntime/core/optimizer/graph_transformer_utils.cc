@@ -34,6 +34,7 @@
 #include "core/optimizer/double_qdq_pairs_remover.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
@@ -197,7 +198,6 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
 #ifndef DISABLE_CONTRIB_OPS
   const InlinedHashSet<std::string_view> cpu_ep = {onnxruntime::kCpuExecutionProvider};
 #endif
-  const InlinedHashSet<std::string_view> dml_ep = {onnxruntime::kDmlExecutionProvider};
   AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
 
   switch (level) {
@@ -365,7 +365,7 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
 #endif
 
       transformers.emplace_back(std::make_unique<MatMulScaleFusion>(cpu_cuda_dml_rocm_eps));
-      transformers.emplace_back(std::make_unique<MatMulActivationFusion>(dml_ep));
+      transformers.emplace_back(std::make_unique<MatMulActivationFusion>(cpu_dml_eps));
 
 #ifdef MLAS_TARGET_AMD64_IX86
       if (avx2_precision_mode) {
@@ -403,6 +403,10 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       // PR #6351 implemented similar fusion-pattern for CUDA only, and can only fuse conv-add-relu,
       // while we can fuse more activation.
       transformers.emplace_back(std::make_unique<ConvAddActivationFusion>(cpu_ep));
+
+      // ElementwiseFusion runs last so that it only collects the elementwise nodes left over by the pattern
+      // fusions above and in Level2.
+      transformers.emplace_back(std::make_unique<ElementwiseFusion>(cpu_ep));
 #endif
 
     } break;
@@ -21,6 +21,10 @@ class LayerNormFusion : public GraphTransformer {
   LayerNormFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
       : GraphTransformer("LayerNormFusion", compatible_execution_providers) {}
 
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"ReduceMean"};
+  }
+
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 };
 
@@ -3,6 +3,8 @@
 
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/matmul_activation_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_utils.h"
 
 using namespace ONNX_NAMESPACE;
@@ -23,6 +25,208 @@ bool IsSupportedOptypeVersionAndDomain(const Node& node, const std::string& op_t
 bool IsFusableActivation(const Node& node) {
   return IsSupportedOptypeVersionAndDomain(node, "Softmax", {1, 11, 13}, kOnnxDomain);
 }
+
+// Keep in sync with the activations supported by the CPU FusedMatMulActivation kernel. Returns the value of the
+// "activation" attribute for the fused node, or nullptr if the node is not a supported activation. BiasGelu and
+// FastGelu with a bias also supply the bias input of the fused node. Clip is only supported with constant bounds.
+const char* GetCpuEpilogueActivation(const Graph& graph, const Node& node, bool& has_bias) {
+  has_bias = false;
+  if (IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}, kOnnxDomain) ||
+      IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}, kOnnxDomain) ||
+      IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}, kOnnxDomain) ||
+      IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6, 16}, kOnnxDomain) ||
+      IsSupportedOptypeVersionAndDomain(node, "HardSigmoid", {6}, kOnnxDomain) ||
+      IsSupportedOptypeVersionAndDomain(node, "Gelu", {1}, kMSDomain) ||
+      IsSupportedOptypeVersionAndDomain(node, "QuickGelu", {1}, kMSDomain)) {
+    return node.OpType().c_str();
+  }
+
+  float min, max;
+  if (IsSupportedOptypeVersionAndDomain(node, "Clip", {6, 11, 12, 13}, kOnnxDomain) &&
+      optimizer_utils::GetClipConstantMinMax(graph, node, min, max)) {
+    return "Clip";
+  }
+
+  if (IsSupportedOptypeVersionAndDomain(node, "BiasGelu", {1}, kMSDomain)) {
+    has_bias = true;
+    return "Gelu";
+  }
+
+  if (IsSupportedOptypeVersionAndDomain(node, "FastGelu", {1}, kMSDomain)) {
+    has_bias = node.InputDefs().size() > 1 && node.InputDefs()[1]->Exists();
+    return "FastGelu";
+  }
+
+  return nullptr;
+}
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+bool DimEquals(const TensorShapeProto_Dimension& dim, const TensorShapeProto_Dimension& other) {
+  if (utils::HasDimValue(dim) && utils::HasDimValue(other)) {
+    return dim.dim_value() == other.dim_value();
+  }
+  return utils::HasDimParam(dim) && utils::HasDimParam(other) && dim.dim_param() == other.dim_param();
+}
+
+bool ShapeEquals(const TensorShapeProto* shape, const TensorShapeProto* other) {
+  if (shape == nullptr || other == nullptr || shape->dim_size() != other->dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    if (!DimEquals(shape->dim(i), other->dim(i))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// The bias of the fused node is broadcast along the rows of the output, so it must be a 1D tensor with the size
+// of the last output dimension.
+bool IsEpilogueBias(const NodeArg& bias, const TensorShapeProto& output_shape) {
+  const auto* shape = bias.Shape();
+  return IsFloatTensor(bias) && shape != nullptr && shape->dim_size() == 1 && output_shape.dim_size() > 0 &&
+         DimEquals(shape->dim(0), output_shape.dim(output_shape.dim_size() - 1));
+}
+
+// Returns the node consuming the output of `node` if it can be appended to the fused chain.
+Node* GetNextEpilogueNode(Graph& graph, const Node& node) {
+  if (node.GetOutputEdgesCount() != 1 || graph.NodeProducesGraphOutput(node)) {
+    return nullptr;
+  }
+
+  Node* next = graph.GetNode(node.OutputNodesBegin()->Index());
+  return next->GetExecutionProviderType() == node.GetExecutionProviderType() ? next : nullptr;
+}
+
+// Returns the input of a two input Add that is not `value`.
+NodeArg* GetOtherAddInput(Node& add, const NodeArg& value) {
+  if (!IsSupportedOptypeVersionAndDomain(add, "Add", {7, 13, 14}, kOnnxDomain) || add.InputDefs().size() != 2) {
+    return nullptr;
+  }
+
+  auto& inputs = add.MutableInputDefs();
+  if (inputs[0] == &value && inputs[1] != &value) {
+    return inputs[1];
+  }
+  if (inputs[1] == &value && inputs[0] != &value) {
+    return inputs[0];
+  }
+  return nullptr;
+}
+
+// On CPU, MatMul or FusedMatMul followed by any of an Add of a bias, an activation and an Add of a residual with the
+// output shape is fused into FusedMatMulActivation, whose kernel applies them to each output tile of the GEMM while
+// it is still in cache. In the bf16 fastmath mode the kernel applies them to the rows of the sbgemm output instead.
+bool FuseCpuEpilogue(Graph& graph, Node& node) {
+  if (!(graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13}) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedMatMul", {1}, kMSDomain)) ||
+      !IsFloatTensor(*node.OutputDefs()[0]) || node.OutputDefs()[0]->Shape() == nullptr) {
+    return false;
+  }
+
+  // A 1D B removes the last dimension of the output, which then no longer matches the bias.
+  const auto* weight_shape = node.InputDefs()[1]->Shape();
+  if (weight_shape == nullptr || weight_shape->dim_size() < 2) {
+    return false;
+  }
+
+  // Leave weights produced by DequantizeLinear to the MatMulNBits and QDQ fusions.
+  const Node* weight_producer = graph_utils::GetInputNode(node, 1);
+  if (weight_producer != nullptr && weight_producer->OpType() == "DequantizeLinear") {
+    return false;
+  }
+
+  const TensorShapeProto& output_shape = *node.OutputDefs()[0]->Shape();
+  InlinedVector<std::reference_wrapper<Node>> nodes{node};
+  NodeArg* bias = nullptr;
+  NodeArg* residual = nullptr;
+  Node* activation = nullptr;
+  const char* activation_type = "Identity";
+
+  Node* next = GetNextEpilogueNode(graph, node);
+  NodeArg* other = next != nullptr ? GetOtherAddInput(*next, *node.OutputDefs()[0]) : nullptr;
+  if (other != nullptr && IsEpilogueBias(*other, output_shape)) {
+    bias = other;
+    nodes.push_back(*next);
+    next = GetNextEpilogueNode(graph, *next);
+  }
+
+  bool activation_has_bias = false;
+  const char* next_activation = next != nullptr ? GetCpuEpilogueActivation(graph, *next, activation_has_bias) : nullptr;
+  const NodeArg* value = nodes.back().get().OutputDefs()[0];
+  if (next_activation != nullptr && next->InputDefs()[0] == value &&
+      !(activation_has_bias && (bias != nullptr || next->InputDefs()[1] == value ||
+                                !IsEpilogueBias(*next->InputDefs()[1], output_shape)))) {
+    if (activation_has_bias) {
+      bias = next->MutableInputDefs()[1];
+    }
+    activation = next;
+    activation_type = next_activation;
+    nodes.push_back(*next);
+    next = GetNextEpilogueNode(graph, *next);
+  }
+
+  other = next != nullptr ? GetOtherAddInput(*next, *nodes.back().get().OutputDefs()[0]) : nullptr;
+  if (other != nullptr && IsFloatTensor(*other) && ShapeEquals(other->Shape(), &output_shape) &&
+      ShapeEquals(next->OutputDefs()[0]->Shape(), &output_shape)) {
+    residual = other;
+    nodes.push_back(*next);
+  }
+
+  if (nodes.size() < 2) {
+    return false;
+  }
+
+  InlinedVector<NodeArg*> inputs{node.MutableInputDefs()[0], node.MutableInputDefs()[1]};
+  if (bias != nullptr || residual != nullptr) {
+    inputs.push_back(bias != nullptr ? bias : &graph.GetOrCreateNodeArg("", nullptr));
+  }
+  if (residual != nullptr) {
+    inputs.push_back(residual);
+  }
+
+  Node& fused_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_FusedEpilogue"), "FusedMatMulActivation",
+                                   node.Description() + " with fused epilogue", inputs, {}, &node.GetAttributes(),
+                                   kMSDomain);
+  fused_node.AddAttribute("activation", std::string(activation_type));
+  fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  if (activation != nullptr && activation->OpType() == "Clip") {
+    // the bounds may be inputs of the Clip, so pass them as activation_alpha and activation_beta.
+    float min, max;
+    ORT_ENFORCE(optimizer_utils::GetClipConstantMinMax(graph, *activation, min, max),
+                "Failed to get Clip min/max constants.");
+    fused_node.AddAttribute("activation_alpha", min);
+    fused_node.AddAttribute("activation_beta", max);
+  } else if (activation != nullptr) {
+    for (const auto& attr : activation->GetAttributes()) {
+      AttributeProto fused_node_attr(attr.second);
+      fused_node_attr.set_name("activation_" + attr.first);
+      fused_node.AddAttributeProto(std::move(fused_node_attr));
+    }
+  }
+
+  // move the input edges of the MatMul and the outputs of the last node to fused_node, then connect the bias and
+  // residual inputs, which were read by nodes that are now removed.
+  graph_utils::FinalizeNodeFusion(graph, nodes, fused_node);
+
+  for (size_t i = 2; i < inputs.size(); ++i) {
+    const Node* producer = inputs[i]->Exists() ? graph.GetProducerNode(inputs[i]->Name()) : nullptr;
+    if (producer != nullptr) {
+      graph.AddEdge(producer->Index(), fused_node.Index(),
+                    graph_utils::GetNodeOutputIndexFromOutputName(*producer, inputs[i]->Name()), static_cast<int>(i));
+    }
+  }
+
+  return true;
+}
 }  // namespace
 
 Status MatMulActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
@@ -38,6 +242,17 @@ Status MatMulActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph
     auto& node = *node_ptr;
     ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
 
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    if (node.GetExecutionProviderType() == kCpuExecutionProvider) {
+      if (FuseCpuEpilogue(graph, node)) {
+        modified = true;
+      }
+      continue;
+    }
+
     if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedMatMul", {1}, kMSDomain) ||
         !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) || node.GetOutputEdgesCount() != 1) {
       continue;
@@ -7,6 +7,12 @@
 
 namespace onnxruntime {
 
+/**
+@Class MatMulActivationFusion
+
+Fuse FusedMatMul + Softmax into FusedMatMulActivation for DML. On CPU, fuse MatMul or FusedMatMul followed by an
+Add of a bias, an activation and an Add of a residual into FusedMatMulActivation, which applies them in the GEMM.
+*/
 class MatMulActivationFusion : public GraphTransformer {
  public:
   MatMulActivationFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
@@ -16,6 +16,10 @@ class ReshapeFusion : public GraphTransformer {
   ReshapeFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
       : GraphTransformer("ReshapeFusion", compatible_execution_providers) {}
 
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"Reshape"};
+  }
+
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 
  private:
@@ -91,6 +91,12 @@ struct ThreadOptions {
   void* custom_thread_creation_options = nullptr;
   OrtCustomJoinThreadFn custom_join_thread_fn = nullptr;
   int dynamic_block_base_ = 0;
+
+  // If true, worker threads are grouped by the NUMA node of the first logical processor in their affinity.
+  // Workers steal work from their own NUMA node first and from remote nodes only when they are about to block,
+  // and the parallel loops started by a thread are preferably dispatched to the workers of a single node.
+  // Has no effect if the affinities are not set or all of them belong to the same NUMA node.
+  bool numa_aware = false;
 };
 
 std::ostream& operator<<(std::ostream& os, const LogicalProcessors&);
@@ -147,6 +153,13 @@ class Env {
 
   virtual std::vector<LogicalProcessors> GetDefaultThreadAffinities() const = 0;
 
+  /// <summary>
+  /// Returns the NUMA node that a logical processor belongs to.
+  /// </summary>
+  /// <param name="logical_processor_id">Logical processor id, starting from 0.</param>
+  /// <returns>NUMA node id starting from 0. 0 if the NUMA topology is unknown.</returns>
+  virtual int GetNumaNodeOfLogicalProcessor(int logical_processor_id) const = 0;
+
   virtual int GetL2CacheSize() const = 0;
 
   /// \brief Returns the number of micro-seconds since the Unix epoch.
@@ -17,6 +17,8 @@ limitations under the License.
 #include "core/platform/env.h"
 
 #include <assert.h>
+#include <ctype.h>
+#include <dirent.h>
 #include <dlfcn.h>
 #include <fcntl.h>
 #include <ftw.h>
@@ -308,6 +310,26 @@ class PosixEnv : public Env {
     return ret;
   }
 
+  int GetNumaNodeOfLogicalProcessor(int logical_processor_id) const override {
+#if defined(__linux__)
+    // sysfs lists a "node<N>" entry in the directory of each logical processor
+    const std::string cpu_dir = "/sys/devices/system/cpu/cpu" + std::to_string(logical_processor_id);
+    DIR* dir = opendir(cpu_dir.c_str());
+    if (dir != nullptr) {
+      auto dir_closer = gsl::finally([dir]() { closedir(dir); });
+      while (const auto* entry = readdir(dir)) {
+        const char* name = entry->d_name;
+        if (strncmp(name, "node", 4) == 0 && isdigit(static_cast<unsigned char>(name[4]))) {
+          return atoi(name + 4);
+        }
+      }
+    }
+#else
+    ORT_UNUSED_PARAMETER(logical_processor_id);
+#endif
+    return 0;
+  }
+
   int GetL2CacheSize() const override {
 #ifdef _SC_LEVEL2_CACHE_SIZE
     return static_cast<int>(sysconf(_SC_LEVEL2_CACHE_SIZE));
@@ -303,6 +303,23 @@ std::vector<LogicalProcessors> WindowsEnv::GetDefaultThreadAffinities() const {
   return cores_.empty() ? std::vector<LogicalProcessors>(DefaultNumCores(), LogicalProcessors{}) : cores_;
 }
 
+int WindowsEnv::GetNumaNodeOfLogicalProcessor(int logical_processor_id) const {
+  const auto processor_info = GetProcessorAffinityMask(logical_processor_id);
+  if (processor_info.group_id < 0) {
+    return 0;
+  }
+
+  PROCESSOR_NUMBER processor_number = {};
+  processor_number.Group = static_cast<WORD>(processor_info.group_id);
+  processor_number.Number = static_cast<BYTE>(processor_info.local_processor_id);
+  USHORT node_number = 0;
+  if (!GetNumaProcessorNodeEx(&processor_number, &node_number) || node_number == MAXUSHORT) {
+    return 0;
+  }
+
+  return static_cast<int>(node_number);
+}
+
 int WindowsEnv::GetL2CacheSize() const {
   return l2_cache_size_;
 }
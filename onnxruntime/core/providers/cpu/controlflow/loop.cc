@@ -22,6 +22,7 @@
 #include "core/framework/session_options.h"
 #include "core/framework/TensorSeq.h"
 #include "core/providers/utils.h"
+#include "core/platform/threadpool.h"
 
 #include <gsl/gsl>
 
@@ -503,6 +504,9 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
+    ORT_RETURN_IF(concurrency::ThreadPool::DeadlinePassed(), "Loop stopped after ", iter_num_value,
+                  " iterations as the run deadline passed.");
+
     if (iter_num_value != 0) {
       SaveOutputsAndUpdateFeeds(fetches, feeds);
       fetches.clear();
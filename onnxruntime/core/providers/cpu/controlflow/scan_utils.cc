@@ -19,6 +19,7 @@
 #include "core/framework/utils.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/framework/session_options.h"
+#include "core/platform/threadpool.h"
 
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -210,6 +211,9 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
 
   int64_t seq_no = 0;
   for (; seq_no < seq_length; ++seq_no) {
+    ORT_RETURN_IF(concurrency::ThreadPool::DeadlinePassed(), "Scan stopped after ", seq_no, " of ", seq_length,
+                  " iterations as the run deadline passed.");
+
     for (int input = 0; input < num_variadic_inputs; ++input) {
       if (input < num_loop_state_variables) {
         // add loop state variable input
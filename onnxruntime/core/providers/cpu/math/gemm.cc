@@ -9,6 +9,7 @@
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
@@ -138,6 +139,73 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
   return true;
 }
 
+bool IsGemmFastMathBfloat16Enabled(const ConfigOptions& config_options) {
+#if defined(MLAS_SUPPORTS_SBGEMM)
+  const std::string mode = config_options.GetConfigOrDefault(kOrtSessionOptionsMlasGemmFastMathBfloat16, "0");
+  if (mode == "1" || config_options.GetConfigOrDefault(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16, "0") == "1") {
+    return MlasBf16AccelerationSupported();
+  }
+#if defined(MLAS_TARGET_AMD64)
+  // "2" also allows the AVX2 emulation of the bf16 kernels, which is used to test this mode on any x64 machine
+  if (mode == "2") {
+    return MlasSBGemmPackBSize(1, 1) != 0;
+  }
+#endif
+#else
+  ORT_UNUSED_PARAMETER(config_options);
+#endif
+  return false;
+}
+
+#if defined(MLAS_SUPPORTS_SBGEMM)
+bool GemmPackBBfloat16(AllocatorPtr& alloc,
+                       const Tensor& tensor_b,
+                       bool trans_b,
+                       IAllocatorUniquePtr<void>& packed_b,
+                       size_t& packed_b_size,
+                       TensorShape& b_shape) {
+  // Only handle the common case of a 2D weight matrix. Additional matrices
+  // could be handled by stacking the packed buffers.
+  if (tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+
+  b_shape = tensor_b.Shape();
+
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+
+  packed_b_size = MlasSBGemmPackBSize(N, K);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+  auto* packed_b_data = packed_b.get();
+
+  // Initialize memory to 0 as there could be some padding associated with pre-packed
+  // buffer memory and we don not want it uninitialized and generate different hashes
+  // if and when we try to cache this pre-packed buffer for sharing between sessions.
+  memset(packed_b_data, 0, packed_b_size);
+
+  // The sbgemm packing routine only reads B as K x N, so a transposed B is transposed first.
+  const float* b_data = tensor_b.Data<float>();
+  std::vector<float> transposed_b;
+  if (trans_b) {
+    transposed_b.resize(K * N);
+    MlasTranspose(b_data, transposed_b.data(), N, K);
+    b_data = transposed_b.data();
+  }
+
+  MlasSBGemmConvertPackB(N,
+                         K,
+                         b_data,
+                         N,
+                         packed_b_data);
+  return true;
+}
+#endif
+
 template <typename T>
 void Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
@@ -189,7 +257,7 @@ void Gemm<MLFloat16>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans
 #if defined(__GNUC__) && defined(HAS_CLASS_MEMACCESS)
 #pragma GCC diagnostic pop
 #endif
-#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED) || defined(MLAS_TARGET_AMD64)
   bool support_mlas = false;
   if (c_shape == nullptr) {
     support_mlas = true;
@@ -198,6 +266,10 @@ void Gemm<MLFloat16>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans
   } else if (c_shape->NumDimensions() == 2 && (((*c_shape)[0] == 1 && (*c_shape)[1] == N) || ((*c_shape)[0] == N && (*c_shape)[1] == 1))) {
     support_mlas = true;
   }
+#if !defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
+  // The x64 half precision GEMM kernels need AVX2 and F16C, fall back to Eigen without them.
+  support_mlas = support_mlas && MlasFp16AccelerationSupported();
+#endif
   if (trans_a == CblasNoTrans && trans_b == CblasNoTrans && support_mlas && alpha.ToFloat() == 1.0 && beta.ToFloat() == 1.0) {
     MLAS_HALF_GEMM_DATA_PARAMS data;
     data.A = a_data;
@@ -253,7 +325,17 @@ Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx,
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-    is_packed = GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
+#if defined(MLAS_SUPPORTS_SBGEMM)
+    const TensorShape& b_shape = tensor.Shape();
+    if (use_fastmath_mode_ && b_shape.NumDimensions() == 2 &&
+        static_cast<size_t>(b_shape.Size()) >= kGemmFastMathKernelSizeThreshold) {
+      is_packed = GemmPackBBfloat16(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
+      packed_b_is_bfloat16_ = is_packed;
+    } else
+#endif
+    {
+      is_packed = GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
+    }
     bool share_prepacked_weights = (prepacked_weights != nullptr);
     if (is_packed && share_prepacked_weights) {
       prepacked_weights->buffers_.push_back(std::move(packed_b_));
@@ -411,6 +493,33 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
   if (B) {
     ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, A->Data<float>(), B->Data<float>(), beta_,
                 c_data, c_shape, y_data, thread_pool);
+#if defined(MLAS_SUPPORTS_SBGEMM)
+  } else if (packed_b_is_bfloat16_) {
+    // A bias of shape (N,) or (1, N) is added by the kernel, any other bias after the product. A scalar C has
+    // no dimensions even if N is 1.
+    const bool has_bias = c_data != nullptr && beta_ != 0.0f;
+    const bool is_row_bias = has_bias && beta_ == 1.0f && c_shape->Size() == N &&
+                             (c_shape->NumDimensions() == 1 ||
+                              (c_shape->NumDimensions() == 2 && (*c_shape)[0] == 1));
+
+    MLAS_SBGEMM_DATA_PARAMS data;
+    data.A = A->Data<float>();
+    data.lda = static_cast<size_t>(K);
+    data.B = packed_b_.get();
+    data.ldb = 0;
+    data.C = y_data;
+    data.ldc = static_cast<size_t>(N);
+    data.Bias = is_row_bias ? c_data : nullptr;
+    data.AIsfp32 = true;
+    data.BIsfp32 = false;
+    MlasSBGemmBatch(static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K), 1, &data, thread_pool);
+
+    if (has_bias && !is_row_bias) {
+      std::vector<float> bias(SafeInt<size_t>(M) * N);
+      GemmBroadcastBias(M, N, beta_, c_data, c_shape, bias.data());
+      EigenVectorArrayMap<float>(y_data, M * N) += beta_ * ConstEigenVectorArrayMap<float>(bias.data(), M * N);
+    }
+#endif
   } else {
     GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
     MlasGemm(
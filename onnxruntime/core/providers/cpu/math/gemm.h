@@ -9,6 +9,7 @@
 #include "core/common/common.h"
 #include "core/util/math.h"
 #include "core/providers/cpu/activation/activations.h"
+#include "core/providers/cpu/math/gemm_matmul_common.h"
 
 namespace onnxruntime {
 
@@ -16,6 +17,9 @@ template <typename T>
 class Gemm : protected GemmBase, public OpKernel {
  public:
   Gemm(const OpKernelInfo& info) : GemmBase(info), OpKernel(info) {
+    // the sbgemm kernels neither transpose A nor scale the product
+    use_fastmath_mode_ = std::is_same<T, float>::value && trans_A_ == CblasNoTrans && alpha_ == 1.0f &&
+                         IsGemmFastMathBfloat16Enabled(info.GetConfigOptions());
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -41,6 +45,10 @@ class Gemm : protected GemmBase, public OpKernel {
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
 
+  // fastmath mode state, B is pre-packed to bfloat16 if packed_b_is_bfloat16_
+  bool use_fastmath_mode_;
+  bool packed_b_is_bfloat16_{false};
+
   // For fused gemm + activation
   std::unique_ptr<functors::ElementWiseRangedTransform<T>> activation_;
 
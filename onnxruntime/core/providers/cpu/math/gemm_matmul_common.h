@@ -14,4 +14,19 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
                    size_t& packed_b_size,
                    TensorShape& b_shape);
 
+// Returns true if fp32 MatMul and Gemm compute with bfloat16 inputs (MlasSBGemmBatch) as configured by the
+// kOrtSessionOptionsMlasGemmFastMathBfloat16 session option, or by the ARM64 only
+// kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16.
+bool IsGemmFastMathBfloat16Enabled(const ConfigOptions& config_options);
+
+// The sbgemm kernels pre-pack the weights, which outweighs the faster math only for large enough weights.
+constexpr size_t kGemmFastMathKernelSizeThreshold = 32;
+
+bool GemmPackBBfloat16(AllocatorPtr& alloc,
+                       const Tensor& tensor_b,
+                       bool trans_b,
+                       IAllocatorUniquePtr<void>& packed_b,
+                       size_t& packed_b_size,
+                       TensorShape& b_shape);
+
 };  // namespace onnxruntime
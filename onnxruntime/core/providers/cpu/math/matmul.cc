@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/matmul.h"
+
+#include <limits>
+
 #include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/util/math.h"
@@ -132,45 +135,110 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
 
   return Status::OK();
 }
-#if defined(__aarch64__) && defined(__linux__)
-bool GemmPackBBfloat16(AllocatorPtr& alloc,
-                       const Tensor& tensor_b,
-                       bool trans_b,
-                       IAllocatorUniquePtr<void>& packed_b,
-                       size_t& packed_b_size,
-                       TensorShape& b_shape) {
-  // Only handle the common case of a 2D weight matrix. Additional matrices
-  // could be handled by stacking the packed buffers.
-  if (tensor_b.Shape().NumDimensions() != 2) {
-    return false;
-  }
 
-  b_shape = tensor_b.Shape();
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED) || defined(MLAS_TARGET_AMD64)
+// The fp16 kernels are only registered when MlasFp16AccelerationSupported() is true, see RegisterFp16GemmKernels().
+template <>
+Status MatMul<MLFloat16>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
-  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
-  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+  const auto* a = ctx->Input<Tensor>(0);
+  const auto* b = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  if (helper.K() == 0) {
+    auto output_span = y->MutableDataAsSpan<MLFloat16>();
+    std::fill(output_span.begin(), output_span.end(), MLFloat16());
+    return Status::OK();
+  }
 
-  packed_b_size = MlasSBGemmPackBSize(N, K);
-  if (packed_b_size == 0) {
-    return false;
+  const auto* a_data = a->Data<MLFloat16>();
+  const auto* b_data = b->Data<MLFloat16>();
+  auto* y_data = y->MutableData<MLFloat16>();
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+  const size_t max_len = helper.OutputOffsets().size();
+  std::vector<MLAS_HALF_GEMM_DATA_PARAMS> data(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    data[i].A = a_data + helper.LeftOffsets()[i];
+    data[i].lda = K;
+    data[i].B = b_data + helper.RightOffsets()[i];
+    data[i].ldb = N;
+    data[i].C = y_data + helper.OutputOffsets()[i];
+    data[i].ldc = N;
   }
+  MlasHalfGemmBatch(M, N, K, max_len, data.data(), thread_pool);
 
-  packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
-  auto* packed_b_data = packed_b.get();
-
-  // Initialize memory to 0 as there could be some padding associated with pre-packed
-  // buffer memory and we don not want it uninitialized and generate different hashes
-  // if and when we try to cache this pre-packed buffer for sharing between sessions.
-  memset(packed_b_data, 0, packed_b_size);
-  MlasSBGemmConvertPackB(N,
-                         K,
-                         tensor_b.Data<float>(),
-                         trans_b ? K : N,
-                         packed_b_data);
-  return true;
+  return Status::OK();
 }
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    9,
+    12,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    MatMul,
+    13,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
 #endif
 
+Status MatMul<float>::GetActivationAttr(const OpKernelInfo& info, MLAS_ACTIVATION& activation) {
+  activation.ActivationKind = MlasIdentityActivation;
+
+  std::string activation_type;
+  if (!info.GetAttr<std::string>("activation", &activation_type).IsOK() || activation_type == "Identity") {
+    return Status::OK();
+  }
+
+  if (activation_type == "Relu") {
+    activation.ActivationKind = MlasReluActivation;
+  } else if (activation_type == "LeakyRelu") {
+    activation.ActivationKind = MlasLeakyReluActivation;
+    activation.Parameters.LeakyRelu.alpha = info.GetAttrOrDefault<float>("activation_alpha", 0.01f);
+  } else if (activation_type == "Clip") {
+    // the bounds of Clip are carried by activation_alpha and activation_beta.
+    activation.ActivationKind = MlasClipActivation;
+    activation.Parameters.Clip.minimum = info.GetAttrOrDefault<float>("activation_alpha",
+                                                                      std::numeric_limits<float>::lowest());
+    activation.Parameters.Clip.maximum = info.GetAttrOrDefault<float>("activation_beta",
+                                                                      std::numeric_limits<float>::max());
+  } else if (activation_type == "Tanh") {
+    activation.ActivationKind = MlasTanhActivation;
+  } else if (activation_type == "Sigmoid") {
+    activation.ActivationKind = MlasLogisticActivation;
+  } else if (activation_type == "HardSigmoid") {
+    activation.ActivationKind = MlasHardSigmoidActivation;
+    activation.Parameters.HardSigmoid.alpha = info.GetAttrOrDefault<float>("activation_alpha", 0.2f);
+    activation.Parameters.HardSigmoid.beta = info.GetAttrOrDefault<float>("activation_beta", 0.5f);
+  } else if (activation_type == "Gelu") {
+    activation.ActivationKind = MlasGeluActivation;
+  } else if (activation_type == "FastGelu") {
+    activation.ActivationKind = MlasFastGeluActivation;
+  } else if (activation_type == "QuickGelu") {
+    activation.ActivationKind = MlasSiluActivation;
+    activation.Parameters.Silu.alpha = info.GetAttrOrDefault<float>("activation_alpha", 1.702f);
+  } else {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "unimplemented activation: ", activation_type);
+  }
+
+  return Status::OK();
+}
+
 Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
                               /*out*/ bool& is_packed,
                               /*out*/ PrePackedWeights* prepacked_weights) {
@@ -179,7 +247,7 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SUPPORTS_SBGEMM)
     size_t dim1 = 0;
     size_t dim2 = 0;
     TensorShape b_shape = tensor.Shape();
@@ -189,7 +257,7 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
       dim2 = static_cast<size_t>(b_shape[1]);
     }
 
-    if (use_fastmath_mode_ && (trans_b_attr_ == 0) && ((dim1 * dim2) >= kFastMathModeKernelsizeThreshold)) {
+    if (use_fastmath_mode_ && (trans_b_attr_ == 0) && ((dim1 * dim2) >= kGemmFastMathKernelSizeThreshold)) {
       is_packed = GemmPackBBfloat16(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
     } else
 #endif
@@ -219,6 +287,42 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   return Status::OK();
 }
 
+Status MatMul<float>::UseCachedPrePackedBuffers(const Tensor& tensor,
+                                                std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                gsl::span<const size_t> prepacked_buffer_sizes,
+                                                int input_idx,
+                                                /*out*/ bool& used_cached_buffers) {
+  used_cached_buffers = false;
+
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 2 || prepacked_buffers.size() != 1) {
+    return Status::OK();
+  }
+
+  const TensorShape& b_shape = tensor.Shape();
+  const bool trans_b = trans_b_attr_ != 0;
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+  size_t packed_b_size;
+#if defined(MLAS_SUPPORTS_SBGEMM)
+  if (use_fastmath_mode_ && !trans_b && ((N * K) >= kGemmFastMathKernelSizeThreshold)) {
+    packed_b_size = MlasSBGemmPackBSize(N, K);
+  } else
+#endif
+  {
+    packed_b_size = MlasGemmPackBSize(N, K);
+  }
+
+  // the buffer was packed with another layout
+  if (packed_b_size == 0 || prepacked_buffer_sizes[0] != packed_b_size) {
+    return Status::OK();
+  }
+
+  used_cached_buffers = true;
+  b_shape_ = b_shape;
+  packed_b_ = std::move(prepacked_buffers[0]);
+  return Status::OK();
+}
+
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
@@ -248,8 +352,40 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const size_t K = static_cast<size_t>(helper.K());
   const size_t lda = helper.Lda(trans_a);
   const size_t ldb = helper.Ldb(trans_b);
-#if defined(__aarch64__) && defined(__linux__)
-  if (use_fastmath_mode_ && !trans_b && ((N * K) >= kFastMathModeKernelsizeThreshold)) {
+
+  // FusedMatMulActivation computes Y = Activation(A * B + bias) + residual in the GEMM epilogue.
+  const Tensor* bias = ctx->Input<Tensor>(2);
+  const Tensor* residual = ctx->Input<Tensor>(3);
+
+  if (bias != nullptr) {
+    ORT_RETURN_IF_NOT(bias->Shape().NumDimensions() == 1 && static_cast<size_t>(bias->Shape()[0]) == N,
+                      "bias must be a 1-D tensor of size ", N, ", got ", bias->Shape());
+  }
+
+  if (residual != nullptr) {
+    ORT_RETURN_IF_NOT(residual->Shape() == y->Shape(),
+                      "residual must have the output shape ", y->Shape(), ", got ", residual->Shape());
+  }
+
+  const bool use_epilogue = bias != nullptr || residual != nullptr ||
+                            activation_.ActivationKind != MlasIdentityActivation;
+
+  // Each batch entry adds its own slice of the residual, so it needs its own epilogue.
+  std::vector<MLAS_SGEMM_EPILOGUE> epilogues;
+  std::vector<MLAS_SGEMM_EPILOGUE_PROCESSOR> epilogue_processors;
+  if (use_epilogue) {
+    epilogues.resize(max_len);
+    epilogue_processors.reserve(max_len);
+    for (size_t i = 0; i < max_len; i++) {
+      epilogues[i].Bias = bias != nullptr ? bias->Data<float>() : nullptr;
+      epilogues[i].Activation = activation_;
+      epilogues[i].Residual = residual != nullptr ? residual->Data<float>() + helper.OutputOffsets()[i] : nullptr;
+      epilogue_processors.emplace_back(epilogues[i]);
+    }
+  }
+
+#if defined(MLAS_SUPPORTS_SBGEMM)
+  if (use_fastmath_mode_ && !trans_b && ((N * K) >= kGemmFastMathKernelSizeThreshold)) {
     std::vector<MLAS_SBGEMM_DATA_PARAMS> data(max_len);
     for (size_t i = 0; i < max_len; i++) {
       data[i].BIsfp32 = !(bool(packed_b_));
@@ -264,6 +400,19 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
       data[i].OutputProcessor = nullptr;
     }
     MlasSBGemmBatch(M, N, K, max_len, data.data(), thread_pool);
+
+    // the sbgemm kernels have no epilogue hook that matches MLAS_SGEMM_EPILOGUE, so apply it to each output row
+    if (use_epilogue) {
+      concurrency::ThreadPool::TryParallelFor(
+          thread_pool, static_cast<std::ptrdiff_t>(max_len * M),
+          {static_cast<double>(N * sizeof(float)), static_cast<double>(N * sizeof(float)), static_cast<double>(N)},
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (auto row = static_cast<size_t>(first); row < static_cast<size_t>(last); ++row) {
+              const size_t i = row / M;
+              epilogue_processors[i].Process(data[i].C, row % M, 0, 1, N, N);
+            }
+          });
+    }
   } else
 #endif
   {
@@ -279,6 +428,13 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
       data[i].alpha = alpha_attr_;
       data[i].beta = 0.0f;
     }
+
+    if (use_epilogue) {
+      for (size_t i = 0; i < max_len; i++) {
+        data[i].OutputProcessor = &epilogue_processors[i];
+      }
+    }
+
     MlasGemmBatch(trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
                   M, N, K, data.data(), max_len, thread_pool);
   }
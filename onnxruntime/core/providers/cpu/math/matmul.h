@@ -5,7 +5,7 @@
 
 #include "core/framework/op_kernel.h"
 #include "core/mlas/inc/mlas.h"
-#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "core/providers/cpu/math/gemm_matmul_common.h"
 
 namespace onnxruntime {
 
@@ -29,10 +29,12 @@ class MatMul<float> final : public OpKernel {
     info.GetAttrOrDefault<int64_t>("transBatchB", &trans_batch_b_attr, 0);
     trans_batch_a_ = trans_batch_a_attr != 0;
     trans_batch_b_ = trans_batch_b_attr != 0;
+    ORT_THROW_IF_ERROR(GetActivationAttr(info, activation_));
 
-#if defined(__aarch64__) && defined(__linux__)
-    auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16);
-    use_fastmath_mode_ = (config_ops == "1") && MlasBf16AccelerationSupported();
+#if defined(MLAS_SUPPORTS_SBGEMM)
+    // the sbgemm kernels neither transpose A nor scale the product. The GEMM epilogue is applied after them.
+    use_fastmath_mode_ = trans_a_attr_ == 0 && alpha_attr_ == 1.0f &&
+                         IsGemmFastMathBfloat16Enabled(info.GetConfigOptions());
 #endif
   }
 
@@ -43,9 +45,15 @@ class MatMul<float> final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UseCachedPrePackedBuffers(const Tensor& tensor, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   gsl::span<const size_t> prepacked_buffer_sizes, int input_idx,
+                                   /*out*/ bool& used_cached_buffers) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
+  static Status GetActivationAttr(const OpKernelInfo& info, MLAS_ACTIVATION& activation);
+
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
 
@@ -56,12 +64,12 @@ class MatMul<float> final : public OpKernel {
   bool trans_batch_a_;
   bool trans_batch_b_;
 
-#if defined(__aarch64__) && defined(__linux__)
+  // For FusedMatMulActivation contrib op, which also takes optional bias and residual inputs
+  MLAS_ACTIVATION activation_;
+
+#if defined(MLAS_SUPPORTS_SBGEMM)
   // fastmath mode state
   bool use_fastmath_mode_;
-  // sbgemm kernel is implemented as 8x8 blocks with weights pre-packed to 4 blocks of 4x2
-  // so a minimum of 32 elements is defined to outweigh the additional prepacking overhead
-  const size_t kFastMathModeKernelsizeThreshold = 32;
 #endif
 };
 
@@ -17,8 +17,11 @@
 
 #include "core/providers/cpu/nn/conv.h"
 
+#include <algorithm>
+
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -153,20 +156,117 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<float>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                            /*out*/ bool& is_packed,
+                            /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // Transform constant 3x3 filters once for the Winograd algorithm.
+  if (input_idx != 1) {
+    return Status::OK();
+  }
+
+  const auto& shape = tensor.Shape();
+  if (shape.NumDimensions() != 4 || shape[2] != 3 || shape[3] != 3 ||
+      conv_attrs_.group <= 0 || shape[0] % conv_attrs_.group != 0) {
+    return Status::OK();
+  }
+
+  const auto all_ones = [](const TensorShapeVector& values) {
+    return std::all_of(values.begin(), values.end(), [](int64_t v) { return v == 1; });
+  };
+  if (!all_ones(conv_attrs_.strides) || !all_ones(conv_attrs_.dilations)) {
+    return Status::OK();
+  }
+
+  const size_t group_count = narrow<size_t>(conv_attrs_.group);
+  const size_t input_channels = narrow<size_t>(shape[1]);
+  const size_t filter_count = narrow<size_t>(shape[0]) / group_count;
+
+  // MlasConvWinogradPrepare never selects the Winograd algorithm for narrow layers.
+  if (input_channels < kWinogradMinimumChannels || filter_count < kWinogradMinimumChannels) {
+    return Status::OK();
+  }
+
+  const size_t packed_size = MlasConvWinogradPackFilterSize(group_count, input_channels, filter_count);
+  winograd_filter_ = IAllocator::MakeUniquePtr<void>(alloc, packed_size, true);
+  MlasConvWinogradPackFilter(group_count, input_channels, filter_count, tensor.Data<float>(),
+                             static_cast<float*>(winograd_filter_.get()));
+
+  // MlasConvPrepare also requires a minimum output size, so the original filter is only released if the spatial
+  // dimensions of the input are static and large enough. Otherwise Compute may fall back to another algorithm.
+  is_packed = WinogradIsSelectedForStaticInput(shape);
+  if (!is_packed) {
+    return Status::OK();
+  }
+
+  filter_shape_ = shape;
+
+  if (prepacked_weights != nullptr) {
+    prepacked_weights->buffers_.push_back(std::move(winograd_filter_));
+    prepacked_weights->buffer_sizes_.push_back(packed_size);
+  }
+
+  return Status::OK();
+}
+
+bool Conv<float>::WinogradIsSelectedForStaticInput(const TensorShape& filter_shape) const {
+  const auto* input_shape_proto = Node().InputDefs()[0]->Shape();
+  if (input_shape_proto == nullptr || input_shape_proto->dim_size() != 4 ||
+      !utils::HasDimValue(input_shape_proto->dim(2)) || !utils::HasDimValue(input_shape_proto->dim(3))) {
+    return false;
+  }
+
+  TensorShapeVector kernel_shape;
+  if (!conv_attrs_.ComputeKernelShape(filter_shape, kernel_shape).IsOK() || kernel_shape.size() != 2) {
+    return false;
+  }
+
+  ConvPadVector pads(conv_attrs_.pads);
+  if (pads.empty()) {
+    pads.resize(kernel_shape.size() * 2, 0);
+  }
+  const TensorShapeVector dilations(kernel_shape.size(), 1);
+  const TensorShapeVector strides(kernel_shape.size(), 1);
+
+  const TensorShape input_shape({input_shape_proto->dim(2).dim_value(), input_shape_proto->dim(3).dim_value()});
+  TensorShapeVector output_dims;
+  if (!conv_attrs_.InferPadsAndOutputShape(input_shape, kernel_shape, strides, dilations, pads, output_dims).IsOK()) {
+    return false;
+  }
+
+  return TensorShape(output_dims).Size() >= kWinogradMinimumOutputSize;
+}
+
+Status Conv<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              int input_idx,
+                                              /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    winograd_filter_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* X = context->Input<Tensor>(0);
   const Tensor* W = context->Input<Tensor>(1);
   const Tensor* B = num_inputs >= 3 ? context->Input<Tensor>(2) : nullptr;
   const Tensor* Sum = num_inputs >= 4 ? context->Input<Tensor>(3) : nullptr;
+  // W is null if PrePack replaced the filter with the Winograd transformed filter.
+  const TensorShape& W_shape = W != nullptr ? W->Shape() : filter_shape_;
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
-  const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
+  const int64_t M = W_shape[0];
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_shape));
 
   // kernel_shape is an optional attribute and has to be inferred from W if not provided
   TensorShapeVector kernel_shape;
-  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W->Shape(), kernel_shape));
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
 
   ConvPadVector pads(conv_attrs_.pads);
   if (pads.empty()) {
@@ -237,9 +337,16 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                                                : nullptr;
     BufferUniquePtr working_buffer(working_data, BufferDeleter(std::move(alloc)));
 
+    if (Parameters.Algorithm == MlasConvAlgorithmWinograd && winograd_filter_ != nullptr) {
+      Parameters.u.Winograd.PackedFilter = static_cast<const float*>(winograd_filter_.get());
+    }
+    ORT_RETURN_IF(W == nullptr && Parameters.Algorithm != MlasConvAlgorithmWinograd,
+                  "The filter was released by PrePack but the Winograd algorithm was not selected for input shape ",
+                  X->Shape());
+
     MlasConv(&Parameters,
              Xdata.data(),
-             W->Data<float>(),
+             W != nullptr ? W->Data<float>() : nullptr,
              Bdata,
              static_cast<float*>(working_buffer.get()),
              Ydata.data(),
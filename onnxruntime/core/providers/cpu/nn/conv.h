@@ -28,12 +28,32 @@ class Conv<float> : public OpKernel {
     activation_.ActivationKind = MlasIdentityActivation;
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  protected:
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  // Thresholds of MlasConvWinogradPrepare for selecting the Winograd algorithm.
+  static constexpr size_t kWinogradMinimumChannels = 16;
+  static constexpr int64_t kWinogradMinimumOutputSize = 64;
+
+  bool WinogradIsSelectedForStaticInput(const TensorShape& filter_shape) const;
+
+  // 3x3 filters pre-transformed for the MLAS Winograd algorithm.
+  IAllocatorUniquePtr<void> winograd_filter_;
+  // Shape of the filter if PrePack released the original filter.
+  TensorShape filter_shape_;
 };
 
 }  // namespace onnxruntime
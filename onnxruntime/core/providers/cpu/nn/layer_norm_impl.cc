@@ -3,8 +3,11 @@
 
 #include "layer_norm_impl.h"
 
+#include <type_traits>
+
 #include "core/common/safeint.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
@@ -74,47 +77,92 @@ Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, boo
     inv_std_dev_data = inv_std_dev->MutableData<U>();
   }
 
-  concurrency::ThreadPool::TryBatchParallelFor(
-      p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(norm_count),
-      [&](ptrdiff_t task_idx) {
-        const T* p_input = X_data + task_idx * norm_size;
-        T* p_output = Y_data + task_idx * norm_size;
-
-        T mean = 0;
-        T mean_square = 0;
+  if constexpr (std::is_same_v<T, double>) {
+    concurrency::ThreadPool::TryBatchParallelFor(
+        p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(norm_count),
+        [&](ptrdiff_t task_idx) {
+          const T* p_input = X_data + task_idx * norm_size;
+          T* p_output = Y_data + task_idx * norm_size;
 
-        for (int64_t h = 0; h < norm_size; h++) {
-          mean += p_input[h];
-          mean_square += p_input[h] * p_input[h];
-        }
+          T mean = 0;
+          T mean_square = 0;
 
-        mean = mean / norm_size;
-        if (simplified) {
-          mean_square = sqrt(mean_square / norm_size + epsilon);
-        } else {
-          mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
-        }
+          for (int64_t h = 0; h < norm_size; h++) {
+            mean += p_input[h];
+            mean_square += p_input[h] * p_input[h];
+          }
 
-        for (int64_t h = 0; h < norm_size; h++) {
+          mean = mean / norm_size;
           if (simplified) {
-            p_output[h] = p_input[h] / mean_square * scale_data[h];
-          } else if (nullptr == bias) {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
+            mean_square = sqrt(mean_square / norm_size + epsilon);
           } else {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
+            mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
+          }
+
+          for (int64_t h = 0; h < norm_size; h++) {
+            if (simplified) {
+              p_output[h] = p_input[h] / mean_square * scale_data[h];
+            } else if (nullptr == bias) {
+              p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
+            } else {
+              p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
+            }
+          }
+
+          if (mean_data != nullptr) {
+            // ONNX spec doesn't support 'double' for 'U' so when 'T' == double, 'U' == float and we need to narrow
+            mean_data[task_idx] = gsl::narrow_cast<U>(mean);
           }
-        }
 
+          if (inv_std_dev_data != nullptr) {
+            inv_std_dev_data[task_idx] = gsl::narrow_cast<U>(1 / mean_square);
+          }
+        },
+        0);
+  } else {
+    MLAS_LAYER_NORM_PARAMS<T> params;
+    params.Input = X_data;
+    params.Scale = scale_data;
+    params.Shift = bias_data;
+    params.Output = Y_data;
+    params.Epsilon = epsilon;
+
+    // MLAS computes the statistics in float. Convert them afterwards when U is float16.
+    IAllocatorUniquePtr<float> mean_float;
+    IAllocatorUniquePtr<float> inv_std_dev_float;
+    if constexpr (std::is_same_v<U, float>) {
+      params.Mean = mean_data;
+      params.InvStdDev = inv_std_dev_data;
+    } else {
+      if (mean_data != nullptr) {
+        mean_float = IAllocator::MakeUniquePtr<float>(alloc, onnxruntime::narrow<size_t>(norm_count));
+        params.Mean = mean_float.get();
+      }
+      if (inv_std_dev_data != nullptr) {
+        inv_std_dev_float = IAllocator::MakeUniquePtr<float>(alloc, onnxruntime::narrow<size_t>(norm_count));
+        params.InvStdDev = inv_std_dev_float.get();
+      }
+    }
+
+    if (simplified) {
+      MlasRmsNorm(params, onnxruntime::narrow<size_t>(norm_count), onnxruntime::narrow<size_t>(norm_size),
+                  p_ctx->GetOperatorThreadPool());
+    } else {
+      MlasLayerNorm(params, onnxruntime::narrow<size_t>(norm_count), onnxruntime::narrow<size_t>(norm_size),
+                    p_ctx->GetOperatorThreadPool());
+    }
+
+    if constexpr (!std::is_same_v<U, float>) {
+      for (int64_t i = 0; i < norm_count; ++i) {
         if (mean_data != nullptr) {
-          // ONNX spec doesn't support 'double' for 'U' so when 'T' == double, 'U' == float and we need to narrow
-          mean_data[task_idx] = gsl::narrow_cast<U>(mean);
+          mean_data[i] = static_cast<U>(mean_float.get()[i]);
         }
-
         if (inv_std_dev_data != nullptr) {
-          inv_std_dev_data[task_idx] = gsl::narrow_cast<U>(1 / mean_square);
+          inv_std_dev_data[i] = static_cast<U>(inv_std_dev_float.get()[i]);
         }
-      },
-      0);
+      }
+    }
+  }
 
   return Status::OK();
 }
@@ -141,7 +189,7 @@ struct SrcDispatcher {
 Status LayerNormImpl::Compute(OpKernelContext* p_ctx) const {
   const auto elem_type = p_ctx->Input<Tensor>(0)->GetElementType();
 
-  using SupportedTypeList = boost::mp11::mp_list<float, double>;
+  using SupportedTypeList = boost::mp11::mp_list<float, double, MLFloat16>;
 
   utils::MLTypeCallDispatcherFromTypeList<SupportedTypeList> t_disp(elem_type);
   return t_disp.InvokeRet<Status, SrcDispatcher>(p_ctx, axis_, epsilon_, simplified_, contrib_op_);
@@ -0,0 +1,402 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/dynamic_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "core/framework/error_code_helper.h"
+#include "core/framework/tensor.h"
+#include "core/graph/node_arg.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+DynamicBatcher::DynamicBatcher(const DynamicBatchingOptions& options,
+                               InlinedHashSet<std::string> batch_input_names,
+                               concurrency::ThreadPool* thread_pool,
+                               AllocatorPtr cpu_allocator,
+                               RunFn run_fn,
+                               const logging::Logger& logger)
+    : options_(options),
+      batch_input_names_(std::move(batch_input_names)),
+      thread_pool_(thread_pool),
+      cpu_allocator_(std::move(cpu_allocator)),
+      run_fn_(std::move(run_fn)),
+      logger_(logger) {
+  ORT_ENFORCE(options_.max_batch_size > 1, "Dynamic batching requires a max batch size greater than 1.");
+  ORT_ENFORCE(thread_pool_ != nullptr && cpu_allocator_ != nullptr);
+}
+
+DynamicBatcher::~DynamicBatcher() {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  shutting_down_ = true;
+  queue_cv_.notify_all();
+  // the collectors drain the queue without waiting for the queue delay once shutting_down_ is set
+  while (active_collectors_ > 0) {
+    shutdown_cv_.wait(lock);
+  }
+}
+
+bool DynamicBatcher::HasSymbolicBatchAxis(gsl::span<const NodeArg* const> inputs,
+                                          gsl::span<const NodeArg* const> outputs) {
+  if (inputs.empty() || outputs.empty()) {
+    return false;
+  }
+
+  const std::string* batch_dim_param = nullptr;
+  auto has_batch_axis = [&batch_dim_param](const NodeArg& node_arg) {
+    const auto* shape = node_arg.Shape();
+    if (shape == nullptr || shape->dim_size() < 1 || !shape->dim(0).has_dim_param()) {
+      return false;
+    }
+
+    const auto& dim_param = shape->dim(0).dim_param();
+    if (batch_dim_param == nullptr) {
+      batch_dim_param = &dim_param;
+    }
+
+    return *batch_dim_param == dim_param;
+  };
+
+  return std::all_of(inputs.begin(), inputs.end(), [&](const NodeArg* arg) { return has_batch_axis(*arg); }) &&
+         std::all_of(outputs.begin(), outputs.end(), [&](const NodeArg* arg) { return has_batch_axis(*arg); });
+}
+
+bool DynamicBatcher::TryEnqueue(const RunOptions* run_options,
+                                gsl::span<const char* const> feed_names,
+                                gsl::span<const OrtValue* const> feeds,
+                                gsl::span<const char* const> fetch_names,
+                                gsl::span<OrtValue*> fetches,
+                                RunAsyncCallbackFn callback,
+                                void* user_data,
+                                std::chrono::steady_clock::time_point deadline) {
+  if (feed_names.size() != batch_input_names_.size() || feeds.size() != feed_names.size() ||
+      fetch_names.empty() || fetches.size() != fetch_names.size()) {
+    return false;
+  }
+
+  // pre-allocated outputs are written in place by a regular run
+  if (std::any_of(fetches.begin(), fetches.end(), [](const OrtValue* fetch) { return fetch != nullptr; })) {
+    return false;
+  }
+
+  Request request;
+  request.num_rows = -1;
+  request.feed_names.reserve(feed_names.size());
+  request.feeds.reserve(feeds.size());
+  for (size_t i = 0, end = feed_names.size(); i < end; ++i) {
+    if (feed_names[i] == nullptr || batch_input_names_.count(feed_names[i]) == 0 ||
+        feeds[i] == nullptr || !feeds[i]->IsTensor()) {
+      return false;
+    }
+
+    const auto& tensor = feeds[i]->Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    if (tensor.Location().device.Type() != OrtDevice::CPU || tensor.IsDataTypeString() ||
+        shape.NumDimensions() < 1 || shape[0] < 1 ||
+        (request.num_rows != -1 && shape[0] != request.num_rows)) {
+      return false;
+    }
+
+    request.num_rows = shape[0];
+    request.feed_names.emplace_back(feed_names[i]);
+    request.feeds.push_back(*feeds[i]);
+  }
+
+  // a repeated feed name would leave a batch input without a value
+  InlinedHashSet<std::string_view> unique_feed_names(request.feed_names.begin(), request.feed_names.end());
+  if (unique_feed_names.size() != batch_input_names_.size() ||
+      static_cast<size_t>(request.num_rows) > options_.max_batch_size) {
+    return false;
+  }
+
+  request.fetch_names.reserve(fetch_names.size());
+  for (const char* fetch_name : fetch_names) {
+    if (fetch_name == nullptr || fetch_name[0] == '\0') {
+      return false;
+    }
+    request.fetch_names.emplace_back(fetch_name);
+  }
+
+  request.run_options = run_options;
+  request.fetches = fetches;
+  request.callback = callback;
+  request.user_data = user_data;
+  request.enqueue_time = std::chrono::steady_clock::now();
+  request.deadline = deadline;
+
+  bool schedule_collector = false;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (shutting_down_) {
+      return false;
+    }
+
+    queue_.push_back(std::move(request));
+    if (collector_waiting_) {
+      queue_cv_.notify_one();
+    } else {
+      schedule_collector = ReserveCollectorLocked();
+    }
+  }
+
+  if (schedule_collector) {
+    ScheduleCollector();
+  }
+
+  return true;
+}
+
+bool DynamicBatcher::IsCompatible(const Request& a, const Request& b) {
+  if (a.run_options != b.run_options || a.feed_names != b.feed_names || a.fetch_names != b.fetch_names) {
+    return false;
+  }
+
+  for (size_t i = 0, end = a.feeds.size(); i < end; ++i) {
+    const auto& a_tensor = a.feeds[i].Get<Tensor>();
+    const auto& b_tensor = b.feeds[i].Get<Tensor>();
+    if (a_tensor.DataType() != b_tensor.DataType() ||
+        a_tensor.Shape().Slice(1) != b_tensor.Shape().Slice(1)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+size_t DynamicBatcher::CompatibleRowsAtFrontLocked() const {
+  const Request& front = queue_.front();
+  size_t num_rows = 0;
+  for (const auto& request : queue_) {
+    if (IsCompatible(front, request)) {
+      num_rows += static_cast<size_t>(request.num_rows);
+    }
+  }
+
+  return num_rows;
+}
+
+std::vector<DynamicBatcher::Request> DynamicBatcher::ExtractBatchLocked() {
+  std::vector<Request> batch;
+  batch.push_back(std::move(queue_.front()));
+  queue_.pop_front();
+
+  size_t num_rows = static_cast<size_t>(batch.front().num_rows);
+  for (auto it = queue_.begin(); it != queue_.end() && num_rows < options_.max_batch_size;) {
+    const size_t request_rows = static_cast<size_t>(it->num_rows);
+    if (num_rows + request_rows <= options_.max_batch_size && IsCompatible(batch.front(), *it)) {
+      num_rows += request_rows;
+      batch.push_back(std::move(*it));
+      it = queue_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  return batch;
+}
+
+bool DynamicBatcher::ReserveCollectorLocked() {
+  collector_waiting_ = true;
+  ++active_collectors_;
+  return true;
+}
+
+void DynamicBatcher::ScheduleCollector() {
+  // Schedule may run the task inline if the thread pool queue is full so this must be called without holding mutex_
+  concurrency::ThreadPool::Schedule(thread_pool_, [this]() { CollectAndRun(); });
+}
+
+void DynamicBatcher::CollectAndRun() {
+  std::vector<Request> batch;
+  bool schedule_collector = false;
+  {
+    std::unique_lock<OrtMutex> lock(mutex_);
+    while (!shutting_down_ && CompatibleRowsAtFrontLocked() < options_.max_batch_size) {
+      const auto now = std::chrono::steady_clock::now();
+      // do not hold a request past its own deadline waiting for the batch to fill
+      const auto deadline = std::min(queue_.front().enqueue_time + options_.max_queue_delay,
+                                     queue_.front().deadline);
+      if (now >= deadline) {
+        break;
+      }
+      queue_cv_.wait_for(lock, deadline - now);
+    }
+
+    batch = ExtractBatchLocked();
+    collector_waiting_ = false;
+
+    // hand the remaining requests to a new collector so they do not wait for this batch to finish executing
+    if (!queue_.empty()) {
+      schedule_collector = ReserveCollectorLocked();
+    }
+  }
+
+  if (schedule_collector) {
+    ScheduleCollector();
+  }
+
+  RunBatch(batch);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  --active_collectors_;
+  shutdown_cv_.notify_all();
+}
+
+void DynamicBatcher::DropExpired(std::vector<Request>& batch) {
+  const auto now = std::chrono::steady_clock::now();
+  auto expired = std::stable_partition(batch.begin(), batch.end(),
+                                       [now](const Request& request) { return now < request.deadline; });
+  std::vector<OrtValue> no_fetches;
+  for (auto it = expired; it != batch.end(); ++it) {
+    Status status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Request dropped as its deadline passed after ",
+                                    std::chrono::duration_cast<std::chrono::microseconds>(now - it->enqueue_time)
+                                        .count(),
+                                    " us in the queue.");
+    Complete(*it, status, no_fetches);
+  }
+  batch.erase(expired, batch.end());
+}
+
+void DynamicBatcher::RunBatch(std::vector<Request>& batch) {
+  DropExpired(batch);
+  if (batch.empty()) {
+    return;
+  }
+
+  std::vector<std::vector<OrtValue>> fetches(batch.size());
+
+  if (batch.size() > 1) {
+    // the coalesced run must finish in time for the most urgent request
+    auto earliest = std::min_element(batch.begin(), batch.end(), [](const Request& a, const Request& b) {
+      return a.deadline < b.deadline;
+    });
+    concurrency::ThreadPool::ScopedDeadline deadline(earliest->deadline);
+    Status status = RunCoalesced(batch, fetches);
+    if (status.IsOK()) {
+      for (size_t i = 0; i < batch.size(); ++i) {
+        Complete(batch[i], status, fetches[i]);
+      }
+      return;
+    }
+
+    // Run the requests one by one so a single bad request or a model that is not batchable along dimension 0
+    // does not fail every request in the batch.
+    LOGS(logger_, WARNING) << "Batched execution of " << batch.size()
+                           << " requests failed. Running them individually. Error: " << status.ErrorMessage();
+    DropExpired(batch);
+  }
+
+  for (size_t i = 0; i < batch.size(); ++i) {
+    concurrency::ThreadPool::ScopedDeadline deadline(batch[i].deadline);
+    Status status = RunSingle(batch[i], fetches[i]);
+    Complete(batch[i], status, fetches[i]);
+  }
+}
+
+Status DynamicBatcher::RunSingle(Request& request, std::vector<OrtValue>& fetches) {
+  Status status;
+  fetches.clear();
+  fetches.resize(request.fetch_names.size());
+  ORT_TRY {
+    RunOptions default_run_options;
+    status = run_fn_(request.run_options ? *request.run_options : default_run_options,
+                     request.feed_names, request.feeds, request.fetch_names, fetches);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+    });
+  }
+  ORT_CATCH(...) {
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "unknown exception");
+  }
+
+  return status;
+}
+
+Status DynamicBatcher::RunCoalesced(std::vector<Request>& batch, std::vector<std::vector<OrtValue>>& fetches) {
+  const Request& front = batch.front();
+
+  int64_t total_rows = 0;
+  for (const auto& request : batch) {
+    total_rows += request.num_rows;
+  }
+
+  // concatenate the feeds along the batch dimension
+  Request batched;
+  batched.run_options = front.run_options;
+  batched.feed_names = front.feed_names;
+  batched.fetch_names = front.fetch_names;
+  batched.feeds.resize(front.feeds.size());
+  for (size_t i = 0, end = front.feeds.size(); i < end; ++i) {
+    const auto& front_tensor = front.feeds[i].Get<Tensor>();
+    TensorShapeVector dims = front_tensor.Shape().AsShapeVector();
+    dims[0] = total_rows;
+    Tensor::InitOrtValue(front_tensor.DataType(), TensorShape(dims), cpu_allocator_, batched.feeds[i]);
+
+    auto* dst = static_cast<uint8_t*>(batched.feeds[i].GetMutable<Tensor>()->MutableDataRaw());
+    for (const auto& request : batch) {
+      const auto& src = request.feeds[i].Get<Tensor>();
+      const size_t num_bytes = src.SizeInBytes();
+      std::memcpy(dst, src.DataRaw(), num_bytes);
+      dst += num_bytes;
+    }
+  }
+
+  std::vector<OrtValue> batched_fetches;
+  ORT_RETURN_IF_ERROR(RunSingle(batched, batched_fetches));
+
+  for (size_t j = 0, end = batched_fetches.size(); j < end; ++j) {
+    const auto& fetch = batched_fetches[j];
+    ORT_RETURN_IF_NOT(fetch.IsTensor(), "Output ", batched.fetch_names[j], " is not a tensor.");
+    const auto& tensor = fetch.Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    ORT_RETURN_IF_NOT(tensor.Location().device.Type() == OrtDevice::CPU && !tensor.IsDataTypeString(),
+                      "Output ", batched.fetch_names[j], " must be a non-string CPU tensor to be split.");
+    ORT_RETURN_IF_NOT(shape.NumDimensions() >= 1 && shape[0] == total_rows,
+                      "Output ", batched.fetch_names[j], " with shape ", shape,
+                      " does not have the batch size ", total_rows, " in dimension 0.");
+  }
+
+  // scatter the outputs back as views that keep the batched output alive
+  int64_t row_offset = 0;
+  for (size_t k = 0; k < batch.size(); ++k) {
+    const int64_t num_rows = batch[k].num_rows;
+    fetches[k].resize(batched_fetches.size());
+    for (size_t j = 0, end = batched_fetches.size(); j < end; ++j) {
+      const OrtValue& batched_fetch = batched_fetches[j];
+      const auto& tensor = batched_fetch.Get<Tensor>();
+      const size_t row_bytes = tensor.SizeInBytes() / static_cast<size_t>(total_rows);
+      TensorShapeVector dims = tensor.Shape().AsShapeVector();
+      dims[0] = num_rows;
+
+      auto* data = static_cast<uint8_t*>(const_cast<void*>(tensor.DataRaw())) +
+                   static_cast<size_t>(row_offset) * row_bytes;
+      auto slice = std::make_unique<Tensor>(tensor.DataType(), TensorShape(dims), data, tensor.Location());
+      fetches[k][j].Init(slice.release(), DataTypeImpl::GetType<Tensor>(),
+                         [batched_fetch](void* p) { delete static_cast<Tensor*>(p); });
+    }
+    row_offset += num_rows;
+  }
+
+  return Status::OK();
+}
+
+void DynamicBatcher::Complete(Request& request, const Status& status, std::vector<OrtValue>& fetches) {
+  size_t num_fetches = 0;
+  if (status.IsOK()) {
+    num_fetches = request.fetches.size();
+    for (size_t i = 0; i < num_fetches; ++i) {
+      request.fetches[i] = new OrtValue(std::move(fetches[i]));
+    }
+  }
+
+  request.callback(request.user_data, request.fetches.data(), num_fetches, ToOrtStatus(status));
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,140 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/logging/logging.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/platform/ort_mutex.h"
+#include "core/session/onnxruntime_c_api.h"
+
+namespace onnxruntime {
+class NodeArg;
+namespace concurrency {
+class ThreadPool;
+}
+
+struct DynamicBatchingOptions {
+  // Maximum number of rows (sum of the batch dimension of the coalesced requests) in a batched run.
+  // A value of 0 or 1 disables dynamic batching.
+  size_t max_batch_size = 0;
+
+  // Maximum time the oldest queued request waits for more requests to arrive before its batch is run.
+  std::chrono::microseconds max_queue_delay{1000};
+};
+
+/**
+ * Coalesces concurrent RunAsync requests along the batch dimension.
+ *
+ * Requests are batchable if all their feeds are dense CPU tensors that share the same batch size in dimension 0 and
+ * all their fetches are unallocated. Queued requests that use the same RunOptions instance, the same feed and fetch
+ * names, and feeds with matching element types and non-batch dimensions are concatenated, executed once and the
+ * outputs are handed back to each callback as views into the batched output.
+ *
+ * The caller is responsible for only enabling this for models whose inputs and outputs all share a symbolic
+ * leading batch dimension, i.e. where the rows of the batch are computed independently.
+ */
+class DynamicBatcher {
+ public:
+  using RunFn = std::function<Status(const RunOptions& run_options,
+                                     gsl::span<const std::string> feed_names,
+                                     gsl::span<const OrtValue> feeds,
+                                     gsl::span<const std::string> fetch_names,
+                                     std::vector<OrtValue>& fetches)>;
+
+  DynamicBatcher(const DynamicBatchingOptions& options,
+                 InlinedHashSet<std::string> batch_input_names,
+                 concurrency::ThreadPool* thread_pool,
+                 AllocatorPtr cpu_allocator,
+                 RunFn run_fn,
+                 const logging::Logger& logger);
+
+  // Waits for all queued requests to be executed and their callbacks invoked.
+  ~DynamicBatcher();
+
+  /**
+   * Queue a request for batched execution.
+   * @param deadline Deadline of the request. A request whose deadline passes while it is queued is completed with
+   *                 an error without being run, and a batch runs under the earliest deadline of its requests.
+   * @returns false if the request cannot be batched. The caller should execute it directly in that case.
+   */
+  bool TryEnqueue(const RunOptions* run_options,
+                  gsl::span<const char* const> feed_names,
+                  gsl::span<const OrtValue* const> feeds,
+                  gsl::span<const char* const> fetch_names,
+                  gsl::span<OrtValue*> fetches,
+                  RunAsyncCallbackFn callback,
+                  void* user_data,
+                  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+  /**
+   * Detect whether all graph inputs and outputs share a symbolic leading dimension that can be used as batch axis.
+   * @param inputs Graph inputs, excluding initializers.
+   * @param outputs Graph outputs.
+   */
+  static bool HasSymbolicBatchAxis(gsl::span<const NodeArg* const> inputs, gsl::span<const NodeArg* const> outputs);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DynamicBatcher);
+
+  struct Request {
+    const RunOptions* run_options;
+    std::vector<std::string> feed_names;
+    std::vector<OrtValue> feeds;
+    std::vector<std::string> fetch_names;
+    gsl::span<OrtValue*> fetches;
+    RunAsyncCallbackFn callback;
+    void* user_data;
+    int64_t num_rows;
+    std::chrono::steady_clock::time_point enqueue_time;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  // Returns true if the two requests can be executed in the same batched run.
+  static bool IsCompatible(const Request& a, const Request& b);
+
+  // Number of queued rows that can be batched together with the request at the front of the queue.
+  size_t CompatibleRowsAtFrontLocked() const;
+
+  // Remove the request at the front of the queue and as many compatible requests as fit in max_batch_size.
+  std::vector<Request> ExtractBatchLocked();
+
+  // Marks a collector as pending. Returns true so the caller schedules it once mutex_ is released.
+  bool ReserveCollectorLocked();
+  void ScheduleCollector();
+  void CollectAndRun();
+  void RunBatch(std::vector<Request>& batch);
+  // Complete the requests of the batch whose deadline has passed with an error and remove them from the batch.
+  void DropExpired(std::vector<Request>& batch);
+  Status RunSingle(Request& request, std::vector<OrtValue>& fetches);
+  Status RunCoalesced(std::vector<Request>& batch, std::vector<std::vector<OrtValue>>& fetches);
+  void Complete(Request& request, const Status& status, std::vector<OrtValue>& fetches);
+
+  const DynamicBatchingOptions options_;
+  const InlinedHashSet<std::string> batch_input_names_;
+  concurrency::ThreadPool* const thread_pool_;
+  const AllocatorPtr cpu_allocator_;
+  const RunFn run_fn_;
+  const logging::Logger& logger_;
+
+  OrtMutex mutex_;
+  OrtCondVar queue_cv_;     // signaled when a request is queued or on shutdown
+  OrtCondVar shutdown_cv_;  // signaled when a collector finishes
+  std::deque<Request> queue_;
+  bool collector_waiting_ = false;
+  int active_collectors_ = 0;
+  bool shutting_down_ = false;
+};
+
+}  // namespace onnxruntime
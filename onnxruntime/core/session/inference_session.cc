@@ -4,6 +4,8 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <chrono>
+#include <cmath>
 #include <memory>
 #include <sstream>
 #include <list>
@@ -24,6 +26,8 @@
 #include "core/framework/execution_frame.h"
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/graph_partitioner.h"
+#include "core/framework/intra_op_parallelism_tuner.h"
+#include "core/framework/node_trace_recorder.h"
 #include "core/framework/kernel_def_builder.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/kernel_type_str_resolver.h"
@@ -34,6 +38,7 @@
 #include "core/framework/tensor_type_and_shape.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/framework/transform_layout_functions.h"
 #include "core/framework/utils.h"
 #include "core/graph/graph_viewer.h"
@@ -71,6 +76,7 @@
 #include "core/session/inference_session_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
+#include "core/session/optimized_model_cache.h"
 #include "core/util/protobuf_parsing_utils.h"
 #include "core/util/thread_utils.h"
 
@@ -244,6 +250,52 @@ Status GetMinimalBuildOptimizationHandling(
 
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
+// Parse the value of kOrtSessionOptionsConfigIntraOpPriority or kOrtRunOptionsConfigIntraOpPriority.
+Status ParseIntraOpPriority(const std::string& value, concurrency::ThreadPool::Priority& priority) {
+  if (value == "normal") {
+    priority = concurrency::ThreadPool::Priority::kNormal;
+  } else if (value == "high") {
+    priority = concurrency::ThreadPool::Priority::kHigh;
+  } else {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid intra-op priority '", value,
+                           "'. Valid values are 'normal' and 'high'.");
+  }
+  return Status::OK();
+}
+
+// Parse the value of kOrtSessionOptionsConfigIntraOpThreadShare or kOrtRunOptionsConfigIntraOpThreadShare into
+// the number of the pool_threads threads, including the calling thread, that a run may use. 0 for the whole pool.
+Status ParseIntraOpThreadShare(const std::string& value, int pool_threads, int& thread_limit) {
+  float share = 0.0f;
+  if (!TryParseStringWithClassicLocale<float>(value, share) || !(share > 0.0f && share <= 1.0f)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid intra-op thread share '", value,
+                           "'. It must be a number in (0, 1].");
+  }
+  const int threads = std::max(1, static_cast<int>(std::lround(share * static_cast<float>(pool_threads))));
+  thread_limit = threads < pool_threads ? threads : 0;
+  return Status::OK();
+}
+
+// Parse the value of kOrtRunOptionsConfigDeadlineMs into the deadline of a run started at start. time_point::max()
+// if the run options do not set a deadline.
+Status ParseRunDeadline(const RunOptions& run_options, std::chrono::steady_clock::time_point start,
+                        std::chrono::steady_clock::time_point& deadline) {
+  deadline = std::chrono::steady_clock::time_point::max();
+  const std::string& value = run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigDeadlineMs, "");
+  if (value.empty()) {
+    return Status::OK();
+  }
+
+  double deadline_ms = 0.0;
+  if (!TryParseStringWithClassicLocale<double>(value, deadline_ms) || !(deadline_ms > 0.0 && deadline_ms <= 1e9)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid run deadline '", value,
+                           "'. It must be a number of milliseconds in (0, 1e9].");
+  }
+  deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                         std::chrono::duration<double, std::milli>(deadline_ms));
+  return Status::OK();
+}
+
 }  // namespace
 
 std::atomic<uint32_t> InferenceSession::global_session_id_{1};
@@ -454,6 +506,9 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
 #if !defined(ORT_MINIMAL_BUILD)
   // Update the number of steps for the graph transformer manager using the "finalized" session options
   ORT_THROW_IF_ERROR(graph_transformer_mgr_.SetSteps(session_options_.max_num_graph_transformation_steps));
+  graph_transformer_mgr_.SetWorklistMode(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsGraphOptimizationWorklistMode, "0") == "1");
+  graph_transformer_mgr_.SetProfiler(&session_profiler_);
 #endif
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
@@ -518,6 +573,8 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         to.auto_set_affinity = to.thread_pool_size == 0 &&
                                session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
                                to.affinity_str.empty();
+        to.numa_aware =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpNumaAware, "0") == "1";
 
         if (to.custom_create_thread_fn) {
           ORT_ENFORCE(to.custom_join_thread_fn, "custom join thread function not set for intra op thread pool");
@@ -704,6 +761,16 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 InferenceSession::~InferenceSession() {
+  // execute the queued RunAsync requests while the rest of the session is still valid
+  dynamic_batcher_.reset();
+
+  if (intra_op_parallelism_tuner_) {
+    // The session works without the tuning file, so failing to write it is not an error
+    if (auto status = intra_op_parallelism_tuner_->Save(*session_logger_); !status.IsOK()) {
+      LOGS(*session_logger_, WARNING) << "Failed to save the intra-op parallelism tuning: " << status.ErrorMessage();
+    }
+  }
+
   if (session_options_.enable_profiling) {
     ORT_TRY {
       EndProfiling();
@@ -877,7 +944,10 @@ common::Status InferenceSession::RegisterGraphTransformer(
                           "Graph transformers must be registered before the session is initialized.");
   }
 
-  return graph_transformer_mgr_.Register(std::move(p_graph_transformer), level);
+  std::string name = p_graph_transformer->Name() + ":" + std::to_string(static_cast<int>(level));
+  ORT_RETURN_IF_ERROR_SESSIONID_(graph_transformer_mgr_.Register(std::move(p_graph_transformer), level));
+  custom_graph_transformers_.push_back(std::move(name));
+  return Status::OK();
 }
 
 common::Status InferenceSession::SaveToOrtFormat(const std::filesystem::path& filepath) const {
@@ -916,14 +986,100 @@ common::Status InferenceSession::SaveToOrtFormat(const std::filesystem::path& fi
   {
     std::ofstream file(filepath, std::ios::binary);
     uint8_t* buf = builder.GetBufferPointer();
-    int size = builder.GetSize();
-    file.write(reinterpret_cast<const char*>(buf), size);
+    const size_t size = builder.GetSize();
+    file.write(reinterpret_cast<const char*>(buf), static_cast<std::streamsize>(size));
     ORT_RETURN_IF_NOT(file, "Failed to save ORT format model to file: ", ToUTF8String(filepath.native()));
   }
 
   return Status::OK();
 }
 
+Status InferenceSession::LoadOptimizedModelFromCache(PathString& cache_file_to_write) {
+  const std::string cache_dir = session_options_.config_options.GetConfigOrDefault(
+      kOrtSessionOptionsConfigOptimizedModelCacheDir, "");
+  // an ORT format model is already optimized, and a model that is saved must be optimized by this session
+  if (cache_dir.empty() || !ort_format_model_bytes_.empty() || !session_options_.optimized_model_filepath.empty()) {
+    return Status::OK();
+  }
+
+  const PathString cache_file = optimized_model_cache::GetCacheFilePath(
+      ToPathString(cache_dir), model_->MainGraph(), execution_providers_, session_options_, optimizers_to_disable_,
+      custom_graph_transformers_, custom_registries_);
+
+  std::error_code error;
+  if (std::filesystem::exists(cache_file, error)) {
+    auto onnx_model = model_;
+    auto status = ReadOrtModelFile(cache_file);
+    if (status.IsOK()) {
+      status = LoadOrtModelFromBytes();
+    }
+
+    if (status.IsOK()) {
+      LOGS(*session_logger_, INFO) << "Loaded the optimized model from cache file " << ToUTF8String(cache_file);
+      return Status::OK();
+    }
+
+    // e.g. the file was truncated. it is replaced once the model is optimized.
+    LOGS(*session_logger_, WARNING) << "Failed to load optimized model cache file " << ToUTF8String(cache_file)
+                                    << ": " << status.ErrorMessage();
+    model_ = std::move(onnx_model);
+    ort_format_model_bytes_ = gsl::span<const uint8_t>();
+    ort_format_model_mapped_file_.reset();
+    std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+    using_ort_model_bytes_for_initializers_ = false;
+  }
+
+  cache_file_to_write = cache_file;
+  return Status::OK();
+}
+
+void InferenceSession::SaveOptimizedModelToCache(const PathString& cache_file) const {
+  if (session_state_->GetFuncMgr().NumFuncs() > 0) {
+    LOGS(*session_logger_, INFO) << "The optimized model is not cached as it contains nodes compiled by an "
+                                    "execution provider.";
+    return;
+  }
+
+  // A flatbuffer is limited to 2GB, and the initializers make up most of the ORT format model.
+  size_t initializers_size = 0;
+  for (const auto& [name, initializer] : model_->MainGraph().GetAllInitializedTensors()) {
+    size_t size = 0;
+    if (utils::GetSizeInBytesFromTensorProto<0>(*initializer, &size).IsOK()) {
+      initializers_size += size;
+    }
+  }
+  if (initializers_size >= FLATBUFFERS_MAX_BUFFER_SIZE) {
+    LOGS(*session_logger_, WARNING) << "The optimized model is not cached as its " << initializers_size
+                                    << " bytes of initializers exceed the size limit of an ORT format model.";
+    return;
+  }
+
+  // Write to a file of this session and rename it, so that no session loads a partially written file.
+  std::basic_ostringstream<PathChar> temp_path;
+  temp_path << cache_file << ORT_TSTR(".") << Env::Default().GetSelfPid() << ORT_TSTR(".") << session_id_
+            << ORT_TSTR(".tmp");
+  const std::filesystem::path temp_file_path(temp_path.str());
+
+  std::error_code error;
+  std::filesystem::create_directories(temp_file_path.parent_path(), error);
+  auto status = SaveToOrtFormat(temp_file_path);
+  if (status.IsOK()) {
+    std::filesystem::rename(temp_file_path, std::filesystem::path(cache_file), error);
+    if (error) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, error.message());
+    }
+  }
+
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to save optimized model cache file " << ToUTF8String(cache_file)
+                                    << ": " << status.ErrorMessage();
+    std::filesystem::remove(temp_file_path, error);
+    return;
+  }
+
+  LOGS(*session_logger_, INFO) << "Saved the optimized model to cache file " << ToUTF8String(cache_file);
+}
+
 common::Status InferenceSession::LoadWithLoader(std::function<common::Status(std::shared_ptr<Model>&)> loader,
                                                 const std::string& event_name) {
   Status status = Status::OK();
@@ -1360,12 +1516,31 @@ Status InferenceSession::LoadOrtModel(const PathString& model_uri) {
   return LoadOrtModelWithLoader(
       [&]() {
         model_location_ = model_uri;
-        ORT_RETURN_IF_ERROR(
-            LoadOrtModelBytes(model_location_, ort_format_model_bytes_, ort_format_model_bytes_data_holder_));
-        return Status::OK();
+        return ReadOrtModelFile(model_location_);
       });
 }
 
+Status InferenceSession::ReadOrtModelFile(const PathString& model_uri) {
+  const bool disable_file_mapping = GetSessionOptions().config_options.GetConfigOrDefault(
+                                        kOrtSessionOptionsConfigDisableOrtModelFileMapping, "0") == "1";
+  if (!disable_file_mapping) {
+    // Map the file so that the initializers can use their data in place. Fall back to reading it if that fails.
+    const auto& env = Env::Default();
+    size_t num_bytes = 0;
+    Env::MappedMemoryPtr mapped_file;
+    if (env.GetFileLength(model_uri.c_str(), num_bytes).IsOK() && num_bytes > 0 &&
+        env.MapFileIntoMemory(model_uri.c_str(), 0, num_bytes, mapped_file).IsOK()) {
+      ort_format_model_bytes_ = gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(mapped_file.get()),
+                                                         num_bytes);
+      ort_format_model_mapped_file_ = std::move(mapped_file);
+      return Status::OK();
+    }
+  }
+
+  ORT_RETURN_IF_ERROR(LoadOrtModelBytes(model_uri, ort_format_model_bytes_, ort_format_model_bytes_data_holder_));
+  return Status::OK();
+}
+
 Status InferenceSession::LoadOrtModel(const void* model_data, int model_data_len) {
   return LoadOrtModelWithLoader([&]() {
     const auto& config_options = GetSessionOptions().config_options;
@@ -1404,6 +1579,10 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
 
   ORT_RETURN_IF_ERROR(load_ort_format_model_bytes());
 
+  return LoadOrtModelFromBytes();
+}
+
+Status InferenceSession::LoadOrtModelFromBytes() {
   // Verify the ort_format_model_bytes_ is a valid InferenceSessionBuffer before we access the data
   flatbuffers::Verifier verifier(ort_format_model_bytes_.data(), ort_format_model_bytes_.size());
   ORT_RETURN_IF_NOT(fbs::VerifyInferenceSessionBuffer(verifier), "ORT model verification failed.");
@@ -1467,11 +1646,13 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
   // provided an existing buffer of bytes when creating the InferenceSession, ort_format_model_bytes_data_holder_
   // will be empty.
   // if that is the case we also allow creating initializers that directly use those bytes.
+  // the initializers always use the bytes of a memory mapped model file, which the session owns.
   const auto& config_options = session_options_.config_options;
   using_ort_model_bytes_for_initializers_ =
       load_options.can_use_flatbuffer_for_initializers =
-          ort_format_model_bytes_data_holder_.empty() &&
-          config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1";
+          ort_format_model_mapped_file_ != nullptr ||
+          (ort_format_model_bytes_data_holder_.empty() &&
+           config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1");
 
   // need to go from unique_ptr to shared_ptr when moving into model_
   std::unique_ptr<Model> tmp_model;
@@ -1681,9 +1862,8 @@ common::Status InferenceSession::Initialize() {
     }
 
     // Verify that there are no external initializers in the graph if external data is disabled.
-    onnxruntime::Graph& graph = model_->MainGraph();
 #ifdef DISABLE_EXTERNAL_INITIALIZERS
-    const InitializedTensorSet& initializers = graph.GetAllInitializedTensors();
+    const InitializedTensorSet& initializers = model_->MainGraph().GetAllInitializedTensors();
     for (const auto& it : initializers) {
       if (utils::HasExternalData(*it.second)) {
         return common::Status(common::ONNXRUNTIME, common::FAIL,
@@ -1707,18 +1887,27 @@ common::Status InferenceSession::Initialize() {
 
 #if !defined(DISABLE_EXTERNAL_INITIALIZERS) && !defined(ORT_MINIMAL_BUILD)
     if (!session_options_.external_initializers.empty()) {
-      ORT_RETURN_IF_ERROR_SESSIONID_(graph.InjectExternalInitializedTensors(session_options_.external_initializers));
+      ORT_RETURN_IF_ERROR_SESSIONID_(
+          model_->MainGraph().InjectExternalInitializedTensors(session_options_.external_initializers));
       InlinedHashMap<std::string, OrtValue>{}.swap(session_options_.external_initializers);
     }
 
     if (!session_options_.external_initializer_files_mmap.empty()) {
-      ORT_RETURN_IF_ERROR_SESSIONID_(
-          graph.InjectExternalInitializersFromFilesInMemory(session_options_.external_initializer_files_mmap));
+      ORT_RETURN_IF_ERROR_SESSIONID_(model_->MainGraph().InjectExternalInitializersFromFilesInMemory(
+          session_options_.external_initializer_files_mmap));
       InlinedHashMap<std::basic_string<ORTCHAR_T>, std::pair<char*, size_t>>{}.swap(
           session_options_.external_initializer_files_mmap);
     }
 #endif
 
+#if !defined(ORT_MINIMAL_BUILD)
+    // this may replace model_, so it must happen before the graph is used
+    PathString optimized_model_cache_file;
+    ORT_RETURN_IF_ERROR_SESSIONID_(LoadOptimizedModelFromCache(optimized_model_cache_file));
+#endif
+
+    onnxruntime::Graph& graph = model_->MainGraph();
+
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
     TraceLoggingWriteStart(session_activity, "OrtInferenceSessionActivity");
     session_activity_started_ = true;
@@ -1853,12 +2042,21 @@ common::Status InferenceSession::Initialize() {
       }
 #endif
 
+      TimePoint transform_tp;
+      if (session_profiler_.IsEnabled()) {
+        transform_tp = session_profiler_.Start();
+      }
+
       // apply any transformations to the main graph and any subgraphs
       ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, saving_ort_format));
 
       // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
       ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
 
+      if (session_profiler_.IsEnabled()) {
+        session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "graph_transformation", transform_tp);
+      }
+
       // Currently graph capture is only considered by CUDA EP, TRT EP, ROCM EP and JS EP.
       //
       // Check for CUDA EP:
@@ -2000,6 +2198,10 @@ common::Status InferenceSession::Initialize() {
 
       // Update temporary copies of metadata, input- and output definitions to the same state as the resolved graph
       ORT_RETURN_IF_ERROR_SESSIONID_(SaveModelMetadata(*model_));
+
+      if (!optimized_model_cache_file.empty()) {
+        SaveOptimizedModelToCache(optimized_model_cache_file);
+      }
 #else   // !defined(ORT_MINIMAL_BUILD)
       ORT_RETURN_IF_ERROR_SESSIONID_(
           ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
@@ -2018,12 +2220,87 @@ common::Status InferenceSession::Initialize() {
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
     }
 
+    const std::string prepacked_weights_cache_file =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigPrepackedWeightsCacheFile, "");
+    if (!prepacked_weights_cache_file.empty()) {
+      prepacked_weights_file_cache_ = std::make_unique<PrepackedWeightsFileCache>(
+          ToPathString(prepacked_weights_cache_file), PrepackedWeightsFileCache::GetModelHash(graph));
+      ORT_RETURN_IF_ERROR_SESSIONID_(prepacked_weights_file_cache_->Load(*session_logger_));
+      session_state_->SetPrepackedWeightsFileCache(prepacked_weights_file_cache_.get());
+    }
+
+    intra_op_pool_threads_ = concurrency::ThreadPool::NumThreadsIncludingCaller(GetIntraOpThreadPoolToUse());
+    if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpParallelismTuning, "0") ==
+            "1" &&
+        intra_op_pool_threads_ > 1) {
+      intra_op_parallelism_tuner_ = std::make_unique<IntraOpParallelismTuner>(
+          ToPathString(session_options_.config_options.GetConfigOrDefault(
+              kOrtSessionOptionsConfigIntraOpParallelismTuningFile, "")),
+          PrepackedWeightsFileCache::GetModelHash(graph), intra_op_pool_threads_);
+      ORT_RETURN_IF_ERROR_SESSIONID_(intra_op_parallelism_tuner_->Load(*session_logger_));
+      session_state_->SetIntraOpParallelismTuner(intra_op_parallelism_tuner_.get());
+    }
+
+    if (const std::string priority = session_options_.config_options.GetConfigOrDefault(
+            kOrtSessionOptionsConfigIntraOpPriority, "");
+        !priority.empty()) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(ParseIntraOpPriority(priority, intra_op_priority_));
+    }
+    if (const std::string thread_share = session_options_.config_options.GetConfigOrDefault(
+            kOrtSessionOptionsConfigIntraOpThreadShare, "");
+        !thread_share.empty()) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(
+          ParseIntraOpThreadShare(thread_share, intra_op_pool_threads_, intra_op_thread_limit_));
+    }
+
+    const auto node_trace_sample_interval = ParseStringWithClassicLocale<uint32_t>(
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigNodeTraceSampleInterval, "0"));
+    if (node_trace_sample_interval > 0) {
+      node_trace_recorder_ = std::make_unique<profiling::NodeTraceRecorder>(GraphViewer(graph),
+                                                                            node_trace_sample_interval);
+      session_state_->SetNodeTraceRecorder(node_trace_recorder_.get());
+    }
+
+    const bool share_initializers = session_options_.config_options.GetConfigOrDefault(
+                                        kOrtSessionOptionsConfigShareInitializersAcrossSessions, "0") == "1";
+    if (share_initializers) {
+      if (environment_.GetSharedInitializerStore() != nullptr) {
+        session_state_->SetSharedInitializerStore(environment_.GetSharedInitializerStore());
+      } else {
+        LOGS(*session_logger_, WARNING) << "The environment has no shared initializer store. "
+                                        << "Initializers are not shared with other sessions.";
+      }
+    }
+
     ORT_RETURN_IF_ERROR_SESSIONID_(
         session_state_->FinalizeSessionState(model_location_, kernel_registry_manager_,
                                              // need to keep the initializers if saving the optimized model
                                              !saving_model,
                                              saving_ort_format));
 
+    LOGS(*session_logger_, INFO) << "Initializers: " << session_state_->GetInitializerMappedBytes()
+                                 << " bytes used in place from mapped memory, "
+                                 << session_state_->GetInitializerCopiedBytes() << " bytes copied.";
+
+    if (share_initializers && environment_.GetSharedInitializerStore() != nullptr) {
+      const auto stats = environment_.GetSharedInitializerStore()->GetStats();
+      LOGS(*session_logger_, INFO) << "Shared initializers: " << session_state_->GetInitializerSharedBytes()
+                                   << " bytes shared with other sessions. The environment stores "
+                                   << stats.num_initializers << " initializers of " << stats.bytes << " bytes with "
+                                   << stats.num_references << " references, saving " << stats.saved_bytes
+                                   << " bytes.";
+    }
+
+    if (prepacked_weights_file_cache_) {
+      // The session works without the cache file, so failing to write it is not an error
+      if (auto status = prepacked_weights_file_cache_->Save(*session_logger_); !status.IsOK()) {
+        LOGS(*session_logger_, WARNING) << "Failed to save the pre-packed weights cache: " << status.ErrorMessage();
+      }
+      LOGS(*session_logger_, INFO) << "Used " << session_state_->GetUsedCachedPrePackedWeightCounter()
+                                   << " pre-packed weights from the cache file, mapping "
+                                   << prepacked_weights_file_cache_->GetMappedBytes() << " bytes.";
+    }
+
 #if !defined(ORT_MINIMAL_BUILD)
     if (saving_model) {
       if (session_state_->GetFuncMgr().NumFuncs() > 0) {
@@ -2074,6 +2351,8 @@ common::Status InferenceSession::Initialize() {
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
+    ORT_RETURN_IF_ERROR_SESSIONID_(InitializeDynamicBatcher());
+
     is_inited_ = true;
 
     if (!using_ort_model_bytes_for_initializers_) {
@@ -2495,6 +2774,31 @@ Status InferenceSession::Run(const RunOptions& run_options,
   auto* inter_tp = (control_spinning) ? inter_op_thread_pool_.get() : nullptr;
   ThreadPoolSpinningSwitch runs_refcounter_and_tp_spin_control(intra_tp, inter_tp, current_num_runs_);
 
+  // The priority and share of the intra-op threads of the run default to those of the session, which were parsed
+  // in Initialize. Only the overrides in the run options are parsed here. The executor carries them over to the
+  // inter-op threads running the streams.
+  concurrency::ThreadPool::Priority intra_op_priority = intra_op_priority_;
+  int intra_op_thread_limit = intra_op_thread_limit_;
+  if (const auto& run_configs = run_options.config_options.configurations; !run_configs.empty()) {
+    if (auto it = run_configs.find(kOrtRunOptionsConfigIntraOpPriority);
+        it != run_configs.end() && !it->second.empty()) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(ParseIntraOpPriority(it->second, intra_op_priority));
+    }
+    if (auto it = run_configs.find(kOrtRunOptionsConfigIntraOpThreadShare);
+        it != run_configs.end() && !it->second.empty()) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(
+          ParseIntraOpThreadShare(it->second, intra_op_pool_threads_, intra_op_thread_limit));
+    }
+  }
+  concurrency::ThreadPool::ScopedPriority scoped_intra_op_priority(intra_op_priority);
+  concurrency::ThreadPool::ScopedThreadLimit scoped_intra_op_thread_limit(intra_op_thread_limit);
+
+  // The deadline applies to the kernels of the run on every thread. A RunAsync request already runs under the
+  // deadline counted from its submission, the earlier one applies.
+  std::chrono::steady_clock::time_point deadline;
+  ORT_RETURN_IF_ERROR_SESSIONID_(ParseRunDeadline(run_options, std::chrono::steady_clock::now(), deadline));
+  concurrency::ThreadPool::ScopedDeadline scoped_deadline(deadline);
+
   // Check if this Run() is simply going to be a CUDA Graph replay.
   if (cached_execution_provider_for_graph_replay_.IsGraphCaptured(graph_annotation_id)) {
     LOGS(*session_logger_, INFO) << "Replaying the captured "
@@ -2754,8 +3058,29 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
   if (!tp || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "intra op thread pool must have at least one thread for RunAsync");
   }
+  // the deadline counts the time the request spends queued
+  const auto submit_time = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+  if (run_options) {
+    ORT_RETURN_IF_ERROR(ParseRunDeadline(*run_options, submit_time, deadline));
+  }
+  if (dynamic_batcher_ &&
+      dynamic_batcher_->TryEnqueue(run_options, feed_names, feeds, fetch_names, fetches, callback, user_data,
+                                   deadline)) {
+    return Status::OK();
+  }
   std::function<void()> run_fn = [=]() {
     Status status = Status::OK();
+    if (std::chrono::steady_clock::now() >= deadline) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Request dropped as its deadline passed after ",
+                               std::chrono::duration_cast<std::chrono::microseconds>(
+                                   std::chrono::steady_clock::now() - submit_time)
+                                   .count(),
+                               " us in the queue.");
+      callback(user_data, fetches.data(), 0, ToOrtStatus(status));
+      return;
+    }
+    concurrency::ThreadPool::ScopedDeadline scoped_deadline(deadline);
     ORT_TRY {
       if (run_options) {
         status = Run(*run_options, feed_names, feeds, fetch_names, fetches);
@@ -2778,6 +3103,55 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
   return Status::OK();
 }
 
+common::Status InferenceSession::InitializeDynamicBatcher() {
+  const auto max_batch_size = ParseStringWithClassicLocale<size_t>(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "0"));
+  if (max_batch_size < 2) {
+    return Status::OK();
+  }
+
+  auto* tp = GetIntraOpThreadPoolToUse();
+  if (!tp || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2) {
+    LOGS(*session_logger_, WARNING) << "Dynamic batching requires an intra op thread pool with at least 2 threads. "
+                                    << "RunAsync requests will not be batched.";
+    return Status::OK();
+  }
+
+  const auto& graph = model_->MainGraph();
+  const auto& inputs = graph.GetInputs();
+  const auto& outputs = graph.GetOutputs();
+  if (!DynamicBatcher::HasSymbolicBatchAxis(inputs, outputs)) {
+    LOGS(*session_logger_, WARNING) << "Dynamic batching requires all graph inputs and outputs to share a symbolic "
+                                    << "leading dimension. RunAsync requests will not be batched.";
+    return Status::OK();
+  }
+
+  DynamicBatchingOptions options;
+  options.max_batch_size = max_batch_size;
+  options.max_queue_delay = std::chrono::microseconds(ParseStringWithClassicLocale<int64_t>(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBatchingMaxQueueDelayUs,
+                                                         "1000")));
+  ORT_RETURN_IF(options.max_queue_delay.count() < 0, "Dynamic batching max queue delay must not be negative.");
+
+  InlinedHashSet<std::string> batch_input_names;
+  for (const auto* input : inputs) {
+    batch_input_names.insert(input->Name());
+  }
+
+  dynamic_batcher_ = std::make_unique<DynamicBatcher>(
+      options, std::move(batch_input_names), tp, session_state_->GetAllocator(OrtDevice()),
+      [this](const RunOptions& run_options, gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+             gsl::span<const std::string> fetch_names, std::vector<OrtValue>& fetches) {
+        return Run(run_options, feed_names, feeds, fetch_names, &fetches, nullptr);
+      },
+      *session_logger_);
+
+  LOGS(*session_logger_, INFO) << "Dynamic batching of RunAsync requests enabled with max batch size "
+                               << options.max_batch_size << " and max queue delay "
+                               << options.max_queue_delay.count() << "us.";
+  return Status::OK();
+}
+
 common::Status InferenceSession::Run(const NameMLValMap& feeds, gsl::span<const std::string> output_names,
                                      std::vector<OrtValue>* p_fetches) {
   return Run(RunOptions(), feeds, output_names, p_fetches);
@@ -2913,6 +3287,47 @@ const profiling::Profiler& InferenceSession::GetProfiling() const {
   return session_profiler_;
 }
 
+namespace {
+void WriteThreadPoolStats(std::ostringstream& out, const concurrency::ThreadPool* tp) {
+  if (tp == nullptr) {
+    out << "null";
+    return;
+  }
+  const concurrency::ThreadPoolStats stats = tp->GetStats();
+  out << "{\"num_threads\":" << stats.num_threads
+      << ",\"allow_spinning\":" << (stats.allow_spinning ? "true" : "false")
+      << ",\"tasks_scheduled\":" << stats.tasks_scheduled
+      << ",\"tasks_stolen\":" << stats.tasks_stolen
+      << ",\"spin_iterations\":" << stats.spin_iterations
+      << ",\"parks\":" << stats.parks
+      << ",\"unparks\":" << stats.unparks
+      << ",\"parallel_section_wait_ns\":" << stats.parallel_section_wait_ns
+      << ",\"queue_depth_histogram\":[";
+  for (size_t i = 0; i < concurrency::ThreadPoolStats::kQueueDepthBuckets; ++i) {
+    out << (i == 0 ? "" : ",") << stats.queue_depth_histogram[i];
+  }
+  out << "]}";
+}
+}  // namespace
+
+std::string InferenceSession::GetThreadPoolStats() const {
+  std::ostringstream out;
+  out.imbue(std::locale::classic());
+  out << "{\"intra_op\":";
+  WriteThreadPoolStats(out, GetIntraOpThreadPoolToUse());
+  out << ",\"inter_op\":";
+  WriteThreadPoolStats(out, GetInterOpThreadPoolToUse());
+  out << '}';
+  return out.str();
+}
+
+common::Status InferenceSession::GetNodeTraceStats(std::string& stats_json) const {
+  ORT_RETURN_IF(node_trace_recorder_ == nullptr, "Node tracing is not enabled. Set the session config entry ",
+                kOrtSessionOptionsConfigNodeTraceSampleInterval, " to enable it.");
+  stats_json = profiling::NodeTraceRecorder::ToJson(node_trace_recorder_->GetSnapshot());
+  return Status::OK();
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 std::vector<TuningResults> InferenceSession::GetTuningResults() const {
   std::vector<TuningResults> ret;
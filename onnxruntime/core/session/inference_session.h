@@ -28,7 +28,9 @@
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/platform/env.h"
 #include "core/platform/ort_mutex.h"
+#include "core/session/dynamic_batcher.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
 #endif
@@ -50,8 +52,12 @@ class CustomRegistry;
 class Environment;
 class GraphTransformer;
 class IExecutionProvider;
+class IntraOpParallelismTuner;
 class IOBinding;
 struct Notification;
+namespace profiling {
+class NodeTraceRecorder;
+}  // namespace profiling
 
 #ifdef ENABLE_TRAINING
 struct PartialGraphExecutionState;
@@ -486,6 +492,20 @@ class InferenceSession {
     */
   const profiling::Profiler& GetProfiling() const;
 
+  /**
+    * Aggregate the kernel runs sampled with kOrtSessionOptionsConfigNodeTraceSampleInterval.
+    * @param stats_json the p50/p99 latency per node and per op type as a JSON object.
+    * @return OK, or an error if node tracing is not enabled for the session.
+    */
+  common::Status GetNodeTraceStats(std::string& stats_json) const;
+
+  /**
+    * Get the counters of the intra-op and inter-op thread pools used by the session, which may be shared with
+    * other sessions if the environment's global thread pools are used.
+    * @return a JSON object with the "intra_op" and "inter_op" pools, null if the session has no such pool.
+    */
+  std::string GetThreadPoolStats() const;
+
 #if !defined(ORT_MINIMAL_BUILD)
   /**
    * Get the TuningResults of TunableOp for every execution providers.
@@ -623,6 +643,16 @@ class InferenceSession {
   }
 
   common::Status SaveToOrtFormat(const std::filesystem::path& filepath) const;
+
+  // Replaces the loaded ONNX model with the optimized ORT format model from the optimized model cache if the cache is
+  // enabled and has an entry for the model and the session configuration. Otherwise cache_file_to_write is set to the
+  // path that the optimized model should be saved to once the graph is transformed, or left empty if the cache is
+  // not enabled.
+  [[nodiscard]] common::Status LoadOptimizedModelFromCache(PathString& cache_file_to_write);
+
+  // Saves the transformed and partitioned model to the optimized model cache.
+  // Failing to do so is logged, the session works without the cache file.
+  void SaveOptimizedModelToCache(const PathString& cache_file) const;
 #endif
 
   /**
@@ -644,6 +674,12 @@ class InferenceSession {
 
   [[nodiscard]] common::Status LoadOrtModelWithLoader(std::function<Status()> load_ort_format_model_bytes);
 
+  // Sets ort_format_model_bytes_ to the content of the ORT format model file, mapping the file if possible.
+  [[nodiscard]] common::Status ReadOrtModelFile(const PathString& model_uri);
+
+  // Creates model_ from ort_format_model_bytes_.
+  [[nodiscard]] common::Status LoadOrtModelFromBytes();
+
   // Create a Logger for a single execution if possible. Otherwise use the default logger.
   // If a new logger is created, it will also be stored in new_run_logger,
   // which must remain valid for the duration of the execution.
@@ -672,6 +708,9 @@ class InferenceSession {
 
   [[nodiscard]] common::Status WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms);
 
+  // Create dynamic_batcher_ if dynamic batching of RunAsync requests is enabled and supported by the model.
+  [[nodiscard]] common::Status InitializeDynamicBatcher();
+
   template <typename T>
   void StartProfiling(const std::basic_string<T>& file_prefix);
 
@@ -705,6 +744,9 @@ class InferenceSession {
 
   onnxruntime::GraphTransformerManager graph_transformer_mgr_;
 
+  // names and levels of the transformers added with RegisterGraphTransformer, part of the optimized model cache key
+  std::vector<std::string> custom_graph_transformers_;
+
   InlinedHashSet<gsl::not_null<const ONNX_NAMESPACE::OpSchema*>> saved_runtime_optimization_produced_node_op_schemas_;
 #endif
   // Any GraphTransformer/RewriteRule name in this set will not be enabled.
@@ -731,6 +773,18 @@ class InferenceSession {
   MemoryProfiler memory_profiler_;
 #endif
 
+  // Cache file of pre-packed weights. Declared before session_state_ as the kernels use its buffers.
+  std::unique_ptr<PrepackedWeightsFileCache> prepacked_weights_file_cache_;
+
+  // Tuner of the intra-op parallelism of the CPU kernels. Declared before session_state_ as the session state uses it.
+  std::unique_ptr<IntraOpParallelismTuner> intra_op_parallelism_tuner_;
+
+  // Recorder of the sampled kernel runs. Declared before session_state_ as the session state uses it.
+  std::unique_ptr<profiling::NodeTraceRecorder> node_trace_recorder_;
+
+  // Memory mapped ORT format model file. Declared before session_state_ as the initializers use its bytes.
+  Env::MappedMemoryPtr ort_format_model_mapped_file_;
+
   // Immutable state for each op in the model. Shared by all executors.
   // It has a dependency on execution_providers_.
   std::unique_ptr<SessionState> session_state_;
@@ -746,6 +800,14 @@ class InferenceSession {
   // Spinning is restarted on the next Run()
   bool force_spinning_stop_between_runs_ = false;
 
+  // Priority of the intra-op work of the runs, and number of intra-op threads including the calling thread that a
+  // run may use (0 for all). Set from kOrtSessionOptionsConfigIntraOpPriority and
+  // kOrtSessionOptionsConfigIntraOpThreadShare, and overridden by the run options.
+  concurrency::ThreadPool::Priority intra_op_priority_ = concurrency::ThreadPool::Priority::kNormal;
+  int intra_op_thread_limit_ = 0;
+  // Number of threads of the intra-op pool including the calling thread, that the thread shares apply to.
+  int intra_op_pool_threads_ = 1;
+
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
@@ -897,6 +959,10 @@ class InferenceSession {
   };
 
   CachedExecutionProviderForGraphReplay cached_execution_provider_for_graph_replay_;
+
+  // Coalesces RunAsync requests along the batch dimension.
+  // Created during Initialize if enabled via kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize.
+  std::unique_ptr<DynamicBatcher> dynamic_batcher_;
 };
 
 struct SessionIOBinding {
@@ -0,0 +1,177 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include "core/session/optimized_model_cache.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+#include "core/framework/content_hasher.h"
+#include "core/framework/customregistry.h"
+#include "core/framework/execution_providers.h"
+#include "core/framework/session_options.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
+namespace onnxruntime {
+namespace optimized_model_cache {
+
+namespace {
+
+template <typename NodeArgs>
+void HashNodeArgs(const NodeArgs& defs, bool include_types, ContentHasher& hasher) {
+  hasher.UpdateValue(defs.size());
+  for (const NodeArg* def : defs) {
+    hasher.Update(def->Exists() ? def->Name() : std::string());
+    if (include_types) {
+      const auto* type = def->TypeAsProto();
+      hasher.Update(type != nullptr ? type->SerializeAsString() : std::string());
+    }
+  }
+}
+
+void HashInitializer(const Graph& graph, const ONNX_NAMESPACE::TensorProto& initializer, ContentHasher& hasher) {
+  hasher.Update(initializer.name());
+  hasher.UpdateValue(initializer.data_type());
+  for (int64_t dim : initializer.dims()) {
+    hasher.UpdateValue(dim);
+  }
+
+  if (utils::HasExternalData(initializer)) {
+    for (const auto& entry : initializer.external_data()) {
+      hasher.Update(entry.key());
+      hasher.Update(entry.value());
+      if (entry.key() == "location") {
+        // Reading the external data would cost about as much as loading it, so a change of the file is detected by
+        // its size and modification time. Both are zero if the file can't be found.
+        std::error_code error;
+        const auto path = graph.ModelPath().parent_path() / std::filesystem::path(ToPathString(entry.value()));
+        const auto size = std::filesystem::file_size(path, error);
+        hasher.UpdateValue(error ? uint64_t{0} : static_cast<uint64_t>(size));
+        const auto write_time = std::filesystem::last_write_time(path, error);
+        hasher.UpdateValue(error ? int64_t{0} : static_cast<int64_t>(write_time.time_since_epoch().count()));
+      }
+    }
+  } else if (utils::HasRawData(initializer)) {
+    hasher.Update(initializer.raw_data().data(), initializer.raw_data().size());
+  } else {
+    hasher.Update(initializer.SerializeAsString());
+  }
+}
+
+void HashGraph(const Graph& graph, ContentHasher& hasher) {
+  HashNodeArgs(graph.GetInputsIncludingInitializers(), true, hasher);
+  HashNodeArgs(graph.GetOutputs(), true, hasher);
+
+  std::vector<const ONNX_NAMESPACE::TensorProto*> initializers;
+  for (const auto& [name, initializer] : graph.GetAllInitializedTensors()) {
+    initializers.push_back(initializer);
+  }
+  std::sort(initializers.begin(), initializers.end(),
+            [](const auto* a, const auto* b) { return a->name() < b->name(); });
+  for (const auto* initializer : initializers) {
+    HashInitializer(graph, *initializer, hasher);
+  }
+
+  for (const auto& node : graph.Nodes()) {
+    hasher.Update(node.Domain());
+    hasher.Update(node.OpType());
+    hasher.Update(node.Name());
+    hasher.UpdateValue(node.SinceVersion());
+    HashNodeArgs(node.InputDefs(), false, hasher);
+    HashNodeArgs(node.OutputDefs(), false, hasher);
+    HashNodeAttributes(node, hasher);
+    for (const auto& subgraph : node.GetSubgraphs()) {
+      HashGraph(*subgraph, hasher);
+    }
+  }
+}
+
+template <typename Map>
+void HashSorted(const Map& map, ContentHasher& hasher) {
+  const std::map<typename Map::key_type, typename Map::mapped_type> sorted(map.begin(), map.end());
+  hasher.UpdateValue(sorted.size());
+  for (const auto& [key, value] : sorted) {
+    hasher.Update(key);
+    if constexpr (std::is_same_v<typename Map::mapped_type, std::string>) {
+      hasher.Update(value);
+    } else {
+      hasher.UpdateValue(value);
+    }
+  }
+}
+
+}  // namespace
+
+PathString GetCacheFilePath(const PathString& cache_dir,
+                            const Graph& graph,
+                            const ExecutionProviders& execution_providers,
+                            const SessionOptions& session_options,
+                            const InlinedHashSet<std::string>& optimizers_to_disable,
+                            const std::vector<std::string>& custom_graph_transformers,
+                            const std::vector<std::shared_ptr<CustomRegistry>>& custom_registries) {
+  ContentHasher hasher;
+  HashGraph(graph, hasher);
+  HashSorted(graph.DomainToVersionMap(), hasher);
+
+  for (const auto& execution_provider : execution_providers) {
+    hasher.Update(execution_provider->Type());
+    HashSorted(execution_provider->GetProviderOptions(), hasher);
+  }
+
+  hasher.UpdateValue(static_cast<int>(session_options.graph_optimization_level));
+  hasher.UpdateValue(session_options.max_num_graph_transformation_steps);
+  for (const auto& free_dimension_override : session_options.free_dimension_overrides) {
+    hasher.Update(free_dimension_override.dim_identifier);
+    hasher.UpdateValue(free_dimension_override.dim_identifier_type);
+    hasher.UpdateValue(free_dimension_override.dim_value);
+  }
+
+  // the location of the cache doesn't change the optimized model
+  auto config_entries = session_options.config_options.configurations;
+  config_entries.erase(kOrtSessionOptionsConfigOptimizedModelCacheDir);
+  HashSorted(config_entries, hasher);
+
+  std::vector<std::string> disabled_optimizers(optimizers_to_disable.begin(), optimizers_to_disable.end());
+  std::sort(disabled_optimizers.begin(), disabled_optimizers.end());
+  for (const auto& optimizer : disabled_optimizers) {
+    hasher.Update(optimizer);
+  }
+
+  hasher.UpdateValue(custom_graph_transformers.size());
+  for (const auto& transformer : custom_graph_transformers) {
+    hasher.Update(transformer);
+  }
+
+  // the kernels of custom registries decide which nodes they take, so they change the partitioning
+  hasher.UpdateValue(custom_registries.size());
+  for (const auto& custom_registry : custom_registries) {
+    const auto& kernel_create_map = custom_registry->GetKernelRegistry()->GetKernelCreateMap();
+    hasher.UpdateValue(kernel_create_map.size());
+    for (const auto& [key, kernel_create_info] : kernel_create_map) {
+      hasher.Update(key);
+      const auto since_version = kernel_create_info.kernel_def->SinceVersion();
+      hasher.UpdateValue(since_version.first);
+      hasher.UpdateValue(since_version.second);
+    }
+  }
+
+  hasher.UpdateValue(GetCpuEnvironmentHash());
+
+  std::ostringstream file_name;
+  file_name << std::hex << std::setw(16) << std::setfill('0') << hasher.Value() << ".ort";
+  return (std::filesystem::path(cache_dir) / std::filesystem::path(ToPathString(file_name.str()))).native();
+}
+
+}  // namespace optimized_model_cache
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/inlined_containers.h"
+#include "core/common/path_string.h"
+
+namespace onnxruntime {
+
+class CustomRegistry;
+class ExecutionProviders;
+class Graph;
+struct SessionOptions;
+
+namespace optimized_model_cache {
+
+// Gets the path of the file in cache_dir that stores the optimized and partitioned ORT format model that
+// initializing a session with the given graph, execution providers and options produces.
+// The file name is a hash of the graph including the initializer data, the type and options of the execution
+// providers, the session options that affect the optimizations, the ONNX Runtime version and the CPU features.
+// The transformers registered by the application are identified by their name and level, and the kernels of custom
+// registries by their op, domain, provider and opset versions.
+// The data of external initializers is not hashed; the size and modification time of their files are used instead.
+PathString GetCacheFilePath(const PathString& cache_dir,
+                            const Graph& graph,
+                            const ExecutionProviders& execution_providers,
+                            const SessionOptions& session_options,
+                            const InlinedHashSet<std::string>& optimizers_to_disable,
+                            const std::vector<std::string>& custom_graph_transformers,
+                            const std::vector<std::shared_ptr<CustomRegistry>>& custom_registries);
+
+}  // namespace optimized_model_cache
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
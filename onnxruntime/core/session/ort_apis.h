@@ -351,6 +351,12 @@ ORT_API_STATUS_IMPL(AddExternalInitializersFromFilesInMemory, _In_ OrtSessionOpt
                     _In_reads_(num_external_initializer_files) const size_t* file_lengths,
                     size_t num_external_initializer_files);
 
+ORT_API_STATUS_IMPL(SessionGetNodeTraceStats, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+
+ORT_API_STATUS_IMPL(SessionGetThreadPoolStats, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+
 ORT_API_STATUS_IMPL(CreateOpAttr,
                     _In_ const char* name,
                     _In_ const void* data,
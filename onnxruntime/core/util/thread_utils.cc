@@ -24,6 +24,7 @@ std::ostream& operator<<(std::ostream& os, const OrtThreadPoolParams& params) {
   os << " affinity_str: " << params.affinity_str;
   // os << " name: " << (params.name ? params.name : L"nullptr");
   os << " set_denormal_as_zero: " << params.set_denormal_as_zero;
+  os << " numa_aware: " << params.numa_aware;
   // os << " custom_create_thread_fn: " << (params.custom_create_thread_fn ? "set" : "nullptr");
   // os << " custom_thread_creation_options: " << (params.custom_thread_creation_options ? "set" : "nullptr");
   // os << " custom_join_thread_fn: " << (params.custom_join_thread_fn ? "set" : "nullptr");
@@ -145,7 +146,21 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
 #endif
   }
 
+  // NUMA-aware scheduling needs to know where each thread runs, so pin the threads to physical cores
+  // if no affinity was set.
+  if (options.numa_aware && to.affinities.empty()) {
+    auto default_affinities = Env::Default().GetDefaultThreadAffinities();
+    if (default_affinities.size() >= static_cast<size_t>(options.thread_pool_size)) {
+      default_affinities.resize(static_cast<size_t>(options.thread_pool_size));
+      to.affinities = std::move(default_affinities);
+    } else {
+      LOGS_DEFAULT(WARNING) << "Thread pool size " << options.thread_pool_size
+                            << " exceeds the number of physical cores. NUMA-aware scheduling is disabled.";
+    }
+  }
+
   to.set_denormal_as_zero = options.set_denormal_as_zero;
+  to.numa_aware = options.numa_aware;
   // set custom thread management members
   to.custom_create_thread_fn = options.custom_create_thread_fn;
   to.custom_thread_creation_options = options.custom_thread_creation_options;
@@ -42,6 +42,10 @@ struct OrtThreadPoolParams {
   // Set or unset denormal as zero
   bool set_denormal_as_zero = false;
 
+  // If it is true, group the threads by NUMA node for work stealing and the distribution of parallel loops.
+  // Thread affinities are set from the default affinities if neither affinity_str nor auto_set_affinity set them.
+  bool numa_aware = false;
+
   // members to manage custom threads
   OrtCustomCreateThreadFn custom_create_thread_fn = nullptr;
   void* custom_thread_creation_options = nullptr;
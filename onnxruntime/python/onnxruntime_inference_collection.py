@@ -6,6 +6,7 @@ from __future__ import annotations
 
 import collections
 import collections.abc
+import json
 import os
 import typing
 import warnings
@@ -317,6 +318,15 @@ class Session:
         """
         return self._sess.get_profiling_start_time_ns
 
+    def get_thread_pool_stats(self):
+        """
+        Return the counters of the thread pools used by the session as a dictionary with the
+        "intra_op" and "inter_op" pools, None if the session has no such pool.
+        The counters cover the lifetime of each pool, and include the work of other sessions
+        if the pool is shared through the environment.
+        """
+        return json.loads(self._sess.get_thread_pool_stats())
+
     def io_binding(self):
         "Return an onnxruntime.IOBinding object`."
         return IOBinding(self)
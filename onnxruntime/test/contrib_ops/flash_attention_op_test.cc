@@ -0,0 +1,221 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "contrib_ops/cpu/bert/attention_common.h"
+#include "test/common/random_generator.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+#include "test/util/include/scoped_env_vars.h"
+
+namespace onnxruntime {
+namespace test {
+
+#ifndef DISABLE_CONTRIB_OPS
+
+// The CPU kernels of Attention and GroupQueryAttention use MlasFlashAttention for fp32 unless
+// ORT_DISABLE_FLASH_ATTENTION is set. The tests below run each op with the unfused kernel first and check that the
+// flash attention outputs match. The block sizes of MlasFlashAttention are derived from the L2 cache size, e.g. 128
+// keys and queries per block for head size 256 and a 1MB L2 cache, so the sequences are long enough to span several
+// blocks.
+
+using AddFlashAttentionInputs = std::function<void(OpTester&)>;
+using FlashAttentionOutputs = std::vector<std::pair<std::string, std::vector<int64_t>>>;
+
+static void RunFlashAttentionTest(const char* op_type,
+                                  const AddFlashAttentionInputs& add_inputs,
+                                  const FlashAttentionOutputs& outputs) {
+  std::vector<OrtValue> unfused_outputs;
+  {
+    ScopedEnvironmentVariables scoped_env_vars{EnvVarMap{{contrib::attention::kDisableFlashAttention, "1"}}};
+    OpTester tester(op_type, 1, onnxruntime::kMSDomain, /*verify_output*/ false);
+    add_inputs(tester);
+    for (const auto& output : outputs) {
+      const size_t size = static_cast<size_t>(TensorShape(output.second).Size());
+      tester.AddOutput<float>(output.first.c_str(), output.second, std::vector<float>(size));
+    }
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+    unfused_outputs = tester.GetFetches();
+  }
+
+  ASSERT_EQ(unfused_outputs.size(), outputs.size());
+  ScopedEnvironmentVariables scoped_env_vars{EnvVarMap{{contrib::attention::kDisableFlashAttention, "0"}}};
+  OpTester tester(op_type, 1, onnxruntime::kMSDomain);
+  add_inputs(tester);
+  for (size_t i = 0; i < outputs.size(); i++) {
+    const auto values = unfused_outputs[i].Get<Tensor>().DataAsSpan<float>();
+    tester.AddOutput<float>(outputs[i].first.c_str(), outputs[i].second,
+                            std::vector<float>(values.begin(), values.end()));
+  }
+  tester.SetOutputTolerance(2e-4f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+struct GqaFlashTestOptions {
+  int batch_size = 2;
+  int sequence_length = 1;
+  int num_heads = 4;
+  int kv_num_heads = 2;
+  int head_size = 256;
+  std::vector<int32_t> past_lengths;  // number of past tokens of each sequence, empty for a prompt
+  int past_buffer_length = 0;         // dimension 2 of past_key and past_value
+  int local_window_size = -1;
+  bool packed_qkv = false;
+};
+
+static void RunGqaFlashAttentionTest(const GqaFlashTestOptions& options) {
+  const int batch_size = options.batch_size;
+  const int sequence_length = options.sequence_length;
+  const int head_size = options.head_size;
+  const int hidden_size = options.num_heads * head_size;
+  const int kv_hidden_size = options.kv_num_heads * head_size;
+  const bool is_prompt = options.past_lengths.empty();
+
+  std::vector<int32_t> seqlens_k(batch_size);
+  for (int b = 0; b < batch_size; b++) {
+    seqlens_k[b] = (is_prompt ? 0 : options.past_lengths[b]) + sequence_length - 1;
+  }
+  const int total_sequence_length = *std::max_element(seqlens_k.begin(), seqlens_k.end()) + 1;
+  const int present_length = std::max(total_sequence_length, options.past_buffer_length);
+
+  RandomValueGenerator random{};
+  const std::vector<int64_t> query_dims{batch_size, sequence_length,
+                                        options.packed_qkv ? hidden_size + 2 * kv_hidden_size : hidden_size};
+  const std::vector<int64_t> kv_dims{batch_size, sequence_length, kv_hidden_size};
+  const std::vector<int64_t> past_dims{batch_size, options.kv_num_heads, options.past_buffer_length, head_size};
+  const std::vector<float> query = random.Uniform<float>(query_dims, -1.0f, 1.0f);
+  const std::vector<float> key = random.Uniform<float>(kv_dims, -1.0f, 1.0f);
+  const std::vector<float> value = random.Uniform<float>(kv_dims, -1.0f, 1.0f);
+  const std::vector<float> past_key = random.Uniform<float>(past_dims, -1.0f, 1.0f);
+  const std::vector<float> past_value = random.Uniform<float>(past_dims, -1.0f, 1.0f);
+
+  auto add_inputs = [&](OpTester& tester) {
+    tester.AddAttribute<int64_t>("num_heads", options.num_heads);
+    tester.AddAttribute<int64_t>("kv_num_heads", options.kv_num_heads);
+    tester.AddAttribute<int64_t>("local_window_size", options.local_window_size);
+    tester.AddInput<float>("query", query_dims, query);
+    if (options.packed_qkv) {
+      tester.AddOptionalInputEdge<float>();
+      tester.AddOptionalInputEdge<float>();
+    } else {
+      tester.AddInput<float>("key", kv_dims, key);
+      tester.AddInput<float>("value", kv_dims, value);
+    }
+    tester.AddInput<float>("past_key", past_dims, past_key);
+    tester.AddInput<float>("past_value", past_dims, past_value);
+    tester.AddInput<int32_t>("seqlens_k", {batch_size}, seqlens_k);
+    tester.AddInput<int32_t>("total_sequence_length", {1}, {total_sequence_length});
+  };
+
+  const std::vector<int64_t> present_dims{batch_size, options.kv_num_heads, present_length, head_size};
+  RunFlashAttentionTest("GroupQueryAttention", add_inputs,
+                        {{"output", {batch_size, sequence_length, hidden_size}},
+                         {"present_key", present_dims},
+                         {"present_value", present_dims}});
+}
+
+TEST(FlashAttentionTest, GroupQueryAttentionPrompt) {
+  GqaFlashTestOptions options;
+  options.sequence_length = 520;
+  RunGqaFlashAttentionTest(options);
+}
+
+TEST(FlashAttentionTest, GroupQueryAttentionPromptLocalWindow) {
+  GqaFlashTestOptions options;
+  options.sequence_length = 520;
+  options.local_window_size = 200;
+  RunGqaFlashAttentionTest(options);
+}
+
+TEST(FlashAttentionTest, GroupQueryAttentionPromptPackedQKV) {
+  // The queries, keys and values of a batch are strided by the packed hidden size.
+  GqaFlashTestOptions options;
+  options.sequence_length = 520;
+  options.kv_num_heads = 1;
+  options.packed_qkv = true;
+  RunGqaFlashAttentionTest(options);
+}
+
+TEST(FlashAttentionTest, GroupQueryAttentionTokenGeneration) {
+  // Each sequence has its own number of keys, and the present buffer is longer than any of them.
+  GqaFlashTestOptions options;
+  options.batch_size = 3;
+  options.past_lengths = {600, 277, 1};
+  options.past_buffer_length = 640;
+  RunGqaFlashAttentionTest(options);
+}
+
+TEST(FlashAttentionTest, GroupQueryAttentionTokenGenerationLocalWindow) {
+  GqaFlashTestOptions options;
+  options.batch_size = 3;
+  options.past_lengths = {600, 277, 1};
+  options.past_buffer_length = 640;
+  options.local_window_size = 150;
+  RunGqaFlashAttentionTest(options);
+}
+
+static void RunAttentionFlashAttentionTest(int sequence_length, int past_sequence_length, bool is_unidirectional) {
+  constexpr int batch_size = 2;
+  constexpr int num_heads = 2;
+  constexpr int head_size = 256;
+  constexpr int hidden_size = num_heads * head_size;
+  const int total_sequence_length = past_sequence_length + sequence_length;
+
+  RandomValueGenerator random{};
+  const std::vector<int64_t> input_dims{batch_size, sequence_length, hidden_size};
+  const std::vector<int64_t> weights_dims{hidden_size, 3 * hidden_size};
+  const std::vector<int64_t> bias_dims{3 * hidden_size};
+  const std::vector<int64_t> past_dims{2, batch_size, num_heads, past_sequence_length, head_size};
+  const std::vector<float> input = random.Uniform<float>(input_dims, -1.0f, 1.0f);
+  const std::vector<float> weights = random.Uniform<float>(weights_dims, -0.1f, 0.1f);
+  const std::vector<float> bias = random.Uniform<float>(bias_dims, -0.1f, 0.1f);
+  const std::vector<float> past = random.Uniform<float>(past_dims, -1.0f, 1.0f);
+  const bool use_past = past_sequence_length > 0;
+
+  auto add_inputs = [&](OpTester& tester) {
+    tester.AddAttribute<int64_t>("num_heads", num_heads);
+    tester.AddAttribute<int64_t>("unidirectional", is_unidirectional ? 1 : 0);
+    tester.AddInput<float>("input", input_dims, input);
+    tester.AddInput<float>("weights", weights_dims, weights);
+    tester.AddInput<float>("bias", bias_dims, bias);
+    if (use_past) {
+      tester.AddOptionalInputEdge<int32_t>();
+      tester.AddInput<float>("past", past_dims, past);
+    }
+  };
+
+  FlashAttentionOutputs outputs{{"output", input_dims}};
+  if (use_past) {
+    outputs.push_back({"present", {2, batch_size, num_heads, total_sequence_length, head_size}});
+  }
+  RunFlashAttentionTest("Attention", add_inputs, outputs);
+}
+
+TEST(FlashAttentionTest, Attention) {
+  RunAttentionFlashAttentionTest(/*sequence_length*/ 520, /*past_sequence_length*/ 0, /*is_unidirectional*/ false);
+}
+
+TEST(FlashAttentionTest, AttentionCausal) {
+  RunAttentionFlashAttentionTest(/*sequence_length*/ 520, /*past_sequence_length*/ 0, /*is_unidirectional*/ true);
+}
+
+TEST(FlashAttentionTest, AttentionCausalWithPast) {
+  // The causal mask is aligned to the last key, i.e. query i attends to the past and the first i + 1 new keys.
+  RunAttentionFlashAttentionTest(/*sequence_length*/ 300, /*past_sequence_length*/ 260, /*is_unidirectional*/ true);
+}
+
+#endif  // DISABLE_CONTRIB_OPS
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "core/common/span_utils.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Tanh(X * scale + bias) * X with a per-channel scale and a scalar bias.
+TEST(FusedElementwiseTest, BroadcastChain) {
+  constexpr int64_t rows = 3;
+  constexpr int64_t cols = 700;
+
+  RandomValueGenerator random{};
+  const std::vector<float> x = random.Uniform<float>(AsSpan({rows, cols}), -2.0f, 2.0f);
+  const std::vector<float> scale = random.Uniform<float>(AsSpan({cols}), -1.0f, 1.0f);
+  const float bias = 0.25f;
+
+  std::vector<float> y(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    y[i] = std::tanh(x[i] * scale[i % cols] + bias) * x[i];
+  }
+
+  OpTester test("FusedElementwise", 1, kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Mul", "Add", "Tanh", "Mul"});
+  // inputs are 0..2, the results of the ops are 3..6.
+  test.AddAttribute<std::vector<int64_t>>("operands", {0, 1, 3, 2, 4, -1, 5, 0});
+  test.AddInput<float>("X", {rows, cols}, x);
+  test.AddInput<float>("scale", {1, cols}, scale);
+  test.AddInput<float>("bias", {}, {bias});
+  test.AddOutput<float>("Y", {rows, cols}, y);
+  test.SetOutputAbsErr("Y", 1e-5f);
+  test.Run();
+}
+
+// The second input is the larger one, and an intermediate result is read by several ops.
+TEST(FusedElementwiseTest, SharedIntermediate) {
+  OpTester test("FusedElementwise", 1, kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Sub", "Mul", "Relu", "Max"});
+  test.AddAttribute<std::vector<int64_t>>("operands", {1, 0, 2, 2, 2, -1, 3, 4});
+  test.AddInput<float>("A", {2}, {1.0f, -1.0f});
+  test.AddInput<float>("B", {2, 2}, {3.0f, 0.0f, -1.0f, 2.0f});
+  // d = B - A = {2, 1, -2, 3}, d * d = {4, 1, 4, 9}, Relu(d) = {2, 1, 0, 3}, Max(d * d, Relu(d)) = d * d
+  test.AddOutput<float>("Y", {2, 2}, {4.0f, 1.0f, 4.0f, 9.0f});
+  test.Run();
+}
+
+// Relu(X * scale + bias) with a per-channel scale and bias of an NCHW tensor, which broadcast along the leading and
+// the trailing dims. The blocks of the kernel cover several channels and end inside a channel.
+TEST(FusedElementwiseTest, PerChannelBroadcast) {
+  constexpr int64_t N = 2;
+  constexpr int64_t C = 5;
+  constexpr int64_t H = 13;
+  constexpr int64_t W = 31;
+
+  RandomValueGenerator random{};
+  const std::vector<float> x = random.Uniform<float>(AsSpan({N, C, H, W}), -2.0f, 2.0f);
+  const std::vector<float> scale = random.Uniform<float>(AsSpan({C, int64_t{1}, int64_t{1}}), -1.0f, 1.0f);
+  const std::vector<float> bias = random.Uniform<float>(AsSpan({N, int64_t{1}, int64_t{1}, W}), -1.0f, 1.0f);
+
+  std::vector<float> y(x.size());
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t c = 0; c < C; ++c) {
+      for (int64_t hw = 0; hw < H * W; ++hw) {
+        const int64_t i = (n * C + c) * H * W + hw;
+        y[i] = std::max(x[i] * scale[c] + bias[n * W + hw % W], 0.0f);
+      }
+    }
+  }
+
+  OpTester test("FusedElementwise", 1, kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Mul", "Add", "Relu"});
+  test.AddAttribute<std::vector<int64_t>>("operands", {0, 1, 3, 2, 4, -1});
+  test.AddInput<float>("X", {N, C, H, W}, x);
+  test.AddInput<float>("scale", {C, 1, 1}, scale);
+  test.AddInput<float>("bias", {N, 1, 1, W}, bias);
+  test.AddOutput<float>("Y", {N, C, H, W}, y);
+  test.SetOutputAbsErr("Y", 1e-5f);
+  test.Run();
+}
+
+TEST(FusedElementwiseTest, InvalidBroadcast) {
+  OpTester test("FusedElementwise", 1, kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Add", "Neg"});
+  test.AddAttribute<std::vector<int64_t>>("operands", {0, 1, 2, -1});
+  test.AddInput<float>("A", {2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+  test.AddInput<float>("B", {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test.AddOutput<float>("Y", {2, 3}, {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "does not broadcast to the output shape");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -1,10 +1,15 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+
 #include "gtest/gtest.h"
+#include "core/common/span_utils.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
 #include "test/common/dnnl_op_test_utils.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/util/include/default_providers.h"
 
 namespace onnxruntime {
 namespace test {
@@ -271,6 +276,70 @@ TEST(FusedMatMulOpTest, FloatTypeTransposeBatch) {
   RunFusedMatMulTest<float>("FusedMatMul", 1, true, true, true, true);
 }
 
+// Y = Relu(alpha * A * B + bias) + residual
+TEST(FusedMatMulOpTest, ActivationBiasResidual) {
+  OpTester test("FusedMatMulActivation", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("alpha", 0.5f);
+  test.AddAttribute("activation", "Relu");
+  test.AddInput<float>("A", {2, 3}, {1.0f, 2.0f, 3.0f, -1.0f, 0.0f, 2.0f});
+  test.AddInput<float>("B", {3, 4}, {1.0f, 0.0f, -1.0f, 2.0f, 0.0f, 1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 0.0f, 1.0f});
+  test.AddInput<float>("bias", {4}, {-1.0f, 0.25f, 0.0f, -2.0f});
+  test.AddInput<float>("residual", {2, 4}, {1.0f, 1.0f, 1.0f, 1.0f, 0.0f, -1.0f, 2.0f, 0.5f});
+  // alpha * A * B + bias = {1, -0.25, 0.5, -0.5, -0.5, -0.75, 0.5, -2}
+  test.AddOutput<float>("Y", {2, 4}, {2.0f, 1.0f, 1.5f, 1.0f, 0.0f, -1.0f, 2.5f, 0.5f});
+  test.ConfigEp(DefaultCpuExecutionProvider()).RunWithConfig();
+}
+
+// Clip takes its bounds from activation_alpha and activation_beta.
+TEST(FusedMatMulOpTest, ClipBias) {
+  OpTester test("FusedMatMulActivation", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("activation", "Clip");
+  test.AddAttribute("activation_alpha", -0.5f);
+  test.AddAttribute("activation_beta", 1.0f);
+  test.AddInput<float>("A", {2, 3}, {1.0f, 2.0f, 3.0f, -1.0f, 0.0f, 2.0f});
+  test.AddInput<float>("B", {3, 4}, {1.0f, 0.0f, -1.0f, 2.0f, 0.0f, 1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 0.0f, 1.0f});
+  test.AddInput<float>("bias", {4}, {-1.0f, 0.25f, 0.0f, -2.0f});
+  // A * B + bias = {3, -0.75, 1, 1, 0, -1.75, 1, -2}
+  test.AddOutput<float>("Y", {2, 4}, {1.0f, -0.5f, 1.0f, 1.0f, 0.0f, -0.5f, 1.0f, -0.5f});
+  test.ConfigEp(DefaultCpuExecutionProvider()).RunWithConfig();
+}
+
+// A batched product whose output columns span several of the slices that the epilogue is applied to.
+TEST(FusedMatMulOpTest, GeluResidualBatched) {
+  constexpr int64_t batch = 2;
+  constexpr int64_t M = 3;
+  constexpr int64_t K = 17;
+  constexpr int64_t N = 300;
+
+  RandomValueGenerator random{};
+  const std::vector<float> a = random.Uniform<float>(AsSpan({batch, M, K}), -1.0f, 1.0f);
+  const std::vector<float> b = random.Uniform<float>(AsSpan({K, N}), -1.0f, 1.0f);
+  const std::vector<float> residual = random.Uniform<float>(AsSpan({batch, M, N}), -1.0f, 1.0f);
+
+  std::vector<float> y(residual.size());
+  for (int64_t m = 0; m < batch * M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; ++k) {
+        sum += a[m * K + k] * b[k * N + n];
+      }
+      y[m * N + n] = 0.5f * sum * (1.0f + std::erf(sum * 0.70710678f)) + residual[m * N + n];
+    }
+  }
+
+  for (bool is_b_constant : {false, true}) {
+    OpTester test("FusedMatMulActivation", 1, onnxruntime::kMSDomain);
+    test.AddAttribute("activation", "Gelu");
+    test.AddInput<float>("A", {batch, M, K}, a);
+    test.AddInput<float>("B", {K, N}, b, is_b_constant);
+    test.AddOptionalInputEdge<float>();
+    test.AddInput<float>("residual", {batch, M, N}, residual);
+    test.AddOutput<float>("Y", {batch, M, N}, y);
+    test.SetOutputAbsErr("Y", 1e-4f);
+    test.ConfigEp(DefaultCpuExecutionProvider()).RunWithConfig();
+  }
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DML)
 TEST(FusedMatMulOpTest, Float16_NoTranspose) {
 #ifdef USE_CUDA
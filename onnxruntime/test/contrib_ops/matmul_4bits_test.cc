@@ -3,7 +3,9 @@
 
 #ifndef ORT_MINIMAL_BUILD
 
+#include <algorithm>
 #include <optional>
+#include <random>
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -320,6 +322,139 @@ TEST(MatMulNBits, Float32) {
   }
 }
 
+namespace {
+
+// Test 2, 3 and 8 bit weights, which the CPU EP dequantizes itself. The weights are generated in their quantized
+// form and packed as little-endian bit streams like MatMulNBits expects. B stays quantized, so it is never prepacked.
+void RunNBitsTest(int64_t nbits, int64_t M, int64_t N, int64_t K, int64_t block_size,
+                  bool has_zero_point, bool zp_is_packed, bool has_g_idx = false, bool is_b_constant = true,
+                  bool has_bias = false) {
+  SCOPED_TRACE(::testing::Message() << "nbits:" << nbits << ", M:" << M << ", N:" << N << ", K:" << K
+                                    << ", block_size:" << block_size << ", has_zero_point:" << has_zero_point
+                                    << ", zp_is_packed:" << zp_is_packed << ", has_g_idx:" << has_g_idx
+                                    << ", is_b_constant:" << is_b_constant << ", has_bias:" << has_bias);
+
+  const int64_t blocks_per_col = (K + block_size - 1) / block_size;
+  const int64_t blob_size = (block_size * nbits + 7) / 8;
+  const int64_t zp_bytes_per_col = (blocks_per_col * nbits + 7) / 8;
+  const int max_q = (1 << nbits) - 1;
+
+  auto pack = [nbits](std::vector<uint8_t>& dst, int64_t bit_offset, int value) {
+    for (int64_t b = 0; b < nbits; ++b, ++bit_offset) {
+      if ((value >> b) & 1) {
+        dst[static_cast<size_t>(bit_offset / 8)] |= static_cast<uint8_t>(1 << (bit_offset % 8));
+      }
+    }
+  };
+
+  RandomValueGenerator random{1234};
+  std::vector<float> input0_vals(random.Gaussian<float>(AsSpan({M, K}), 0.0f, 0.25f));
+  std::vector<int> q_vals(random.Uniform<int>(AsSpan({N, K}), 0, max_q + 1));
+  std::vector<int> zp_vals(random.Uniform<int>(AsSpan({N, blocks_per_col}), 0, max_q + 1));
+  std::vector<float> scales(random.Uniform<float>(AsSpan({N, blocks_per_col}), 0.01f, 0.1f));
+  std::vector<float> bias(random.Uniform<float>(AsSpan({N}), -1.0f, 1.0f));
+
+  // g_idx assigns each row of B to the block whose scale and zero point it uses, like act-order quantization.
+  std::vector<int32_t> g_idx(static_cast<size_t>(K));
+  for (int64_t k = 0; k < K; ++k) {
+    g_idx[k] = static_cast<int32_t>(k / block_size);
+  }
+  if (has_g_idx) {
+    std::shuffle(g_idx.begin(), g_idx.end(), std::default_random_engine{static_cast<unsigned>(K)});
+  }
+
+  std::vector<uint8_t> input1_vals(static_cast<size_t>(N * blocks_per_col * blob_size), 0);
+  std::vector<uint8_t> zp_packed(static_cast<size_t>(N * zp_bytes_per_col), 0);
+  std::vector<float> zp_f(static_cast<size_t>(N * blocks_per_col));
+  std::vector<float> input1_f_vals(static_cast<size_t>(N * K));
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t kb = 0; kb < blocks_per_col; ++kb) {
+      const int zp = has_zero_point ? zp_vals[n * blocks_per_col + kb] : (1 << (nbits - 1));
+      pack(zp_packed, n * zp_bytes_per_col * 8 + kb * nbits, zp);
+      zp_f[n * blocks_per_col + kb] = static_cast<float>(zp);
+    }
+    for (int64_t k = 0; k < K; ++k) {
+      const int64_t kb = k / block_size;
+      const int64_t rid = g_idx[k];
+      const int q = q_vals[n * K + k];
+      pack(input1_vals, ((n * blocks_per_col + kb) * blob_size) * 8 + (k % block_size) * nbits, q);
+      input1_f_vals[n * K + k] = (q - zp_f[n * blocks_per_col + rid]) * scales[n * blocks_per_col + rid];
+    }
+  }
+
+  std::vector<float> expected_vals(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += input0_vals[m * K + k] * input1_f_vals[n * K + k];
+      }
+      expected_vals[m * N + n] = sum + (has_bias ? bias[n] : 0.0f);
+    }
+  }
+
+  OpTester test("MatMulNBits", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", K);
+  test.AddAttribute<int64_t>("N", N);
+  test.AddAttribute<int64_t>("block_size", block_size);
+  test.AddAttribute<int64_t>("bits", nbits);
+  test.AddAttribute<int64_t>("accuracy_level", int64_t{4});
+  test.AddInput<float>("A", {M, K}, input0_vals, false);
+  test.AddInput<uint8_t>("B", {N, blocks_per_col, blob_size}, input1_vals, is_b_constant);
+  test.AddInput<float>("scales", {N * blocks_per_col}, scales, true);
+  if (!has_zero_point) {
+    test.AddOptionalInputEdge<uint8_t>();
+  } else if (zp_is_packed) {
+    test.AddInput<uint8_t>("zero_points", {N * zp_bytes_per_col}, zp_packed, true);
+  } else {
+    test.AddInput<float>("zero_points", {N * blocks_per_col}, zp_f, true);
+  }
+  if (has_g_idx) {
+    test.AddInput<int32_t>("g_idx", {K}, g_idx, true);
+  } else if (has_bias) {
+    test.AddOptionalInputEdge<int32_t>();
+  }
+  if (has_bias) {
+    test.AddInput<float>("bias", {N}, bias, true);
+  }
+  test.AddOutput<float>("Y", {M, N}, expected_vals);
+  // the kernel accumulates in a different order
+  test.SetOutputRelErr("Y", 1e-4f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.emplace_back(DefaultCpuExecutionProvider());
+  test.ConfigEps(std::move(execution_providers));
+  size_t number_of_pre_packed_weights = 0;
+  test.RunWithConfig(&number_of_pre_packed_weights);
+  // the quantized B must not be replaced by a float copy
+  EXPECT_EQ(number_of_pre_packed_weights, 0u);
+}
+
+}  // namespace
+
+TEST(MatMulNBits, Float32NBits) {
+  for (auto nbits : {2, 3, 8}) {
+    for (auto M : {1, 5}) {
+      // the kernel dequantizes B in tiles of 32 columns
+      for (auto N : {1, 32, 33, 70}) {
+        for (auto K : {16, 93, 256}) {
+          for (auto block_size : {16, 32, 128}) {
+            RunNBitsTest(nbits, M, N, K, block_size, false, false);
+            RunNBitsTest(nbits, M, N, K, block_size, true, true);
+            RunNBitsTest(nbits, M, N, K, block_size, true, false);
+            RunNBitsTest(nbits, M, N, K, block_size, true, true, true);
+            RunNBitsTest(nbits, M, N, K, block_size, true, false, true);
+            RunNBitsTest(nbits, M, N, K, block_size, true, true, false, false);
+            RunNBitsTest(nbits, M, N, K, block_size, true, true, true, false);
+            RunNBitsTest(nbits, M, N, K, block_size, true, true, false, true, true);
+            RunNBitsTest(nbits, M, N, K, block_size, true, false, true, true, true);
+          }
+        }
+      }
+    }
+  }
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DML)
 
 namespace {
@@ -488,7 +623,7 @@ void RunSharedPrepackedWeightsTest(int64_t M, int64_t N, int64_t K, int block_si
       for (int64_t k = 0; k < K; k++) {
         sum += input0_vals[m * K + k] * input1_f_vals[k * N + n];
       }
-      expected_vals[m * N + n] = sum;
+      expected_vals[m * N + n] = sum + (has_bias ? bias[n] : 0.0f);
     }
   }
 
@@ -0,0 +1,577 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "contrib_ops/cpu/transformers/paged_kv_cache.h"
+#include "core/framework/tensor.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/session/onnxruntime_cxx_api.h"
+#include "test/common/random_generator.h"
+#include "test/framework/test_utils.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+
+extern std::unique_ptr<Ort::Env> ort_env;
+
+namespace onnxruntime {
+namespace test {
+
+using contrib::transformers::PagedKVCache;
+using contrib::transformers::UpdatePagedKVCacheFeeds;
+
+TEST(PagedKVCacheTest, AllocatesBlocksAsTokensAreWritten) {
+  PagedKVCache cache(/*num_sequences*/ 2, /*max_sequence_length*/ 10, /*block_size*/ 4);
+  EXPECT_EQ(cache.MaxBlocksPerSequence(), 3);
+  EXPECT_EQ(cache.NumBlocks(), 0);
+
+  // prompt of 5 tokens needs 2 blocks per sequence
+  std::vector<std::pair<int32_t, int32_t>> copies;
+  ASSERT_TRUE(cache.PrepareWrite(0, 5, copies).IsOK());
+  EXPECT_TRUE(copies.empty());
+  EXPECT_EQ(cache.NumUsedBlocks(), 4);
+
+  auto table = cache.BlockTable();
+  ASSERT_EQ(table.size(), 6u);
+  EXPECT_EQ(table[2], -1);
+  EXPECT_EQ(table[5], -1);
+
+  // tokens 5 to 7 fit in the second block
+  ASSERT_TRUE(cache.PrepareWrite(5, 6, copies).IsOK());
+  ASSERT_TRUE(cache.PrepareWrite(7, 8, copies).IsOK());
+  EXPECT_EQ(cache.NumUsedBlocks(), 4);
+
+  ASSERT_TRUE(cache.PrepareWrite(8, 9, copies).IsOK());
+  EXPECT_EQ(cache.NumUsedBlocks(), 6);
+  EXPECT_TRUE(copies.empty());
+
+  EXPECT_FALSE(cache.PrepareWrite(12, 13, copies).IsOK());
+}
+
+TEST(PagedKVCacheTest, ReorderSharesBlocksCopyOnWrite) {
+  PagedKVCache cache(/*num_sequences*/ 3, /*max_sequence_length*/ 16, /*block_size*/ 4);
+  std::vector<std::pair<int32_t, int32_t>> copies;
+  ASSERT_TRUE(cache.PrepareWrite(0, 6, copies).IsOK());
+  EXPECT_EQ(cache.NumUsedBlocks(), 6);
+  std::vector<int32_t> old_table(cache.BlockTable().begin(), cache.BlockTable().end());
+
+  // all beams continue from beam 0, e.g. after the first step of beam search
+  const std::vector<int32_t> indices{0, 0, 0};
+  cache.Reorder(indices);
+  EXPECT_EQ(cache.NumUsedBlocks(), 2);
+  auto table = cache.BlockTable();
+  for (int sequence = 0; sequence < 3; sequence++) {
+    EXPECT_EQ(table[sequence * 4], old_table[0]);
+    EXPECT_EQ(table[sequence * 4 + 1], old_table[1]);
+  }
+
+  // token 6 is written to the shared second block, so beams 1 and 2 get a copy of it
+  ASSERT_TRUE(cache.PrepareWrite(6, 7, copies).IsOK());
+  EXPECT_EQ(cache.NumUsedBlocks(), 4);
+  ASSERT_EQ(copies.size(), 2u);
+  table = cache.BlockTable();
+  for (const auto& copy : copies) {
+    EXPECT_EQ(copy.first, old_table[1]);
+  }
+  EXPECT_EQ(table[0], table[4]);
+  EXPECT_NE(table[1], table[5]);
+  EXPECT_NE(table[5], table[9]);
+
+  // the first block stays shared until no sequence refers to it
+  copies.clear();
+  const std::vector<int32_t> indices2{1, 1, 2};
+  cache.Reorder(indices2);
+  EXPECT_EQ(cache.NumUsedBlocks(), 3);
+  ASSERT_TRUE(cache.PrepareWrite(7, 8, copies).IsOK());
+  EXPECT_EQ(copies.size(), 1u);
+  EXPECT_EQ(cache.NumUsedBlocks(), 4);
+}
+
+TEST(PagedKVCacheTest, UpdateFeedsGrowsPoolsAndCopiesBlocks) {
+  auto alloc = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  constexpr int num_sequences = 2;
+  constexpr int block_size = 2;
+  constexpr int head_size = 1;
+
+  // feeds: past_key_0, past_value_0, block_table. fetches: logits, present_key_0, present_value_0
+  std::vector<OrtValue> feeds(3);
+  std::vector<OrtValue> fetches(3);
+  for (int i = 0; i < 2; i++) {
+    Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({0, 1, block_size, head_size}), alloc, feeds[i]);
+  }
+  Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(), TensorShape({num_sequences, 4}), alloc, feeds[2]);
+
+  PagedKVCache cache(num_sequences, /*max_sequence_length*/ 8, block_size);
+  ASSERT_TRUE(UpdatePagedKVCacheFeeds<float>(cache, 0, 2, alloc, 0, 1, 2, 2, feeds, fetches).IsOK());
+  for (int i = 0; i < 2; i++) {
+    const auto& pool = feeds[i].Get<Tensor>();
+    EXPECT_EQ(pool.Shape(), TensorShape({cache.NumBlocks(), 1, block_size, head_size}));
+    EXPECT_EQ(fetches[1 + i].Get<Tensor>().Data<float>(), pool.Data<float>());
+  }
+
+  // write the tokens of sequence 0 and let sequence 1 continue from it
+  const auto table = cache.BlockTable();
+  const int64_t num_blocks = cache.NumBlocks();
+  feeds[0].GetMutable<Tensor>()->MutableData<float>()[table[0] * block_size] = 1.0f;
+  feeds[1].GetMutable<Tensor>()->MutableData<float>()[table[0] * block_size] = 2.0f;
+  const std::vector<int32_t> indices{0, 0};
+  cache.Reorder(indices);
+
+  // token 1 is written to the shared block, which is copied for sequence 1 in both pools
+  ASSERT_TRUE(UpdatePagedKVCacheFeeds<float>(cache, 1, 2, alloc, 0, 1, 2, 2, feeds, fetches).IsOK());
+  const int32_t* block_table = feeds[2].Get<Tensor>().Data<int32_t>();
+  ASSERT_NE(block_table[0], block_table[4]);
+  for (int sequence = 0; sequence < num_sequences; sequence++) {
+    EXPECT_EQ(feeds[0].Get<Tensor>().Data<float>()[block_table[sequence * 4] * block_size], 1.0f);
+    EXPECT_EQ(feeds[1].Get<Tensor>().Data<float>()[block_table[sequence * 4] * block_size], 2.0f);
+  }
+
+  // more blocks than available grow the pools and keep their content
+  ASSERT_TRUE(UpdatePagedKVCacheFeeds<float>(cache, 2, 3, alloc, 0, 1, 2, 2, feeds, fetches).IsOK());
+  EXPECT_GT(cache.NumBlocks(), num_blocks);
+  for (int i = 0; i < 2; i++) {
+    const float* data = feeds[i].Get<Tensor>().Data<float>();
+    EXPECT_EQ(feeds[i].Get<Tensor>().Shape()[0], cache.NumBlocks());
+    EXPECT_EQ(fetches[1 + i].Get<Tensor>().Data<float>(), data);
+    for (int sequence = 0; sequence < num_sequences; sequence++) {
+      EXPECT_EQ(data[block_table[sequence * 4] * block_size], i == 0 ? 1.0f : 2.0f);
+    }
+  }
+}
+
+#ifndef DISABLE_CONTRIB_OPS
+
+// Run GroupQueryAttention with a dense past state and with a paged past state that holds the same tokens in scattered
+// blocks, and compare both with a reference attention.
+static void RunPagedGroupQueryAttentionTest(const std::vector<int>& past_lengths, int sequence_length) {
+  constexpr int num_heads = 4;
+  constexpr int kv_num_heads = 2;
+  constexpr int head_size = 8;
+  constexpr int block_size = 4;
+  constexpr int hidden_size = num_heads * head_size;
+  constexpr int kv_hidden_size = kv_num_heads * head_size;
+  const int batch_size = static_cast<int>(past_lengths.size());
+  const int past_buffer_length = *std::max_element(past_lengths.begin(), past_lengths.end());
+  const int total_sequence_length = past_buffer_length + sequence_length;
+  const int max_blocks_per_sequence = (total_sequence_length + block_size - 1) / block_size;
+  const int num_blocks = batch_size * max_blocks_per_sequence + 1;
+
+  RandomValueGenerator random{1234};
+  const std::vector<int64_t> query_dims{batch_size, sequence_length, hidden_size};
+  const std::vector<int64_t> kv_dims{batch_size, sequence_length, kv_hidden_size};
+  const std::vector<int64_t> past_dims{batch_size, kv_num_heads, past_buffer_length, head_size};
+  const std::vector<int64_t> pool_dims{num_blocks, kv_num_heads, block_size, head_size};
+  const std::vector<float> query = random.Uniform<float>(query_dims, -1.0f, 1.0f);
+  const std::vector<float> key = random.Uniform<float>(kv_dims, -1.0f, 1.0f);
+  const std::vector<float> value = random.Uniform<float>(kv_dims, -1.0f, 1.0f);
+  const std::vector<float> past_key = random.Uniform<float>(past_dims, -1.0f, 1.0f);
+  const std::vector<float> past_value = random.Uniform<float>(past_dims, -1.0f, 1.0f);
+  std::vector<float> key_pool = random.Uniform<float>(pool_dims, -1.0f, 1.0f);
+  std::vector<float> value_pool = random.Uniform<float>(pool_dims, -1.0f, 1.0f);
+
+  // Sequences use the blocks in a shuffled order, and one block is not used at all.
+  std::vector<int32_t> blocks(num_blocks);
+  std::iota(blocks.begin(), blocks.end(), 0);
+  std::shuffle(blocks.begin(), blocks.end(), std::mt19937(42));
+  std::vector<int32_t> block_table(static_cast<size_t>(batch_size) * max_blocks_per_sequence, -1);
+  std::vector<int32_t> seqlens_k(batch_size);
+  for (int b = 0; b < batch_size; b++) {
+    seqlens_k[b] = past_lengths[b] + sequence_length - 1;
+    for (int i = 0; i * block_size <= seqlens_k[b]; i++) {
+      block_table[b * max_blocks_per_sequence + i] = blocks[b * max_blocks_per_sequence + i];
+    }
+  }
+
+  // Key or value of token t of sequence b and kv head n in the dense buffer and in the pool.
+  auto dense_index = [&](int b, int n, int t, int length) {
+    return ((static_cast<size_t>(b) * kv_num_heads + n) * length + t) * head_size;
+  };
+  auto pool_index = [&](int b, int n, int t) {
+    const int32_t block = block_table[b * max_blocks_per_sequence + t / block_size];
+    return ((static_cast<size_t>(block) * kv_num_heads + n) * block_size + t % block_size) * head_size;
+  };
+  auto new_index = [&](int b, int n, int s) {
+    return (static_cast<size_t>(b) * sequence_length + s) * kv_hidden_size + static_cast<size_t>(n) * head_size;
+  };
+
+  for (int b = 0; b < batch_size; b++) {
+    for (int n = 0; n < kv_num_heads; n++) {
+      for (int t = 0; t < past_lengths[b]; t++) {
+        std::copy_n(past_key.begin() + dense_index(b, n, t, past_buffer_length), head_size,
+                    key_pool.begin() + pool_index(b, n, t));
+        std::copy_n(past_value.begin() + dense_index(b, n, t, past_buffer_length), head_size,
+                    value_pool.begin() + pool_index(b, n, t));
+      }
+    }
+  }
+
+  // Expected present state: the past tokens followed by the new tokens.
+  const int present_length = std::max(total_sequence_length, past_buffer_length);
+  std::vector<float> present_key(static_cast<size_t>(batch_size) * kv_num_heads * present_length * head_size, 0.0f);
+  std::vector<float> present_value(present_key.size(), 0.0f);
+  std::vector<float> present_key_pool = key_pool;
+  std::vector<float> present_value_pool = value_pool;
+  for (int b = 0; b < batch_size; b++) {
+    for (int n = 0; n < kv_num_heads; n++) {
+      for (int t = 0; t < past_lengths[b] + sequence_length; t++) {
+        const bool is_new = t >= past_lengths[b];
+        const size_t source = is_new ? new_index(b, n, t - past_lengths[b]) : dense_index(b, n, t, past_buffer_length);
+        const auto& k = is_new ? key : past_key;
+        const auto& v = is_new ? value : past_value;
+        std::copy_n(k.begin() + source, head_size, present_key.begin() + dense_index(b, n, t, present_length));
+        std::copy_n(v.begin() + source, head_size, present_value.begin() + dense_index(b, n, t, present_length));
+        std::copy_n(k.begin() + source, head_size, present_key_pool.begin() + pool_index(b, n, t));
+        std::copy_n(v.begin() + source, head_size, present_value_pool.begin() + pool_index(b, n, t));
+      }
+    }
+  }
+
+  // Expected output: causal attention of each query token over the present tokens.
+  std::vector<float> output(query.size());
+  const float scale = 1.0f / std::sqrt(static_cast<float>(head_size));
+  for (int b = 0; b < batch_size; b++) {
+    for (int n = 0; n < num_heads; n++) {
+      const int kv_head = n / (num_heads / kv_num_heads);
+      for (int s = 0; s < sequence_length; s++) {
+        const float* q = query.data() + (static_cast<size_t>(b) * sequence_length + s) * hidden_size + n * head_size;
+        const int length = past_lengths[b] + s + 1;
+        std::vector<float> scores(length);
+        for (int t = 0; t < length; t++) {
+          const float* k = present_key.data() + dense_index(b, kv_head, t, present_length);
+          scores[t] = scale * std::inner_product(q, q + head_size, k, 0.0f);
+        }
+        const float max_score = *std::max_element(scores.begin(), scores.end());
+        float sum = 0.0f;
+        for (float& score : scores) {
+          score = std::exp(score - max_score);
+          sum += score;
+        }
+        float* out = output.data() + (static_cast<size_t>(b) * sequence_length + s) * hidden_size + n * head_size;
+        for (int t = 0; t < length; t++) {
+          const float* v = present_value.data() + dense_index(b, kv_head, t, present_length);
+          for (int h = 0; h < head_size; h++) {
+            out[h] += scores[t] / sum * v[h];
+          }
+        }
+      }
+    }
+  }
+
+  for (bool paged : {false, true}) {
+    OpTester tester("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+    tester.AddAttribute<int64_t>("num_heads", num_heads);
+    tester.AddAttribute<int64_t>("kv_num_heads", kv_num_heads);
+    tester.AddInput<float>("query", query_dims, query);
+    tester.AddInput<float>("key", kv_dims, key);
+    tester.AddInput<float>("value", kv_dims, value);
+    tester.AddInput<float>("past_key", paged ? pool_dims : past_dims, paged ? key_pool : past_key);
+    tester.AddInput<float>("past_value", paged ? pool_dims : past_dims, paged ? value_pool : past_value);
+    tester.AddInput<int32_t>("seqlens_k", {batch_size}, seqlens_k);
+    tester.AddInput<int32_t>("total_sequence_length", {1}, {total_sequence_length});
+    if (paged) {
+      tester.AddOptionalInputEdge<float>();
+      tester.AddOptionalInputEdge<float>();
+      tester.AddInput<int32_t>("block_table", {batch_size, max_blocks_per_sequence}, block_table);
+    }
+
+    const std::vector<int64_t> present_dims{batch_size, kv_num_heads, present_length, head_size};
+    tester.AddOutput<float>("output", query_dims, output);
+    tester.AddOutput<float>("present_key", paged ? pool_dims : present_dims, paged ? present_key_pool : present_key);
+    tester.AddOutput<float>("present_value", paged ? pool_dims : present_dims,
+                            paged ? present_value_pool : present_value);
+    tester.SetOutputTolerance(1e-4f);
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+}
+
+TEST(PagedKVCacheTest, GroupQueryAttentionPromptMatchesDense) {
+  RunPagedGroupQueryAttentionTest({0, 0}, /*sequence_length*/ 7);
+}
+
+TEST(PagedKVCacheTest, GroupQueryAttentionTokenGenerationMatchesDense) {
+  // The new tokens of the sequences are written to the middle of a block, the start of a block and the end of a block.
+  RunPagedGroupQueryAttentionTest({9, 8, 3}, /*sequence_length*/ 1);
+}
+
+namespace {
+
+void SetTensorValueInfo(ONNX_NAMESPACE::ValueInfoProto& value_info, const std::string& name, int32_t elem_type,
+                        const std::vector<int64_t>& dims) {
+  value_info.set_name(name);
+  auto* tensor_type = value_info.mutable_type()->mutable_tensor_type();
+  tensor_type->set_elem_type(elem_type);
+  auto* shape = tensor_type->mutable_shape();
+  for (size_t i = 0; i < dims.size(); i++) {
+    // negative dimensions are symbolic
+    if (dims[i] < 0) {
+      shape->add_dim()->set_dim_param(name + "_dim" + std::to_string(i));
+    } else {
+      shape->add_dim()->set_dim_value(dims[i]);
+    }
+  }
+}
+
+ONNX_NAMESPACE::NodeProto& AddNode(ONNX_NAMESPACE::GraphProto& graph, const std::string& op_type,
+                                   const std::vector<std::string>& inputs, const std::vector<std::string>& outputs,
+                                   const std::string& domain = "") {
+  auto* node = graph.add_node();
+  node->set_op_type(op_type);
+  node->set_domain(domain);
+  node->set_name(op_type + "_" + std::to_string(graph.node_size()));
+  for (const auto& input : inputs) {
+    node->add_input(input);
+  }
+  for (const auto& output : outputs) {
+    node->add_output(output);
+  }
+  return *node;
+}
+
+void AddIntAttribute(ONNX_NAMESPACE::NodeProto& node, const std::string& name, int64_t value) {
+  auto* attribute = node.add_attribute();
+  attribute->set_name(name);
+  attribute->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_INT);
+  attribute->set_i(value);
+}
+
+void AddFloatInitializer(ONNX_NAMESPACE::GraphProto& graph, const std::string& name, const std::vector<int64_t>& dims,
+                         const std::vector<float>& values) {
+  auto* tensor = graph.add_initializer();
+  tensor->set_name(name);
+  tensor->set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  for (int64_t dim : dims) {
+    tensor->add_dims(dim);
+  }
+  for (float value : values) {
+    tensor->add_float_data(value);
+  }
+}
+
+void AddIntInitializer(ONNX_NAMESPACE::GraphProto& graph, const std::string& name, int32_t data_type,
+                       const std::vector<int64_t>& dims, const std::vector<int64_t>& values) {
+  auto* tensor = graph.add_initializer();
+  tensor->set_name(name);
+  tensor->set_data_type(data_type);
+  for (int64_t dim : dims) {
+    tensor->add_dims(dim);
+  }
+  for (int64_t value : values) {
+    if (data_type == ONNX_NAMESPACE::TensorProto_DataType_INT32) {
+      tensor->add_int32_data(static_cast<int32_t>(value));
+    } else {
+      tensor->add_int64_data(value);
+    }
+  }
+}
+
+constexpr int kTinyVocabSize = 24;
+constexpr int kTinyNumHeads = 2;
+constexpr int kTinyKVNumHeads = 1;
+constexpr int kTinyHeadSize = 8;
+constexpr int kTinyHiddenSize = kTinyNumHeads * kTinyHeadSize;
+constexpr int kTinyBlockSize = 4;
+
+// Build a GPT decoder subgraph with one GroupQueryAttention layer. The past state is either a dense past_0 with shape
+// (2, batch_size, kv_num_heads, past_sequence_length, head_size), or paged key and value pools with shape
+// (num_blocks, kv_num_heads, block_size, head_size) that are passed directly to GroupQueryAttention.
+ONNX_NAMESPACE::GraphProto BuildTinyGqaDecoder(bool paged) {
+  constexpr auto float_type = ONNX_NAMESPACE::TensorProto_DataType_FLOAT;
+  constexpr auto int32_type = ONNX_NAMESPACE::TensorProto_DataType_INT32;
+  constexpr auto int64_type = ONNX_NAMESPACE::TensorProto_DataType_INT64;
+
+  ONNX_NAMESPACE::GraphProto graph;
+  graph.set_name(paged ? "paged_decoder" : "dense_decoder");
+  SetTensorValueInfo(*graph.add_input(), "input_ids", int32_type, {-1, -1});
+  SetTensorValueInfo(*graph.add_input(), "position_ids", int32_type, {-1, -1});
+  SetTensorValueInfo(*graph.add_input(), "attention_mask", int32_type, {-1, -1});
+  if (paged) {
+    SetTensorValueInfo(*graph.add_input(), "past_key_0", float_type, {-1, kTinyKVNumHeads, kTinyBlockSize, kTinyHeadSize});
+    SetTensorValueInfo(*graph.add_input(), "past_value_0", float_type,
+                       {-1, kTinyKVNumHeads, kTinyBlockSize, kTinyHeadSize});
+    SetTensorValueInfo(*graph.add_input(), "block_table", int32_type, {-1, -1});
+    SetTensorValueInfo(*graph.add_input(), "past_sequence_length", int32_type, {1});
+  } else {
+    SetTensorValueInfo(*graph.add_input(), "past_0", float_type, {2, -1, kTinyKVNumHeads, -1, kTinyHeadSize});
+  }
+
+  SetTensorValueInfo(*graph.add_output(), "logits", float_type, {-1, -1, kTinyVocabSize});
+  if (paged) {
+    SetTensorValueInfo(*graph.add_output(), "present_key_0", float_type,
+                       {-1, kTinyKVNumHeads, kTinyBlockSize, kTinyHeadSize});
+    SetTensorValueInfo(*graph.add_output(), "present_value_0", float_type,
+                       {-1, kTinyKVNumHeads, kTinyBlockSize, kTinyHeadSize});
+  } else {
+    SetTensorValueInfo(*graph.add_output(), "present_0", float_type, {2, -1, kTinyKVNumHeads, -1, kTinyHeadSize});
+  }
+
+  RandomValueGenerator random{4321};
+  constexpr int kv_hidden_size = kTinyKVNumHeads * kTinyHeadSize;
+  AddFloatInitializer(graph, "embedding", {kTinyVocabSize, kTinyHiddenSize},
+                      random.Uniform<float>(std::vector<int64_t>{kTinyVocabSize, kTinyHiddenSize}, -1.0f, 1.0f));
+  AddFloatInitializer(graph, "wq", {kTinyHiddenSize, kTinyHiddenSize},
+                      random.Uniform<float>(std::vector<int64_t>{kTinyHiddenSize, kTinyHiddenSize}, -1.0f, 1.0f));
+  AddFloatInitializer(graph, "wk", {kTinyHiddenSize, kv_hidden_size},
+                      random.Uniform<float>(std::vector<int64_t>{kTinyHiddenSize, kv_hidden_size}, -1.0f, 1.0f));
+  AddFloatInitializer(graph, "wv", {kTinyHiddenSize, kv_hidden_size},
+                      random.Uniform<float>(std::vector<int64_t>{kTinyHiddenSize, kv_hidden_size}, -1.0f, 1.0f));
+  AddFloatInitializer(graph, "wo", {kTinyHiddenSize, kTinyVocabSize},
+                      random.Uniform<float>(std::vector<int64_t>{kTinyHiddenSize, kTinyVocabSize}, -1.0f, 1.0f));
+  AddIntInitializer(graph, "one_i32", int32_type, {}, {1});
+  AddIntInitializer(graph, "axes_1", int64_type, {1}, {1});
+
+  AddNode(graph, "Gather", {"embedding", "input_ids"}, {"x"});
+  AddNode(graph, "MatMul", {"x", "wq"}, {"q"});
+  AddNode(graph, "MatMul", {"x", "wk"}, {"k"});
+  AddNode(graph, "MatMul", {"x", "wv"}, {"v"});
+
+  // seqlens_k is the total sequence length minus 1, and total_sequence_length is the length of the attention mask.
+  AddIntAttribute(AddNode(graph, "ReduceSum", {"attention_mask", "axes_1"}, {"mask_sum"}), "keepdims", 0);
+  AddNode(graph, "Sub", {"mask_sum", "one_i32"}, {"seqlens_k"});
+  AddIntAttribute(AddNode(graph, "Shape", {"attention_mask"}, {"mask_length"}), "start", 1);
+  AddIntAttribute(AddNode(graph, "Cast", {"mask_length"}, {"total_sequence_length"}), "to", int32_type);
+
+  if (paged) {
+    auto& gqa = AddNode(graph, "GroupQueryAttention",
+                        {"q", "k", "v", "past_key_0", "past_value_0", "seqlens_k", "total_sequence_length", "", "",
+                         "block_table"},
+                        {"attention", "present_key_0", "present_value_0"}, kMSDomain);
+    AddIntAttribute(gqa, "num_heads", kTinyNumHeads);
+    AddIntAttribute(gqa, "kv_num_heads", kTinyKVNumHeads);
+  } else {
+    AddIntInitializer(graph, "zero_i64", int64_type, {}, {0});
+    AddIntInitializer(graph, "one_i64", int64_type, {}, {1});
+    AddIntInitializer(graph, "axes_0", int64_type, {1}, {0});
+    AddNode(graph, "Gather", {"past_0", "zero_i64"}, {"past_key"});
+    AddNode(graph, "Gather", {"past_0", "one_i64"}, {"past_value"});
+    auto& gqa = AddNode(graph, "GroupQueryAttention",
+                        {"q", "k", "v", "past_key", "past_value", "seqlens_k", "total_sequence_length"},
+                        {"attention", "present_key", "present_value"}, kMSDomain);
+    AddIntAttribute(gqa, "num_heads", kTinyNumHeads);
+    AddIntAttribute(gqa, "kv_num_heads", kTinyKVNumHeads);
+    AddNode(graph, "Unsqueeze", {"present_key", "axes_0"}, {"present_key_4d"});
+    AddNode(graph, "Unsqueeze", {"present_value", "axes_0"}, {"present_value_4d"});
+    AddIntAttribute(AddNode(graph, "Concat", {"present_key_4d", "present_value_4d"}, {"present_0"}), "axis", 0);
+  }
+
+  AddNode(graph, "Add", {"attention", "x"}, {"hidden"});
+  AddNode(graph, "MatMul", {"hidden", "wo"}, {"logits"});
+  return graph;
+}
+
+// Run BeamSearch (num_beams > 1) or GreedySearch with the tiny GQA decoder and return the generated sequences.
+std::vector<int32_t> RunTinyGqaGeneration(bool paged, int num_beams, const std::vector<int32_t>& input_ids,
+                                          int batch_size, int max_length) {
+  constexpr auto float_type = ONNX_NAMESPACE::TensorProto_DataType_FLOAT;
+  constexpr auto int32_type = ONNX_NAMESPACE::TensorProto_DataType_INT32;
+  const bool is_beam_search = num_beams > 1;
+  const int sequence_length = static_cast<int>(input_ids.size()) / batch_size;
+
+  ONNX_NAMESPACE::ModelProto model;
+  model.set_ir_version(8);
+  auto* opset = model.add_opset_import();
+  opset->set_domain("");
+  opset->set_version(17);
+  opset = model.add_opset_import();
+  opset->set_domain(kMSDomain);
+  opset->set_version(1);
+
+  auto& graph = *model.mutable_graph();
+  graph.set_name("generation");
+  std::vector<std::string> inputs{"input_ids", "max_length", "min_length"};
+  if (is_beam_search) {
+    inputs.insert(inputs.end(), {"num_beams", "num_return_sequences", "length_penalty"});
+  }
+  inputs.push_back("repetition_penalty");
+  for (const auto& input : inputs) {
+    const bool is_float = input == "length_penalty" || input == "repetition_penalty";
+    SetTensorValueInfo(*graph.add_input(), input, is_float ? float_type : int32_type,
+                       input == "input_ids" ? std::vector<int64_t>{-1, -1} : std::vector<int64_t>{1});
+  }
+  SetTensorValueInfo(*graph.add_output(), "sequences", int32_type,
+                     is_beam_search ? std::vector<int64_t>{-1, -1, -1} : std::vector<int64_t>{-1, -1});
+
+  auto& node = AddNode(graph, is_beam_search ? "BeamSearch" : "GreedySearch", inputs, {"sequences"}, kMSDomain);
+  AddIntAttribute(node, "eos_token_id", kTinyVocabSize - 1);
+  AddIntAttribute(node, "pad_token_id", kTinyVocabSize - 1);
+  AddIntAttribute(node, "model_type", 0);
+  auto* decoder = node.add_attribute();
+  decoder->set_name("decoder");
+  decoder->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_GRAPH);
+  *decoder->mutable_g() = BuildTinyGqaDecoder(paged);
+
+  std::string model_data;
+  model.SerializeToString(&model_data);
+  Ort::SessionOptions session_options;
+  Ort::Session session(*ort_env, model_data.data(), model_data.size(), session_options);
+
+  auto info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+  std::vector<int32_t> input_ids_data = input_ids;
+  std::vector<int64_t> input_ids_shape{batch_size, sequence_length};
+  std::vector<int64_t> parameter_shape{1};
+  std::vector<int32_t> max_length_data{max_length};
+  std::vector<int32_t> min_length_data{1};
+  std::vector<int32_t> num_beams_data{num_beams};
+  std::vector<int32_t> num_return_sequences_data{1};
+  std::vector<float> length_penalty_data{1.0f};
+  std::vector<float> repetition_penalty_data{1.0f};
+
+  std::vector<Ort::Value> ort_inputs;
+  ort_inputs.push_back(Ort::Value::CreateTensor(info, input_ids_data.data(), input_ids_data.size(),
+                                                input_ids_shape.data(), input_ids_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(info, max_length_data.data(), 1, parameter_shape.data(), 1));
+  ort_inputs.push_back(Ort::Value::CreateTensor(info, min_length_data.data(), 1, parameter_shape.data(), 1));
+  if (is_beam_search) {
+    ort_inputs.push_back(Ort::Value::CreateTensor(info, num_beams_data.data(), 1, parameter_shape.data(), 1));
+    ort_inputs.push_back(
+        Ort::Value::CreateTensor(info, num_return_sequences_data.data(), 1, parameter_shape.data(), 1));
+    ort_inputs.push_back(Ort::Value::CreateTensor(info, length_penalty_data.data(), 1, parameter_shape.data(), 1));
+  }
+  ort_inputs.push_back(Ort::Value::CreateTensor(info, repetition_penalty_data.data(), 1, parameter_shape.data(), 1));
+
+  std::vector<const char*> input_names;
+  for (const auto& input : inputs) {
+    input_names.push_back(input.c_str());
+  }
+  const char* const output_names[] = {"sequences"};
+  auto ort_outputs = session.Run(Ort::RunOptions{}, input_names.data(), ort_inputs.data(), ort_inputs.size(),
+                                 output_names, 1);
+
+  const auto& sequences = ort_outputs[0];
+  const size_t count = sequences.GetTensorTypeAndShapeInfo().GetElementCount();
+  EXPECT_EQ(count, static_cast<size_t>(batch_size) * max_length);
+  const int32_t* data = sequences.GetTensorData<int32_t>();
+  return std::vector<int32_t>(data, data + count);
+}
+
+}  // namespace
+
+// The generated sequences are the same with a paged and a dense past state. The prompt and the generated tokens span
+// several blocks, so the pools are grown during generation, and beam search shares and copies blocks between beams.
+TEST(PagedKVCacheTest, GptGenerationMatchesDense) {
+  constexpr int batch_size = 2;
+  constexpr int max_length = 15;
+  const std::vector<int32_t> input_ids{3, 7, 1, 12, 5,
+                                       9, 2, 18, 4, 20};
+
+  for (int num_beams : {1, 3}) {
+    SCOPED_TRACE(num_beams);
+    const std::vector<int32_t> dense = RunTinyGqaGeneration(false, num_beams, input_ids, batch_size, max_length);
+    const std::vector<int32_t> paged = RunTinyGqaGeneration(true, num_beams, input_ids, batch_size, max_length);
+    EXPECT_EQ(paged, dense);
+  }
+}
+
+#endif  // DISABLE_CONTRIB_OPS
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -385,6 +385,7 @@ class PlannerTest : public ::testing::Test {
   void SetNodePartitionConfigFilePath(const char* config_file_path) {
     ORT_THROW_IF_ERROR(sess_options_->config_options.AddConfigEntry(kNodePartitionConfigFile, config_file_path));
   }
+  SessionOptions& GetSessionOptions() { return *sess_options_; }
   std::unique_ptr<::onnxruntime::KernelDef>& GetStdKernel() { return std_kernel_; }
 #ifdef USE_CUDA
   void MemcpyToHostInCuda_TransposeInCudaAndCpu(const char* partitionConfigFile = nullptr) {
@@ -1998,6 +1999,35 @@ TEST_F(PlannerTest, TestMultiStreamMismatchDevice) {
   status = sess.Initialize();
   ASSERT_TRUE(!status.IsOK());
 }
+
+// Test execution plan for the graph in parallel execution mode:
+// node1   node2
+//   \       /
+//    \     /
+//      node3
+// All 3 nodes are CPU EP. node1 and node2 are independent so they are put into separate streams.
+TEST_F(PlannerTest, ParallelExecutionCriticalPathPartition) {
+  std::unique_ptr<::onnxruntime::KernelDef> cpuKernelAdd = KernelDefBuilder().SetName("Add").Provider(kCpuExecutionProvider).SinceVersion(1, 10).Build();
+  std::string Graph_input("Graph_input"), Arg1("Arg1"), Arg2("Arg2"), Arg3("Arg3"), node1("node1"), node2("node2"), node3("node3");
+  std::vector<onnxruntime::NodeArg*> input1{Arg(Graph_input)}, output1{Arg(Arg1)}, output2{Arg(Arg2)}, input3{Arg(Arg1), Arg(Arg2)}, output3{Arg(Arg3)};
+  AddNode(*GetStdKernel(), node1, input1, output1);
+  AddNode(*GetStdKernel(), node2, input1, output2);
+  AddNode(*cpuKernelAdd, node3, input3, output3);
+
+  GetSessionOptions().execution_mode = ExecutionMode::ORT_PARALLEL;
+  ASSERT_STATUS_OK(GetSessionOptions().config_options.AddConfigEntry(kOrtSessionOptionsConfigParallelExecutionMaxCpuStreams, "4"));
+  CreatePlan({}, false);
+
+  EXPECT_EQ(GetState().GetExecutionPlan()->execution_plan.size(), 2) << "2 logic streams for the 2 branches";
+  EXPECT_EQ(GetState().GetExecutionPlan()->execution_plan[0]->steps_.size(), 3) << "stream 0 has 3 steps";
+  EXPECT_NE(strstr(typeid(*GetState().GetExecutionPlan()->execution_plan[0]->steps_[0]).name(), "LaunchKernelStep"), nullptr) << "0th step: LaunchKernelStep for node 1";
+  EXPECT_NE(strstr(typeid(*GetState().GetExecutionPlan()->execution_plan[0]->steps_[1]).name(), "BarrierStep"), nullptr) << "1st step: BarrierStep for node 3, for TriggerDownstreamStep in stream 1";
+  EXPECT_NE(strstr(typeid(*GetState().GetExecutionPlan()->execution_plan[0]->steps_[2]).name(), "LaunchKernelStep"), nullptr) << "2nd step: LaunchKernelStep for node 3";
+
+  EXPECT_EQ(GetState().GetExecutionPlan()->execution_plan[1]->steps_.size(), 2) << "stream 1 has 2 steps";
+  EXPECT_NE(strstr(typeid(*GetState().GetExecutionPlan()->execution_plan[1]->steps_[0]).name(), "LaunchKernelStep"), nullptr) << "0th step: LaunchKernelStep for node 2";
+  EXPECT_NE(strstr(typeid(*GetState().GetExecutionPlan()->execution_plan[1]->steps_[1]).name(), "TriggerDownstreamStep"), nullptr) << "1st step: TriggerDownstreamStep for node 3";
+}
 #endif
 
 #if defined(USE_CUDA) && defined(ORT_ENABLE_STREAM)
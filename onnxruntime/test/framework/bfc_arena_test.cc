@@ -7,6 +7,7 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <cstdlib>
+#include <thread>
 #include "core/framework/stream_handles.h"
 
 namespace onnxruntime {
@@ -321,6 +322,177 @@ TEST(BFCArenaTest, TestBackoffDoesntHang) {
   EXPECT_THROW(a.Alloc(1024), OnnxRuntimeException) << "Arena should be unable to allocate memory";
 }
 
+TEST(BFCArenaTest, TestThreadCache) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_cache_max_bytes*/ 64 * 1024);
+
+  void* p1 = a.Alloc(1000);
+  EXPECT_EQ(a.RequestedSize(p1), 1000u);
+  EXPECT_EQ(a.AllocatedSize(p1), 1024u);
+  a.Free(p1);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.thread_cache_bytes, 1024);
+
+  // the freed chunk is reused for an allocation of the same bin
+  void* p2 = a.Alloc(900);
+  EXPECT_EQ(p2, p1);
+  EXPECT_EQ(a.RequestedSize(p2), 900u);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 2);
+  EXPECT_EQ(stats.num_thread_cache_hits, 1);
+  EXPECT_EQ(stats.thread_cache_bytes, 0);
+  EXPECT_EQ(stats.bytes_in_use, 1024);
+
+  // large allocations bypass the caches
+  void* large = a.Alloc(1024 * 1024);
+  a.Free(large);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.thread_cache_bytes, 0);
+  a.Free(p2);
+
+  // the cache returns chunks to the arena once it exceeds its limit
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 32; ++i) {
+    ptrs.push_back(a.Alloc(4096));
+  }
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+  a.GetStats(&stats);
+  EXPECT_GT(stats.num_thread_cache_flushes, 0);
+  EXPECT_LE(stats.thread_cache_bytes, 64 * 1024);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  // Shrink returns all cached chunks first so the regions can be freed
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.thread_cache_bytes, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, TestThreadCacheFlushedWhenOutOfMemory) {
+  constexpr size_t memory_limit = 1024 * 1024;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), memory_limit, BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_cache_max_bytes*/ 2 * memory_limit);
+
+  // fill the arena with small chunks and keep all of them in the cache of this thread
+  constexpr size_t small_size = 32 * 1024;
+  std::vector<void*> ptrs;
+  for (size_t i = 0; i < memory_limit / small_size; ++i) {
+    ptrs.push_back(a.Alloc(small_size));
+  }
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.thread_cache_bytes, static_cast<int64_t>(memory_limit));
+  EXPECT_EQ(stats.num_thread_cache_flushes, 0);
+
+  // the arena cannot grow, so the cached chunks are returned to the bins where they coalesce
+  void* large = nullptr;
+  ASSERT_NO_THROW(large = a.Alloc(memory_limit / 2));
+  ASSERT_NE(large, nullptr);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.thread_cache_bytes, 0);
+  EXPECT_GT(stats.num_thread_cache_flushes, 0);
+  EXPECT_EQ(stats.total_allocated_bytes, static_cast<int64_t>(memory_limit));
+  a.Free(large);
+
+  // with nothing left in the caches the arena still fails once the request does not fit
+  EXPECT_THROW(a.Alloc(2 * memory_limit), OnnxRuntimeException);
+}
+
+// The cached chunks are returned to the bins before the arena grows, even when it is allowed to grow.
+TEST(BFCArenaTest, TestThreadCacheFlushedBeforeExtend) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_cache_max_bytes*/ 1 << 30);
+
+  // fill the first region of the arena with small chunks and keep all of them in the cache of this thread
+  constexpr size_t region_size = BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES;
+  constexpr size_t small_size = 32 * 1024;
+  std::vector<void*> ptrs;
+  for (size_t i = 0; i < region_size / small_size; ++i) {
+    ptrs.push_back(a.Alloc(small_size));
+  }
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, static_cast<int64_t>(region_size));
+  EXPECT_EQ(stats.thread_cache_bytes, static_cast<int64_t>(region_size));
+
+  // the coalesced cached chunks satisfy the request, so the arena does not grow
+  void* large = a.Alloc(region_size / 2);
+  ASSERT_NE(large, nullptr);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.thread_cache_bytes, 0);
+  EXPECT_GT(stats.num_thread_cache_flushes, 0);
+  EXPECT_EQ(stats.total_allocated_bytes, static_cast<int64_t>(region_size));
+  EXPECT_EQ(stats.num_arena_extensions, 1);
+  a.Free(large);
+}
+
+TEST(BFCArenaTest, TestThreadCacheConcurrentAllocations) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_cache_max_bytes*/ 256 * 1024);
+
+  constexpr int num_threads = 4;
+  constexpr int num_iterations = 1000;
+  // chunks allocated by one thread are freed by the next one
+  std::vector<std::vector<void*>> handoff(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&a, &handoff, t]() {
+      auto& mine = handoff[t];
+      for (int i = 0; i < num_iterations; ++i) {
+        const size_t size = 64 + static_cast<size_t>((i * 37 + t * 101) % 8192);
+        auto* p = static_cast<char*>(a.Alloc(size));
+        ASSERT_NE(p, nullptr);
+        p[0] = static_cast<char>(t);
+        p[size - 1] = static_cast<char>(i);
+        EXPECT_GE(a.AllocatedSize(p), size);
+        if (i % 3 == 0) {
+          mine.push_back(p);
+        } else {
+          a.Free(p);
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int t = 0; t < num_threads; ++t) {
+    for (void* p : handoff[(t + 1) % num_threads]) {
+      a.Free(p);
+    }
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, num_threads * num_iterations);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_GT(stats.num_thread_cache_hits, 0);
+}
+
 struct NotificationMock : public synchronize::Notification {
  public:
   NotificationMock(Stream& s) : Notification(s) {}
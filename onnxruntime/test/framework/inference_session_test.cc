@@ -8,7 +8,9 @@
 #include <cfloat>
 #include <functional>
 #include <iterator>
+#include <set>
 #include <thread>
+#include <filesystem>
 #include <fstream>
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
@@ -22,6 +24,7 @@
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_store.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/bfc_arena.h"
 #include "core/graph/graph_viewer.h"
@@ -3008,5 +3011,420 @@ TEST(InferenceSessionTests, InterThreadPoolWithDenormalAsZero) {
 }
 #endif
 
+TEST(InferenceSessionTests, PrepackedWeightsCacheFile) {
+  const PathString cache_file = ORT_TSTR("prepacked_weights_cache_file_test.bin");
+  std::filesystem::remove(cache_file);
+
+  SessionOptions so;
+  so.session_logid = "PrepackedWeightsCacheFile";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigPrepackedWeightsCacheFile,
+                                                    PathToUTF8String(cache_file).c_str()));
+
+  std::vector<int64_t> dims_x = {3, 2};
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims_x, values_x, &ml_value);
+  NameMLValMap feeds{{"X", ml_value}};
+  const std::vector<std::string> output_names{"Y"};
+
+  // The first session packs the weight and writes it to the cache file
+  {
+    InferenceSessionWrapper session{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+    ASSERT_STATUS_OK(session.Initialize());
+    if (session.GetSessionState().GetNumberOfPrepacksCounter() == 0) {
+      GTEST_SKIP() << "MatMul does not pre-pack its weight on this platform";
+    }
+    ASSERT_EQ(session.GetSessionState().GetUsedCachedPrePackedWeightCounter(), 0u);
+    ASSERT_TRUE(std::filesystem::exists(cache_file));
+
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, output_names, &fetches));
+    VerifyOutputs(fetches, {3, 1}, {4.0f, 10.0f, 16.0f});
+  }
+
+  // The second session uses the pre-packed weight mapped from the cache file
+  {
+    InferenceSessionWrapper session{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+    ASSERT_STATUS_OK(session.Initialize());
+    ASSERT_EQ(session.GetSessionState().GetUsedCachedPrePackedWeightCounter(), 1u);
+    ASSERT_EQ(session.GetSessionState().GetNumberOfPrepacksCounter(), 1u);
+
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, output_names, &fetches));
+    VerifyOutputs(fetches, {3, 1}, {4.0f, 10.0f, 16.0f});
+  }
+
+  // A cache file written for another model is ignored
+  {
+    std::fstream stream(cache_file, std::ios::in | std::ios::out | std::ios::binary);
+    stream.seekp(8);
+    const uint64_t model_hash = 0;
+    stream.write(reinterpret_cast<const char*>(&model_hash), sizeof(model_hash));
+  }
+  {
+    InferenceSessionWrapper session{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+    ASSERT_STATUS_OK(session.Initialize());
+    ASSERT_EQ(session.GetSessionState().GetUsedCachedPrePackedWeightCounter(), 0u);
+    ASSERT_EQ(session.GetSessionState().GetNumberOfPrepacksCounter(), 1u);
+  }
+
+  std::filesystem::remove(cache_file);
+}
+
+TEST(InferenceSessionTests, ShareInitializersAcrossSessions) {
+  auto* store = GetEnvironment().GetSharedInitializerStore();
+  ASSERT_NE(store, nullptr);
+
+  auto get_initializer_data = [](const SessionState& session_state) {
+    std::set<const void*> data;
+    for (const auto& [ort_value_index, ort_value] : session_state.GetInitializedTensors()) {
+      data.insert(ort_value.Get<Tensor>().DataRaw());
+    }
+    return data;
+  };
+
+  // sessions with different options that load the same model share the initializers
+  SessionOptions so1;
+  so1.session_logid = "ShareInitializersAcrossSessions1";
+  so1.graph_optimization_level = TransformerLevel::Level1;
+  ASSERT_STATUS_OK(so1.config_options.AddConfigEntry(kOrtSessionOptionsConfigShareInitializersAcrossSessions, "1"));
+  SessionOptions so2 = so1;
+  so2.session_logid = "ShareInitializersAcrossSessions2";
+  so2.intra_op_param.thread_pool_size = 1;
+
+  {
+    InferenceSessionWrapper session1{so1, GetEnvironment()};
+    ASSERT_STATUS_OK(session1.Load(ORT_TSTR("testdata/mnist.onnx")));
+    ASSERT_STATUS_OK(session1.Initialize());
+    ASSERT_EQ(session1.GetSessionState().GetInitializerSharedBytes(), 0u);
+
+    InferenceSessionWrapper session2{so2, GetEnvironment()};
+    ASSERT_STATUS_OK(session2.Load(ORT_TSTR("testdata/mnist.onnx")));
+    ASSERT_STATUS_OK(session2.Initialize());
+    ASSERT_GT(session2.GetSessionState().GetInitializerSharedBytes(), 0u);
+
+    const auto data1 = get_initializer_data(session1.GetSessionState());
+    const auto data2 = get_initializer_data(session2.GetSessionState());
+    std::vector<const void*> shared_data;
+    std::set_intersection(data1.begin(), data1.end(), data2.begin(), data2.end(), std::back_inserter(shared_data));
+    ASSERT_FALSE(shared_data.empty());
+
+    const auto stats = store->GetStats();
+    ASSERT_GT(stats.num_initializers, 0u);
+    ASSERT_EQ(stats.num_references, 2 * stats.num_initializers);
+    ASSERT_EQ(stats.saved_bytes, stats.bytes);
+
+    // a session without the option does not use the store
+    SessionOptions so3;
+    so3.session_logid = "ShareInitializersAcrossSessions3";
+    so3.graph_optimization_level = TransformerLevel::Level1;
+    InferenceSessionWrapper session3{so3, GetEnvironment()};
+    ASSERT_STATUS_OK(session3.Load(ORT_TSTR("testdata/mnist.onnx")));
+    ASSERT_STATUS_OK(session3.Initialize());
+    ASSERT_EQ(session3.GetSessionState().GetInitializerSharedBytes(), 0u);
+    const auto data3 = get_initializer_data(session3.GetSessionState());
+    for (const void* data : shared_data) {
+      ASSERT_EQ(data3.count(data), 0u);
+    }
+  }
+
+  // the initializers are freed with the last session using them
+  ASSERT_EQ(store->GetStats().num_initializers, 0u);
+}
+
+TEST(InferenceSessionTests, IntraOpParallelismTuning) {
+  const std::filesystem::path tuning_file = ORT_TSTR("intra_op_parallelism_tuning_test.txt");
+  std::filesystem::remove(tuning_file);
+
+  SessionOptions so;
+  so.session_logid = "IntraOpParallelismTuning";
+  so.intra_op_param.thread_pool_size = 2;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigIntraOpParallelismTuning, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigIntraOpParallelismTuningFile,
+                                                    PathToUTF8String(tuning_file.native()).c_str()));
+
+  std::vector<int64_t> dims_x = {3, 2};
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims_x, values_x, &ml_value);
+  NameMLValMap feeds{{"X", ml_value}};
+  const std::vector<std::string> output_names{"Y"};
+
+  NodeIndex matmul_index = 0;
+  auto run_session = [&](int num_runs) {
+    InferenceSessionWrapper session{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+    ASSERT_STATUS_OK(session.Initialize());
+    ASSERT_EQ(session.GetGraph().NumberOfNodes(), 1);
+    matmul_index = session.GetGraph().Nodes().begin()->Index();
+    for (int i = 0; i < num_runs; ++i) {
+      std::vector<OrtValue> fetches;
+      ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, output_names, &fetches));
+      VerifyOutputs(fetches, {3, 1}, {4.0f, 10.0f, 16.0f});
+    }
+  };
+
+  auto count_lines = [&]() {
+    std::ifstream stream(tuning_file);
+    size_t lines = 0;
+    for (std::string line; std::getline(stream, line);) {
+      ++lines;
+    }
+    return lines;
+  };
+
+  // The outputs do not depend on the measured settings, and the single node is tuned within 20 runs
+  run_session(20);
+  ASSERT_TRUE(std::filesystem::exists(tuning_file));
+  ASSERT_EQ(count_lines(), 2u) << "header and the setting of the MatMul node";
+
+  // The entry holds the node, the hash of its input shapes and a setting within the 2 intra-op threads
+  {
+    std::ifstream stream(tuning_file);
+    std::string magic;
+    uint64_t model_hash = 0;
+    uint64_t environment_hash = 0;
+    int max_threads = 0;
+    ASSERT_TRUE(static_cast<bool>(stream >> magic >> model_hash >> environment_hash >> max_threads));
+    EXPECT_EQ(max_threads, 2);
+
+    NodeIndex node_index = 0;
+    uint64_t shape_hash = 0;
+    int num_threads = -1;
+    double block_size_scale = 0.0;
+    ASSERT_TRUE(static_cast<bool>(stream >> node_index >> shape_hash >> num_threads >> block_size_scale));
+    EXPECT_EQ(node_index, matmul_index);
+    EXPECT_NE(shape_hash, 0u);
+    EXPECT_TRUE(num_threads == 0 || num_threads == 1) << num_threads;
+    EXPECT_TRUE(block_size_scale == 0.25 || block_size_scale == 1.0 || block_size_scale == 4.0) << block_size_scale;
+  }
+
+  // A later session uses the tuned setting, and has nothing new to write
+  const auto write_time = std::filesystem::last_write_time(tuning_file);
+  run_session(1);
+  ASSERT_EQ(std::filesystem::last_write_time(tuning_file), write_time);
+
+  // A corrupt file is ignored and replaced
+  {
+    std::ofstream stream(tuning_file, std::ios::trunc);
+    stream << "not a tuning file";
+  }
+  run_session(20);
+  ASSERT_EQ(count_lines(), 2u);
+
+  std::filesystem::remove(tuning_file);
+}
+
+TEST(InferenceSessionTests, NodeTraceStats) {
+  std::vector<int64_t> dims_x = {3, 2};
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims_x, values_x, &ml_value);
+  NameMLValMap feeds{{"X", ml_value}};
+  const std::vector<std::string> output_names{"Y"};
+
+  // Not enabled by default
+  {
+    SessionOptions so;
+    so.session_logid = "NodeTraceStatsDisabled";
+    InferenceSession session{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+    ASSERT_STATUS_OK(session.Initialize());
+    std::string stats_json;
+    ASSERT_STATUS_NOT_OK_AND_HAS_SUBSTR(session.GetNodeTraceStats(stats_json), "not enabled");
+  }
+
+  SessionOptions so;
+  so.session_logid = "NodeTraceStats";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigNodeTraceSampleInterval, "2"));
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  std::string stats_json;
+  ASSERT_STATUS_OK(session.GetNodeTraceStats(stats_json));
+  ASSERT_EQ(stats_json, R"({"nodes":[],"op_types":[]})");
+
+  // every second run of the MatMul node on this thread is recorded
+  for (int i = 0; i < 10; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, output_names, &fetches));
+    VerifyOutputs(fetches, {3, 1}, {4.0f, 10.0f, 16.0f});
+  }
+
+  ASSERT_STATUS_OK(session.GetNodeTraceStats(stats_json));
+  auto count_occurrences = [&stats_json](const std::string& text) {
+    size_t count = 0;
+    for (size_t pos = stats_json.find(text); pos != std::string::npos; pos = stats_json.find(text, pos + 1)) {
+      ++count;
+    }
+    return count;
+  };
+  EXPECT_EQ(count_occurrences(R"("op_type":"MatMul","count":5,)"), 2u) << stats_json;
+  // 3x1 float output
+  EXPECT_EQ(count_occurrences(R"("mean_output_bytes":12,)"), 2u) << stats_json;
+}
+
+TEST(InferenceSessionTests, IntraOpPriorityAndThreadShare) {
+  std::vector<int64_t> dims_x = {3, 2};
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims_x, values_x, &ml_value);
+  NameMLValMap feeds{{"X", ml_value}};
+  const std::vector<std::string> output_names{"Y"};
+
+  SessionOptions so;
+  so.session_logid = "IntraOpPriorityAndThreadShare";
+  so.intra_op_param.thread_pool_size = 4;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigIntraOpPriority, "high"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigIntraOpThreadShare, "0.5"));
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, output_names, &fetches));
+  VerifyOutputs(fetches, {3, 1}, {4.0f, 10.0f, 16.0f});
+  // the priority only applies during the run
+  EXPECT_EQ(concurrency::ThreadPool::CurrentPriority(), concurrency::ThreadPool::Priority::kNormal);
+
+  RunOptions run_options;
+  ASSERT_STATUS_OK(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigIntraOpPriority, "normal"));
+  ASSERT_STATUS_OK(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigIntraOpThreadShare, "1"));
+  fetches.clear();
+  ASSERT_STATUS_OK(session.Run(run_options, feeds, output_names, &fetches));
+  VerifyOutputs(fetches, {3, 1}, {4.0f, 10.0f, 16.0f});
+
+  RunOptions invalid_run_options;
+  ASSERT_STATUS_OK(invalid_run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigIntraOpThreadShare, "2"));
+  fetches.clear();
+  ASSERT_STATUS_NOT_OK_AND_HAS_SUBSTR(session.Run(invalid_run_options, feeds, output_names, &fetches),
+                                      "Invalid intra-op thread share");
+
+  SessionOptions invalid_so;
+  invalid_so.session_logid = "IntraOpPriorityInvalid";
+  ASSERT_STATUS_OK(invalid_so.config_options.AddConfigEntry(kOrtSessionOptionsConfigIntraOpPriority, "urgent"));
+  InferenceSession invalid_session{invalid_so, GetEnvironment()};
+  ASSERT_STATUS_OK(invalid_session.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+  ASSERT_STATUS_NOT_OK_AND_HAS_SUBSTR(invalid_session.Initialize(), "Invalid intra-op priority");
+}
+
+TEST(InferenceSessionTests, RunDeadline) {
+  std::vector<int64_t> dims_x = {3, 2};
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims_x, values_x, &ml_value);
+  NameMLValMap feeds{{"X", ml_value}};
+  const std::vector<std::string> output_names{"Y"};
+
+  SessionOptions so;
+  so.session_logid = "RunDeadline";
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  RunOptions run_options;
+  ASSERT_STATUS_OK(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigDeadlineMs, "60000"));
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session.Run(run_options, feeds, output_names, &fetches));
+  VerifyOutputs(fetches, {3, 1}, {4.0f, 10.0f, 16.0f});
+  // the deadline only applies during the run
+  EXPECT_EQ(concurrency::ThreadPool::CurrentDeadline(), std::chrono::steady_clock::time_point::max());
+
+  // a nanosecond passes before the first node runs
+  RunOptions missed_run_options;
+  ASSERT_STATUS_OK(missed_run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigDeadlineMs, "0.000001"));
+  fetches.clear();
+  ASSERT_STATUS_NOT_OK_AND_HAS_SUBSTR(session.Run(missed_run_options, feeds, output_names, &fetches),
+                                      "run deadline being exceeded");
+
+  // a deadline set by the caller applies as well
+  {
+    concurrency::ThreadPool::ScopedDeadline deadline(std::chrono::steady_clock::now());
+    fetches.clear();
+    ASSERT_STATUS_NOT_OK_AND_HAS_SUBSTR(session.Run(run_options, feeds, output_names, &fetches),
+                                        "run deadline being exceeded");
+  }
+
+  RunOptions invalid_run_options;
+  ASSERT_STATUS_OK(invalid_run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigDeadlineMs, "0"));
+  fetches.clear();
+  ASSERT_STATUS_NOT_OK_AND_HAS_SUBSTR(session.Run(invalid_run_options, feeds, output_names, &fetches),
+                                      "Invalid run deadline");
+}
+
+TEST(InferenceSessionTests, OptimizedModelCache) {
+  const std::filesystem::path cache_dir = ORT_TSTR("optimized_model_cache_test");
+  std::filesystem::remove_all(cache_dir);
+
+  SessionOptions so;
+  so.session_logid = "OptimizedModelCache";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                                    PathToUTF8String(cache_dir.native()).c_str()));
+
+  std::vector<int64_t> dims_x = {3, 2};
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims_x, values_x, &ml_value);
+  NameMLValMap feeds{{"X", ml_value}};
+  const std::vector<std::string> output_names{"Y"};
+
+  // Returns true if the graph transformers ran, i.e. the model was not loaded from the cache
+  auto run_session = [&](const SessionOptions& session_options,
+                         const std::string& transformer_name = "DummyTransformer") {
+    InferenceSession session{session_options, GetEnvironment()};
+    auto transformer = std::make_unique<DummyGraphTransformer>(transformer_name);
+    const auto* transformer_ptr = transformer.get();
+    EXPECT_STATUS_OK(session.RegisterGraphTransformer(std::move(transformer), TransformerLevel::Level1));
+    EXPECT_STATUS_OK(session.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+    EXPECT_STATUS_OK(session.Initialize());
+
+    std::vector<OrtValue> fetches;
+    EXPECT_STATUS_OK(session.Run(RunOptions{}, feeds, output_names, &fetches));
+    VerifyOutputs(fetches, {3, 1}, {4.0f, 10.0f, 16.0f});
+    return transformer_ptr->IsTransformerInvoked();
+  };
+
+  auto cache_files = [&]() {
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+      files.push_back(entry.path());
+    }
+    return files;
+  };
+
+  // The first session optimizes the model and writes it to the cache
+  ASSERT_TRUE(run_session(so));
+  auto files = cache_files();
+  ASSERT_EQ(files.size(), 1u);
+
+  // The second session loads the optimized model from the cache
+  ASSERT_FALSE(run_session(so));
+
+  // Other session options that affect the optimizations use another cache file
+  SessionOptions so_basic = so;
+  so_basic.graph_optimization_level = TransformerLevel::Level1;
+  ASSERT_TRUE(run_session(so_basic));
+  ASSERT_EQ(cache_files().size(), 2u);
+
+  // So do other graph transformers registered by the application
+  ASSERT_TRUE(run_session(so, "OtherDummyTransformer"));
+  ASSERT_EQ(cache_files().size(), 3u);
+  ASSERT_FALSE(run_session(so, "OtherDummyTransformer"));
+
+  // A corrupt cache file is ignored and replaced
+  {
+    std::ofstream stream(files[0], std::ios::binary | std::ios::trunc);
+    stream << "not an ORT format model";
+  }
+  ASSERT_TRUE(run_session(so));
+  ASSERT_FALSE(run_session(so));
+
+  std::filesystem::remove_all(cache_dir);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
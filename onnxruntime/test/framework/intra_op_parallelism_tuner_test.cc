@@ -0,0 +1,191 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "core/framework/content_hasher.h"
+#include "core/framework/intra_op_parallelism_tuner.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/test_environment.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+constexpr uint64_t kKey = 1234;
+constexpr NodeIndex kNodeIndex = 7;
+constexpr uint64_t kShapeHash = 5678;
+
+// Runs the candidate measured by the next run with the given execution time and returns its setting.
+IntraOpParallelismTuner::Setting Measure(IntraOpParallelismTuner& tuner, int expected_candidate,
+                                         double microseconds) {
+  int candidate = -1;
+  const auto setting = tuner.Begin(kKey, kNodeIndex, kShapeHash, candidate);
+  EXPECT_EQ(candidate, expected_candidate);
+  tuner.End(kKey, candidate, microseconds);
+  return setting;
+}
+
+void ExpectSetting(const IntraOpParallelismTuner::Setting& setting, int num_threads, double block_size_scale) {
+  EXPECT_EQ(setting.num_threads, num_threads);
+  EXPECT_EQ(setting.block_size_scale, block_size_scale);
+}
+
+void ExpectTuned(IntraOpParallelismTuner& tuner, int num_threads, double block_size_scale) {
+  int candidate = 0;
+  ExpectSetting(tuner.Begin(kKey, kNodeIndex, kShapeHash, candidate), num_threads, block_size_scale);
+  EXPECT_EQ(candidate, -1);
+  EXPECT_EQ(tuner.NumTuned(), 1u);
+  EXPECT_EQ(tuner.NumTuning(), 0u);
+}
+
+}  // namespace
+
+// All threads are measured first, then 1, 2, ... threads below the maximum, then the block size scales at the fastest
+// thread limit. Each candidate is measured three times and its fastest run counts.
+TEST(IntraOpParallelismTunerTest, MeasuresThreadLimitsThenBlockSizes) {
+  IntraOpParallelismTuner tuner(PathString(), 1, 4);
+
+  ExpectSetting(Measure(tuner, 0, 500.0), 0, 1.0);
+  Measure(tuner, 0, 100.0);
+  Measure(tuner, 0, 500.0);
+  EXPECT_EQ(tuner.NumTuning(), 1u);
+
+  for (int i = 0; i < 3; ++i) {
+    ExpectSetting(Measure(tuner, 1, 300.0), 1, 1.0);
+  }
+  for (int i = 0; i < 3; ++i) {
+    ExpectSetting(Measure(tuner, 2, 80.0), 2, 1.0);
+  }
+  for (int i = 0; i < 3; ++i) {
+    ExpectSetting(Measure(tuner, 3, 90.0), 2, 0.25);
+  }
+  EXPECT_EQ(tuner.NumTuned(), 0u);
+  for (int i = 0; i < 3; ++i) {
+    ExpectSetting(Measure(tuner, 4, 60.0), 2, 4.0);
+  }
+
+  ExpectTuned(tuner, 2, 4.0);
+}
+
+// The fastest run with all threads counts, so a slow first run does not prevent keeping the default.
+TEST(IntraOpParallelismTunerTest, FastKernelKeepsDefault) {
+  IntraOpParallelismTuner tuner(PathString(), 1, 4);
+
+  Measure(tuner, 0, 100.0);
+  Measure(tuner, 0, 5.0);
+  Measure(tuner, 0, 6.0);
+
+  ExpectTuned(tuner, 0, 1.0);
+}
+
+// The block size does not matter if the loops run in the calling thread only.
+TEST(IntraOpParallelismTunerTest, SingleThreadSkipsBlockSizes) {
+  IntraOpParallelismTuner tuner(PathString(), 1, 4);
+
+  for (int i = 0; i < 3; ++i) {
+    Measure(tuner, 0, 200.0);
+  }
+  for (int i = 0; i < 3; ++i) {
+    Measure(tuner, 1, 50.0);
+  }
+  for (int i = 0; i < 3; ++i) {
+    Measure(tuner, 2, 120.0);
+  }
+
+  ExpectTuned(tuner, 1, 1.0);
+}
+
+// Concurrent runs of a node measure the same candidate and count towards its runs.
+TEST(IntraOpParallelismTunerTest, ConcurrentRunsMeasureTheSameCandidate) {
+  IntraOpParallelismTuner tuner(PathString(), 1, 2);
+
+  int first = -1;
+  int second = -1;
+  tuner.Begin(kKey, kNodeIndex, kShapeHash, first);
+  tuner.Begin(kKey, kNodeIndex, kShapeHash, second);
+  EXPECT_EQ(first, 0);
+  EXPECT_EQ(second, 0);
+  tuner.End(kKey, first, 200.0);
+  tuner.End(kKey, second, 200.0);
+  Measure(tuner, 0, 200.0);
+
+  for (int i = 0; i < 3; ++i) {
+    Measure(tuner, 1, 100.0);
+  }
+
+  ExpectTuned(tuner, 1, 1.0);
+}
+
+// The tuned settings are written with the model hash, the environment and the thread count, and loaded by a tuner
+// for the same model and thread count.
+TEST(IntraOpParallelismTunerTest, SaveAndLoad) {
+  const PathString tuning_file = ORT_TSTR("intra_op_parallelism_tuner_test.txt");
+  std::filesystem::remove(tuning_file);
+  const auto& logger = DefaultLoggingManager().DefaultLogger();
+
+  {
+    IntraOpParallelismTuner tuner(tuning_file, 99, 4);
+    ASSERT_STATUS_OK(tuner.Load(logger));
+    for (int candidate = 0; candidate < 5; ++candidate) {
+      for (int i = 0; i < 3; ++i) {
+        Measure(tuner, candidate, candidate == 3 ? 10.0 : 100.0);
+      }
+    }
+    ExpectTuned(tuner, 0, 0.25);
+    ASSERT_STATUS_OK(tuner.Save(logger));
+  }
+
+  {
+    std::ifstream stream{std::filesystem::path(tuning_file)};
+    std::string magic;
+    uint64_t model_hash = 0;
+    uint64_t environment_hash = 0;
+    int max_threads = 0;
+    ASSERT_TRUE(static_cast<bool>(stream >> magic >> model_hash >> environment_hash >> max_threads));
+    EXPECT_EQ(model_hash, 99u);
+    EXPECT_EQ(environment_hash, GetCpuEnvironmentHash());
+    EXPECT_EQ(max_threads, 4);
+
+    NodeIndex node_index = 0;
+    uint64_t shape_hash = 0;
+    int num_threads = -1;
+    double block_size_scale = 0.0;
+    ASSERT_TRUE(static_cast<bool>(stream >> node_index >> shape_hash >> num_threads >> block_size_scale));
+    EXPECT_EQ(node_index, kNodeIndex);
+    EXPECT_EQ(shape_hash, kShapeHash);
+    EXPECT_EQ(num_threads, 0);
+    EXPECT_EQ(block_size_scale, 0.25);
+    EXPECT_FALSE(static_cast<bool>(stream >> node_index));
+  }
+
+  {
+    IntraOpParallelismTuner tuner(tuning_file, 99, 4);
+    ASSERT_STATUS_OK(tuner.Load(logger));
+    EXPECT_EQ(tuner.NumTuned(), 1u);
+    int candidate = 0;
+    // the key of a node is derived from its index and input shapes, see KernelScope
+    ContentHasher hasher;
+    hasher.UpdateValue(kNodeIndex);
+    hasher.UpdateValue(kShapeHash);
+    ExpectSetting(tuner.Begin(hasher.Value(), kNodeIndex, kShapeHash, candidate), 0, 0.25);
+    EXPECT_EQ(candidate, -1);
+  }
+
+  {
+    // another thread count may need other settings
+    IntraOpParallelismTuner tuner(tuning_file, 99, 8);
+    ASSERT_STATUS_OK(tuner.Load(logger));
+    EXPECT_EQ(tuner.NumTuned(), 0u);
+  }
+
+  std::filesystem::remove(tuning_file);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
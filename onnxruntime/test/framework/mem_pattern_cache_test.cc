@@ -0,0 +1,183 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+#include "core/framework/mem_pattern_planner.h"
+#include "test/framework/test_utils.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+namespace {
+MemoryPatternGroup CreatePatternGroup(const OrtDevice& device, size_t size) {
+  MemPatternPlanner planner{/*using_counters*/ false};
+  planner.TraceAllocation(0, size);
+
+  MemoryPatternGroup group;
+  group.locations.push_back(device);
+  group.patterns.push_back(planner.GenerateMemPattern());
+  return group;
+}
+
+OrtValue CreateFeed(AllocatorPtr alloc, const std::vector<int64_t>& dims) {
+  OrtValue value;
+  AllocateMLValue<float>(alloc, dims, &value);
+  return value;
+}
+}  // namespace
+
+TEST(MemoryPatternCacheTest, KeyedByShapes) {
+  auto alloc = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  const auto& device = alloc->Info().device;
+  const std::vector<int> feed_idxs{0, 1};
+
+  MemoryPatternCache cache;
+  std::vector<OrtValue> feeds_2x3{CreateFeed(alloc, {2, 3}), CreateFeed(alloc, {4})};
+  std::vector<OrtValue> feeds_3x2{CreateFeed(alloc, {3, 2}), CreateFeed(alloc, {4})};
+  std::vector<OrtValue> feeds_6{CreateFeed(alloc, {6}), CreateFeed(alloc, {4})};
+
+  EXPECT_EQ(cache.Find(feed_idxs, feeds_2x3), nullptr);
+  auto entry = cache.Insert(feed_idxs, feeds_2x3, CreatePatternGroup(device, 256), {});
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->PlannedBytes(), 256u);
+
+  // same number of elements but different shapes must not share patterns
+  EXPECT_EQ(cache.Find(feed_idxs, feeds_3x2), nullptr);
+  EXPECT_EQ(cache.Find(feed_idxs, feeds_6), nullptr);
+  EXPECT_EQ(cache.Find(feed_idxs, feeds_2x3), entry);
+
+  // an existing entry is not replaced
+  EXPECT_EQ(cache.Insert(feed_idxs, feeds_2x3, CreatePatternGroup(device, 512), {}), entry);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 3u);
+  EXPECT_EQ(stats.evictions, 0u);
+  ASSERT_EQ(stats.buckets.size(), 1u);
+  EXPECT_EQ(stats.buckets[0].shapes, "[2,3],[4]");
+  EXPECT_EQ(stats.buckets[0].planned_bytes, 256u);
+  EXPECT_EQ(stats.buckets[0].retained_bytes, 0u);
+}
+
+TEST(MemoryPatternCacheTest, EvictsLeastRecentlyUsed) {
+  auto alloc = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  const auto& device = alloc->Info().device;
+  const std::vector<int> feed_idxs{0};
+
+  MemoryPatternCache cache(2);
+  std::vector<OrtValue> feeds_a{CreateFeed(alloc, {1, 8})};
+  std::vector<OrtValue> feeds_b{CreateFeed(alloc, {1, 16})};
+  std::vector<OrtValue> feeds_c{CreateFeed(alloc, {1, 32})};
+
+  auto entry_a = cache.Insert(feed_idxs, feeds_a, CreatePatternGroup(device, 64), {});
+  cache.Insert(feed_idxs, feeds_b, CreatePatternGroup(device, 128), {});
+
+  // use a so b becomes the least recently used bucket
+  EXPECT_EQ(cache.Find(feed_idxs, feeds_a), entry_a);
+  cache.Insert(feed_idxs, feeds_c, CreatePatternGroup(device, 256), {});
+
+  EXPECT_EQ(cache.Find(feed_idxs, feeds_b), nullptr);
+  EXPECT_EQ(cache.Find(feed_idxs, feeds_a), entry_a);
+  EXPECT_NE(cache.Find(feed_idxs, feeds_c), nullptr);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.evictions, 1u);
+  ASSERT_EQ(stats.buckets.size(), 2u);
+  EXPECT_EQ(stats.buckets[0].shapes, "[1,32]");
+  EXPECT_EQ(stats.buckets[1].shapes, "[1,8]");
+}
+
+TEST(MemoryPatternCacheTest, RetainsActivationBuffers) {
+  auto alloc = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  const auto& device = alloc->Info().device;
+  const std::vector<int> feed_idxs{0};
+  std::vector<OrtValue> feeds{CreateFeed(alloc, {4, 4})};
+
+  // bounded cache: the blocks of a finished run are handed to the next run
+  {
+    MemoryPatternCache cache(4);
+    auto entry = cache.Insert(feed_idxs, feeds, CreatePatternGroup(device, 1024), {});
+
+    MemoryPatternCacheEntry::ActivationBuffers buffers;
+    EXPECT_FALSE(entry->AcquireBuffers(buffers));
+    void* block = alloc->Alloc(1024);
+    buffers[device] = BufferUniquePtr(block, BufferDeleter(alloc));
+    entry->ReleaseBuffers(std::move(buffers));
+    EXPECT_EQ(entry->RetainedBytes(), 1024u);
+    EXPECT_EQ(cache.GetStats().buckets[0].retained_bytes, 1024u);
+
+    MemoryPatternCacheEntry::ActivationBuffers reused;
+    ASSERT_TRUE(entry->AcquireBuffers(reused));
+    EXPECT_EQ(reused[device].get(), block);
+    EXPECT_EQ(entry->RetainedBytes(), 0u);
+    EXPECT_FALSE(entry->AcquireBuffers(buffers));
+    entry->ReleaseBuffers(std::move(reused));
+  }
+
+  // unbounded cache: blocks are freed at the end of each run
+  {
+    MemoryPatternCache cache;
+    auto entry = cache.Insert(feed_idxs, feeds, CreatePatternGroup(device, 1024), {});
+
+    MemoryPatternCacheEntry::ActivationBuffers buffers;
+    buffers[device] = BufferUniquePtr(alloc->Alloc(1024), BufferDeleter(alloc));
+    entry->ReleaseBuffers(std::move(buffers));
+    EXPECT_EQ(entry->RetainedBytes(), 0u);
+    EXPECT_FALSE(entry->AcquireBuffers(buffers));
+  }
+}
+
+TEST(MemoryPatternCacheTest, ReleasesRetainedBuffersOnEviction) {
+  auto alloc = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  const auto& device = alloc->Info().device;
+  const std::vector<int> feed_idxs{0};
+  std::vector<OrtValue> feeds_a{CreateFeed(alloc, {1, 8})};
+  std::vector<OrtValue> feeds_b{CreateFeed(alloc, {1, 16})};
+
+  MemoryPatternCache cache(1);
+  auto entry_a = cache.Insert(feed_idxs, feeds_a, CreatePatternGroup(device, 1024), {});
+
+  MemoryPatternCacheEntry::ActivationBuffers buffers;
+  buffers[device] = BufferUniquePtr(alloc->Alloc(1024), BufferDeleter(alloc));
+  entry_a->ReleaseBuffers(std::move(buffers));
+  EXPECT_EQ(entry_a->RetainedBytes(), 1024u);
+
+  // a run still holds entry_a, but its retained blocks are freed when the bucket is evicted
+  MemoryPatternCacheEntry::ActivationBuffers in_use;
+  in_use[device] = BufferUniquePtr(alloc->Alloc(1024), BufferDeleter(alloc));
+  cache.Insert(feed_idxs, feeds_b, CreatePatternGroup(device, 1024), {});
+  EXPECT_EQ(cache.GetStats().evictions, 1u);
+  EXPECT_EQ(entry_a->RetainedBytes(), 0u);
+  EXPECT_FALSE(entry_a->AcquireBuffers(buffers));
+
+  // the blocks of a run finishing after the eviction are freed as well
+  entry_a->ReleaseBuffers(std::move(in_use));
+  EXPECT_EQ(entry_a->RetainedBytes(), 0u);
+  EXPECT_FALSE(entry_a->AcquireBuffers(buffers));
+}
+
+TEST(MemoryPatternCacheTest, ReleasesRetainedBuffersOnDestruction) {
+  auto alloc = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  const auto& device = alloc->Info().device;
+  const std::vector<int> feed_idxs{0};
+  std::vector<OrtValue> feeds{CreateFeed(alloc, {4, 4})};
+
+  std::shared_ptr<const MemoryPatternCacheEntry> entry;
+  {
+    MemoryPatternCache cache(4);
+    entry = cache.Insert(feed_idxs, feeds, CreatePatternGroup(device, 1024), {});
+
+    MemoryPatternCacheEntry::ActivationBuffers buffers;
+    buffers[device] = BufferUniquePtr(alloc->Alloc(1024), BufferDeleter(alloc));
+    entry->ReleaseBuffers(std::move(buffers));
+    EXPECT_EQ(entry->RetainedBytes(), 1024u);
+  }
+
+  // the entry outlives the cache without keeping the blocks
+  EXPECT_EQ(entry->RetainedBytes(), 0u);
+  MemoryPatternCacheEntry::ActivationBuffers buffers;
+  EXPECT_FALSE(entry->AcquireBuffers(buffers));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
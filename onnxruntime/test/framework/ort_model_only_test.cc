@@ -557,6 +557,30 @@ TEST(OrtModelOnlyTests, LoadOrtFormatModelFromBufferNoCopyInitializersUseBuffer)
   RunOrtModel(test_info);
 }
 
+// By default the initializers of an ORT format model loaded from a file use the data in the memory mapped file
+TEST(OrtModelOnlyTests, LoadOrtFormatModelInitializersUseMappedFile) {
+  for (const bool disable_file_mapping : {false, true}) {
+    SessionOptions so;
+    so.session_logid = "LoadOrtFormatModelInitializersUseMappedFile";
+    so.graph_optimization_level = TransformerLevel::Default;  // keep the initializers of the model
+    if (disable_file_mapping) {
+      ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDisableOrtModelFileMapping, "1"));
+    }
+
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(ORT_TSTR("testdata/mnist.basic.ort")));
+    ASSERT_STATUS_OK(session_object.Initialize());
+
+    const auto& session_state = session_object.GetSessionState();
+    if (disable_file_mapping) {
+      EXPECT_EQ(session_state.GetInitializerMappedBytes(), 0u);
+      EXPECT_GT(session_state.GetInitializerCopiedBytes(), 0u);
+    } else {
+      EXPECT_GT(session_state.GetInitializerMappedBytes(), 0u);
+    }
+  }
+}
+
 // regression test for 2 issues covered by PR #17000 (internally reported issue).
 // 1) allocation planner broke in minimal build when subgraph had no nodes.
 // 2) usage of a sequence data type caused an exception due to IsSparseTensor() throwing
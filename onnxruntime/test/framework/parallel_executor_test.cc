@@ -1,9 +1,18 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
+#include "core/graph/model.h"
+#include "core/platform/threadpool.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/inference_session_wrapper.h"
 #include "test_utils.h"
 #include "core/session/inference_session.h"
 
@@ -145,5 +154,165 @@ TEST_P(ParallelExecutorThreadPoolTest, TestNullInterOpThreadPool) {
 
 INSTANTIATE_TEST_SUITE_P(ParallelExecutorThreadPoolTests, ParallelExecutorThreadPoolTest,
                          testing::Values(1, 0));
+
+#ifdef ORT_ENABLE_STREAM
+// Test kernel that adds 1 to the input and records the intra-op thread limit it runs under
+struct ThreadLimitOp {
+  static constexpr const char* OpName = "ThreadLimitOp";
+  static constexpr const char* OpDomain = "testing";
+
+  static std::atomic<int> num_runs;
+  // runs whose intra-op parallelism was capped below the size of the intra-op thread pool
+  static std::atomic<int> num_limited_runs;
+
+  static ONNX_NAMESPACE::OpSchema OpSchema() {
+    ONNX_NAMESPACE::OpSchema schema;
+    schema.SetDoc("Add 1 to the input and record the intra-op thread limit.")
+        .SetName(OpName)
+        .SetDomain(OpDomain)
+        .SinceVersion(10)
+        .Input(0, "X", "Input.", "T", OpSchema::Single)
+        .Output(0, "Y", "Input plus 1.", "T", OpSchema::Single)
+        .TypeConstraint("T", {"tensor(float)"}, "Type of the input and output")
+        .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+    return schema;
+  }
+
+  class OpKernelImpl final : public OpKernel {
+   public:
+    OpKernelImpl(const OpKernelInfo& info) : OpKernel{info} {}
+
+    Status Compute(OpKernelContext* ctx) const override {
+      const int pool_threads = concurrency::ThreadPool::NumThreadsIncludingCaller(ctx->GetOperatorThreadPool());
+      const int thread_limit = concurrency::ThreadPool::CurrentThreadLimit();
+      num_runs.fetch_add(1);
+      if (thread_limit > 0 && thread_limit < pool_threads) {
+        num_limited_runs.fetch_add(1);
+      }
+
+      // keep the branches running long enough to overlap
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+      const Tensor& X = *ctx->Input<Tensor>(0);
+      Tensor& Y = *ctx->Output(0, X.Shape());
+      const auto x = X.DataAsSpan<float>();
+      auto y = Y.MutableDataAsSpan<float>();
+      for (size_t i = 0; i < x.size(); ++i) {
+        y[i] = x[i] + 1.0f;
+      }
+      return Status::OK();
+    }
+  };
+
+  static KernelDefBuilder KernelDef() {
+    KernelDefBuilder def;
+    def.SetName(OpName)
+        .SetDomain(OpDomain)
+        .SinceVersion(10)
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .Provider(onnxruntime::kCpuExecutionProvider);
+
+    return def;
+  }
+};
+
+std::atomic<int> ThreadLimitOp::num_runs{0};
+std::atomic<int> ThreadLimitOp::num_limited_runs{0};
+
+// Independent branches run on separate CPU streams in parallel execution mode. While several streams run, their
+// kernels share the intra-op threads. The graph is Y = Sum(ThreadLimitOp(X), ..., ThreadLimitOp(X)).
+TEST(ParallelExecutor, CpuStreamsLimitIntraOpThreads) {
+  constexpr int kNumBranches = 4;
+
+  SessionOptions so;
+  so.session_logid = "ParallelExecutor.CpuStreamsLimitIntraOpThreads";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_param.thread_pool_size = kNumBranches;
+  so.intra_op_param.thread_pool_size = 4;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigParallelExecutionMaxCpuStreams,
+                                                    std::to_string(kNumBranches).c_str()));
+
+  // Both the session and the model need the custom registry
+  auto registry = std::make_shared<CustomRegistry>();
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.RegisterCustomRegistry(registry));
+  std::vector<OpSchema> schemas{ThreadLimitOp::OpSchema()};
+  ASSERT_STATUS_OK(registry->RegisterOpSet(schemas, ThreadLimitOp::OpDomain, 10, 11));
+  KernelCreateFn kernel_create_fn = [](FuncManager&, const OpKernelInfo& info, std::unique_ptr<OpKernel>& out) { out = std::make_unique<typename ThreadLimitOp::OpKernelImpl>(info); return Status::OK(); };
+  auto kernel_def = ThreadLimitOp::KernelDef();
+  ASSERT_STATUS_OK(registry->RegisterCustomKernel(kernel_def, kernel_create_fn));
+
+  IOnnxRuntimeOpSchemaRegistryList custom_schema_registries = {registry->GetOpschemaRegistry()};
+  std::unordered_map<std::string, int> domain_to_version = {{kOnnxDomain, 13}, {ThreadLimitOp::OpDomain, 10}};
+  Model model("CpuStreamsLimitIntraOpThreads", false, ModelMetaData(), PathString(), custom_schema_registries,
+              domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  NodeArg* input_arg = &graph.GetOrCreateNodeArg("X", &type);
+  std::vector<NodeArg*> sum_inputs;
+  for (int i = 0; i < kNumBranches; ++i) {
+    const std::string suffix = std::to_string(i);
+    NodeArg* output_arg = &graph.GetOrCreateNodeArg("T_" + suffix, &type);
+    graph.AddNode("branch_" + suffix, ThreadLimitOp::OpName, "", {input_arg}, {output_arg}, nullptr,
+                  ThreadLimitOp::OpDomain);
+    sum_inputs.push_back(output_arg);
+  }
+  graph.AddNode("sum", "Sum", "", sum_inputs, {&graph.GetOrCreateNodeArg("Y", &type)});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+  EXPECT_GT(session.GetSessionState().GetExecutionPlan()->execution_plan.size(), 1u)
+      << "the branches are partitioned into several streams";
+
+  const std::vector<float> x{-1.0f, 0.0f, 1.0f, 2.0f, 3.0f, 4.0f};
+  OrtValue x_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {2, 3}, x, &x_value);
+
+  ThreadLimitOp::num_runs = 0;
+  ThreadLimitOp::num_limited_runs = 0;
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session.Run(RunOptions{}, AsSpan<std::string>({"X"}), AsSpan({x_value}),
+                               AsSpan<std::string>({"Y"}), &fetches, nullptr));
+
+  ASSERT_EQ(fetches.size(), 1u);
+  const auto y = fetches[0].Get<Tensor>().DataAsSpan<float>();
+  ASSERT_EQ(y.size(), x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    EXPECT_EQ(y[i], kNumBranches * (x[i] + 1.0f)) << "at index " << i;
+  }
+
+  EXPECT_EQ(ThreadLimitOp::num_runs, kNumBranches);
+  EXPECT_GT(ThreadLimitOp::num_limited_runs, 0) << "kernels of concurrent streams are not capped";
+}
+
+// an invalid number of CPU streams fails the session initialization instead of throwing
+TEST(ParallelExecutor, InvalidMaxCpuStreams) {
+  auto registry = std::make_shared<CustomRegistry>();
+  std::vector<OpSchema> schemas{TestOp::OpSchema()};
+  ASSERT_STATUS_OK(registry->RegisterOpSet(schemas, TestOp::OpDomain, 10, 11));
+  KernelCreateFn kernel_create_fn = [](FuncManager&, const OpKernelInfo& info, std::unique_ptr<OpKernel>& out) { out = std::make_unique<typename TestOp::OpKernelImpl>(info); return Status::OK(); };
+  auto kernel_def = TestOp::KernelDef();
+  ASSERT_STATUS_OK(registry->RegisterCustomKernel(kernel_def, kernel_create_fn));
+
+  OpTester tester{"TestOp", 10, TestOp::OpDomain};
+  tester.AddCustomOpRegistry(registry);
+
+  tester.AddInput<int64_t>("action", {1}, {/*success*/ 0});
+  tester.AddOutput<int64_t>("action_out", {1}, {0});
+  onnxruntime::SessionOptions so;
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigParallelExecutionMaxCpuStreams, "many"));
+  tester.Run(so, OpTester::ExpectResult::kExpectFailure, "Invalid value for session.parallel_execution_max_cpu_streams",
+             {kTensorrtExecutionProvider}, nullptr, nullptr);
+}
+#endif
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#include "core/framework/prepacked_weights_file_cache.h"
+#include "core/graph/onnx_protobuf.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/test_environment.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+// A kernel that cannot use the cached buffers packs its weight again on every load. Adding a weight that the file
+// already holds must not make Save() rewrite the file.
+TEST(PrepackedWeightsFileCacheTest, ExistingEntryIsNotNew) {
+  const PathString cache_file = ORT_TSTR("prepacked_weights_file_cache_test.bin");
+  std::filesystem::remove(cache_file);
+  const auto& logger = DefaultLoggingManager().DefaultLogger();
+
+  std::vector<float> packed(16, 1.0f);
+  PrePackedWeights weights;
+  weights.buffers_.push_back(BufferUniquePtr(packed.data(), BufferDeleter(nullptr)));
+  weights.buffer_sizes_.push_back(packed.size() * sizeof(float));
+
+  PrepackedWeightsFileCache::WeightSignature weight{42, ONNX_NAMESPACE::TensorProto_DataType_FLOAT, 64, {4, 4}};
+
+  {
+    PrepackedWeightsFileCache cache(cache_file, 1);
+    ASSERT_STATUS_OK(cache.Load(logger));
+    cache.Add("Conv:W", weight, weights);
+    ASSERT_TRUE(cache.HasNewEntries());
+    ASSERT_STATUS_OK(cache.Save(logger));
+  }
+
+  {
+    PrepackedWeightsFileCache cache(cache_file, 1);
+    ASSERT_STATUS_OK(cache.Load(logger));
+    cache.Add("Conv:W", weight, weights);
+    EXPECT_FALSE(cache.HasNewEntries());
+
+    // a changed weight replaces the entry
+    weight.hash = 43;
+    cache.Add("Conv:W", weight, weights);
+    EXPECT_TRUE(cache.HasNewEntries());
+  }
+
+  std::filesystem::remove(cache_file);
+}
+
+// An entry whose hash matches is not used for a weight of another type, shape or size, as the hash may collide.
+TEST(PrepackedWeightsFileCacheTest, HashMatchAloneIsNotEnough) {
+  const PathString cache_file = ORT_TSTR("prepacked_weights_file_cache_hash_test.bin");
+  std::filesystem::remove(cache_file);
+  const auto& logger = DefaultLoggingManager().DefaultLogger();
+
+  std::vector<float> packed(16, 1.0f);
+  PrePackedWeights weights;
+  weights.buffers_.push_back(BufferUniquePtr(packed.data(), BufferDeleter(nullptr)));
+  weights.buffer_sizes_.push_back(packed.size() * sizeof(float));
+
+  const PrepackedWeightsFileCache::WeightSignature weight{42, ONNX_NAMESPACE::TensorProto_DataType_FLOAT, 64, {4, 4}};
+  {
+    PrepackedWeightsFileCache cache(cache_file, 1);
+    ASSERT_STATUS_OK(cache.Load(logger));
+    cache.Add("MatMul:B", weight, weights);
+    ASSERT_STATUS_OK(cache.Save(logger));
+  }
+
+  {
+    PrepackedWeightsFileCache cache(cache_file, 1);
+    ASSERT_STATUS_OK(cache.Load(logger));
+    std::vector<BufferUniquePtr> buffers;
+    std::vector<size_t> buffer_sizes;
+
+    auto other_shape = weight;
+    other_shape.shape = {2, 8};
+    EXPECT_FALSE(cache.Find("MatMul:B", other_shape, buffers, buffer_sizes));
+
+    auto other_type = weight;
+    other_type.elem_type = ONNX_NAMESPACE::TensorProto_DataType_INT32;
+    EXPECT_FALSE(cache.Find("MatMul:B", other_type, buffers, buffer_sizes));
+
+    auto other_size = weight;
+    other_size.size_in_bytes = 32;
+    EXPECT_FALSE(cache.Find("MatMul:B", other_size, buffers, buffer_sizes));
+
+    ASSERT_TRUE(cache.Find("MatMul:B", weight, buffers, buffer_sizes));
+    ASSERT_EQ(buffer_sizes.size(), 1u);
+    EXPECT_EQ(buffer_sizes[0], packed.size() * sizeof(float));
+    EXPECT_EQ(memcmp(buffers[0].get(), packed.data(), buffer_sizes[0]), 0);
+  }
+
+  std::filesystem::remove(cache_file);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -16,11 +16,13 @@
 #include "core/graph/model.h"
 #include "core/graph/op.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/session/inference_session.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/util/thread_utils.h"
 #include "gtest/gtest.h"
 #include "test/test_environment.h"
 #include "test/util/include/default_providers.h"
+#include "test/util/include/inference_session_wrapper.h"
 #include "core/optimizer/layout_transformation/layout_transformation.h"
 
 using namespace ONNX_NAMESPACE;
@@ -989,6 +991,210 @@ INSTANTIATE_TEST_SUITE_P(SessionStateTests,
                                          PrepackingTestParam{false, true},
                                          PrepackingTestParam{true, false},
                                          PrepackingTestParam{true, true}));
+
+// The weights are pre-packed in parallel on the intra-op thread pool unless parallel initialization is disabled.
+// The result must be the same in both cases.
+class SessionStateParallelInitializationTest : public testing::TestWithParam<bool> {};
+TEST_P(SessionStateParallelInitializationTest, PrePackAllNodes) {
+  const bool disable_parallel_initialization = GetParam();
+  constexpr int kNodeCount = 32;
+
+  OrtThreadPoolParams to;
+  to.thread_pool_size = 4;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+  ONNX_OPERATOR_SCHEMA(ParallelPrePackingTest)
+      .SetDoc("Faking Node for parallel PrePacking")
+      .Input(0, "Input_0", "input 0", "tensor(float)")
+      .Input(1, "Input_1", "input 1", "tensor(float)")
+      .Output(0, "output_0", "docstr for output_0.", "tensor(float)");
+
+  ExecutionProviders execution_providers;
+  auto cpu_execution_provider = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(false));
+  ASSERT_STATUS_OK(execution_providers.Add(kCpuExecutionProvider, std::move(cpu_execution_provider)));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 11;
+  Model model("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+              DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  auto& input_arg = graph.GetOrCreateNodeArg("input", &type);
+
+  // every node has its own weight, except the last two nodes that share one
+  for (int i = 0; i < kNodeCount; ++i) {
+    const std::string weight_name = "weight_" + std::to_string(std::min(i, kNodeCount - 2));
+    auto& weight_arg = graph.GetOrCreateNodeArg(weight_name, &type);
+    auto& output_arg = graph.GetOrCreateNodeArg("output_" + std::to_string(i), &type);
+    graph.AddNode("node_" + std::to_string(i), "ParallelPrePackingTest", "node", {&input_arg, &weight_arg},
+                  {&output_arg});
+
+    if (i < kNodeCount - 1) {
+      ONNX_NAMESPACE::TensorProto tensor;
+      tensor.add_dims(1);
+      tensor.add_float_data(1.0f);
+      tensor.set_data_type(TensorProto_DataType_FLOAT);
+      tensor.set_name(weight_name);
+      graph.AddInitializedTensor(tensor);
+    }
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisableParallelInitialization] =
+      disable_parallel_initialization ? "1" : "0";
+
+  SessionState session_state(graph,
+                             execution_providers,
+                             tp.get(),
+                             nullptr, /*inter_op_thread_pool*/
+                             dtm,
+                             DefaultLoggingManager().DefaultLogger(),
+                             profiler,
+                             sess_options);
+
+  KernelRegistryManager kernel_registry_manager;
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+  std::shared_ptr<KernelRegistry> kernel_registry = std::make_shared<KernelRegistry>();
+  auto kernel_def =
+      KernelDefBuilder().SetName("ParallelPrePackingTest").Provider(kCpuExecutionProvider).SinceVersion(1).Build();
+  ASSERT_STATUS_OK(kernel_registry->Register(
+      KernelCreateInfo(std::move(kernel_def),
+                       [](FuncManager&, const OpKernelInfo& info, std::unique_ptr<OpKernel>& out) -> Status {
+                         out = std::make_unique<PrePackingTestOpKernel>(info);
+                         return Status::OK();
+                       })));
+  kernel_registry_manager.RegisterKernelRegistry(kernel_registry);
+
+  PlaceAllNodesToCPUEP(graph);
+  ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                      kernel_registry_manager));
+
+  // all weights are pre-packed and released, including the shared one once both of its nodes packed it
+  ASSERT_EQ(session_state.GetNumberOfPrepacksCounter(), static_cast<size_t>(kNodeCount));
+  ASSERT_TRUE(session_state.GetConstantInitializedTensors().empty());
+
+  for (const auto& node : graph.Nodes()) {
+    const auto* kernel = static_cast<const PrePackingTestOpKernel*>(session_state.GetKernel(node.Index()));
+    ASSERT_NE(kernel, nullptr);
+    ASSERT_EQ(kernel->prepack_calls_count, 1);
+    ASSERT_EQ(reinterpret_cast<const float*>(kernel->weight_packed_.get())[0], 1.2345f);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(SessionStateTests,
+                         SessionStateParallelInitializationTest,
+                         testing::Values(false, true));
+
+// Initializes a session for a chain of MatMul and Gemm nodes of the built-in CPU registry, each with its own weights,
+// and returns the output and the number of pre-packed weights.
+static void RunParallelInitializationModel(bool disable_parallel_initialization,
+                                           std::vector<float>& output, size_t& prepacks_count) {
+  constexpr int kNodeCount = 48;
+  constexpr int64_t kRows = 8;
+  constexpr int64_t kWidth = 64;
+
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 13;
+  Model model("parallel_initialization", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+              DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kRows);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kWidth);
+
+  NodeArg* input_arg = &graph.GetOrCreateNodeArg("X", &type);
+  for (int i = 0; i < kNodeCount; ++i) {
+    const std::string suffix = std::to_string(i);
+    ONNX_NAMESPACE::TensorProto weight;
+    weight.set_name("W_" + suffix);
+    weight.set_data_type(TensorProto_DataType_FLOAT);
+    weight.add_dims(kWidth);
+    weight.add_dims(kWidth);
+    for (int64_t j = 0; j < kWidth * kWidth; ++j) {
+      weight.add_float_data(static_cast<float>((j * 37 + i * 11) % 17 - 8) / 64.0f);
+    }
+    graph.AddInitializedTensor(weight);
+
+    auto& output_arg = graph.GetOrCreateNodeArg(i == kNodeCount - 1 ? "Y" : "T_" + suffix, &type);
+    std::vector<NodeArg*> inputs{input_arg, &graph.GetOrCreateNodeArg(weight.name(), nullptr)};
+    if (i % 2 == 0) {
+      graph.AddNode("matmul_" + suffix, "MatMul", "", inputs, {&output_arg});
+    } else {
+      ONNX_NAMESPACE::TensorProto bias;
+      bias.set_name("B_" + suffix);
+      bias.set_data_type(TensorProto_DataType_FLOAT);
+      bias.add_dims(kWidth);
+      for (int64_t j = 0; j < kWidth; ++j) {
+        bias.add_float_data(static_cast<float>(j % 5) / 8.0f);
+      }
+      graph.AddInitializedTensor(bias);
+      inputs.push_back(&graph.GetOrCreateNodeArg(bias.name(), nullptr));
+      auto& gemm = graph.AddNode("gemm_" + suffix, "Gemm", "", inputs, {&output_arg});
+      gemm.AddAttribute("transB", static_cast<int64_t>(1));
+    }
+    input_arg = &output_arg;
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  SessionOptions so;
+  so.intra_op_param.thread_pool_size = 4;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDisableParallelInitialization,
+                                                    disable_parallel_initialization ? "1" : "0"));
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  std::vector<float> x(kRows * kWidth);
+  for (size_t j = 0; j < x.size(); ++j) {
+    x[j] = static_cast<float>(j % 13) / 13.0f - 0.5f;
+  }
+  OrtValue x_value;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({kRows, kWidth}), x.data(),
+                       OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator), x_value);
+
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session.Run(RunOptions{}, AsSpan<std::string>({"X"}), AsSpan({x_value}),
+                               AsSpan<std::string>({"Y"}), &fetches, nullptr));
+  ASSERT_EQ(fetches.size(), static_cast<size_t>(1));
+  const auto y = fetches[0].Get<Tensor>().DataAsSpan<float>();
+  output.assign(y.begin(), y.end());
+  prepacks_count = session.GetSessionState().GetNumberOfPrepacksCounter();
+}
+
+// The kernels of the built-in CPU registry are created and pre-pack their weights on the intra-op thread pool.
+// The session must compute the same output as a session initialized sequentially.
+TEST(SessionStateTest, ParallelInitializationMatchesSequential) {
+  std::vector<float> sequential_output;
+  size_t sequential_prepacks_count = 0;
+  ASSERT_NO_FATAL_FAILURE(RunParallelInitializationModel(true, sequential_output, sequential_prepacks_count));
+
+  std::vector<float> parallel_output;
+  size_t parallel_prepacks_count = 0;
+  ASSERT_NO_FATAL_FAILURE(RunParallelInitializationModel(false, parallel_output, parallel_prepacks_count));
+
+  EXPECT_EQ(parallel_prepacks_count, sequential_prepacks_count);
+  ASSERT_EQ(parallel_output.size(), sequential_output.size());
+  for (size_t i = 0; i < parallel_output.size(); ++i) {
+    ASSERT_EQ(parallel_output[i], sequential_output[i]) << "at index " << i;
+  }
+}
 #endif
 
 }  // namespace test
@@ -2001,6 +2001,58 @@ TEST_F(GraphTest, SetInputsAndSetOutputs_NewInputAndOutput) {
       << "expected new output sum_with_z";
 }
 
+TEST_F(GraphTest, NodeChangeLog) {
+  std::shared_ptr<Model> model;
+  {
+    ModelProto m;
+    m.set_ir_version(4);
+    ImportOpset(m, "", 10);
+    ConstructASimpleAddGraph(*m.mutable_graph(), nullptr);
+    ASSERT_STATUS_OK(Model::Load(std::move(m), model, nullptr, *logger_));
+  }
+
+  Graph& graph = model->MainGraph();
+  ASSERT_EQ(graph.NumberOfNodes(), 1);
+  const NodeIndex add_index = graph.Nodes().begin()->Index();
+
+  std::vector<NodeIndex> node_change_log;
+  graph.SetNodeChangeLog(&node_change_log);
+
+  // the edges rebuilt by Resolve are not changes
+  graph.SetGraphResolveNeeded();
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_TRUE(node_change_log.empty());
+
+  TypeProto type_proto{};
+  SetTypeAndShape(type_proto.mutable_tensor_type(), 1, {3, 4, 5});
+  auto* sum = graph.GetNodeArg("sum");
+  auto* z = &graph.GetOrCreateNodeArg("z", &type_proto);
+  auto* sum_with_z = &graph.GetOrCreateNodeArg("sum_with_z", &type_proto);
+  Node& add_z = graph.AddNode("add_z", "Add", "add z to sum", {sum, z}, {sum_with_z});
+  EXPECT_EQ(node_change_log, std::vector<NodeIndex>({add_z.Index()}));
+
+  node_change_log.clear();
+  graph.AddEdge(add_index, add_z.Index(), 0, 0);
+  EXPECT_NE(std::find(node_change_log.begin(), node_change_log.end(), add_index), node_change_log.end());
+  EXPECT_NE(std::find(node_change_log.begin(), node_change_log.end(), add_z.Index()), node_change_log.end());
+
+  node_change_log.clear();
+  add_z.MutableInputDefs()[1] = sum;
+  EXPECT_EQ(node_change_log, std::vector<NodeIndex>({add_z.Index()}));
+
+  // removing a node logs the neighbors it was connected to
+  node_change_log.clear();
+  const NodeIndex add_z_index = add_z.Index();
+  ASSERT_TRUE(graph.RemoveNode(add_z_index));
+  EXPECT_NE(std::find(node_change_log.begin(), node_change_log.end(), add_index), node_change_log.end());
+  EXPECT_NE(std::find(node_change_log.begin(), node_change_log.end(), add_z_index), node_change_log.end());
+
+  node_change_log.clear();
+  graph.SetNodeChangeLog(nullptr);
+  graph.GetNode(add_index)->AddAttribute("unused", static_cast<int64_t>(1));
+  EXPECT_TRUE(node_change_log.empty());
+}
+
 TEST_F(GraphTest, LoadModelMissingInput) {
   ModelProto m;
   m.set_ir_version(ONNX_NAMESPACE::IR_VERSION);
@@ -38,8 +38,9 @@ static const std::vector<std::string>& ArgNamesForConv(size_t rank) {
   return rank_to_args_name[rank];
 }
 
-// dummy for some strange build error when using Bench capture
-void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
+// The capture argument selects the filter handling: "packed" supplies filters
+// pre-transformed for the Winograd algorithm when MlasConvPrepare selects it.
+void SCONV_NCHW(benchmark::State& state, const char* mode) {
   const int64_t rank = state.range(0);                       // Rank
   const int64_t batch_size = state.range(1);                 // N
   const int64_t groups = state.range(2);                     // G
@@ -118,6 +119,20 @@ void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
   std::vector<float> Y(static_cast<size_t>(y_size));
   std::vector<float> working_buffer(WorkingBufferSize);
 
+  std::vector<float> packed_filter;
+  if (std::string(mode) == "packed" && Parameters.Algorithm == MlasConvAlgorithmWinograd) {
+    const size_t packed_size = MlasConvWinogradPackFilterSize(static_cast<size_t>(groups),
+                                                              static_cast<size_t>(input_channels_per_group),
+                                                              static_cast<size_t>(output_channels_per_group));
+    packed_filter.resize(packed_size / sizeof(float));
+    MlasConvWinogradPackFilter(static_cast<size_t>(groups),
+                               static_cast<size_t>(input_channels_per_group),
+                               static_cast<size_t>(output_channels_per_group),
+                               F.data(),
+                               packed_filter.data());
+    Parameters.u.Winograd.PackedFilter = packed_filter.data();
+  }
+
   // warm up first round.
   MlasConv(&Parameters,
            X.data(),
@@ -245,3 +260,24 @@ static void General_Conv2d(benchmark::internal::Benchmark* b) {
 }
 
 BENCHMARK_CAPTURE(SCONV_NCHW, 2d, "")->Apply(General_Conv2d)->UseRealTime();
+
+static void Conv3x3Stride1(benchmark::internal::Benchmark* b) {
+  b->ArgNames(ArgNamesForConv(2));
+
+  // 3x3 stride 1 layers from ResNet50 and YOLOv3, where MlasConvPrepare
+  // selects the Winograd algorithm.
+  //    Rank, N, G, Cpg, Fpg,   I,    , K, , P, , , , S, , D, ,
+  b->Args({2, 1, 1, 64, 64, 56, 56, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+  b->Args({2, 1, 1, 128, 128, 28, 28, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+  b->Args({2, 1, 1, 256, 256, 14, 14, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+  b->Args({2, 1, 1, 512, 512, 7, 7, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+  b->Args({2, 1, 1, 32, 64, 208, 208, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+  b->Args({2, 1, 1, 64, 128, 104, 104, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+  b->Args({2, 1, 1, 128, 256, 52, 52, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+  b->Args({2, 1, 1, 256, 512, 26, 26, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+  b->Args({2, 1, 1, 512, 1024, 13, 13, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+  b->Args({2, 4, 1, 64, 64, 56, 56, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+}
+
+BENCHMARK_CAPTURE(SCONV_NCHW, Conv3x3Stride1, "")->Apply(Conv3x3Stride1)->UseRealTime();
+BENCHMARK_CAPTURE(SCONV_NCHW, Conv3x3Stride1Packed, "packed")->Apply(Conv3x3Stride1)->UseRealTime();
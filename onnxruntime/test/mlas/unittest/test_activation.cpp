@@ -204,7 +204,8 @@ class MlasActivationTest : public MlasTestBase {
     MLAS_ACTIVATION Activation;
     AliasedValue Buffer[_countof(TestData)];
 
-    for (unsigned kind = 0; kind < unsigned(MlasActivationKindCount); kind++) {
+    // The gated activations (Gelu, FastGelu, Silu) are covered by the GEMM epilogue test.
+    for (unsigned kind = 0; kind <= unsigned(MlasHardSigmoidActivation); kind++) {
       Activation.ActivationKind = MLAS_ACTIVATION_KIND(kind);
 
       if (Activation.ActivationKind == MlasLeakyReluActivation) {
@@ -12,10 +12,26 @@ static size_t Conv2dRegistLongExecute() {
   return count;
 }
 
+//
+// Grouped, batched and asymmetrically padded convolutions with channel counts
+// that are not aligned to the NCHWc block size, so these are not shared with
+// the NCHWc tests.
+//
+template <bool Threaded>
+static size_t Conv2dRegistGroupedShortExecute() {
+  size_t count = 0;
+  for (unsigned i = 1; i < 256; i <<= 1) {
+    count += Conv2dShortExecuteTest<MlasConv2DTest<Threaded>>::RegisterSingleTest(2, 2, 24, i, i + 3, 20, 3, 3, 1, 2, 0, 1, 1, 1, 1, 1);
+  }
+  return count;
+}
+
 static size_t Conv2dRegistShortExecute() {
   size_t count = Conv2dShortExecuteTest<MlasConv2DTest<false>>::RegisterShortExecuteTests();
+  count += Conv2dRegistGroupedShortExecute<false>();
   if (GetMlasThreadPool() != nullptr) {
     count += Conv2dShortExecuteTest<MlasConv2DTest<true>>::RegisterShortExecuteTests();
+    count += Conv2dRegistGroupedShortExecute<true>();
   }
   return count;
 }
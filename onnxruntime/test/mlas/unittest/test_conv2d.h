@@ -60,6 +60,8 @@ class MlasConv2DTest : public MlasTestBase {
                     0.0f,
                     threadpool_);
 
+    UsedWinograd_ = (Parameters.Algorithm == MlasConvAlgorithmWinograd);
+
     MlasConv(&Parameters,
              Input,
              Filter,
@@ -157,6 +159,10 @@ class MlasConv2DTest : public MlasTestBase {
 
   MLAS_THREADPOOL* threadpool_;
 
+  // The Winograd algorithm reorders the floating point operations, so its
+  // results are compared with a tolerance instead of exactly.
+  bool UsedWinograd_ = false;
+
  public:
   static const char* GetTestSuiteName() {
     static const std::string suite_name(Threaded ? "Conv2d_Threaded" : "Conv2d_SingleThread");
@@ -215,6 +221,8 @@ class MlasConv2DTest : public MlasTestBase {
     float* Output = BufferOutput.GetBuffer(OutputElements);
     float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
 
+    UsedWinograd_ = false;
+
     MlasConv2D(BatchCount,
                GroupCount,
                InputChannels,
@@ -246,6 +254,21 @@ class MlasConv2DTest : public MlasTestBase {
                     Bias,
                     OutputReference);
 
+    if (UsedWinograd_) {
+      for (size_t i = 0; i < OutputElements; i++) {
+        ASSERT_TRUE(CloseEnough(Output[i], OutputReference[i]))
+            << "@" << i << " of " << OutputElements << ", got: " << Output[i] << ", expecting: " << OutputReference[i]
+            << ", B" << BatchCount << "/"
+            << "G" << GroupCount << "/"
+            << "Cpg" << InputChannels << "/"
+            << "Fpg" << FilterCount << "/"
+            << "H" << InputHeight << "/"
+            << "W" << InputWidth << "/"
+            << "Pad" << PaddingLeftHeight << "," << PaddingLeftWidth << "," << PaddingRightHeight << "," << PaddingRightWidth;
+      }
+      return;
+    }
+
     ASSERT_EQ(memcmp(Output, OutputReference, OutputElements * sizeof(float)), 0)
         << "B" << BatchCount << "/"
         << "G" << GroupCount << "/"
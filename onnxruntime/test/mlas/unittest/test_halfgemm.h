@@ -105,20 +105,21 @@ class MlasHalfGemmTest : public MlasTestBase {
                       const BType* B,
                       const MLFp16* Bias,
                       float* C) {
-    // TODO!! deal with half precision accumulation error
-    // Most CPUs does not support mixed precision accumulation,
-    // only mul & add fuse. As a result, different striding
-    // on the K dimension may lead to rounding error.
-    // Accumulation of these rounding error maybe very significant.
-    // So setting a approximation ratio does NOT work.
+    // The kernels round C to half precision at the end of each K stride.
+    // The ARM64 kernel also accumulates in half precision within a stride,
+    // while the x64 kernel accumulates in single precision, and runs over
+    // all of K at once when A and B are both half precision. The test
+    // values are multiples of 1/16, so single precision sums are exact and
+    // the oracle can follow either kernel exactly.
     //
-    // Currently this test require a manual efforts:
-    // 1. Change the K stride of the kernel under test to be 16;
-    // 2. Force the K stride of the fp16 kernel to 16
-    // 3. Change the test oracle to be exact match.
-    // 4. Pass this test and then change it back :-(.
+    // N.B. Changing the K stride of a kernel requires changing KStride.
     //
     constexpr size_t KStride = 512;
+#if defined(MLAS_TARGET_ARM64)
+    constexpr bool AccumulateInHalf = true;
+#else
+    constexpr bool AccumulateInHalf = false;
+#endif
 
     for (size_t batch = 0; batch < BatchSize; batch++) {
       for (size_t m = 0; m < M; m++) {
@@ -132,14 +133,19 @@ class MlasHalfGemmTest : public MlasTestBase {
             if (k == 0 && Bias != nullptr) {
               sum = float(Bias[n]);
             }
+            if (!AccumulateInHalf && k != 0) {
+              sum = *c;
+            }
             for (size_t kk = 0; kk < std::min(KStride, K - k); kk++) {
-              MLFp16 down(float(*b) * float(*a) + sum);
-              sum = float(down);
+              sum += float(*b) * float(*a);
+              if (AccumulateInHalf) {
+                sum = float(MLFp16(sum));
+              }
               b += N;
               a += 1;
             }
-            if (k == 0) {
-              *c = sum;
+            if (k == 0 || !AccumulateInHalf) {
+              *c = float(MLFp16(sum));
             } else {
               MLFp16 d(sum + *c);
               *c = float(d);
@@ -0,0 +1,206 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_fp16.h"
+
+template <typename T, bool Threaded>
+class MlasLayerNormTest : public MlasTestBase {
+ private:
+  // MLFp16 has the layout of MLAS_FP16.
+  using MlasType = std::conditional_t<std::is_same_v<T, float>, float, MLAS_FP16>;
+
+  MatrixGuardBuffer<T> BufferInput;
+  MatrixGuardBuffer<T> BufferSkip;
+  MatrixGuardBuffer<T> BufferBias;
+  MatrixGuardBuffer<T> BufferScale;
+  MatrixGuardBuffer<T> BufferShift;
+  MatrixGuardBuffer<T> BufferOutput;
+  MatrixGuardBuffer<T> BufferSumOutput;
+  MatrixGuardBuffer<int8_t> BufferQuantizedOutput;
+  MatrixGuardBuffer<float> BufferInputFloat;
+  MatrixGuardBuffer<float> BufferSkipFloat;
+  MatrixGuardBuffer<float> BufferBiasFloat;
+  MatrixGuardBuffer<float> BufferScaleFloat;
+  MatrixGuardBuffer<float> BufferShiftFloat;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferSumOutputReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  static float ToFloat(T Value) {
+    if constexpr (std::is_same_v<T, float>) {
+      return Value;
+    } else {
+      return Value.ToFloat();
+    }
+  }
+
+  // Fills the buffer of the tested type and a float copy holding the same values.
+  template <typename Generator>
+  static void Fill(T* Buffer, float* BufferFloat, size_t Count, Generator&& generator) {
+    for (size_t i = 0; i < Count; i++) {
+      Buffer[i] = T(generator());
+      BufferFloat[i] = ToFloat(Buffer[i]);
+    }
+  }
+
+  void Test(size_t N, size_t D, size_t SkipRows, bool Simplified) {
+    T* Input = BufferInput.GetBuffer(N * D);
+    T* Skip = BufferSkip.GetBuffer(SkipRows * D);
+    T* Bias = BufferBias.GetBuffer(D);
+    T* Scale = BufferScale.GetBuffer(D);
+    T* Shift = BufferShift.GetBuffer(D);
+    T* Output = BufferOutput.GetBuffer(N * D);
+    T* SumOutput = BufferSumOutput.GetBuffer(N * D);
+    int8_t* QuantizedOutput = BufferQuantizedOutput.GetBuffer(N * D);
+    float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+    float* SumOutputReference = BufferSumOutputReference.GetBuffer(N * D);
+
+    std::default_random_engine generator(static_cast<unsigned>(N * D + SkipRows));
+    std::uniform_real_distribution<float> distribution(-2.0f, 3.0f);
+    auto next = [&]() { return distribution(generator); };
+
+    float* InputFloat = BufferInputFloat.GetBuffer(N * D);
+    float* SkipFloat = BufferSkipFloat.GetBuffer(SkipRows * D);
+    float* BiasFloat = BufferBiasFloat.GetBuffer(D);
+    float* ScaleFloat = BufferScaleFloat.GetBuffer(D);
+    float* ShiftFloat = BufferShiftFloat.GetBuffer(D);
+    Fill(Input, InputFloat, N * D, next);
+    Fill(Skip, SkipFloat, SkipRows * D, next);
+    Fill(Bias, BiasFloat, D, next);
+    Fill(Scale, ScaleFloat, D, next);
+    Fill(Shift, ShiftFloat, D, next);
+
+    MLAS_LAYER_NORM_PARAMS<MlasType> Params;
+    Params.Input = reinterpret_cast<const MlasType*>(Input);
+    Params.Skip = SkipRows != 0 ? reinterpret_cast<const MlasType*>(Skip) : nullptr;
+    Params.SkipRows = SkipRows;
+    Params.Bias = SkipRows != 0 ? reinterpret_cast<const MlasType*>(Bias) : nullptr;
+    Params.Scale = reinterpret_cast<const MlasType*>(Scale);
+    Params.Shift = Simplified ? nullptr : reinterpret_cast<const MlasType*>(Shift);
+    Params.Output = reinterpret_cast<MlasType*>(Output);
+    Params.SumOutput = SkipRows != 0 ? reinterpret_cast<MlasType*>(SumOutput) : nullptr;
+    Params.QuantizedOutput = QuantizedOutput;
+    Params.QuantizedScale = 0.05f;
+    Params.QuantizedZeroPoint = 3;
+    Params.Epsilon = 1e-5f;
+
+    if (Simplified) {
+      MlasRmsNorm(Params, N, D, threadpool_);
+    } else {
+      MlasLayerNorm(Params, N, D, threadpool_);
+    }
+
+    MLAS_LAYER_NORM_PARAMS<float> ReferenceParams;
+    ReferenceParams.Input = InputFloat;
+    ReferenceParams.Skip = SkipRows != 0 ? SkipFloat : nullptr;
+    ReferenceParams.SkipRows = SkipRows;
+    ReferenceParams.Bias = SkipRows != 0 ? BiasFloat : nullptr;
+    ReferenceParams.Scale = ScaleFloat;
+    ReferenceParams.Shift = Simplified ? nullptr : ShiftFloat;
+    ReferenceParams.Epsilon = Params.Epsilon;
+
+    ReferenceLayerNorm(ReferenceParams, SumOutputReference, OutputReference, N, D, Simplified);
+
+    // Half precision outputs are rounded to 11 significant bits.
+    constexpr bool IsFloat = std::is_same_v<T, float>;
+    constexpr float AbsoluteTolerance = IsFloat ? 1e-4f : 2e-3f;
+    constexpr float RelativeTolerance = IsFloat ? 1e-4f : 2e-3f;
+
+    for (size_t nd = 0; nd < N * D; nd++) {
+      float diff = std::fabs(ToFloat(Output[nd]) - OutputReference[nd]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[nd]) * RelativeTolerance)
+          << "Simplified:" << (int)Simplified << " SkipRows:" << SkipRows << " difference " << N << "/" << D
+          << ", got: " << ToFloat(Output[nd]) << ", expecting: " << OutputReference[nd];
+
+      if (Params.SumOutput != nullptr) {
+        ASSERT_EQ(ToFloat(SumOutput[nd]), ToFloat(T(SumOutputReference[nd])))
+            << " sum output " << N << "/" << D << " @" << nd;
+      }
+
+      // Allow a rounding difference for values that fall close to a quantization step.
+      float q = std::nearbyint(OutputReference[nd] / Params.QuantizedScale) + Params.QuantizedZeroPoint;
+      q = std::min(std::max(q, -128.0f), 127.0f);
+      ASSERT_LE(std::fabs(float(QuantizedOutput[nd]) - q), 1.0f)
+          << " quantized output " << N << "/" << D << " @" << nd
+          << ", got: " << int(QuantizedOutput[nd]) << ", expecting: " << q;
+    }
+  }
+
+  void ReferenceLayerNorm(const MLAS_LAYER_NORM_PARAMS<float>& Params, float* SumOutput, float* Output,
+                          size_t N, size_t D, bool Simplified) {
+    for (size_t n = 0; n < N; n++) {
+      const float* Input = Params.Input + n * D;
+      float* Sum = SumOutput + n * D;
+
+      for (size_t d = 0; d < D; d++) {
+        float Value = Input[d];
+        if (Params.Skip != nullptr) {
+          Value += Params.Skip[(n % Params.SkipRows) * D + d];
+        }
+        if (Params.Bias != nullptr) {
+          Value += Params.Bias[d];
+        }
+        Sum[d] = Value;
+      }
+
+      double Mean = 0.0;
+      if (!Simplified) {
+        for (size_t d = 0; d < D; d++) {
+          Mean += Sum[d];
+        }
+        Mean /= double(D);
+      }
+
+      double Variance = 0.0;
+      for (size_t d = 0; d < D; d++) {
+        double Centered = Sum[d] - Mean;
+        Variance += Centered * Centered;
+      }
+      Variance /= double(D);
+
+      const double InvStdDev = 1.0 / std::sqrt(Variance + Params.Epsilon);
+
+      for (size_t d = 0; d < D; d++) {
+        double Value = (Sum[d] - Mean) * InvStdDev * Params.Scale[d];
+        if (Params.Shift != nullptr) {
+          Value += Params.Shift[d];
+        }
+        Output[n * D + d] = float(Value);
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::string(std::is_same_v<T, float> ? "LayerNorm" : "LayerNormFp16") +
+                                        (Threaded ? "_Threaded" : "_SingleThread"));
+    return suite_name.c_str();
+  }
+
+  MlasLayerNormTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (size_t d = 1; d < 70; d++) {
+      Test(2, d, 0, false);
+      Test(2, d, 0, true);
+    }
+
+    Test(3, 768, 3, false);
+    Test(5, 1024, 1, true);
+    Test(17, 300, 17, false);
+    Test(64, 257, 8, true);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasLayerNormTest<float, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasLayerNormTest<MLFp16, false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasLayerNormTest<float, true>>::RegisterShortExecute();
+      count += MlasDirectShortExecuteTests<MlasLayerNormTest<MLFp16, true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
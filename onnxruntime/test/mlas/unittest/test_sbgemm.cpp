@@ -15,10 +15,10 @@ Abstract:
 
 --*/
 
-#if defined(__aarch64__) && defined(__linux__)
-
 #include "test_sbgemm.h"
 
+#if defined(MLAS_SUPPORTS_SBGEMM)
+
 //
 // Short Execute() test helper to register each test separately by all parameters.
 //
@@ -76,8 +76,15 @@ class SBGemmShortExecuteTest : public MlasTestFixture<MlasSBGemmTest<AType, BTyp
         test_registered += RegisterSingleTest(1, 32, b, 5, false);
       }
     }
-    // TODO: check why the cosine similarly is < 0.99 for this shape alone
-    // test_registered += RegisterSingleTest(43, 500, 401, 1, true);
+    // Row and column tails of the 32x32 AMX tile blocks and of the x64 kernels, odd K that leaves the last bf16
+    // pair half filled, and K spanning several 256 element strides.
+    for (size_t m : {31, 32, 33, 65}) {
+      for (size_t n : {15, 32, 49}) {
+        test_registered += RegisterSingleTest(m, n, 33, 1, (m + n) % 2 == 0);
+        test_registered += RegisterSingleTest(m, n, 531, 1, (m + n) % 2 != 0);
+      }
+    }
+    test_registered += RegisterSingleTest(43, 500, 401, 1, true);
     test_registered += RegisterSingleTest(1001, 1027, 1031, 1, false);
     if (!Packed) {
       test_registered += RegisterSingleTest(43, 500, 401, 5, true);
@@ -129,13 +136,20 @@ static size_t SBGemmRegistShortExecute() {
 }
 
 static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+#if defined(MLAS_TARGET_AMD64)
+  // x64 machines without bf16 support run the AVX2 emulation of the kernels
+  if (MlasSBGemmPackBSize(128, 128) == 0) {
+    return false;
+  }
+#else
   if (!MlasBf16AccelerationSupported()) {
     return false;
   }
+#endif
 
   if (is_short_execute) {
     return SBGemmRegistShortExecute() > 0;
   }
   return SBGemmRegistLongExecute() > 0;
 });
-#endif  // defined(__aarch64__) && defined(__linux__)
+#endif  // defined(MLAS_SUPPORTS_SBGEMM)
@@ -0,0 +1,164 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasSgemmEpilogueTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferResidual;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MatrixGuardBuffer<int8_t> BufferQuantizedC;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t M, size_t N, size_t K, MLAS_ACTIVATION_KIND ActivationKind, bool UseBias, bool UseResidual,
+            CBLAS_TRANSPOSE TransA = CblasNoTrans, bool PackB = false) {
+    std::default_random_engine generator(static_cast<unsigned>(M * N * K));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    auto fill = [&](float* start, size_t size) {
+      for (size_t i = 0; i < size; i++) {
+        start[i] = distribution(generator);
+      }
+    };
+
+    const float* A = BufferA.GetFilledBuffer(M * K, fill);
+    const float* B = BufferB.GetFilledBuffer(K * N, fill);
+    const float* Bias = BufferBias.GetFilledBuffer(N, fill);
+    const float* Residual = BufferResidual.GetFilledBuffer(M * N, fill);
+    float* C = BufferC.GetBuffer(M * N, true);
+    float* CReference = BufferCReference.GetBuffer(M * N, true);
+    int8_t* QuantizedC = BufferQuantizedC.GetBuffer(M * N, true);
+
+    MLAS_SGEMM_EPILOGUE Epilogue;
+    Epilogue.Bias = UseBias ? Bias : nullptr;
+    Epilogue.Activation.ActivationKind = ActivationKind;
+    if (ActivationKind == MlasClipActivation) {
+      Epilogue.Activation.Parameters.Clip.minimum = -1.0f;
+      Epilogue.Activation.Parameters.Clip.maximum = 2.0f;
+    } else if (ActivationKind == MlasSiluActivation) {
+      Epilogue.Activation.Parameters.Silu.alpha = 1.702f;
+    }
+    Epilogue.Residual = UseResidual ? Residual : nullptr;
+    Epilogue.QuantizedOutput = QuantizedC;
+    Epilogue.QuantizedScale = 0.125f;
+    Epilogue.QuantizedZeroPoint = -5;
+
+    MLAS_SGEMM_EPILOGUE_PROCESSOR Processor(Epilogue);
+
+    MLAS_SGEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = (TransA == CblasNoTrans) ? K : M;
+    Data.B = B;
+    Data.ldb = N;
+    if (PackB) {
+      void* PackedB = BufferBPacked.GetBuffer(MlasGemmPackBSize(N, K), true);
+      MlasGemmPackB(CblasNoTrans, N, K, B, N, PackedB);
+      Data.B = static_cast<const float*>(PackedB);
+      Data.BIsPacked = true;
+    }
+    Data.C = C;
+    Data.ldc = N;
+    Data.OutputProcessor = &Processor;
+
+    MlasGemm(TransA, CblasNoTrans, M, N, K, Data, threadpool_);
+
+    ReferenceSgemmEpilogue(TransA, M, N, K, A, B, Epilogue, CReference);
+
+    for (size_t mn = 0; mn < M * N; mn++) {
+      const float diff = std::fabs(C[mn] - CReference[mn]);
+      ASSERT_TRUE(diff <= 1e-4f || diff <= std::fabs(CReference[mn]) * 1e-4f)
+          << "ActivationKind:" << int(ActivationKind) << " Bias:" << UseBias << " Residual:" << UseResidual
+          << " TransA:" << (TransA != CblasNoTrans) << " PackB:" << PackB
+          << " @[" << mn / N << "," << mn % N << "], M=" << M << ", N=" << N << ", K=" << K
+          << ", got: " << C[mn] << ", expecting: " << CReference[mn];
+
+      // Allow a rounding difference for values that fall close to a quantization step.
+      float q = std::nearbyint(CReference[mn] / Epilogue.QuantizedScale) + Epilogue.QuantizedZeroPoint;
+      q = std::min(std::max(q, -128.0f), 127.0f);
+      ASSERT_LE(std::fabs(float(QuantizedC[mn]) - q), 1.0f)
+          << " quantized output @[" << mn / N << "," << mn % N << "], M=" << M << ", N=" << N << ", K=" << K;
+    }
+  }
+
+  static float ReferenceActivation(const MLAS_ACTIVATION& Activation, float Value) {
+    switch (Activation.ActivationKind) {
+      case MlasReluActivation:
+        return std::max(Value, 0.0f);
+      case MlasClipActivation:
+        return std::min(std::max(Value, Activation.Parameters.Clip.minimum), Activation.Parameters.Clip.maximum);
+      case MlasGeluActivation:
+        return Value * 0.5f * (1.0f + std::erf(Value * 0.70710678118654752f));
+      case MlasFastGeluActivation:
+        return Value * 0.5f * (1.0f + std::tanh(0.79788456080286536f * (Value + 0.044715f * Value * Value * Value)));
+      case MlasSiluActivation:
+        return Value / (1.0f + std::exp(-Activation.Parameters.Silu.alpha * Value));
+      default:
+        return Value;
+    }
+  }
+
+  static void ReferenceSgemmEpilogue(CBLAS_TRANSPOSE TransA, size_t M, size_t N, size_t K, const float* A,
+                                     const float* B, const MLAS_SGEMM_EPILOGUE& Epilogue, float* C) {
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double sum = 0.0;
+        for (size_t k = 0; k < K; k++) {
+          const float a = (TransA == CblasNoTrans) ? A[m * K + k] : A[k * M + m];
+          sum += double(a) * double(B[k * N + n]);
+        }
+        float value = float(sum);
+        if (Epilogue.Bias != nullptr) {
+          value += Epilogue.Bias[n];
+        }
+        value = ReferenceActivation(Epilogue.Activation, value);
+        if (Epilogue.Residual != nullptr) {
+          value += Epilogue.Residual[m * N + n];
+        }
+        C[m * N + n] = value;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "SgemmEpilogue_Threaded" : "SgemmEpilogue_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasSgemmEpilogueTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    static const MLAS_ACTIVATION_KIND kinds[] = {MlasIdentityActivation, MlasReluActivation, MlasClipActivation,
+                                                 MlasGeluActivation, MlasFastGeluActivation, MlasSiluActivation};
+
+    for (MLAS_ACTIVATION_KIND kind : kinds) {
+      Test(1, 37, 16, kind, true, false);
+      Test(5, 300, 24, kind, true, true);
+      Test(67, 129, 33, kind, false, true);
+      Test(128, 64, 300, kind, true, true);
+    }
+
+    // Cover the transposed A, packed B, single column and empty K paths.
+    Test(67, 300, 150, MlasGeluActivation, true, true, CblasTrans);
+    Test(67, 300, 150, MlasGeluActivation, true, true, CblasNoTrans, true);
+    Test(19, 129, 300, MlasReluActivation, true, true, CblasTrans, true);
+    Test(33, 1, 40, MlasReluActivation, true, true);
+    Test(7, 20, 0, MlasClipActivation, true, true);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmEpilogueTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSgemmEpilogueTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
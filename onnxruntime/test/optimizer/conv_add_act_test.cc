@@ -45,6 +45,11 @@ TEST(ConvAddActivationFusionTests, ConvExpandThenGemm) {
   TestConvPath({1, 16, 5, 5}, {16, 16, 3, 3}, {1, 16, 3, 3}, 1);
 }
 
+TEST(ConvAddActivationFusionTests, ConvWinograd) {
+  // hit MlasConvAlgorithmWinograd
+  TestConvPath({1, 16, 10, 10}, {16, 16, 3, 3}, {1, 16, 8, 8}, 1);
+}
+
 TEST(ConvAddActivationFusionTests, ConvDepthwise) {
   // MlasConvAlgorithmDepthwise or MlasConvAlgorithmExpandThenGemmSegmented
   TestConvPath({1, 16, 5, 5}, {16, 1, 3, 3}, {1, 16, 3, 3}, 16);
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "graph_transform_test_builder.h"
+
+#include "core/graph/graph.h"
+#include "core/optimizer/elementwise_fusion.h"
+
+namespace onnxruntime {
+namespace test {
+
+#ifndef DISABLE_CONTRIB_OPS
+
+// Tanh(X * scale + bias) * X collapses into a single node that reads X once per element.
+TEST(ElementwiseFusionTests, BroadcastChain) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 8, 130}, -2.f, 2.f);
+    auto* scale_arg = builder.MakeInitializer<float>({130}, -1.f, 1.f);
+    auto* bias_arg = builder.MakeScalarInitializer<float>(0.25f);
+    auto* mul_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* tanh_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Mul", {input_arg, scale_arg}, {mul_out});
+    builder.AddNode("Add", {mul_out, bias_arg}, {add_out});
+    builder.AddNode("Tanh", {add_out}, {tanh_out});
+    builder.AddNode("Mul", {tanh_out, input_arg}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["Mul"], 0);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["Tanh"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level3, 13,
+                    1e-5, 1e-5, std::make_unique<ElementwiseFusion>());
+}
+
+// A per-channel scale and bias of an NCHW tensor broadcast along the leading and the trailing dims.
+TEST(ElementwiseFusionTests, PerChannelBroadcast) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 6, 9, 11}, -2.f, 2.f);
+    auto* scale_arg = builder.MakeInitializer<float>({6, 1, 1}, -1.f, 1.f);
+    auto* bias_arg = builder.MakeInitializer<float>({6, 1, 1}, -1.f, 1.f);
+    auto* mul_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Mul", {input_arg, scale_arg}, {mul_out});
+    builder.AddNode("Add", {mul_out, bias_arg}, {add_out});
+    builder.AddNode("Relu", {add_out}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["Mul"], 0);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["Relu"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level3, 13,
+                    1e-5, 1e-5, std::make_unique<ElementwiseFusion>());
+}
+
+// The Neg, whose output is smaller than the output of the group, stays outside the fused node. The fused Add then
+// reads two inputs that are both broadcast.
+TEST(ElementwiseFusionTests, BroadcastInputsOnly) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({3, 1}, -2.f, 2.f);
+    auto* other_arg = builder.MakeInput<float>({1, 4}, -2.f, 2.f);
+    auto* neg_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Neg", {input_arg}, {neg_out});
+    builder.AddNode("Add", {neg_out, other_arg}, {add_out});
+    builder.AddNode("Relu", {add_out}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["Neg"], 1);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["Relu"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level3, 13,
+                    1e-5, 1e-5, std::make_unique<ElementwiseFusion>());
+}
+
+// A value that is also a graph output must stay materialized, which leaves nothing to fuse.
+TEST(ElementwiseFusionTests, IntermediateGraphOutput) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({4, 16}, -2.f, 2.f);
+    auto* other_arg = builder.MakeInput<float>({4, 16}, -2.f, 2.f);
+    auto* add_out = builder.MakeOutput();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Add", {input_arg, other_arg}, {add_out});
+    builder.AddNode("Sigmoid", {add_out}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 0);
+    EXPECT_EQ(op_to_count["Add"], 1);
+    EXPECT_EQ(op_to_count["Sigmoid"], 1);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level3, 13,
+                    1e-5, 1e-5, std::make_unique<ElementwiseFusion>());
+}
+
+#endif  // DISABLE_CONTRIB_OPS
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -7735,5 +7735,39 @@ TEST_F(GraphTransformationTests, MatMulNBitsBiasFusion) {
 
 #endif  // !defined(DISABLE_CONTRIB_OPS)
 
+// The worklist mode only revisits the nodes around the changes of the previous transformers after the first step, and
+// must produce the same graph as applying every transformer to the whole graph in every step.
+TEST_F(GraphTransformationTests, WorklistModeMatchesFullGraphSteps) {
+  auto optimize = [this](bool worklist_mode, std::map<std::string, int>& op_to_count) {
+    constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/gpt2_one_layer.onnx";
+    std::shared_ptr<Model> p_model;
+    ASSERT_STATUS_OK(Model::Load(model_uri, p_model, nullptr, *logger_));
+    Graph& graph = p_model->MainGraph();
+    for (auto& node : graph.Nodes()) {
+      node.SetExecutionProviderType(kCpuExecutionProvider);
+    }
+
+    SessionOptions session_options;
+    CPUExecutionProvider cpu_ep(CPUExecutionProviderInfo{});
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{10};
+    graph_transformation_mgr.SetWorklistMode(worklist_mode);
+    for (auto level : {TransformerLevel::Level1, TransformerLevel::Level2}) {
+      for (auto& transformer : optimizer_utils::GenerateTransformers(level, session_options, cpu_ep)) {
+        ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(transformer), level));
+      }
+      ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, level, *logger_));
+    }
+
+    op_to_count = CountOpsInGraph(graph);
+  };
+
+  std::map<std::string, int> expected_op_to_count;
+  optimize(false, expected_op_to_count);
+  std::map<std::string, int> op_to_count;
+  optimize(true, op_to_count);
+
+  EXPECT_EQ(op_to_count, expected_op_to_count);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,176 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "graph_transform_test_builder.h"
+
+#include "core/graph/graph.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/optimizer/matmul_activation_fusion.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+#ifndef DISABLE_CONTRIB_OPS
+
+// MatMul + BiasGelu + Add of a residual becomes a single FusedMatMulActivation with bias and residual inputs.
+TEST(MatMulActivationFusionTests, BiasGeluResidual) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 8, 32}, -1.f, 1.f);
+    auto* residual_arg = builder.MakeInput<float>({2, 8, 48}, -1.f, 1.f);
+    auto* weight_arg = builder.MakeInitializer<float>({32, 48}, -0.5f, 0.5f);
+    auto* bias_arg = builder.MakeInitializer<float>({48}, -0.5f, 0.5f);
+    auto* matmul_out = builder.MakeIntermediate();
+    auto* gelu_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("MatMul", {input_arg, weight_arg}, {matmul_out});
+    builder.AddNode("BiasGelu", {matmul_out, bias_arg}, {gelu_out}, kMSDomain);
+    builder.AddNode("Add", {residual_arg, gelu_out}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedMatMulActivation"], 1);
+    EXPECT_EQ(op_to_count["MatMul"], 0);
+    EXPECT_EQ(op_to_count["com.microsoft.BiasGelu"], 0);
+    EXPECT_EQ(op_to_count["Add"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13,
+                    1e-5, 1e-5, std::make_unique<MatMulActivationFusion>());
+}
+
+// The attributes of the activation are carried over with an "activation_" prefix.
+TEST(MatMulActivationFusionTests, BiasLeakyRelu) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({3, 5, 40}, -1.f, 1.f);
+    auto* weight_arg = builder.MakeInitializer<float>({40, 130}, -0.5f, 0.5f);
+    auto* bias_arg = builder.MakeInitializer<float>({130}, -0.5f, 0.5f);
+    auto* matmul_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("MatMul", {input_arg, weight_arg}, {matmul_out});
+    builder.AddNode("Add", {matmul_out, bias_arg}, {add_out});
+    Node& leaky_relu = builder.AddNode("LeakyRelu", {add_out}, {output_arg});
+    leaky_relu.AddAttribute("alpha", 0.3f);
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedMatMulActivation"], 1);
+    EXPECT_EQ(op_to_count["MatMul"], 0);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["LeakyRelu"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13,
+                    1e-5, 1e-5, std::make_unique<MatMulActivationFusion>());
+}
+
+// A Clip with constant bounds is fused, with the bounds carried by activation_alpha and activation_beta.
+TEST(MatMulActivationFusionTests, BiasClip) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 8, 32}, -1.f, 1.f);
+    auto* weight_arg = builder.MakeInitializer<float>({32, 48}, -0.5f, 0.5f);
+    auto* bias_arg = builder.MakeInitializer<float>({48}, -0.5f, 0.5f);
+    auto* min_arg = builder.MakeScalarInitializer<float>(-0.25f);
+    auto* max_arg = builder.MakeScalarInitializer<float>(0.5f);
+    auto* matmul_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("MatMul", {input_arg, weight_arg}, {matmul_out});
+    builder.AddNode("Add", {matmul_out, bias_arg}, {add_out});
+    builder.AddNode("Clip", {add_out, min_arg, max_arg}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedMatMulActivation"], 1);
+    EXPECT_EQ(op_to_count["MatMul"], 0);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["Clip"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13,
+                    1e-5, 1e-5, std::make_unique<MatMulActivationFusion>());
+}
+
+// A bias that broadcasts along the rows instead of the columns is not supported by the epilogue.
+TEST(MatMulActivationFusionTests, RowBias) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 8, 32}, -1.f, 1.f);
+    auto* weight_arg = builder.MakeInitializer<float>({32, 48}, -0.5f, 0.5f);
+    auto* bias_arg = builder.MakeInitializer<float>({8, 1}, -0.5f, 0.5f);
+    auto* matmul_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("MatMul", {input_arg, weight_arg}, {matmul_out});
+    builder.AddNode("Add", {matmul_out, bias_arg}, {add_out});
+    builder.AddNode("Relu", {add_out}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedMatMulActivation"], 0);
+    EXPECT_EQ(op_to_count["MatMul"], 1);
+    EXPECT_EQ(op_to_count["Add"], 1);
+    EXPECT_EQ(op_to_count["Relu"], 1);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13,
+                    1e-5, 1e-5, std::make_unique<MatMulActivationFusion>());
+}
+
+#if defined(MLAS_SUPPORTS_SBGEMM)
+// With the bf16 fastmath mode the fused node must still run the sbgemm kernels. The unfused MatMul of the baseline
+// rounds its inputs to bf16, so a fused node that fell back to the fp32 GEMM would differ by far more than the
+// tolerance.
+TEST(MatMulActivationFusionTests, BiasReluFastMath) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({3, 5, 64}, -1.f, 1.f);
+    auto* weight_arg = builder.MakeInitializer<float>({64, 48}, -1.f, 1.f);
+    auto* bias_arg = builder.MakeInitializer<float>({48}, -0.5f, 0.5f);
+    auto* matmul_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("MatMul", {input_arg, weight_arg}, {matmul_out});
+    builder.AddNode("Add", {matmul_out, bias_arg}, {add_out});
+    builder.AddNode("Relu", {add_out}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedMatMulActivation"], 1);
+    EXPECT_EQ(op_to_count["MatMul"], 0);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["Relu"], 0);
+  };
+
+  auto add_session_options = [](SessionOptions& so) {
+#if defined(MLAS_TARGET_AMD64)
+    // also run the AVX2 emulation of the bf16 kernels on machines without bf16 support
+    constexpr const char* fast_math_mode = "2";
+#else
+    constexpr const char* fast_math_mode = "1";
+#endif
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasGemmFastMathBfloat16, fast_math_mode));
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13,
+                    1e-5, 1e-5, std::make_unique<MatMulActivationFusion>(), add_session_options);
+}
+#endif  // defined(MLAS_SUPPORTS_SBGEMM)
+
+#endif  // DISABLE_CONTRIB_OPS
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -672,4 +672,228 @@ TEST(ThreadPoolTest, TestDefaultAffinity) {
 #endif
 #endif
 
+namespace {
+// Environment that reports two NUMA nodes with logical processors [0, 4) on node 0 and [4, 8) on node 1.
+// Threads are created without affinity so the test does not depend on the topology of the machine.
+struct FakeNumaEnv {
+  using EnvThread = onnxruntime::EnvThread;
+
+  EnvThread* CreateThread(const ORTCHAR_T* name_prefix, int index,
+                          unsigned (*start_address)(int id, Eigen::ThreadPoolInterface* param),
+                          Eigen::ThreadPoolInterface* threadpool, const ThreadOptions& thread_options) {
+    ThreadOptions options_without_affinity = thread_options;
+    options_without_affinity.affinities.clear();
+    return Env::Default().CreateThread(name_prefix, index, start_address, threadpool, options_without_affinity);
+  }
+
+  int GetNumaNodeOfLogicalProcessor(int logical_processor_id) const {
+    return logical_processor_id / 4;
+  }
+};
+}  // namespace
+
+TEST(ThreadPoolTest, TestNumaAwareScheduling) {
+  constexpr int num_threads = 6;
+  FakeNumaEnv env;
+  ThreadOptions thread_options;
+  thread_options.numa_aware = true;
+  for (int i = 0; i < num_threads; ++i) {
+    thread_options.affinities.push_back(LogicalProcessors{i + 1});
+  }
+
+  ThreadPoolTempl<FakeNumaEnv> tp(nullptr, num_threads, true, env, thread_options);
+  ASSERT_EQ(tp.NumNumaDomains(), 2u);
+
+  for (int rep = 0; rep < 5; rep++) {
+    auto test_data = CreateTestData(num_threads + 1);
+    tp.RunInParallel([&](unsigned idx) { IncrementElement(*test_data, idx); }, num_threads + 1, 0);
+    ValidateTestData(*test_data);
+
+    // work scheduled from outside the pool is spread over both nodes and must be picked up by stealing
+    constexpr int num_tasks = 64;
+    auto scheduled_data = CreateTestData(num_tasks);
+    onnxruntime::Barrier b(num_tasks);
+    for (int i = 0; i < num_tasks; i++) {
+      tp.Schedule([&, i]() {
+        IncrementElement(*scheduled_data, i);
+        b.Notify();
+      });
+    }
+    b.Wait();
+    ValidateTestData(*scheduled_data);
+  }
+}
+
+TEST(ThreadPoolTest, TestNumaAwareSchedulingSingleNode) {
+  constexpr int num_threads = 3;
+  FakeNumaEnv env;
+  ThreadOptions thread_options;
+  thread_options.numa_aware = true;
+  for (int i = 0; i < num_threads; ++i) {
+    thread_options.affinities.push_back(LogicalProcessors{i});
+  }
+
+  ThreadPoolTempl<FakeNumaEnv> tp(nullptr, num_threads, true, env, thread_options);
+  EXPECT_EQ(tp.NumNumaDomains(), 1u);
+
+  auto test_data = CreateTestData(num_threads + 1);
+  tp.RunInParallel([&](unsigned idx) { IncrementElement(*test_data, idx); }, num_threads + 1, 0);
+  ValidateTestData(*test_data);
+}
+
+TEST(ThreadPoolTest, TestStats) {
+  constexpr int num_threads = 4;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr,
+                                         num_threads + 1, true);
+  ThreadPoolStats stats = tp->GetStats();
+  EXPECT_EQ(stats.num_threads, num_threads);
+  EXPECT_TRUE(stats.allow_spinning);
+  EXPECT_EQ(stats.tasks_scheduled, 0u);
+
+  constexpr int num_tasks = 64;
+  auto test_data = CreateTestData(num_tasks);
+  onnxruntime::Barrier b(num_tasks);
+  for (int i = 0; i < num_tasks; i++) {
+    ThreadPool::Schedule(tp.get(), [&, i]() {
+      IncrementElement(*test_data, i);
+      b.Notify();
+    });
+  }
+  b.Wait();
+  ValidateTestData(*test_data);
+
+  stats = tp->GetStats();
+  EXPECT_EQ(stats.tasks_scheduled, static_cast<uint64_t>(num_tasks));
+  uint64_t histogram_total = 0;
+  for (auto count : stats.queue_depth_histogram) {
+    histogram_total += count;
+  }
+  EXPECT_EQ(histogram_total, stats.tasks_scheduled);
+
+  // the parallel loop adds tasks for the other threads
+  auto loop_data = CreateTestData(num_threads + 1);
+  ThreadPool::TrySimpleParallelFor(tp.get(), num_threads + 1,
+                                   [&](std::ptrdiff_t i) { IncrementElement(*loop_data, i); });
+  ValidateTestData(*loop_data);
+  EXPECT_GT(tp->GetStats().tasks_scheduled, stats.tasks_scheduled);
+
+  // no threads, no counters
+  ThreadPool single_thread_tp(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 1, true);
+  EXPECT_EQ(single_thread_tp.GetStats().num_threads, 0);
+}
+
+TEST(ThreadPoolTest, TestHighPriorityWorkRunsFirst) {
+  // a single worker, so that the order in which the tasks run is the order in which the worker pops them
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 2, true);
+  EXPECT_EQ(ThreadPool::CurrentPriority(), ThreadPool::Priority::kNormal);
+
+  std::atomic<bool> blocker_started{false};
+  std::atomic<bool> release_blocker{false};
+  onnxruntime::OrtMutex mutex;
+  std::vector<int> order;
+  constexpr int num_tasks = 4;
+  onnxruntime::Barrier b(2 * num_tasks + 1);
+
+  ThreadPool::Schedule(tp.get(), [&]() {
+    blocker_started = true;
+    while (!release_blocker) {
+      onnxruntime::concurrency::SpinPause();
+    }
+    b.Notify();
+  });
+  while (!blocker_started) {
+    onnxruntime::concurrency::SpinPause();
+  }
+
+  auto schedule_tasks = [&](int first) {
+    for (int i = first; i < first + num_tasks; i++) {
+      ThreadPool::Schedule(tp.get(), [&, i]() {
+        {
+          std::lock_guard<onnxruntime::OrtMutex> lock(mutex);
+          order.push_back(i);
+        }
+        b.Notify();
+      });
+    }
+  };
+  schedule_tasks(0);
+  {
+    ThreadPool::ScopedPriority priority(ThreadPool::Priority::kHigh);
+    EXPECT_EQ(ThreadPool::CurrentPriority(), ThreadPool::Priority::kHigh);
+    schedule_tasks(num_tasks);
+  }
+  EXPECT_EQ(ThreadPool::CurrentPriority(), ThreadPool::Priority::kNormal);
+
+  release_blocker = true;
+  b.Wait();
+  ASSERT_EQ(order.size(), static_cast<size_t>(2 * num_tasks));
+  for (int i = 0; i < num_tasks; i++) {
+    EXPECT_GE(order[i], num_tasks) << "normal task ran before the high priority tasks";
+  }
+
+  // parallel loops of high priority callers
+  ThreadPool::ScopedPriority priority(ThreadPool::Priority::kHigh);
+  auto test_data = CreateTestData(100);
+  ThreadPool::TrySimpleParallelFor(tp.get(), 100, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+  ValidateTestData(*test_data);
+}
+
+TEST(ThreadPoolTest, TestScopedDeadline) {
+  using Clock = std::chrono::steady_clock;
+  EXPECT_EQ(ThreadPool::CurrentDeadline(), Clock::time_point::max());
+  EXPECT_FALSE(ThreadPool::DeadlinePassed());
+
+  const auto later = Clock::now() + std::chrono::hours(1);
+  {
+    ThreadPool::ScopedDeadline deadline(later);
+    EXPECT_EQ(ThreadPool::CurrentDeadline(), later);
+    EXPECT_FALSE(ThreadPool::DeadlinePassed());
+    {
+      // the earliest deadline applies
+      ThreadPool::ScopedDeadline later_deadline(later + std::chrono::hours(1));
+      EXPECT_EQ(ThreadPool::CurrentDeadline(), later);
+      ThreadPool::ScopedDeadline passed_deadline(Clock::now());
+      EXPECT_TRUE(ThreadPool::DeadlinePassed());
+    }
+    EXPECT_EQ(ThreadPool::CurrentDeadline(), later);
+  }
+  EXPECT_EQ(ThreadPool::CurrentDeadline(), Clock::time_point::max());
+
+  // the workers running a parallel loop see the deadline of the caller
+  constexpr int num_threads = 4;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr,
+                                         num_threads + 1, true);
+  constexpr int num_iterations = 100;
+  std::atomic<int> with_deadline{0};
+  {
+    ThreadPool::ScopedDeadline deadline(later);
+    ThreadPool::TrySimpleParallelFor(tp.get(), num_iterations, [&](std::ptrdiff_t) {
+      if (ThreadPool::CurrentDeadline() == later) {
+        ++with_deadline;
+      }
+    });
+  }
+  EXPECT_EQ(with_deadline.load(), num_iterations);
+
+  std::atomic<int> passed{0};
+  {
+    ThreadPool::ScopedDeadline deadline(Clock::now());
+    ThreadPool::TrySimpleParallelFor(tp.get(), num_iterations, [&](std::ptrdiff_t) {
+      if (ThreadPool::DeadlinePassed()) {
+        ++passed;
+      }
+    });
+  }
+  EXPECT_EQ(passed.load(), num_iterations);
+
+  // the workers do not keep the deadline after the loop
+  std::atomic<int> without_deadline{0};
+  ThreadPool::TrySimpleParallelFor(tp.get(), num_iterations, [&](std::ptrdiff_t) {
+    if (ThreadPool::CurrentDeadline() == Clock::time_point::max()) {
+      ++without_deadline;
+    }
+  });
+  EXPECT_EQ(without_deadline.load(), num_iterations);
+}
+
 }  // namespace onnxruntime
@@ -9,15 +9,25 @@
 #include "test/common/dnnl_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
 #include "test/common/tensor_op_test_utils.h"
+#include "test/common/random_generator.h"
 #include "default_providers.h"
 
-#if defined(__aarch64__) && defined(__linux__)
+#include "core/mlas/inc/mlas.h"
+
+#if defined(MLAS_SUPPORTS_SBGEMM)
 
 namespace onnxruntime {
 namespace test {
 
 namespace {
 
+#if defined(MLAS_TARGET_AMD64)
+// also run the AVX2 emulation of the bf16 kernels on machines without bf16 support
+constexpr const char* kFastMathEnabled = "2";
+#else
+constexpr const char* kFastMathEnabled = "1";
+#endif
+
 const onnxruntime::RunOptions run_options = []() {
   onnxruntime::RunOptions options{};
   ORT_THROW_IF_ERROR(options.config_options.AddConfigEntry(kOpTesterRunOptionsConfigTestTunableOp, "true"));
@@ -145,7 +155,7 @@ void RunMatMulTest(int32_t opset_version, bool is_a_constant, bool is_b_constant
 
     SessionOptions so;
     ASSERT_STATUS_OK(so.config_options.AddConfigEntry(
-        kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16, "1"));
+        kOrtSessionOptionsMlasGemmFastMathBfloat16, kFastMathEnabled));
 
     test.ConfigExcludeEps(excluded_providers)
         .Config(run_with_tunable_op)
@@ -154,7 +164,7 @@ void RunMatMulTest(int32_t opset_version, bool is_a_constant, bool is_b_constant
 
     if (disable_fastmath) {
       ASSERT_STATUS_OK(so.config_options.AddConfigEntry(
-          kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16, "0"));
+          kOrtSessionOptionsMlasGemmFastMathBfloat16, "0"));
 
       test.ConfigExcludeEps(excluded_providers)
           .Config(run_with_tunable_op)
@@ -237,7 +247,7 @@ TEST(MathOpTest, MatMulSharedPrepackedWeights_FastMath) {
   // Set up B as a shared initializer to be shared between sessions
   ASSERT_EQ(so.AddInitializer("B", &b), Status::OK());
   ASSERT_STATUS_OK(so.config_options.AddConfigEntry(
-      kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16, "1"));
+      kOrtSessionOptionsMlasGemmFastMathBfloat16, kFastMathEnabled));
 
   // We want all sessions running using this OpTester to be able to share pre-packed weights if applicable
   test.EnableSharingOfPrePackedWeightsAcrossSessions();
@@ -295,6 +305,120 @@ TEST(MathOpTest, MatMulSharedPrepackedWeights_FastMath) {
 
 #endif
 
+// The tests above use small integers, which bfloat16 represents exactly. The tests below use random values, so the
+// results of the bfloat16 kernels are compared with an fp32 reference with a tolerance.
+constexpr float kFastMathTolerance = 0.05f;
+
+// Computes A * B + beta * C for a row major A (M x K), a B (K x N, or N x K if trans_b) and a C broadcast to
+// M x N.
+static std::vector<float> ReferenceGemm(const std::vector<float>& a, const std::vector<float>& b, bool trans_b,
+                                        const std::vector<float>* c, const std::vector<int64_t>& c_dims,
+                                        float beta, int64_t M, int64_t N, int64_t K) {
+  std::vector<float> y(static_cast<size_t>(M * N));
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += a[m * K + k] * (trans_b ? b[n * K + k] : b[k * N + n]);
+      }
+      if (c != nullptr) {
+        const int64_t c_rows = c_dims.size() == 2 ? c_dims[0] : 1;
+        const int64_t c_cols = c_dims.empty() ? 1 : c_dims.back();
+        sum += beta * (*c)[(c_rows == 1 ? 0 : m) * c_cols + (c_cols == 1 ? 0 : n)];
+      }
+      y[m * N + n] = sum;
+    }
+  }
+  return y;
+}
+
+static SessionOptions FastMathSessionOptions() {
+  SessionOptions so;
+  ORT_THROW_IF_ERROR(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasGemmFastMathBfloat16, kFastMathEnabled));
+  return so;
+}
+
+static std::vector<std::unique_ptr<IExecutionProvider>> FastMathExecutionProviders() {
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  return execution_providers;
+}
+
+TEST(MathOpTest, MatMulFloatTypeRandom_FastMath) {
+  constexpr int64_t M = 15, N = 48, K = 64;
+  const std::vector<int64_t> a_dims{3, 5, K};
+  const std::vector<int64_t> b_dims{K, N};
+  RandomValueGenerator random{};
+  const std::vector<float> a = random.Uniform<float>(a_dims, -1.0f, 1.0f);
+  const std::vector<float> b = random.Uniform<float>(b_dims, -1.0f, 1.0f);
+
+  OpTester test("MatMul", 13);
+  test.AddInput<float>("A", a_dims, a);
+  test.AddInput<float>("B", b_dims, b, true);
+  test.AddOutput<float>("Y", {3, 5, N}, ReferenceGemm(a, b, false, nullptr, {}, 0.0f, M, N, K));
+  test.SetOutputTolerance(kFastMathTolerance);
+
+  test.Config(FastMathSessionOptions())
+      .ConfigEps(FastMathExecutionProviders())
+      .RunWithConfig();
+}
+
+struct GemmFastMathTestCase {
+  std::string name;
+  int64_t M, N, K;
+  bool trans_b;
+  std::vector<int64_t> c_dims;  // ignored if !has_c
+  bool has_c;
+  float beta;
+};
+
+static void RunGemmFastMathTest(const GemmFastMathTestCase& t) {
+  SCOPED_TRACE("test case: " + t.name);
+
+  RandomValueGenerator random{};
+  const std::vector<int64_t> a_dims{t.M, t.K};
+  const std::vector<int64_t> b_dims = t.trans_b ? std::vector<int64_t>{t.N, t.K} : std::vector<int64_t>{t.K, t.N};
+  const std::vector<float> a = random.Uniform<float>(a_dims, -1.0f, 1.0f);
+  const std::vector<float> b = random.Uniform<float>(b_dims, -1.0f, 1.0f);
+  const std::vector<float> c = random.Uniform<float>(t.c_dims, -1.0f, 1.0f);
+
+  OpTester test("Gemm", 13);
+  test.AddAttribute("transB", static_cast<int64_t>(t.trans_b ? 1 : 0));
+  test.AddAttribute("beta", t.beta);
+  test.AddInput<float>("A", a_dims, a);
+  // B has to be an initializer to be pre-packed to bfloat16
+  test.AddInput<float>("B", b_dims, b, true);
+  if (t.has_c) {
+    test.AddInput<float>("C", t.c_dims, c);
+  }
+  test.AddOutput<float>("Y", {t.M, t.N},
+                        ReferenceGemm(a, b, t.trans_b, t.has_c ? &c : nullptr, t.c_dims, t.beta, t.M, t.N, t.K));
+  test.SetOutputTolerance(kFastMathTolerance);
+
+  test.Config(FastMathSessionOptions())
+      .ConfigEps(FastMathExecutionProviders())
+      .RunWithConfig();
+}
+
+TEST(MathOpTest, GemmFloatType_FastMath) {
+  const std::vector<GemmFastMathTestCase> test_cases{
+      {"no bias", 7, 40, 64, false, {}, false, 1.0f},
+      {"transposed B", 7, 40, 64, true, {}, false, 1.0f},
+      {"bias (N)", 33, 40, 64, false, {40}, true, 1.0f},
+      {"bias (1, N)", 33, 40, 64, true, {1, 40}, true, 1.0f},
+      {"bias (N) with beta", 9, 40, 64, false, {40}, true, 0.5f},
+      {"bias (M, 1)", 9, 40, 64, false, {9, 1}, true, 1.0f},
+      {"bias (M, N)", 9, 40, 64, false, {9, 40}, true, 2.0f},
+      {"scalar bias", 9, 40, 64, false, {}, true, 1.0f},
+      {"scalar bias with N = 1", 9, 1, 64, false, {}, true, 1.0f},
+      {"bias (1) with N = 1", 9, 1, 64, false, {1}, true, 1.0f},
+  };
+
+  for (const auto& t : test_cases) {
+    RunGemmFastMathTest(t);
+  }
+}
+
 // Dummy run to disable the FastMath mode for the current session
 TEST(MathOpTest, MatMulUint64Type_DisableFastMath) {
   RunMatMulTest<uint64_t>(9, false, false, true);
@@ -302,4 +426,4 @@ TEST(MathOpTest, MatMulUint64Type_DisableFastMath) {
 
 }  // namespace test
 }  // namespace onnxruntime
-#endif  // defined(__aarch64__) && defined(__linux__)
+#endif  // defined(MLAS_SUPPORTS_SBGEMM)
@@ -8,6 +8,7 @@
 #include "test/common/cuda_op_test_utils.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "default_providers.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 namespace test {
@@ -273,6 +274,44 @@ TEST(MathOpTest, MatMul_Float16) {
 }
 #endif
 
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED) || defined(MLAS_TARGET_AMD64)
+TEST(MathOpTest, MatMul_Float16_Cpu) {
+  if (!MlasFp16AccelerationSupported()) {
+    GTEST_SKIP() << "CPU does not support fp16 acceleration";
+  }
+
+  // A is broadcast over the batch of B, and N spans both the vectorized and the remainder columns.
+  constexpr int64_t M = 3, K = 5, N = 19, batch = 2;
+  std::vector<float> A(M * K);
+  std::vector<float> B(batch * K * N);
+  for (size_t i = 0; i < A.size(); i++) {
+    A[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+  }
+  for (size_t i = 0; i < B.size(); i++) {
+    B[i] = static_cast<float>(static_cast<int>(i % 5) - 2);
+  }
+  std::vector<float> Y(batch * M * N, 0.0f);
+  for (int64_t b = 0; b < batch; b++) {
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t n = 0; n < N; n++) {
+        for (int64_t k = 0; k < K; k++) {
+          Y[(b * M + m) * N + n] += A[m * K + k] * B[(b * K + k) * N + n];
+        }
+      }
+    }
+  }
+
+  OpTester test("MatMul", 13);
+  test.AddInput<MLFloat16>("A", {M, K}, FloatsToMLFloat16s(A));
+  test.AddInput<MLFloat16>("B", {batch, K, N}, FloatsToMLFloat16s(B), true);
+  test.AddOutput<MLFloat16>("Y", {batch, M, N}, FloatsToMLFloat16s(Y));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+#endif
+
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DNNL)
 TEST(MathOpTest, MatMul_bfloat16) {
 #ifdef USE_CUDA
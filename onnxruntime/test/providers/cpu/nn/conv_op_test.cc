@@ -2,7 +2,9 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "test/common/random_generator.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
 using namespace std;
 namespace onnxruntime {
 namespace test {
@@ -979,5 +981,97 @@ TEST(ConvTest, Conv_AutoPad_with_non_default_strides) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true);
 }
 
+#ifndef ENABLE_TRAINING
+// Direct 3x3 convolution with unit strides and dilations used as the reference for the Winograd tests.
+static vector<float> ReferenceConv3x3(const vector<float>& X, const vector<float>& W,
+                                      int64_t C, int64_t M, int64_t H, int64_t W_in, int64_t pad) {
+  const int64_t out_h = H + 2 * pad - 2;
+  const int64_t out_w = W_in + 2 * pad - 2;
+  vector<float> Y(static_cast<size_t>(M * out_h * out_w), 0.0f);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t oh = 0; oh < out_h; oh++) {
+      for (int64_t ow = 0; ow < out_w; ow++) {
+        float sum = 0.0f;
+        for (int64_t c = 0; c < C; c++) {
+          for (int64_t kh = 0; kh < 3; kh++) {
+            for (int64_t kw = 0; kw < 3; kw++) {
+              const int64_t ih = oh + kh - pad;
+              const int64_t iw = ow + kw - pad;
+              if (ih >= 0 && ih < H && iw >= 0 && iw < W_in) {
+                sum += X[(c * H + ih) * W_in + iw] * W[((m * C + c) * 3 + kh) * 3 + kw];
+              }
+            }
+          }
+        }
+        Y[(m * out_h + oh) * out_w + ow] = sum;
+      }
+    }
+  }
+  return Y;
+}
+
+// Runs a 3x3 convolution with a constant filter wide enough for the Winograd algorithm in two sessions that share
+// pre-packed weights, and returns the number of weights pre-packed by the first session.
+static size_t RunWinogradConvTest(int64_t H, int64_t W_in, int64_t pad) {
+  constexpr int64_t C = 16;
+  constexpr int64_t M = 24;
+  const vector<int64_t> X_shape{1, C, H, W_in};
+  const vector<int64_t> W_shape{M, C, 3, 3};
+  RandomValueGenerator random{};
+  const vector<float> X = random.Uniform<float>(X_shape, -1.0f, 1.0f);
+  const vector<float> W = random.Uniform<float>(W_shape, -0.5f, 0.5f);
+  const vector<float> Y = ReferenceConv3x3(X, W, C, M, H, W_in, pad);
+
+  OpTester test("Conv", 11);
+  test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+  test.AddAttribute("pads", vector<int64_t>{pad, pad, pad, pad});
+  test.AddInput<float>("X", X_shape, X);
+  test.AddInput<float>("W", W_shape, W, true);
+  test.AddOutput<float>("Y", {1, M, H + 2 * pad - 2, W_in + 2 * pad - 2}, Y);
+  test.SetOutputTolerance(1e-4f);
+
+  OrtValue w;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape(W_shape), const_cast<float*>(W.data()),
+                       OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator), w);
+  SessionOptions so;
+  EXPECT_EQ(so.AddInitializer("W", &w), Status::OK());
+  test.EnableSharingOfPrePackedWeightsAcrossSessions();
+
+  auto cpu_ep = []() -> std::vector<std::unique_ptr<IExecutionProvider>> {
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    return execution_providers;
+  };
+
+  size_t number_of_pre_packed_weights_counter_session_1 = 0;
+  size_t number_of_shared_pre_packed_weights_counter = 0;
+  test.Config(so)
+      .ConfigEps(cpu_ep())
+      .RunWithConfig(&number_of_pre_packed_weights_counter_session_1, &number_of_shared_pre_packed_weights_counter);
+  EXPECT_EQ(number_of_shared_pre_packed_weights_counter, static_cast<size_t>(0));
+
+  // The second session uses the transformed filter of the first one.
+  size_t number_of_pre_packed_weights_counter_session_2 = 0;
+  test.Config(so)
+      .ConfigEps(cpu_ep())
+      .RunWithConfig(&number_of_pre_packed_weights_counter_session_2, &number_of_shared_pre_packed_weights_counter);
+  EXPECT_EQ(number_of_pre_packed_weights_counter_session_2, number_of_pre_packed_weights_counter_session_1);
+  EXPECT_EQ(number_of_shared_pre_packed_weights_counter, number_of_pre_packed_weights_counter_session_1);
+
+  return number_of_pre_packed_weights_counter_session_1;
+}
+
+TEST(ConvTest, Conv2D_WinogradPrePacked) {
+  // The 10x10 output is large enough for the Winograd algorithm, so the original filter is replaced.
+  EXPECT_EQ(RunWinogradConvTest(/*H*/ 10, /*W*/ 10, /*pad*/ 1), static_cast<size_t>(1));
+}
+
+TEST(ConvTest, Conv2D_WinogradSmallOutput) {
+  // MlasConvPrepare selects another algorithm for the 4x4 output, which needs the original filter.
+  EXPECT_EQ(RunWinogradConvTest(/*H*/ 6, /*W*/ 6, /*pad*/ 0), static_cast<size_t>(0));
+}
+
+#endif  // ENABLE_TRAINING
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -4402,6 +4402,190 @@ TEST(CApiTest, RunAsyncFail) {
   EXPECT_THROW(session.RunAsync(run_options, input_names, input_tensors, 1, output_names, output_values, 1, CallbackFail, nullptr), std::exception);
 }
 
+struct DynamicBatchingRequest {
+  float x_value[3];
+  std::atomic_bool done{false};
+};
+
+void CallbackDynamicBatching(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status_ptr) {
+  auto* request = reinterpret_cast<DynamicBatchingRequest*>(user_data);
+  Ort::Status status(status_ptr);
+  EXPECT_TRUE(status.IsOK());
+  EXPECT_EQ(num_outputs, 1UL);
+  if (num_outputs == 1) {
+    Ort::Value output_value(outputs[0]);
+    EXPECT_EQ(output_value.GetTensorTypeAndShapeInfo().GetShape(), (std::vector<int64_t>{1, 3}));
+    const float* y = output_value.GetTensorData<float>();
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(y[i], request->x_value[i] + static_cast<float>(i + 1));
+    }
+    // the output is owned by the Ort::Value passed to RunAsync
+    output_value.release();
+  }
+  request->done.store(true);
+}
+
+TEST(CApiTest, RunAsyncDynamicBatching) {
+  Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(4);
+  session_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "4");
+  // long enough for all requests to be queued before the first batch runs
+  session_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxQueueDelayUs, "100000");
+  // the node events of the profile record the input shapes of each run
+#ifdef _WIN32
+  session_options.EnableProfiling(L"dynamic_batching_profile");
+#else
+  session_options.EnableProfiling("dynamic_batching_profile");
+#endif
+  Ort::Session session(*ort_env, TSTR("testdata/dynamic_batching_add.onnx"), session_options);
+
+  constexpr size_t num_requests = 6;
+  std::vector<DynamicBatchingRequest> requests(num_requests);
+  std::vector<Ort::Value> input_tensors;
+  std::vector<Ort::Value> output_values;
+  input_tensors.reserve(num_requests);
+  output_values.reserve(num_requests);
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  const int64_t x_dim[] = {1, 3};
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  Ort::RunOptions run_options;
+
+  for (size_t i = 0; i < num_requests; ++i) {
+    for (size_t j = 0; j < 3; ++j) {
+      requests[i].x_value[j] = static_cast<float>(i * 10 + j);
+    }
+    input_tensors.push_back(Ort::Value::CreateTensor<float>(memory_info, requests[i].x_value, 3, x_dim, 2));
+    output_values.emplace_back(nullptr);
+  }
+
+  for (size_t i = 0; i < num_requests; ++i) {
+    EXPECT_NO_THROW(session.RunAsync(run_options, input_names, &input_tensors[i], 1, output_names,
+                                     &output_values[i], 1, CallbackDynamicBatching, &requests[i]));
+  }
+
+  auto all_done = [&requests]() {
+    return std::all_of(requests.begin(), requests.end(),
+                       [](const DynamicBatchingRequest& request) { return request.done.load(); });
+  };
+
+  std::chrono::duration<double, std::milli> dur{100};
+  // timeout in about 10 secs
+  for (int i = 0; i < 100 && !all_done(); ++i) {
+    std::this_thread::sleep_for(dur);
+  }
+
+  ASSERT_TRUE(all_done());
+
+  // the requests of 1 row each must have been executed as batches of more than one row
+  Ort::AllocatorWithDefaultOptions allocator;
+  auto profile_file = session.EndProfilingAllocated(allocator);
+  std::ifstream profile_stream(profile_file.get());
+  ASSERT_TRUE(profile_stream.is_open());
+  std::stringstream profile;
+  profile << profile_stream.rdbuf();
+  const std::string events = profile.str();
+  bool batched = false;
+  for (int rows = 2; rows <= 4; ++rows) {
+    batched |= events.find("{\"float\":[" + std::to_string(rows) + ",3]}") != std::string::npos;
+  }
+  EXPECT_TRUE(batched) << "no batched run found in " << profile_file.get();
+  profile_stream.close();
+  std::remove(profile_file.get());
+}
+
+struct ExpiredRequest {
+  std::atomic_bool done{false};
+  size_t num_outputs = 0;
+  std::string error;
+};
+
+void CallbackExpiredRequest(void* user_data, OrtValue** /*outputs*/, size_t num_outputs, OrtStatusPtr status_ptr) {
+  auto* request = reinterpret_cast<ExpiredRequest*>(user_data);
+  Ort::Status status(status_ptr);
+  request->num_outputs = num_outputs;
+  request->error = status.IsOK() ? "" : status.GetErrorMessage();
+  request->done.store(true);
+}
+
+// A request whose run.deadline_ms passes before it leaves the queue is completed with an error and never runs, both
+// when RunAsync schedules it directly and when the dynamic batcher queues it. A request without a deadline submitted
+// at the same time still runs.
+TEST(CApiTest, RunAsyncDropsExpiredRequests) {
+  for (const bool dynamic_batching : {false, true}) {
+    SCOPED_TRACE(dynamic_batching ? "dynamic batching" : "no dynamic batching");
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(2);
+    if (dynamic_batching) {
+      session_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "4");
+      // the expired request must not wait for the batch to fill
+      session_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxQueueDelayUs, "100000");
+    }
+    // the profile records a model_run event for each run
+#ifdef _WIN32
+    session_options.EnableProfiling(L"run_async_deadline_profile");
+#else
+    session_options.EnableProfiling("run_async_deadline_profile");
+#endif
+    Ort::Session session(*ort_env, TSTR("testdata/dynamic_batching_add.onnx"), session_options);
+
+    const char* input_names[] = {"X"};
+    const char* output_names[] = {"Y"};
+    const int64_t x_dim[] = {1, 3};
+    auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+    // a nanosecond passes before the request leaves the queue
+    Ort::RunOptions expired_run_options;
+    expired_run_options.AddConfigEntry(kOrtRunOptionsConfigDeadlineMs, "0.000001");
+    ExpiredRequest expired;
+    float expired_x[] = {1.0f, 2.0f, 3.0f};
+    Ort::Value expired_input = Ort::Value::CreateTensor<float>(memory_info, expired_x, 3, x_dim, 2);
+    Ort::Value expired_output{nullptr};
+    EXPECT_NO_THROW(session.RunAsync(expired_run_options, input_names, &expired_input, 1, output_names,
+                                     &expired_output, 1, CallbackExpiredRequest, &expired));
+
+    Ort::RunOptions run_options;
+    DynamicBatchingRequest request;
+    for (size_t j = 0; j < 3; ++j) {
+      request.x_value[j] = static_cast<float>(j);
+    }
+    Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, request.x_value, 3, x_dim, 2);
+    Ort::Value output{nullptr};
+    EXPECT_NO_THROW(session.RunAsync(run_options, input_names, &input, 1, output_names, &output, 1,
+                                     CallbackDynamicBatching, &request));
+
+    std::chrono::duration<double, std::milli> dur{100};
+    // timeout in about 10 secs
+    for (int i = 0; i < 100 && !(expired.done.load() && request.done.load()); ++i) {
+      std::this_thread::sleep_for(dur);
+    }
+    ASSERT_TRUE(expired.done.load());
+    ASSERT_TRUE(request.done.load());
+
+    EXPECT_EQ(expired.num_outputs, 0u);
+    EXPECT_THAT(expired.error, testing::HasSubstr("Request dropped as its deadline passed"));
+    EXPECT_EQ(static_cast<OrtValue*>(expired_output), nullptr);
+
+    // only the request without a deadline ran
+    Ort::AllocatorWithDefaultOptions allocator;
+    auto profile_file = session.EndProfilingAllocated(allocator);
+    std::ifstream profile_stream(profile_file.get());
+    ASSERT_TRUE(profile_stream.is_open());
+    std::stringstream profile;
+    profile << profile_stream.rdbuf();
+    const std::string events = profile.str();
+    size_t num_runs = 0;
+    for (size_t pos = events.find("\"model_run\""); pos != std::string::npos;
+         pos = events.find("\"model_run\"", pos + 1)) {
+      ++num_runs;
+    }
+    EXPECT_EQ(num_runs, 1u);
+    profile_stream.close();
+    std::remove(profile_file.get());
+  }
+}
+
 struct MockGQA : public OrtCustomOp {
   MockGQA() {
     OrtCustomOp::GetMayInplace = [](int** input_index, int** output_index) {
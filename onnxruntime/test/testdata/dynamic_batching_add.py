@@ -0,0 +1,15 @@
+import onnx
+from onnx import TensorProto, helper
+
+# Model with a symbolic leading 'batch' dimension shared by all graph inputs and outputs.
+# Used to test dynamic batching of RunAsync requests.
+graph = helper.make_graph(
+    [helper.make_node("Add", ["X", "B"], ["Y"], "add")],
+    "dynamic_batching_add",
+    [helper.make_tensor_value_info("X", TensorProto.FLOAT, ["batch", 3])],
+    [helper.make_tensor_value_info("Y", TensorProto.FLOAT, ["batch", 3])],
+    [helper.make_tensor("B", TensorProto.FLOAT, [3], [1.0, 2.0, 3.0])],
+)
+
+model = helper.make_model(graph, opset_imports=[helper.make_opsetid("", 13)], ir_version=7)
+onnx.save(model, "dynamic_batching_add.onnx")